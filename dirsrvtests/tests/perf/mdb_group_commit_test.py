@@ -0,0 +1,101 @@
+# --- BEGIN COPYRIGHT BLOCK ---
+# Copyright (C) 2026 Red Hat, Inc.
+# All rights reserved.
+#
+# License: GPL (version 3 or any later version).
+# See LICENSE for details.
+# --- END COPYRIGHT BLOCK ---
+#
+"""Write throughput of lmdb with group commit, at different window sizes"""
+
+import logging
+import threading
+import time
+import pytest
+from lib389.topologies import topology_st as topo
+from lib389.backend import DatabaseConfig
+from lib389.idm.user import UserAccounts
+from lib389.idm.account import Account
+from lib389.monitor import MonitorDatabase
+from lib389.utils import get_default_db_lib
+from lib389._constants import DEFAULT_SUFFIX, DN_DM, PASSWORD
+
+pytestmark = pytest.mark.tier3
+
+log = logging.getLogger(__name__)
+
+WINDOWS = ['0', '1', '2', '5', '10']
+NB_THREADS = 16
+DURATION = 20
+NB_USERS = NB_THREADS
+
+
+def _writer(inst, dn, deadline, counts, idx):
+    conn = Account(inst, dn=DN_DM).bind(PASSWORD)
+    user = Account(conn, dn=dn)
+    n = 0
+    try:
+        while time.time() < deadline:
+            user.replace('description', str(n))
+            n += 1
+    finally:
+        conn.unbind_s()
+    counts[idx] = n
+
+
+def _run(inst, users):
+    counts = [0] * NB_THREADS
+    deadline = time.time() + DURATION
+    threads = [threading.Thread(target=_writer, args=(inst, users[i].dn, deadline, counts, i))
+               for i in range(NB_THREADS)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return sum(counts)
+
+
+@pytest.mark.skipif(get_default_db_lib() != "mdb", reason="Group commit is an lmdb feature")
+def test_mdb_group_commit_throughput(topo):
+    """Measure the modify throughput with concurrent writers for several
+    group commit windows
+
+    :id: 6a1c9a4e-0f2d-4a8e-b7d3-3c55e2b91f07
+    :setup: Standalone instance using lmdb
+    :steps:
+        1. Create a user per writer thread
+        2. For each window, set nsslapd-mdb-group-commit-window and restart
+        3. Run the writers for a fixed duration and count the modifies
+        4. Check the syncs were shared between several txns
+    :expectedresults:
+        1. Success
+        2. Success
+        3. Every modify succeeds, the throughput is logged
+        4. With a window, there are fewer syncs than committed txns
+    """
+    inst = topo.standalone
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    accounts = [users.create_test_user(uid=2000 + i) for i in range(NB_USERS)]
+    db_cfg = DatabaseConfig(inst)
+
+    results = {}
+    for window in WINDOWS:
+        db_cfg.set([('nsslapd-mdb-group-commit-window', window)])
+        inst.restart()
+
+        nbmods = _run(inst, accounts)
+        results[window] = nbmods / DURATION
+        log.info(f'group commit window {window} ms: {results[window]:.0f} modifies/s')
+
+        if window != '0':
+            monitor = MonitorDatabase(inst)
+            syncs = monitor.get_attr_val_int('groupCommitSyncs')
+            synced = monitor.get_attr_val_int('groupCommitSyncedRWtxn')
+            log.info(f'group commit window {window} ms: {synced} txns made durable by {syncs} syncs')
+            assert syncs < synced
+
+    for window in WINDOWS:
+        log.info(f'{window:>4} ms: {results[window]:10.0f} modifies/s')
+
+    db_cfg.set([('nsslapd-mdb-group-commit-window', '0')])
+    inst.restart()
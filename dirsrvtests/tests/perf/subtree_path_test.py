@@ -0,0 +1,162 @@
+# --- BEGIN COPYRIGHT BLOCK ---
+# Copyright (C) 2026 Red Hat, Inc.
+# All rights reserved.
+#
+# License: GPL (version 3 or any later version).
+# See LICENSE for details.
+# --- END COPYRIGHT BLOCK ---
+#
+"""Subtree searches and subtree moves in a deep tree, with and without
+the subtreepath index"""
+
+import logging
+import os
+import time
+import ldap
+import pytest
+from lib389.topologies import topology_st as topo
+from lib389.backend import Backends, DatabaseConfig
+from lib389.idm.account import Account
+from lib389._constants import DEFAULT_SUFFIX, DEFAULT_BENAME, DN_DM, PASSWORD
+
+pytestmark = pytest.mark.tier3
+
+log = logging.getLogger(__name__)
+
+DEPTH = 10
+FANOUT = 2
+USERS_PER_OU = 20
+NB_SEARCHES = 200
+NB_MOVES = 20
+SEARCH_FILTER = '(objectClass=inetOrgPerson)'
+
+
+def _ou_dn(path):
+    """The dn of the ou at path, a tuple of child indexes from the top"""
+    rdns = [f'ou=level{depth}_{idx}' for depth, idx in enumerate(path)]
+    return ','.join(reversed(rdns)) + f',ou=tree,{DEFAULT_SUFFIX}'
+
+
+def _write_ldif(ldif_file):
+    """A binary tree of ous, DEPTH levels deep, with users in each ou"""
+    nb_users = 0
+    with open(ldif_file, 'w') as f:
+        f.write(f'dn: {DEFAULT_SUFFIX}\nobjectClass: top\nobjectClass: domain\ndc: example\n\n')
+        f.write(f'dn: ou=tree,{DEFAULT_SUFFIX}\nobjectClass: top\nobjectClass: organizationalUnit\nou: tree\n\n')
+        paths = [(i,) for i in range(FANOUT)]
+        while paths:
+            path = paths.pop()
+            dn = _ou_dn(path)
+            f.write(f'dn: {dn}\nobjectClass: top\nobjectClass: organizationalUnit\n'
+                    f'ou: level{len(path) - 1}_{path[-1]}\n\n')
+            for u in range(USERS_PER_OU):
+                uid = f'user{nb_users}'
+                f.write(f'dn: uid={uid},{dn}\nobjectClass: top\nobjectClass: person\n'
+                        f'objectClass: organizationalPerson\nobjectClass: inetOrgPerson\n'
+                        f'uid: {uid}\ncn: {uid}\nsn: {uid}\n\n')
+                nb_users += 1
+            if len(path) < DEPTH:
+                paths += [path + (i,) for i in range(FANOUT)]
+    return nb_users
+
+
+def _search_bases():
+    """A base at each depth of the tree"""
+    return [f'ou=tree,{DEFAULT_SUFFIX}'] + [_ou_dn((0,) * depth) for depth in range(1, DEPTH + 1)]
+
+
+def _subtree_dns(conn, base):
+    return {dn.lower() for dn, _ in conn.search_s(base, ldap.SCOPE_SUBTREE, SEARCH_FILTER, ['1.1'])}
+
+
+def _run_searches(conn):
+    """Returns the results of each base and the searches per second"""
+    bases = _search_bases()
+    results = {base: _subtree_dns(conn, base) for base in bases}
+    start = time.monotonic()
+    for i in range(NB_SEARCHES):
+        conn.search_s(bases[i % len(bases)], ldap.SCOPE_SUBTREE, SEARCH_FILTER, ['1.1'])
+    return results, NB_SEARCHES / (time.monotonic() - start)
+
+
+def _run_moves(conn):
+    """Moves a subtree of the second level back and forth between two
+    parents at different depths, returns the moves per second"""
+    moved_rdn = 'ou=level1_0'
+    parents = [_ou_dn((0,)), _ou_dn((1, 1))]
+    start = time.monotonic()
+    for i in range(NB_MOVES):
+        conn.rename_s(f'{moved_rdn},{parents[i % 2]}', moved_rdn, newsuperior=parents[(i + 1) % 2])
+    return NB_MOVES / (time.monotonic() - start)
+
+
+def test_subtree_path_deep_tree(topo):
+    """Compare subtree searches and subtree moves in a deep tree with the
+    ancestorid index and with the subtreepath index
+
+    :id: 5c1e8a2f-7d34-4b9e-a0c6-2f9b8e4d7a13
+    :setup: Standalone instance
+    :steps:
+        1. Import a tree of ous 10 levels deep, with users in every ou
+        2. Run subtree searches from a base at each depth, and move a
+           subtree back and forth, with the ancestorid index
+        3. Enable nsslapd-subtreepath-index and restart the server
+        4. Run the same searches and moves with the subtreepath index
+        5. Move a subtree once more and search it at its new place
+        6. Delete a user, reindex subtreepath online and search again
+    :expectedresults:
+        1. Success
+        2. The rates are logged
+        3. The subtreepath index is built at startup
+        4. The rates are logged and each search returns the same entries
+        5. The moved entries are found under their new parent only
+        6. The index is rebuilt and the searches return the same entries
+    """
+    inst = topo.standalone
+    ldif_file = os.path.join(inst.get_ldif_dir(), 'subtree_path.ldif')
+    nb_users = _write_ldif(ldif_file)
+    inst.stop()
+    assert inst.ldif2db(DEFAULT_BENAME, None, None, None, ldif_file)
+    inst.start()
+
+    conn = Account(inst, dn=DN_DM).bind(PASSWORD)
+    ancestorid_results, ancestorid_searches = _run_searches(conn)
+    assert len(ancestorid_results[f'ou=tree,{DEFAULT_SUFFIX}']) == nb_users
+    ancestorid_moves = _run_moves(conn)
+    conn.unbind_s()
+
+    DatabaseConfig(inst).set([('nsslapd-subtreepath-index', 'on')])
+    inst.restart()
+
+    conn = Account(inst, dn=DN_DM).bind(PASSWORD)
+    subtreepath_results, subtreepath_searches = _run_searches(conn)
+    assert subtreepath_results == ancestorid_results
+    subtreepath_moves = _run_moves(conn)
+
+    log.info(f'ancestorid: {ancestorid_searches:.1f} searches/s, {ancestorid_moves:.1f} moves/s')
+    log.info(f'subtreepath: {subtreepath_searches:.1f} searches/s, {subtreepath_moves:.1f} moves/s')
+
+    # One more move: the subtree is found under its new parent only
+    old_parent, new_parent = _ou_dn((0,)), _ou_dn((1, 1))
+    old_parent_dns = _subtree_dns(conn, old_parent)
+    moved = _subtree_dns(conn, f'ou=level1_0,{old_parent}')
+    conn.rename_s(f'ou=level1_0,{old_parent}', 'ou=level1_0', newsuperior=new_parent)
+    assert _subtree_dns(conn, f'ou=level1_0,{new_parent}') == \
+        {dn.replace(old_parent.lower(), new_parent.lower()) for dn in moved}
+    assert _subtree_dns(conn, old_parent) == old_parent_dns - moved
+    assert len(_subtree_dns(conn, f'ou=tree,{DEFAULT_SUFFIX}')) == nb_users
+
+    # An online reindex rebuilds the index before the searches use it again
+    conn.delete_s(f'uid=user0,{_ou_dn((1,))}')
+    tree_dns = _subtree_dns(conn, f'ou=tree,{DEFAULT_SUFFIX}')
+    assert len(tree_dns) == nb_users - 1
+    Backends(inst).get(DEFAULT_BENAME).reindex(attrs=['subtreepath'], wait=True)
+    assert _subtree_dns(conn, f'ou=tree,{DEFAULT_SUFFIX}') == tree_dns
+    conn.unbind_s()
+
+
+if __name__ == '__main__':
+    # Run isolated
+    # -s for DEBUG mode
+    CURRENT_FILE = os.path.realpath(__file__)
+    pytest.main(["-s", CURRENT_FILE])
@@ -0,0 +1,177 @@
+# --- BEGIN COPYRIGHT BLOCK ---
+# Copyright (C) 2026 Red Hat, Inc.
+# All rights reserved.
+#
+# License: GPL (version 3 or any later version).
+# See LICENSE for details.
+# --- END COPYRIGHT BLOCK ---
+#
+"""VLV paging throughput at random offsets while the vlv index is updated"""
+
+import logging
+import os
+import random
+import string
+import threading
+import time
+import ldap
+import pytest
+from ldap.controls.vlv import VLVRequestControl, VLVResponseControl
+from ldap.controls.sss import SSSRequestControl
+from lib389.topologies import topology_st as topo
+from lib389.dbgen import dbgen_users
+from lib389.index import VLVSearch, VLVIndex
+from lib389.idm.account import Account
+from lib389.idm.user import UserAccounts
+from lib389.tasks import Tasks
+from lib389.utils import get_default_db_lib
+from lib389._constants import DEFAULT_SUFFIX, DEFAULT_BENAME, DN_DM, PASSWORD
+
+pytestmark = pytest.mark.tier3
+
+log = logging.getLogger(__name__)
+
+NB_USERS = 50000
+PAGE_SIZE = 20
+NB_READERS = 8
+NB_WRITERS = 4
+DURATION = 30
+VLV_FILTER = '(uid=*)'
+
+
+def _vlv_page(conn, offset, content_count=0):
+    """Returns the uids of the page at offset and the server content count"""
+    vlv_control = VLVRequestControl(criticality=True, before_count=0, after_count=PAGE_SIZE - 1,
+                                    offset=offset, content_count=content_count,
+                                    greater_than_or_equal=None, context_id=None)
+    sss_control = SSSRequestControl(criticality=True, ordering_rules=['uid'])
+    msgid = conn.search_ext(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, VLV_FILTER, ['uid'],
+                            serverctrls=[vlv_control, sss_control])
+    _, rdata, _, rctrls = conn.result3(msgid)
+    resp = [c for c in rctrls if c.controlType == VLVResponseControl.controlType]
+    assert resp and resp[0].result == 0
+    uids = [entry['uid'][0] for _, entry in rdata]
+    return uids, resp[0].content_count
+
+
+def _reader(inst, deadline, stats, idx):
+    conn = Account(inst, dn=DN_DM).bind(PASSWORD)
+    latencies = []
+    try:
+        while time.time() < deadline:
+            offset = random.randint(1, NB_USERS)
+            start = time.monotonic()
+            uids, count = _vlv_page(conn, offset, NB_USERS)
+            latencies.append(time.monotonic() - start)
+            assert len(uids) <= PAGE_SIZE
+            assert NB_USERS <= count <= NB_USERS + NB_WRITERS
+    finally:
+        conn.unbind_s()
+    stats[idx] = latencies
+
+
+def _writer(inst, deadline, counts, idx):
+    conn = Account(inst, dn=DN_DM).bind(PASSWORD)
+    users = UserAccounts(conn, DEFAULT_SUFFIX)
+    n = 0
+    try:
+        while time.time() < deadline:
+            # Spread the updates over the whole index
+            uid = f'{random.choice(string.ascii_lowercase)}vlvwriter{idx}_{n}'
+            user = users.create(properties={
+                'uid': uid,
+                'cn': uid,
+                'sn': uid,
+                'uidNumber': str(100000 + n),
+                'gidNumber': str(100000 + n),
+                'homeDirectory': f'/home/{uid}',
+            })
+            user.delete()
+            n += 1
+    finally:
+        conn.unbind_s()
+    counts[idx] = n
+
+
+def _percentile(values, pct):
+    return values[min(len(values) - 1, int(len(values) * pct / 100))]
+
+
+@pytest.mark.skipif(get_default_db_lib() != "mdb", reason="The vlv recno cache is an lmdb feature")
+def test_vlv_paging_with_concurrent_writes(topo):
+    """Measure the throughput of vlv searches at random offsets while
+    other threads add and delete entries of the vlv index
+
+    :id: 0b7e5d2c-8a41-4f6b-9c3e-5d27a1f4e8b3
+    :setup: Standalone instance using lmdb
+    :steps:
+        1. Import the users and create a vlv index sorted on uid
+        2. Run vlv searches at random offsets, without writers, then
+           with concurrent writers adding and deleting users
+        3. Once the writers are stopped, page through the whole index
+        4. Check random pages against the full list
+    :expectedresults:
+        1. Success
+        2. Every search succeeds, the throughput and latencies are logged
+        3. Every user is returned exactly once and the content count
+           is the number of users
+        4. The pages match
+    """
+    inst = topo.standalone
+    ldif_file = os.path.join(inst.get_ldif_dir(), 'vlv_paging.ldif')
+    dbgen_users(inst, NB_USERS, ldif_file, DEFAULT_SUFFIX)
+    inst.stop()
+    assert inst.ldif2db(DEFAULT_BENAME, None, None, None, ldif_file)
+    inst.start()
+
+    vlv_search = VLVSearch(inst).create(
+        basedn=f'cn={DEFAULT_BENAME},cn=ldbm database,cn=plugins,cn=config',
+        properties={'objectclass': ['top', 'vlvSearch'], 'cn': 'vlvPagingSrch',
+                    'vlvbase': DEFAULT_SUFFIX, 'vlvfilter': VLV_FILTER,
+                    'vlvscope': str(ldap.SCOPE_SUBTREE)})
+    VLVIndex(inst).create(
+        basedn=vlv_search.dn,
+        properties={'objectclass': ['top', 'vlvIndex'], 'cn': 'vlvPagingIdx', 'vlvsort': 'uid'})
+    assert Tasks(inst).reindex(suffix=DEFAULT_SUFFIX, attrname='vlvPagingIdx',
+                               args={'wait': True}, vlv=True) == 0
+    inst.restart()
+
+    for nb_writers in (0, NB_WRITERS):
+        stats = [[] for _ in range(NB_READERS)]
+        counts = [0] * nb_writers
+        deadline = time.time() + DURATION
+        threads = [threading.Thread(target=_reader, args=(inst, deadline, stats, i))
+                   for i in range(NB_READERS)]
+        threads += [threading.Thread(target=_writer, args=(inst, deadline, counts, i))
+                    for i in range(nb_writers)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        latencies = sorted(l for s in stats for l in s)
+        assert latencies
+        log.info(f'{nb_writers} writers: {len(latencies) / DURATION:.0f} vlv searches/s, '
+                 f'{sum(counts) / DURATION:.0f} add+delete/s, latency '
+                 f'p50={_percentile(latencies, 50) * 1000:.2f}ms '
+                 f'p99={_percentile(latencies, 99) * 1000:.2f}ms')
+
+    # The index is back to the imported users: check the positions are exact
+    conn = Account(inst, dn=DN_DM).bind(PASSWORD)
+    all_uids = []
+    offset = 1
+    while True:
+        uids, count = _vlv_page(conn, offset)
+        assert count == NB_USERS
+        if offset > count:
+            break
+        all_uids += uids
+        offset += PAGE_SIZE
+    assert len(all_uids) == NB_USERS
+    assert len(set(all_uids)) == NB_USERS
+
+    for _ in range(100):
+        offset = random.randint(1, NB_USERS)
+        uids, _ = _vlv_page(conn, offset)
+        assert uids == all_uids[offset - 1:offset - 1 + PAGE_SIZE]
+    conn.unbind_s()
@@ -23,6 +23,7 @@ from lib389.dbgen import dbgen_users
 from lib389.tasks import BackupTask, RestoreTask
 from lib389.config import BDB_LDBMConfig
 from lib389.idm.nscontainer import nsContainers
+from lib389.idm.user import UserAccounts
 from lib389 import DSEldif
 from lib389.utils import ds_is_older, get_default_db_lib
 from lib389.replica import ReplicationManager
@@ -389,6 +390,81 @@ def test_online_backup_and_dse_write(topo):
     event.clear()
 
 
+def _wait_task(task, timeout=600):
+    task.wait(timeout=timeout)
+    assert task.is_complete()
+    assert task.get_exit_code() == 0, task.get_task_log()
+    return task.get_task_log()
+
+
+@pytest.mark.skipif(get_default_db_lib() != "mdb", reason="Incremental backups are an lmdb feature")
+def test_incremental_backup_and_restore(topo):
+    """Test that a chain of incremental backups can be restored
+
+    :id: 3c4b1f0e-5d8a-4e2b-9f61-7a2d0c9e8b14
+    :setup: One standalone instance using lmdb
+    :steps:
+        1. Add users and perform a full backup
+        2. Modify some users and perform an incremental backup
+        3. Add users and perform a second incremental backup
+        4. Check the incremental backups are smaller than the full one
+        5. Delete the users and restore the second incremental backup
+        6. Check the users and modifications are back
+        7. Remove the full backup and try to restore the incremental one
+    :expectedresults:
+        1. Success
+        2. Success, the task log reports the bytes copied and the throughput
+        3. Success
+        4. The incremental backups have no data.mdb and their increment is
+           smaller than the database
+        5. Success
+        6. All the users are present with their last values
+        7. The restore is refused
+    """
+    inst = topo.standalone
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    bak_full = f'{inst.ds_paths.backup_dir}/incr_full'
+    bak_incr1 = f'{inst.ds_paths.backup_dir}/incr_1'
+    bak_incr2 = f'{inst.ds_paths.backup_dir}/incr_2'
+    for bak_dir in (bak_full, bak_incr1, bak_incr2):
+        shutil.rmtree(bak_dir, ignore_errors=True)
+
+    accounts = [users.create_test_user(uid=3000 + i) for i in range(200)]
+    _wait_task(inst.backup_online(archive=bak_full))
+    assert os.path.exists(f'{bak_full}/data.mdb')
+
+    for account in accounts[:20]:
+        account.replace('description', 'incremental 1')
+    tasklog = _wait_task(inst.backup_online(archive=bak_incr1, incremental=True))
+    assert 'Incremental backup of txn' in tasklog
+    assert 'bytes written' in tasklog
+
+    accounts += [users.create_test_user(uid=3200 + i) for i in range(50)]
+    _wait_task(inst.backup_online(archive=bak_incr2, incremental=True))
+
+    dbsize = os.path.getsize(f'{bak_full}/data.mdb')
+    for bak_dir in (bak_incr1, bak_incr2):
+        assert not os.path.exists(f'{bak_dir}/data.mdb')
+        assert os.path.getsize(f'{bak_dir}/data.mdb.incr') < dbsize
+
+    for account in accounts:
+        account.delete()
+    _wait_task(inst.restore_online(archive=bak_incr2))
+
+    for i in range(250):
+        user = users.get(f'test_user_{3000 + i}')
+        if i < 20:
+            assert user.get_attr_val_utf8('description') == 'incremental 1'
+
+    shutil.rmtree(bak_full)
+    task = inst.restore_online(archive=bak_incr2)
+    task.wait(timeout=600)
+    assert task.get_exit_code() != 0
+
+    for bak_dir in (bak_incr1, bak_incr2):
+        shutil.rmtree(bak_dir)
+
+
 if __name__ == '__main__':
     # Run isolated
     # -s for DEBUG mode
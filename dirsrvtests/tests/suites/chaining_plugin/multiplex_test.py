@@ -0,0 +1,101 @@
+# --- BEGIN COPYRIGHT BLOCK ---
+# Copyright (C) 2026 Red Hat, Inc.
+# All rights reserved.
+#
+# License: GPL (version 3 or any later version).
+# See LICENSE for details.
+# --- END COPYRIGHT BLOCK ---
+
+import pytest
+import threading
+from lib389.idm.account import Accounts, Account
+from lib389.topologies import topology_i2 as topology
+from lib389.backend import Backends
+from lib389._constants import DEFAULT_SUFFIX
+from lib389.plugins import ChainingBackendPlugin
+from lib389.chaining import ChainingLinks
+from lib389.mappingTree import MappingTrees
+
+pytestmark = pytest.mark.tier1
+
+NB_THREADS = 8
+NB_SEARCHES = 25
+
+
+def test_chaining_multiplexed_searches(topology):
+    """Test concurrent searches through a chaining link using
+    multiplexed connections and a limit of operations in flight
+
+    :id: 2f0c6a57-1d5e-4b7a-a8d8-6f0b7f3c9e41
+    :setup: Two standalones in chaining.
+    :steps:
+        1. Configure chaining st1 -> st2 with nsMultiplexOperations on,
+           a single operation connection and nsMaxOperationsInFlight 4
+        2. Run searches from several threads at the same time
+        3. Check the monitor of the link
+    :expectedresults:
+        1. Success
+        2. Every search returns the entries of st2
+        3. The operations are accounted in the response time histogram
+           and no operation is left in flight
+    """
+    st1 = topology.ins["standalone1"]
+    st2 = topology.ins["standalone2"]
+
+    for be in Backends(st1).list():
+        be.delete()
+
+    ChainingBackendPlugin(st1).enable()
+
+    chains = ChainingLinks(st1)
+    chain = chains.create(properties={
+        'cn': 'muxchain',
+        'nsslapd-suffix': DEFAULT_SUFFIX,
+        'nsmultiplexorbinddn': '',
+        'nsmultiplexorcredentials': '',
+        'nsfarmserverurl': st2.toLDAPURL(),
+        'nsoperationconnectionslimit': '1',
+        'nsconcurrentoperationslimit': '64',
+        'nsmultiplexoperations': 'on',
+        'nsmaxoperationsinflight': '4',
+    })
+
+    mts = MappingTrees(st1)
+    for mt in mts.list():
+        mt.delete()
+    mts.ensure_state(properties={
+        'cn': DEFAULT_SUFFIX,
+        'nsslapd-state': 'backend',
+        'nsslapd-backend': 'muxchain',
+    })
+    st1.restart()
+
+    expected = len(Accounts(st2, DEFAULT_SUFFIX).list())
+    assert expected > 0
+
+    failures = []
+
+    def searcher():
+        conn = Account(st1, dn='').bind(password='')
+        try:
+            for _ in range(NB_SEARCHES):
+                found = len(Accounts(conn, DEFAULT_SUFFIX).list())
+                if found != expected:
+                    failures.append(found)
+        finally:
+            conn.unbind_s()
+
+    threads = [threading.Thread(target=searcher) for _ in range(NB_THREADS)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not failures
+
+    monitor = chain.get_monitor()
+    assert monitor.get_attr_val_int('nsoperationsinflight') == 0
+    assert monitor.get_attr_val_int('nsoperationsinflightpeak') <= 4
+    assert monitor.get_attr_val_int('nsopenopconnectioncount') == 1
+    histogram = monitor.get_attr_vals_utf8('nsfarmresponsetimehistogram')
+    completed = sum(int(v.split(':')[1]) for v in histogram)
+    assert completed >= NB_THREADS * NB_SEARCHES
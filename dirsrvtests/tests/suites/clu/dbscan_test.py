@@ -198,6 +198,48 @@ def test_dbscan_changelog_dump(helper, request):
     assert 'replace: description' in result.stdout
 
 
+def test_dbscan_index_stats(helper, request):
+    """Test dbscan index statistics
+
+    :id: 3c1e6f2a-8d4b-11f1-9c7e-482ae39447e5
+    :setup: Stopped standalone instance
+    :steps:
+         1. Run dbscan --index-stats on the objectclass index with a sidecar file
+         2. Check the reported statistics
+         3. Check the sidecar file
+         4. Run dbscan --index-stats on id2entry
+    :expectedresults:
+         1. Success
+         2. The equality keys, the top keys and the size are reported
+         3. The sidecar contains the key counts and the top keys
+         4. dbscan fails with a parameter error
+    """
+
+    if '--index-stats' not in helper.options:
+        pytest.skip('Not supported with this dbscan version')
+    ocdbi = helper.get_dbi('objectclass')
+    sidecar = f'{helper.ldif_dir}/objectclass.stats'
+    result = helper.dbscan(['-D', helper.dblib, '-T', '--top', '5',
+                            '--index-stats-file', sidecar, '-f', ocdbi])
+    log.info(result.stdout)
+    assert 'Equality index keys:' in result.stdout
+    assert 'Top 5 keys:' in result.stdout
+    assert '=top' in result.stdout
+    size = re.search(r'On-disk size: (\d+) bytes', result.stdout)
+    assert size and int(size.group(1)) > 0
+
+    with open(sidecar, 'r') as f:
+        stats = f.read()
+    log.info(stats)
+    assert re.search(r'^eq-keys: [1-9]', stats, flags=re.MULTILINE)
+    assert re.search(r'^top: \d+ =top$', stats, flags=re.MULTILINE)
+    os.remove(sidecar)
+
+    id2entry = helper.get_dbi('id2entry')
+    result = helper.dbscan(['-D', helper.dblib, '-T', '-f', id2entry], expected_rc=1)
+    assert 'only applies to attribute indexes' in result.stdout
+
+
 if __name__ == '__main__':
     # Run isolated
     # -s for DEBUG mode
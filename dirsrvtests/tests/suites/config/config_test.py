@@ -899,6 +899,89 @@ def test_lmdb_autotuned_maxdbs(topology_m2, request):
 
 
 
+def test_dse_write_delay(topo):
+    """Check that the dse.ldif writes are deferred with nsslapd-dse-write-delay
+
+    :id: 3c2b7d51-8e0f-4f4a-9a61-0d5e2b8c7f14
+    :setup: Standalone instance
+    :steps:
+        1. Set nsslapd-dse-write-delay to 600000
+        2. Modify a cn=config attribute
+        3. Check that dse.ldif is not updated
+        4. Run an online backup
+        5. Check that the backup and dse.ldif have the new value
+        6. Modify cn=config several times and stop the server at once
+        7. Check that dse.ldif has the last value
+        8. Set nsslapd-dse-write-delay back to 0
+        9. Check that a cn=config modify is written synchronously
+    :expectedresults:
+        1. Success
+        2. Success
+        3. Success
+        4. Success
+        5. Success
+        6. Success
+        7. Success
+        8. Success
+        9. Success
+    """
+
+    inst = topo.standalone
+    inst.config.replace('nsslapd-dse-write-delay', '600000')
+
+    inst.config.replace('nsslapd-idletimeout', '1234')
+    assert DSEldif(inst).get(DN_CONFIG, 'nsslapd-idletimeout', single=True) != '1234'
+
+    # The backup writes the delayed changes before copying dse.ldif
+    backup_dir = os.path.join(inst.ds_paths.backup_dir, 'dse_write_delay')
+    assert inst.tasks.db2bak(backup_dir=backup_dir, args={TASK_WAIT: True}) == 0
+    backup_dse = os.path.join(backup_dir, 'config_files', 'dse.ldif')
+    assert DSEldif(inst, path=backup_dse).get(DN_CONFIG, 'nsslapd-idletimeout', single=True) == '1234'
+    assert DSEldif(inst).get(DN_CONFIG, 'nsslapd-idletimeout', single=True) == '1234'
+
+    for timeout in range(100, 150):
+        inst.config.replace('nsslapd-idletimeout', str(timeout))
+    inst.stop()
+    assert DSEldif(inst).get(DN_CONFIG, 'nsslapd-idletimeout', single=True) == '149'
+    inst.start()
+
+    inst.config.replace('nsslapd-dse-write-delay', '0')
+    inst.config.replace('nsslapd-idletimeout', '0')
+    assert DSEldif(inst).get(DN_CONFIG, 'nsslapd-idletimeout', single=True) == '0'
+
+    with pytest.raises(ldap.LDAPError):
+        inst.config.replace('nsslapd-dse-write-delay', '-1')
+
+
+def test_dse_task_entries_not_written(topo):
+    """Check that task entries do not rewrite dse.ldif
+
+    :id: 9f4e8a26-5b3d-4c17-b2e0-7a1c6d9e3b58
+    :setup: Standalone instance
+    :steps:
+        1. Run a schema reload task
+        2. Check that dse.ldif was not rewritten
+        3. Check that the task entry is not in dse.ldif
+    :expectedresults:
+        1. Success
+        2. Success
+        3. Success
+    """
+
+    inst = topo.standalone
+    dse_path = DSEldif(inst).path
+    mtime = os.stat(dse_path).st_mtime_ns
+
+    task = SchemaReloadTask(inst)
+    task.create(properties={})
+    task.wait()
+    assert task.get_exit_code() == 0
+
+    assert os.stat(dse_path).st_mtime_ns == mtime
+    with open(dse_path) as f:
+        assert 'cn=schema_reload_' not in f.read().lower()
+
+
 if __name__ == '__main__':
     # Run isolated
     # -s for DEBUG mode
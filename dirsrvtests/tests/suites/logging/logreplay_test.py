@@ -0,0 +1,87 @@
+# --- BEGIN COPYRIGHT BLOCK ---
+# Copyright (C) 2026 Red Hat, Inc.
+# All rights reserved.
+#
+# License: GPL (version 3 or any later version).
+# See LICENSE for details.
+# --- END COPYRIGHT BLOCK ---
+#
+import logging
+import os
+import re
+import subprocess
+import ldap
+import pytest
+from lib389._constants import DEFAULT_SUFFIX, DN_DM, PASSWORD
+from lib389.topologies import topology_st as topo
+from lib389.idm.user import UserAccounts
+from lib389.utils import ensure_str
+
+log = logging.getLogger(__name__)
+
+NB_USERS = 10
+
+
+def run_logreplay(inst, csv_file, *extra):
+    """Replay the instance access log against the instance itself"""
+    cmd = [os.path.join(inst.get_bin_dir(), 'logreplay.py'),
+           '-H', f'ldap://{inst.host}:{inst.port}',
+           '-D', DN_DM, '-w', PASSWORD, '-s', '0', '-c', csv_file,
+           *extra, inst.ds_paths.access_log]
+    log.info(" ".join(cmd))
+    result = subprocess.run(cmd, capture_output=True)
+    log.info(ensure_str(result.stdout))
+    log.info(ensure_str(result.stderr))
+    return result.returncode, ensure_str(result.stdout)
+
+
+@pytest.mark.parametrize("log_format", ["default", "json"])
+def test_logreplay_searches(topo, log_format):
+    """Check that logreplay.py replays the searches of the access log
+
+    :id: 7d0a3c52-5a21-4d8c-9a73-3e5b1c2f8e10
+    :parametrized: yes
+    :setup: Standalone Instance
+    :steps:
+        1. Set the access log format and disable the log buffering
+        2. Add users and search each of them
+        3. Replay the access log as fast as possible
+        4. Check the report and the csv file
+    :expectedresults:
+        1. Success
+        2. Success
+        3. Success
+        4. Every search is replayed with the same result code and
+           number of entries, the modify operation is skipped
+    """
+    inst = topo.standalone
+    inst.config.replace('nsslapd-accesslog-logbuffering', 'off')
+    inst.config.replace('nsslapd-accesslog-log-format', log_format)
+    inst.deleteAccessLogs(restart=True)
+
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    for i in range(NB_USERS):
+        if not users.exists(f'test_user_{1000 + i}'):
+            users.create_test_user(uid=1000 + i)
+    for i in range(NB_USERS):
+        inst.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, f'(uid=test_user_{1000 + i})', ['cn'])
+    users.get('test_user_1000').replace('description', log_format)
+
+    csv_file = os.path.join(inst.get_ldif_dir(), f'logreplay_{log_format}.csv')
+    rc, out = run_logreplay(inst, csv_file)
+    assert rc == 0
+    assert re.search(r'Result code mismatches:\s+0', out)
+    assert re.search(r'Entry count mismatches:\s+0', out)
+    assert re.search(r'Skipped \(MOD\):\s+\d+', out)
+
+    with open(csv_file) as f:
+        rows = f.readlines()[1:]
+    replayed = [row for row in rows if ',SRCH,' in row]
+    assert len(replayed) >= NB_USERS
+
+
+if __name__ == '__main__':
+    # Run isolated
+    # -s for DEBUG mode
+    CURRENT_FILE = os.path.realpath(__file__)
+    pytest.main(["-s", CURRENT_FILE])
@@ -14,6 +14,7 @@ from lib389.backend import Backends, DatabaseConfig
 from lib389._constants import *
 from lib389.topologies import topology_st as topo
 from lib389._mapped_object import DSLdapObjects
+from lib389.idm.user import UserAccounts
 
 pytestmark = pytest.mark.tier1
 
@@ -177,6 +178,61 @@ def test_num_subordinates_with_monitor_suffix(topo):
     assert len(filter2) == num_subordinates_val
 
 
+def test_monitor_latency(topo):
+    """Check the latency histograms of cn=latency,cn=monitor
+
+    :id: 6f2b3c1e-9d47-4a8e-b5f0-3c81d2e7a946
+    :setup: Single instance
+    :steps:
+        1. Read cn=latency,cn=monitor to start a new window
+        2. Run searches and modifications
+        3. Read cn=latency,cn=monitor
+        4. Read it again without running operations
+        5. Check the operation latencies in cn=snmp,cn=monitor
+    :expectedresults:
+        1. Success
+        2. Success
+        3. The operations are counted per type, for the backend and
+           for the plugins, and the percentiles are ordered
+        4. The search and modify windows are empty
+        5. The latencies are reported with their own window
+    """
+
+    inst = topo.standalone
+    latency = MonitorLatency(inst)
+    latency.get_status()
+
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    user = users.create_test_user(uid=5000)
+    for i in range(20):
+        users.list()
+        user.replace('description', f'latency {i}')
+
+    status = latency.get_status()
+    search = status['operations']['search']['optime']
+    modify = status['operations']['modify']['optime']
+    log.info(f'search: {search} modify: {modify}')
+    assert search['count'] >= 20
+    assert modify['count'] == 20
+    for summary in (search, modify):
+        assert summary['p50'] <= summary['p90'] <= summary['p99'] <= summary['p999'] <= summary['max']
+    assert status['operations']['modify']['waittime']['count'] == 20
+
+    backend = [b for b in status['backends'] if b['backend'].lower() == DEFAULT_BENAME.lower()]
+    assert backend and backend[0]['count'] >= 40
+    assert any(p['count'] > 0 for p in status['plugins'])
+
+    status = latency.get_status()
+    assert status['operations']['modify']['optime']['count'] == 0
+    # The window only has the search of the previous read
+    assert status['operations']['search']['optime']['count'] <= 1
+
+    snmp = MonitorSNMP(inst)
+    assert int(snmp.get_attr_val_utf8('ModifyOpTimeCount')) >= 20
+    assert int(snmp.get_attr_val_utf8('ModifyOpTimeCount')) == 0
+    user.delete()
+
+
 if __name__ == '__main__':
     # Run isolated
     # -s for DEBUG mode
@@ -20,6 +20,7 @@ from lib389._controls import SSSRequestControl
 from lib389.idm.user import UserAccount, UserAccounts
 from lib389.cli_base import FakeArgs
 from lib389.config import LDBMConfig
+from lib389.monitor import Monitor
 from lib389.dbgen import dbgen_users
 
 from lib389.idm.organization import Organization
@@ -683,6 +684,86 @@ def test_search_multiple_paging(topology_st, create_user):
         del_users(users_list)
 
 
+def test_search_spilled_candidates(topology_st, create_user):
+    """Verify that a simple paged search whose candidate list is
+    spilled to disk returns the same entries, in the same order,
+    and that its memory is reported in the connection monitor.
+
+    :id: 0d5d2f4e-8a4f-4b8f-9e0e-2f7c6c1d9a31
+    :setup: Standalone instance, test user for binding,
+            varying number of users for the search base
+    :steps:
+        1. Bind as test user
+        2. Set nsslapd-pagedspillthreshold to 0
+        3. Search through added users with a simple paged control
+           and a server side sort control
+        4. Set nsslapd-pagedspillthreshold to 10
+        5. Request the first page of the same search
+        6. Check the paged search in cn=monitor
+        7. Request the remaining pages
+        8. Check cn=monitor once the search is complete
+    :expectedresults:
+        1. Bind should be successful
+        2. Config should be successfully set
+        3. All users should be found
+        4. Config should be successfully set
+        5. The first page should be returned
+        6. The spilled candidates should be reported
+        7. The same users should be returned, in the same order
+        8. No paged search should be reported
+    """
+
+    users_num = 50
+    page_size = 5
+    users_list = add_users(topology_st, users_num, DEFAULT_SUFFIX)
+    search_flt = r'(uid=test*)'
+    searchreq_attrlist = ['dn', 'sn']
+    monitor = Monitor(topology_st.standalone)
+    ldbmconfig = LDBMConfig(topology_st.standalone)
+
+    try:
+        conn = create_user.bind(TEST_USER_PWD)
+
+        log.info('Collect data with candidates in memory')
+        ldbmconfig.replace('nsslapd-pagedspillthreshold', '0')
+        req_ctrl = SimplePagedResultsControl(True, size=page_size, cookie='')
+        sort_ctrl = SSSRequestControl(True, ['sn'])
+        in_memory = paged_search(conn, DEFAULT_SUFFIX, [req_ctrl, sort_ctrl],
+                                 search_flt, searchreq_attrlist)
+        assert len(in_memory) == users_num
+
+        log.info('Collect data with spilled candidates')
+        ldbmconfig.replace('nsslapd-pagedspillthreshold', '10')
+        req_ctrl = SimplePagedResultsControl(True, size=page_size, cookie='')
+        controls = [req_ctrl, sort_ctrl]
+        msgid = conn.search_ext(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE,
+                                search_flt, searchreq_attrlist, serverctrls=controls)
+        rtype, spilled, rmsgid, rctrls = conn.result3(msgid)
+        pctrls = [c for c in rctrls if c.controlType == SimplePagedResultsControl.controlType]
+        assert pctrls[0].cookie
+
+        log.info('Check the paged search memory in cn=monitor')
+        assert int(monitor.get_attr_val_utf8('currentpagedresultsspilled')) > 0
+        assert int(monitor.get_attr_val_utf8('currentpagedresultsmemory')) > 0
+        pr_values = monitor.get_attr_vals_utf8('pagedresults')
+        assert len(pr_values) == 1
+        connid, searches, mem, spilled_bytes = pr_values[0].split(':')
+        assert int(searches) == 1
+        assert int(spilled_bytes) > 0
+
+        req_ctrl.cookie = pctrls[0].cookie
+        spilled.extend(paged_search(conn, DEFAULT_SUFFIX, controls,
+                                    search_flt, searchreq_attrlist))
+        assert [dn for dn, attrs in spilled] == [dn for dn, attrs in in_memory]
+
+        log.info('Check that the search result set was released')
+        assert int(monitor.get_attr_val_utf8('currentpagedresultsspilled')) == 0
+        assert not monitor.get_attr_vals_utf8('pagedresults')
+    finally:
+        ldbmconfig.replace('nsslapd-pagedspillthreshold', '100000')
+        del_users(users_list)
+
+
 @pytest.mark.parametrize("invalid_cookie", [1000, -1])
 def test_search_invalid_cookie(topology_st, create_user, invalid_cookie):
     """Verify that using invalid cookie while performing
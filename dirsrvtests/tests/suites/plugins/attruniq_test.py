@@ -12,7 +12,8 @@ import logging
 from lib389.plugins import AttributeUniquenessPlugin
 from lib389.idm.user import UserAccounts
 from lib389.idm.group import Groups
-from lib389._constants import DEFAULT_SUFFIX
+from lib389._constants import DEFAULT_SUFFIX, LOG_PLUGIN, LOG_DEFAULT
+from lib389 import Entry
 from lib389.topologies import topology_st
 
 pytestmark = pytest.mark.tier1
@@ -80,4 +81,79 @@ def test_modrdn_attr_uniqueness(topology_st):
     log.debug(excinfo.value)
 
     log.debug('Move user2 to group1')
-    user2.rename(f'uid={user2.rdn}', group1.dn)
\ No newline at end of file
+    user2.rename(f'uid={user2.rdn}', group1.dn)
+
+def test_attr_uniqueness_use_index(topology_st):
+    """Test that the values are checked with the equality index lookups
+    when uniqueness-use-index is enabled
+
+    :id: 5b0f3c8e-2a61-4f7d-9d1c-8e4b7a3f0c21
+
+    :setup: Standalone instance
+
+    :steps: 1. Setup PLUGIN_ATTR_UNIQUENESS plugin for the indexed 'telephoneNumber' attribute
+            2. Enable the index lookups, the plugin and the plugin logging
+            3. Add a subentry, as a replication conflict is, with a telephoneNumber
+            4. Add a user with the same telephoneNumber
+            5. Add a user with the same telephoneNumber
+            6. Add a user with another telephoneNumber
+            7. Modify the second user to the value of the first one
+            8. Delete the first user and modify the second one to its value
+
+    :expectedresults:
+            1. Success
+            2. Success
+            3. Success
+            4. Success, the subentry is ignored and the value was
+               checked in the index
+            5. Add operation should FAIL
+            6. Success
+            7. Modify operation should FAIL
+            8. Success
+    """
+    inst = topology_st.standalone
+    phone = '+1 555 0100'
+
+    log.debug('Setup PLUGIN_ATTR_UNIQUENESS plugin for telephoneNumber attribute')
+    attruniq = AttributeUniquenessPlugin(inst, dn="cn=attruniq_index,cn=plugins,cn=config")
+    attruniq.create(properties={'cn': 'attruniq_index'})
+    attruniq.add_unique_attribute('telephoneNumber')
+    attruniq.add_unique_subtree(DEFAULT_SUFFIX)
+    attruniq.enable_index_lookup()
+    attruniq.enable()
+    inst.config.set('nsslapd-errorlog-level', str(LOG_PLUGIN + LOG_DEFAULT))
+    inst.restart()
+
+    log.debug('A subentry with the value, as a conflict entry, is ignored')
+    subentry_dn = f'cn=conflict copy,ou=people,{DEFAULT_SUFFIX}'
+    inst.add_s(Entry((subentry_dn, {
+        'objectClass': ['top', 'ldapsubentry', 'extensibleObject'],
+        'cn': 'conflict copy',
+        'telephoneNumber': phone,
+    })))
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    user1 = users.create_test_user(101)
+    user1.add('telephoneNumber', phone)
+    assert inst.searchErrorsLog(f'search_index - Index lookup under {DEFAULT_SUFFIX} complete')
+
+    log.debug('Add a user with the same telephoneNumber')
+    with pytest.raises(ldap.CONSTRAINT_VIOLATION):
+        user = users.create_test_user(102)
+        user.add('telephoneNumber', phone)
+        log.fatal(f'Failed: Attribute "telephoneNumber" with {phone} is accepted')
+
+    log.debug('Modify a user to the telephoneNumber of another one')
+    user2 = users.get('test_user_102')
+    user2.add('telephoneNumber', '+1 555 0101')
+    with pytest.raises(ldap.CONSTRAINT_VIOLATION):
+        user2.replace('telephoneNumber', phone)
+
+    log.debug('The value can be reused once its entry is deleted')
+    user1.delete()
+    user2.replace('telephoneNumber', phone)
+
+    user2.delete()
+    inst.delete_s(subentry_dn)
+    attruniq.delete()
+    inst.config.set('nsslapd-errorlog-level', str(LOG_DEFAULT))
+    inst.restart()
@@ -12,6 +12,7 @@ Created on Dec 12, 2019
 @author: tbordaz
 '''
 import logging
+import time
 import pytest
 from lib389 import Entry
 from lib389.plugins import ReferentialIntegrityPlugin
@@ -142,6 +143,79 @@ def test_invalid_referint_log(topo):
     assert inst.status()
 
 
+def test_batched_updates(topo):
+    """Check that the batched mode updates all the references to a
+    deleted or renamed entry, immediately and with a delay
+
+    :id: 0c3f5e1a-8d27-4b6e-a4f9-2e71c5d9b803
+    :setup: Standalone Instance
+    :steps:
+        1. Configure the plugin with member and owner and a batch size of 2
+        2. Create users and groups referring to them with member and owner
+        3. Delete a user
+        4. Rename a user
+        5. Set an update delay and delete a user
+    :expectedresults:
+        1. Success
+        2. Success
+        3. All the references to the user are removed
+        4. All the references to the user are renamed
+        5. All the references to the user are removed after the delay
+    """
+
+    inst = topo.standalone
+    plugin = ReferentialIntegrityPlugin(inst)
+    plugin.enable()
+    plugin.replace('referint-membership-attr', ['member', 'owner'])
+    plugin.remove_all('nsslapd-plugincontainerscope')
+    plugin.set_update_delay('0')
+    plugin.set_batch_size(2)
+    inst.restart()
+
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    deleted = users.create_test_user(uid=2001)
+    renamed = users.create_test_user(uid=2002)
+    delayed = users.create_test_user(uid=2003)
+    groups = Groups(inst, DEFAULT_SUFFIX)
+    batch_groups = []
+    for i in range(5):
+        group = groups.create(properties={'cn': f'batch_group_{i}',
+                                          'member': [deleted.dn, renamed.dn, delayed.dn],
+                                          'owner': [deleted.dn, renamed.dn, delayed.dn]})
+        batch_groups.append(group)
+
+    log.info('Delete a user referred by all the groups')
+    deleted_dn = deleted.dn
+    deleted.delete()
+    for group in batch_groups:
+        assert not group.present('member', deleted_dn)
+        assert not group.present('owner', deleted_dn)
+
+    log.info('Rename a user referred by all the groups')
+    renamed_dn = renamed.dn
+    renamed.rename('uid=new_test_user_2002', deloldrdn=False)
+    for group in batch_groups:
+        for attr in ['member', 'owner']:
+            assert not group.present(attr, renamed_dn)
+            assert group.present(attr, renamed.dn)
+
+    log.info('Delete a user with a delayed update')
+    plugin.set_update_delay('2')
+    inst.restart()
+    delayed_dn = delayed.dn
+    delayed.delete()
+    time.sleep(6)
+    for group in batch_groups:
+        assert not group.present('member', delayed_dn)
+        assert not group.present('owner', delayed_dn)
+        assert group.present('member', renamed.dn)
+
+    plugin.set_update_delay('0')
+    plugin.set_batch_size(0)
+    for group in batch_groups:
+        group.delete()
+
+
 if __name__ == '__main__':
     # Run isolated
     # -s for DEBUG mode
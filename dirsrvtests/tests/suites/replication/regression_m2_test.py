@@ -1148,6 +1148,346 @@ def test_bulk_import(preserve_topo_m2):
     assert len(users_s1) == len(users_s2)
 
 
+def test_bulk_import_streams(preserve_topo_m2):
+    """Test a total update sending batches of entries over several connections
+
+    :id: 9b0c57d2-6f4e-4d1b-a3a8-2c51e0f7d6b4
+    :setup: Two suppliers replicated instances
+    :steps:
+        1. Generate and import an LDIF file on supplier1
+        2. Set the total update streams and batch size of the agreement
+        3. Perform the total update
+        4. Check the number of connections the entries were sent over
+        5. Check that the consumer has all the entries of the supplier
+        6. Check that replication is still working
+    :expectedresults:
+        1. Operation successful
+        2. Operation successful
+        3. Operation successful
+        4. All the streams are used if the consumer is on lmdb, only
+           the main connection otherwise
+        5. Replicas should have the same entries
+        6. Replication should be in sync
+    """
+    s1 = preserve_topo_m2.ms["supplier1"]
+    s2 = preserve_topo_m2.ms["supplier2"]
+    ldif_file = f'{s1.get_ldif_dir()}/db3K.ldif'
+    dbgen_users(s1, 3000, ldif_file, DEFAULT_SUFFIX)
+    s1.tasks.importLDIF(benamebase=DEFAULT_BENAME,
+                        input_file=ldif_file,
+                        args={TASK_WAIT: True})
+
+    repl = ReplicationManager(DEFAULT_SUFFIX)
+    repl._create_service_group(s1)
+    repl._create_service_account(s1, s2)
+
+    agmt = Agreements(s1).list()[0]
+    agmt.replace_many(('nsds5ReplicaTotalUpdateStreams', '4'),
+                      ('nsds5ReplicaTotalUpdateBatchSize', '50'))
+    try:
+        agmt.begin_reinit()
+        (done, error) = agmt.wait_reinit()
+        assert done is True
+        assert error is False
+
+        streams = 4 if s2.get_db_lib() == 'mdb' else 1
+        assert s1.searchErrorsLog(f'entries per operation over {streams} connection')
+
+        # Every entry of the suffix, subentries included, must be on the consumer
+        all_filter = "(|(objectclass=*)(objectclass=ldapsubentry))"
+        dns_s1 = {e.dn.lower() for e in s1.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, all_filter, ['dn'],
+                                                    escapehatch='i am sure')}
+        dns_s2 = {e.dn.lower() for e in s2.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, all_filter, ['dn'],
+                                                    escapehatch='i am sure')}
+        log.info(f"{len(dns_s1)} entries on supplier1, {len(dns_s2)} on supplier2")
+        assert len(dns_s1) > 3000
+        assert dns_s1 == dns_s2
+
+        repl.test_replication_topology(preserve_topo_m2)
+    finally:
+        agmt.remove_all('nsds5ReplicaTotalUpdateStreams')
+        agmt.remove_all('nsds5ReplicaTotalUpdateBatchSize')
+
+
+def test_total_update_snapshot(preserve_topo_m2):
+    """Test a total update sending a snapshot of the backend databases
+
+    :id: 4e2f8a61-0c7b-4b9e-9d35-b8a1f6c2e079
+    :setup: Two suppliers replicated instances
+    :steps:
+        1. Generate and import an LDIF file on supplier1
+        2. Set the total update method of the agreement to snapshot
+        3. Perform the total update
+        4. Check that the database records were sent
+        5. Check that the replicas have the same number of users
+        6. Check that replication is still working
+    :expectedresults:
+        1. Operation successful
+        2. Operation successful
+        3. Operation successful
+        4. The snapshot is sent if both replicas are on lmdb, the
+           entries otherwise
+        5. Replicas should have same number of user entries
+        6. Replication should be in sync
+    """
+    s1 = preserve_topo_m2.ms["supplier1"]
+    s2 = preserve_topo_m2.ms["supplier2"]
+    ldif_file = f'{s1.get_ldif_dir()}/db2K.ldif'
+    dbgen_users(s1, 2000, ldif_file, DEFAULT_SUFFIX)
+    s1.tasks.importLDIF(benamebase=DEFAULT_BENAME,
+                        input_file=ldif_file,
+                        args={TASK_WAIT: True})
+
+    repl = ReplicationManager(DEFAULT_SUFFIX)
+    repl._create_service_group(s1)
+    repl._create_service_account(s1, s2)
+
+    agmt = Agreements(s1).list()[0]
+    agmt.replace('nsds5ReplicaTotalUpdateMethod', 'snapshot')
+    try:
+        agmt.begin_reinit()
+        (done, error) = agmt.wait_reinit()
+        assert done is True
+        assert error is False
+
+        if s1.get_db_lib() == 'mdb' and s2.get_db_lib() == 'mdb':
+            assert s1.searchErrorsLog('from a snapshot. Sent')
+        else:
+            assert s1.searchErrorsLog('entries per operation over')
+
+        users_s1 = s1.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, "(uid=*)", escapehatch='i am sure')
+        users_s2 = s2.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, "(uid=*)", escapehatch='i am sure')
+        log.info(f"{len(users_s1)} user entries on supplier1, {len(users_s2)} on supplier2")
+        assert len(users_s1) == len(users_s2)
+
+        repl.test_replication_topology(preserve_topo_m2)
+    finally:
+        agmt.remove_all('nsds5ReplicaTotalUpdateMethod')
+
+
+def test_total_update_snapshot_fractional(preserve_topo_m2):
+    """Test that a fractional agreement sends the entries, not a snapshot
+
+    :id: 0d6b3f27-91e4-4c58-a2f0-7e5c3b19d846
+    :setup: Two suppliers replicated instances
+    :steps:
+        1. Add a user with a telephoneNumber on supplier1
+        2. Exclude telephoneNumber from the total update of the agreement
+           and set its total update method to snapshot
+        3. Perform the total update
+        4. Check that the entries were sent rather than a snapshot
+        5. Check that telephoneNumber was not sent
+    :expectedresults:
+        1. Operation successful
+        2. Operation successful
+        3. Operation successful
+        4. The fallback to the entries is logged
+        5. The user on supplier2 has no telephoneNumber
+    """
+    s1 = preserve_topo_m2.ms["supplier1"]
+    s2 = preserve_topo_m2.ms["supplier2"]
+    users = UserAccounts(s1, DEFAULT_SUFFIX)
+    user = users.create_test_user(uid=3001)
+    user.replace('telephoneNumber', '555-0101')
+
+    agmt = Agreements(s1).list()[0]
+    agmt.replace('nsDS5ReplicatedAttributeListTotal', '(objectclass=*) $ EXCLUDE telephoneNumber')
+    agmt.replace('nsds5ReplicaTotalUpdateMethod', 'snapshot')
+    try:
+        agmt.begin_reinit()
+        (done, error) = agmt.wait_reinit()
+        assert done is True
+        assert error is False
+
+        assert s1.searchErrorsLog('is fractional or strips attributes, sending the entries')
+        assert not s1.searchErrorsLog('from a snapshot. Sent')
+        user_s2 = UserAccount(s2, user.dn)
+        assert user_s2.exists()
+        assert not user_s2.present('telephoneNumber')
+    finally:
+        agmt.remove_all('nsds5ReplicaTotalUpdateMethod')
+        agmt.remove_all('nsDS5ReplicatedAttributeListTotal')
+        user.delete()
+
+
+def test_parallel_apply(preserve_topo_m2):
+    """Test a consumer applying the replicated updates in parallel
+
+    :id: 9b1c7e42-5d3a-4f60-8e27-c4a9d0f31b85
+    :setup: Two suppliers replicated instances
+    :steps:
+        1. Enable the parallel apply on supplier2
+        2. Pause the agreement from supplier1 to supplier2
+        3. Add, modify and delete users on supplier1
+        4. Resume the agreement and wait for the replication
+        5. Check that the replicas have the same users
+        6. Check the parallel apply monitoring of supplier2
+        7. Check that replication is still working
+    :expectedresults:
+        1. Operation successful
+        2. Operation successful
+        3. Operation successful
+        4. Replication should be in sync
+        5. Replicas should have the same user entries
+        6. The updates applied in parallel are counted, and some of them
+           ran at once
+        7. Replication should be in sync
+    """
+    s1 = preserve_topo_m2.ms["supplier1"]
+    s2 = preserve_topo_m2.ms["supplier2"]
+    repl = ReplicationManager(DEFAULT_SUFFIX)
+    replica = Replicas(s2).get(DEFAULT_SUFFIX)
+    replica.replace('nsds5ReplicaParallelApply', 'on')
+    agmt = Agreements(s1).list()[0]
+    try:
+        agmt.pause()
+        users = UserAccounts(s1, DEFAULT_SUFFIX)
+        for idx in range(200):
+            user = users.create_test_user(uid=5000 + idx)
+            user.replace('description', f'parallel apply {idx}')
+            if idx % 4 == 0:
+                user.delete()
+        agmt.resume()
+        repl.wait_for_replication(s1, s2, timeout=120)
+
+        filt = '(uid=test_user_5*)'
+        users_s1 = s1.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, filt, ['description'])
+        users_s2 = s2.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, filt, ['description'])
+        assert len(users_s1) == 150
+        assert sorted((e.dn, e.getValue('description')) for e in users_s1) == \
+               sorted((e.dn, e.getValue('description')) for e in users_s2)
+
+        updates = int(replica.get_attr_val_utf8('nsds5replicaParallelApplyUpdates'))
+        running_max = int(replica.get_attr_val_utf8('nsds5replicaParallelApplyMax'))
+        log.info(f"{updates} updates applied in parallel, at most {running_max} at once")
+        assert updates > 0
+        assert running_max > 1
+
+        repl.test_replication_topology(preserve_topo_m2)
+    finally:
+        agmt.resume()
+        replica.remove_all('nsds5ReplicaParallelApply')
+
+
+def test_parallel_apply_missing_parent(preserve_topo_m2):
+    """Test the adds of siblings under a missing parent applied in parallel
+
+    :id: 6e0d2a94-1f3b-4c87-b5e6-7a9c02d4f13e
+    :setup: Two suppliers replicated instances
+    :steps:
+        1. Enable the parallel apply on supplier2
+        2. Add an organizational unit on supplier1 and wait for the replication
+        3. Pause the agreements, delete the organizational unit on supplier2
+        4. Add users under the organizational unit on supplier1
+        5. Resume the agreement to supplier2 and wait for the replication
+        6. Check that supplier2 has the users under a single glue entry
+        7. Resume the other agreement, remove the users and the glue entries
+        8. Check that replication is still working
+    :expectedresults:
+        1. Operation successful
+        2. Replication should be in sync
+        3. Operation successful
+        4. Operation successful
+        5. Replication should be in sync
+        6. The organizational unit is a glue entry, with no conflict entry
+        7. Operation successful
+        8. Replication should be in sync
+    """
+    s1 = preserve_topo_m2.ms["supplier1"]
+    s2 = preserve_topo_m2.ms["supplier2"]
+    repl = ReplicationManager(DEFAULT_SUFFIX)
+    replica = Replicas(s2).get(DEFAULT_SUFFIX)
+    replica.replace('nsds5ReplicaParallelApply', 'on')
+    ou = OrganizationalUnits(s1, DEFAULT_SUFFIX).create(properties={'ou': 'parallel_glue'})
+    repl.wait_for_replication(s1, s2)
+    agmt_s1 = Agreements(s1).list()[0]
+    agmt_s2 = Agreements(s2).list()[0]
+    try:
+        agmt_s1.pause()
+        agmt_s2.pause()
+        OrganizationalUnits(s2, DEFAULT_SUFFIX).get('parallel_glue').delete()
+        users = UserAccounts(s1, DEFAULT_SUFFIX, rdn='ou=parallel_glue')
+        for idx in range(20):
+            users.create_test_user(uid=6000 + idx)
+        agmt_s1.resume()
+        repl.wait_for_replication(s1, s2, timeout=60)
+
+        glue = s2.search_s(ou.dn, ldap.SCOPE_BASE, '(objectclass=*)', ['objectclass'])
+        assert len(glue) == 1
+        assert b'glue' in [oc.lower() for oc in glue[0].getValues('objectclass')]
+        children = s2.search_s(ou.dn, ldap.SCOPE_ONELEVEL, '(objectclass=*)')
+        assert len(children) == 20
+        conflicts = s2.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE,
+                                '(&(nsds5ReplConflict=*)(|(objectclass=*)(objectclass=ldapsubentry)))')
+        assert len(conflicts) == 0
+    finally:
+        agmt_s1.resume()
+        agmt_s2.resume()
+        replica.remove_all('nsds5ReplicaParallelApply')
+    repl.wait_for_replication(s2, s1, timeout=60)
+    for user in UserAccounts(s1, DEFAULT_SUFFIX, rdn='ou=parallel_glue').list():
+        user.delete()
+    s1.delete_s(ou.dn)
+    repl.wait_for_replication(s1, s2, timeout=60)
+
+    repl.test_replication_topology(preserve_topo_m2)
+
+
+def test_tombstone_reap_batches(preserve_topo_m2):
+    """Test the tombstones are reaped in batches
+
+    :id: 2d6f0b18-7c45-4e93-a1d2-58e3c9f04b67
+    :setup: Two suppliers replicated instances
+    :steps:
+        1. Set a short purge delay and a small reap batch size on supplier1
+        2. Add and delete users on supplier1
+        3. Wait for the purge delay, then update supplier1
+        4. Schedule a tombstone reap on supplier1
+        5. Check that the tombstones of the users are purged
+        6. Check the tombstone reap monitoring of supplier1
+    :expectedresults:
+        1. Operation successful
+        2. Operation successful
+        3. Operation successful
+        4. Operation successful
+        5. No tombstone of the users is left
+        6. The purged tombstones are counted and none is left
+    """
+    s1 = preserve_topo_m2.ms["supplier1"]
+    s2 = preserve_topo_m2.ms["supplier2"]
+    repl = ReplicationManager(DEFAULT_SUFFIX)
+    replica = Replicas(s1).get(DEFAULT_SUFFIX)
+    replica.replace_many(('nsds5ReplicaPurgeDelay', '5'),
+                         ('nsds5ReplicaTombstoneReapBatchSize', '10'))
+    try:
+        users = UserAccounts(s1, DEFAULT_SUFFIX)
+        for idx in range(50):
+            users.create_test_user(uid=6000 + idx).delete()
+        repl.wait_for_replication(s1, s2)
+
+        time.sleep(6)
+        repl.test_replication(s1, s2)
+        replica.replace('nsds5ReplicaTombstonePurgeInterval', '5')
+
+        filt = '(&(objectclass=nsTombstone)(uid=test_user_6*))'
+        for _ in range(30):
+            time.sleep(2)
+            tombstones = s1.search_s(DEFAULT_SUFFIX, ldap.SCOPE_SUBTREE, filt, ['dn'])
+            if not tombstones and replica.get_attr_val_utf8('nsds5replicaReapActive') == '0':
+                break
+        assert len(tombstones) == 0
+
+        purged = int(replica.get_attr_val_utf8('nsds5replicaReapPurged'))
+        backlog = int(replica.get_attr_val_utf8('nsds5replicaReapBacklog'))
+        log.info(f"{purged} tombstones purged, {backlog} left")
+        assert purged >= 50
+        assert backlog == 0
+    finally:
+        replica.remove_all('nsds5ReplicaTombstoneReapBatchSize')
+        replica.remove_all('nsds5ReplicaTombstonePurgeInterval')
+        replica.remove_all('nsds5ReplicaPurgeDelay')
+
+
 def check_monitoring_status(inst):
     creds = { 'binddn': DN_DM, 'bindpw': PW_DM }
     repl_monitor = ReplicationMonitor(inst)
@@ -55,6 +55,7 @@ repl_add_attrs = [('nsDS5ReplicaType', '-1', '4', overflow, notnum, '1'),
                   ('nsds5ReplicaPurgeDelay', '-2', too_big, overflow, notnum, '1'),
                   ('nsDS5ReplicaBindDnGroupCheckInterval', '-2', too_big, overflow, notnum, '1'),
                   ('nsds5ReplicaTombstonePurgeInterval', '-2', too_big, overflow, notnum, '1'),
+                  ('nsds5ReplicaTombstoneReapBatchSize', '0', too_big, overflow, notnum, '100'),
                   ('nsds5ReplicaProtocolTimeout', '-1', too_big, overflow, notnum, '1'),
                   ('nsds5ReplicaReleaseTimeout', '-1', too_big, overflow, notnum, '1'),
                   ('nsds5ReplicaBackoffMin', '0', too_big, overflow, notnum, '3'),
@@ -65,6 +66,7 @@ repl_mod_attrs = [('nsDS5Flags', '-1', '2', overflow, notnum, '1'),
                   ('nsds5ReplicaPurgeDelay', '-2', too_big, overflow, notnum, '1'),
                   ('nsDS5ReplicaBindDnGroupCheckInterval', '-2', too_big, overflow, notnum, '1'),
                   ('nsds5ReplicaTombstonePurgeInterval', '-2', too_big, overflow, notnum, '1'),
+                  ('nsds5ReplicaTombstoneReapBatchSize', '0', too_big, overflow, notnum, '100'),
                   ('nsds5ReplicaProtocolTimeout', '-1', too_big, overflow, notnum, '1'),
                   ('nsds5ReplicaReleaseTimeout', '-1', too_big, overflow, notnum, '1'),
                   ('nsds5ReplicaBackoffMin', '0', too_big, overflow, notnum, '3'),
@@ -7,6 +7,9 @@
 # --- END COPYRIGHT BLOCK ---
 
 import logging
+import os
+import signal
+import time
 import ldap
 import pytest
 from lib389.topologies import topology_st
@@ -424,3 +427,101 @@ if __name__ == '__main__':
     # -s for DEBUG mode
     CURRENT_FILE = os.path.realpath(__file__)
     pytest.main("-s %s" % CURRENT_FILE)
+
+
+def test_retrocl_async_write(topology_st, request):
+    """Test the retro changelog records are written asynchronously
+    in changenumber order
+
+    :id: 8d6a0f3e-54a2-4f0b-9c3d-2e71a4b6c915
+    :setup: Standalone Instance
+    :steps:
+        1. Enable Retro changelog with nsslapd-changelog-async-write
+        2. Do a bunch of updates
+        3. Check the root DSE exposes the write queue
+        4. Wait for the queue to be drained
+        5. Check the changelog records, and their order
+        6. Do more updates and restart the instance
+        7. Check the records queued at shutdown were written
+        8. Do more updates and kill the instance
+        9. Start the instance
+    :expectedresults:
+        1. Success
+        2. Success
+        3. Success
+        4. Success
+        5. There is one record per update, in the order of the updates
+        6. Success
+        7. Success
+        8. Success
+        9. The records queued when the instance was killed are written,
+           and lastchangenumber never exceeds the last record written
+    """
+
+    inst = topology_st.standalone
+    log.info('Configure retrocl plugin')
+    rcl = RetroChangelogPlugin(inst)
+    rcl.replace('nsslapd-include-suffix', DEFAULT_SUFFIX)
+    rcl.replace('nsslapd-changelog-async-write', 'on')
+    rcl.replace('nsslapd-changelog-async-batch-size', '8')
+    rcl.enable()
+    inst.restart()
+
+    def last_changenumber():
+        return int(inst.rootdse.get_attr_val_utf8('lastchangenumber'))
+
+    first = last_changenumber()
+    suffix = Domain(inst, DEFAULT_SUFFIX)
+    for idx in range(0, 50):
+        suffix.replace('description', 'async %d' % idx)
+
+    assert inst.rootdse.present('changelogqueuedepth')
+    assert inst.rootdse.present('changelogwritelag')
+    for _ in range(0, 30):
+        if inst.rootdse.get_attr_val_int('changelogqueuedepth') == 0:
+            break
+        time.sleep(1)
+    assert inst.rootdse.get_attr_val_int('changelogqueuedepth') == 0
+    assert inst.rootdse.get_attr_val_int('lastwrittenchangenumber') == last_changenumber()
+
+    retro_changelog_suffix = DSLdapObjects(inst, basedn=RETROCL_SUFFIX)
+    records = retro_changelog_suffix.filter(f'(&(targetDn={DEFAULT_SUFFIX})(changeNumber>={first + 1}))')
+    changes = {}
+    for rec in records:
+        changes[int(rec.get_attr_val_utf8('changeNumber'))] = rec.get_attr_val_utf8('changes')
+    assert len(changes) == 50
+    for idx, cnum in enumerate(sorted(changes)):
+        assert 'async %d' % idx in changes[cnum]
+
+    # Nothing queued is lost on shutdown
+    base = last_changenumber()
+    for idx in range(0, 50):
+        suffix.replace('description', 'shutdown %d' % idx)
+    assert last_changenumber() <= base + 50
+    inst.restart()
+    assert last_changenumber() == base + 50
+    assert retro_changelog_suffix.filter(f'(changeNumber={base + 50})')
+
+    # Nor on a crash, the queued records are in the journal
+    base = last_changenumber()
+    for idx in range(0, 50):
+        suffix.replace('description', 'crash %d' % idx)
+    with open(inst.pid_file()) as f:
+        os.kill(int(f.readline().strip()), signal.SIGKILL)
+    time.sleep(1)
+    inst.start()
+    assert last_changenumber() == base + 50
+    records = retro_changelog_suffix.filter(f'(&(targetDn={DEFAULT_SUFFIX})(changeNumber>={base + 1}))')
+    changes = {}
+    for rec in records:
+        changes[int(rec.get_attr_val_utf8('changeNumber'))] = rec.get_attr_val_utf8('changes')
+    assert sorted(changes) == list(range(base + 1, base + 51))
+    for idx, cnum in enumerate(sorted(changes)):
+        assert 'crash %d' % idx in changes[cnum]
+
+    def fin():
+        rcl.remove_all('nsslapd-changelog-async-write')
+        rcl.remove_all('nsslapd-changelog-async-batch-size')
+        inst.restart()
+
+    request.addfinalizer(fin)
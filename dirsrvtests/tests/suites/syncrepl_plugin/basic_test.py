@@ -732,3 +732,75 @@ def test_sync_repl_invalid_cookie(topology, request):
             pass
 
     request.addfinalizer(fin)
+
+
+def test_sync_repl_many_persist_clients(topology, init_sync_repl_plugins, request):
+    """Test that more persistent sync_repl clients than worker threads
+       all receive the updates, with progressing cookies
+
+    :id: 5b0c2f4e-8a31-4c7d-9d62-3e7f1a2b6c90
+    :setup: Standalone Instance
+    :steps:
+      1.: initialization/cleanup done by init_sync_repl_plugins fixture
+      2.: allow 16 persistent sessions served by 2 worker threads
+      3.: start 16 sync repl clients
+      4.: create (5) users
+      5.: stop sync repl clients and collect the lists of cookie.change_no
+      6.: check that every client received the same increasing cookies
+    :expectedresults:
+      1.: succeeds
+      2.: succeeds
+      3.: succeeds
+      4.: succeeds
+      5.: succeeds
+      6.: succeeds
+    """
+    inst = topology[0]
+    nb_clients = 16
+
+    plugin = ContentSyncPlugin(inst)
+    plugin.replace_many(('nsslapd-pluginarg0', str(nb_clients)),
+                        ('nsslapd-pluginarg1', '2'))
+    inst.restart()
+
+    sync_repls = [Sync_persist(inst) for _ in range(nb_clients)]
+    for sync_repl in sync_repls:
+        sync_repl.start()
+    time.sleep(5)
+
+    users = UserAccounts(inst, DEFAULT_SUFFIX)
+    users_set = []
+    for i in range(10101, 10106):
+        users_set.append(users.create_test_user(uid=i))
+    time.sleep(5)
+
+    # stop the server to get the sync_repl result sets (exit from while loop).
+    inst.stop()
+    time.sleep(10)
+
+    expected = None
+    for sync_repl in sync_repls:
+        cookies = sync_repl.get_result()
+        assert len(cookies) > 0
+        prev = -1
+        for cookie in cookies:
+            assert int(cookie) > prev
+            prev = int(cookie)
+        if expected is None:
+            expected = cookies
+        assert cookies == expected
+        sync_repl.join()
+    log.info('test_sync_repl_many_persist_clients: PASS\n')
+
+    def fin():
+        inst.restart()
+        plugin.remove_all('nsslapd-pluginarg0')
+        plugin.remove_all('nsslapd-pluginarg1')
+        for user in users_set:
+            try:
+                user.delete()
+            except:
+                pass
+        inst.restart()
+
+    request.addfinalizer(fin)
@@ -0,0 +1,693 @@
+#!/usr/bin/python3
+
+# --- BEGIN COPYRIGHT BLOCK ---
+# Copyright (C) 2026 Red Hat, Inc.
+# All rights reserved.
+#
+# License: GPL (version 3 or any later version).
+# See LICENSE for details.
+# --- END COPYRIGHT BLOCK ---
+#
+
+import os
+import gzip
+import re
+import csv
+import json
+import argparse
+import logging
+import sys
+import threading
+import time
+from collections import defaultdict
+from datetime import datetime
+import ldap
+
+logReplayVersion = "1.0"
+
+# Operations whose content is not in the access log: they are counted
+# but can not be replayed.
+UNREPLAYABLE_OPS = {
+    'ADD': 'ADD', 'MOD': 'MOD', 'MODIFY': 'MOD', 'DEL': 'DEL', 'DELETE': 'DEL',
+    'MODRDN': 'MODRDN', 'CMP': 'CMP', 'COMPARE': 'CMP', 'EXT': 'EXT',
+    'EXTENDED_OP': 'EXT', 'ABANDON': 'ABANDON'
+}
+
+# A replayed operation starting later than this (in seconds) is "late"
+LATE_THRESHOLD = 0.01
+
+
+class replayOp:
+    """
+    One client operation of the access log, and the outcome of its replay.
+    """
+    __slots__ = ('conn', 'op_id', 'time', 'op_type', 'base', 'scope', 'filter',
+                 'attrs', 'etime', 'err', 'nentries', 'replay_etime',
+                 'replay_err', 'replay_nentries', 'late')
+
+    def __init__(self, conn, op_id, timestamp, op_type):
+        self.conn = conn
+        self.op_id = op_id
+        self.time = timestamp
+        self.op_type = op_type
+        self.base = None
+        self.scope = None
+        self.filter = None
+        self.attrs = None
+        self.etime = None
+        self.err = None
+        self.nentries = None
+        self.replay_etime = None
+        self.replay_err = None
+        self.replay_nentries = None
+        self.late = 0.0
+
+    def describe(self):
+        if self.op_type == 'SRCH':
+            return (f'conn={self.conn} op={self.op_id} SRCH base="{self.base}" '
+                    f'scope={self.scope} filter="{self.filter}"')
+        return f'conn={self.conn} op={self.op_id} {self.op_type}'
+
+
+class logReplayer:
+    """
+    Rebuild the per-connection operation streams of access logs (text or
+    JSON format) and replay them against a server.
+    """
+
+    def __init__(self,
+                 ldapurl: str = 'ldap://localhost:389',
+                 bind_dn: str = None,
+                 bind_pw: str = None,
+                 speed: float = 1.0,
+                 threads: int = 0,
+                 max_ops: int = 0,
+                 skip_binds: bool = False,
+                 top: int = 20,
+                 verbose: bool = False):
+
+        self.ldapurl = ldapurl
+        self.bind_dn = bind_dn
+        self.bind_pw = bind_pw
+        self.speed = speed
+        self.threads = threads
+        self.max_ops = max_ops
+        self.skip_binds = skip_binds
+        self.top = top
+        self.verbose = verbose
+        self.logger = self._setup_logger(logging.DEBUG if verbose else logging.INFO)
+
+        # conn key -> list of replayOp, in log order
+        self.streams = defaultdict(list)
+        # (conn key, op id) -> replayOp waiting for its RESULT
+        self.pending = {}
+        # The text logs have no connection key: the conn ids start over
+        # at each restart, detected when a connection opens with an id
+        # lower than the last one.
+        self.restart_ctr = 0
+        self.last_conn_id = 0
+        self.nb_ops = 0
+        self.skipped = defaultdict(int)
+        self.replay_start = None
+        self.replay_stop = None
+        self.log_start = None
+        self.regexes = self._init_regexes()
+
+    def _setup_logger(self, log_level: int):
+        logger = logging.getLogger("logreplay")
+        formatter = logging.Formatter('%(levelname)s - %(message)s')
+        handler = logging.StreamHandler()
+        handler.setFormatter(formatter)
+        logger.handlers.clear()
+        logger.addHandler(handler)
+        logger.setLevel(log_level)
+        return logger
+
+    def _init_regexes(self):
+        """
+        Initialise the regex patterns of the text access log lines that
+        matter for the replay.
+        """
+        TIMESTAMP_PATTERN = r'''
+            \[(?P<timestamp>\d{2}\/[A-Za-z]{3}\/\d{4}:\d{2}:\d{2}:\d{2})(?:\.(?P<nanosecond>\d+))?\s(?P<timezone>[+-]\d{4})\]
+        '''
+        return {
+            'OP': re.compile(rf'''
+                {TIMESTAMP_PATTERN}
+                \sconn=(?P<conn_id>\d+)                             # conn=int (no internal ops)
+                \sop=(?P<op_id>-?\d+)                               # op=int
+                \s(?P<rem>.*)
+            ''', re.VERBOSE),
+            'CONNECTION': re.compile(rf'''
+                {TIMESTAMP_PATTERN}
+                \sconn=(?P<conn_id>\d+)                             # conn=int
+                \sfd=\d+                                            # fd=int
+                \sslot=\d+                                          # slot=int
+                \s(?:SSL\s)?connection\sfrom                        # connection from
+            ''', re.VERBOSE),
+            'SRCH': re.compile(r'''
+                SRCH
+                \sbase="(?P<base>[^"]*)"                            # base="", "string"
+                \sscope=(?P<scope>\d+)                              # scope=int
+                \sfilter="(?P<filter>.*?)"                          # filter="string"
+                \sattrs=(?P<attrs>ALL|"[^"]*")                      # attrs=ALL | attrs="strings"
+                (?P<psearch>\soptions=persistent)?                  # Optional: options=persistent
+            ''', re.VERBOSE),
+            'RESULT': re.compile(r'''
+                RESULT
+                \serr=(?P<err>\d+)                                  # err=int
+                \stag=(?P<tag>\d+)                                  # tag=int
+                \snentries=(?P<nentries>\d+)                        # nentries=int
+                (?:\swtime=\d+\.\d+\soptime=\d+\.\d+)?              # Optional: wtime, optime
+                \setime=(?P<etime>\d+\.\d+)                         # etime=float
+            ''', re.VERBOSE),
+            'JSON_TIME': re.compile(r'''
+                (?P<timestamp>\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2})(?:\.(?P<nanosecond>\d+))?\s*(?P<timezone>[+-]\d{4})?
+            ''', re.VERBOSE)
+        }
+
+    def _to_epoch(self, timestamp: str, nanosecond: str, timezone: str, fmt: str):
+        dt = datetime.strptime(f"{timestamp} {timezone or '+0000'}", f"{fmt} %z")
+        secs = dt.timestamp()
+        if nanosecond:
+            secs += int(nanosecond) / (10 ** len(nanosecond))
+        return secs
+
+    def _new_op(self, key, conn, op_id, timestamp, op_type):
+        if self.log_start is None or timestamp < self.log_start:
+            self.log_start = timestamp
+        op = replayOp(conn, op_id, timestamp, op_type)
+        self.streams[key].append(op)
+        self.pending[(key, op_id)] = op
+        if op_type != 'UNBIND':
+            self.nb_ops += 1
+        return op
+
+    def _skip(self, reason: str):
+        self.skipped[reason] += 1
+
+    def _set_result(self, key, op_id, err, nentries, etime):
+        op = self.pending.pop((key, op_id), None)
+        if op is not None:
+            op.err = int(err)
+            op.nentries = int(nentries)
+            op.etime = float(etime)
+
+    def _process_text_line(self, line: str):
+        match = self.regexes['OP'].match(line)
+        if match is None:
+            match = self.regexes['CONNECTION'].match(line)
+            if match is not None:
+                conn_id = int(match['conn_id'])
+                if conn_id < self.last_conn_id:
+                    self.restart_ctr += 1
+                self.last_conn_id = conn_id
+            return
+        groups = match.groupdict()
+        conn = groups['conn_id']
+        key = (self.restart_ctr, conn)
+        op_id = groups['op_id']
+        rem = groups['rem']
+        op_type = rem.split(' ', 1)[0]
+
+        if op_type == 'RESULT':
+            result = self.regexes['RESULT'].match(rem)
+            if result:
+                self._set_result(key, op_id, result['err'], result['nentries'], result['etime'])
+            return
+        if op_type not in ('SRCH', 'BIND', 'UNBIND') and op_type not in UNREPLAYABLE_OPS:
+            return
+        timestamp = self._to_epoch(groups['timestamp'], groups['nanosecond'],
+                                   groups['timezone'], "%d/%b/%Y:%H:%M:%S")
+
+        if op_type in UNREPLAYABLE_OPS:
+            self._skip(UNREPLAYABLE_OPS[op_type])
+        elif op_type == 'SRCH':
+            srch = self.regexes['SRCH'].match(rem)
+            if srch is None or srch['base'].endswith('...') or srch['filter'].endswith('...'):
+                self._skip('truncated')
+            elif srch['psearch']:
+                self._skip('persistent')
+            else:
+                op = self._new_op(key, conn, op_id, timestamp, 'SRCH')
+                op.base = srch['base']
+                op.scope = int(srch['scope'])
+                op.filter = srch['filter']
+                if srch['attrs'] != 'ALL':
+                    attrs = srch['attrs'].strip('"')
+                    op.attrs = [a for a in attrs.split(' ') if a and not a.endswith('...')]
+        elif op_type == 'BIND':
+            if self.skip_binds:
+                self._skip('BIND')
+            else:
+                self._new_op(key, conn, op_id, timestamp, 'BIND')
+        elif op_type == 'UNBIND':
+            self._new_op(key, conn, op_id, timestamp, 'UNBIND')
+
+    def _process_json_line(self, action: dict):
+        if 'header' in action or action.get('internal_op'):
+            return
+        operation = action.get('operation')
+        if 'op_id' not in action:
+            return
+        # The connection key survives the conn_id reuse across restarts
+        conn = str(action.get('conn_id'))
+        key = action.get('key', conn)
+        op_id = str(action['op_id'])
+
+        if operation == 'RESULT':
+            self._set_result(key, op_id, action.get('err', 0), action.get('nentries', 0),
+                             action.get('etime', 0))
+            return
+        if operation not in ('SEARCH', 'BIND', 'UNBIND') and operation not in UNREPLAYABLE_OPS:
+            return
+        tmatch = self.regexes['JSON_TIME'].match(action.get('local_time', ''))
+        if tmatch is None:
+            self._skip('time format')
+            return
+        timestamp = self._to_epoch(tmatch['timestamp'], tmatch['nanosecond'],
+                                   tmatch['timezone'], "%Y-%m-%dT%H:%M:%S")
+
+        if operation in UNREPLAYABLE_OPS:
+            self._skip(UNREPLAYABLE_OPS[operation])
+        elif operation == 'SEARCH':
+            if action.get('psearch'):
+                self._skip('persistent')
+                return
+            op = self._new_op(key, conn, op_id, timestamp, 'SRCH')
+            op.base = action.get('base_dn', '')
+            op.scope = int(action.get('scope', 2))
+            op.filter = action.get('filter', '(objectClass=*)')
+            if action.get('attrs'):
+                op.attrs = [a for a in action['attrs'] if a != '...']
+        elif operation == 'BIND':
+            if self.skip_binds:
+                self._skip('BIND')
+            else:
+                self._new_op(key, conn, op_id, timestamp, 'BIND')
+        elif operation == 'UNBIND':
+            self._new_op(key, conn, op_id, timestamp, 'UNBIND')
+
+    def _open_log(self, filepath: str):
+        with open(filepath, 'rb') as f:
+            magic = f.read(2)
+        if magic == b'\x1f\x8b':
+            return gzip.open(filepath, 'rt', encoding='utf-8', errors='replace')
+        return open(filepath, 'r', encoding='utf-8', errors='replace')
+
+    def process_file(self, filepath: str):
+        """
+        Parse one access log, text or JSON (including json-pretty) format.
+        """
+        self.logger.info(f"Parsing {filepath} ...")
+        jobj = None
+        with self._open_log(filepath) as f:
+            for line in f:
+                if self.max_ops and self.nb_ops >= self.max_ops:
+                    break
+                line = line.rstrip('\n')
+                if jobj is not None:
+                    # json-pretty: accumulate until the closing brace
+                    jobj += line.strip()
+                    if line == '}':
+                        self._process_json_text(jobj)
+                        jobj = None
+                    continue
+                if line.startswith('{'):
+                    if line.rstrip().endswith('}'):
+                        self._process_json_text(line)
+                    else:
+                        jobj = line.strip()
+                elif line.startswith('['):
+                    try:
+                        self._process_text_line(line)
+                    except ValueError as e:
+                        self.logger.debug(f"Skipping line {line}: {e}")
+
+    def _process_json_text(self, text: str):
+        try:
+            self._process_json_line(json.loads(text))
+        except ValueError as e:
+            self.logger.debug(f"Skipping json {text}: {e}")
+
+    def _connect(self):
+        conn = ldap.initialize(self.ldapurl)
+        conn.set_option(ldap.OPT_PROTOCOL_VERSION, ldap.VERSION3)
+        conn.set_option(ldap.OPT_REFERRALS, 0)
+        self._bind(conn)
+        return conn
+
+    def _bind(self, conn):
+        # Passwords are not logged: every bind uses the replay credentials
+        conn.simple_bind_s(self.bind_dn or '', self.bind_pw or '')
+
+    def _run_op(self, conn, op):
+        start = time.monotonic()
+        try:
+            if op.op_type == 'SRCH':
+                msgid = conn.search_ext(op.base, op.scope, op.filter, op.attrs)
+                nentries = 0
+                while True:
+                    rtype, rdata, rmsgid, rctrls = conn.result3(msgid, all=0)
+                    if rtype == ldap.RES_SEARCH_ENTRY:
+                        nentries += len(rdata)
+                    elif rtype == ldap.RES_SEARCH_RESULT:
+                        break
+                op.replay_nentries = nentries
+            elif op.op_type == 'BIND':
+                self._bind(conn)
+                op.replay_nentries = 0
+            op.replay_err = 0
+        except ldap.LDAPError as e:
+            info = e.args[0] if e.args and isinstance(e.args[0], dict) else {}
+            op.replay_err = info.get('result', -1)
+            op.replay_nentries = 0
+        op.replay_etime = time.monotonic() - start
+
+    def _due(self, op):
+        return self.replay_start + (op.time - self.log_start) / self.speed
+
+    def _replay_stream(self, ops, slots):
+        """
+        Replay the operations of one connection, in order, each one at its
+        (scaled) original offset from the beginning of the log.
+        """
+        conn = None
+        try:
+            for op in ops:
+                if self.speed > 0:
+                    delay = self._due(op) - time.monotonic()
+                    if delay > 0:
+                        time.sleep(delay)
+                    else:
+                        op.late = -delay
+                if op.op_type == 'UNBIND':
+                    break
+                if conn is None:
+                    conn = self._connect()
+                self._run_op(conn, op)
+        except ldap.LDAPError as e:
+            self.logger.error(f"Connection {ops[0].conn} failed: {e}")
+        finally:
+            if conn is not None:
+                try:
+                    conn.unbind_s()
+                except ldap.LDAPError:
+                    pass
+            if slots is not None:
+                slots.release()
+
+    def replay(self):
+        """
+        Replay each connection in its own thread, started at the (scaled)
+        time of its first operation, so that the connections overlap as
+        they did in the log.  With self.threads, at most that number of
+        connections are replayed at a time and the others start late.
+        """
+        # Results may be missing for ops cut at the end of a log
+        streams = [ops for ops in self.streams.values()
+                   if any(op.op_type != 'UNBIND' for op in ops)]
+        streams.sort(key=lambda ops: ops[0].time)
+        slots = threading.Semaphore(self.threads) if self.threads > 0 else None
+
+        limit = f"at most {self.threads}" if slots else "all"
+        self.logger.info(f"Replaying {self.nb_ops} operations of {len(streams)} connections "
+                         f"({limit} concurrently) against {self.ldapurl} ...")
+        self.replay_start = time.monotonic()
+        workers = []
+        for ops in streams:
+            if self.speed > 0:
+                delay = self._due(ops[0]) - time.monotonic()
+                if delay > 0:
+                    time.sleep(delay)
+            if slots is not None:
+                slots.acquire()
+            worker = threading.Thread(target=self._replay_stream, args=(ops, slots), daemon=True)
+            worker.start()
+            workers.append(worker)
+            # Forget the connections already replayed
+            workers = [w for w in workers if w.is_alive()]
+        for w in workers:
+            w.join()
+        self.replay_stop = time.monotonic()
+
+    @staticmethod
+    def percentile(values: list, pct: float):
+        if not values:
+            return 0.0
+        values = sorted(values)
+        idx = min(len(values) - 1, max(0, int(round(pct / 100.0 * len(values) + 0.5)) - 1))
+        return values[idx]
+
+    def _replayed_ops(self):
+        return [op for ops in self.streams.values() for op in ops
+                if op.replay_etime is not None]
+
+    def display_report(self):
+        """
+        Compare the replayed etimes with the original ones.  The replay
+        etime is measured on the client side, so it includes the network
+        round trip.
+        """
+        ops = self._replayed_ops()
+        elapsed = (self.replay_stop or 0) - (self.replay_start or 0)
+        print(f"\nReplayed operations:        {len(ops)}")
+        print(f"Replay duration:            {elapsed:.3f} seconds")
+        if self.speed > 0:
+            print(f"Speed factor:               {self.speed}")
+        else:
+            print("Speed factor:               none (as fast as possible)")
+        for reason, count in sorted(self.skipped.items()):
+            print(f"Skipped ({reason}):{' ' * max(1, 17 - len(reason))}{count}")
+        late = [op for op in ops if op.late > LATE_THRESHOLD]
+        print(f"Late starts (> {int(LATE_THRESHOLD * 1000)}ms):       {len(late)}")
+        mismatch_err = [op for op in ops if op.err is not None and op.err != op.replay_err]
+        mismatch_nentries = [op for op in ops if op.op_type == 'SRCH' and op.nentries is not None
+                             and op.nentries != op.replay_nentries]
+        print(f"Result code mismatches:     {len(mismatch_err)}")
+        print(f"Entry count mismatches:     {len(mismatch_nentries)}")
+
+        print("\n----- Etimes (seconds) -----\n")
+        print(f"{'Operation':<10} {'Count':>8} {'Orig avg':>10} {'Orig p50':>10} {'Orig p99':>10}"
+              f" {'Replay avg':>10} {'Replay p50':>10} {'Replay p99':>10}")
+        by_type = defaultdict(list)
+        for op in ops:
+            by_type[op.op_type].append(op)
+        by_type['ALL'] = ops
+        for op_type in sorted(by_type.keys(), key=lambda t: (t == 'ALL', t)):
+            type_ops = by_type[op_type]
+            orig = [op.etime for op in type_ops if op.etime is not None]
+            replay = [op.replay_etime for op in type_ops]
+            orig_avg = sum(orig) / len(orig) if orig else 0.0
+            replay_avg = sum(replay) / len(replay) if replay else 0.0
+            print(f"{op_type:<10} {len(type_ops):>8} {orig_avg:>10.6f} {self.percentile(orig, 50):>10.6f}"
+                  f" {self.percentile(orig, 99):>10.6f} {replay_avg:>10.6f}"
+                  f" {self.percentile(replay, 50):>10.6f} {self.percentile(replay, 99):>10.6f}")
+
+        regressions = sorted([op for op in ops if op.etime is not None],
+                             key=lambda op: op.replay_etime - op.etime, reverse=True)[:self.top]
+        if regressions:
+            print(f"\n----- Top {len(regressions)} Slower Operations (replay etime - original etime) -----\n")
+            for op in regressions:
+                print(f"{op.replay_etime - op.etime:+.6f}  orig={op.etime:.6f} replay={op.replay_etime:.6f}"
+                      f"  {op.describe()}")
+        if mismatch_err:
+            print(f"\n----- Top {min(len(mismatch_err), self.top)} Result Code Mismatches -----\n")
+            for op in mismatch_err[:self.top]:
+                print(f"orig err={op.err} replay err={op.replay_err}  {op.describe()}")
+
+    def write_csv(self, filename: str):
+        with open(filename, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['conn', 'op', 'operation', 'orig_etime', 'replay_etime', 'orig_err',
+                             'replay_err', 'orig_nentries', 'replay_nentries', 'late'])
+            for op in sorted(self._replayed_ops(), key=lambda op: op.time):
+                writer.writerow([op.conn, op.op_id, op.op_type, op.etime, f"{op.replay_etime:.6f}",
+                                 op.err, op.replay_err, op.nentries, op.replay_nentries,
+                                 f"{op.late:.6f}"])
+
+
+def main():
+    """
+    Entry point for the Access Log Replay script.
+
+    Rebuilds the client connections recorded in server access logs and
+    replays their operations against a (test) server, then compares the
+    replayed etimes with the logged ones.
+    """
+    parser = argparse.ArgumentParser(
+        description="Replay server access logs against a server and compare the etimes.",
+        formatter_class=argparse.RawTextHelpFormatter,
+        epilog="""
+    Only the searches and binds can be replayed: the access log does not
+    record the content of the write operations nor the passwords. Binds are
+    replayed with the -D/-w credentials, and the skipped operations are counted.
+
+    Examples:
+
+    Replay a log with its original timing:
+        logreplay.py -H ldap://test.example.com:389 -D "cn=Directory Manager" -w password /var/log/dirsrv/slapd-host/access
+
+    Replay twice as fast with at most 50 concurrent connections:
+        logreplay.py -H ldap://test.example.com:389 --speed 2 --threads 50 /var/log/dirsrv/slapd-host/access*
+
+    Replay as fast as possible and write the per operation results:
+        logreplay.py -H ldap://test.example.com:389 --speed 0 --csv replay.csv /var/log/dirsrv/slapd-host/access
+    """
+    )
+
+    parser.add_argument(
+        'logs',
+        type=str,
+        nargs='*',
+        help='Single or multiple (*) access logs, text or JSON format'
+    )
+
+    general_group = parser.add_argument_group("General options")
+    general_group.add_argument(
+        '-v', '--version',
+        action='store_true',
+        help='Display log replay version'
+    )
+    general_group.add_argument(
+        '-V', '--verbose',
+        action='store_true',
+        help='Enable verbose mode'
+    )
+
+    connection_group = parser.add_argument_group("Connection options")
+    connection_group.add_argument(
+        '-H', '--ldapurl',
+        type=str,
+        metavar="LDAP_URL",
+        default="ldap://localhost:389",
+        help='LDAP URL of the server to replay against.\nDefault: "ldap://localhost:389"'
+    )
+    connection_group.add_argument(
+        '-D', '--bindDN',
+        type=str,
+        metavar="BIND_DN",
+        help='DN used by the replayed connections and binds.\nDefault: anonymous'
+    )
+    connection_group.add_argument(
+        '-w', '--bindPW',
+        type=str,
+        metavar="BIND_PW",
+        help='Password of the bind DN'
+    )
+    connection_group.add_argument(
+        '-y', '--bindPWFile',
+        type=str,
+        metavar="BIND_PW_FILE",
+        help='File containing the password of the bind DN'
+    )
+
+    replay_group = parser.add_argument_group("Replay options")
+    replay_group.add_argument(
+        '-s', '--speed',
+        type=float,
+        metavar="SPEED",
+        default=1.0,
+        help='Timing scale factor: 1 keeps the original timing, 2 replays twice as fast,\n'
+             '0 replays as fast as possible.\nDefault: 1'
+    )
+    replay_group.add_argument(
+        '-t', '--threads',
+        type=int,
+        metavar="THREADS",
+        default=0,
+        help='Maximum number of connections replayed concurrently, each one in its own thread.\n'
+             'Default: no limit, every connection starts at the time of its first operation'
+    )
+    replay_group.add_argument(
+        '-n', '--maxOps',
+        type=int,
+        metavar="MAX_OPS",
+        default=0,
+        help='Replay at most this number of operations.\nDefault: no limit'
+    )
+    replay_group.add_argument(
+        '-B', '--skipBinds',
+        action='store_true',
+        help='Do not replay the binds of the log'
+    )
+
+    report_group = parser.add_argument_group("Reporting options")
+    report_group.add_argument(
+        '-r', '--reportSize',
+        type=int,
+        metavar="SIZE",
+        default=20,
+        help='Number of operations listed per report category.\nDefault: 20'
+    )
+    report_group.add_argument(
+        '-c', '--csv',
+        type=str,
+        metavar="CSV_FILENAME",
+        help='Write the original and replayed results of each operation to a csv file'
+    )
+
+    args = parser.parse_args()
+
+    if args.version:
+        print(f"Access Log Replay {logReplayVersion}")
+        sys.exit(0)
+
+    if not args.logs:
+        print("No logs provided. Use '-h' for help.")
+        sys.exit(1)
+
+    if args.speed < 0 or args.threads < 0:
+        print("The speed and the number of threads must be >= 0.")
+        sys.exit(1)
+
+    bind_pw = args.bindPW
+    if args.bindPWFile:
+        with open(args.bindPWFile) as f:
+            bind_pw = f.readline().rstrip('\n')
+
+    replayer = logReplayer(
+        ldapurl=args.ldapurl,
+        bind_dn=args.bindDN,
+        bind_pw=bind_pw,
+        speed=args.speed,
+        threads=args.threads,
+        max_ops=args.maxOps,
+        skip_binds=args.skipBinds,
+        top=args.reportSize,
+        verbose=args.verbose)
+
+    print(f"Access Log Replay {logReplayVersion}")
+
+    # Sanitise list of log files, and sort them by creation time
+    existing_logs = [
+        file for file in args.logs
+        if not re.search(r'access\.rotationinfo', file) and os.path.isfile(file)
+    ]
+    if not existing_logs:
+        replayer.logger.error("No log files provided.")
+        sys.exit(1)
+    existing_logs.sort(key=lambda x: os.path.getctime(x))
+
+    try:
+        for accesslog in existing_logs:
+            replayer.process_file(accesslog)
+    except OSError as e:
+        replayer.logger.error(f"Failed to read the logs: {e}")
+        sys.exit(1)
+
+    if replayer.nb_ops == 0:
+        replayer.logger.error("No replayable operation found in the logs.")
+        sys.exit(1)
+
+    replayer.replay()
+    replayer.display_report()
+    if args.csv:
+        replayer.write_csv(args.csv)
+        print(f"\nPer operation results written to {args.csv}")
+
+    print("Done.")
+
+
+if __name__ == "__main__":
+    main()
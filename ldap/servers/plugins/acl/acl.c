@@ -12,6 +12,7 @@
 #endif
 
 #include "acl.h"
+#include "slapd-probes.h"
 
 
 /****************************************************************************
@@ -304,6 +305,7 @@ acl_access_allowed(
     }
 
     TNF_PROBE_1_DEBUG(acl_access_allowed_start, "ACL", "", tnf_int, access, access);
+    SLAPD_PROBE1(acl__eval__entry, access);
 
     decision_reason.deciding_aci = NULL;
     decision_reason.reason = ACL_REASON_NONE;
@@ -346,6 +348,7 @@ acl_access_allowed(
                           o_connid, o_opid,
                           acl_access2str(access),
                           n_edn);
+            SLAPD_PROBE2(acl__eval__return, access, LDAP_UNWILLING_TO_PERFORM);
             return LDAP_UNWILLING_TO_PERFORM;
         }
     }
@@ -359,6 +362,7 @@ acl_access_allowed(
                       o_connid, o_opid,
                       acl_access2str(access),
                       n_edn);
+        SLAPD_PROBE2(acl__eval__return, access, LDAP_SUCCESS);
         return (LDAP_SUCCESS);
     }
     TNF_PROBE_0_DEBUG(acl_skipaccess_end, "ACL", "");
@@ -720,6 +724,7 @@ cleanup_and_ret:
     TNF_PROBE_0_DEBUG(acl_cleanup_end, "ACL", "");
 
     TNF_PROBE_0_DEBUG(acl_access_allowed_end, "ACL", "");
+    SLAPD_PROBE2(acl__eval__return, access, ret_val);
 
     return (ret_val);
 }
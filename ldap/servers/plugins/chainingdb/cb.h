@@ -64,6 +64,10 @@
 #define CB_MONITOR_COMPARECOUNT "nsCompareCount"
 #define CB_MONITOR_OUTGOINGCONN "nsOpenOpConnectionCount"
 #define CB_MONITOR_OUTGOINGBINDCOUNT "nsOpenBindConnectionCount"
+#define CB_MONITOR_INFLIGHT "nsOperationsInFlight"
+#define CB_MONITOR_INFLIGHTPEAK "nsOperationsInFlightPeak"
+#define CB_MONITOR_INFLIGHTWAITS "nsOperationsInFlightWaitCount"
+#define CB_MONITOR_LATENCY "nsFarmResponseTimeHistogram"
 
 /* Global configuration */
 #define CB_CONFIG_GLOBAL_FORWARD_CTRLS "nsTransmittedControls"
@@ -92,6 +96,8 @@
 #define CB_CONFIG_MAXCONNECTIONS "nsOperationConnectionsLimit"
 #define CB_CONFIG_MAXCONCURRENCY "nsConcurrentOperationsLimit"
 #define CB_CONFIG_MAXBINDCONCURRENCY "nsConcurrentBindLimit"
+#define CB_CONFIG_MULTIPLEX "nsMultiplexOperations"
+#define CB_CONFIG_MAXINFLIGHT "nsMaxOperationsInFlight"
 
 #define CB_CONFIG_IMPERSONATION "nsProxiedAuthorization"
 
@@ -136,6 +142,8 @@
 #define CB_DEF_MAX_TEST_TIME "15"        /* CB_CONFIG_MAX_TEST_TIME */
 #define CB_DEF_STARTTLS "off"            /* CB_CONFIG_STARTTLS */
 #define CB_DEF_BINDMECH LDAP_SASL_SIMPLE /* CB_CONFIG_BINDMECH */
+#define CB_DEF_MULTIPLEX "off"           /* CB_CONFIG_MULTIPLEX */
+#define CB_DEF_MAXINFLIGHT "0"           /* CB_CONFIG_MAXINFLIGHT, 0 means no limit */
 
 #define CB_SIMPLE_BINDMECH "SIMPLE" /* will be translated to LDAP_SASL_SIMPLE */
 
@@ -227,9 +235,45 @@ typedef struct _cb_backend
 #define ENABLE_MULTITHREAD_PER_CONN 1  /* to allow multiple threads to perform LDAP operations on a connection */
 #define DISABLE_MULTITHREAD_PER_CONN 0 /* to allow only one thread to perform LDAP operations on a connection */
 
+/* result reader states (multiplexed connections) */
+#define CB_READER_NONE 0    /* no reader, operations call ldap_result() themselves */
+#define CB_READER_RUNNING 1 /* reader thread dispatches results by message id */
+#define CB_READER_STOPPING 2
+#define CB_READER_FAILED 3  /* ldap_result() failed, the connection is unusable */
+
+/* how often the reader thread checks if it has been asked to stop (usec) */
+#define CB_READER_POLL_USEC 250000
+
+/*
+ * Farm response time histogram: bucket i counts the operations that
+ * completed in less than 2^i milliseconds, the last one everything slower.
+ */
+#define CB_LATENCY_BUCKETS 16
+
+/* A result message queued by the reader thread for an operation */
+typedef struct _cb_pending_msg
+{
+    LDAPMessage *msg;
+    int type;
+    struct _cb_pending_msg *next;
+} cb_pending_msg;
+
+/* An operation sent on an outgoing connection and not yet completed */
+typedef struct _cb_pending_op
+{
+    int msgid;
+    struct timespec start;  /* when the request was sent */
+    Slapi_CondVar *cv;      /* signalled when msgs is no longer empty */
+    cb_pending_msg *msgs;   /* results received, in arrival order */
+    cb_pending_msg *last;
+    struct _cb_pending_op *next;
+} cb_pending_op;
+
 /**************  WARNING: Be careful if you want to change this constant. It is used in hexadecimal in cb_conn_stateless.c in the function PR_ThreadSelf() ************/
 #define MAX_CONN_ARRAY 2048 /* we suppose the number of threads in the server not to exceed this limit*/
 /**********************************************************************************************************/
+struct _cb_conn_pool;
+
 typedef struct _cb_outgoing_conn
 {
     LDAP *ld;
@@ -238,9 +282,15 @@ typedef struct _cb_outgoing_conn
     time_t opentime;
     int status;
     int ThreadId; /* usefull to identify the thread when SSL is enabled */
+
+    struct _cb_conn_pool *pool;  /* owning pool, for the farm statistics */
+    Slapi_Mutex *pending_lock;   /* protects pending and reader_state */
+    cb_pending_op *pending;      /* operations in progress on this connection */
+    PRThread *reader;            /* result reader thread (multiplexed mode) */
+    int reader_state;            /* CB_READER_XXX */
 } cb_outgoing_conn;
 
-typedef struct
+typedef struct _cb_conn_pool
 {
     char *hostname; /* Farm server name */
     char *url;
@@ -265,8 +315,20 @@ typedef struct
         cb_outgoing_conn *conn_list;
         unsigned int conn_list_count;
 
+        int multiplex;            /* dedicated result reader per connection */
+        unsigned int maxinflight; /* max outstanding operations, 0 = no limit */
+        unsigned int inflight;    /* outstanding operations on this farm */
+
     } conn;
 
+    /* Farm statistics, updated atomically */
+    struct
+    {
+        uint64_t inflight_peak;
+        uint64_t inflight_waits;
+        uint64_t latency[CB_LATENCY_BUCKETS];
+    } stats;
+
     cb_outgoing_conn *connarray[MAX_CONN_ARRAY]; /* array of secure connections */
 
     /* To protect the config set by LDAP */
@@ -392,6 +454,15 @@ typedef struct _cb_searchContext
 
 
 int cb_get_connection(cb_conn_pool *pool, LDAP **ld, cb_outgoing_conn **cnx, struct timespec *expire_time, char **errmsg);
+int cb_conn_start_reader(cb_outgoing_conn *cnx);
+void cb_conn_stop_reader(cb_outgoing_conn *cnx);
+void cb_conn_send_begin(cb_outgoing_conn *cnx);
+void cb_conn_send_end(cb_outgoing_conn *cnx, int rc, int msgid);
+void cb_conn_forget_op(cb_outgoing_conn *cnx, int msgid);
+void cb_conn_abandon_op(cb_outgoing_conn *cnx, int msgid);
+void cb_conn_purge_ops(cb_outgoing_conn *cnx);
+int cb_conn_usable(cb_outgoing_conn *cnx);
+int cb_result(cb_outgoing_conn *cnx, int msgid, int all, struct timeval *timeout, LDAPMessage **result);
 int cb_config(cb_backend_instance *cb, int argc, char **argv);
 int cb_update_controls(Slapi_PBlock *pb, LDAP *ld, LDAPControl ***controls, int ctrl_flags);
 int cb_is_control_forwardable(cb_backend *cb, char *controloid);
@@ -400,7 +471,7 @@ int cb_forward_operation(Slapi_PBlock *op);
 int cb_parse_instance_config_entry(cb_backend *cb, Slapi_Entry *e);
 int cb_abandon_connection(cb_backend_instance *cb, Slapi_PBlock *pb, LDAP **ld);
 int cb_atoi(char *str);
-int cb_check_forward_abandon(cb_backend_instance *cb, Slapi_PBlock *pb, LDAP *ld, int msgid);
+int cb_check_forward_abandon(cb_backend_instance *cb, Slapi_PBlock *pb, cb_outgoing_conn *cnx, int msgid);
 int cb_search_monitor_callback(Slapi_PBlock *pb, Slapi_Entry *e, Slapi_Entry *e2, int *ret, char *t, void *a);
 int cb_config_load_dse_info(Slapi_PBlock *pb);
 int cb_config_add_dse_entries(cb_backend *cb, char **entries, char *string1, char *string2, char *string3);
@@ -33,11 +33,12 @@ chaining_back_abandon(Slapi_PBlock *pb __attribute__((unused)))
 }
 
 int
-cb_check_forward_abandon(cb_backend_instance *cb, Slapi_PBlock *pb, LDAP *ld, int msgid)
+cb_check_forward_abandon(cb_backend_instance *cb, Slapi_PBlock *pb, cb_outgoing_conn *cnx, int msgid)
 {
 
     int rc;
     LDAPControl **ctrls = NULL;
+    LDAP *ld = cnx->ld;
 
     if (slapi_op_abandoned(pb)) {
 
@@ -51,6 +52,7 @@ cb_check_forward_abandon(cb_backend_instance *cb, Slapi_PBlock *pb, LDAP *ld, in
             return 0;
         }
         rc = ldap_abandon_ext(ld, msgid, ctrls, NULL);
+        cb_conn_forget_op(cnx, msgid);
         cb_release_op_connection(cb->pool, ld, CB_LDAP_CONN_ERROR(rc));
         if (NULL != ctrls)
             ldap_controls_free(ctrls);
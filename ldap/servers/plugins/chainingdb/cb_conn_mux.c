@@ -0,0 +1,425 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "cb.h"
+
+/*
+ * Result dispatching on the outgoing operation connections.
+ *
+ * Every operation sent to a farm server is recorded on its connection
+ * (cb_conn_send_begin/cb_conn_send_end) and waits for its results through
+ * cb_result().
+ *
+ * 1) By default (nsMultiplexOperations: off) cb_result() is a thin wrapper
+ *    around ldap_result() called by the worker thread itself: the records
+ *    are only used to compute the farm response time.
+ *
+ * 2) In multiplexed mode a reader thread is started for each connection of
+ *    the operation pool.  It is the only thread calling ldap_result() on the
+ *    connection: it reads every message, whatever its message id, and queues
+ *    it on the matching record.  Workers just sleep on the record condition
+ *    variable, so many operations can share a connection without competing
+ *    for the socket, and the nsConcurrentOperationsLimit can be raised a lot
+ *    (a few connections are then enough for a high latency farm).
+ *
+ * 3) The sender holds pending_lock while the request is written, so the
+ *    operation is always recorded before the reader can dispatch its first
+ *    result.  The reader only queues messages on existing records: the
+ *    results of an operation nobody waits for anymore are freed right away.
+ *
+ * 4) An operation given up before its final result (abandon, timeout, bad
+ *    message, ...) must be forgotten (cb_conn_forget_op), and abandoned on
+ *    the farm server if it may still be running (cb_conn_abandon_op), before
+ *    the connection is released.  The remaining records are freed when the
+ *    connection is closed, once the reader is stopped.
+ */
+
+static cb_pending_op *
+cb_conn_find_op(cb_outgoing_conn *cnx, int msgid, cb_pending_op **prev)
+{
+    cb_pending_op *op;
+    cb_pending_op *p = NULL;
+
+    for (op = cnx->pending; op != NULL; op = op->next) {
+        if (op->msgid == msgid) {
+            break;
+        }
+        p = op;
+    }
+    if (prev) {
+        *prev = p;
+    }
+    return op;
+}
+
+/* pending_lock must be held */
+static cb_pending_op *
+cb_conn_get_op(cb_outgoing_conn *cnx, int msgid)
+{
+    cb_pending_op *op = cb_conn_find_op(cnx, msgid, NULL);
+
+    if (op == NULL) {
+        op = (cb_pending_op *)slapi_ch_calloc(1, sizeof(cb_pending_op));
+        op->msgid = msgid;
+        op->cv = slapi_new_condvar(cnx->pending_lock);
+        clock_gettime(CLOCK_MONOTONIC, &op->start);
+        op->next = cnx->pending;
+        cnx->pending = op;
+    }
+    return op;
+}
+
+static void
+cb_conn_free_op(cb_pending_op *op)
+{
+    cb_pending_msg *m, *next;
+
+    for (m = op->msgs; m != NULL; m = next) {
+        next = m->next;
+        ldap_msgfree(m->msg);
+        slapi_ch_free((void **)&m);
+    }
+    slapi_destroy_condvar(op->cv);
+    slapi_ch_free((void **)&op);
+}
+
+/* pending_lock must be held */
+static void
+cb_conn_unlink_op(cb_outgoing_conn *cnx, int msgid)
+{
+    cb_pending_op *prev = NULL;
+    cb_pending_op *op = cb_conn_find_op(cnx, msgid, &prev);
+
+    if (op) {
+        if (prev) {
+            prev->next = op->next;
+        } else {
+            cnx->pending = op->next;
+        }
+        cb_conn_free_op(op);
+    }
+}
+
+static int
+cb_is_final_result(int type)
+{
+    return (type != LDAP_RES_SEARCH_ENTRY) &&
+           (type != LDAP_RES_SEARCH_REFERENCE) &&
+           (type != LDAP_RES_INTERMEDIATE);
+}
+
+static void
+cb_record_latency(cb_conn_pool *pool, struct timespec *start)
+{
+    struct timespec now;
+    struct timespec diff;
+    uint64_t msec;
+    int i;
+
+    if (pool == NULL) {
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    slapi_timespec_diff(&now, start, &diff);
+    msec = (uint64_t)diff.tv_sec * 1000 + diff.tv_nsec / 1000000;
+
+    for (i = 0; i < CB_LATENCY_BUCKETS - 1; i++) {
+        if (msec < ((uint64_t)1 << i)) {
+            break;
+        }
+    }
+    slapi_atomic_incr_64(&pool->stats.latency[i], __ATOMIC_RELAXED);
+}
+
+/*
+ * To be called right before sending a request on cnx: the results can
+ * not be dispatched until cb_conn_send_end() is called.
+ */
+void
+cb_conn_send_begin(cb_outgoing_conn *cnx)
+{
+    slapi_lock_mutex(cnx->pending_lock);
+}
+
+/*
+ * Remember that msgid was just sent on cnx, if the request was sent
+ * (rc is the LDAP code returned by the ldap_XXX_ext() call).
+ */
+void
+cb_conn_send_end(cb_outgoing_conn *cnx, int rc, int msgid)
+{
+    if (rc == LDAP_SUCCESS) {
+        cb_conn_get_op(cnx, msgid);
+    }
+    slapi_unlock_mutex(cnx->pending_lock);
+}
+
+/*
+ * The caller is not interested in the results of msgid anymore
+ * (typically because it has been abandoned).  The results queued and
+ * the ones still to come are dropped.
+ */
+void
+cb_conn_forget_op(cb_outgoing_conn *cnx, int msgid)
+{
+    slapi_lock_mutex(cnx->pending_lock);
+    cb_conn_unlink_op(cnx, msgid);
+    slapi_unlock_mutex(cnx->pending_lock);
+}
+
+/*
+ * Give up msgid before its final result: it is abandoned on the farm
+ * server unless it has already completed, then forgotten.
+ */
+void
+cb_conn_abandon_op(cb_outgoing_conn *cnx, int msgid)
+{
+    cb_pending_op *op;
+    cb_pending_msg *m;
+    int running = 0;
+
+    slapi_lock_mutex(cnx->pending_lock);
+    if ((op = cb_conn_find_op(cnx, msgid, NULL)) != NULL) {
+        running = 1;
+        for (m = op->msgs; m != NULL; m = m->next) {
+            if (cb_is_final_result(m->type)) {
+                running = 0;
+            }
+        }
+        cb_conn_unlink_op(cnx, msgid);
+    }
+    slapi_unlock_mutex(cnx->pending_lock);
+
+    if (running) {
+        (void)ldap_abandon_ext(cnx->ld, msgid, NULL, NULL);
+    }
+}
+
+/*
+ * Free every record of the connection.  Called when the connection is
+ * closed, after the reader is stopped: the remaining records can only be
+ * leftovers of failed operations.
+ */
+void
+cb_conn_purge_ops(cb_outgoing_conn *cnx)
+{
+    cb_pending_op *op, *next;
+
+    slapi_lock_mutex(cnx->pending_lock);
+    for (op = cnx->pending; op != NULL; op = next) {
+        next = op->next;
+        cb_conn_free_op(op);
+    }
+    cnx->pending = NULL;
+    slapi_unlock_mutex(cnx->pending_lock);
+}
+
+/*
+ * Returns 0 if the reader thread of a multiplexed connection has died,
+ * the connection must not be handed out anymore.
+ */
+int
+cb_conn_usable(cb_outgoing_conn *cnx)
+{
+    int usable;
+
+    slapi_lock_mutex(cnx->pending_lock);
+    usable = (cnx->reader_state != CB_READER_FAILED);
+    slapi_unlock_mutex(cnx->pending_lock);
+    return usable;
+}
+
+static void
+cb_conn_reader_thread(void *arg)
+{
+    cb_outgoing_conn *cnx = (cb_outgoing_conn *)arg;
+    struct timeval poll_to;
+    LDAPMessage *res;
+    cb_pending_op *op;
+    cb_pending_msg *m;
+    int rc, msgid;
+
+    if (cb_debug_on()) {
+        slapi_log_err(SLAPI_LOG_PLUGIN, CB_PLUGIN_SUBSYSTEM,
+                      "cb_conn_reader_thread - reader started for conn 0x%p\n", cnx);
+    }
+
+    for (;;) {
+        slapi_lock_mutex(cnx->pending_lock);
+        if (cnx->reader_state != CB_READER_RUNNING) {
+            slapi_unlock_mutex(cnx->pending_lock);
+            break;
+        }
+        slapi_unlock_mutex(cnx->pending_lock);
+
+        poll_to.tv_sec = 0;
+        poll_to.tv_usec = CB_READER_POLL_USEC;
+        res = NULL;
+        rc = ldap_result(cnx->ld, LDAP_RES_ANY, LDAP_MSG_ONE, &poll_to, &res);
+        if (rc == 0) {
+            continue;
+        }
+
+        msgid = (rc == -1) ? -1 : ldap_msgid(res);
+        slapi_lock_mutex(cnx->pending_lock);
+        if (rc == -1 || msgid <= 0) {
+            /* Connection lost or unsolicited notification: wake up everybody */
+            slapi_log_err(SLAPI_LOG_PLUGIN, CB_PLUGIN_SUBSYSTEM,
+                          "cb_conn_reader_thread - conn 0x%p failed (%d)\n", cnx,
+                          slapi_ldap_get_lderrno(cnx->ld, NULL, NULL));
+            if (cnx->reader_state == CB_READER_RUNNING) {
+                cnx->reader_state = CB_READER_FAILED;
+            }
+            for (op = cnx->pending; op != NULL; op = op->next) {
+                slapi_notify_condvar(op->cv, 1);
+            }
+            slapi_unlock_mutex(cnx->pending_lock);
+            ldap_msgfree(res);
+            break;
+        }
+
+        op = cb_conn_find_op(cnx, msgid, NULL);
+        if (op == NULL) {
+            /* Forgotten operation: nobody is waiting for this message */
+            ldap_msgfree(res);
+        } else {
+            m = (cb_pending_msg *)slapi_ch_malloc(sizeof(cb_pending_msg));
+            m->msg = res;
+            m->type = rc;
+            m->next = NULL;
+            if (op->last) {
+                op->last->next = m;
+            } else {
+                op->msgs = m;
+            }
+            op->last = m;
+            slapi_notify_condvar(op->cv, 0);
+        }
+        slapi_unlock_mutex(cnx->pending_lock);
+    }
+
+    if (cb_debug_on()) {
+        slapi_log_err(SLAPI_LOG_PLUGIN, CB_PLUGIN_SUBSYSTEM,
+                      "cb_conn_reader_thread - reader stopped for conn 0x%p\n", cnx);
+    }
+}
+
+/*
+ * Start the result reader of a newly opened connection.
+ * Returns LDAP_SUCCESS or LDAP_OPERATIONS_ERROR.
+ */
+int
+cb_conn_start_reader(cb_outgoing_conn *cnx)
+{
+    cnx->reader_state = CB_READER_RUNNING;
+    cnx->reader = PR_CreateThread(PR_USER_THREAD,
+                                  cb_conn_reader_thread,
+                                  (void *)cnx,
+                                  PR_PRIORITY_NORMAL,
+                                  PR_GLOBAL_THREAD,
+                                  PR_JOINABLE_THREAD,
+                                  SLAPD_DEFAULT_THREAD_STACKSIZE);
+    if (cnx->reader == NULL) {
+        slapi_log_err(SLAPI_LOG_ERR, CB_PLUGIN_SUBSYSTEM,
+                      "cb_conn_start_reader - Unable to create the result reader thread\n");
+        cnx->reader_state = CB_READER_NONE;
+        return LDAP_OPERATIONS_ERROR;
+    }
+    return LDAP_SUCCESS;
+}
+
+/*
+ * Stop the result reader, if any.  Must be called before unbinding.
+ */
+void
+cb_conn_stop_reader(cb_outgoing_conn *cnx)
+{
+    cb_pending_op *op;
+
+    if (cnx->reader == NULL) {
+        return;
+    }
+    slapi_lock_mutex(cnx->pending_lock);
+    cnx->reader_state = CB_READER_STOPPING;
+    for (op = cnx->pending; op != NULL; op = op->next) {
+        slapi_notify_condvar(op->cv, 1);
+    }
+    slapi_unlock_mutex(cnx->pending_lock);
+
+    (void)PR_JoinThread(cnx->reader);
+    cnx->reader = NULL;
+}
+
+/*
+ * Drop-in replacement of ldap_result() for the operation connections.
+ * Returns the message type, 0 on timeout and -1 on error, like ldap_result().
+ * In multiplexed mode, results are always returned one at a time.
+ */
+int
+cb_result(cb_outgoing_conn *cnx, int msgid, int all, struct timeval *timeout, LDAPMessage **result)
+{
+    cb_pending_op *op;
+    cb_pending_msg *m;
+    int rc;
+
+    *result = NULL;
+
+    if (cnx->reader == NULL) {
+        rc = ldap_result(cnx->ld, msgid, all, timeout, result);
+        if (rc > 0 && cb_is_final_result(rc)) {
+            slapi_lock_mutex(cnx->pending_lock);
+            op = cb_conn_find_op(cnx, msgid, NULL);
+            if (op) {
+                cb_record_latency(cnx->pool, &op->start);
+                cb_conn_unlink_op(cnx, msgid);
+            }
+            slapi_unlock_mutex(cnx->pending_lock);
+        }
+        return rc;
+    }
+
+    slapi_lock_mutex(cnx->pending_lock);
+    if ((op = cb_conn_find_op(cnx, msgid, NULL)) == NULL) {
+        /* Not sent or already forgotten */
+        slapi_unlock_mutex(cnx->pending_lock);
+        return -1;
+    }
+    while (op->msgs == NULL && cnx->reader_state == CB_READER_RUNNING) {
+        if (!slapi_wait_condvar_pt(op->cv, cnx->pending_lock, timeout)) {
+            /* Timed out: let the caller check abandon and time limits */
+            slapi_unlock_mutex(cnx->pending_lock);
+            return 0;
+        }
+    }
+
+    if ((m = op->msgs) == NULL) {
+        /* The reader died, the error is set in the LDAP handle */
+        slapi_unlock_mutex(cnx->pending_lock);
+        return -1;
+    }
+
+    op->msgs = m->next;
+    if (op->msgs == NULL) {
+        op->last = NULL;
+    }
+    rc = m->type;
+    *result = m->msg;
+    slapi_ch_free((void **)&m);
+
+    if (cb_is_final_result(rc)) {
+        cb_record_latency(cnx->pool, &op->start);
+        cb_conn_unlink_op(cnx, msgid);
+    }
+    slapi_unlock_mutex(cnx->pending_lock);
+
+    return rc;
+}
@@ -49,6 +49,14 @@
  *    that we reconnect to a primary server after failover occurs.  If no
  *    lifetime is configured or it is set to 0, we never close and reopen
  *    connections.
+ *
+ * 8) With nsMultiplexOperations, a result reader thread is attached to each
+ *    non secure operation connection (see cb_conn_mux.c).  A connection
+ *    whose reader failed is treated like a connection marked "down".
+ *
+ * 9) nsMaxOperationsInFlight caps the number of operations outstanding on
+ *    the farm server, whatever the number of connections they use.  Threads
+ *    exceeding it wait on the pool condition variable like in 5).
  */
 
 static void cb_close_and_dispose_connection(cb_outgoing_conn *conn);
@@ -140,7 +148,7 @@ cb_get_connection(cb_conn_pool *pool,
     LDAP *ld = NULL;
     int checktime = 0;
     struct timeval bind_to, op_to;
-    unsigned int maxconcurrency, maxconnections;
+    unsigned int maxconcurrency, maxconnections, maxinflight;
     char *password, *binddn, *hostname;
     unsigned int port;
     int secure;
@@ -148,6 +156,7 @@ cb_get_connection(cb_conn_pool *pool,
     ;
     static char *error1 = "Can't contact remote server : %s";
     int isMultiThread = ENABLE_MULTITHREAD_PER_CONN; /* by default, we enable multiple operations per connection */
+    int multiplex;
 
     struct timespec cb_expire_time;
 
@@ -164,6 +173,8 @@ cb_get_connection(cb_conn_pool *pool,
     slapi_rwlock_rdlock(pool->rwl_config_lock);
     maxconcurrency = pool->conn.maxconcurrency;
     maxconnections = pool->conn.maxconnections;
+    maxinflight = pool->conn.maxinflight;
+    multiplex = pool->conn.multiplex;
     bind_to.tv_sec = pool->conn.bind_timeout.tv_sec;
     bind_to.tv_usec = pool->conn.bind_timeout.tv_usec;
     op_to.tv_sec = pool->conn.op_timeout.tv_sec;
@@ -191,6 +202,8 @@ cb_get_connection(cb_conn_pool *pool,
 
     if (secure) {
         isMultiThread = DISABLE_MULTITHREAD_PER_CONN;
+        /* per thread connections, nothing to multiplex */
+        multiplex = 0;
     }
 
     /* For stupid admins */
@@ -265,6 +278,24 @@ cb_get_connection(cb_conn_pool *pool,
             goto unlock_and_return;
         }
 
+        /*
+         * Per farm limit of outstanding operations
+         */
+
+        if (maxinflight > 0 && pool->conn.inflight >= maxinflight) {
+            struct timeval inflight_to = {1, 0};
+
+            if (cb_debug_on()) {
+                slapi_log_err(SLAPI_LOG_PLUGIN, CB_PLUGIN_SUBSYSTEM,
+                              "cb_get_connection - server %s has %u operations in flight, waiting\n",
+                              hostname, pool->conn.inflight);
+            }
+            slapi_atomic_incr_64(&pool->stats.inflight_waits, __ATOMIC_RELAXED);
+            /* bounded wait so that the time limit is checked */
+            slapi_wait_condvar_pt(pool->conn.conn_list_cv, pool->conn.conn_list_mutex, &inflight_to);
+            continue;
+        }
+
         /*
          * First, look for an available, already open/bound connection
          */
@@ -289,6 +320,10 @@ cb_get_connection(cb_conn_pool *pool,
                                   conn->status, conn->refcount);
                 }
 
+                if (conn->status == CB_CONNSTATUS_OK && conn->reader && !cb_conn_usable(conn)) {
+                    /* result reader failed, close it when released */
+                    conn->status = CB_CONNSTATUS_DOWN;
+                }
                 if (conn->status == CB_CONNSTATUS_OK && conn->refcount < maxconcurrency) {
                     if (cb_debug_on()) {
                         slapi_log_err(SLAPI_LOG_PLUGIN, CB_PLUGIN_SUBSYSTEM,
@@ -449,13 +484,20 @@ cb_get_connection(cb_conn_pool *pool,
                 }
             }
 
-            conn = (cb_outgoing_conn *)slapi_ch_malloc(sizeof(cb_outgoing_conn));
+            conn = (cb_outgoing_conn *)slapi_ch_calloc(1, sizeof(cb_outgoing_conn));
             conn->ld = ld;
             conn->status = CB_CONNSTATUS_OK;
             conn->refcount = 0; /* incremented below */
             conn->opentime = slapi_current_rel_time_t();
             conn->ThreadId = PR_MyThreadId(); /* store the thread id */
             conn->next = NULL;
+            conn->pool = pool;
+            conn->pending_lock = slapi_new_mutex();
+            conn->reader_state = CB_READER_NONE;
+            if (multiplex) {
+                /* not fatal if it fails, the workers then read their own results */
+                (void)cb_conn_start_reader(conn);
+            }
             if (secure) {
                 if (pool->connarray[PR_ThreadSelf()] == NULL) {
                     pool->connarray[PR_ThreadSelf()] = conn;
@@ -499,6 +541,10 @@ cb_get_connection(cb_conn_pool *pool,
 unlock_and_return:
     if (conn != NULL) {
         ++conn->refcount;
+        ++pool->conn.inflight;
+        if (pool->conn.inflight > pool->stats.inflight_peak) {
+            slapi_atomic_store_64(&pool->stats.inflight_peak, pool->conn.inflight, __ATOMIC_RELAXED);
+        }
         *lld = conn->ld;
         *cc = conn;
         if (cb_debug_on()) {
@@ -561,6 +607,9 @@ cb_release_op_connection(cb_conn_pool *pool, LDAP *lld, int dispose)
     } else {
 
         --conn->refcount;
+        if (pool->conn.inflight > 0) {
+            --pool->conn.inflight;
+        }
 
         if (cb_debug_on()) {
             slapi_log_err(SLAPI_LOG_PLUGIN, CB_PLUGIN_SUBSYSTEM,
@@ -605,7 +654,7 @@ cb_release_op_connection(cb_conn_pool *pool, LDAP *lld, int dispose)
           * wake up a thread that is waiting for a connection
      */
 
-    if (!secure)
+    if (!secure || pool->conn.maxinflight > 0)
         slapi_notify_condvar(pool->conn.conn_list_cv, 0);
 
     slapi_unlock_mutex(pool->conn.conn_list_mutex);
@@ -615,8 +664,11 @@ cb_release_op_connection(cb_conn_pool *pool, LDAP *lld, int dispose)
 static void
 cb_close_and_dispose_connection(cb_outgoing_conn *conn)
 {
+    cb_conn_stop_reader(conn);
+    cb_conn_purge_ops(conn);
     slapi_ldap_unbind(conn->ld);
     conn->ld = NULL;
+    slapi_destroy_mutex(conn->pending_lock);
     slapi_ch_free((void **)&conn);
 }
 
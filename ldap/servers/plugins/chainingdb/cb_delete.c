@@ -133,7 +133,9 @@ chaining_back_delete(Slapi_PBlock *pb)
     /*
      * Send LDAP operation to the remote host
      */
+    cb_conn_send_begin(cnx);
     rc = ldap_delete_ext(ld, dn, ctrls, NULL, &msgid);
+    cb_conn_send_end(cnx, rc, msgid);
     ldap_controls_free(ctrls);
     if (rc != LDAP_SUCCESS) {
         cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL,
@@ -143,15 +145,16 @@ chaining_back_delete(Slapi_PBlock *pb)
     }
 
     while (1) {
-        if (cb_check_forward_abandon(cb, pb, ld, msgid)) {
+        if (cb_check_forward_abandon(cb, pb, cnx, msgid)) {
             return -1;
         }
 
-        rc = ldap_result(ld, msgid, 0, &cb->abandon_timeout, &res);
+        rc = cb_result(cnx, msgid, 0, &cb->abandon_timeout, &res);
         switch (rc) {
         case -1:
             cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL,
                                 ldap_err2string(rc), 0, NULL);
+            cb_conn_abandon_op(cnx, msgid);
             cb_release_op_connection(cb->pool, ld, CB_LDAP_CONN_ERROR(rc));
             ldap_msgfree(res);
             return -1;
@@ -162,6 +165,7 @@ chaining_back_delete(Slapi_PBlock *pb)
                 /*cb_send_ldap_result(pb,LDAP_OPERATIONS_ERROR, NULL,
                     ldap_err2string(rc), 0, NULL);*/
                 cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL, "FARM SERVER TEMPORARY UNAVAILABLE", 0, NULL);
+                cb_conn_abandon_op(cnx, msgid);
                 cb_release_op_connection(cb->pool, ld, CB_LDAP_CONN_ERROR(rc));
                 ldap_msgfree(res);
                 return -1;
@@ -45,6 +45,8 @@ static void *cb_instance_timelimit_get(void *arg);
 static void *cb_instance_hoplimit_get(void *arg);
 static void *cb_instance_max_idle_get(void *arg);
 static void *cb_instance_max_test_get(void *arg);
+static void *cb_instance_multiplex_get(void *arg);
+static void *cb_instance_maxinflight_get(void *arg);
 
 
 /* Set functions */
@@ -71,6 +73,8 @@ static int cb_instance_timelimit_set(void *arg, void *value, char *errorbuf, int
 static int cb_instance_hoplimit_set(void *arg, void *value, char *errorbuf, int phase, int apply);
 static int cb_instance_max_idle_set(void *arg, void *value, char *errorbuf, int phase, int apply);
 static int cb_instance_max_test_set(void *arg, void *value, char *errorbuf, int phase, int apply);
+static int cb_instance_multiplex_set(void *arg, void *value, char *errorbuf, int phase, int apply);
+static int cb_instance_maxinflight_set(void *arg, void *value, char *errorbuf, int phase, int apply);
 
 /* Default hardwired values */
 
@@ -97,6 +101,8 @@ cb_instance_config_info cb_the_instance_config[] = {
     {CB_CONFIG_MAX_TEST_TIME, CB_CONFIG_TYPE_INT, CB_DEF_MAX_TEST_TIME, &cb_instance_max_test_get, &cb_instance_max_test_set, CB_ALWAYS_SHOW},
     {CB_CONFIG_STARTTLS, CB_CONFIG_TYPE_ONOFF, CB_DEF_STARTTLS, &cb_instance_starttls_get, &cb_instance_starttls_set, CB_ALWAYS_SHOW},
     {CB_CONFIG_BINDMECH, CB_CONFIG_TYPE_STRING, CB_DEF_BINDMECH, &cb_instance_bindmech_get, &cb_instance_bindmech_set, CB_ALWAYS_SHOW},
+    {CB_CONFIG_MULTIPLEX, CB_CONFIG_TYPE_ONOFF, CB_DEF_MULTIPLEX, &cb_instance_multiplex_get, &cb_instance_multiplex_set, CB_ALWAYS_SHOW},
+    {CB_CONFIG_MAXINFLIGHT, CB_CONFIG_TYPE_INT, CB_DEF_MAXINFLIGHT, &cb_instance_maxinflight_get, &cb_instance_maxinflight_set, CB_ALWAYS_SHOW},
     {NULL, 0, NULL, NULL, NULL, 0}};
 
 /* Others forward declarations */
@@ -1172,6 +1178,68 @@ cb_instance_maxconc_set(void *arg, void *value, char *errorbuf __attribute__((un
     return LDAP_SUCCESS;
 }
 
+static void *
+cb_instance_multiplex_get(void *arg)
+{
+    cb_backend_instance *inst = (cb_backend_instance *)arg;
+    uintptr_t data;
+
+    slapi_rwlock_rdlock(inst->rwl_config_lock);
+    data = inst->pool->conn.multiplex;
+    slapi_rwlock_unlock(inst->rwl_config_lock);
+    return (void *)data;
+}
+
+static int
+cb_instance_multiplex_set(void *arg, void *value, char *errorbuf __attribute__((unused)), int phase, int apply)
+{
+    cb_backend_instance *inst = (cb_backend_instance *)arg;
+    int rc = LDAP_SUCCESS;
+
+    if (apply) {
+        /* Only the operation pool: bind connections carry the client identity */
+        slapi_rwlock_wrlock(inst->rwl_config_lock);
+        inst->pool->conn.multiplex = (int)((uintptr_t)value);
+        slapi_rwlock_unlock(inst->rwl_config_lock);
+        if ((phase != CB_CONFIG_PHASE_INITIALIZATION) &&
+            (phase != CB_CONFIG_PHASE_STARTUP)) {
+            rc = CB_REOPEN_CONN; /* reconnect with the new mode */
+        }
+    }
+    return rc;
+}
+
+static void *
+cb_instance_maxinflight_get(void *arg)
+{
+    cb_backend_instance *inst = (cb_backend_instance *)arg;
+    uintptr_t data;
+
+    slapi_rwlock_rdlock(inst->rwl_config_lock);
+    data = inst->pool->conn.maxinflight;
+    slapi_rwlock_unlock(inst->rwl_config_lock);
+    return (void *)data;
+}
+
+static int
+cb_instance_maxinflight_set(void *arg, void *value, char *errorbuf, int phase __attribute__((unused)), int apply)
+{
+    cb_backend_instance *inst = (cb_backend_instance *)arg;
+    int maxinflight = (int)((uintptr_t)value);
+
+    if (maxinflight < 0) {
+        PR_snprintf(errorbuf, SLAPI_DSE_RETURNTEXT_SIZE, "%s must be positive or 0 (no limit)",
+                    CB_CONFIG_MAXINFLIGHT);
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+    if (apply) {
+        slapi_rwlock_wrlock(inst->rwl_config_lock);
+        inst->pool->conn.maxinflight = (unsigned int)maxinflight;
+        slapi_rwlock_unlock(inst->rwl_config_lock);
+    }
+    return LDAP_SUCCESS;
+}
+
 static void *
 cb_instance_imperson_get(void *arg)
 {
@@ -43,6 +43,11 @@ extern cb_instance_config_info cb_the_instance_config[];
 **        outgoingopconnections
 **        outgoingbindconnections
 **
+**    Farm server load
+**        operationsinflight (current, peak, waits on the limit)
+**        farm response time histogram, one value per bucket
+**        "<Nms:count", the last bucket being ">=Nms:count"
+**
 */
 
 int
@@ -59,8 +64,12 @@ cb_search_monitor_callback(Slapi_PBlock *pb __attribute__((unused)),
     struct berval *vals[2];
     unsigned long deletecount, addcount, modifycount, modrdncount, searchbasecount, searchonelevelcount;
     unsigned long searchsubtreecount, abandoncount, bindcount, unbindcount, comparecount;
-    unsigned int outgoingconn, outgoingbindconn;
+    unsigned int outgoingconn, outgoingbindconn, inflight;
+    struct berval latvals[CB_LATENCY_BUCKETS];
+    struct berval *latvalp[CB_LATENCY_BUCKETS + 1];
+    char latbuf[CB_LATENCY_BUCKETS][64];
     cb_backend_instance *inst = (cb_backend_instance *)arg;
+    int i;
 
     /* First make sure the backend instance is configured */
     /* If not, don't return anything              */
@@ -98,6 +107,7 @@ cb_search_monitor_callback(Slapi_PBlock *pb __attribute__((unused)),
 
     slapi_lock_mutex(inst->pool->conn.conn_list_mutex);
     outgoingconn = inst->pool->conn.conn_list_count;
+    inflight = inst->pool->conn.inflight;
     slapi_unlock_mutex(inst->pool->conn.conn_list_mutex);
 
     slapi_lock_mutex(inst->bind_pool->conn.conn_list_mutex);
@@ -169,6 +179,35 @@ cb_search_monitor_callback(Slapi_PBlock *pb __attribute__((unused)),
     val.bv_len = strlen(buf);
     slapi_entry_attr_replace(e, CB_MONITOR_OUTGOINGBINDCOUNT, (struct berval **)vals);
 
+    sprintf(buf, "%u", inflight);
+    val.bv_val = buf;
+    val.bv_len = strlen(buf);
+    slapi_entry_attr_replace(e, CB_MONITOR_INFLIGHT, (struct berval **)vals);
+
+    sprintf(buf, "%" PRIu64, slapi_atomic_load_64(&inst->pool->stats.inflight_peak, __ATOMIC_RELAXED));
+    val.bv_val = buf;
+    val.bv_len = strlen(buf);
+    slapi_entry_attr_replace(e, CB_MONITOR_INFLIGHTPEAK, (struct berval **)vals);
+
+    sprintf(buf, "%" PRIu64, slapi_atomic_load_64(&inst->pool->stats.inflight_waits, __ATOMIC_RELAXED));
+    val.bv_val = buf;
+    val.bv_len = strlen(buf);
+    slapi_entry_attr_replace(e, CB_MONITOR_INFLIGHTWAITS, (struct berval **)vals);
+
+    for (i = 0; i < CB_LATENCY_BUCKETS; i++) {
+        uint64_t count = slapi_atomic_load_64(&inst->pool->stats.latency[i], __ATOMIC_RELAXED);
+        if (i < CB_LATENCY_BUCKETS - 1) {
+            PR_snprintf(latbuf[i], sizeof(latbuf[i]), "<%dms:%" PRIu64, 1 << i, count);
+        } else {
+            PR_snprintf(latbuf[i], sizeof(latbuf[i]), ">=%dms:%" PRIu64, 1 << (i - 1), count);
+        }
+        latvals[i].bv_val = latbuf[i];
+        latvals[i].bv_len = strlen(latbuf[i]);
+        latvalp[i] = &latvals[i];
+    }
+    latvalp[CB_LATENCY_BUCKETS] = NULL;
+    slapi_entry_attr_replace(e, CB_MONITOR_LATENCY, latvalp);
+
     *returnCode = LDAP_SUCCESS;
     return (SLAPI_DSE_CALLBACK_OK);
 }
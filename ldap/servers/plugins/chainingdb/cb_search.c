@@ -239,8 +239,10 @@ chainingdb_build_candidate_list(Slapi_PBlock *pb)
         endtime = slapi_current_rel_time_t() + cb->max_idle_time;
     }
 
+    cb_conn_send_begin(cnx);
     rc = ldap_search_ext(ld, target, scope, filter, attrs, attrsonly,
                          ctrls, NULL, &timeout, sizelimit, &(ctx->msgid));
+    cb_conn_send_end(cnx, rc, ctx->msgid);
 
     ldap_controls_free(ctrls);
 
@@ -258,12 +260,12 @@ chainingdb_build_candidate_list(Slapi_PBlock *pb)
 
     doit = 1;
     while (doit) {
-        if (cb_check_forward_abandon(cb, pb, ctx->ld, ctx->msgid)) {
+        if (cb_check_forward_abandon(cb, pb, ctx->cnx, ctx->msgid)) {
             slapi_ch_free((void **)&ctx);
             return 1;
         }
 
-        rc = ldap_result(ld, ctx->msgid, LDAP_MSG_ONE, &cb->abandon_timeout, &res);
+        rc = cb_result(cnx, ctx->msgid, LDAP_MSG_ONE, &cb->abandon_timeout, &res);
         switch (rc) {
         case -1:
             /* An error occurred. return now */
@@ -275,6 +277,7 @@ chainingdb_build_candidate_list(Slapi_PBlock *pb)
             } else {
                 cb_send_ldap_result(pb, rc, NULL, NULL, 0, NULL);
             }
+            cb_conn_abandon_op(cnx, ctx->msgid);
             cb_release_op_connection(cb->pool, ld, CB_LDAP_CONN_ERROR(rc));
             ldap_msgfree(res);
             slapi_ch_free((void **)&ctx);
@@ -288,6 +291,7 @@ chainingdb_build_candidate_list(Slapi_PBlock *pb)
                 cb_send_ldap_result(pb, LDAP_TIMELIMIT_EXCEEDED,
                                     NULL, NULL, 0, NULL);
                 /* Force connection close */
+                cb_conn_abandon_op(cnx, ctx->msgid);
                 cb_release_op_connection(cb->pool, ld, 1);
                 ldap_msgfree(res);
                 slapi_ch_free((void **)&ctx);
@@ -297,6 +301,7 @@ chainingdb_build_candidate_list(Slapi_PBlock *pb)
             if ((rc = cb_ping_farm(cb, cnx, endtime)) != LDAP_SUCCESS) {
                 cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL,
                                     ldap_err2string(rc), 0, NULL);
+                cb_conn_abandon_op(cnx, ctx->msgid);
                 cb_release_op_connection(cb->pool, ld, CB_LDAP_CONN_ERROR(rc));
                 ldap_msgfree(res);
                 slapi_ch_free((void **)&ctx);
@@ -507,7 +512,7 @@ chainingdb_next_search_entry(Slapi_PBlock *pb)
 
     while (1) {
 
-        if (cb_check_forward_abandon(cb, pb, ctx->ld, ctx->msgid)) {
+        if (cb_check_forward_abandon(cb, pb, ctx->cnx, ctx->msgid)) {
             /* cnx handle released */
             ldap_msgfree(ctx->pending_result);
             slapi_ch_free((void **)&ctx);
@@ -527,8 +532,8 @@ chainingdb_next_search_entry(Slapi_PBlock *pb)
         } else {
 
 
-            rc = ldap_result(ctx->ld, ctx->msgid,
-                             LDAP_MSG_ONE, &cb->abandon_timeout, &res);
+            rc = cb_result(ctx->cnx, ctx->msgid,
+                           LDAP_MSG_ONE, &cb->abandon_timeout, &res);
         }
 
         /* The server can return three types of results back to the client,
@@ -551,6 +556,7 @@ chainingdb_next_search_entry(Slapi_PBlock *pb)
             cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL, ldap_err2string(rc), 0, NULL);
 
             ldap_msgfree(res);
+            cb_conn_abandon_op(ctx->cnx, ctx->msgid);
             cb_release_op_connection(cb->pool, ctx->ld, CB_LDAP_CONN_ERROR(rc));
             slapi_ch_free((void **)&ctx);
             return -1;
@@ -565,6 +571,7 @@ chainingdb_next_search_entry(Slapi_PBlock *pb)
                                     ldap_err2string(rc), 0, NULL);
 
                 ldap_msgfree(res);
+                cb_conn_abandon_op(ctx->cnx, ctx->msgid);
                 cb_release_op_connection(cb->pool, ctx->ld, CB_LDAP_CONN_ERROR(rc));
                 slapi_ch_free((void **)&ctx);
                 return -1;
@@ -590,6 +597,7 @@ chainingdb_next_search_entry(Slapi_PBlock *pb)
                 cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL, NULL, 0, NULL);
 
                 ldap_msgfree(res);
+                cb_conn_abandon_op(ctx->cnx, ctx->msgid);
                 cb_release_op_connection(cb->pool, ctx->ld, 0);
                 slapi_ch_free((void **)&ctx);
                 return -1;
@@ -617,6 +625,7 @@ chainingdb_next_search_entry(Slapi_PBlock *pb)
             if (parse_rc != LDAP_SUCCESS) {
                 cb_send_ldap_result(pb, LDAP_OPERATIONS_ERROR, NULL,
                                     ldap_err2string(parse_rc), 0, NULL);
+                cb_conn_abandon_op(ctx->cnx, ctx->msgid);
                 cb_release_op_connection(cb->pool, ctx->ld, CB_LDAP_CONN_ERROR(parse_rc));
                 slapi_ch_free((void **)&ctx);
 
@@ -13,6 +13,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 #include "portable.h"
 #include "slapi-plugin.h"
 #include "slap.h"
@@ -29,6 +30,7 @@
 #define REFERINT_ATTR_DELAY       "referint-update-delay"
 #define REFERINT_ATTR_LOGFILE     "referint-logfile"
 #define REFERINT_ATTR_MEMBERSHIP  "referint-membership-attr"
+#define REFERINT_ATTR_BATCH_SIZE  "referint-batch-size"
 #define MAX_LINE     2048
 #define READ_BUFSIZE 4096
 #define MY_EOF  0
@@ -39,6 +41,7 @@ typedef struct referint_config
     int delay;
     char *logfile;
     char **attrs;
+    int batch_size; /* 0: one search and modify per attribute */
 } referint_config;
 
 Slapi_RWLock *config_rwlock = NULL;
@@ -56,6 +59,7 @@ void referint_thread_func(void *arg);
 void writeintegritylog(Slapi_PBlock *pb, char *logfilename, Slapi_DN *sdn, char *newrdn, Slapi_DN *newsuperior, Slapi_DN *requestorsdn);
 int load_config(Slapi_PBlock *pb, Slapi_Entry *config_entry, int apply);
 int referint_get_delay(void);
+int referint_get_batch_size(void);
 char *referint_get_logfile(void);
 char **referint_get_attrs(void);
 int referint_postop_modify(Slapi_PBlock *pb);
@@ -274,7 +278,12 @@ referint_postop_init(Slapi_PBlock *pb)
  * referint-membership-attr: uniquemember
  * referint-membership-attr: owner
  * referint-membership-attr: seeAlso
+ * referint-batch-size: 100
  *
+ * referint-batch-size is optional: when it is set, the references to
+ * a DN are found with a single search over all the membership
+ * attributes, each referencing entry is updated with a single modify,
+ * and the delayed updates commit every batch-size modifies.
  *
  * Need to lock this!
  */
@@ -331,6 +340,17 @@ load_config(Slapi_PBlock *pb, Slapi_Entry *config_entry, int apply)
         tmp_config->attrs = attrs;
         new_config_present = 1;
     }
+    if ((value = (char *)slapi_entry_attr_get_ref(config_entry, REFERINT_ATTR_BATCH_SIZE))) {
+        char *endptr = NULL;
+        long batch_size = strtol(value, &endptr, 10);
+        if (!*value || *endptr || batch_size < 0 || batch_size > INT_MAX) {
+            slapi_log_err(SLAPI_LOG_ERR, REFERINT_PLUGIN_SUBSYSTEM, "load_config - invalid value \"%s\" for %s; should be >= 0\n",
+                          value, REFERINT_ATTR_BATCH_SIZE);
+            rc = SLAPI_PLUGIN_FAILURE;
+            goto done;
+        }
+        tmp_config->batch_size = (int)batch_size;
+    }
 
     if (new_config_present) {
         /* Verify we have everything we need */
@@ -492,6 +512,18 @@ referint_get_delay(void)
     return delay;
 }
 
+int
+referint_get_batch_size(void)
+{
+    int batch_size;
+
+    slapi_rwlock_rdlock(config_rwlock);
+    batch_size = config->batch_size;
+    slapi_rwlock_unlock(config_rwlock);
+
+    return batch_size;
+}
+
 char *
 referint_get_logfile(void)
 {
@@ -1072,6 +1104,405 @@ bail:
     return rc;
 }
 
+/*
+ * The DN that replaces origDN in modrdn mode, NULL if it can't be built
+ */
+static char *
+_referint_new_dn(Slapi_DN *origDN, char *newRDN, const char *newsuperior)
+{
+    const char *superior = NULL;
+    char **dnParts = NULL;
+    char *newDN = NULL;
+
+    dnParts = slapi_ldap_explode_dn(slapi_sdn_get_dn(origDN), 0);
+    if (NULL == dnParts) {
+        slapi_log_err(SLAPI_LOG_ERR, REFERINT_PLUGIN_SUBSYSTEM,
+                      "_referint_new_dn - Failed to explode dn %s\n",
+                      slapi_sdn_get_dn(origDN));
+        return NULL;
+    }
+    if (NULL == newRDN) {
+        newRDN = dnParts[0];
+    }
+    if (newsuperior) {
+        superior = newsuperior;
+    } else {
+        /* do not free superior */
+        superior = slapi_dn_find_parent(slapi_sdn_get_dn(origDN));
+    }
+    /* newRDN and superior are already normalized. */
+    newDN = slapi_ch_smprintf("%s,%s", newRDN, superior);
+    slapi_dn_ignore_case(newDN);
+    slapi_ldap_value_free(dnParts);
+
+    return newDN;
+}
+
+/*
+ * Add to smods the updates of the values of attr that refer to origDN:
+ * the deletion of origDN in delete mode (newDN is NULL), the renaming
+ * of origDN and of its descendants to newDN in modrdn mode. See
+ * _update_all_per_mod for the two modrdn cases.
+ */
+static void
+_add_entry_mods(Slapi_Mods *smods,
+                Slapi_Attr *attr,
+                char *attrName,
+                Slapi_DN *origDN,
+                const char *newDN)
+{
+    Slapi_Value *v = NULL;
+    struct berval bv = {0};
+    char *sval = NULL;
+    char *newvalue = NULL;
+    char *p = NULL;
+    size_t dnlen = 0;
+    int nval = 0;
+
+    if (NULL == newDN) {
+        /* The entry may match on another attribute only */
+        bv.bv_val = (char *)slapi_sdn_get_dn(origDN);
+        bv.bv_len = strlen(bv.bv_val);
+        if (slapi_attr_value_find(attr, &bv) == 0) {
+            slapi_mods_add_string(smods, LDAP_MOD_DELETE, attrName, bv.bv_val);
+        }
+        return;
+    }
+
+    for (nval = slapi_attr_first_value(attr, &v);
+         nval != -1;
+         nval = slapi_attr_next_value(attr, nval, &v)) {
+        int normalize_rc;
+        p = NULL;
+        dnlen = 0;
+
+        /* DN syntax, which should be a string */
+        sval = slapi_ch_strdup(slapi_value_get_string(v));
+        normalize_rc = slapi_dn_normalize_case_ext(sval, 0, &p, &dnlen);
+        if (normalize_rc == 0) { /* sval is passed in; not terminated */
+            *(p + dnlen) = '\0';
+            sval = p;
+        } else if (normalize_rc > 0) {
+            slapi_ch_free_string(&sval);
+            sval = p;
+        }
+        /* else: normalize_rc < 0) Ignore the DN normalization error for now. */
+
+        p = PL_strstr(sval, slapi_sdn_get_ndn(origDN));
+        if (p == sval) {
+            /* (case 1) */
+            newvalue = slapi_ch_strdup(newDN);
+        } else if (p) {
+            /* (case 2) */
+            newvalue = slapi_ch_smprintf("%.*s%s", (int)(p - sval), sval, newDN);
+        }
+        if (newvalue) {
+            slapi_mods_add_string(smods, LDAP_MOD_DELETE, attrName, sval);
+            /* Add only if the attr value does not exist */
+            bv.bv_val = newvalue;
+            bv.bv_len = strlen(newvalue);
+            if (VALUE_PRESENT != attr_value_find_wsi(attr, &bv, &v)) {
+                slapi_mods_add_string(smods, LDAP_MOD_ADD, attrName, newvalue);
+            }
+            slapi_ch_free_string(&newvalue);
+        }
+        /* else: value does not include the modified DN.  Ignore it. */
+        slapi_ch_free_string(&sval);
+    }
+}
+
+/*
+ * The filter of the entries that refer to origDN, or to one of its
+ * descendants in modrdn mode, through any of the membership attributes
+ */
+static char *
+_referint_batch_filter(char **membership_attrs, const char *origDN, int modrdn)
+{
+    char *filter = NULL;
+    size_t nattrs = 0;
+
+    for (size_t i = 0; membership_attrs[i] != NULL; i++) {
+        char *component = NULL;
+
+        if (modrdn) {
+            /* we need to check the children of the old dn, so use a wildcard */
+            component = slapi_filter_sprintf("(%s=*%s%s)", membership_attrs[i], ESC_NEXT_VAL, origDN);
+        } else {
+            component = slapi_filter_sprintf("(%s=%s%s)", membership_attrs[i], ESC_NEXT_VAL, origDN);
+        }
+        if (NULL == component) {
+            slapi_ch_free_string(&filter);
+            return NULL;
+        }
+        filter = slapi_ch_smprintf("%s%s", filter ? filter : "", component);
+        slapi_ch_free_string(&component);
+        nattrs++;
+    }
+    if (nattrs > 1) {
+        char *or_filter = slapi_ch_smprintf("(|%s)", filter);
+        slapi_ch_free_string(&filter);
+        filter = or_filter;
+    }
+    return filter;
+}
+
+/*
+ * Whether attrName is one of the membership attributes or a subtype
+ */
+static int
+_referint_is_membership_attr(char **membership_attrs, const char *attrName)
+{
+    for (size_t i = 0; membership_attrs[i] != NULL; i++) {
+        if (slapi_attr_type_cmp(membership_attrs[i], attrName, SLAPI_TYPE_CMP_SUBTYPE) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Update the references of a single entry, with one modify (or one per
+ * value for the big attributes in modrdn mode). The modifies are added
+ * to *nmods.
+ */
+static int
+_referint_update_entry(Slapi_Entry *e,
+                       Slapi_DN *origSDN,
+                       char *newrDN,
+                       Slapi_DN *newsuperior,
+                       char *newDN,
+                       char **membership_attrs,
+                       Slapi_PBlock *mod_pb,
+                       int *nmods)
+{
+    Slapi_DN *entrySDN = slapi_entry_get_sdn(e);
+    Slapi_Mods *smods = slapi_mods_new();
+    Slapi_Attr *attr = NULL;
+    char *attrName = NULL;
+    int modrdn = (newrDN || newsuperior);
+    int rc = 0;
+
+    for (slapi_entry_first_attr(e, &attr); attr; slapi_entry_next_attr(e, attr, &attr)) {
+        int nval = 0;
+
+        slapi_attr_get_type(attr, &attrName);
+        if (!_referint_is_membership_attr(membership_attrs, attrName)) {
+            continue;
+        }
+        slapi_attr_get_numvalues(attr, &nval);
+        if (modrdn && nval > 128) {
+            /* Same compromise as update_integrity for the big attributes */
+            rc = _update_one_per_mod(entrySDN, attr, attrName, origSDN, newrDN,
+                                     slapi_sdn_get_dn(newsuperior), mod_pb);
+            (*nmods)++;
+        } else {
+            _add_entry_mods(smods, attr, attrName, origSDN, newDN);
+        }
+        if (rc) {
+            break;
+        }
+    }
+    if (rc == 0 && slapi_mods_get_num_mods(smods) > 0) {
+        rc = _do_modify(mod_pb, entrySDN, slapi_mods_get_ldapmods_byref(smods));
+        (*nmods)++;
+    }
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, REFERINT_PLUGIN_SUBSYSTEM,
+                      "update_integrity_batched - Entry %s failed (%d)\n",
+                      slapi_sdn_get_dn(entrySDN), rc);
+    }
+    slapi_mods_free(&smods);
+    return rc;
+}
+
+/*
+ * Redo the updates of the entries [first, last] of a batch whose
+ * transaction was aborted, each in its own transaction as the
+ * unbatched updates do, up to the first failure. The delayed log line
+ * is consumed, so the updates that succeeded in the batch must not be
+ * lost with the one that failed.
+ */
+static int
+_referint_redo_batch(Slapi_Entry **entries,
+                     size_t first,
+                     size_t last,
+                     Slapi_DN *origSDN,
+                     char *newrDN,
+                     Slapi_DN *newsuperior,
+                     char *newDN,
+                     char **membership_attrs,
+                     Slapi_PBlock *mod_pb)
+{
+    int nmods = 0;
+    int rc = 0;
+
+    slapi_log_err(SLAPI_LOG_PLUGIN, REFERINT_PLUGIN_SUBSYSTEM,
+                  "update_integrity_batched - Updating the %lu entries of the aborted batch one by one\n",
+                  (unsigned long)(last - first + 1));
+    for (size_t j = first; j <= last && rc == 0; j++) {
+        rc = _referint_update_entry(entries[j], origSDN, newrDN, newsuperior, newDN,
+                                    membership_attrs, mod_pb, &nmods);
+    }
+    return rc;
+}
+
+/*
+ * Batched version of update_integrity: a single search per suffix over
+ * all the membership attributes, and a single modify per referencing
+ * entry.  The delayed updates of a backend txn plugin, which run out
+ * of any operation, are committed every batch_size modifies instead of
+ * each in its own transaction. If an update of a batch, or its commit,
+ * fails, the batch is aborted and its updates are redone one by one.
+ */
+static int
+update_integrity_batched(Slapi_DN *origSDN,
+                         char *newrDN,
+                         Slapi_DN *newsuperior,
+                         Slapi_PBlock *pb,
+                         char **membership_attrs,
+                         int batch_size)
+{
+    Slapi_PBlock *search_result_pb = slapi_pblock_new();
+    Slapi_PBlock *mod_pb = slapi_pblock_new();
+    Slapi_PBlock *txn_pb = NULL;
+    Slapi_Entry **search_entries = NULL;
+    Slapi_DN *sdn = NULL;
+    void *node = NULL;
+    const char *search_base = NULL;
+    char *newDN = NULL;
+    char *filter = NULL;
+    int modrdn = (newrDN || newsuperior);
+    int search_result;
+    int rc = SLAPI_PLUGIN_SUCCESS;
+
+    if (modrdn && (newDN = _referint_new_dn(origSDN, newrDN, slapi_sdn_get_dn(newsuperior))) == NULL) {
+        goto free_and_return;
+    }
+    filter = _referint_batch_filter(membership_attrs, slapi_sdn_get_dn(origSDN), modrdn);
+    if (NULL == filter) {
+        goto free_and_return;
+    }
+
+    if (plugin_ContainerScope) {
+        sdn = plugin_ContainerScope;
+    } else {
+        sdn = slapi_get_first_suffix(&node, 0);
+    }
+    while (sdn) {
+        Slapi_Backend *be = slapi_be_select(sdn);
+        size_t batch_first = 0;
+        size_t j;
+        int nmods = 0;
+
+        search_base = slapi_sdn_get_dn(sdn);
+
+        slapi_pblock_init(search_result_pb);
+        slapi_pblock_set(search_result_pb, SLAPI_BACKEND, be);
+        slapi_search_internal_set_pb(search_result_pb, search_base,
+                                     LDAP_SCOPE_SUBTREE, filter, membership_attrs, 0 /* attrs only */,
+                                     NULL, NULL, referint_plugin_identity, 0);
+        slapi_search_internal_pb(search_result_pb);
+        slapi_pblock_get(search_result_pb, SLAPI_PLUGIN_INTOP_RESULT, &search_result);
+
+        if (search_result != LDAP_SUCCESS) {
+            if (isFatalSearchError(search_result)) {
+                slapi_log_err(SLAPI_LOG_ERR, REFERINT_PLUGIN_SUBSYSTEM,
+                              "update_integrity_batched - Search (base=%s filter=%s) returned "
+                              "error %d\n",
+                              search_base, filter, search_result);
+                slapi_free_search_results_internal(search_result_pb);
+                if (pb) {
+                    slapi_pblock_set(pb, SLAPI_RESULT_CODE, &search_result);
+                }
+                rc = SLAPI_PLUGIN_FAILURE;
+                goto free_and_return;
+            }
+            slapi_free_search_results_internal(search_result_pb);
+            goto next_suffix;
+        }
+        slapi_pblock_get(search_result_pb, SLAPI_PLUGIN_INTOP_SEARCH_ENTRIES, &search_entries);
+
+        for (j = 0; search_entries && search_entries[j] != NULL; j++) {
+            int last = (search_entries[j + 1] == NULL);
+
+            /*
+             * The delayed updates of a backend txn plugin have no
+             * operation transaction to join, start a batch one
+             */
+            if (use_txn && pb == NULL && txn_pb == NULL) {
+                txn_pb = slapi_pblock_new();
+                slapi_pblock_set(txn_pb, SLAPI_BACKEND, be);
+                if (slapi_back_transaction_begin(txn_pb) != LDAP_SUCCESS) {
+                    slapi_log_err(SLAPI_LOG_ERR, REFERINT_PLUGIN_SUBSYSTEM,
+                                  "update_integrity_batched - Failed to start transaction\n");
+                    slapi_pblock_destroy(txn_pb);
+                    txn_pb = NULL;
+                }
+                batch_first = j;
+                nmods = 0;
+            }
+
+            rc = _referint_update_entry(search_entries[j], origSDN, newrDN, newsuperior, newDN,
+                                        membership_attrs, mod_pb, &nmods);
+            if (rc && txn_pb) {
+                slapi_back_transaction_abort(txn_pb);
+                slapi_pblock_destroy(txn_pb);
+                txn_pb = NULL;
+                rc = _referint_redo_batch(search_entries, batch_first, j, origSDN, newrDN,
+                                          newsuperior, newDN, membership_attrs, mod_pb);
+            }
+            if (rc == 0 && txn_pb && (nmods >= batch_size || last)) {
+                int commit_rc = slapi_back_transaction_commit(txn_pb);
+
+                slapi_pblock_destroy(txn_pb);
+                txn_pb = NULL;
+                if (commit_rc) {
+                    slapi_log_err(SLAPI_LOG_ERR, REFERINT_PLUGIN_SUBSYSTEM,
+                                  "update_integrity_batched - Failed to commit the updates of %lu entries (%d)\n",
+                                  (unsigned long)(j - batch_first + 1), commit_rc);
+                    rc = _referint_redo_batch(search_entries, batch_first, j, origSDN, newrDN,
+                                              newsuperior, newDN, membership_attrs, mod_pb);
+                }
+            }
+
+            if (rc) {
+                if (use_txn) {
+                    /*
+                     * We're using backend transactions,
+                     * so we need to stop on failure.
+                     */
+                    if (pb) {
+                        /* Set the error code of the failure */
+                        slapi_pblock_set(pb, SLAPI_RESULT_CODE, &rc);
+                    }
+                    slapi_free_search_results_internal(search_result_pb);
+                    rc = SLAPI_PLUGIN_FAILURE;
+                    goto free_and_return;
+                }
+                rc = SLAPI_PLUGIN_SUCCESS;
+            }
+        }
+        slapi_free_search_results_internal(search_result_pb);
+
+    next_suffix:
+        if (plugin_ContainerScope) {
+            /* at the moment only a single scope is supported
+             * so the loop ends after the first iteration
+             */
+            sdn = NULL;
+        } else {
+            sdn = slapi_get_next_suffix(&node, 0);
+        }
+    }
+
+free_and_return:
+    slapi_ch_free_string(&filter);
+    slapi_ch_free_string(&newDN);
+    slapi_pblock_destroy(mod_pb);
+    slapi_pblock_destroy(search_result_pb);
+    return rc;
+}
+
 int
 update_integrity(Slapi_DN *origSDN,
                  char *newrDN,
@@ -1092,10 +1523,18 @@ update_integrity(Slapi_DN *origSDN,
     char **membership_attrs = NULL;
     int search_result;
     int nval = 0;
+    int batch_size = 0;
     int i, j;
     int rc = SLAPI_PLUGIN_SUCCESS;
 
     membership_attrs = referint_get_attrs();
+    batch_size = referint_get_batch_size();
+    if (batch_size > 0) {
+        rc = update_integrity_batched(origSDN, newrDN, newsuperior, pb, membership_attrs, batch_size);
+        slapi_ch_array_free(membership_attrs);
+        slapi_pblock_destroy(mod_pb);
+        return rc;
+    }
     /*
      *  For now, just putting attributes to keep integrity on in conf file,
      *  until resolve the other timing mode issue
@@ -67,6 +67,22 @@
  * new set of start and response extops. */
 #define REPL_START_NSDS90_REPLICATION_REQUEST_OID "2.16.840.1.113730.3.5.12"
 #define REPL_NSDS90_REPLICATION_RESPONSE_OID      "2.16.840.1.113730.3.5.13"
+/* Parallel total update: the entries request carries a batch of entries in
+ * one PDU, the stream request attaches another connection from the same
+ * supplier to the total update that holds the replica, so the entries can
+ * be sent over several connections. */
+#define REPL_NSDS_REPLICATION_ENTRIES_REQUEST_OID "2.16.840.1.113730.3.5.17"
+#define REPL_NSDS_TOTAL_UPDATE_STREAM_REQUEST_OID "2.16.840.1.113730.3.5.18"
+/* Snapshot total update: the supplier ships the records of the backend
+ * databases rather than the entries, for LMDB servers. A consumer that
+ * does not know the protocol answers unknown update protocol, and the
+ * supplier falls back to the total protocol. */
+#define REPL_NSDS_SNAPSHOT_TOTAL_PROTOCOL_OID        "2.16.840.1.113730.3.6.10"
+#define REPL_NSDS_REPLICATION_DB_RECORDS_REQUEST_OID "2.16.840.1.113730.3.5.19"
+/* The start request of the snapshot protocol carries the fingerprint of the
+ * supplier index configuration, under this guid, in place of the session
+ * plugin data. The consumer refuses the snapshot if its own differs. */
+#define REPL_NSDS_SNAPSHOT_FINGERPRINT_GUID          "snapshotIndexFingerprint"
 /* cleanallruv extended ops */
 #define REPL_CLEANRUV_OID              "2.16.840.1.113730.3.6.5"
 #define REPL_ABORT_CLEANRUV_OID        "2.16.840.1.113730.3.6.6"
@@ -127,6 +143,7 @@
 #define DEFAULT_PROTOCOL_TIMEOUT 120
 #define DEFAULT_REPLICA_KEEPALIVE_UPDATE_INTERVAL 3600
 #define REPLICA_KEEPALIVE_UPDATE_INTERVAL_MIN 60
+#define DEFAULT_REPLICA_TOMBSTONE_REAP_BATCH_SIZE 100
 
 /* To Allow Consumer Initialization when adding an agreement - */
 #define STATE_PERFORMING_TOTAL_UPDATE       501
@@ -159,11 +176,15 @@ extern const char *type_nsds5ReplicaEnabled;
 extern const char *type_nsds5ReplicaStripAttrs;
 extern const char *type_nsds5ReplicaFlowControlWindow;
 extern const char *type_nsds5ReplicaFlowControlPause;
+extern const char *type_nsds5ReplicaTotalUpdateStreams;
+extern const char *type_nsds5ReplicaTotalUpdateBatchSize;
+extern const char *type_nsds5ReplicaTotalUpdateMethod;
 extern const char *type_replicaProtocolTimeout;
 extern const char *type_replicaReleaseTimeout;
 extern const char *type_replicaBackoffMin;
 extern const char *type_replicaBackoffMax;
 extern const char *type_replicaPrecisePurge;
+extern const char *type_replicaParallelApply;
 extern const char *type_replicaIgnoreMissingChange;
 extern const char *type_nsds5ReplicaBootstrapBindDN;
 extern const char *type_nsds5ReplicaBootstrapCredentials;
@@ -211,6 +232,7 @@ extern const char *type_agmtMaxCSN;
 extern const char *type_replicaPurgeDelay;
 extern const char *type_replicaChangeCount;
 extern const char *type_replicaTombstonePurgeInterval;
+extern const char *type_replicaTombstoneReapBatchSize;
 extern const char *type_replicaCleanRUV;
 extern const char *type_replicaAbortCleanRUV;
 extern const char *type_ruvElementUpdatetime;
@@ -275,6 +297,8 @@ char *get_repl_session_id(Slapi_PBlock *pb, char *id, CSN **opcsn);
 /* In repl_extop.c */
 int multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb);
 int multisupplier_extop_EndNSDS50ReplicationRequest(Slapi_PBlock *pb);
+int multisupplier_extop_NSDSTotalUpdateStreamRequest(Slapi_PBlock *pb);
+int multisupplier_extop_NSDSReplicationDbRecords(Slapi_PBlock *pb);
 int multisupplier_extop_cleanruv(Slapi_PBlock *pb);
 int multisupplier_extop_abort_cleanruv(Slapi_PBlock *pb);
 int multisupplier_extop_cleanruv_get_maxcsn(Slapi_PBlock *pb);
@@ -285,6 +309,7 @@ struct berval *NSDS50StartReplicationRequest_new(const char *protocol_oid,
                                                  char **extra_referrals,
                                                  CSN *csn);
 struct berval *NSDS50EndReplicationRequest_new(char *repl_root);
+struct berval *NSDSTotalUpdateStreamRequest_new(char *repl_root);
 int decode_repl_ext_response(struct berval *bvdata, int *response_code, struct berval ***ruv_bervals, char **data_guid, struct berval **data);
 struct berval *NSDS90StartReplicationRequest_new(const char *protocol_oid,
                                                  const char *repl_root,
@@ -384,6 +409,8 @@ typedef struct repl5agmt Repl_Agmt;
 #define BINDMETHOD_SSL_CLIENTAUTH 2
 #define BINDMETHOD_SASL_GSSAPI 3
 #define BINDMETHOD_SASL_DIGEST_MD5 4
+#define TOTAL_UPDATE_METHOD_ENTRIES "entries"
+#define TOTAL_UPDATE_METHOD_SNAPSHOT "snapshot"
 Repl_Agmt *agmt_new_from_entry(Slapi_Entry *e);
 Repl_Agmt *agmt_new_from_pblock(Slapi_PBlock *pb);
 void agmt_delete(void **ra);
@@ -394,6 +421,9 @@ long agmt_get_busywaittime(const Repl_Agmt *ra);
 long agmt_get_pausetime(const Repl_Agmt *ra);
 long agmt_get_flowcontrolwindow(const Repl_Agmt *ra);
 long agmt_get_flowcontrolpause(const Repl_Agmt *ra);
+long agmt_get_total_update_streams(const Repl_Agmt *ra);
+long agmt_get_total_update_batch_size(const Repl_Agmt *ra);
+int agmt_get_total_update_snapshot(const Repl_Agmt *ra);
 long agmt_get_ignoremissing(const Repl_Agmt *ra);
 int agmt_start(Repl_Agmt *ra);
 int windows_agmt_start(Repl_Agmt *ra);
@@ -421,6 +451,9 @@ int agmt_set_schedule_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
 int agmt_set_timeout_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
 int agmt_set_flowcontrolwindow_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
 int agmt_set_flowcontrolpause_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
+int agmt_set_total_update_streams_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
+int agmt_set_total_update_batch_size_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
+int agmt_set_total_update_method_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
 int agmt_set_ignoremissing_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
 int agmt_set_busywaittime_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
 int agmt_set_pausetime_from_entry(Repl_Agmt *ra, const Slapi_Entry *e);
@@ -550,6 +583,8 @@ typedef struct consumer_connection_extension
     Slapi_Connection *connection;
     PRLock *lock;    /* protects entire structure */
     int in_use_opid; /* the id of the operation actively using this, else -1 */
+    Replica *stream_replica; /* replica whose total update this connection streams entries to */
+    int snapshot;            /* the total update ships database records rather than entries */
 } consumer_connection_extension;
 
 /* extension construct/destructor */
@@ -603,7 +638,9 @@ typedef enum {
     CONN_IS_WIN2K3,
     CONN_NOT_WIN2K3,
     CONN_SUPPORTS_DS90_REPL,
-    CONN_DOES_NOT_SUPPORT_DS90_REPL
+    CONN_DOES_NOT_SUPPORT_DS90_REPL,
+    CONN_SUPPORTS_TOTAL_STREAMS,
+    CONN_DOES_NOT_SUPPORT_TOTAL_STREAMS
 } ConnResult;
 
 char *conn_result2string(int result);
@@ -624,6 +661,7 @@ void conn_cancel_linger(Repl_Connection *conn);
 ConnResult conn_replica_supports_ds5_repl(Repl_Connection *conn);
 ConnResult conn_replica_supports_ds71_repl(Repl_Connection *conn);
 ConnResult conn_replica_supports_ds90_repl(Repl_Connection *conn);
+ConnResult conn_replica_supports_total_streams(Repl_Connection *conn);
 ConnResult conn_replica_is_readonly(Repl_Connection *conn);
 
 ConnResult conn_read_entry_attribute(Repl_Connection *conn, const char *dn, char *type, struct berval ***returned_bvals);
@@ -695,9 +733,14 @@ int replica_subentry_check(const char *repl_root, ReplicaId rid);
 PRBool replica_get_exclusive_access(Replica *r, PRBool *isInc, uint64_t connid, int opid, const char *locking_purl, char **current_purl);
 void replica_relinquish_exclusive_access(Replica *r, uint64_t connid, int opid);
 PRBool replica_get_tombstone_reap_active(const Replica *r);
+void replica_get_tombstone_reap_stats(Replica *r, uint64_t *purged, uint64_t *rate, uint64_t *backlog);
 const Slapi_DN *replica_get_root(const Replica *r);
 const char *replica_get_name(const Replica *r);
 uint64_t replica_get_locking_conn(const Replica *r);
+void replica_total_update_streams_open(Replica *r, Slapi_Connection *conn);
+void replica_total_update_streams_close(Replica *r);
+Slapi_Connection *replica_total_update_stream_enter(Replica *r);
+void replica_total_update_stream_exit(Replica *r, Slapi_Connection *conn);
 ReplicaId replica_get_rid(const Replica *r);
 void replica_set_rid(Replica *r, ReplicaId rid);
 PRBool replica_is_initialized(const Replica *r);
@@ -754,6 +797,8 @@ void consumer5_set_mapping_tree_state_for_replica(const Replica *r, RUV *supplie
 Replica *replica_get_for_backend(const char *be_name);
 void replica_set_purge_delay(Replica *r, uint32_t purge_delay);
 void replica_set_tombstone_reap_interval(Replica *r, long interval);
+void replica_set_tombstone_reap_batch_size(Replica *r, int64_t batch_size);
+int64_t replica_get_tombstone_reap_batch_size(Replica *r);
 void replica_set_keepalive_update_interval(Replica *r, int64_t interval);
 int64_t replica_get_keepalive_update_interval(Replica *r);
 void replica_update_ruv_consumer(Replica *r, RUV *supplier_ruv);
@@ -777,6 +822,10 @@ void replica_incr_agmt_count(Replica *r);
 void replica_decr_agmt_count(Replica *r);
 uint64_t replica_get_precise_purging(Replica *r);
 void replica_set_precise_purging(Replica *r, uint64_t on_off);
+uint64_t replica_get_parallel_apply(Replica *r);
+void replica_set_parallel_apply(Replica *r, uint64_t on_off);
+void replica_update_parallel_apply_stats(Replica *r, int running);
+void replica_get_parallel_apply_stats(Replica *r, uint64_t *ops, uint64_t *running, uint64_t *running_max);
 PRBool ignore_error_and_keep_going(int error);
 void replica_check_release_timeout(Replica *r, Slapi_PBlock *pb);
 void replica_lock_replica(Replica *r);
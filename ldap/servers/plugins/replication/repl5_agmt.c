@@ -64,6 +64,10 @@
 #define DEFAULT_FLOWCONTROL_PAUSE       2000 /* msec of pause when #entries sent witout acknowledgment (bdb) */
 #define LMDB_DEFAULT_FLOWCONTROL_WINDOW 50   /* #entries sent without acknowledgment (lmdb) */
 #define LMDB_DEFAULT_FLOWCONTROL_PAUSE  200  /* msec of pause when #entries sent witout acknowledgment (lmdb) */
+#define DEFAULT_TOTAL_UPDATE_STREAMS    1    /* #connections a total update sends the entries on */
+#define MAX_TOTAL_UPDATE_STREAMS        16
+#define DEFAULT_TOTAL_UPDATE_BATCH_SIZE 1    /* #entries sent per total update extended operation */
+#define MAX_TOTAL_UPDATE_BATCH_SIZE     10000
 
 #define STATUS_LEN 2048
 #define STATUS_GOOD "green"
@@ -138,6 +142,9 @@ typedef struct repl5agmt
     int64_t flowControlWindow;         /* This is the maximum number of entries sent without acknowledgment */
     int64_t flowControlPause;          /* When nb of not acknowledged entries overpass totalUpdateWindow
                                         * This is the duration (in msec) that the RA will pause before sending the next entry */
+    int64_t totalUpdateStreams;        /* Number of connections a total update sends the entries on */
+    int64_t totalUpdateBatchSize;      /* Number of entries sent in each total update extended operation */
+    int totalUpdateSnapshot;           /* A total update ships the database records rather than the entries */
     int64_t ignoreMissingChange;       /* if set replication will try to continue even if change cannot be found in changelog */
     Slapi_RWLock *attr_lock;           /* RW lock for all the stripped attrs */
     int64_t WaitForAsyncResults;       /* Pass to DS_Sleep(PR_MillisecondsToInterval(WaitForAsyncResults))
@@ -410,6 +417,29 @@ agmt_new_from_entry(Slapi_Entry *e)
         ra->flowControlPause = pause;
     }
 
+    /* parallel total update */
+    ra->totalUpdateStreams = DEFAULT_TOTAL_UPDATE_STREAMS;
+    if ((val = slapi_entry_attr_get_ref(e, type_nsds5ReplicaTotalUpdateStreams))){
+        int64_t streams;
+        if (repl_config_valid_num(type_nsds5ReplicaTotalUpdateStreams, (char *)val, 1, MAX_TOTAL_UPDATE_STREAMS, &rc, errormsg, &streams) != 0) {
+            goto loser;
+        }
+        ra->totalUpdateStreams = streams;
+    }
+    ra->totalUpdateBatchSize = DEFAULT_TOTAL_UPDATE_BATCH_SIZE;
+    if ((val = slapi_entry_attr_get_ref(e, type_nsds5ReplicaTotalUpdateBatchSize))){
+        int64_t batch;
+        if (repl_config_valid_num(type_nsds5ReplicaTotalUpdateBatchSize, (char *)val, 1, MAX_TOTAL_UPDATE_BATCH_SIZE, &rc, errormsg, &batch) != 0) {
+            goto loser;
+        }
+        ra->totalUpdateBatchSize = batch;
+    }
+    ra->totalUpdateSnapshot = 0;
+    tmpstr = (char *)slapi_entry_attr_get_ref(e, type_nsds5ReplicaTotalUpdateMethod);
+    if (NULL != tmpstr && strcasecmp(tmpstr, TOTAL_UPDATE_METHOD_SNAPSHOT) == 0) {
+        ra->totalUpdateSnapshot = 1;
+    }
+
     /* continue on missing change ? */
     ra->ignoreMissingChange = 0;
     tmpstr = (char *)slapi_entry_attr_get_ref(e, type_replicaIgnoreMissingChange);
@@ -1269,6 +1299,36 @@ agmt_get_flowcontrolpause(const Repl_Agmt *ra)
     return return_value;
 }
 long
+agmt_get_total_update_streams(const Repl_Agmt *ra)
+{
+    long return_value;
+    PR_ASSERT(NULL != ra);
+    PR_Lock(ra->lock);
+    return_value = ra->totalUpdateStreams;
+    PR_Unlock(ra->lock);
+    return return_value;
+}
+long
+agmt_get_total_update_batch_size(const Repl_Agmt *ra)
+{
+    long return_value;
+    PR_ASSERT(NULL != ra);
+    PR_Lock(ra->lock);
+    return_value = ra->totalUpdateBatchSize;
+    PR_Unlock(ra->lock);
+    return return_value;
+}
+int
+agmt_get_total_update_snapshot(const Repl_Agmt *ra)
+{
+    int return_value;
+    PR_ASSERT(NULL != ra);
+    PR_Lock(ra->lock);
+    return_value = ra->totalUpdateSnapshot;
+    PR_Unlock(ra->lock);
+    return return_value;
+}
+long
 agmt_get_ignoremissing(const Repl_Agmt *ra)
 {
     long return_value;
@@ -2175,6 +2235,110 @@ agmt_set_flowcontrolpause_from_entry(Repl_Agmt *ra, const Slapi_Entry *e)
     }
     return return_value;
 }
+
+/*
+ * Set or reset the number of connections the next total update sends the
+ * entries on. A total update in progress keeps its connections.
+ *
+ * Returns 0 if the number is set, or -1 if an error occurred.
+ */
+int
+agmt_set_total_update_streams_from_entry(Repl_Agmt *ra, const Slapi_Entry *e)
+{
+    int return_value = -1;
+    int64_t streams = DEFAULT_TOTAL_UPDATE_STREAMS;
+    const char *val;
+
+    PR_ASSERT(NULL != ra);
+    PR_Lock(ra->lock);
+    if (ra->stop_in_progress) {
+        PR_Unlock(ra->lock);
+        return return_value;
+    }
+
+    val = slapi_entry_attr_get_ref((Slapi_Entry *)e, type_nsds5ReplicaTotalUpdateStreams);
+    if (val) {
+        int rc = 0;
+        char errormsg[SLAPI_DSE_RETURNTEXT_SIZE];
+        if (repl_config_valid_num(type_nsds5ReplicaTotalUpdateStreams, (char *)val, 1, MAX_TOTAL_UPDATE_STREAMS, &rc, errormsg, &streams) == 0) {
+            ra->totalUpdateStreams = streams;
+            return_value = 0;
+        }
+    } else {
+        /* the attribute was removed, go back to a single connection */
+        ra->totalUpdateStreams = streams;
+        return_value = 0;
+    }
+    PR_Unlock(ra->lock);
+    return return_value;
+}
+
+/*
+ * Set or reset the number of entries sent in each total update extended
+ * operation.
+ *
+ * Returns 0 if the size is set, or -1 if an error occurred.
+ */
+int
+agmt_set_total_update_batch_size_from_entry(Repl_Agmt *ra, const Slapi_Entry *e)
+{
+    int return_value = -1;
+    int64_t batch = DEFAULT_TOTAL_UPDATE_BATCH_SIZE;
+    const char *val;
+
+    PR_ASSERT(NULL != ra);
+    PR_Lock(ra->lock);
+    if (ra->stop_in_progress) {
+        PR_Unlock(ra->lock);
+        return return_value;
+    }
+
+    val = slapi_entry_attr_get_ref((Slapi_Entry *)e, type_nsds5ReplicaTotalUpdateBatchSize);
+    if (val) {
+        int rc = 0;
+        char errormsg[SLAPI_DSE_RETURNTEXT_SIZE];
+        if (repl_config_valid_num(type_nsds5ReplicaTotalUpdateBatchSize, (char *)val, 1, MAX_TOTAL_UPDATE_BATCH_SIZE, &rc, errormsg, &batch) == 0) {
+            ra->totalUpdateBatchSize = batch;
+            return_value = 0;
+        }
+    } else {
+        ra->totalUpdateBatchSize = batch;
+        return_value = 0;
+    }
+    PR_Unlock(ra->lock);
+    return return_value;
+}
+
+/*
+ * Set or reset the way a total update sends the data: the entries, or a
+ * snapshot of the database records when both servers run LMDB.
+ *
+ * Returns 0 if the method is set, or -1 if an error occurred.
+ */
+int
+agmt_set_total_update_method_from_entry(Repl_Agmt *ra, const Slapi_Entry *e)
+{
+    int return_value = -1;
+    const char *val;
+
+    PR_ASSERT(NULL != ra);
+    PR_Lock(ra->lock);
+    if (ra->stop_in_progress) {
+        PR_Unlock(ra->lock);
+        return return_value;
+    }
+
+    val = slapi_entry_attr_get_ref((Slapi_Entry *)e, type_nsds5ReplicaTotalUpdateMethod);
+    if (val == NULL || strcasecmp(val, TOTAL_UPDATE_METHOD_ENTRIES) == 0) {
+        ra->totalUpdateSnapshot = 0;
+        return_value = 0;
+    } else if (strcasecmp(val, TOTAL_UPDATE_METHOD_SNAPSHOT) == 0) {
+        ra->totalUpdateSnapshot = 1;
+        return_value = 0;
+    }
+    PR_Unlock(ra->lock);
+    return return_value;
+}
 /* add comment here */
 int
 agmt_set_ignoremissing_from_entry(Repl_Agmt *ra, const Slapi_Entry *e)
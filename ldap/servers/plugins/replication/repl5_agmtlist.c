@@ -381,6 +381,34 @@ agmtlist_modify_callback(Slapi_PBlock *pb,
                 *returncode = LDAP_OPERATIONS_ERROR;
                 rc = SLAPI_DSE_CALLBACK_ERROR;
             }
+        } else if (slapi_attr_types_equivalent(mods[i]->mod_type,
+                                               type_nsds5ReplicaTotalUpdateStreams)) {
+            if (agmt_set_total_update_streams_from_entry(agmt, e) != 0) {
+                slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "agmtlist_modify_callback - "
+                                                               "Failed to update the total update streams for agreement %s\n",
+                              agmt_get_long_name(agmt));
+                *returncode = LDAP_UNWILLING_TO_PERFORM;
+                rc = SLAPI_DSE_CALLBACK_ERROR;
+            }
+        } else if (slapi_attr_types_equivalent(mods[i]->mod_type,
+                                               type_nsds5ReplicaTotalUpdateBatchSize)) {
+            if (agmt_set_total_update_batch_size_from_entry(agmt, e) != 0) {
+                slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "agmtlist_modify_callback - "
+                                                               "Failed to update the total update batch size for agreement %s\n",
+                              agmt_get_long_name(agmt));
+                *returncode = LDAP_UNWILLING_TO_PERFORM;
+                rc = SLAPI_DSE_CALLBACK_ERROR;
+            }
+        } else if (slapi_attr_types_equivalent(mods[i]->mod_type,
+                                               type_nsds5ReplicaTotalUpdateMethod)) {
+            if (agmt_set_total_update_method_from_entry(agmt, e) != 0) {
+                slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "agmtlist_modify_callback - "
+                                                               "Failed to update the total update method for agreement %s "
+                                                               "(must be \"%s\" or \"%s\")\n",
+                              agmt_get_long_name(agmt), TOTAL_UPDATE_METHOD_ENTRIES, TOTAL_UPDATE_METHOD_SNAPSHOT);
+                *returncode = LDAP_UNWILLING_TO_PERFORM;
+                rc = SLAPI_DSE_CALLBACK_ERROR;
+            }
         } else if (slapi_attr_types_equivalent(mods[i]->mod_type,
                                                type_replicaIgnoreMissingChange)) {
             /* New replica timeout */
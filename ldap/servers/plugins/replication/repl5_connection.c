@@ -48,6 +48,7 @@ typedef struct repl_connection
     int supports_ds40_repl; /* 1 if does, 0 if doesn't, -1 if not determined */
     int supports_ds71_repl; /* 1 if does, 0 if doesn't, -1 if not determined */
     int supports_ds90_repl; /* 1 if does, 0 if doesn't, -1 if not determined */
+    int supports_total_streams; /* 1 if does, 0 if doesn't, -1 if not determined */
     int linger_time;        /* time in seconds to leave an idle connection open */
     PRBool linger_active;
     Slapi_Eq_Context *linger_event;
@@ -162,6 +163,10 @@ conn_result2string(int result)
         return "consumer supports all DS90 extop";
     case CONN_DOES_NOT_SUPPORT_DS90_REPL:
         return "consumer does not support all DS90 extop";
+    case CONN_SUPPORTS_TOTAL_STREAMS:
+        return "consumer supports parallel total update";
+    case CONN_DOES_NOT_SUPPORT_TOTAL_STREAMS:
+        return "consumer does not support parallel total update";
     default:
         return NULL;
     }
@@ -194,6 +199,7 @@ conn_new(Repl_Agmt *agmt)
     rpc->supports_ds50_repl = -1;
     rpc->supports_ds71_repl = -1;
     rpc->supports_ds90_repl = -1;
+    rpc->supports_total_streams = -1;
 
     rpc->linger_active = PR_FALSE;
     rpc->delete_after_linger = PR_FALSE;
@@ -603,12 +609,19 @@ check_flow_control_tot_init(Repl_Connection *conn, int optype, const char *extop
 {
     int rcv_msgid;
     int once;
+    long batch_size;
 
-    if ((sent_msgid != 0) && (optype == CONN_EXTENDED_OPERATION) && (strcmp(extop_oid, REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID) == 0)) {
+    if ((sent_msgid != 0) && (optype == CONN_EXTENDED_OPERATION) &&
+        (strcmp(extop_oid, REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID) == 0 ||
+         strcmp(extop_oid, REPL_NSDS_REPLICATION_ENTRIES_REQUEST_OID) == 0 ||
+         strcmp(extop_oid, REPL_NSDS_REPLICATION_DB_RECORDS_REQUEST_OID) == 0)) {
         /* We are sending entries part of the total update of a consumer
          * Wait a bit if the consumer needs to catchup from the current sent entries
+         * The window is in entries, each message of a batched update carries
+         * up to batch_size of them. One message is always allowed in flight.
          */
         rcv_msgid = repl5_tot_last_rcv_msgid(conn);
+        batch_size = repl5_tot_batch_size(conn);
         if (rcv_msgid == -1) {
             slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name,
                           "check_flow_control_tot_init - %s - Check_flow_control_tot_init no callback data [ msgid sent: %d]\n",
@@ -620,7 +633,8 @@ check_flow_control_tot_init(Repl_Connection *conn, int optype, const char *extop
                           agmt_get_long_name(conn->agmt),
                           sent_msgid,
                           rcv_msgid);
-        } else if ((sent_msgid - rcv_msgid) > agmt_get_flowcontrolwindow(conn->agmt)) {
+        } else if ((batch_size == 1 || (sent_msgid - rcv_msgid) > 1) &&
+                   (long)(sent_msgid - rcv_msgid) * batch_size > agmt_get_flowcontrolwindow(conn->agmt)) {
             int totalUpdatePause;
 
             totalUpdatePause = agmt_get_flowcontrolpause(conn->agmt);
@@ -1262,6 +1276,7 @@ close_connection_internal(Repl_Connection *conn)
     conn->supports_ds50_repl = -1;
     conn->supports_ds71_repl = -1;
     conn->supports_ds90_repl = -1;
+    conn->supports_total_streams = -1;
     /* do this last, to minimize the chance that another thread
        might read conn->state as not disconnected and attempt
        to use conn->ld */
@@ -1471,6 +1486,60 @@ conn_replica_supports_ds90_repl(Repl_Connection *conn)
     return return_value;
 }
 
+/*
+ * Determine if the remote replica accepts the entries of a total update
+ * in batches, and over several connections.
+ */
+ConnResult
+conn_replica_supports_total_streams(Repl_Connection *conn)
+{
+    ConnResult return_value;
+    int ldap_rc;
+
+    PR_Lock(conn->lock);
+    if (conn_connected(conn)) {
+        if (conn->supports_total_streams == -1) {
+            LDAPMessage *res = NULL;
+            LDAPMessage *entry = NULL;
+            char *attrs[] = {"supportedextension", NULL};
+
+            conn->status = STATUS_SEARCHING;
+            ldap_rc = ldap_search_ext_s(conn->ld, "", LDAP_SCOPE_BASE,
+                                        "(objectclass=*)", attrs, 0 /* attrsonly */,
+                                        NULL /* server controls */, NULL /* client controls */,
+                                        &conn->timeout, LDAP_NO_LIMIT, &res);
+            if (LDAP_SUCCESS == ldap_rc) {
+                conn->supports_total_streams = 0;
+                entry = ldap_first_entry(conn->ld, res);
+                if (!attribute_string_value_present(conn->ld, entry, "supportedextension", REPL_NSDS_REPLICATION_ENTRIES_REQUEST_OID)) {
+                    return_value = CONN_DOES_NOT_SUPPORT_TOTAL_STREAMS;
+                } else {
+                    conn->supports_total_streams = 1;
+                    return_value = CONN_SUPPORTS_TOTAL_STREAMS;
+                }
+            } else {
+                if (IS_DISCONNECT_ERROR(ldap_rc)) {
+                    conn->last_ldap_error = ldap_rc; /* specific reason */
+                    close_connection_internal(conn);
+                    return_value = CONN_NOT_CONNECTED;
+                } else {
+                    return_value = CONN_OPERATION_FAILED;
+                }
+            }
+            if (NULL != res)
+                ldap_msgfree(res);
+        } else {
+            return_value = conn->supports_total_streams ? CONN_SUPPORTS_TOTAL_STREAMS : CONN_DOES_NOT_SUPPORT_TOTAL_STREAMS;
+        }
+    } else {
+        /* Not connected */
+        return_value = CONN_NOT_CONNECTED;
+    }
+    PR_Unlock(conn->lock);
+
+    return return_value;
+}
+
 /* Determine if the replica is read-only */
 ConnResult
 conn_replica_is_readonly(Repl_Connection *conn)
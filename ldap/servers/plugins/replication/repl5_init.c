@@ -60,10 +60,23 @@ static char *end_name_list[] = {
 static char *total_oid_list[] = {
     REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID,
     REPL_NSDS71_REPLICATION_ENTRY_REQUEST_OID,
+    REPL_NSDS_REPLICATION_ENTRIES_REQUEST_OID,
     NULL};
 static char *total_name_list[] = {
     NSDS_REPL_NAME_PREFIX " Total Update Entry",
     NULL};
+static char *total_stream_oid_list[] = {
+    REPL_NSDS_TOTAL_UPDATE_STREAM_REQUEST_OID,
+    NULL};
+static char *total_stream_name_list[] = {
+    NSDS_REPL_NAME_PREFIX " Total Update Stream",
+    NULL};
+static char *total_snapshot_oid_list[] = {
+    REPL_NSDS_REPLICATION_DB_RECORDS_REQUEST_OID,
+    NULL};
+static char *total_snapshot_name_list[] = {
+    NSDS_REPL_NAME_PREFIX " Total Update Database Records",
+    NULL};
 static char *response_oid_list[] = {
     REPL_NSDS50_REPLICATION_RESPONSE_OID,
     NULL};
@@ -565,6 +578,50 @@ multisupplier_total_extop_init(Slapi_PBlock *pb)
     return rc;
 }
 
+int
+multisupplier_total_stream_extop_init(Slapi_PBlock *pb)
+{
+    int rc = 0; /* OK */
+    void *identity = NULL;
+
+    /* get plugin identity and store it to pass to internal operations */
+    slapi_pblock_get(pb, SLAPI_PLUGIN_IDENTITY, &identity);
+    PR_ASSERT(identity);
+
+    if (slapi_pblock_set(pb, SLAPI_PLUGIN_VERSION, SLAPI_PLUGIN_VERSION_01) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_DESCRIPTION, (void *)&multisupplierextopdesc) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_EXT_OP_OIDLIST, (void *)total_stream_oid_list) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_EXT_OP_NAMELIST, (void *)total_stream_name_list) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_EXT_OP_FN, (void *)multisupplier_extop_NSDSTotalUpdateStreamRequest)) {
+        slapi_log_err(SLAPI_LOG_PLUGIN, repl_plugin_name, "multisupplier_total_stream_extop_init - Failed\n");
+        rc = -1;
+    }
+
+    return rc;
+}
+
+int
+multisupplier_total_snapshot_extop_init(Slapi_PBlock *pb)
+{
+    int rc = 0; /* OK */
+    void *identity = NULL;
+
+    /* get plugin identity and store it to pass to internal operations */
+    slapi_pblock_get(pb, SLAPI_PLUGIN_IDENTITY, &identity);
+    PR_ASSERT(identity);
+
+    if (slapi_pblock_set(pb, SLAPI_PLUGIN_VERSION, SLAPI_PLUGIN_VERSION_01) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_DESCRIPTION, (void *)&multisupplierextopdesc) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_EXT_OP_OIDLIST, (void *)total_snapshot_oid_list) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_EXT_OP_NAMELIST, (void *)total_snapshot_name_list) != 0 ||
+        slapi_pblock_set(pb, SLAPI_PLUGIN_EXT_OP_FN, (void *)multisupplier_extop_NSDSReplicationDbRecords)) {
+        slapi_log_err(SLAPI_LOG_PLUGIN, repl_plugin_name, "multisupplier_total_snapshot_extop_init - Failed\n");
+        rc = -1;
+    }
+
+    return rc;
+}
+
 int
 multisupplier_response_extop_init(Slapi_PBlock *pb)
 {
@@ -974,6 +1031,8 @@ replication_multisupplier_plugin_init(Slapi_PBlock *pb)
         rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_start_extop_init", multisupplier_start_extop_init, "Multisupplier replication start extended operation plugin", NULL, identity);
         rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_end_extop_init", multisupplier_end_extop_init, "Multisupplier replication end extended operation plugin", NULL, identity);
         rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_total_extop_init", multisupplier_total_extop_init, "Multisupplier replication total update extended operation plugin", NULL, identity);
+        rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_total_stream_extop_init", multisupplier_total_stream_extop_init, "Multisupplier replication total update stream extended operation plugin", NULL, identity);
+        rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_total_snapshot_extop_init", multisupplier_total_snapshot_extop_init, "Multisupplier replication total update database records extended operation plugin", NULL, identity);
         rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_response_extop_init", multisupplier_response_extop_init, "Multisupplier replication extended response plugin", NULL, identity);
         rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_cleanruv_extop_init", multisupplier_cleanruv_extop_init, "Multisupplier replication cleanruv extended operation plugin", NULL, identity);
         rc = slapi_register_plugin("extendedop", 1 /* Enabled */, "multisupplier_cleanruv_abort_extop_init", multisupplier_cleanruv_abort_extop_init, "Multisupplier replication cleanruv abort extended operation plugin", NULL, identity);
@@ -55,7 +55,7 @@ static int write_changelog_and_ruv(Slapi_PBlock *pb);
 static int process_postop(Slapi_PBlock *pb);
 static int cancel_opcsn(Slapi_PBlock *pb);
 static int ruv_tombstone_op(Slapi_PBlock *pb);
-static PRBool process_operation(Slapi_PBlock *pb, const CSN *csn);
+static PRBool process_operation(Slapi_PBlock *pb, const CSN *csn, const char *target_uuid, const char *superior_uuid);
 static PRBool is_mmr_replica(Slapi_PBlock *pb);
 static const char *replica_get_purl_for_op(const Replica *r, Slapi_PBlock *pb, const CSN *opcsn);
 
@@ -170,7 +170,7 @@ multisupplier_preop_add(Slapi_PBlock *pb)
 
                     /* we don't want to process replicated operations with csn smaller
                     than the corresponding csn in the consumer's ruv */
-                    if (!process_operation(pb, csn)) {
+                    if (!process_operation(pb, csn, target_uuid, superior_uuid)) {
                         slapi_send_ldap_result(pb, LDAP_SUCCESS, 0,
                                                "replication operation not processed, replica unavailable "
                                                "or csn ignored",
@@ -259,7 +259,7 @@ multisupplier_preop_delete(Slapi_PBlock *pb)
                 } else if (1 == drc) {
                     /* we don't want to process replicated operations with csn smaller
                     than the corresponding csn in the consumer's ruv */
-                    if (!process_operation(pb, csn)) {
+                    if (!process_operation(pb, csn, target_uuid, NULL)) {
                         slapi_send_ldap_result(pb, LDAP_SUCCESS, 0,
                                                "replication operation not processed, replica unavailable "
                                                "or csn ignored",
@@ -333,7 +333,7 @@ multisupplier_preop_modify(Slapi_PBlock *pb)
                 } else if (1 == drc) {
                     /* we don't want to process replicated operations with csn smaller
                     than the corresponding csn in the consumer's ruv */
-                    if (!process_operation(pb, csn)) {
+                    if (!process_operation(pb, csn, target_uuid, NULL)) {
                         slapi_send_ldap_result(pb, LDAP_SUCCESS, 0,
                                                "replication operation not processed, replica unavailable "
                                                "or csn ignored",
@@ -421,7 +421,7 @@ multisupplier_preop_modrdn(Slapi_PBlock *pb)
 
                     /* we don't want to process replicated operations with csn smaller
                     than the corresponding csn in the consumer's ruv */
-                    if (!process_operation(pb, csn)) {
+                    if (!process_operation(pb, csn, target_uuid, NULL)) {
                         slapi_send_ldap_result(pb, LDAP_SUCCESS, 0,
                                                "replication operation not processed, replica unavailable "
                                                "or csn ignored",
@@ -1350,14 +1350,63 @@ ruv_tombstone_op(Slapi_PBlock *pb)
     return rc;
 }
 
+/*
+ * Registers the entries a replicated update applied in parallel applies
+ * to: the target entry, and the parent an add or a delete depends on.
+ * An add whose parent is missing creates a glue entry for it, so it also
+ * applies to the parent.
+ */
+static void
+register_apply_entries(Slapi_PBlock *pb, Replica *r, const char *target_uuid, const char *superior_uuid)
+{
+    Slapi_Operation *op = NULL;
+    Slapi_DN *sdn = NULL;
+    char **keys = NULL;
+    char **deps = NULL;
+    unsigned long optype;
+
+    slapi_pblock_get(pb, SLAPI_OPERATION, &op);
+    slapi_pblock_get(pb, SLAPI_TARGET_SDN, &sdn);
+    optype = operation_get_type(op);
+
+    if (sdn) {
+        charray_add(&keys, slapi_ch_strdup(slapi_sdn_get_ndn(sdn)));
+    }
+    if (target_uuid) {
+        charray_add(&keys, slapi_ch_strdup(target_uuid));
+    }
+    if (optype == SLAPI_OPERATION_ADD || optype == SLAPI_OPERATION_DELETE) {
+        const char *parent = sdn ? slapi_dn_find_parent(slapi_sdn_get_ndn(sdn)) : NULL;
+
+        if (parent) {
+            charray_add(&deps, slapi_ch_strdup(parent));
+            if (optype == SLAPI_OPERATION_ADD) {
+                Slapi_DN *parent_sdn = slapi_sdn_new_ndn_byref(parent);
+                char *attrs[] = {"1.1", NULL};
+
+                if (slapi_search_internal_get_entry(parent_sdn, attrs, NULL,
+                                                    repl_get_plugin_identity(PLUGIN_MULTISUPPLIER_REPLICATION)) != LDAP_SUCCESS) {
+                    charray_add(&keys, slapi_ch_strdup(parent));
+                }
+                slapi_sdn_free(&parent_sdn);
+            }
+        }
+        if (superior_uuid) {
+            charray_add(&deps, slapi_ch_strdup(superior_uuid));
+        }
+    }
+    replica_update_parallel_apply_stats(r, slapi_operation_apply_register(pb, keys, deps));
+}
+
 /* we don't want to process replicated operations with csn smaller
    than the corresponding csn in the consumer's ruv */
 static PRBool
-process_operation(Slapi_PBlock *pb, const CSN *csn)
+process_operation(Slapi_PBlock *pb, const CSN *csn, const char *target_uuid, const char *superior_uuid)
 {
     Replica *r;
     Object *ruv_obj;
     RUV *ruv;
+    int parallel;
     int rc;
 
     r = replica_get_replica_for_op(pb);
@@ -1376,10 +1425,19 @@ process_operation(Slapi_PBlock *pb, const CSN *csn)
     ruv = (RUV *)object_get_data(ruv_obj);
     PR_ASSERT(ruv);
 
+    /*
+     * Applied in parallel, the csns of the session must enter the pending
+     * list in order: an earlier csn would be taken as already seen.
+     */
+    parallel = slapi_operation_apply_wait_turn(pb);
     rc = ruv_add_csn_inprogress(r, ruv, csn);
 
     object_release(ruv_obj);
 
+    if (parallel) {
+        register_apply_entries(pb, r, target_uuid, superior_uuid);
+    }
+
     return (rc == RUV_SUCCESS);
 }
 
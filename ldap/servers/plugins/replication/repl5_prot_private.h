@@ -52,6 +52,7 @@ extern Private_Repl_Protocol *Repl_5_Inc_Protocol_new(Repl_Protocol *rp);
 extern Private_Repl_Protocol *Repl_5_Tot_Protocol_new(Repl_Protocol *rp);
 extern int repl5_tot_last_rcv_msgid(Repl_Connection *conn);
 extern int repl5_tot_flowcontrol_detection(Repl_Connection *conn, int increment);
+extern long repl5_tot_batch_size(Repl_Connection *conn);
 extern Private_Repl_Protocol *Windows_Inc_Protocol_new(Repl_Protocol *rp);
 extern Private_Repl_Protocol *Windows_Tot_Protocol_new(Repl_Protocol *rp);
 
@@ -55,6 +55,33 @@ get_current_csn(Slapi_DN *replarea_sdn)
     return current_csn;
 }
 
+/* The total protocol ships the entries, the snapshot one the database records */
+static int
+is_total_protocol_oid(const char *prot_oid)
+{
+    return (strcmp(REPL_NSDS50_TOTAL_PROTOCOL_OID, prot_oid) == 0 ||
+            strcmp(REPL_NSDS_SNAPSHOT_TOTAL_PROTOCOL_OID, prot_oid) == 0);
+}
+
+/*
+ * The fingerprint of the index configuration of the backend holding the
+ * replicated area, sent with the start request of the snapshot protocol.
+ * Without it the consumer refuses the snapshot.
+ */
+static void
+get_snapshot_fingerprint(const Slapi_DN *replarea_sdn, char **data_guid, struct berval **data)
+{
+    Slapi_Backend *be = slapi_be_select(replarea_sdn);
+    back_info_snapshot snap = {0};
+
+    if (be && slapi_back_ctrl_info(be, BACK_INFO_SNAPSHOT_FINGERPRINT, &snap) == 0 && snap.fingerprint) {
+        *data_guid = slapi_ch_strdup(REPL_NSDS_SNAPSHOT_FINGERPRINT_GUID);
+        *data = (struct berval *)slapi_ch_malloc(sizeof(struct berval));
+        (*data)->bv_val = snap.fingerprint;
+        (*data)->bv_len = strlen(snap.fingerprint);
+    }
+}
+
 /*
  * Acquire exclusive access to a replica. Send a start replication extended
  * operation to the replica. The response will contain a success code, and
@@ -188,7 +215,7 @@ acquire_replica(Private_Repl_Protocol *prp, char *prot_oid, RUV **ruv)
                 struct berval *data = NULL;
 
                 /* Check if this is a total or incremental update. */
-                if (strcmp(REPL_NSDS50_TOTAL_PROTOCOL_OID, prot_oid) == 0) {
+                if (is_total_protocol_oid(prot_oid)) {
                     is_total = 1;
                 }
 
@@ -196,6 +223,14 @@ acquire_replica(Private_Repl_Protocol *prp, char *prot_oid, RUV **ruv)
                  * may have extra data to be sent to the replica. */
                 if (repl_session_plugin_call_pre_acquire_cb(prp->agmt, is_total,
                                                             &data_guid, &data) == 0) {
+                    if (strcmp(REPL_NSDS_SNAPSHOT_TOTAL_PROTOCOL_OID, prot_oid) == 0) {
+                        /* The consumer only takes the records if its index
+                         * configuration is the same as ours */
+                        slapi_ch_free_string(&data_guid);
+                        ber_bvfree(data);
+                        data = NULL;
+                        get_snapshot_fingerprint(replarea_sdn, &data_guid, &data);
+                    }
                     payload = NSDS90StartReplicationRequest_new(
                         prot_oid, slapi_sdn_get_ndn(replarea_sdn),
                         NULL, current_csn, data_guid, data);
@@ -334,8 +369,7 @@ acquire_replica(Private_Repl_Protocol *prp, char *prot_oid, RUV **ruv)
                         /* Someone else is updating the replica. Try later. */
                         /* if acquire_replica is called for replica
                            initialization, log REPLICA_BUSY, too */
-                        if (strcmp(REPL_NSDS50_TOTAL_PROTOCOL_OID,
-                                   prot_oid) == 0) {
+                        if (is_total_protocol_oid(prot_oid)) {
                             slapi_log_err(SLAPI_LOG_NOTICE, repl_plugin_name,
                                           "acquire_replica - "
                                           "%s: Unable to acquire replica: "
@@ -393,7 +427,7 @@ acquire_replica(Private_Repl_Protocol *prp, char *prot_oid, RUV **ruv)
                             int is_total = 0;
 
                             /* Check if this is a total or incremental update. */
-                            if (strcmp(REPL_NSDS50_TOTAL_PROTOCOL_OID, prot_oid) == 0) {
+                            if (is_total_protocol_oid(prot_oid)) {
                                 is_total = 1;
                             }
 
@@ -54,15 +54,25 @@ struct replica
     PRBool tombstone_reap_stop;        /* TRUE when the tombstone reaper should stop */
     PRBool tombstone_reap_active;      /* TRUE when the tombstone reaper is running */
     int64_t tombstone_reap_interval;   /* Time in seconds between tombstone reaping */
+    int64_t tombstone_reap_batch_size; /* Most tombstones purged per backend transaction */
+    uint64_t tombstone_reap_purged;    /* Tombstones purged by the current or last reap */
+    uint64_t tombstone_reap_rate;      /* Tombstones purged per second by the current or last reap */
+    uint64_t tombstone_reap_backlog;   /* Expired tombstones left to purge */
     Slapi_ValueSet *repl_referral;     /* A list of administrator provided referral URLs */
     PRBool state_update_inprogress;    /* replica state is being updated */
     PRLock *agmt_lock;                 /* protects agreement creation, start and stop */
     char *locking_purl;                /* supplier who has exclusive access */
     uint64_t locking_conn;             /* The supplier's connection id */
+    Slapi_Connection *total_update_conn; /* Connection of the total update other connections can stream to */
+    uint64_t total_update_streams;     /* Number of stream operations importing on total_update_conn */
     Slapi_Counter *protocol_timeout;   /* protocol shutdown timeout */
     Slapi_Counter *backoff_min;        /* backoff retry minimum */
     Slapi_Counter *backoff_max;        /* backoff retry maximum */
     Slapi_Counter *precise_purging;    /* Enable precise tombstone purging */
+    Slapi_Counter *parallel_apply;     /* Apply the updates of a session concurrently */
+    Slapi_Counter *parallel_apply_ops; /* Updates applied in parallel */
+    Slapi_Counter *parallel_apply_running; /* Sum over these updates of the updates running with them */
+    uint64_t parallel_apply_running_max;   /* Most updates running at once */
     uint64_t agmt_count;               /* Number of agmts */
     Slapi_Counter *release_timeout;    /* The amount of time to wait before releasing active replica */
     uint64_t abort_session;            /* Abort the current replica session */
@@ -71,13 +81,25 @@ struct replica
 };
 
 
+/* Most tombstones a search of the reaper keeps to purge */
+#define REAP_MAX_PENDING 100000
+/* Waiting longer (in milliseconds) for the backend transaction halves the next batch */
+#define REAP_TXN_MAX_WAIT 10
+/* Most attempts to commit a batch of tombstones */
+#define REAP_BATCH_MAX_RETRIES 3
+
 typedef struct reap_callback_data
 {
     int rc;
     uint64_t num_entries;
     uint64_t num_purged_entries;
+    uint64_t num_expired_entries; /* tombstones found to purge, and not purged yet */
     CSN *purge_csn;
     PRBool *tombstone_reap_stop;
+    char **pending_dns; /* the tombstones to purge once the search is done */
+    char **pending_uniqueids;
+    size_t num_pending;
+    size_t max_pending;
 } reap_callback_data;
 
 
@@ -100,7 +122,7 @@ static void replica_get_referrals_nolock(const Replica *r, char ***referrals);
 static int replica_log_ruv_elements_nolock(const Replica *r);
 static void replica_replace_ruv_tombstone(Replica *r);
 static void start_agreements_for_replica(Replica *r, PRBool start);
-static void _delete_tombstone(const char *tombstone_dn, const char *uniqueid, int ext_op_flags);
+static int _delete_tombstone(const char *tombstone_dn, const char *uniqueid, int ext_op_flags);
 static void replica_strip_cleaned_rids(Replica *r);
 
 static void
@@ -192,6 +214,9 @@ replica_new_from_entry(Slapi_Entry *e, char *errortext, PRBool is_add_operation,
     r->backoff_min = slapi_counter_new();
     r->backoff_max = slapi_counter_new();
     r->precise_purging = slapi_counter_new();
+    r->parallel_apply = slapi_counter_new();
+    r->parallel_apply_ops = slapi_counter_new();
+    r->parallel_apply_running = slapi_counter_new();
 
     /* read parameters from the replica config entry */
     rc = _replica_init_from_config(r, e, errortext);
@@ -408,6 +433,9 @@ replica_destroy(void **arg)
     slapi_counter_destroy(&r->backoff_min);
     slapi_counter_destroy(&r->backoff_max);
     slapi_counter_destroy(&r->precise_purging);
+    slapi_counter_destroy(&r->parallel_apply);
+    slapi_counter_destroy(&r->parallel_apply_ops);
+    slapi_counter_destroy(&r->parallel_apply_running);
 
     slapi_ch_free((void **)arg);
 }
@@ -711,6 +739,20 @@ replica_get_tombstone_reap_active(const Replica *r)
     return (r->tombstone_reap_active);
 }
 
+/*
+ * Returns the tombstones purged by the current or last reap, per second,
+ * and the expired tombstones left to purge
+ */
+void
+replica_get_tombstone_reap_stats(Replica *r, uint64_t *purged, uint64_t *rate, uint64_t *backlog)
+{
+    replica_lock(r->repl_lock);
+    *purged = r->tombstone_reap_purged;
+    *rate = r->tombstone_reap_rate;
+    *backlog = r->tombstone_reap_backlog;
+    replica_unlock(r->repl_lock);
+}
+
 /*
  * Returns root of the replicated area
  */
@@ -747,6 +789,76 @@ replica_get_locking_conn(const Replica *r)
     replica_unlock(r->repl_lock);
     return connid;
 }
+/*
+ * Total update streams
+ *
+ * The connection that holds the replica for a total update owns the bulk
+ * import. Once it is registered here, the other connections the supplier
+ * opens for the same total update import their entries through it. Each
+ * stream operation holds a reference on that connection, so it is not
+ * cleaned up under the import. Before the bulk import is stopped, the
+ * registration is removed and the stream operations still importing are
+ * waited for.
+ */
+void
+replica_total_update_streams_open(Replica *r, Slapi_Connection *conn)
+{
+    PR_ASSERT(r);
+
+    replica_lock(r->repl_lock);
+    r->total_update_conn = conn;
+    replica_unlock(r->repl_lock);
+}
+
+void
+replica_total_update_streams_close(Replica *r)
+{
+    PR_ASSERT(r);
+
+    replica_lock(r->repl_lock);
+    r->total_update_conn = NULL;
+    while (r->total_update_streams > 0) {
+        PR_Wait(r->repl_lock, PR_INTERVAL_NO_TIMEOUT);
+    }
+    replica_unlock(r->repl_lock);
+}
+
+/*
+ * Returns the connection to import the entries of a stream through, or
+ * NULL if no total update accepts streams. A non NULL return must be
+ * followed by replica_total_update_stream_exit once the import is done.
+ */
+Slapi_Connection *
+replica_total_update_stream_enter(Replica *r)
+{
+    Slapi_Connection *conn;
+
+    PR_ASSERT(r);
+
+    replica_lock(r->repl_lock);
+    conn = r->total_update_conn;
+    if (conn && slapi_connection_acquire(conn) == 0) {
+        r->total_update_streams++;
+    } else {
+        conn = NULL;
+    }
+    replica_unlock(r->repl_lock);
+    return conn;
+}
+
+void
+replica_total_update_stream_exit(Replica *r, Slapi_Connection *conn)
+{
+    PR_ASSERT(r);
+
+    replica_lock(r->repl_lock);
+    slapi_connection_release(conn);
+    if (--r->total_update_streams == 0) {
+        PR_NotifyAll(r->repl_lock);
+    }
+    replica_unlock(r->repl_lock);
+}
+
 /*
  * Returns replicaid of this replica
  */
@@ -1943,6 +2055,7 @@ _replica_init_from_config(Replica *r, Slapi_Entry *e, char *errortext)
     Slapi_Attr *attr;
     CSNGen *gen;
     char *precise_purging = NULL;
+    char *parallel_apply = NULL;
     char buf[SLAPI_DSE_RETURNTEXT_SIZE];
     char *errormsg = errortext ? errortext : buf;
     char *val;
@@ -2069,6 +2182,25 @@ _replica_init_from_config(Replica *r, Slapi_Entry *e, char *errortext)
         slapi_counter_set_value(r->precise_purging, 0);
     }
 
+    /* check for the parallel apply of the replicated updates */
+    parallel_apply = (char *)slapi_entry_attr_get_ref(e, type_replicaParallelApply);
+    if (parallel_apply) {
+        if (strcasecmp(parallel_apply, "on") == 0) {
+            slapi_counter_set_value(r->parallel_apply, 1);
+        } else if (strcasecmp(parallel_apply, "off") == 0) {
+            slapi_counter_set_value(r->parallel_apply, 0);
+        } else {
+            /* Invalid value */
+            PR_snprintf(errormsg, SLAPI_DSE_RETURNTEXT_SIZE, "Invalid value for %s: %s",
+                        type_replicaParallelApply, parallel_apply);
+            slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "_replica_init_from_config - "
+                          "%s\n", errormsg);
+            return LDAP_UNWILLING_TO_PERFORM;
+        }
+    } else {
+        slapi_counter_set_value(r->parallel_apply, 0);
+    }
+
     /* get replica flags */
     if (slapi_entry_attr_exists(e, attr_flags)) {
         int64_t rflags;
@@ -2193,6 +2325,15 @@ _replica_init_from_config(Replica *r, Slapi_Entry *e, char *errortext)
         r->tombstone_reap_interval = 3600 * 24; /* One week, in seconds */
     }
 
+    if ((val = (char*)slapi_entry_attr_get_ref(e, type_replicaTombstoneReapBatchSize))) {
+        if (repl_config_valid_num(type_replicaTombstoneReapBatchSize, val, 1, INT_MAX, &rc, errormsg, &interval) != 0) {
+            return LDAP_UNWILLING_TO_PERFORM;
+        }
+        r->tombstone_reap_batch_size = interval;
+    } else {
+        r->tombstone_reap_batch_size = DEFAULT_REPLICA_TOMBSTONE_REAP_BATCH_SIZE;
+    }
+
     if ((val = (char*)slapi_entry_attr_get_ref(e, type_replicaKeepAliveUpdateInterval))) {
         if (repl_config_valid_num(type_replicaKeepAliveUpdateInterval, val, REPLICA_KEEPALIVE_UPDATE_INTERVAL_MIN,
                                   INT_MAX, &rc, errormsg, &interval) != 0)
@@ -3108,16 +3249,16 @@ entry_get_deletion_csn(Slapi_Entry *e)
 }
 
 
-static void
+static int
 _delete_tombstone(const char *tombstone_dn, const char *uniqueid, int ext_op_flags)
 {
+    int ldaprc = LDAP_PARAM_ERROR;
 
     PR_ASSERT(NULL != tombstone_dn && NULL != uniqueid);
     if (NULL == tombstone_dn || NULL == uniqueid) {
         slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "_delete_tombstone - "
                                                        "NULL tombstone_dn or uniqueid provided.\n");
     } else {
-        int ldaprc;
         Slapi_PBlock *pb = slapi_pblock_new();
         slapi_delete_internal_set_pb(pb, tombstone_dn, NULL, /* controls */
                                      uniqueid, repl_get_plugin_identity(PLUGIN_MULTISUPPLIER_REPLICATION),
@@ -3133,6 +3274,7 @@ _delete_tombstone(const char *tombstone_dn, const char *uniqueid, int ext_op_fla
         }
         slapi_pblock_destroy(pb);
     }
+    return ldaprc;
 }
 
 static void
@@ -3143,13 +3285,47 @@ get_reap_result(int rc, void *cb_data)
     ((reap_callback_data *)cb_data)->rc = rc;
 }
 
+/*
+ * Keeps a tombstone to purge once the search is done, up to
+ * REAP_MAX_PENDING of them: another search finds the next ones.
+ */
+static void
+reap_add_pending(reap_callback_data *cb_data, Slapi_Entry *entry)
+{
+    cb_data->num_expired_entries++;
+    if (cb_data->num_pending == REAP_MAX_PENDING) {
+        return;
+    }
+    if (cb_data->num_pending == cb_data->max_pending) {
+        cb_data->max_pending = cb_data->max_pending ? 2 * cb_data->max_pending : 1024;
+        cb_data->pending_dns = (char **)slapi_ch_realloc((char *)cb_data->pending_dns,
+                                                         cb_data->max_pending * sizeof(char *));
+        cb_data->pending_uniqueids = (char **)slapi_ch_realloc((char *)cb_data->pending_uniqueids,
+                                                               cb_data->max_pending * sizeof(char *));
+    }
+    cb_data->pending_dns[cb_data->num_pending] = slapi_ch_strdup(slapi_entry_get_dn(entry));
+    cb_data->pending_uniqueids[cb_data->num_pending] = slapi_ch_strdup(slapi_entry_get_uniqueid(entry));
+    cb_data->num_pending++;
+}
+
+static void
+reap_free_pending(reap_callback_data *cb_data)
+{
+    for (size_t i = 0; i < cb_data->num_pending; i++) {
+        slapi_ch_free_string(&cb_data->pending_dns[i]);
+        slapi_ch_free_string(&cb_data->pending_uniqueids[i]);
+    }
+    slapi_ch_free((void **)&cb_data->pending_dns);
+    slapi_ch_free((void **)&cb_data->pending_uniqueids);
+    cb_data->num_pending = cb_data->max_pending = 0;
+}
+
 static int
 process_reap_entry(Slapi_Entry *entry, void *cb_data)
 {
     char deletion_csn_str[CSN_STRSIZE];
     char purge_csn_str[CSN_STRSIZE];
     uint64_t *num_entriesp = &((reap_callback_data *)cb_data)->num_entries;
-    uint64_t *num_purged_entriesp = &((reap_callback_data *)cb_data)->num_purged_entries;
     CSN *purge_csn = ((reap_callback_data *)cb_data)->purge_csn;
     /* this is a pointer into the actual value in the Replica object - so that
        if the value is set in the replica, we will know about it immediately */
@@ -3194,9 +3370,7 @@ process_reap_entry(Slapi_Entry *entry, void *cb_data)
                           csn_as_string(purge_csn, PR_FALSE, purge_csn_str));
         }
         if (slapi_entry_attr_get_ulong(entry, "tombstonenumsubordinates") < 1) {
-            _delete_tombstone(slapi_entry_get_dn(entry),
-                              slapi_entry_get_uniqueid(entry), 0);
-            (*num_purged_entriesp)++;
+            reap_add_pending((reap_callback_data *)cb_data, entry);
         }
     } else {
         if (slapi_is_loglevel_set(SLAPI_LOG_REPL)) {
@@ -3218,6 +3392,121 @@ process_reap_entry(Slapi_Entry *entry, void *cb_data)
 }
 
 
+static void
+_replica_reap_update_stats(Replica *replica, reap_callback_data *cb_data, struct timespec *start)
+{
+    struct timespec now;
+    struct timespec elapsed;
+    uint64_t elapsed_ms;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    slapi_timespec_diff(&now, start, &elapsed);
+    elapsed_ms = (uint64_t)elapsed.tv_sec * 1000 + elapsed.tv_nsec / 1000000;
+
+    replica_lock(replica->repl_lock);
+    replica->tombstone_reap_purged = cb_data->num_purged_entries;
+    replica->tombstone_reap_rate = elapsed_ms ? cb_data->num_purged_entries * 1000 / elapsed_ms
+                                              : cb_data->num_purged_entries;
+    replica->tombstone_reap_backlog = cb_data->num_expired_entries;
+    replica_unlock(replica->repl_lock);
+}
+
+/*
+ * Purges the tombstones found by a search in batches, each batch in one
+ * backend transaction: the transaction is committed once per batch
+ * instead of once per tombstone.
+ *
+ * Beginning the transaction waits for the backend lock held by the client
+ * writes, so the time it takes is what the client writes cost the reaper.
+ * A wait longer than REAP_TXN_MAX_WAIT halves the next batch, a short one
+ * doubles it back up to nsds5ReplicaTombstoneReapBatchSize. After a wait
+ * the reaper sleeps as long before the next batch, to let the client
+ * writes in.
+ *
+ * The purge counters are only updated once a batch is committed. A batch
+ * failing to commit is retried, halved, up to REAP_BATCH_MAX_RETRIES times
+ * before the reap stops: its tombstones stay in the backlog.
+ */
+static void
+_replica_reap_pending(Replica *replica, reap_callback_data *cb_data, struct timespec *start)
+{
+    Slapi_Backend *be = slapi_be_select(replica->repl_root);
+    int64_t batch_max = replica_get_tombstone_reap_batch_size(replica);
+    int64_t batch_size = batch_max;
+    int retries = 0;
+    size_t i = 0;
+
+    while (i < cb_data->num_pending) {
+        Slapi_PBlock *txn_pb = slapi_pblock_new();
+        size_t first = i;
+        size_t end = i + batch_size < cb_data->num_pending ? i + batch_size : cb_data->num_pending;
+        struct timespec wait_start;
+        struct timespec wait_end;
+        struct timespec elapsed;
+        uint64_t purged = 0;
+        int64_t wait_ms;
+        int txn = 0;
+        int rc;
+
+        if (*cb_data->tombstone_reap_stop || slapi_is_shutting_down()) {
+            slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                          "_replica_reap_pending - The tombstone reap process "
+                          " has been stopped\n");
+            slapi_pblock_destroy(txn_pb);
+            break;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &wait_start);
+        slapi_pblock_set(txn_pb, SLAPI_BACKEND, be);
+        if (be && slapi_back_transaction_begin(txn_pb) == 0) {
+            txn = 1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &wait_end);
+        slapi_timespec_diff(&wait_end, &wait_start, &elapsed);
+        wait_ms = (int64_t)elapsed.tv_sec * 1000 + elapsed.tv_nsec / 1000000;
+
+        for (; i < end; i++) {
+            if (_delete_tombstone(cb_data->pending_dns[i], cb_data->pending_uniqueids[i], 0) == LDAP_SUCCESS) {
+                purged++;
+            }
+        }
+        if (txn && (rc = slapi_back_transaction_commit(txn_pb)) != 0) {
+            slapi_pblock_destroy(txn_pb);
+            /* Nothing of the batch was purged: purge it again */
+            i = first;
+            if (++retries > REAP_BATCH_MAX_RETRIES) {
+                slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name,
+                              "_replica_reap_pending - Failed to commit the purge of %" PRIu64 " tombstones "
+                              "in replica %s (%d), stopping the reap\n",
+                              purged, slapi_sdn_get_dn(replica->repl_root), rc);
+                break;
+            }
+            slapi_log_err(SLAPI_LOG_WARNING, repl_plugin_name,
+                          "_replica_reap_pending - Failed to commit the purge of %" PRIu64 " tombstones "
+                          "in replica %s (%d), retrying\n",
+                          purged, slapi_sdn_get_dn(replica->repl_root), rc);
+            if (batch_size > 1) {
+                batch_size /= 2;
+            }
+            continue;
+        }
+        slapi_pblock_destroy(txn_pb);
+        retries = 0;
+        cb_data->num_purged_entries += purged;
+        cb_data->num_expired_entries -= purged;
+        _replica_reap_update_stats(replica, cb_data, start);
+
+        if (wait_ms > REAP_TXN_MAX_WAIT && batch_size > 1) {
+            batch_size /= 2;
+        } else if (wait_ms < REAP_TXN_MAX_WAIT / 2 && batch_size < batch_max) {
+            batch_size = 2 * batch_size < batch_max ? 2 * batch_size : batch_max;
+        }
+        if (i < cb_data->num_pending && wait_ms > 0) {
+            DS_Sleep(PR_MillisecondsToInterval(wait_ms));
+        }
+    }
+}
+
 /* This does the actual work of searching for tombstones and deleting them.
    This must be called in a separate thread because it may take a long time.
 */
@@ -3255,10 +3544,15 @@ _replica_reap_tombstones(void *arg)
     purge_csn = replica_get_purge_csn(replica);
     if (NULL != purge_csn) {
         LDAPControl **ctrls;
-        reap_callback_data cb_data;
+        reap_callback_data cb_data = {0};
         char deletion_csn_str[CSN_STRSIZE];
         char tombstone_filter[128];
         char **attrs = NULL;
+        struct timespec start;
+        uint64_t num_tombstones = 0;
+        uint64_t num_purged = 0;
+        int first_pass = 1;
+        int more = 0;
         int oprc;
 
         if (replica_get_precise_purging(replica)) {
@@ -3286,35 +3580,60 @@ _replica_reap_tombstones(void *arg)
         charray_add(&attrs, slapi_ch_strdup("tombstonenumsubordinates"));
         charray_add(&attrs, slapi_ch_strdup(SLAPI_ATTR_TOMBSTONE_CSN));
 
-        ctrls = (LDAPControl **)slapi_ch_calloc(3, sizeof(LDAPControl *));
-        ctrls[0] = create_managedsait_control();
-        ctrls[1] = create_backend_control(replica->repl_root);
-        ctrls[2] = NULL;
-        pb = slapi_pblock_new();
-        slapi_search_internal_set_pb(pb, slapi_sdn_get_dn(replica->repl_root),
-                                     LDAP_SCOPE_SUBTREE, tombstone_filter,
-                                     attrs, 0, ctrls, NULL,
-                                     repl_get_plugin_identity(PLUGIN_MULTISUPPLIER_REPLICATION),
-                                     OP_FLAG_REVERSE_CANDIDATE_ORDER);
-
-        cb_data.rc = 0;
-        cb_data.num_entries = 0UL;
-        cb_data.num_purged_entries = 0UL;
         cb_data.purge_csn = purge_csn;
         /* set the cb data pointer to point to the actual memory address in
            the actual Replica object - so that when the value in the Replica
            is set, the reap process will know about it immediately */
         cb_data.tombstone_reap_stop = &(replica->tombstone_reap_stop);
+        clock_gettime(CLOCK_MONOTONIC, &start);
 
-        slapi_search_internal_callback_pb(pb, &cb_data /* callback data */,
-                                          get_reap_result /* result callback */,
-                                          process_reap_entry /* entry callback */,
-                                          NULL /* referral callback*/);
+        /*
+         * The search keeps the tombstones to purge, which are purged once it
+         * is done. If it found more than REAP_MAX_PENDING of them, another
+         * search finds the next ones.
+         */
+        do {
+            ctrls = (LDAPControl **)slapi_ch_calloc(3, sizeof(LDAPControl *));
+            ctrls[0] = create_managedsait_control();
+            ctrls[1] = create_backend_control(replica->repl_root);
+            ctrls[2] = NULL;
+            pb = slapi_pblock_new();
+            slapi_search_internal_set_pb(pb, slapi_sdn_get_dn(replica->repl_root),
+                                         LDAP_SCOPE_SUBTREE, tombstone_filter,
+                                         attrs, 0, ctrls, NULL,
+                                         repl_get_plugin_identity(PLUGIN_MULTISUPPLIER_REPLICATION),
+                                         OP_FLAG_REVERSE_CANDIDATE_ORDER);
+
+            cb_data.rc = 0;
+            cb_data.num_entries = 0UL;
+            cb_data.num_expired_entries = 0UL;
+
+            slapi_search_internal_callback_pb(pb, &cb_data /* callback data */,
+                                              get_reap_result /* result callback */,
+                                              process_reap_entry /* entry callback */,
+                                              NULL /* referral callback*/);
+            slapi_free_search_results_internal(pb);
+            slapi_pblock_destroy(pb);
+            pb = NULL;
+
+            oprc = cb_data.rc;
+            if (first_pass) {
+                num_tombstones = cb_data.num_entries;
+                first_pass = 0;
+            }
+            more = cb_data.num_expired_entries > cb_data.num_pending;
+            num_purged = cb_data.num_purged_entries;
+            if (LDAP_SUCCESS == oprc) {
+                _replica_reap_update_stats(replica, &cb_data, &start);
+                _replica_reap_pending(replica, &cb_data, &start);
+            }
+            reap_free_pending(&cb_data);
+            /* Stop if the last tombstones could not be purged */
+        } while (LDAP_SUCCESS == oprc && more && cb_data.num_purged_entries > num_purged &&
+                 !replica->tombstone_reap_stop && !slapi_is_shutting_down());
 
         charray_free(attrs);
 
-        oprc = cb_data.rc;
-
         if (LDAP_SUCCESS != oprc) {
             slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name,
                           "_replica_reap_tombstones - Failed when searching for "
@@ -3327,7 +3646,7 @@ _replica_reap_tombstones(void *arg)
                           "_replica_reap_tombstones - Purged %" PRIu64 " of %" PRIu64 " tombstones "
                           "in replica %s. Will try again in %" PRId64 " "
                           "seconds.\n",
-                          cb_data.num_purged_entries, cb_data.num_entries,
+                          cb_data.num_purged_entries, num_tombstones,
                           slapi_sdn_get_dn(replica->repl_root),
                           replica->tombstone_reap_interval);
         }
@@ -3738,6 +4057,25 @@ replica_set_tombstone_reap_interval(Replica *r, long interval)
     replica_unlock(r->repl_lock);
 }
 
+void
+replica_set_tombstone_reap_batch_size(Replica *r, int64_t batch_size)
+{
+    replica_lock(r->repl_lock);
+    r->tombstone_reap_batch_size = batch_size;
+    replica_unlock(r->repl_lock);
+}
+
+int64_t
+replica_get_tombstone_reap_batch_size(Replica *r)
+{
+    int64_t batch_size;
+
+    replica_lock(r->repl_lock);
+    batch_size = r->tombstone_reap_batch_size;
+    replica_unlock(r->repl_lock);
+    return batch_size;
+}
+
 void
 replica_set_keepalive_update_interval(Replica *r, int64_t interval)
 {
@@ -4231,6 +4569,50 @@ replica_get_precise_purging(Replica *r)
     }
 }
 
+void
+replica_set_parallel_apply(Replica *r, uint64_t on_off)
+{
+    if (r) {
+        slapi_counter_set_value(r->parallel_apply, on_off);
+    }
+}
+
+uint64_t
+replica_get_parallel_apply(Replica *r)
+{
+    if (r) {
+        return slapi_counter_get_value(r->parallel_apply);
+    } else {
+        return 0;
+    }
+}
+
+/* Accounts an update applied in parallel, running with running-1 others */
+void
+replica_update_parallel_apply_stats(Replica *r, int running)
+{
+    if (r == NULL || running <= 0) {
+        return;
+    }
+    slapi_counter_increment(r->parallel_apply_ops);
+    slapi_counter_add(r->parallel_apply_running, (uint64_t)running);
+    if ((uint64_t)running > slapi_atomic_load_64(&r->parallel_apply_running_max, __ATOMIC_ACQUIRE)) {
+        replica_lock(r->repl_lock);
+        if ((uint64_t)running > r->parallel_apply_running_max) {
+            slapi_atomic_store_64(&r->parallel_apply_running_max, (uint64_t)running, __ATOMIC_RELEASE);
+        }
+        replica_unlock(r->repl_lock);
+    }
+}
+
+void
+replica_get_parallel_apply_stats(Replica *r, uint64_t *ops, uint64_t *running, uint64_t *running_max)
+{
+    *ops = slapi_counter_get_value(r->parallel_apply_ops);
+    *running = slapi_counter_get_value(r->parallel_apply_running);
+    *running_max = slapi_atomic_load_64(&r->parallel_apply_running_max, __ATOMIC_ACQUIRE);
+}
+
 int
 replica_get_agmt_count(Replica *r)
 {
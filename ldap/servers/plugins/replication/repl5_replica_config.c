@@ -368,9 +368,15 @@ replica_config_modify(Slapi_PBlock *pb,
                 } else if (strcasecmp(config_attr, type_replicaKeepAliveUpdateInterval) == 0) {
                     if (apply_mods)
                         replica_set_keepalive_update_interval(r, DEFAULT_REPLICA_KEEPALIVE_UPDATE_INTERVAL);
+                } else if (strcasecmp(config_attr, type_replicaTombstoneReapBatchSize) == 0) {
+                    if (apply_mods)
+                        replica_set_tombstone_reap_batch_size(r, DEFAULT_REPLICA_TOMBSTONE_REAP_BATCH_SIZE);
                 } else if (strcasecmp(config_attr, type_replicaPrecisePurge) == 0) {
                     if (apply_mods)
                         replica_set_precise_purging(r, 0);
+                } else if (strcasecmp(config_attr, type_replicaParallelApply) == 0) {
+                    if (apply_mods)
+                        replica_set_parallel_apply(r, 0);
                 } else if (strcasecmp(config_attr, type_replicaReleaseTimeout) == 0) {
                     if (apply_mods)
                         replica_set_release_timeout(r, 0);
@@ -465,6 +471,15 @@ replica_config_modify(Slapi_PBlock *pb,
                             break;
                         }
                     }
+                } else if (strcasecmp(config_attr, type_replicaTombstoneReapBatchSize) == 0) {
+                    if (apply_mods && config_attr_value[0]) {
+                        int64_t batch_size;
+                        if (repl_config_valid_num(config_attr, config_attr_value, 1, INT_MAX, returncode, errortext, &batch_size) == 0) {
+                            replica_set_tombstone_reap_batch_size(r, batch_size);
+                        } else {
+                            break;
+                        }
+                    }
                 }
                 /* ignore modifiers attributes added by the server */
                 else if (slapi_attr_is_last_mod(config_attr)) {
@@ -540,6 +555,30 @@ replica_config_modify(Slapi_PBlock *pb,
                             replica_set_precise_purging(r, 0);
                         }
                     }
+                } else if (strcasecmp(config_attr, type_replicaParallelApply) == 0) {
+                    if (apply_mods) {
+                        if (config_attr_value[0]) {
+                            uint64_t on_off = 0;
+
+                            if (strcasecmp(config_attr_value, "on") == 0) {
+                                on_off = 1;
+                            } else if (strcasecmp(config_attr_value, "off") == 0) {
+                                on_off = 0;
+                            } else {
+                                /* Invalid value */
+                                *returncode = LDAP_UNWILLING_TO_PERFORM;
+                                PR_snprintf(errortext, SLAPI_DSE_RETURNTEXT_SIZE,
+                                            "Invalid value for %s: %s  Value should be \"on\" or \"off\"\n",
+                                            type_replicaParallelApply, config_attr_value);
+                                slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name,
+                                              "replica_config_modify - %s:\n", errortext);
+                                break;
+                            }
+                            replica_set_parallel_apply(r, on_off);
+                        } else {
+                            replica_set_parallel_apply(r, 0);
+                        }
+                    }
                 } else if (strcasecmp(config_attr, type_replicaReleaseTimeout) == 0) {
                     if (apply_mods) {
                         int64_t val;
@@ -851,6 +890,12 @@ replica_config_search(Slapi_PBlock *pb,
     multisupplier_mtnode_extension *mtnode_ext;
     int changeCount = 0;
     PRBool reapActive = PR_FALSE;
+    uint64_t apply_ops = 0;
+    uint64_t apply_running = 0;
+    uint64_t apply_running_max = 0;
+    uint64_t reap_purged = 0;
+    uint64_t reap_rate = 0;
+    uint64_t reap_backlog = 0;
     char val[64];
 
     /* add attribute that contains number of entries in the changelog for this replica */
@@ -873,6 +918,8 @@ replica_config_search(Slapi_PBlock *pb,
         }
         if (replica) {
             reapActive = replica_get_tombstone_reap_active(replica);
+            replica_get_parallel_apply_stats(replica, &apply_ops, &apply_running, &apply_running_max);
+            replica_get_tombstone_reap_stats(replica, &reap_purged, &reap_rate, &reap_backlog);
         }
         /* Check if the in memory ruv is requested */
         if (search_requested_attr(pb, type_ruvElement)) {
@@ -886,6 +933,15 @@ replica_config_search(Slapi_PBlock *pb,
     sprintf(val, "%d", changeCount);
     slapi_entry_add_string(e, type_replicaChangeCount, val);
     slapi_entry_attr_set_int(e, "nsds5replicaReapActive", (int)reapActive);
+    /* the progress of the current or last tombstone reap */
+    slapi_entry_attr_set_ulong(e, "nsds5replicaReapPurged", reap_purged);
+    slapi_entry_attr_set_ulong(e, "nsds5replicaReapRate", reap_rate);
+    slapi_entry_attr_set_ulong(e, "nsds5replicaReapBacklog", reap_backlog);
+    /* the parallelism achieved applying the replicated updates */
+    slapi_entry_attr_set_ulong(e, "nsds5replicaParallelApplyUpdates", apply_ops);
+    PR_snprintf(val, sizeof(val), "%.2f", apply_ops ? (double)apply_running / (double)apply_ops : 0.0);
+    slapi_entry_add_string(e, "nsds5replicaParallelApplyAverage", val);
+    slapi_entry_attr_set_ulong(e, "nsds5replicaParallelApplyMax", apply_running_max);
 
     PR_Unlock(s_configLock);
 
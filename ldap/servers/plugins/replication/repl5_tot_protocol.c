@@ -22,6 +22,7 @@
 
 #include "repl5.h"
 #include "repl5_prot_private.h"
+#include "../../slapd/back-ldbm/dbimpl.h" /* for dblayer_is_lmdb */
 
 /* Private data structures */
 typedef struct repl5_tot_private
@@ -41,6 +42,7 @@ typedef struct operation_id_list_item
 typedef struct callback_data
 {
     Private_Repl_Protocol *prp;
+    Repl_Connection *conn; /* The connection the entries are sent over */
     int rc;
     unsigned long num_entries;
     uint32_t sleep_on_busy;
@@ -53,6 +55,16 @@ typedef struct callback_data
     int last_message_id_sent;
     int last_message_id_received;
     int flowcontrol_detection;
+    struct berval **batch;           /* Encoded entries not sent yet */
+    int batch_count;
+    ber_len_t batch_bytes;
+    long batch_size;                 /* Entries sent per extended operation */
+    struct callback_data *streams;   /* The additional connections of the update */
+    int num_streams;
+    int next_stream;                 /* Connection of the next batch, 0 is this one */
+    time_t start_time;
+    time_t last_progress;
+    int snapshot;                    /* The batches hold database records rather than entries */
 } callback_data;
 
 /*
@@ -61,9 +73,23 @@ typedef struct callback_data
  */
 #define SLEEP_ON_BUSY_WINDOW (10)
 
+/*
+ * A batch is sent when it holds the configured number of entries, or
+ * this many bytes, to stay below the maximum PDU size of the consumer
+ */
+#define TOTAL_UPDATE_BATCH_MAX_BYTES (512 * 1024)
+
+/* Database records sent per extended operation by a snapshot total update */
+#define TOTAL_UPDATE_SNAPSHOT_BATCH_SIZE (4096)
+
+/* Seconds between two updates of the progress of the total update */
+#define TOTAL_UPDATE_PROGRESS_INTERVAL (10)
+
 /* Helper functions */
 static void get_result(int rc, void *cb_data);
 static int send_entry(Slapi_Entry *e, void *callback_data);
+static int send_record(void *callback_data, back_info_snapshot_record *record);
+static int send_batch(callback_data *cb_data, callback_data *target);
 static void repl5_tot_delete(Private_Repl_Protocol **prp);
 
 #define LOST_CONN_ERR(xx) ((xx == -2) || (xx == LDAP_SERVER_DOWN) || (xx == LDAP_CONNECT_ERROR))
@@ -104,7 +130,7 @@ repl5_tot_result_threadmain(void *param)
 {
     callback_data *cb = (callback_data *)param;
     ConnResult conres = 0;
-    Repl_Connection *conn = cb->prp->conn;
+    Repl_Connection *conn = cb->conn;
     int finished = 0;
     int connection_error = 0;
     char *ldap_error_string = NULL;
@@ -229,8 +255,8 @@ repl5_tot_get_next_result(callback_data *cb_data)
     char *ldap_error_string = NULL;
     int operation_code = 0;
     /* Wait on the next result */
-    conres = conn_read_result(cb_data->prp->conn, &message_id);
-    conn_get_error_ex(cb_data->prp->conn, &operation_code, &connection_error, &ldap_error_string);
+    conres = conn_read_result(cb_data->conn, &message_id);
+    conn_get_error_ex(cb_data->conn, &operation_code, &connection_error, &ldap_error_string);
     if (connection_error) {
         repl5_tot_log_operation_failure(connection_error, ldap_error_string, agmt_get_long_name(cb_data->prp->agmt));
     }
@@ -329,6 +355,224 @@ check_suffix_entryID(Slapi_Backend *be, Slapi_Entry *suffix)
     }
 }
 
+/*
+ * Opens an additional connection to the consumer and joins it, with a
+ * TotalUpdateStreamRequest, to the total update the connection of the
+ * protocol holds the replica for. The consumer imports the entries
+ * sent over it in the same bulk import.
+ */
+static int
+repl5_tot_open_stream(callback_data *cb_data, callback_data *stream, const Slapi_DN *area_sdn)
+{
+    Private_Repl_Protocol *prp = cb_data->prp;
+    struct berval *payload = NULL;
+    struct berval *retdata = NULL;
+    char *retoid = NULL;
+    int message_id = 0;
+    int ret_message_id = 0;
+    int response = -1;
+    ConnResult conres;
+
+    stream->prp = prp;
+    stream->rc = CONN_OPERATION_SUCCESS;
+    stream->conn = conn_new(prp->agmt);
+    if (NULL == stream->conn) {
+        return -1;
+    }
+    pthread_mutex_init(&(stream->lock), NULL);
+    conn_set_timeout(stream->conn, agmt_get_timeout(prp->agmt));
+
+    conres = conn_connect(stream->conn);
+    if (CONN_OPERATION_SUCCESS == conres) {
+        payload = NSDSTotalUpdateStreamRequest_new((char *)slapi_sdn_get_dn(area_sdn));
+        conres = conn_send_extended_operation(stream->conn, REPL_NSDS_TOTAL_UPDATE_STREAM_REQUEST_OID,
+                                              payload, NULL /* update control */, &message_id);
+        ber_bvfree(payload);
+    }
+    if (CONN_OPERATION_SUCCESS == conres) {
+        conres = conn_read_result_ex(stream->conn, &retoid, &retdata, NULL, message_id, &ret_message_id, 1);
+    }
+    if (CONN_OPERATION_SUCCESS == conres) {
+        struct berval **ruv_bervals = NULL;
+        char *data_guid = NULL;
+        struct berval *data = NULL;
+
+        if (decode_repl_ext_response(retdata, &response, &ruv_bervals, &data_guid, &data) != 0) {
+            response = -1;
+        }
+        if (NULL != ruv_bervals) {
+            ber_bvecfree(ruv_bervals);
+        }
+        slapi_ch_free_string(&data_guid);
+        ber_bvfree(data);
+    }
+    if (NULL != retoid) {
+        ldap_memfree(retoid);
+    }
+    if (NULL != retdata) {
+        ber_bvfree(retdata);
+    }
+    if (NSDS50_REPL_REPLICA_READY != response) {
+        slapi_log_err(SLAPI_LOG_WARNING, repl_plugin_name,
+                      "repl5_tot_open_stream - %s: Unable to open a total update stream "
+                      "(connection result %d, response %d)\n",
+                      agmt_get_long_name(prp->agmt), conres, response);
+        goto loser;
+    }
+
+    stream->batch = (struct berval **)slapi_ch_calloc(cb_data->batch_size, sizeof(struct berval *));
+    stream->batch_size = cb_data->batch_size;
+    conn_set_tot_update_cb(stream->conn, (void *)stream);
+    if (repl5_tot_create_async_result_thread(stream)) {
+        conn_set_tot_update_cb(stream->conn, NULL);
+        slapi_ch_free((void **)&stream->batch);
+        goto loser;
+    }
+    return 0;
+
+loser:
+    conn_disconnect(stream->conn);
+    conn_delete(stream->conn);
+    stream->conn = NULL;
+    pthread_mutex_destroy(&(stream->lock));
+    return -1;
+}
+
+/*
+ * Opens up to num_streams additional connections. The update goes on
+ * over the connections that could be opened.
+ */
+static void
+repl5_tot_open_streams(callback_data *cb_data, long num_streams, const Slapi_DN *area_sdn)
+{
+    if (num_streams <= 0) {
+        return;
+    }
+    cb_data->streams = (callback_data *)slapi_ch_calloc(num_streams, sizeof(callback_data));
+    while (cb_data->num_streams < num_streams) {
+        if (repl5_tot_open_stream(cb_data, &cb_data->streams[cb_data->num_streams], area_sdn)) {
+            break;
+        }
+        cb_data->num_streams++;
+    }
+    if (cb_data->num_streams == 0) {
+        slapi_ch_free((void **)&cb_data->streams);
+    }
+}
+
+/*
+ * Waits for the results of the entries sent over the additional
+ * connections and closes them. An error on one of them fails the
+ * update.
+ */
+static void
+repl5_tot_close_streams(callback_data *cb_data)
+{
+    for (int i = 0; i < cb_data->num_streams; i++) {
+        callback_data *stream = &cb_data->streams[i];
+
+        if (cb_data->rc == CONN_OPERATION_SUCCESS) {
+            repl5_tot_waitfor_async_results(stream);
+        }
+        repl5_tot_destroy_async_result_thread(stream);
+        pthread_mutex_lock(&(stream->lock));
+        if (stream->abort && cb_data->rc == CONN_OPERATION_SUCCESS) {
+            cb_data->rc = stream->rc ? stream->rc : -1;
+        }
+        pthread_mutex_unlock(&(stream->lock));
+        cb_data->flowcontrol_detection += stream->flowcontrol_detection;
+
+        conn_set_tot_update_cb(stream->conn, NULL);
+        conn_disconnect(stream->conn);
+        conn_delete(stream->conn);
+        for (int j = 0; j < stream->batch_count; j++) {
+            ber_bvfree(stream->batch[j]);
+        }
+        slapi_ch_free((void **)&stream->batch);
+        pthread_mutex_destroy(&(stream->lock));
+    }
+    slapi_ch_free((void **)&cb_data->streams);
+    cb_data->num_streams = 0;
+}
+
+/* Sends the entries left in the batches of all the connections */
+static int
+repl5_tot_flush_batches(callback_data *cb_data)
+{
+    int rc = send_batch(cb_data, cb_data);
+
+    for (int i = 0; rc == 0 && i < cb_data->num_streams; i++) {
+        rc = send_batch(cb_data, &cb_data->streams[i]);
+    }
+    return rc;
+}
+
+static void
+repl5_tot_report_progress(callback_data *cb_data, time_t now)
+{
+    char status[128];
+    time_t elapsed = now - cb_data->start_time;
+
+    cb_data->last_progress = now;
+    PR_snprintf(status, sizeof(status), "Total update in progress: %lu %s sent, %lu %s/s",
+                cb_data->num_entries, cb_data->snapshot ? "records" : "entries",
+                elapsed > 0 ? cb_data->num_entries / (unsigned long)elapsed : 0UL,
+                cb_data->snapshot ? "records" : "entries");
+    agmt_set_last_init_status(cb_data->prp->agmt, 0, 0, 0, status);
+}
+
+/*
+ * Sends a snapshot of the backend databases. The records are read in a
+ * single read txn, so they are consistent with each other, and sent in
+ * batches over the connection while the txn is open. The RUV tombstone
+ * travels with the records, the consumer replaces its RUV with the one
+ * sent at the start of the session.
+ */
+static void
+repl5_tot_send_snapshot(callback_data *cb_data, Slapi_Backend *be)
+{
+    back_info_snapshot snap = {0};
+    Private_Repl_Protocol *prp = cb_data->prp;
+    int rc;
+
+    cb_data->num_entries = 0UL;
+    cb_data->batch_size = TOTAL_UPDATE_SNAPSHOT_BATCH_SIZE;
+    cb_data->batch = (struct berval **)slapi_ch_calloc(cb_data->batch_size, sizeof(struct berval *));
+    conn_set_tot_update_cb(prp->conn, (void *)cb_data);
+
+    rc = repl5_tot_create_async_result_thread(cb_data);
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "repl5_tot_send_snapshot - %s - "
+                      "repl5_tot_create_async_result_thread failed; error - %d\n",
+                      agmt_get_long_name(prp->agmt), rc);
+        cb_data->rc = -1;
+        return;
+    }
+
+    snap.record_fn = send_record;
+    snap.arg = cb_data;
+    rc = slapi_back_ctrl_info(be, BACK_INFO_SNAPSHOT_READ, &snap);
+    if (rc && cb_data->rc == CONN_OPERATION_SUCCESS) {
+        /* the read failed, not the connection */
+        slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "repl5_tot_send_snapshot - %s - "
+                      "Failed to read the database records; error - %d\n",
+                      agmt_get_long_name(prp->agmt), rc);
+        cb_data->rc = -1;
+    }
+    if (cb_data->rc == CONN_OPERATION_SUCCESS) {
+        repl5_tot_flush_batches(cb_data);
+    }
+    if (cb_data->rc == CONN_OPERATION_SUCCESS) {
+        repl5_tot_waitfor_async_results(cb_data);
+    }
+    rc = repl5_tot_destroy_async_result_thread(cb_data);
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "repl5_tot_send_snapshot - %s - "
+                      "repl5_tot_destroy_async_result_thread failed; error - %d\n",
+                      agmt_get_long_name(prp->agmt), rc);
+    }
+}
+
 /*
  * Completely refresh a replica. The basic protocol interaction goes
  * like this:
@@ -354,6 +598,7 @@ repl5_tot_run(Private_Repl_Protocol *prp)
     ReplicaId rid = 0; /* Used to create the replica keep alive subentry */
     char **instances = NULL;
     Slapi_Backend *be = NULL;
+    int num_connections = 1;
 
     PR_ASSERT(NULL != prp);
 
@@ -371,10 +616,41 @@ repl5_tot_run(Private_Repl_Protocol *prp)
 
     conn_set_timeout(prp->conn, agmt_get_timeout(prp->agmt));
 
+    /* A snapshot of the databases can only be read from lmdb, and the
+     * records hold all the attributes: a fractional agreement, or one that
+     * strips attributes, needs the entries to be filtered by send_entry */
+    if (agmt_get_total_update_snapshot(prp->agmt)) {
+        Slapi_Backend *area_be = slapi_be_select(area_sdn);
+        char **frac_attrs = agmt_get_fractional_attrs_total(prp->agmt);
+        char **strip_attrs = agmt_get_attrs_to_strip(prp->agmt);
+
+        cb_data.snapshot = (area_be && dblayer_is_lmdb(area_be));
+        if (cb_data.snapshot && (agmt_is_fractional(prp->agmt) || frac_attrs ||
+                                 (strip_attrs && strip_attrs[0]))) {
+            slapi_log_err(SLAPI_LOG_INFO, repl_plugin_name, "repl5_tot_run - "
+                          "%s: The agreement is fractional or strips attributes, sending the entries "
+                          "rather than a snapshot.\n",
+                          agmt_get_long_name(prp->agmt));
+            cb_data.snapshot = 0;
+        }
+        slapi_ch_array_free(frac_attrs);
+    }
+
     /* acquire remote replica */
     agmt_set_last_init_start(prp->agmt, slapi_current_utc_time());
 retry:
-    rc = acquire_replica(prp, REPL_NSDS50_TOTAL_PROTOCOL_OID, NULL /* ruv */);
+    rc = acquire_replica(prp, cb_data.snapshot ? REPL_NSDS_SNAPSHOT_TOTAL_PROTOCOL_OID : REPL_NSDS50_TOTAL_PROTOCOL_OID,
+                         NULL /* ruv */);
+    if (rc != ACQUIRE_SUCCESS && cb_data.snapshot &&
+        prp->last_acquire_response_code == NSDS50_REPL_UNKNOWN_UPDATE_PROTOCOL) {
+        /* The consumer does not know the protocol, does not run lmdb,
+         * or cannot take the records: send the entries */
+        slapi_log_err(SLAPI_LOG_INFO, repl_plugin_name, "repl5_tot_run - "
+                      "%s: The consumer cannot be initialized from a snapshot, sending the entries.\n",
+                      agmt_get_long_name(prp->agmt));
+        cb_data.snapshot = 0;
+        goto retry;
+    }
     /* We never retry total protocol, even in case a transient error.
        This is because if somebody already updated the replica we don't
        want to do it again */
@@ -457,6 +733,21 @@ retry:
         goto done;
     }
 
+    cb_data.prp = prp;
+    cb_data.conn = prp->conn;
+    cb_data.rc = 0;
+    cb_data.num_entries = 1UL;
+    cb_data.sleep_on_busy = 0;
+    cb_data.last_busy = slapi_current_rel_time_t();
+    cb_data.flowcontrol_detection = 0;
+    cb_data.start_time = cb_data.last_progress = slapi_current_rel_time_t();
+    pthread_mutex_init(&(cb_data.lock), NULL);
+
+    if (cb_data.snapshot) {
+        repl5_tot_send_snapshot(&cb_data, be);
+        goto sent;
+    }
+
     /*
      * Supporting entries out of order -- parent could have a larger id than its children.
      * Entires are retireved sorted by parentid without the allid threshold.
@@ -473,13 +764,18 @@ retry:
         goto done;
     }
 
-    cb_data.prp = prp;
-    cb_data.rc = 0;
-    cb_data.num_entries = 1UL;
-    cb_data.sleep_on_busy = 0;
-    cb_data.last_busy = slapi_current_rel_time_t();
-    cb_data.flowcontrol_detection = 0;
-    pthread_mutex_init(&(cb_data.lock), NULL);
+    /*
+     * A consumer that supports it takes several entries per extended
+     * operation, and entries over additional connections. The entries
+     * are sent in batches, in turn over each connection.
+     */
+    cb_data.batch_size = 1;
+    if (!prp->repl50consumer &&
+        conn_replica_supports_total_streams(prp->conn) == CONN_SUPPORTS_TOTAL_STREAMS) {
+        cb_data.batch_size = agmt_get_total_update_batch_size(prp->agmt);
+        repl5_tot_open_streams(&cb_data, agmt_get_total_update_streams(prp->agmt) - 1, area_sdn);
+    }
+    cb_data.batch = (struct berval **)slapi_ch_calloc(cb_data.batch_size, sizeof(struct berval *));
 
     /* This allows during perform_operation to check the callback data
      * especially to do flow contol on delta send msgid / recv msgid
@@ -495,6 +791,27 @@ retry:
         goto done;
     }
 
+    /*
+     * An lmdb consumer only imports the entries of a total update once it
+     * got the suffix as first entry, the entries received before it are
+     * dropped. So the suffix goes alone over this connection, and the
+     * stream connections only start sending once it is acknowledged.
+     */
+    if (cb_data.batch_size > 1) {
+        rc = send_batch(&cb_data, &cb_data);
+        if (rc == 0) {
+            rc = repl5_tot_get_next_result(&cb_data);
+            cb_data.last_message_id_received = cb_data.last_message_id_sent;
+        }
+        if (rc) {
+            slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name,
+                          "repl5_tot_run - The consumer did not accept the suffix entry \"%s\" (%d).\n",
+                          slapi_sdn_get_dn(area_sdn), rc);
+            cb_data.rc = rc;
+            goto done;
+        }
+    }
+
     /* we need to provide managedsait control so that referral entries can
      * be replicated */
     ctrls = (LDAPControl **)slapi_ch_calloc(3, sizeof(LDAPControl *));
@@ -538,6 +855,9 @@ retry:
                                       get_result /* result callback */,
                                       send_entry /* entry callback */,
                                       NULL /* referral callback*/);
+    if (cb_data.rc == CONN_OPERATION_SUCCESS) {
+        repl5_tot_flush_batches(&cb_data);
+    }
 
     /*
      * After completing the sending operation (or optionally failing), we need to clean up
@@ -564,6 +884,9 @@ retry:
      * suitable messages will have been logged to the error log about the failure.
      */
 
+sent:
+    num_connections = cb_data.num_streams + 1;
+    repl5_tot_close_streams(&cb_data);
     agmt_set_last_init_end(prp->agmt, slapi_current_utc_time());
     rc = cb_data.rc;
     agmt_set_update_in_progress(prp->agmt, PR_FALSE);
@@ -576,9 +899,22 @@ retry:
                       agmt_get_long_name(prp->agmt), rc);
         agmt_set_last_init_status(prp->agmt, 0, 0, rc, "Total update aborted");
     } else {
-        slapi_log_err(SLAPI_LOG_INFO, repl_plugin_name,
-                      "repl5_tot_run - Finished total update of replica \"%s\". Sent %lu entries.\n",
-                      agmt_get_long_name(prp->agmt), cb_data.num_entries);
+        time_t elapsed = slapi_current_rel_time_t() - cb_data.start_time;
+
+        if (cb_data.snapshot) {
+            slapi_log_err(SLAPI_LOG_INFO, repl_plugin_name,
+                          "repl5_tot_run - Finished total update of replica \"%s\" from a snapshot. "
+                          "Sent %lu database records in %ld seconds (%lu records/s).\n",
+                          agmt_get_long_name(prp->agmt), cb_data.num_entries, (long)elapsed,
+                          elapsed > 0 ? cb_data.num_entries / (unsigned long)elapsed : cb_data.num_entries);
+        } else {
+            slapi_log_err(SLAPI_LOG_INFO, repl_plugin_name,
+                          "repl5_tot_run - Finished total update of replica \"%s\". Sent %lu entries "
+                          "in %ld seconds (%lu entries/s), %ld entries per operation over %d connection(s).\n",
+                          agmt_get_long_name(prp->agmt), cb_data.num_entries, (long)elapsed,
+                          elapsed > 0 ? cb_data.num_entries / (unsigned long)elapsed : cb_data.num_entries,
+                          cb_data.batch_size, num_connections);
+        }
         agmt_set_last_init_status(prp->agmt, 0, 0, 0, "Total update succeeded");
         agmt_set_last_update_status(prp->agmt, 0, 0, NULL);
     }
@@ -597,6 +933,11 @@ done:
                       type_nsds5ReplicaFlowControlWindow);
     }
     conn_set_tot_update_cb(prp->conn, NULL);
+    repl5_tot_close_streams(&cb_data);
+    for (int i = 0; i < cb_data.batch_count; i++) {
+        ber_bvfree(cb_data.batch[i]);
+    }
+    slapi_ch_free((void **)&cb_data.batch);
     pthread_mutex_destroy(&(cb_data.lock));
     prp->stopped = 1;
 }
@@ -759,17 +1100,57 @@ repl5_tot_flowcontrol_detection(Repl_Connection *conn, int increment)
     }
 }
 
+/* Number of entries sent per operation on the connection
+ * Call must hold the connection lock
+ */
+long
+repl5_tot_batch_size(Repl_Connection *conn)
+{
+    struct callback_data *cb_data;
+
+    conn_get_tot_update_cb_nolock(conn, (void **)&cb_data);
+    if (cb_data == NULL || cb_data->batch_size < 1) {
+        return 1;
+    }
+    return cb_data->batch_size;
+}
+
+/* Returns true if the result reader thread of a connection encountered a fatal error */
+static int
+repl5_tot_aborted(callback_data *cb_data)
+{
+    int rc;
+
+    pthread_mutex_lock(&(cb_data->lock));
+    rc = cb_data->abort;
+    pthread_mutex_unlock(&(cb_data->lock));
+    for (int i = 0; !rc && i < cb_data->num_streams; i++) {
+        pthread_mutex_lock(&(cb_data->streams[i].lock));
+        rc = cb_data->streams[i].abort;
+        pthread_mutex_unlock(&(cb_data->streams[i].lock));
+    }
+    return rc;
+}
+
+static void
+repl5_tot_disconnect(callback_data *cb_data)
+{
+    conn_disconnect(cb_data->conn);
+    for (int i = 0; i < cb_data->num_streams; i++) {
+        conn_disconnect(cb_data->streams[i].conn);
+    }
+}
+
 static int
 send_entry(Slapi_Entry *e, void *cb_data)
 {
     int rc;
     Private_Repl_Protocol *prp;
+    callback_data *target;
     BerElement *bere;
     struct berval *bv;
     unsigned long *num_entriesp;
-    uint32_t *sleep_on_busyp;
-    time_t *last_busyp;
-    int message_id = 0;
+    time_t now;
     int retval = 0;
     char **frac_excluded_attrs = NULL;
 
@@ -777,23 +1158,18 @@ send_entry(Slapi_Entry *e, void *cb_data)
 
     prp = ((callback_data *)cb_data)->prp;
     num_entriesp = &((callback_data *)cb_data)->num_entries;
-    sleep_on_busyp = &((callback_data *)cb_data)->sleep_on_busy;
-    last_busyp = &((callback_data *)cb_data)->last_busy;
     PR_ASSERT(prp);
 
     if (prp->terminate) {
-        conn_disconnect(prp->conn);
+        repl5_tot_disconnect((callback_data *)cb_data);
         ((callback_data *)cb_data)->rc = -1;
         return -1;
     }
 
-    /* see if the result reader thread encountered
+    /* see if a result reader thread encountered
        a fatal error */
-    pthread_mutex_lock((&((callback_data *)cb_data)->lock));
-    rc = ((callback_data *)cb_data)->abort;
-    pthread_mutex_unlock((&((callback_data *)cb_data)->lock));
-    if (rc) {
-        conn_disconnect(prp->conn);
+    if (repl5_tot_aborted((callback_data *)cb_data)) {
+        repl5_tot_disconnect((callback_data *)cb_data);
         ((callback_data *)cb_data)->rc = -1;
         return -1;
     }
@@ -834,13 +1210,142 @@ send_entry(Slapi_Entry *e, void *cb_data)
         goto error;
     }
 
+    /* add the entry to the batch of the connection it goes over */
+    target = ((callback_data *)cb_data)->next_stream ?
+                 &((callback_data *)cb_data)->streams[((callback_data *)cb_data)->next_stream - 1] :
+                 (callback_data *)cb_data;
+    target->batch[target->batch_count++] = bv;
+    target->batch_bytes += bv->bv_len;
+    (*num_entriesp)++;
+    if (target->batch_count < ((callback_data *)cb_data)->batch_size &&
+        target->batch_bytes < TOTAL_UPDATE_BATCH_MAX_BYTES) {
+        return 0;
+    }
+
+    /* the batch is full, the next one goes over the next connection */
+    ((callback_data *)cb_data)->next_stream = (((callback_data *)cb_data)->next_stream + 1) %
+                                              (((callback_data *)cb_data)->num_streams + 1);
+    retval = send_batch((callback_data *)cb_data, target);
+
+    now = slapi_current_rel_time_t();
+    if (now - ((callback_data *)cb_data)->last_progress >= TOTAL_UPDATE_PROGRESS_INTERVAL) {
+        repl5_tot_report_progress((callback_data *)cb_data, now);
+    }
+error:
+    return retval;
+}
+
+/*
+ * Adds a database record of a snapshot to the batch, and sends the batch
+ * once full. A non-0 return stops the read of the records.
+ */
+static int
+send_record(void *cb_data, back_info_snapshot_record *record)
+{
+    callback_data *cb = (callback_data *)cb_data;
+    BerElement *bere = NULL;
+    struct berval *bv = NULL;
+    time_t now;
+    int retval = 0;
+
+    if (cb->prp->terminate || repl5_tot_aborted(cb)) {
+        repl5_tot_disconnect(cb);
+        cb->rc = -1;
+        return -1;
+    }
+
+    bere = der_alloc();
+    if (bere == NULL ||
+        ber_printf(bere, "{sOO}", record->dbname, &record->key, &record->data) == -1 ||
+        ber_flatten(bere, &bv) != 0) {
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name, "%s: send_record: Encoding Error\n",
+                      agmt_get_long_name(cb->prp->agmt));
+        if (bere) {
+            ber_free(bere, 1);
+        }
+        cb->rc = -1;
+        return -1;
+    }
+    ber_free(bere, 1);
+
+    cb->batch[cb->batch_count++] = bv;
+    cb->batch_bytes += bv->bv_len;
+    cb->num_entries++;
+    if (cb->batch_count < cb->batch_size && cb->batch_bytes < TOTAL_UPDATE_BATCH_MAX_BYTES) {
+        return 0;
+    }
+    retval = send_batch(cb, cb);
+
+    now = slapi_current_rel_time_t();
+    if (now - cb->last_progress >= TOTAL_UPDATE_PROGRESS_INTERVAL) {
+        repl5_tot_report_progress(cb, now);
+    }
+    return retval;
+}
+
+/*
+ * Sends the entries batched for a connection: the entry in an
+ * NSDS50ReplicationEntry extended operation if batching is off, the
+ * whole batch in an NSDSReplicationEntries one otherwise. The database
+ * records of a snapshot go in an NSDSReplicationDbRecords one.
+ */
+static int
+send_batch(callback_data *cb_data, callback_data *target)
+{
+    int rc;
+    Private_Repl_Protocol *prp = cb_data->prp;
+    struct berval *bv = NULL;
+    const char *extop_oid;
+    uint32_t *sleep_on_busyp = &cb_data->sleep_on_busy;
+    time_t *last_busyp = &cb_data->last_busy;
+    int message_id = 0;
+    int retval = 0;
+
+    if (target->batch_count == 0) {
+        return 0;
+    }
+
+    if (cb_data->batch_size > 1) {
+        BerElement *bere = der_alloc();
+
+        extop_oid = cb_data->snapshot ? REPL_NSDS_REPLICATION_DB_RECORDS_REQUEST_OID :
+                                        REPL_NSDS_REPLICATION_ENTRIES_REQUEST_OID;
+        rc = (bere == NULL) || (ber_printf(bere, "{") == -1);
+        for (int i = 0; !rc && i < target->batch_count; i++) {
+            rc = (ber_printf(bere, "O", target->batch[i]) == -1);
+        }
+        if (!rc && (ber_printf(bere, "}") == -1 || ber_flatten(bere, &bv) != 0)) {
+            rc = 1;
+        }
+        if (bere) {
+            ber_free(bere, 1);
+        }
+        for (int i = 0; i < target->batch_count; i++) {
+            ber_bvfree(target->batch[i]);
+            target->batch[i] = NULL;
+        }
+    } else {
+        extop_oid = REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID;
+        bv = target->batch[0];
+        target->batch[0] = NULL;
+        rc = 0;
+    }
+    target->batch_count = 0;
+    target->batch_bytes = 0;
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name, "%s: send_batch: Encoding Error\n",
+                      agmt_get_long_name(prp->agmt));
+        cb_data->rc = -1;
+        return -1;
+    }
+
     do {
-        /* push the entry to the consumer */
-        rc = conn_send_extended_operation(prp->conn, REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID,
+        /* push the entries to the consumer */
+        rc = conn_send_extended_operation(target->conn, extop_oid,
                                           bv /* payload */, NULL /* update_control */, &message_id);
 
         if (message_id) {
-            ((callback_data *)cb_data)->last_message_id_sent = message_id;
+            target->last_message_id_sent = message_id;
         }
 
         /* If we are talking to a 5.0 type consumer, we need to wait here and retrieve the
@@ -850,7 +1355,7 @@ send_entry(Slapi_Entry *e, void *cb_data)
 
         if (prp->repl50consumer) {
             /* Get the response here */
-            rc = repl5_tot_get_next_result((callback_data *)cb_data);
+            rc = repl5_tot_get_next_result(target);
         }
 
         if (rc == CONN_BUSY) {
@@ -871,23 +1376,21 @@ send_entry(Slapi_Entry *e, void *cb_data)
     } while (rc == CONN_BUSY);
 
     ber_bvfree(bv);
-    (*num_entriesp)++;
 
     /* if the connection has been closed, we need to stop
        sending entries and set a special rc value to let
        the result reading thread know the connection has been
        closed - do not attempt to read any more results */
     if (CONN_NOT_CONNECTED == rc) {
-        ((callback_data *)cb_data)->rc = -2;
+        cb_data->rc = -2;
         retval = -1;
     } else {
-        ((callback_data *)cb_data)->rc = rc;
+        cb_data->rc = rc;
         if (CONN_OPERATION_SUCCESS == rc) {
             retval = 0;
         } else {
             retval = -1;
         }
     }
-error:
     return retval;
 }
@@ -616,40 +616,31 @@ loser:
 }
 
 /*
- * Extract the payload from a total update extended operation,
- * decode it, and produce a Slapi_Entry structure representing a new
- * entry to be added to the local database.
+ * Decode the encoding of an entry sent by a total update, and produce
+ * a Slapi_Entry structure representing a new entry to be added to the
+ * local database.
  */
 static int
-decode_total_update_extop(Slapi_PBlock *pb, Slapi_Entry **ep)
+decode_total_update_entry(struct berval *entry_value, Slapi_Entry **ep)
 {
     BerElement *tmp_bere = NULL;
     Slapi_Entry *e = NULL;
     Slapi_Attr *attr = NULL;
     char *str = NULL;
-    struct berval *extop_value = NULL;
-    char *extop_oid = NULL;
     ber_len_t len;
     char *lasto;
     ber_tag_t tag;
     int rc;
     PRBool deleted;
 
-    PR_ASSERT(NULL != pb);
     PR_ASSERT(NULL != ep);
 
-    slapi_pblock_get(pb, SLAPI_EXT_OP_REQ_OID, &extop_oid);
-    slapi_pblock_get(pb, SLAPI_EXT_OP_REQ_VALUE, &extop_value);
-
-    if ((NULL == extop_oid) ||
-        ((strcmp(extop_oid, REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID) != 0) &&
-         (strcmp(extop_oid, REPL_NSDS71_REPLICATION_ENTRY_REQUEST_OID) != 0)) ||
-        !BV_HAS_DATA(extop_value)) {
+    if (!BV_HAS_DATA(entry_value)) {
         /* Bogus */
         goto loser;
     }
 
-    if ((tmp_bere = ber_init(extop_value)) == NULL) {
+    if ((tmp_bere = ber_init(entry_value)) == NULL) {
         goto loser;
     }
 
@@ -733,7 +724,7 @@ loser:
         slapi_entry_free(e);
     }
     *ep = NULL;
-    slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "decode_total_update_extop - Could not decode extended "
+    slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name, "decode_total_update_entry - Could not decode extended "
                                                    "operation containing entry for total update.\n");
 
 free_and_return:
@@ -744,51 +735,175 @@ free_and_return:
     return rc;
 }
 
+/*
+ * Extract the payload from a total update extended operation, and
+ * decode the entries it carries: the single entry of an
+ * NSDS50ReplicationEntry, or the batch of an NSDSReplicationEntries.
+ * The decoded entries are returned in a NULL terminated array the
+ * caller frees, with the entries it did not consume.
+ */
+static int
+decode_total_update_extop(Slapi_PBlock *pb, Slapi_Entry ***entries)
+{
+    BerElement *tmp_bere = NULL;
+    Slapi_Entry *e = NULL;
+    struct berval *extop_value = NULL;
+    struct berval entry_value = {0};
+    char *extop_oid = NULL;
+    ber_len_t len;
+    char *last;
+    ber_tag_t tag;
+    size_t count = 0;
+    size_t max = 0;
+    int rc = 0;
+
+    PR_ASSERT(NULL != pb);
+    PR_ASSERT(NULL != entries);
+
+    *entries = NULL;
+    slapi_pblock_get(pb, SLAPI_EXT_OP_REQ_OID, &extop_oid);
+    slapi_pblock_get(pb, SLAPI_EXT_OP_REQ_VALUE, &extop_value);
+
+    if (NULL == extop_oid) {
+        return -1;
+    }
+    if ((strcmp(extop_oid, REPL_NSDS50_REPLICATION_ENTRY_REQUEST_OID) == 0) ||
+        (strcmp(extop_oid, REPL_NSDS71_REPLICATION_ENTRY_REQUEST_OID) == 0)) {
+        if (decode_total_update_entry(extop_value, &e) != 0) {
+            return -1;
+        }
+        *entries = (Slapi_Entry **)slapi_ch_calloc(2, sizeof(Slapi_Entry *));
+        (*entries)[0] = e;
+        return 0;
+    }
+    if ((strcmp(extop_oid, REPL_NSDS_REPLICATION_ENTRIES_REQUEST_OID) != 0) ||
+        !BV_HAS_DATA(extop_value) ||
+        (tmp_bere = ber_init(extop_value)) == NULL) {
+        /* Bogus */
+        return -1;
+    }
+
+    /* The batch is a sequence of the encodings of its entries */
+    for (tag = ber_first_element(tmp_bere, &len, &last);
+         tag != LBER_ERROR && tag != LBER_END_OF_SEQORSET;
+         tag = ber_next_element(tmp_bere, &len, last)) {
+        if (ber_scanf(tmp_bere, "o", &entry_value) == LBER_ERROR) {
+            rc = -1;
+            break;
+        }
+        rc = decode_total_update_entry(&entry_value, &e);
+        slapi_ch_free((void **)&entry_value.bv_val);
+        if (rc != 0) {
+            break;
+        }
+        if (count + 1 >= max) {
+            max = max ? 2 * max : 64;
+            *entries = (Slapi_Entry **)slapi_ch_realloc((char *)*entries, max * sizeof(Slapi_Entry *));
+        }
+        (*entries)[count++] = e;
+        (*entries)[count] = NULL;
+    }
+    if (tag == LBER_ERROR) {
+        rc = -1;
+    }
+    ber_free(tmp_bere, 1);
+
+    return rc;
+}
+
+/* Frees the entries array, and the entries from the first the import did not consume */
+static void
+total_update_entries_free(Slapi_Entry ***entries, size_t imported)
+{
+    if (*entries) {
+        for (size_t i = imported; (*entries)[i]; i++) {
+            slapi_entry_free((*entries)[i]);
+        }
+        slapi_ch_free((void **)entries);
+    }
+}
+
 /*
  * This plugin entry point is called whenever an NSDS50ReplicationEntry
- * extended operation is received.
+ * or an NSDSReplicationEntries extended operation is received.
+ *
+ * The entries are imported in order by the bulk import of the
+ * connection. On a connection that joined a total update as a stream,
+ * they are imported by the bulk import of the connection that holds
+ * the replica.
  */
 int
 multisupplier_extop_NSDS50ReplicationEntry(Slapi_PBlock *pb)
 {
     int rc;
-    Slapi_Entry *e = NULL;
+    Slapi_Entry **entries = NULL;
     Slapi_Connection *conn = NULL;
+    Slapi_Connection *total_conn = NULL;
+    consumer_connection_extension *connext = NULL;
+    Slapi_PBlock *import_pb = pb;
+    size_t imported = 0;
     PRUint64 connid = 0;
     int opid = 0;
 
     slapi_pblock_get(pb, SLAPI_CONN_ID, &connid);
     slapi_pblock_get(pb, SLAPI_OPERATION_ID, &opid);
+    slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
 
     /* Decode the extended operation */
-    rc = decode_total_update_extop(pb, &e);
+    rc = decode_total_update_extop(pb, &entries);
 
     if (0 == rc) {
+        if (conn) {
+            connext = (consumer_connection_extension *)repl_con_get_ext(REPL_CON_EXT_CONN, conn);
+        }
+        if (connext && connext->stream_replica) {
+            total_conn = replica_total_update_stream_enter(connext->stream_replica);
+            if (NULL == total_conn) {
+                slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                              "multisupplier_extop_NSDS50ReplicationEntry - "
+                              "The total update is over for the stream conn=%" PRIu64 " op=%d\n",
+                              connid, opid);
+                rc = -1;
+            } else {
+                import_pb = slapi_pblock_new();
+                slapi_pblock_set(import_pb, SLAPI_CONNECTION, total_conn);
+            }
+        }
+
+        for (size_t i = 0; rc == 0 && entries && entries[i]; i++) {
 #ifdef notdef
-        /*
-         * Just spew LDIF so we're sure we got it right. Later we'll firehose
-         * this into the database import code
-         */
-        int len;
-        char *str = slapi_entry2str_with_options(e, &len, SLAPI_DUMP_UNIQUEID);
-        puts(str);
-        free(str);
+            /*
+             * Just spew LDIF so we're sure we got it right. Later we'll firehose
+             * this into the database import code
+             */
+            int len;
+            char *str = slapi_entry2str_with_options(entries[i], &len, SLAPI_DUMP_UNIQUEID);
+            puts(str);
+            free(str);
 #endif
 
-        rc = slapi_import_entry(pb, e);
-        /* slapi_import_entry returns an LDAP error in case of a
-        * problem.  If there's a problem, it's our responsibility
-        * to free the slapi_entry that we're trying to import.
-        */
-        if (rc != LDAP_SUCCESS) {
-            const char *dn = slapi_entry_get_dn_const(e);
-            slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
-                          "multisupplier_extop_NSDS50ReplicationEntry - "
-                          "Error %d: could not import entry dn %s for total update operation conn=%" PRIu64 " op=%d\n",
-                          rc, dn, connid, opid);
-            rc = -1;
+            rc = slapi_import_entry(import_pb, entries[i]);
+            /* slapi_import_entry returns an LDAP error in case of a
+            * problem.  If there's a problem, it's our responsibility
+            * to free the slapi_entry that we're trying to import.
+            */
+            if (rc != LDAP_SUCCESS) {
+                const char *dn = slapi_entry_get_dn_const(entries[i]);
+                slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                              "multisupplier_extop_NSDS50ReplicationEntry - "
+                              "Error %d: could not import entry dn %s for total update operation conn=%" PRIu64 " op=%d\n",
+                              rc, dn, connid, opid);
+                rc = -1;
+            } else {
+                /* the import consumed the entry */
+                imported++;
+            }
         }
 
+        if (total_conn) {
+            slapi_pblock_destroy(import_pb);
+            replica_total_update_stream_exit(connext->stream_replica, total_conn);
+        }
     } else {
         slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
                       "multisupplier_extop_NSDS50ReplicationEntry - "
@@ -800,16 +915,143 @@ multisupplier_extop_NSDS50ReplicationEntry(Slapi_PBlock *pb)
     if (LDAP_SUCCESS != rc) {
         /* just disconnect from the supplier. bulk import is stopped when
            connection object is destroyed */
-        slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
         if (conn) {
             slapi_disconnect_server(conn);
         }
+    }
+    /* cleanup */
+    total_update_entries_free(&entries, imported);
+
+    return rc;
+}
+
+static void
+total_update_records_free(back_info_snapshot *snap)
+{
+    for (size_t i = 0; i < snap->nrecords; i++) {
+        slapi_ch_free((void **)&snap->records[i].dbname);
+        slapi_ch_free((void **)&snap->records[i].key.bv_val);
+        slapi_ch_free((void **)&snap->records[i].data.bv_val);
+    }
+    slapi_ch_free((void **)&snap->records);
+    snap->nrecords = 0;
+}
+
+/*
+ * The requestValue of the NSDSReplicationDbRecords looks like this:
+ *
+ *     requestValue ::= SEQUENCE OF SEQUENCE {
+ *         dbname OCTET STRING,
+ *         key OCTET STRING,
+ *         data OCTET STRING
+ *     }
+ *
+ * The records are decoded in an array the caller frees with
+ * total_update_records_free. On a decoding error they are freed here.
+ */
+static int
+decode_total_update_records(struct berval *extop_value, back_info_snapshot *snap)
+{
+    BerElement *tmp_bere = NULL;
+    ber_len_t len;
+    char *last;
+    ber_tag_t tag;
+    size_t max = 0;
+    int rc = 0;
+
+    if (!BV_HAS_DATA(extop_value) || (tmp_bere = ber_init(extop_value)) == NULL) {
+        return -1;
+    }
+    for (tag = ber_first_element(tmp_bere, &len, &last);
+         tag != LBER_ERROR && tag != LBER_END_OF_SEQORSET;
+         tag = ber_next_element(tmp_bere, &len, last)) {
+        back_info_snapshot_record *record;
 
-        /* cleanup */
-        if (e) {
-            slapi_entry_free(e);
+        if (snap->nrecords >= max) {
+            max = max ? 2 * max : 256;
+            snap->records = (back_info_snapshot_record *)slapi_ch_realloc((char *)snap->records,
+                                                                          max * sizeof(back_info_snapshot_record));
+        }
+        record = &snap->records[snap->nrecords];
+        memset(record, 0, sizeof(*record));
+        /* the record is counted first, so the fields ber_scanf may have
+         * allocated before failing are freed with the others */
+        snap->nrecords++;
+        if (ber_scanf(tmp_bere, "{aoo}", (char **)&record->dbname, &record->key, &record->data) == LBER_ERROR) {
+            rc = -1;
+            break;
+        }
+    }
+    if (tag == LBER_ERROR) {
+        rc = -1;
+    }
+    ber_free(tmp_bere, 1);
+    if (rc) {
+        total_update_records_free(snap);
+    }
+    return rc;
+}
+
+/*
+ * This plugin entry point is called whenever an NSDSReplicationDbRecords
+ * extended operation is received, during a total update the supplier
+ * started with the snapshot protocol. The records are written as they are
+ * in the backend databases of the replica.
+ */
+int
+multisupplier_extop_NSDSReplicationDbRecords(Slapi_PBlock *pb)
+{
+    back_info_snapshot snap = {0};
+    struct berval *extop_value = NULL;
+    Slapi_Connection *conn = NULL;
+    consumer_connection_extension *connext = NULL;
+    Slapi_Backend *be = NULL;
+    PRUint64 connid = 0;
+    int opid = 0;
+    int rc = -1;
+
+    slapi_pblock_get(pb, SLAPI_CONN_ID, &connid);
+    slapi_pblock_get(pb, SLAPI_OPERATION_ID, &opid);
+    slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
+    slapi_pblock_get(pb, SLAPI_EXT_OP_REQ_VALUE, &extop_value);
+
+    if (conn) {
+        connext = (consumer_connection_extension *)repl_con_get_ext(REPL_CON_EXT_CONN, conn);
+    }
+    if (NULL == connext || NULL == connext->replica_acquired || !connext->snapshot) {
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                      "multisupplier_extop_NSDSReplicationDbRecords - "
+                      "No snapshot total update in progress conn=%" PRIu64 " op=%d\n",
+                      connid, opid);
+    } else if (decode_total_update_records(extop_value, &snap) != 0) {
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                      "multisupplier_extop_NSDSReplicationDbRecords - "
+                      "Could not decode the database records conn=%" PRIu64 " op=%d\n",
+                      connid, opid);
+    } else if ((be = slapi_be_select(replica_get_root(connext->replica_acquired))) == NULL) {
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                      "multisupplier_extop_NSDSReplicationDbRecords - "
+                      "No backend for the replica conn=%" PRIu64 " op=%d\n",
+                      connid, opid);
+    } else {
+        rc = slapi_back_ctrl_info(be, BACK_INFO_SNAPSHOT_WRITE, &snap);
+        if (rc) {
+            slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                          "multisupplier_extop_NSDSReplicationDbRecords - "
+                          "Error %d: could not write %lu database records conn=%" PRIu64 " op=%d\n",
+                          rc, (unsigned long)snap.nrecords, connid, opid);
+        }
+    }
+
+    if (LDAP_SUCCESS != rc) {
+        /* just disconnect from the supplier, the snapshot is aborted
+           when connection object is destroyed */
+        if (conn) {
+            slapi_disconnect_server(conn);
         }
+        rc = -1;
     }
+    total_update_records_free(&snap);
 
     return rc;
 }
@@ -38,6 +38,8 @@ consumer_connection_extension_constructor(void *object __attribute__((unused)),
         ext->supplier_ruv = NULL;
         ext->connection = NULL;
         ext->in_use_opid = -1;
+        ext->stream_replica = NULL;
+        ext->snapshot = 0;
         ext->lock = PR_NewLock();
         if (NULL == ext->lock) {
             slapi_log_err(SLAPI_LOG_PLUGIN, repl_plugin_name, "consumer_connection_extension_constructor - "
@@ -77,7 +79,20 @@ consumer_connection_extension_destructor(void *ext, void *object __attribute__((
                                   "Aborting total update in progress for replicated "
                                   "area %s connid=%" PRIu64 "\n",
                                   slapi_sdn_get_dn(repl_root_sdn), connid);
-                    slapi_stop_bulk_import(pb);
+                    if (connext->snapshot) {
+                        back_info_snapshot snap = {0};
+                        Slapi_Backend *be = slapi_be_select(repl_root_sdn);
+
+                        /* the records written so far are discarded */
+                        snap.abort = 1;
+                        if (be) {
+                            slapi_back_ctrl_info(be, BACK_INFO_SNAPSHOT_DONE, &snap);
+                        }
+                    } else {
+                        /* the streams import through this connection */
+                        replica_total_update_streams_close(r);
+                        slapi_stop_bulk_import(pb);
+                    }
                 } else {
                     slapi_log_err(SLAPI_LOG_ERR, repl_plugin_name,
                                   "consumer_connection_extension_destructor - Can't determine root "
@@ -103,6 +118,7 @@ consumer_connection_extension_destructor(void *ext, void *object __attribute__((
 
         connext->in_use_opid = -1;
 
+        connext->stream_replica = NULL;
         connext->connection = NULL;
         slapi_ch_free((void **)&ext);
     }
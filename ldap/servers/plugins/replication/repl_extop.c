@@ -16,6 +16,7 @@
 #include "repl5.h"
 #include "repl5_prot_private.h"
 #include "cl5_api.h"
+#include "../../slapd/back-ldbm/dbimpl.h" /* for dblayer_is_lmdb */
 #define ENABLE_TEST_TICKET_374
 #ifdef ENABLE_TEST_TICKET_374
 #include <unistd.h> /* for usleep */
@@ -306,6 +307,12 @@ NSDS50EndReplicationRequest_new(char *repl_root)
     return (create_ReplicationExtopPayload(NULL, repl_root, NULL, NULL, 1, 0, 0));
 }
 
+struct berval *
+NSDSTotalUpdateStreamRequest_new(char *repl_root)
+{
+    return (create_ReplicationExtopPayload(NULL, repl_root, NULL, NULL, 1, 0, 0));
+}
+
 static int
 decode_ruv(BerElement *ber, RUV **ruv)
 {
@@ -501,11 +508,12 @@ free_and_return:
 
 /*
  * Decode an NSDS50 End Replication Request extended
- * operation. Returns 0 on success, -1 on decoding error.
+ * operation, or a Total Update Stream Request which has
+ * the same payload. Returns 0 on success, -1 on decoding error.
  * The caller is responsible for freeing repl_root.
  */
 static int
-decode_endrepl_extop(Slapi_PBlock *pb, char **repl_root)
+decode_endrepl_extop(Slapi_PBlock *pb, const char *oid, char **repl_root)
 {
     char *extop_oid = NULL;
     struct berval *extop_value = NULL;
@@ -516,14 +524,14 @@ decode_endrepl_extop(Slapi_PBlock *pb, char **repl_root)
     slapi_pblock_get(pb, SLAPI_EXT_OP_REQ_VALUE, &extop_value);
 
     if ((NULL == extop_oid) ||
-        (strcmp(extop_oid, REPL_END_NSDS50_REPLICATION_REQUEST_OID) != 0) ||
+        (strcmp(extop_oid, oid) != 0) ||
         !BV_HAS_DATA(extop_value))
     {
         /* bogus */
         slapi_log_err(SLAPI_LOG_ERR, "decode_endrepl_extop",
                 "decoding failed: extop_oid (%s) correct oid (%s) extop_value data (%s)\n",
                 extop_oid ? extop_oid : "NULL",
-                extop_oid ? strcmp(extop_oid, REPL_END_NSDS50_REPLICATION_REQUEST_OID) != 0 ? "wrong oid" : "correct oid" : "NULL",
+                extop_oid ? strcmp(extop_oid, oid) != 0 ? "wrong oid" : "correct oid" : "NULL",
                 !BV_HAS_DATA(extop_value) ? "No data" : "Has data");
         rc = -1;
         goto free_and_return;
@@ -693,7 +701,9 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
     char locking_session[42] = {0};
     char *data_guid = NULL;
     struct berval *data = NULL;
+    char *snap_fingerprint = NULL;
     int is90 = 0;
+    Slapi_Backend *be = NULL;
 
     /* Decode the extended operation */
     if (decode_startrepl_extop(pb, &protocol_oid, &repl_root, &supplier_ruv,
@@ -765,6 +775,7 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
         /* Stash info that this is a total update session */
         if (NULL != connext) {
             connext->repl_protocol_version = REPL_PROTOCOL_50_TOTALUPDATE;
+            connext->snapshot = 0;
         }
         slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
                       "multisupplier_extop_StartNSDS50ReplicationRequest - "
@@ -783,12 +794,36 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
         /* Stash info that this is a total update session */
         if (NULL != connext) {
             connext->repl_protocol_version = REPL_PROTOCOL_50_TOTALUPDATE;
+            connext->snapshot = 0;
         }
         slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
                       "multisupplier_extop_StartNSDS50ReplicationRequest - "
                       "conn=%" PRIu64 " op=%d repl=\"%s\": Begin 7.1 total protocol\n",
                       connid, opid, repl_root);
         isInc = PR_FALSE;
+    } else if (strcmp(protocol_oid, REPL_NSDS_SNAPSHOT_TOTAL_PROTOCOL_OID) == 0) {
+        /* Keep the fingerprint of the supplier index configuration, the
+         * backend refuses the records if it differs from its own */
+        if (data_guid && data && data->bv_val &&
+            strcmp(data_guid, REPL_NSDS_SNAPSHOT_FINGERPRINT_GUID) == 0) {
+            snap_fingerprint = (char *)slapi_ch_malloc(data->bv_len + 1);
+            memcpy(snap_fingerprint, data->bv_val, data->bv_len);
+            snap_fingerprint[data->bv_len] = '\0';
+        }
+        slapi_ch_free_string(&data_guid);
+        ber_bvfree(data);
+        data = NULL;
+
+        /* Stash info that this is a total update session from a database snapshot */
+        if (NULL != connext) {
+            connext->repl_protocol_version = REPL_PROTOCOL_50_TOTALUPDATE;
+            connext->snapshot = 1;
+        }
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                      "multisupplier_extop_StartNSDS50ReplicationRequest - "
+                      "conn=%" PRIu64 " op=%d repl=\"%s\": Begin snapshot total protocol\n",
+                      connid, opid, repl_root);
+        isInc = PR_FALSE;
     } else {
         /* Unknown replication protocol */
         response = NSDS50_REPL_UNKNOWN_UPDATE_PROTOCOL;
@@ -969,8 +1004,21 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
     }
     /* total update protocol */
     else if (connext->repl_protocol_version == REPL_PROTOCOL_50_TOTALUPDATE) {
-        char *mtnstate = slapi_mtn_get_state(repl_root_sdn);
-        char **mtnreferral = slapi_mtn_get_referral(repl_root_sdn);
+        char *mtnstate = NULL;
+        char **mtnreferral = NULL;
+        back_info_snapshot snap = {0};
+
+        /* The database records can only be written in a lmdb backend,
+         * the supplier falls back to the entries */
+        if (connext->snapshot) {
+            be = slapi_be_select(repl_root_sdn);
+            if (NULL == be || !dblayer_is_lmdb(be)) {
+                response = NSDS50_REPL_UNKNOWN_UPDATE_PROTOCOL;
+                goto send_response;
+            }
+        }
+        mtnstate = slapi_mtn_get_state(repl_root_sdn);
+        mtnreferral = slapi_mtn_get_referral(repl_root_sdn);
 
         /* richm 20041118 - we do not want to reap tombstones while there is
            a total update in progress, so shut it down */
@@ -988,11 +1036,19 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
         /* LPREPL - check the return code.
          * But what do we do if mapping tree could not be updated ? */
 
-        /* start the bulk import */
+        /* start the bulk import, or empty the backend for the records */
         slapi_pblock_set(pb, SLAPI_TARGET_SDN, repl_root_sdn);
-        rc = slapi_start_bulk_import(pb);
+        if (connext->snapshot) {
+            snap.fingerprint = snap_fingerprint;
+            rc = slapi_back_ctrl_info(be, BACK_INFO_SNAPSHOT_START, &snap);
+        } else {
+            rc = slapi_start_bulk_import(pb);
+        }
         if (rc != LDAP_SUCCESS) {
-            response = NSDS50_REPL_INTERNAL_ERROR;
+            /* a backend that cannot take the records (i.e: encrypted
+             * attributes, other indexes) may still be initialized with
+             * the entries */
+            response = connext->snapshot ? NSDS50_REPL_UNKNOWN_UPDATE_PROTOCOL : NSDS50_REPL_INTERNAL_ERROR;
             /* reset the mapping tree state to what it was before
                we tried to do the bulk import if mtnstate exists */
             if (mtnstate) {
@@ -1008,6 +1064,16 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
         slapi_ch_free_string(&mtnstate);
         charray_free(mtnreferral);
         mtnreferral = NULL;
+
+        /* lmdb bulk import queues the entries from any thread and accepts
+         * children ahead of their parent, so the supplier may stream the
+         * entries over other connections */
+        if (!connext->snapshot) {
+            slapi_pblock_get(pb, SLAPI_BACKEND, &be);
+            if (be && dblayer_is_lmdb(be)) {
+                replica_total_update_streams_open(replica, (Slapi_Connection *)conn);
+            }
+        }
     }
     /* something unexpected at this point, like REPL_PROTOCOL_UNKNOWN */
     else {
@@ -1036,6 +1102,9 @@ multisupplier_extop_StartNSDS50ReplicationRequest(Slapi_PBlock *pb)
     connext->isreplicationsession = 1;
     /* Save away the connection */
     slapi_pblock_get(pb, SLAPI_CONNECTION, &connext->connection);
+    /* Independent updates of an incremental session may be applied in parallel */
+    slapi_connection_set_parallel_apply(connext->connection,
+                                        isInc && replica_get_parallel_apply(replica));
 
 send_response:
     if (connext && replica &&
@@ -1220,6 +1289,7 @@ send_response:
         if (NULL != connext) {
             connext->repl_protocol_version = REPL_PROTOCOL_UNKNOWN;
             connext->isreplicationsession = 0;
+            connext->snapshot = 0;
         }
         slapi_pblock_set(pb, SLAPI_CONN_IS_REPLICATION_SESSION, &zero);
     }
@@ -1247,6 +1317,7 @@ send_response:
     if (NULL != ruv_bervals) {
         ber_bvecfree(ruv_bervals);
     }
+    slapi_ch_free_string(&snap_fingerprint);
 
     return return_value;
 }
@@ -1271,7 +1342,7 @@ multisupplier_extop_EndNSDS50ReplicationRequest(Slapi_PBlock *pb)
     int opid = -1;
 
     /* Decode the extended operation */
-    if (decode_endrepl_extop(pb, &repl_root) == -1) {
+    if (decode_endrepl_extop(pb, REPL_END_NSDS50_REPLICATION_REQUEST_OID, &repl_root) == -1) {
         response = NSDS50_REPL_DECODING_ERROR;
     } else {
 
@@ -1318,7 +1389,19 @@ multisupplier_extop_EndNSDS50ReplicationRequest(Slapi_PBlock *pb)
                 }
                 slapi_pblock_set(pb, SLAPI_TARGET_SDN, repl_root_sdn);
 
-                slapi_stop_bulk_import(pb);
+                if (connext->snapshot) {
+                    back_info_snapshot snap = {0};
+                    Slapi_Backend *be = slapi_be_select(repl_root_sdn);
+
+                    /* the records are all written, bring the backend online */
+                    if (be) {
+                        slapi_back_ctrl_info(be, BACK_INFO_SNAPSHOT_DONE, &snap);
+                    }
+                    connext->snapshot = 0;
+                } else {
+                    replica_total_update_streams_close(r);
+                    slapi_stop_bulk_import(pb);
+                }
 
                 /* ONREPL - this is a bit of a hack. Once bulk import is finished,
                    the replication function that responds to backend state change
@@ -1427,6 +1510,116 @@ free_and_return:
     return return_value;
 }
 
+/*
+ * This plugin entry point is called whenever a TotalUpdateStreamRequest
+ * is received. The connection joins the total update in progress on the
+ * replica: the entries it receives next are queued to the bulk import of
+ * the connection that holds the replica.
+ */
+int
+multisupplier_extop_NSDSTotalUpdateStreamRequest(Slapi_PBlock *pb)
+{
+    int return_value = SLAPI_PLUGIN_EXTENDED_NOT_HANDLED;
+    char *repl_root = NULL;
+    Slapi_DN *repl_root_sdn = NULL;
+    Slapi_DN *bind_sdn = NULL;
+    char *bind_dn = NULL;
+    BerElement *resp_bere = NULL;
+    struct berval *resp_bval = NULL;
+    ber_int_t response;
+    void *conn;
+    consumer_connection_extension *connext = NULL;
+    Replica *replica = NULL;
+    Slapi_Connection *total_conn = NULL;
+    PRUint64 connid = 0;
+    int opid = -1;
+    int one = 1;
+
+    slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
+    slapi_pblock_get(pb, SLAPI_CONN_ID, &connid);
+    slapi_pblock_get(pb, SLAPI_OPERATION_ID, &opid);
+
+    /* Decode the extended operation */
+    if (decode_endrepl_extop(pb, REPL_NSDS_TOTAL_UPDATE_STREAM_REQUEST_OID, &repl_root) == -1) {
+        response = NSDS50_REPL_DECODING_ERROR;
+        goto send_response;
+    }
+
+    connext = consumer_connection_extension_acquire_exclusive_access(conn, connid, opid);
+    if (NULL == connext || connext->replica_acquired || connext->stream_replica) {
+        /* the connection is already in a replication session */
+        response = NSDS50_REPL_REPLICA_BUSY;
+        goto send_response;
+    }
+
+    repl_root_sdn = slapi_sdn_new_dn_byval(repl_root);
+    replica = replica_get_replica_from_dn(repl_root_sdn);
+    if (NULL == replica) {
+        response = NSDS50_REPL_NO_SUCH_REPLICA;
+        goto send_response;
+    }
+
+    /* Check that bind dn is authorized to supply replication updates */
+    slapi_pblock_get(pb, SLAPI_CONN_DN, &bind_dn); /* bind_dn is allocated */
+    bind_sdn = slapi_sdn_new_dn_passin(bind_dn);
+    if (replica_is_updatedn(replica, bind_sdn) == PR_FALSE) {
+        response = NSDS50_REPL_PERMISSION_DENIED;
+        goto send_response;
+    }
+
+    /* A total update must be in progress, on a backend that accepts streams */
+    total_conn = replica_total_update_stream_enter(replica);
+    if (NULL == total_conn) {
+        slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                      "multisupplier_extop_NSDSTotalUpdateStreamRequest - "
+                      "conn=%" PRIu64 " op=%d repl=\"%s\": "
+                      "No total update accepts streams\n",
+                      connid, opid, repl_root);
+        response = NSDS50_REPL_UNKNOWN_UPDATE_PROTOCOL;
+        goto send_response;
+    }
+    replica_total_update_stream_exit(replica, total_conn);
+
+    connext->stream_replica = replica;
+    /* process the entries in the order they are received */
+    slapi_pblock_set(pb, SLAPI_CONN_IS_REPLICATION_SESSION, &one);
+    connext->isreplicationsession = 1;
+    response = NSDS50_REPL_REPLICA_READY;
+    slapi_log_err(SLAPI_LOG_REPL, repl_plugin_name,
+                  "multisupplier_extop_NSDSTotalUpdateStreamRequest - "
+                  "conn=%" PRIu64 " op=%d repl=\"%s\": "
+                  "Joined the total update in progress\n",
+                  connid, opid, repl_root);
+
+send_response:
+    if ((resp_bere = der_alloc()) == NULL) {
+        goto free_and_return;
+    }
+    ber_printf(resp_bere, "{e}", response);
+    ber_flatten(resp_bere, &resp_bval);
+    slapi_pblock_set(pb, SLAPI_EXT_OP_RET_OID, REPL_NSDS50_REPLICATION_RESPONSE_OID);
+    slapi_pblock_set(pb, SLAPI_EXT_OP_RET_VALUE, resp_bval);
+    slapi_send_ldap_result(pb, LDAP_SUCCESS, NULL, NULL, 0, NULL);
+
+    return_value = SLAPI_PLUGIN_EXTENDED_SENT_RESULT;
+
+free_and_return:
+    slapi_ch_free_string(&repl_root);
+    slapi_sdn_free(&repl_root_sdn);
+    slapi_sdn_free(&bind_sdn);
+    if (NULL != resp_bere) {
+        ber_free(resp_bere, 1);
+    }
+    if (NULL != resp_bval) {
+        ber_bvfree(resp_bval);
+    }
+    if (NULL != connext) {
+        consumer_connection_extension_relinquish_exclusive_access(conn, connid, opid, PR_FALSE);
+    }
+
+    return return_value;
+}
+
 /*
  * Decode the ber element passed to us by the cleanAllRUV task
  */
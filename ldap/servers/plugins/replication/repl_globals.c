@@ -81,6 +81,7 @@ const char *type_agmtMaxCSN = "nsds5AgmtMaxCSN";
 const char *type_replicaPurgeDelay = "nsds5ReplicaPurgeDelay";
 const char *type_replicaChangeCount = "nsds5ReplicaChangeCount";
 const char *type_replicaTombstonePurgeInterval = "nsds5ReplicaTombstonePurgeInterval";
+const char *type_replicaTombstoneReapBatchSize = "nsds5ReplicaTombstoneReapBatchSize";
 const char *type_ruvElementUpdatetime = "nsruvReplicaLastModified";
 const char *type_replicaCleanRUV = "nsds5ReplicaCleanRUV";
 const char *type_replicaAbortCleanRUV = "nsds5ReplicaAbortCleanRUV";
@@ -89,6 +90,7 @@ const char *type_replicaReleaseTimeout = "nsds5ReplicaReleaseTimeout";
 const char *type_replicaBackoffMin = "nsds5ReplicaBackoffMin";
 const char *type_replicaBackoffMax = "nsds5ReplicaBackoffMax";
 const char *type_replicaPrecisePurge = "nsds5ReplicaPreciseTombstonePurging";
+const char *type_replicaParallelApply = "nsds5ReplicaParallelApply";
 const char *type_replicaKeepAliveUpdateInterval = "nsds5ReplicaKeepAliveUpdateInterval";
 
 /* Attribute names for replication agreement attributes */
@@ -112,6 +114,9 @@ const char *type_nsds5ReplicaEnabled = "nsds5ReplicaEnabled";
 const char *type_nsds5ReplicaStripAttrs = "nsds5ReplicaStripAttrs";
 const char *type_nsds5ReplicaFlowControlWindow = "nsds5ReplicaFlowControlWindow";
 const char *type_nsds5ReplicaFlowControlPause = "nsds5ReplicaFlowControlPause";
+const char *type_nsds5ReplicaTotalUpdateStreams = "nsds5ReplicaTotalUpdateStreams";
+const char *type_nsds5ReplicaTotalUpdateBatchSize = "nsds5ReplicaTotalUpdateBatchSize";
+const char *type_nsds5ReplicaTotalUpdateMethod = "nsds5ReplicaTotalUpdateMethod";
 const char *type_nsds5WaitForAsyncResults = "nsds5ReplicaWaitForAsyncResults";
 const char *type_replicaIgnoreMissingChange = "nsds5ReplicaIgnoreMissingChange";
 const char *type_nsds5ReplicaBootstrapBindDN = "nsds5ReplicaBootstrapBindDN";
@@ -2118,6 +2118,7 @@ windows_create_remote_entry(Private_Repl_Protocol *prp, Slapi_Entry *original_en
                      * create the attributes with the old type, then reset them. */
                     if (slapi_entry_attr_find(new_entry, type, &new_attr) == 0) {
                         slapi_attr_set_type(new_attr, new_type);
+                        entry_attrs_changed(new_entry);
                     }
                 }
                 slapi_ch_free_string(&new_type);
@@ -381,6 +381,14 @@ retrocl_start(Slapi_PBlock *pb)
         return rc;
     }
 
+    /* Add the records queued but not written before a crash */
+    if (retrocl_queue_replay() != 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_start - Failed to add the change records of the journal "
+                      "of asynchronous writes.\n");
+        return -1;
+    }
+
     /* Remove the old default aci as it exposes passwords changes to anonymous users */
     retrocl_remove_legacy_default_aci();
 
@@ -552,6 +560,10 @@ retrocl_start(Slapi_PBlock *pb)
         slapi_ch_array_free(values);
     }
 
+    if (slapi_entry_attr_get_bool(e, CONFIG_CHANGELOG_ASYNC_WRITE)) {
+        retrocl_queue_start(slapi_entry_attr_get_int(e, CONFIG_CHANGELOG_ASYNC_BATCH));
+    }
+
     return 0;
 }
 
@@ -635,6 +647,7 @@ retrocl_stop(Slapi_PBlock *pb __attribute__((unused)))
     }
     slapi_ch_free((void **)&retrocl_includes);
 
+    retrocl_queue_stop();
     retrocl_stop_trimming();
     retrocl_be_changelog = NULL;
     retrocl_forget_changenumbers();
@@ -680,6 +693,16 @@ retrocl_plugin_init(Slapi_PBlock *pb)
     if ((slapi_pblock_get(pb, SLAPI_PLUGIN_CONFIG_ENTRY, &plugin_entry) == 0) &&
         plugin_entry) {
         is_betxn = slapi_entry_attr_get_bool(plugin_entry, "nsslapd-pluginbetxn");
+        /*
+         * The queued records are written after the operation is committed,
+         * they must not be queued by an operation that may still abort.
+         */
+        if (is_betxn && slapi_entry_attr_get_bool(plugin_entry, CONFIG_CHANGELOG_ASYNC_WRITE)) {
+            slapi_log_err(SLAPI_LOG_INFO, RETROCL_PLUGIN_NAME,
+                          "retrocl_plugin_init - %s is on, using post operation plugins\n",
+                          CONFIG_CHANGELOG_ASYNC_WRITE);
+            is_betxn = 0;
+        }
     }
 
     if (!legacy_initialised) {
@@ -55,6 +55,22 @@ typedef struct _cnumRet
 
 #define CONFIG_CHANGELOG_TRIM_INTERVAL "nsslapd-changelog-trim-interval"
 
+/*
+ * Asynchronous writes of the change records
+ */
+#define CONFIG_CHANGELOG_ASYNC_WRITE "nsslapd-changelog-async-write"
+#define CONFIG_CHANGELOG_ASYNC_BATCH "nsslapd-changelog-async-batch-size"
+#define DEFAULT_CHANGELOG_ASYNC_BATCH 100
+/* postops wait for the writer beyond this number of queued records */
+#define RETROCL_QUEUE_MAX_DEPTH 100000
+/* journal of the queued records, in the changelog database directory */
+#define RETROCL_QUEUE_JOURNAL "retrocl_queue.journal"
+/* the journal is rewritten with the records still queued beyond this size */
+#define RETROCL_QUEUE_JOURNAL_MAX_SIZE (64 * 1024 * 1024)
+/* seconds between two attempts to write a record, doubled up to the max */
+#define RETROCL_QUEUE_RETRY_MIN 1
+#define RETROCL_QUEUE_RETRY_MAX 30
+
 #if defined(__hpux) && defined(__ia64)
 #define RETROCL_DLL_DEFAULT_THREAD_STACKSIZE 524288L
 #else
@@ -144,6 +160,15 @@ extern void retrocl_init_trimming(void);
 extern void retrocl_stop_trimming(void);
 extern char *retrocl_get_config_str(const char *attrt);
 
+extern int retrocl_queue_enabled(void);
+extern int retrocl_queue_start(int batch_size);
+extern void retrocl_queue_stop(void);
+extern void retrocl_queue_record(Slapi_Entry *e, changeNumber cnum);
+extern void retrocl_queue_sync(void);
+extern int retrocl_queue_replay(void);
+extern changeNumber retrocl_get_last_written_changenumber(void);
+extern void retrocl_queue_get_status(uint64_t *depth, time_t *lag, changeNumber *last_written);
+
 int retrocl_entry_in_scope(Slapi_Entry *e);
 int retrocl_attr_in_exclude_attrs(char *attr, int attrlen);
 
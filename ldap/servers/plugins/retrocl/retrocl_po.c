@@ -162,6 +162,7 @@ write_replog_db(
     int extensibleObject = 0;
     int err = 0;
     int ret = LDAP_SUCCESS;
+    int queued = 0;
     int i;
 
     if (!dn) {
@@ -359,8 +360,13 @@ write_replog_db(
         err = SLAPI_PLUGIN_FAILURE;
     }
 
-    /* Call the repl backend to add this entry */
-    if (0 == err) {
+    if (0 == err && retrocl_queue_enabled()) {
+        /* The writer thread adds it, in changenumber order */
+        retrocl_queue_record(e, changenum);
+        retrocl_commit_changenumber();
+        queued = 1;
+    } else if (0 == err) {
+        /* Call the repl backend to add this entry */
         newPb = slapi_pblock_new();
         slapi_add_entry_internal_set_pb(newPb, e, NULL /* controls */,
                                         g_plg_identity[PLUGIN_RETROCL],
@@ -389,6 +395,9 @@ write_replog_db(
         ret = err;
     }
     PR_Unlock(retrocl_internal_lock);
+    if (queued) {
+        retrocl_queue_sync();
+    }
     if (NULL != edn) {
         slapi_ch_free((void **)&edn);
     }
@@ -414,6 +423,7 @@ entry2reple(Slapi_Entry *e, Slapi_Entry *oe, int optype)
     struct berval val;
     int len;
     Slapi_Attr *attrs = NULL;
+    Slapi_Attr *next_attrs = NULL;
 
     vals[0] = &val;
     vals[1] = NULL;
@@ -431,11 +441,11 @@ entry2reple(Slapi_Entry *e, Slapi_Entry *oe, int optype)
     slapi_entry_add_values(e, retrocl_changetype, vals);
 
     /* Does this entry contain any excluded attributes */
-    for (attrs  = oe->e_attrs; attrs != NULL; attrs = attrs->a_next) {
+    for (attrs = oe->e_attrs; attrs != NULL; attrs = next_attrs) {
+        next_attrs = attrs->a_next;
         if (retrocl_attr_in_exclude_attrs(attrs->a_type, strlen(attrs->a_type))) {
             slapi_log_err(SLAPI_LOG_PLUGIN, RETROCL_PLUGIN_NAME, "entry2reple - excluding attr (%s).\n", attrs->a_type);
-            attrlist_delete(&oe->e_attrs, attrs->a_type);
-            attrs = attrs->a_next;
+            slapi_entry_attr_delete(oe, attrs->a_type);
         }
     }
 
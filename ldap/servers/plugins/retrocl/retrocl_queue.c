@@ -0,0 +1,741 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+
+#include "retrocl.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * Asynchronous changelog writes
+ *
+ * With nsslapd-changelog-async-write on, the postop builds the change record
+ * and assigns its changenumber as usual, but appends the record to a queue
+ * instead of adding it to the changelog backend. A writer thread adds the
+ * queued records in changenumber order, several of them in one backend
+ * transaction. The queue is drained before the plugin stops.
+ *
+ * The queued records are also appended to a journal file, in the directory
+ * of the changelog database, and the journal is synced before the postop
+ * returns (retrocl_queue_sync). A record leaves the journal only once it is
+ * in the changelog backend: the journal is emptied when the queue is
+ * drained, or rewritten with the records still queued when it grows too
+ * big. The records left in the journal by a crash are added at startup,
+ * before any new changenumber is assigned (retrocl_queue_replay).
+ *
+ * A journal record is a "# changenumber <cnum> length <len>" line, followed
+ * by the LDIF of the change record (len bytes) and an empty line.
+ */
+
+typedef struct _retrocl_queued_rec
+{
+    Slapi_Entry *qr_entry;    /* change record, a copy is added */
+    changeNumber qr_cnum;
+    time_t qr_queued;         /* when the postop queued it */
+    struct _retrocl_queued_rec *qr_next;
+} retrocl_queued_rec;
+
+typedef struct _retrocl_queue
+{
+    pthread_mutex_t rq_lock;
+    pthread_cond_t rq_records_cv;  /* the writer waits for records */
+    pthread_cond_t rq_space_cv;    /* the postops wait for room in the queue */
+    retrocl_queued_rec *rq_head;
+    retrocl_queued_rec *rq_tail;
+    uint64_t rq_depth;
+    changeNumber rq_last_written;
+    int rq_batch_size;
+    int rq_stopping;
+    PRThread *rq_writer;
+    char *rq_journal_path;
+    int rq_journal_fd;
+    uint64_t rq_journal_size;
+} retrocl_queue;
+
+static retrocl_queue rq = {0};
+static int retrocl_async_write = 0;
+
+static void retrocl_queue_writer(void *arg);
+
+/* Path of the journal, NULL if the changelog backend has no directory */
+static char *
+retrocl_journal_path(void)
+{
+    char *dir = NULL;
+
+    if (retrocl_be_changelog == NULL ||
+        slapi_back_get_info(retrocl_be_changelog, BACK_INFO_DIRECTORY, (void **)&dir) != 0 ||
+        dir == NULL) {
+        return NULL;
+    }
+    return slapi_ch_smprintf("%s/%s", dir, RETROCL_QUEUE_JOURNAL);
+}
+
+static int
+retrocl_journal_write(int fd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+/* Append a record to the journal, size is the journal size, increased by
+ * the bytes written */
+static int
+retrocl_journal_append(int fd, Slapi_Entry *e, changeNumber cnum, uint64_t *size)
+{
+    char header[64];
+    char *ldif;
+    int hlen, len = 0;
+    int rc;
+
+    ldif = slapi_entry2str(e, &len);
+    if (ldif == NULL) {
+        return -1;
+    }
+    hlen = snprintf(header, sizeof(header), "# changenumber %lu length %d\n", cnum, len);
+    rc = retrocl_journal_write(fd, header, hlen);
+    if (rc == 0) {
+        rc = retrocl_journal_write(fd, ldif, len);
+    }
+    if (rc == 0) {
+        rc = retrocl_journal_write(fd, "\n", 1);
+    }
+    slapi_ch_free_string(&ldif);
+    if (rc == 0) {
+        *size += hlen + len + 1;
+    } else {
+        /* Do not leave a partial record before the next ones */
+        int err = errno;
+        (void)ftruncate(fd, *size);
+        errno = err;
+    }
+    return rc;
+}
+
+/*
+ * Called by the writer with rq_lock held, once a batch is in the changelog
+ * backend: drop the records written from the journal.
+ */
+static void
+retrocl_journal_trim(void)
+{
+    retrocl_queued_rec *rec;
+    char *tmp_path;
+    uint64_t size = 0;
+    int fd;
+
+    if (rq.rq_head == NULL) {
+        /* Everything is written */
+        if (ftruncate(rq.rq_journal_fd, 0) != 0) {
+            slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                          "retrocl_journal_trim - Failed to truncate %s, error %d (%s)\n",
+                          rq.rq_journal_path, errno, slapd_system_strerror(errno));
+        } else {
+            rq.rq_journal_size = 0;
+        }
+        return;
+    }
+    if (rq.rq_journal_size <= RETROCL_QUEUE_JOURNAL_MAX_SIZE) {
+        return;
+    }
+
+    /* Rewrite the records still queued, the old journal is replaced once
+     * the new one is synced */
+    tmp_path = slapi_ch_smprintf("%s.tmp", rq.rq_journal_path);
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_journal_trim - Failed to create %s, error %d (%s)\n",
+                      tmp_path, errno, slapd_system_strerror(errno));
+        slapi_ch_free_string(&tmp_path);
+        return;
+    }
+    for (rec = rq.rq_head; rec; rec = rec->qr_next) {
+        if (retrocl_journal_append(fd, rec->qr_entry, rec->qr_cnum, &size) != 0) {
+            break;
+        }
+    }
+    if (rec != NULL || fsync(fd) != 0 || rename(tmp_path, rq.rq_journal_path) != 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_journal_trim - Failed to rewrite %s, error %d (%s)\n",
+                      rq.rq_journal_path, errno, slapd_system_strerror(errno));
+        close(fd);
+        unlink(tmp_path);
+    } else {
+        close(rq.rq_journal_fd);
+        rq.rq_journal_fd = fd;
+        rq.rq_journal_size = size;
+    }
+    slapi_ch_free_string(&tmp_path);
+}
+
+/* Add a copy of a change record, the record is kept for a retry */
+static int
+retrocl_queue_add(Slapi_Entry *e)
+{
+    Slapi_PBlock *newPb = slapi_pblock_new();
+    int ret = 0;
+
+    slapi_add_entry_internal_set_pb(newPb, slapi_entry_dup(e), NULL /* controls */,
+                                    g_plg_identity[PLUGIN_RETROCL],
+                                    SLAPI_OP_FLAG_NEVER_CACHE);
+    slapi_add_internal_pb(newPb);
+    slapi_pblock_get(newPb, SLAPI_PLUGIN_INTOP_RESULT, &ret);
+    slapi_pblock_destroy(newPb);
+    return ret;
+}
+
+/*
+ * Function: retrocl_queue_replay
+ *
+ * Returns: 0 on success, -1 if a record of the journal could not be added
+ *
+ * Description: adds to the changelog backend the records left in the
+ * journal by a crash, whether asynchronous writes are still enabled or
+ * not. Must be called once the changenumbers are read from the backend and
+ * before any change is logged. On failure, the journal is kept and the
+ * plugin must not start, or the changenumbers of the journal would be
+ * assigned again.
+ *
+ */
+int
+retrocl_queue_replay(void)
+{
+    char *path = retrocl_journal_path();
+    struct stat st;
+    char *buf = NULL;
+    char *p, *end;
+    changeNumber first;
+    uint64_t added = 0;
+    int fd, rc = 0;
+
+    if (path == NULL) {
+        return 0;
+    }
+    if ((fd = open(path, O_RDONLY)) < 0) {
+        if (errno != ENOENT) {
+            slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_replay - Failed to open %s, error %d (%s)\n",
+                          path, errno, slapd_system_strerror(errno));
+            rc = -1;
+        }
+        slapi_ch_free_string(&path);
+        return rc;
+    }
+    if (fstat(fd, &st) != 0) {
+        rc = -1;
+    } else {
+        buf = slapi_ch_malloc(st.st_size + 1);
+        for (off_t n = 0; rc == 0 && n < st.st_size;) {
+            ssize_t r = read(fd, buf + n, st.st_size - n);
+            if (r > 0) {
+                n += r;
+            } else if (r == 0 || errno != EINTR) {
+                rc = -1;
+            }
+        }
+    }
+    close(fd);
+    if (rc != 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_queue_replay - Failed to read %s, error %d (%s)\n",
+                      path, errno, slapd_system_strerror(errno));
+        slapi_ch_free_string(&buf);
+        slapi_ch_free_string(&path);
+        return rc;
+    }
+    buf[st.st_size] = '\0';
+
+    /* Records older than the first one in the changelog were trimmed */
+    first = retrocl_get_first_changenumber();
+    end = buf + st.st_size;
+    for (p = buf; p < end;) {
+        char *nl = memchr(p, '\n', end - p);
+        changeNumber cnum;
+        Slapi_Entry *e;
+        char *ldif;
+        int len;
+
+        if (nl == NULL || sscanf(p, "# changenumber %lu length %d", &cnum, &len) != 2 ||
+            len < 0 || len >= end - nl - 1 || nl[len + 1] != '\n') {
+            /* The server stopped while the record was written, the change
+             * was not acknowledged */
+            slapi_log_err(SLAPI_LOG_WARNING, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_replay - Ignoring the incomplete record at the end of %s\n",
+                          path);
+            break;
+        }
+        ldif = slapi_ch_malloc(len + 1);
+        memcpy(ldif, nl + 1, len);
+        ldif[len] = '\0';
+        p = nl + len + 2;
+
+        if (first != 0 && cnum < first) {
+            slapi_ch_free_string(&ldif);
+            continue;
+        }
+        if ((e = slapi_str2entry(ldif, 0)) == NULL) {
+            rc = LDAP_DECODING_ERROR;
+        } else {
+            rc = retrocl_queue_add(e);
+            slapi_entry_free(e);
+        }
+        slapi_ch_free_string(&ldif);
+        if (rc == LDAP_ALREADY_EXISTS) {
+            /* written before the crash */
+            rc = 0;
+        } else if (rc != 0) {
+            slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_replay - Change number %lu of %s could not be added "
+                          "to the changelog (%d), the journal is kept\n",
+                          cnum, path, rc);
+            rc = -1;
+            break;
+        } else {
+            added++;
+        }
+    }
+    slapi_ch_free_string(&buf);
+
+    if (rc == 0) {
+        if (added) {
+            slapi_log_err(SLAPI_LOG_NOTICE, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_replay - %" PRIu64 " change records added from %s\n",
+                          added, path);
+            retrocl_get_changenumbers();
+        }
+        unlink(path);
+    }
+    slapi_ch_free_string(&path);
+    return rc;
+}
+
+/*
+ * Function: retrocl_queue_enabled
+ *
+ * Returns: non-zero if the change records are written by the writer thread
+ *
+ */
+int
+retrocl_queue_enabled(void)
+{
+    return retrocl_async_write;
+}
+
+/*
+ * Function: retrocl_queue_start
+ *
+ * Returns: 0 on success
+ *
+ * Arguments: batch_size - maximum number of records added in one transaction
+ *
+ * Description: starts the writer thread. Change records are then queued by
+ * retrocl_queue_record() until retrocl_queue_stop() is called.
+ *
+ */
+int
+retrocl_queue_start(int batch_size)
+{
+    pthread_mutex_init(&rq.rq_lock, NULL);
+    pthread_cond_init(&rq.rq_records_cv, NULL);
+    pthread_cond_init(&rq.rq_space_cv, NULL);
+    rq.rq_head = rq.rq_tail = NULL;
+    rq.rq_depth = 0;
+    rq.rq_last_written = retrocl_get_last_changenumber();
+    rq.rq_batch_size = batch_size > 0 ? batch_size : DEFAULT_CHANGELOG_ASYNC_BATCH;
+    rq.rq_stopping = 0;
+    rq.rq_journal_size = 0;
+    rq.rq_journal_fd = -1;
+
+    if ((rq.rq_journal_path = retrocl_journal_path()) == NULL ||
+        (rq.rq_journal_fd = open(rq.rq_journal_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND,
+                                 S_IRUSR | S_IWUSR)) < 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_queue_start - Failed to create the journal %s, error %d (%s), "
+                      "changes are written synchronously\n",
+                      rq.rq_journal_path ? rq.rq_journal_path : "(no changelog directory)",
+                      errno, slapd_system_strerror(errno));
+        slapi_ch_free_string(&rq.rq_journal_path);
+        pthread_cond_destroy(&rq.rq_space_cv);
+        pthread_cond_destroy(&rq.rq_records_cv);
+        pthread_mutex_destroy(&rq.rq_lock);
+        return -1;
+    }
+
+    rq.rq_writer = PR_CreateThread(PR_USER_THREAD, retrocl_queue_writer, NULL,
+                                   PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
+                                   PR_JOINABLE_THREAD, RETROCL_DLL_DEFAULT_THREAD_STACKSIZE);
+    if (rq.rq_writer == NULL) {
+        int prerr = PR_GetError();
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_queue_start - Failed to create the writer thread, error %d (%s), "
+                      "changes are written synchronously\n",
+                      prerr, slapi_pr_strerror(prerr));
+        close(rq.rq_journal_fd);
+        unlink(rq.rq_journal_path);
+        slapi_ch_free_string(&rq.rq_journal_path);
+        pthread_cond_destroy(&rq.rq_space_cv);
+        pthread_cond_destroy(&rq.rq_records_cv);
+        pthread_mutex_destroy(&rq.rq_lock);
+        return -1;
+    }
+    retrocl_async_write = 1;
+    slapi_log_err(SLAPI_LOG_INFO, RETROCL_PLUGIN_NAME,
+                  "retrocl_queue_start - Asynchronous changelog writes enabled (batch size %d)\n",
+                  rq.rq_batch_size);
+    return 0;
+}
+
+/*
+ * Function: retrocl_queue_stop
+ *
+ * Returns: none
+ *
+ * Description: writes the records still queued and stops the writer thread.
+ *
+ */
+void
+retrocl_queue_stop(void)
+{
+    if (!retrocl_async_write) {
+        return;
+    }
+    /* From now on, postops write their record themselves */
+    PR_Lock(retrocl_internal_lock);
+    retrocl_async_write = 0;
+    PR_Unlock(retrocl_internal_lock);
+
+    pthread_mutex_lock(&rq.rq_lock);
+    rq.rq_stopping = 1;
+    pthread_cond_signal(&rq.rq_records_cv);
+    pthread_mutex_unlock(&rq.rq_lock);
+
+    PR_JoinThread(rq.rq_writer);
+    rq.rq_writer = NULL;
+
+    /* The journal is empty unless records could not be written */
+    if (rq.rq_journal_size == 0) {
+        unlink(rq.rq_journal_path);
+    }
+    close(rq.rq_journal_fd);
+    rq.rq_journal_fd = -1;
+    slapi_ch_free_string(&rq.rq_journal_path);
+
+    pthread_cond_destroy(&rq.rq_space_cv);
+    pthread_cond_destroy(&rq.rq_records_cv);
+    pthread_mutex_destroy(&rq.rq_lock);
+}
+
+/*
+ * Function: retrocl_queue_record
+ *
+ * Returns: none
+ *
+ * Arguments: e - the change record, the queue takes ownership of it
+ *            cnum - its change number
+ *
+ * Description: must be called with retrocl_internal_lock held, so that the
+ * records are queued and journaled in changenumber order. When the writer
+ * is too far behind, waits for room in the queue. retrocl_queue_sync() must
+ * be called before the operation result is sent.
+ *
+ */
+void
+retrocl_queue_record(Slapi_Entry *e, changeNumber cnum)
+{
+    retrocl_queued_rec *rec = (retrocl_queued_rec *)slapi_ch_calloc(1, sizeof(retrocl_queued_rec));
+
+    rec->qr_entry = e;
+    rec->qr_cnum = cnum;
+    rec->qr_queued = slapi_current_rel_time_t();
+
+    pthread_mutex_lock(&rq.rq_lock);
+    while (rq.rq_depth >= RETROCL_QUEUE_MAX_DEPTH) {
+        pthread_cond_wait(&rq.rq_space_cv, &rq.rq_lock);
+    }
+    if (retrocl_journal_append(rq.rq_journal_fd, e, cnum, &rq.rq_journal_size) != 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_queue_record - Failed to journal change number %lu, error %d (%s), "
+                      "it is lost if the server stops before it is written\n",
+                      cnum, errno, slapd_system_strerror(errno));
+    }
+    if (rq.rq_tail) {
+        rq.rq_tail->qr_next = rec;
+    } else {
+        rq.rq_head = rec;
+    }
+    rq.rq_tail = rec;
+    rq.rq_depth++;
+    pthread_cond_signal(&rq.rq_records_cv);
+    pthread_mutex_unlock(&rq.rq_lock);
+}
+
+/*
+ * Function: retrocl_queue_sync
+ *
+ * Returns: none
+ *
+ * Description: flushes the journal to disk. Called by the postops once
+ * retrocl_internal_lock is released, so that the syncs of concurrent
+ * operations are grouped.
+ *
+ */
+void
+retrocl_queue_sync(void)
+{
+    int fd;
+
+    pthread_mutex_lock(&rq.rq_lock);
+    fd = dup(rq.rq_journal_fd); /* the writer may replace the journal */
+    pthread_mutex_unlock(&rq.rq_lock);
+    if (fd < 0 || fdatasync(fd) != 0) {
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_queue_sync - Failed to sync %s, error %d (%s)\n",
+                      rq.rq_journal_path, errno, slapd_system_strerror(errno));
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+/*
+ * Function: retrocl_get_last_written_changenumber
+ *
+ * Returns: the change number of the last record in the changelog backend
+ *
+ * Description: with asynchronous writes, the change numbers assigned to the
+ * queued records are not published before the records are written.
+ *
+ */
+changeNumber
+retrocl_get_last_written_changenumber(void)
+{
+    changeNumber cnum;
+
+    if (!retrocl_queue_enabled()) {
+        return retrocl_get_last_changenumber();
+    }
+    pthread_mutex_lock(&rq.rq_lock);
+    cnum = rq.rq_last_written;
+    pthread_mutex_unlock(&rq.rq_lock);
+    return cnum;
+}
+
+/*
+ * Function: retrocl_queue_get_status
+ *
+ * Returns: none
+ *
+ * Arguments: depth - number of records not yet written
+ *            lag - age in seconds of the oldest record not yet written
+ *            last_written - change number of the last record written
+ *
+ */
+void
+retrocl_queue_get_status(uint64_t *depth, time_t *lag, changeNumber *last_written)
+{
+    pthread_mutex_lock(&rq.rq_lock);
+    *depth = rq.rq_depth;
+    *lag = rq.rq_head ? slapi_current_rel_time_t() - rq.rq_head->qr_queued : 0;
+    *last_written = rq.rq_last_written;
+    pthread_mutex_unlock(&rq.rq_lock);
+}
+
+static int
+retrocl_queue_stopping(void)
+{
+    int stopping;
+
+    pthread_mutex_lock(&rq.rq_lock);
+    stopping = rq.rq_stopping;
+    pthread_mutex_unlock(&rq.rq_lock);
+    return stopping;
+}
+
+/*
+ * Add a record in its own transaction. A record is never skipped, the
+ * writer retries until it is added: returns non-zero only if the queue is
+ * stopped meanwhile, the record then stays in the journal.
+ */
+static int
+retrocl_queue_write_one(retrocl_queued_rec *rec)
+{
+    int delay = RETROCL_QUEUE_RETRY_MIN;
+    int ret;
+
+    while (1) {
+        Slapi_PBlock *txn_pb = slapi_pblock_new();
+        int txn = 0;
+
+        slapi_pblock_set(txn_pb, SLAPI_BACKEND, retrocl_be_changelog);
+        if (slapi_back_transaction_begin(txn_pb) == 0) {
+            txn = 1;
+        }
+        ret = retrocl_queue_add(rec->qr_entry);
+        if (txn) {
+            if (ret != 0) {
+                slapi_back_transaction_abort(txn_pb);
+            } else {
+                ret = slapi_back_transaction_commit(txn_pb);
+            }
+        }
+        slapi_pblock_destroy(txn_pb);
+
+        if (ret == 0 || ret == LDAP_ALREADY_EXISTS) {
+            return 0;
+        }
+        if (retrocl_queue_stopping()) {
+            slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_write_one - Change number %lu could not be added "
+                          "to the changelog (%d), it is kept in %s and added at the next startup\n",
+                          rec->qr_cnum, ret, rq.rq_journal_path);
+            return ret;
+        }
+        slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                      "retrocl_queue_write_one - Change number %lu could not be added "
+                      "to the changelog (%d), retrying in %d seconds\n",
+                      rec->qr_cnum, ret, delay);
+        DS_Sleep(PR_SecondsToInterval(delay));
+        delay = (delay * 2 > RETROCL_QUEUE_RETRY_MAX) ? RETROCL_QUEUE_RETRY_MAX : delay * 2;
+    }
+}
+
+/*
+ * Add a batch of records to the changelog backend, in a single transaction
+ * when the backend supports it. If an add or the commit fails, nothing of
+ * the batch is written and its records are added one by one.
+ * Returns non-zero if the queue was stopped before the batch was written.
+ */
+static int
+retrocl_queue_write_batch(retrocl_queued_rec *batch)
+{
+    Slapi_PBlock *txn_pb = slapi_pblock_new();
+    retrocl_queued_rec *rec, *next;
+    changeNumber last_cnum = batch->qr_cnum;
+    int txn = 0;
+    int ret = 0;
+
+    slapi_pblock_set(txn_pb, SLAPI_BACKEND, retrocl_be_changelog);
+    if (slapi_back_transaction_begin(txn_pb) == 0) {
+        txn = 1;
+    }
+
+    for (rec = batch; rec; rec = rec->qr_next) {
+        last_cnum = rec->qr_cnum;
+        ret = retrocl_queue_add(rec->qr_entry);
+        if (0 != ret) {
+            slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_write_batch - An error occured while adding change "
+                          "number %lu: %s.\n",
+                          rec->qr_cnum, ldap_err2string(ret));
+            if (txn) {
+                break;
+            }
+            /* no transaction: the other records are not affected */
+            if ((ret = retrocl_queue_write_one(rec)) != 0) {
+                break;
+            }
+        }
+    }
+    if (txn) {
+        if (ret != 0) {
+            slapi_back_transaction_abort(txn_pb);
+        } else if ((ret = slapi_back_transaction_commit(txn_pb)) != 0) {
+            slapi_log_err(SLAPI_LOG_ERR, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_write_batch - Failed to commit change numbers %lu to %lu (%d)\n",
+                          batch->qr_cnum, last_cnum, ret);
+        }
+        if (ret != 0) {
+            slapi_log_err(SLAPI_LOG_WARNING, RETROCL_PLUGIN_NAME,
+                          "retrocl_queue_write_batch - Writing the batch from change number %lu one by one\n",
+                          batch->qr_cnum);
+            for (ret = 0, rec = batch; ret == 0 && rec; rec = rec->qr_next) {
+                ret = retrocl_queue_write_one(rec);
+            }
+        }
+    }
+    slapi_pblock_destroy(txn_pb);
+
+    for (rec = batch; rec; rec = next) {
+        next = rec->qr_next;
+        slapi_entry_free(rec->qr_entry);
+        slapi_ch_free((void **)&rec);
+    }
+    return ret;
+}
+
+/*
+ * Writer thread: takes the queued records by batches of at most
+ * rq_batch_size, until the queue is stopped and empty. If the queue is
+ * stopped while a record can not be written, the records left are only
+ * in the journal.
+ */
+static void
+retrocl_queue_writer(void *arg __attribute__((unused)))
+{
+    retrocl_queued_rec *batch, *last, *next;
+    uint64_t count;
+
+    pthread_mutex_lock(&rq.rq_lock);
+    while (1) {
+        while (rq.rq_head == NULL && !rq.rq_stopping) {
+            pthread_cond_wait(&rq.rq_records_cv, &rq.rq_lock);
+        }
+        if (rq.rq_head == NULL) {
+            /* stopping, and everything is written */
+            break;
+        }
+
+        /* Cut a batch from the head of the queue */
+        batch = last = rq.rq_head;
+        for (count = 1; count < (uint64_t)rq.rq_batch_size && last->qr_next; count++) {
+            last = last->qr_next;
+        }
+        rq.rq_head = last->qr_next;
+        if (rq.rq_head == NULL) {
+            rq.rq_tail = NULL;
+        }
+        last->qr_next = NULL;
+        pthread_mutex_unlock(&rq.rq_lock);
+
+        changeNumber last_cnum = last->qr_cnum;
+        int rc = retrocl_queue_write_batch(batch);
+
+        pthread_mutex_lock(&rq.rq_lock);
+        rq.rq_depth -= count;
+        if (rc != 0) {
+            for (batch = rq.rq_head; batch; batch = next) {
+                next = batch->qr_next;
+                slapi_entry_free(batch->qr_entry);
+                slapi_ch_free((void **)&batch);
+            }
+            rq.rq_head = rq.rq_tail = NULL;
+            rq.rq_depth = 0;
+            break;
+        }
+        rq.rq_last_written = last_cnum;
+        retrocl_journal_trim();
+        pthread_cond_broadcast(&rq.rq_space_cv);
+    }
+    pthread_mutex_unlock(&rq.rq_lock);
+}
@@ -23,7 +23,8 @@
  * Arguments: See plugin API
  *
  * Description: callback function plugged into base object search of root DSE.
- * Adds changelog, firstchangenumber and lastchangenumber attributes.
+ * Adds changelog, firstchangenumber and lastchangenumber attributes, and
+ * the state of the write queue when the changes are written asynchronously.
  *
  */
 
@@ -60,12 +61,35 @@ retrocl_rootdse_search(Slapi_PBlock *pb __attribute__((unused)),
         val.bv_len = strlen(val.bv_val);
         slapi_entry_attr_replace(e, "firstchangenumber", vals);
 
-        /* Last change number contained in log */
-        cnum = retrocl_get_last_changenumber();
+        /* Last change number contained in log, not the last one assigned
+         * to a record still queued */
+        cnum = retrocl_get_last_written_changenumber();
         sprintf(buf, "%lu", cnum);
         val.bv_val = buf;
         val.bv_len = strlen(val.bv_val);
         slapi_entry_attr_replace(e, "lastchangenumber", vals);
+
+        /* Records queued but not yet written to the changelog backend */
+        if (retrocl_queue_enabled()) {
+            uint64_t depth;
+            time_t lag;
+
+            retrocl_queue_get_status(&depth, &lag, &cnum);
+            sprintf(buf, "%" PRIu64, depth);
+            val.bv_val = buf;
+            val.bv_len = strlen(val.bv_val);
+            slapi_entry_attr_replace(e, "changelogqueuedepth", vals);
+
+            sprintf(buf, "%ld", (long)lag);
+            val.bv_val = buf;
+            val.bv_len = strlen(val.bv_val);
+            slapi_entry_attr_replace(e, "changelogwritelag", vals);
+
+            sprintf(buf, "%lu", cnum);
+            val.bv_val = buf;
+            val.bv_len = strlen(val.bv_val);
+            slapi_entry_attr_replace(e, "lastwrittenchangenumber", vals);
+        }
     }
 
     return SLAPI_DSE_CALLBACK_OK;
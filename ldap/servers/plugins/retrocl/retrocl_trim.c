@@ -270,7 +270,7 @@ trim_changelog(void)
                 break;
             }
 
-            last_in_log = retrocl_get_last_changenumber();
+            last_in_log = retrocl_get_last_written_changenumber();
             if (last_in_log == first_in_log) {
                 /* Always leave at least one entry in the change log */
                 break;
@@ -109,6 +109,8 @@ typedef struct OPERATION_PL_CTX
     struct OPERATION_PL_CTX *next; /* list of nested operation, the head of the list is the primary operation */
 } OPERATION_PL_CTX_T;
 
+struct sync_request;
+
 OPERATION_PL_CTX_T * get_thread_primary_op(void);
 void set_thread_primary_op(OPERATION_PL_CTX_T *op);
 op_ext_ident_t * sync_persist_get_operation_extension(Slapi_PBlock *pb);
@@ -150,17 +152,18 @@ int sync_is_active(Slapi_Entry *e, Slapi_PBlock *pb);
 int sync_is_active_scope(const Slapi_DN *dn, Slapi_PBlock *pb);
 
 int sync_refresh_update_content(Slapi_PBlock *pb, Sync_Cookie *client_cookie, Sync_Cookie *session_cookie);
-int sync_refresh_initial_content(Slapi_PBlock *pb, int persist, PRThread *tid, Sync_Cookie *session_cookie);
+int sync_refresh_initial_content(Slapi_PBlock *pb, int persist, struct sync_request *req, Sync_Cookie *session_cookie);
 int sync_read_entry_from_changelog(Slapi_Entry *cl_entry, void *cb_data);
 int sync_send_entry_from_changelog(Slapi_PBlock *pb, int chg_req, char *uniqueid, Sync_Cookie *session_cookie);
 void sync_send_deleted_entries(Slapi_PBlock *pb, Sync_UpdateNode *upd, int chg_count, Sync_Cookie *session_cookie);
 void sync_send_modified_entries(Slapi_PBlock *pb, Sync_UpdateNode *upd, int chg_count, Sync_Cookie *session_cookie);
+void sync_cl_cache_clear(void);
 
 int sync_persist_initialize(int argc, char **argv);
-PRThread *sync_persist_add(Slapi_PBlock *pb);
-int sync_persist_startup(PRThread *tid, Sync_Cookie *session_cookie);
+struct sync_request *sync_persist_add(Slapi_PBlock *pb);
+int sync_persist_startup(struct sync_request *req, Sync_Cookie *session_cookie);
 int sync_persist_terminate_all(void);
-int sync_persist_terminate(PRThread *tid);
+int sync_persist_terminate(struct sync_request *req);
 
 Slapi_PBlock *sync_pblock_copy(Slapi_PBlock *src);
 
@@ -172,14 +175,25 @@ Slapi_ComponentId *plugin_get_default_component_id(void);
  * Structures to handle the persitent phase of
  * Content Synchronization Requests
  *
- * A queue of entries being to be sent by a particular persistent
- * sync thread
+ * A copy of an updated entry, shared by the queues of all the
+ * requests the update matches.
+ */
+typedef struct sync_shared_entry
+{
+    Slapi_Entry *se_entry;
+    uint64_t se_refcnt;
+} SyncSharedEntry;
+
+/*
+ * A queue of entries being to be sent for a particular persistent
+ * sync request
  *
  * will be created in post op plugins
  */
 typedef struct sync_queue_node
 {
     Slapi_Entry *sync_entry;
+    SyncSharedEntry *sync_shared;
     LDAPControl *pe_ctrls[2]; /* XXX ?? XXX */
     struct sync_queue_node *sync_next;
     int sync_chgtype;
@@ -195,15 +209,22 @@ typedef struct sync_request
 {
     Slapi_PBlock *req_pblock;
     Slapi_Operation *req_orig_op;
+    Slapi_Connection *req_conn;
+    int req_conn_acquired;
     PRLock *req_lock;
-    PRThread *req_tid;
     char *req_orig_base;
     Slapi_Filter *req_filter;
     PRInt32 req_complete;
     Sync_Cookie *req_cookie;
     SyncQueueNode *ps_eq_head;
     SyncQueueNode *ps_eq_tail;
+    int req_queue_len;              /* protected by req_lock */
+    int req_overflow;               /* the client does not keep up with the updates */
     int req_active;
+    int req_scheduled;              /* on the ready list or being sent, protected by sync_req_cvarlock */
+    int req_released;               /* protected by sync_req_cvarlock */
+    int req_blocked;                /* the connection can not take more data yet */
+    struct sync_request *req_ready_next;
     struct sync_request *req_next;
 } SyncRequest;
 
@@ -213,12 +234,20 @@ typedef struct sync_request
  * will be initialized at plugin initialization
  */
 #define SYNC_MAX_CONCURRENT 10
+#define SYNC_DEFAULT_WORKERS 4
+#define SYNC_DEFAULT_MAX_QUEUE 10000
 typedef struct sync_request_list
 {
     Slapi_RWLock *sync_req_rwlock; /* R/W lock struct to serialize access */
     SyncRequest *sync_req_head;    /* Head of list */
-    pthread_mutex_t sync_req_cvarlock;    /* Lock for cvar */
-    pthread_cond_t sync_req_cvar;         /* ps threads sleep on this */
+    pthread_mutex_t sync_req_cvarlock;    /* Lock for cvar and the ready list */
+    pthread_cond_t sync_req_cvar;         /* worker threads sleep on this */
+    SyncRequest *sync_ready_head;         /* requests with updates to send */
+    SyncRequest *sync_ready_tail;
+    time_t sync_last_scan;                /* last check for abandoned requests */
+    PRThread **sync_workers;
+    int sync_nb_workers;
+    int sync_req_max_queue;
     int sync_req_max_persist;
     int sync_req_cur_persist;
 } SyncRequestList;
@@ -232,6 +261,6 @@ typedef struct sync_op_info
 {
     int send_flag;       /* hint for preop plugins what to send */
     Sync_Cookie *cookie; /* cookie to add in control */
-    PRThread *tid;       /* thread for persistent phase */
+    struct sync_request *req; /* request for persistent phase */
 } SyncOpInfo;
 
@@ -226,6 +226,7 @@ static int
 sync_close(Slapi_PBlock *pb __attribute__((unused)))
 {
     sync_persist_terminate_all();
+    sync_cl_cache_clear();
     sync_unregister_operation_entension();
 
     return (0);
@@ -28,14 +28,26 @@ static SyncRequestList *sync_request_list = NULL;
  */
 #define SYNC_IS_INITIALIZED() (sync_request_list != NULL)
 
+/*
+ * Number of updates a worker sends for a request before moving to the next
+ * ready one, so that a busy session does not delay the others.
+ */
+#define SYNC_WORKER_BATCH 32
+
 static int plugin_closing = 0;
-static PRUint64 thread_count = 0;
 static int sync_add_request(SyncRequest *req);
 static void sync_remove_request(SyncRequest *req);
 static SyncRequest *sync_request_alloc(void);
+static void sync_request_free(SyncRequest *req);
 void sync_queue_change(OPERATION_PL_CTX_T *operation);
-static void sync_send_results(void *arg);
+static int sync_send_results(SyncRequest *req);
+static void sync_worker_thread(void *arg);
+static void sync_request_schedule_nolock(SyncRequest *req);
+static void sync_request_schedule(SyncRequest *req);
+static void sync_request_schedule_ended(void);
 static void sync_request_wakeup_all(void);
+static SyncSharedEntry *sync_shared_entry_new(Slapi_Entry *e);
+static void sync_shared_entry_release(SyncSharedEntry *shared);
 static void sync_node_free(SyncQueueNode **node);
 
 static int sync_acquire_connection(Slapi_Connection *conn);
@@ -451,6 +463,8 @@ sync_queue_change(OPERATION_PL_CTX_T *operation)
     Slapi_Entry *e = operation->entry;
     Slapi_Entry *eprev = operation->eprev;
     ber_int_t chgtype = operation->chgtype;
+    SyncSharedEntry *shared_e = NULL;
+    SyncSharedEntry *shared_eprev = NULL;
 
     if (!SYNC_IS_INITIALIZED()) {
         return;
@@ -471,7 +485,8 @@ sync_queue_change(OPERATION_PL_CTX_T *operation)
         /* Skip the nodes that have no more active operation
          */
         slapi_pblock_get(req->req_pblock, SLAPI_OPERATION, &op);
-        if (op == NULL || slapi_op_abandoned(req->req_pblock)) {
+        if (op == NULL || slapi_op_abandoned(req->req_pblock) ||
+            req->req_complete || req->req_overflow) {
             continue;
         }
 
@@ -524,14 +539,44 @@ sync_queue_change(OPERATION_PL_CTX_T *operation)
             } else {
                 node->sync_chgtype = chgtype;
             }
+            /*
+             * The entry is duplicated once for all the requests, each
+             * queue node only holds a reference to the shared copy.
+             */
             if (node->sync_chgtype == LDAP_REQ_DELETE && chgtype == LDAP_REQ_MODIFY) {
                 /* use previous entry to pass the filter test in sync_send_results */
-                node->sync_entry = slapi_entry_dup(eprev);
+                if (shared_eprev == NULL) {
+                    shared_eprev = sync_shared_entry_new(eprev);
+                }
+                node->sync_shared = shared_eprev;
             } else {
-                node->sync_entry = slapi_entry_dup(e);
+                if (shared_e == NULL) {
+                    shared_e = sync_shared_entry_new(e);
+                }
+                node->sync_shared = shared_e;
             }
+            slapi_atomic_incr_64(&node->sync_shared->se_refcnt, __ATOMIC_RELAXED);
+            node->sync_entry = node->sync_shared->se_entry;
+
             /* Put it on the end of the list for this sync search */
             PR_Lock(req->req_lock);
+            if (req->req_queue_len >= sync_request_list->sync_req_max_queue) {
+                /*
+                 * The client does not read the updates as fast as they come,
+                 * stop queuing them, the session is ended by a worker and the
+                 * client can resume with its cookie.
+                 */
+                PR_Unlock(req->req_lock);
+                if (!req->req_overflow) {
+                    slapi_log_err(SLAPI_LOG_WARNING, SYNC_PLUGIN_SUBSYSTEM,
+                                  "sync_queue_change - Persistent sync request on \"%s\" has %d pending updates, ending it\n",
+                                  req->req_orig_base, sync_request_list->sync_req_max_queue);
+                    req->req_overflow = 1;
+                }
+                sync_node_free(&node);
+                sync_request_schedule(req);
+                continue;
+            }
             pOldtail = req->ps_eq_tail;
             req->ps_eq_tail = node;
             if (NULL == req->ps_eq_head) {
@@ -539,10 +584,16 @@ sync_queue_change(OPERATION_PL_CTX_T *operation)
             } else {
                 pOldtail->sync_next = req->ps_eq_tail;
             }
+            req->req_queue_len++;
             slapi_log_err(SLAPI_LOG_PLUGIN, SYNC_PLUGIN_SUBSYSTEM, "sync_queue_change - entry "
                                                               "\"%s\" \n",
                       slapi_entry_get_dn_const(node->sync_entry));
             PR_Unlock(req->req_lock);
+
+            /* Hand the request to a worker, a blocked one is retried by the scan */
+            if (req->req_active && !req->req_blocked) {
+                sync_request_schedule(req);
+            }
         }
     }
     /* Were there any matches? */
@@ -557,10 +608,12 @@ sync_queue_change(OPERATION_PL_CTX_T *operation)
     }
     SYNC_UNLOCK_READ();
 
-    /* Were there any matches? */
-    if (matched) {
-        /* Notify update threads */
-        sync_request_wakeup_all();
+    /* Drop the references of the copies, the queues hold their own */
+    if (shared_e) {
+        sync_shared_entry_release(shared_e);
+    }
+    if (shared_eprev) {
+        sync_shared_entry_release(shared_eprev);
     }
 }
 /*
@@ -617,23 +670,55 @@ sync_persist_initialize(int argc, char **argv)
                 sync_request_list->sync_req_max_persist = SYNC_MAX_CONCURRENT;
             }
         }
+        sync_request_list->sync_nb_workers = SYNC_DEFAULT_WORKERS;
+        if (argc > 1) {
+            /* number of threads sending the updates to the clients */
+            int nb_workers = sync_number2int(argv[1]);
+            if (nb_workers > 0) {
+                sync_request_list->sync_nb_workers = nb_workers;
+            }
+        }
+        sync_request_list->sync_req_max_queue = SYNC_DEFAULT_MAX_QUEUE;
+        if (argc > 2) {
+            /* updates pending for a client before its session is ended */
+            int max_queue = sync_number2int(argv[2]);
+            if (max_queue > 0) {
+                sync_request_list->sync_req_max_queue = max_queue;
+            }
+        }
         plugin_closing = 0;
+
+        sync_request_list->sync_workers = (PRThread **)slapi_ch_calloc(sync_request_list->sync_nb_workers,
+                                                                       sizeof(PRThread *));
+        for (int i = 0; i < sync_request_list->sync_nb_workers; i++) {
+            sync_request_list->sync_workers[i] = PR_CreateThread(PR_USER_THREAD, sync_worker_thread,
+                                                                 NULL, PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
+                                                                 PR_JOINABLE_THREAD, SLAPD_DEFAULT_THREAD_STACKSIZE);
+            if (NULL == sync_request_list->sync_workers[i]) {
+                int prerr = PR_GetError();
+                slapi_log_err(SLAPI_LOG_ERR, SYNC_PLUGIN_SUBSYSTEM,
+                              "sync_persist_initialize - Failed to create persistent worker thread, error %d (%s)\n",
+                              prerr, slapi_pr_strerror(prerr));
+                sync_request_list->sync_nb_workers = i;
+                break;
+            }
+        }
     }
     return (0);
 }
 /*
  * Add the given pblock to the list of established sync searches.
- * Then, start a thread to send the results to the client as they
- * are dispatched by add, modify, and modrdn operations.
+ * The updates dispatched by add, modify, and modrdn operations are
+ * then sent to the client by the pool of persistent workers.
  */
-PRThread *
+SyncRequest *
 sync_persist_add(Slapi_PBlock *pb)
 {
     SyncRequest *req = NULL;
     char *base;
     Slapi_Filter *filter;
 
-    if (SYNC_IS_INITIALIZED() && NULL != pb) {
+    if (SYNC_IS_INITIALIZED() && NULL != pb && sync_request_list->sync_nb_workers > 0) {
         /* Create the new node */
         req = sync_request_alloc();
         assert(req); /* avoid gcc_analyzer warning */
@@ -644,54 +729,39 @@ sync_persist_add(Slapi_PBlock *pb)
         req->req_orig_base = slapi_ch_strdup(base);
         slapi_pblock_get(pb, SLAPI_SEARCH_FILTER, &filter);
         req->req_filter = slapi_filter_dup(filter);
+        slapi_pblock_get(req->req_pblock, SLAPI_CONNECTION, &req->req_conn);
 
         /* Add it to the head of the list of persistent searches */
         if (0 == sync_add_request(req)) {
-
-            /* Start a thread to send the results */
-            req->req_tid = PR_CreateThread(PR_USER_THREAD, sync_send_results,
-                                           (void *)req, PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
-                                           PR_UNJOINABLE_THREAD, SLAPD_DEFAULT_THREAD_STACKSIZE);
-
-            /* Checking if the thread is succesfully created and
-                 * if the thread is not created succesfully.... we send
-             * error messages to the Log file
-             */
-            if (NULL == (req->req_tid)) {
-                int prerr;
-                prerr = PR_GetError();
-                slapi_log_err(SLAPI_LOG_ERR, SYNC_PLUGIN_SUBSYSTEM,
-                              "sync_persist_add - Failed to create persitent thread, error %d (%s)\n",
-                              prerr, slapi_pr_strerror(prerr));
-                /* Now remove the ps from the list so call the function ps_remove */
-                sync_remove_request(req);
-                PR_DestroyLock(req->req_lock);
-                req->req_lock = NULL;
-                slapi_ch_free((void **)&req->req_pblock);
-                slapi_ch_free((void **)&req);
-            } else {
-                thread_count++;
-                return (req->req_tid);
+            if (req->req_conn && sync_acquire_connection(req->req_conn) == 0) {
+                req->req_conn_acquired = 1;
+                return (req);
             }
+            slapi_log_err(SLAPI_LOG_ERR, SYNC_PLUGIN_SUBSYSTEM,
+                          "sync_persist_add - Could not acquire the connection of the persistent request\n");
+            sync_remove_request(req);
         }
+        sync_request_free(req);
     }
     return (NULL);
 }
 
 int
-sync_persist_startup(PRThread *tid, Sync_Cookie *cookie)
+sync_persist_startup(SyncRequest *req, Sync_Cookie *cookie)
 {
     SyncRequest *cur;
     int rc = 1;
 
-    if (SYNC_IS_INITIALIZED() && NULL != tid) {
+    if (SYNC_IS_INITIALIZED() && NULL != req) {
         SYNC_LOCK_READ();
         /* Find and change */
         cur = sync_request_list->sync_req_head;
         while (NULL != cur) {
-            if (cur->req_tid == tid) {
+            if (cur == req) {
                 cur->req_active = PR_TRUE;
                 cur->req_cookie = cookie;
+                /* send what was queued during the refresh phase */
+                sync_request_schedule(cur);
                 rc = 0;
                 break;
             }
@@ -704,19 +774,20 @@ sync_persist_startup(PRThread *tid, Sync_Cookie *cookie)
 
 
 int
-sync_persist_terminate(PRThread *tid)
+sync_persist_terminate(SyncRequest *req)
 {
     SyncRequest *cur;
     int rc = 1;
 
-    if (SYNC_IS_INITIALIZED() && NULL != tid) {
+    if (SYNC_IS_INITIALIZED() && NULL != req) {
         SYNC_LOCK_READ();
-        /* Find and change */
+        /* Find and change, a worker releases it */
         cur = sync_request_list->sync_req_head;
         while (NULL != cur) {
-            if (cur->req_tid == tid) {
+            if (cur == req) {
                 cur->req_active = PR_FALSE;
                 cur->req_complete = PR_TRUE;
+                sync_request_schedule(cur);
                 rc = 0;
                 break;
             }
@@ -724,9 +795,6 @@ sync_persist_terminate(PRThread *tid)
         }
         SYNC_UNLOCK_READ();
     }
-    if (rc == 0) {
-        sync_remove_request(cur);
-    }
     return (rc);
 }
 
@@ -738,28 +806,25 @@ sync_persist_terminate_all()
 {
     SyncRequest *req = NULL, *next;
     if (SYNC_IS_INITIALIZED()) {
-        /* signal the threads to stop */
+        /* signal the workers to stop */
         plugin_closing = 1;
         sync_request_wakeup_all();
 
-        /* wait for all the threads to finish */
-        while (thread_count > 0) {
-            PR_Sleep(PR_SecondsToInterval(1));
+        /* wait for all the workers to finish */
+        for (int i = 0; i < sync_request_list->sync_nb_workers; i++) {
+            PR_JoinThread(sync_request_list->sync_workers[i]);
         }
-
-        slapi_destroy_rwlock(sync_request_list->sync_req_rwlock);
-        pthread_mutex_destroy(&(sync_request_list->sync_req_cvarlock));
-		pthread_cond_destroy(&(sync_request_list->sync_req_cvar));
+        slapi_ch_free((void **)&sync_request_list->sync_workers);
 
         /* it frees the structures, just in case it remained connected sync_repl client */
         for (req = sync_request_list->sync_req_head; NULL != req; req = next) {
             next = req->req_next;
-            slapi_pblock_destroy(req->req_pblock);
-            req->req_pblock = NULL;
-            PR_DestroyLock(req->req_lock);
-            req->req_lock = NULL;
-            slapi_ch_free((void **)&req);
+            sync_request_free(req);
         }
+
+        slapi_destroy_rwlock(sync_request_list->sync_req_rwlock);
+        pthread_mutex_destroy(&(sync_request_list->sync_req_cvarlock));
+        pthread_cond_destroy(&(sync_request_list->sync_req_cvar));
         slapi_ch_free((void **)&sync_request_list);
     }
 
@@ -782,7 +847,6 @@ sync_request_alloc(void)
         slapi_ch_free((void **)&req);
         return (NULL);
     }
-    req->req_tid = (PRThread *)NULL;
     req->req_complete = 0;
     req->req_cookie = NULL;
     req->ps_eq_head = req->ps_eq_tail = (SyncQueueNode *)NULL;
@@ -791,6 +855,53 @@ sync_request_alloc(void)
     return req;
 }
 
+/*
+ * Free a request which is no longer in the list, and end its operation.
+ */
+static void
+sync_request_free(SyncRequest *req)
+{
+    SyncQueueNode *qnode, *qnodenext;
+    LDAPControl **ctrls = NULL;
+    char **attrs_dup;
+    char *strFilter;
+
+    if (req->req_conn_acquired) {
+        /* indicate the end of search */
+        sync_release_connection(req->req_pblock, req->req_conn, req->req_orig_op, 1);
+        req->req_conn_acquired = 0;
+    }
+
+    PR_DestroyLock(req->req_lock);
+    req->req_lock = NULL;
+
+    slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_ATTRS, &attrs_dup);
+    slapi_ch_array_free(attrs_dup);
+    slapi_pblock_set(req->req_pblock, SLAPI_SEARCH_ATTRS, NULL);
+
+    slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_STRFILTER, &strFilter);
+    slapi_ch_free((void **)&strFilter);
+    slapi_pblock_set(req->req_pblock, SLAPI_SEARCH_STRFILTER, NULL);
+
+    slapi_pblock_get(req->req_pblock, SLAPI_REQCONTROLS, &ctrls);
+    if (ctrls) {
+        ldap_controls_free(ctrls);
+        slapi_pblock_set(req->req_pblock, SLAPI_REQCONTROLS, NULL);
+    }
+
+    slapi_pblock_destroy(req->req_pblock);
+    req->req_pblock = NULL;
+
+    slapi_ch_free((void **)&req->req_orig_base);
+    slapi_filter_free(req->req_filter, 1);
+
+    for (qnode = req->ps_eq_head; qnode; qnode = qnodenext) {
+        qnodenext = qnode->sync_next;
+        sync_node_free(&qnode);
+    }
+    slapi_ch_free((void **)&req);
+}
+
 
 /*
  * Add the given persistent search to the
@@ -852,6 +963,61 @@ sync_remove_request(SyncRequest *req)
     }
 }
 
+/*
+ * Put the request on the ready list, unless a worker already has it.
+ * Must be called with sync_req_cvarlock held.
+ */
+static void
+sync_request_schedule_nolock(SyncRequest *req)
+{
+    if (req->req_scheduled || req->req_released) {
+        return;
+    }
+    req->req_scheduled = 1;
+    req->req_ready_next = NULL;
+    if (NULL == sync_request_list->sync_ready_tail) {
+        sync_request_list->sync_ready_head = req;
+    } else {
+        sync_request_list->sync_ready_tail->req_ready_next = req;
+    }
+    sync_request_list->sync_ready_tail = req;
+    pthread_cond_signal(&(sync_request_list->sync_req_cvar));
+}
+
+static void
+sync_request_schedule(SyncRequest *req)
+{
+    pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+    sync_request_schedule_nolock(req);
+    pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+}
+
+/*
+ * If an operation is abandoned, we do not get notified by the
+ * connection code. Hand the requests which ended while they had
+ * nothing to send to the workers, so that they are released, and
+ * retry the ones whose client was not reading.
+ */
+static void
+sync_request_schedule_ended(void)
+{
+    SyncRequest *req;
+
+    SYNC_LOCK_READ();
+    pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+    for (req = sync_request_list->sync_req_head; NULL != req; req = req->req_next) {
+        if (req->req_complete || req->req_overflow || req->req_orig_op == NULL ||
+            slapi_is_operation_abandoned(req->req_orig_op)) {
+            sync_request_schedule_nolock(req);
+        } else if (req->req_blocked) {
+            req->req_blocked = 0;
+            sync_request_schedule_nolock(req);
+        }
+    }
+    pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+    SYNC_UNLOCK_READ();
+}
+
 static void
 sync_request_wakeup_all(void)
 {
@@ -908,192 +1074,240 @@ sync_release_connection(Slapi_PBlock *pb, Slapi_Connection *conn, Slapi_Operatio
     return (0);
 }
 /*
- * Thread routine for sending search results to a client
- * which is persistently waiting for them.
+ * Worker routine for sending search results to the clients
+ * which are persistently waiting for them.
  *
- * This routine will terminate when either (a) the ps_complete
- * flag is set, or (b) the associated operation is abandoned.
- * In any case, the thread won't notice until it wakes from
- * sleeping on the ps_list condition variable, so it needs
- * to be awakened.
+ * The workers take the requests from the ready list, where they
+ * are put when updates are queued for them or when they end.
+ * The workers terminate when the plugin is closing.
  */
 static void
-sync_send_results(void *arg)
+sync_worker_thread(void *arg __attribute__((unused)))
 {
-    SyncRequest *req = (SyncRequest *)arg;
-    SyncQueueNode *qnode, *qnodenext;
-    int conn_acq_flag = 0;
-    Slapi_Connection *conn = NULL;
+    SyncRequest *req;
+    int done;
+
+    pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+    while (!plugin_closing) {
+        time_t now = slapi_current_rel_time_t();
+
+        if (now != sync_request_list->sync_last_scan) {
+            sync_request_list->sync_last_scan = now;
+            pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+            sync_request_schedule_ended();
+            pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+        }
+
+        req = sync_request_list->sync_ready_head;
+        if (NULL == req) {
+            /* Nothing to do yet, wake up every second to check the ended requests */
+            struct timespec current_time = {0};
+            clock_gettime(CLOCK_MONOTONIC, &current_time);
+            current_time.tv_sec += 1;
+            pthread_cond_timedwait(&(sync_request_list->sync_req_cvar),
+                                   &(sync_request_list->sync_req_cvarlock),
+                                   &current_time);
+            continue;
+        }
+        sync_request_list->sync_ready_head = req->req_ready_next;
+        if (NULL == sync_request_list->sync_ready_head) {
+            sync_request_list->sync_ready_tail = NULL;
+        }
+        req->req_ready_next = NULL;
+
+        /*
+         * Send the results.  Since send_ldap_search_entry can block for
+         * up to 30 minutes, we relinquish all locks before calling it.
+         */
+        pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+        done = sync_send_results(req);
+        pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+
+        req->req_scheduled = 0;
+        if (done) {
+            /* This client closed the connection or shutdown, free the req */
+            req->req_released = 1;
+            pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+            sync_remove_request(req);
+            sync_request_free(req);
+            pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+        } else if (req->req_active && !req->req_blocked) {
+            /* More updates were queued while sending, go back in line */
+            PR_Lock(req->req_lock);
+            if (NULL != req->ps_eq_head) {
+                sync_request_schedule_nolock(req);
+            }
+            PR_Unlock(req->req_lock);
+        }
+    }
+    pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+}
+
+/*
+ * Send at most SYNC_WORKER_BATCH queued updates of a request.
+ * The updates stay queued while the client does not read what was sent,
+ * rather than having the worker wait for it: the request is marked
+ * blocked and retried by the next scan of the requests.
+ *
+ * Returns 1 when the request is over: either (a) the req_complete
+ * flag is set, (b) the associated operation is abandoned, (c) the
+ * client did not keep up with the updates, or (d) the plugin is closing.
+ */
+static int
+sync_send_results(SyncRequest *req)
+{
+    SyncQueueNode *qnode;
     Slapi_Operation *op = req->req_orig_op;
-    LDAPControl **ctrls = NULL;
     int rc;
     PRUint64 connid;
     int opid;
-    char **attrs_dup;
-    char *strFilter;
 
     slapi_pblock_get(req->req_pblock, SLAPI_CONN_ID, &connid);
     slapi_pblock_get(req->req_pblock, SLAPI_OPERATION_ID, &opid);
-    slapi_pblock_get(req->req_pblock, SLAPI_CONNECTION, &conn);
-    if (NULL == conn) {
+    if (!req->req_conn_acquired) {
         slapi_log_err(SLAPI_LOG_ERR, SYNC_PLUGIN_SUBSYSTEM,
                       "sync_send_results - conn=%" PRIu64 " op=%d Null connection - aborted\n",
                       connid, opid);
-        goto done;
-    }
-    conn_acq_flag = sync_acquire_connection(conn);
-    if (conn_acq_flag) {
-        slapi_log_err(SLAPI_LOG_ERR, SYNC_PLUGIN_SUBSYSTEM,
-                      "sync_send_results - conn=%" PRIu64 " op=%d Could not acquire the connection - aborted\n",
-                      connid, opid);
-        goto done;
+        return (1);
     }
 
-    pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
+    for (int sent = 0; sent < SYNC_WORKER_BATCH; sent++) {
+        int attrsonly;
+        char **attrs;
+        char **noattrs = NULL;
+        LDAPControl **ectrls = NULL;
+        Slapi_Entry *ec;
+        int chg_type = LDAP_SYNC_NONE;
 
-    while ((conn_acq_flag == 0) && !req->req_complete && !plugin_closing) {
+        if (req->req_complete || plugin_closing) {
+            return (1);
+        }
         /* Check for an abandoned operation */
         if (op == NULL || slapi_is_operation_abandoned(op)) {
             slapi_log_err(SLAPI_LOG_PLUGIN, SYNC_PLUGIN_SUBSYSTEM,
                           "sync_send_results - conn=%" PRIu64 " op=%d Operation no longer active - terminating\n",
                           connid, opid);
-            break;
+            return (1);
+        }
+        if (req->req_overflow) {
+            slapi_log_err(SLAPI_LOG_ERR, SYNC_PLUGIN_SUBSYSTEM,
+                          "sync_send_results - conn=%" PRIu64 " op=%d More than %d pending updates - terminating\n",
+                          connid, opid, sync_request_list->sync_req_max_queue);
+            sync_result_err(req->req_pblock, LDAP_ADMINLIMIT_EXCEEDED,
+                            "Too many pending updates for the synchronization session");
+            return (1);
+        }
+        if (!req->req_active) {
+            /* The refresh phase is not yet completed */
+            return (0);
+        }
+        PR_Lock(req->req_lock);
+        qnode = req->ps_eq_head;
+        PR_Unlock(req->req_lock);
+        if (NULL == qnode) {
+            return (0);
+        }
+        if (!slapi_connection_is_writable(req->req_conn)) {
+            slapi_log_err(SLAPI_LOG_PLUGIN, SYNC_PLUGIN_SUBSYSTEM,
+                          "sync_send_results - conn=%" PRIu64 " op=%d Client not reading, %d updates pending\n",
+                          connid, opid, req->req_queue_len);
+            req->req_blocked = 1;
+            return (0);
         }
-        if (NULL == req->ps_eq_head || !req->req_active) {
-            /* Nothing to do yet, or the refresh phase is not yet completed */
-            /* If an operation is abandoned, we do not get notified by the
-             * connection code. Wake up every second to check if thread
-             * should terminate.
-             */
-            struct timespec current_time = {0};
-            clock_gettime(CLOCK_MONOTONIC, &current_time);
-            current_time.tv_sec += 1;
-            pthread_cond_timedwait(&(sync_request_list->sync_req_cvar),
-                                   &(sync_request_list->sync_req_cvarlock),
-                                   &current_time);
-        } else {
-            /* dequeue the item */
-            int attrsonly;
-            char **attrs;
-            char **noattrs = NULL;
-            LDAPControl **ectrls = NULL;
-            Slapi_Entry *ec;
-            int chg_type = LDAP_SYNC_NONE;
-
-            /* dequeue one element */
-            PR_Lock(req->req_lock);
-            qnode = req->ps_eq_head;
-            slapi_log_err(SLAPI_LOG_PLUGIN, SYNC_PLUGIN_SUBSYSTEM, "sync_queue_change - dequeue  "
-                          "\"%s\" \n",
-                          slapi_entry_get_dn_const(qnode->sync_entry));
-            req->ps_eq_head = qnode->sync_next;
-            if (NULL == req->ps_eq_head) {
-                req->ps_eq_tail = NULL;
-            }
-            PR_Unlock(req->req_lock);
-
-            /* Get all the information we need to send the result */
-            ec = qnode->sync_entry;
-            slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_ATTRS, &attrs);
-            slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_ATTRSONLY, &attrsonly);
-
-            /*
-             * Send the result.  Since send_ldap_search_entry can block for
-             * up to 30 minutes, we relinquish all locks before calling it.
-             */
-            pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
-
-            /*
-             * The entry is in the right scope and matches the filter
-             * but we need to redo the filter test here to check access
-             * controls. See the comments at the slapi_filter_test()
-             * call in sync_persist_add().
-            */
-
-            if (slapi_vattr_filter_test(req->req_pblock, ec, req->req_filter,
-                                        1 /* verify_access */) == 0) {
-                slapi_pblock_set(req->req_pblock, SLAPI_SEARCH_RESULT_ENTRY, ec);
-
-                /* NEED TO BUILD THE CONTROL */
-                switch (qnode->sync_chgtype) {
-                case LDAP_REQ_ADD:
-                    chg_type = LDAP_SYNC_ADD;
-                    break;
-                case LDAP_REQ_MODIFY:
-                    chg_type = LDAP_SYNC_MODIFY;
-                    break;
-                case LDAP_REQ_MODRDN:
-                    chg_type = LDAP_SYNC_MODIFY;
-                    break;
-                case LDAP_REQ_DELETE:
-                    chg_type = LDAP_SYNC_DELETE;
-                    noattrs = (char **)slapi_ch_calloc(2, sizeof(char *));
-                    noattrs[0] = slapi_ch_strdup("1.1");
-                    noattrs[1] = NULL;
-                    break;
-                }
-                ectrls = (LDAPControl **)slapi_ch_calloc(2, sizeof(LDAPControl *));
-                if (req->req_cookie) {
-                    sync_cookie_update(req->req_cookie, ec);
-                }
-                sync_create_state_control(ec, &ectrls[0], chg_type, req->req_cookie, PR_FALSE);
-                rc = slapi_send_ldap_search_entry(req->req_pblock,
-                                                  ec, ectrls,
-                                                  noattrs ? noattrs : attrs, attrsonly);
-                if (rc) {
-                    slapi_log_err(SLAPI_LOG_CONNS, SYNC_PLUGIN_SUBSYSTEM,
-                                  "sync_send_results - Error %d sending entry %s\n",
-                                  rc, slapi_entry_get_dn_const(ec));
-                }
-                ldap_controls_free(ectrls);
-                slapi_ch_array_free(noattrs);
-            }
-            pthread_mutex_lock(&(sync_request_list->sync_req_cvarlock));
 
-            /* Deallocate our wrapper for this entry */
-            sync_node_free(&qnode);
+        /* dequeue one element */
+        PR_Lock(req->req_lock);
+        qnode = req->ps_eq_head;
+        if (NULL == qnode) {
+            PR_Unlock(req->req_lock);
+            return (0);
         }
-    }
-    pthread_mutex_unlock(&(sync_request_list->sync_req_cvarlock));
+        slapi_log_err(SLAPI_LOG_PLUGIN, SYNC_PLUGIN_SUBSYSTEM, "sync_queue_change - dequeue  "
+                      "\"%s\" \n",
+                      slapi_entry_get_dn_const(qnode->sync_entry));
+        req->ps_eq_head = qnode->sync_next;
+        if (NULL == req->ps_eq_head) {
+            req->ps_eq_tail = NULL;
+        }
+        req->req_queue_len--;
+        PR_Unlock(req->req_lock);
 
-    /* indicate the end of search */
-    sync_release_connection(req->req_pblock, conn, op, conn_acq_flag == 0);
+        /* Get all the information we need to send the result */
+        ec = qnode->sync_entry;
+        slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_ATTRS, &attrs);
+        slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_ATTRSONLY, &attrsonly);
 
-done:
-    /* This client closed the connection or shutdown, free the req */
-    sync_remove_request(req);
-    PR_DestroyLock(req->req_lock);
-    req->req_lock = NULL;
+        /*
+         * The entry is in the right scope and matches the filter
+         * but we need to redo the filter test here to check access
+         * controls. See the comments at the slapi_filter_test()
+         * call in sync_persist_add().
+        */
 
-    slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_ATTRS, &attrs_dup);
-    slapi_ch_array_free(attrs_dup);
-    slapi_pblock_set(req->req_pblock, SLAPI_SEARCH_ATTRS, NULL);
+        if (slapi_vattr_filter_test(req->req_pblock, ec, req->req_filter,
+                                    1 /* verify_access */) == 0) {
+            slapi_pblock_set(req->req_pblock, SLAPI_SEARCH_RESULT_ENTRY, ec);
 
-    slapi_pblock_get(req->req_pblock, SLAPI_SEARCH_STRFILTER, &strFilter);
-    slapi_ch_free((void **)&strFilter);
-    slapi_pblock_set(req->req_pblock, SLAPI_SEARCH_STRFILTER, NULL);
+            /* NEED TO BUILD THE CONTROL */
+            switch (qnode->sync_chgtype) {
+            case LDAP_REQ_ADD:
+                chg_type = LDAP_SYNC_ADD;
+                break;
+            case LDAP_REQ_MODIFY:
+                chg_type = LDAP_SYNC_MODIFY;
+                break;
+            case LDAP_REQ_MODRDN:
+                chg_type = LDAP_SYNC_MODIFY;
+                break;
+            case LDAP_REQ_DELETE:
+                chg_type = LDAP_SYNC_DELETE;
+                noattrs = (char **)slapi_ch_calloc(2, sizeof(char *));
+                noattrs[0] = slapi_ch_strdup("1.1");
+                noattrs[1] = NULL;
+                break;
+            }
+            ectrls = (LDAPControl **)slapi_ch_calloc(2, sizeof(LDAPControl *));
+            if (req->req_cookie) {
+                sync_cookie_update(req->req_cookie, ec);
+            }
+            sync_create_state_control(ec, &ectrls[0], chg_type, req->req_cookie, PR_FALSE);
+            rc = slapi_send_ldap_search_entry(req->req_pblock,
+                                              ec, ectrls,
+                                              noattrs ? noattrs : attrs, attrsonly);
+            if (rc) {
+                slapi_log_err(SLAPI_LOG_CONNS, SYNC_PLUGIN_SUBSYSTEM,
+                              "sync_send_results - Error %d sending entry %s\n",
+                              rc, slapi_entry_get_dn_const(ec));
+            }
+            ldap_controls_free(ectrls);
+            slapi_ch_array_free(noattrs);
+        }
 
-    slapi_pblock_get(req->req_pblock, SLAPI_REQCONTROLS, &ctrls);
-    if (ctrls) {
-        ldap_controls_free(ctrls);
-        slapi_pblock_set(req->req_pblock, SLAPI_REQCONTROLS, NULL);
+        /* Deallocate our wrapper for this entry */
+        sync_node_free(&qnode);
     }
+    return (0);
+}
 
-    slapi_pblock_destroy(req->req_pblock);
-    req->req_pblock = NULL;
+static SyncSharedEntry *
+sync_shared_entry_new(Slapi_Entry *e)
+{
+    SyncSharedEntry *shared = (SyncSharedEntry *)slapi_ch_calloc(1, sizeof(SyncSharedEntry));
 
-    slapi_ch_free((void **)&req->req_orig_base);
-    slapi_filter_free(req->req_filter, 1);
+    shared->se_entry = slapi_entry_dup(e);
+    shared->se_refcnt = 1;
+    return shared;
+}
 
-    for (qnode = req->ps_eq_head; qnode; qnode = qnodenext) {
-        qnodenext = qnode->sync_next;
-        sync_node_free(&qnode);
+static void
+sync_shared_entry_release(SyncSharedEntry *shared)
+{
+    if (slapi_atomic_decr_64(&shared->se_refcnt, __ATOMIC_ACQ_REL) == 0) {
+        slapi_entry_free(shared->se_entry);
+        slapi_ch_free((void **)&shared);
     }
-    slapi_ch_free((void **)&req);
-    thread_count--;
 }
 
-
 /*
  * Free a sync update node (and everything it holds).
  */
@@ -1101,8 +1315,9 @@ static void
 sync_node_free(SyncQueueNode **node)
 {
     if (node != NULL && *node != NULL) {
-        if ((*node)->sync_entry != NULL) {
-            slapi_entry_free((*node)->sync_entry);
+        if ((*node)->sync_shared != NULL) {
+            sync_shared_entry_release((*node)->sync_shared);
+            (*node)->sync_shared = NULL;
             (*node)->sync_entry = NULL;
         }
         slapi_ch_free((void **)node);
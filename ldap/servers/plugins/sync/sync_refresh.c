@@ -8,7 +8,7 @@
 
 #include "sync.h"
 
-static SyncOpInfo *new_SyncOpInfo(int flag, PRThread *tid, Sync_Cookie *cookie);
+static SyncOpInfo *new_SyncOpInfo(int flag, SyncRequest *req, Sync_Cookie *cookie);
 
 static int sync_extension_type;
 static int sync_extension_handle;
@@ -19,8 +19,33 @@ static void sync_set_operation_extension(Slapi_PBlock *pb, SyncOpInfo *spec);
 static int sync_find_ref_by_uuid(Sync_UpdateNode *updates, int stop, char *uniqueid);
 static void sync_free_update_nodes(Sync_UpdateNode **updates, int count);
 Slapi_Entry *sync_deleted_entry_from_changelog(Slapi_Entry *cl_entry);
+static char *sync_get_attr_value_from_entry(Slapi_Entry *cl_entry, char *attrtype);
 static int sync_feature_allowed(Slapi_PBlock *pb);
 
+/*
+ * The retro changelog records recently read to refresh sessions from a
+ * cookie. Clients reconnecting at the same time have close cookies, so they
+ * all replay the same changelog window: the records from cl_first to cl_last
+ * have been read once, the next sessions only search the changes above.
+ * The window only holds consecutive changenumbers: a record is replayed
+ * from it only if all the ones before it since the start of the session
+ * are there, anything else is read from the changelog.
+ */
+#define SYNC_CL_CACHE_SIZE 1024
+static pthread_mutex_t sync_cl_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static Slapi_Entry **sync_cl_cache = NULL; /* ordered by changenumber */
+static size_t sync_cl_cache_count = 0;
+static unsigned long sync_cl_first = SYNC_INVALID_CHANGENUM;
+static unsigned long sync_cl_last = SYNC_INVALID_CHANGENUM;
+
+typedef struct sync_cl_read
+{
+    Sync_CallBackData *cl_cb_data;
+    Slapi_Entry **cl_entries;
+    size_t cl_count;
+    size_t cl_size;
+} Sync_ChangelogRead;
+
 static int
 sync_feature_allowed(Slapi_PBlock *pb)
 {
@@ -61,7 +86,7 @@ sync_srch_refresh_pre_search(Slapi_PBlock *pb)
     Sync_Cookie *session_cookie = NULL;
     int rc = 0;
     int sync_persist = 0;
-    PRThread *tid = NULL;
+    SyncRequest *req = NULL;
     int entries_sent = 0;
 
     slapi_pblock_get(pb, SLAPI_REQCONTROLS, &requestcontrols);
@@ -127,9 +152,9 @@ sync_srch_refresh_pre_search(Slapi_PBlock *pb)
                     sync_result_err(pb, rc, "Invalid session state, openldap compat not supported with persistence");
                     goto error_return;
                 }
-                /* Launch the thread. */
-                tid = sync_persist_add(pb);
-                if (tid)
+                /* Register the request with the persist workers. */
+                req = sync_persist_add(pb);
+                if (req)
                     sync_persist = 1;
                 else {
                     rc = LDAP_UNWILLING_TO_PERFORM;
@@ -162,7 +187,7 @@ sync_srch_refresh_pre_search(Slapi_PBlock *pb)
                     sync_result_err(pb, rc, "Invalid session cookie");
                 }
             } else {
-                rc = sync_refresh_initial_content(pb, sync_persist, tid, session_cookie);
+                rc = sync_refresh_initial_content(pb, sync_persist, req, session_cookie);
                 if (rc == 0 && !sync_persist) {
                     /* maintained in postop code */
                     session_cookie = NULL;
@@ -172,7 +197,7 @@ sync_srch_refresh_pre_search(Slapi_PBlock *pb)
 
             if (rc) {
                 if (sync_persist) {
-                    sync_persist_terminate(tid);
+                    sync_persist_terminate(req);
                 }
                 goto error_return;
             } else if (sync_persist) {
@@ -180,7 +205,7 @@ sync_srch_refresh_pre_search(Slapi_PBlock *pb)
 
                 slapi_pblock_get(pb, SLAPI_OPERATION, &operation);
                 if (client_cookie) {
-                    rc = sync_persist_startup(tid, session_cookie);
+                    rc = sync_persist_startup(req, session_cookie);
                 }
                 if (rc == 0) {
                     session_cookie = NULL; /* maintained in persist code */
@@ -225,8 +250,8 @@ sync_srch_refresh_post_search(Slapi_PBlock *pb)
          * depending on the operation type, reset flag
          */
         info->send_flag &= ~SYNC_FLAG_ADD_STATE_CTRL;
-        /* activate the persistent phase thread*/
-        sync_persist_startup(info->tid, info->cookie);
+        /* activate the persistent phase */
+        sync_persist_startup(info->req, info->cookie);
     }
     if (info->send_flag & SYNC_FLAG_ADD_DONE_CTRL) {
         LDAPControl **ctrl = (LDAPControl **)slapi_ch_calloc(2, sizeof(LDAPControl *));
@@ -324,12 +349,166 @@ sync_free_update_nodes(Sync_UpdateNode **updates, int count)
     slapi_ch_free((void **)updates);
 }
 
+static unsigned long
+sync_cl_changenumber(Slapi_Entry *cl_entry)
+{
+    char *chgnr = sync_get_attr_value_from_entry(cl_entry, CL_ATTR_CHANGENUMBER);
+    unsigned long chgnum = sync_number2ulong(chgnr);
+
+    slapi_ch_free_string(&chgnr);
+    return chgnum;
+}
+
+static int
+sync_cl_changenumber_cmp(const void *a, const void *b)
+{
+    unsigned long cn_a = sync_cl_changenumber(*(Slapi_Entry **)a);
+    unsigned long cn_b = sync_cl_changenumber(*(Slapi_Entry **)b);
+
+    return (cn_a > cn_b) - (cn_a < cn_b);
+}
+
+/* Must be called with sync_cl_cache_lock held */
+static void
+sync_cl_cache_clear_nolock(void)
+{
+    for (size_t i = 0; i < sync_cl_cache_count; i++) {
+        slapi_entry_free(sync_cl_cache[i]);
+    }
+    slapi_ch_free((void **)&sync_cl_cache);
+    sync_cl_cache_count = 0;
+    sync_cl_first = sync_cl_last = SYNC_INVALID_CHANGENUM;
+}
+
+void
+sync_cl_cache_clear(void)
+{
+    pthread_mutex_lock(&sync_cl_cache_lock);
+    sync_cl_cache_clear_nolock();
+    pthread_mutex_unlock(&sync_cl_cache_lock);
+}
+
+/*
+ * Feed the cached records of [start, end] to the changelog callback, up
+ * to the first missing or repeated changenumber.
+ * Returns the first changenumber still to be read from the changelog.
+ */
+static unsigned long
+sync_cl_cache_replay(unsigned long start, unsigned long end, Sync_CallBackData *cb_data)
+{
+    unsigned long next = start;
+
+    pthread_mutex_lock(&sync_cl_cache_lock);
+    if (sync_cl_last != SYNC_INVALID_CHANGENUM && end < sync_cl_first) {
+        /* The changelog was recreated and numbers restarted, forget the window */
+        sync_cl_cache_clear_nolock();
+    }
+    if (sync_cl_last != SYNC_INVALID_CHANGENUM &&
+        sync_cl_first <= start && start <= sync_cl_last) {
+        for (size_t i = 0; i < sync_cl_cache_count; i++) {
+            Slapi_Entry *cl_entry = sync_cl_cache[i];
+            unsigned long chgnum = sync_cl_changenumber(cl_entry);
+
+            if (chgnum < start) {
+                continue;
+            }
+            if (chgnum > end || chgnum != next) {
+                break;
+            }
+            next++;
+            if (cb_data->openldap_compat &&
+                !slapi_entry_attr_exists(cl_entry, CL_ATTR_ENTRYUUID)) {
+                /* the changelog search filters them out in openldap compat */
+                continue;
+            }
+            sync_read_entry_from_changelog(cl_entry, cb_data);
+        }
+    }
+    pthread_mutex_unlock(&sync_cl_cache_lock);
+
+    return next;
+}
+
+/*
+ * Add the records read from the changelog for [start, end] to the window,
+ * if they extend it or replace it with more recent ones. The window ends
+ * before the first missing or repeated changenumber.
+ * The entries are consumed.
+ */
+static void
+sync_cl_cache_merge(unsigned long start, unsigned long end, Slapi_Entry **entries, size_t count)
+{
+    size_t i = 0;
+
+    qsort(entries, count, sizeof(Slapi_Entry *), sync_cl_changenumber_cmp);
+
+    pthread_mutex_lock(&sync_cl_cache_lock);
+    if (sync_cl_last == SYNC_INVALID_CHANGENUM ||
+        start < sync_cl_first || start > sync_cl_last + 1) {
+        /* Not contiguous with the window: keep the most recent */
+        if (sync_cl_last != SYNC_INVALID_CHANGENUM && end < sync_cl_last) {
+            pthread_mutex_unlock(&sync_cl_cache_lock);
+            goto done;
+        }
+        sync_cl_cache_clear_nolock();
+        sync_cl_first = start;
+        sync_cl_last = start - 1;
+    }
+    if (end > sync_cl_last) {
+        /* Skip what the window already has */
+        while (i < count && sync_cl_changenumber(entries[i]) <= sync_cl_last) {
+            i++;
+        }
+        sync_cl_cache = (Slapi_Entry **)slapi_ch_realloc((char *)sync_cl_cache,
+                                                         (sync_cl_cache_count + count - i + 1) * sizeof(Slapi_Entry *));
+        for (; i < count && sync_cl_changenumber(entries[i]) == sync_cl_last + 1; i++) {
+            sync_cl_cache[sync_cl_cache_count++] = entries[i];
+            entries[i] = NULL;
+            sync_cl_last++;
+        }
+        if (sync_cl_cache_count > SYNC_CL_CACHE_SIZE) {
+            /* Drop the oldest quarter, the window starts at the first kept record */
+            size_t drop = sync_cl_cache_count - SYNC_CL_CACHE_SIZE + SYNC_CL_CACHE_SIZE / 4;
+            for (size_t j = 0; j < drop; j++) {
+                slapi_entry_free(sync_cl_cache[j]);
+            }
+            sync_cl_cache_count -= drop;
+            memmove(sync_cl_cache, sync_cl_cache + drop, sync_cl_cache_count * sizeof(Slapi_Entry *));
+            sync_cl_first = sync_cl_changenumber(sync_cl_cache[0]);
+        }
+    }
+    pthread_mutex_unlock(&sync_cl_cache_lock);
+
+done:
+    for (i = 0; i < count; i++) {
+        slapi_entry_free(entries[i]);
+    }
+}
+
+static int
+sync_cl_read_entry(Slapi_Entry *cl_entry, void *cb_data)
+{
+    Sync_ChangelogRead *cl_read = (Sync_ChangelogRead *)cb_data;
+
+    if (cl_read->cl_entries) {
+        if (cl_read->cl_count == cl_read->cl_size) {
+            cl_read->cl_size = cl_read->cl_size ? cl_read->cl_size * 2 : 64;
+            cl_read->cl_entries = (Slapi_Entry **)slapi_ch_realloc((char *)cl_read->cl_entries,
+                                                                   cl_read->cl_size * sizeof(Slapi_Entry *));
+        }
+        cl_read->cl_entries[cl_read->cl_count++] = slapi_entry_dup(cl_entry);
+    }
+    return sync_read_entry_from_changelog(cl_entry, cl_read->cl_cb_data);
+}
+
 int
 sync_refresh_update_content(Slapi_PBlock *pb, Sync_Cookie *client_cookie, Sync_Cookie *server_cookie)
 {
     Slapi_PBlock *seq_pb;
     char *filter;
     Sync_CallBackData cb_data;
+    Sync_ChangelogRead cl_read = {0};
+    unsigned long change_next;
     int rc = LDAP_SUCCESS;
     PR_ASSERT(client_cookie);
 
@@ -348,13 +527,27 @@ sync_refresh_update_content(Slapi_PBlock *pb, Sync_Cookie *client_cookie, Sync_C
 
     cb_data.cb_updates = (Sync_UpdateNode *)slapi_ch_calloc(chg_count, sizeof(Sync_UpdateNode));
 
-    seq_pb = slapi_pblock_new();
-    slapi_pblock_init(seq_pb);
-
     cb_data.orig_pb = pb;
     cb_data.change_start = client_cookie->cookie_change_info;
     cb_data.openldap_compat = server_cookie->openldap_compat;
 
+    /* The changes already read for another session are not searched again */
+    change_next = sync_cl_cache_replay(client_cookie->cookie_change_info + 1,
+                                       server_cookie->cookie_change_info,
+                                       &cb_data);
+    if (change_next > server_cookie->cookie_change_info) {
+        goto send_entries;
+    }
+    cl_read.cl_cb_data = &cb_data;
+    if (!server_cookie->openldap_compat) {
+        /* openldap compat filters the records, they do not fill the window */
+        cl_read.cl_size = 64;
+        cl_read.cl_entries = (Slapi_Entry **)slapi_ch_calloc(cl_read.cl_size, sizeof(Slapi_Entry *));
+    }
+
+    seq_pb = slapi_pblock_new();
+    slapi_pblock_init(seq_pb);
+
     /*
      * The client has already seen up to AND including change_info, so this should
      * should reflect that. originally was:
@@ -375,11 +568,11 @@ sync_refresh_update_content(Slapi_PBlock *pb, Sync_Cookie *client_cookie, Sync_C
     if (server_cookie->openldap_compat) {
         /* In openldap compat we only want items that have an entryuuid, else we can't sync them */
         filter = slapi_ch_smprintf("(&(changenumber>=%lu)(changenumber<=%lu)(" CL_ATTR_ENTRYUUID "=*))",
-                                   client_cookie->cookie_change_info + 1,
+                                   change_next,
                                    server_cookie->cookie_change_info);
     } else {
         filter = slapi_ch_smprintf("(&(changenumber>=%lu)(changenumber<=%lu))",
-                                   client_cookie->cookie_change_info + 1,
+                                   change_next,
                                    server_cookie->cookie_change_info);
     }
     slapi_search_internal_set_pb(
@@ -394,9 +587,23 @@ sync_refresh_update_content(Slapi_PBlock *pb, Sync_Cookie *client_cookie, Sync_C
         0);
 
     rc = slapi_search_internal_callback_pb(
-        seq_pb, &cb_data, NULL, sync_read_entry_from_changelog, NULL);
+        seq_pb, &cl_read, NULL, sync_cl_read_entry, NULL);
     slapi_pblock_destroy(seq_pb);
+    slapi_ch_free((void **)&filter);
+
+    if (cl_read.cl_entries) {
+        if (rc == LDAP_SUCCESS) {
+            sync_cl_cache_merge(change_next, server_cookie->cookie_change_info,
+                                cl_read.cl_entries, cl_read.cl_count);
+        } else {
+            for (size_t i = 0; i < cl_read.cl_count; i++) {
+                slapi_entry_free(cl_read.cl_entries[i]);
+            }
+        }
+        slapi_ch_free((void **)&cl_read.cl_entries);
+    }
 
+send_entries:
     /* Now send the deleted entries in a sync info message
      * and the modified entries as single entries
      */
@@ -404,12 +611,11 @@ sync_refresh_update_content(Slapi_PBlock *pb, Sync_Cookie *client_cookie, Sync_C
     sync_send_modified_entries(pb, cb_data.cb_updates, chg_count, server_cookie);
 
     sync_free_update_nodes(&cb_data.cb_updates, chg_count);
-    slapi_ch_free((void **)&filter);
     return (rc);
 }
 
 int
-sync_refresh_initial_content(Slapi_PBlock *pb, int sync_persist, PRThread *tid, Sync_Cookie *sc)
+sync_refresh_initial_content(Slapi_PBlock *pb, int sync_persist, SyncRequest *req, Sync_Cookie *sc)
 {
     /* the entries will be sent in the normal search process, but
      * - a control has to be sent with each entry
@@ -451,12 +657,12 @@ sync_refresh_initial_content(Slapi_PBlock *pb, int sync_persist, PRThread *tid,
         info = new_SyncOpInfo(SYNC_FLAG_ADD_STATE_CTRL |
                                   SYNC_FLAG_SEND_INTERMEDIATE |
                                   SYNC_FLAG_NO_RESULT,
-                              tid,
+                              req,
                               sc);
     } else {
         info = new_SyncOpInfo(SYNC_FLAG_ADD_STATE_CTRL |
                                   SYNC_FLAG_ADD_DONE_CTRL,
-                              tid,
+                              req,
                               sc);
     }
     sync_set_operation_extension(pb, info);
@@ -867,12 +1073,12 @@ senddone:
 }
 
 static SyncOpInfo *
-new_SyncOpInfo(int flag, PRThread *tid, Sync_Cookie *cookie)
+new_SyncOpInfo(int flag, SyncRequest *req, Sync_Cookie *cookie)
 {
     SyncOpInfo *spec = (SyncOpInfo *)slapi_ch_calloc(1, sizeof(SyncOpInfo));
     spec->send_flag = flag;
     spec->cookie = cookie;
-    spec->tid = tid;
+    spec->req = req;
 
     return spec;
 }
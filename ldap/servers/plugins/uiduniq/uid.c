@@ -44,6 +44,7 @@ int ldap_quote_filter_value(
 
 
 static int search_one_berval(Slapi_DN *baseDN, const char **attrNames, const struct berval *value, const char *requiredObjectClass, Slapi_DN *target, Slapi_DN **excludes);
+static int search_index(Slapi_DN *baseDN, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *target, Slapi_DN **excludes, int *result);
 
 /*
  * ISSUES:
@@ -83,6 +84,7 @@ typedef struct attr_uniqueness_config
     PRBool unique_in_all_subtrees;
     char *top_entry_oc;
     char *subtree_entries_oc;
+    PRBool use_index;
     struct attr_uniqueness_config *next;
 } attr_uniqueness_config_t;
 
@@ -92,6 +94,7 @@ typedef struct attr_uniqueness_config
 #define ATTR_UNIQUENESS_ACROSS_ALL_SUBTREES "uniqueness-across-all-subtrees"
 #define ATTR_UNIQUENESS_TOP_ENTRY_OC        "uniqueness-top-entry-oc"
 #define ATTR_UNIQUENESS_SUBTREE_ENTRIES_OC  "uniqueness-subtree-entries-oc"
+#define ATTR_UNIQUENESS_USE_INDEX           "uniqueness-use-index"
 
 static int getArguments(Slapi_PBlock *pb, char **attrName, char **markerObjectClass, char **requiredObjectClass);
 static struct attr_uniqueness_config *uniqueness_entry_to_config(Slapi_PBlock *pb, Slapi_Entry *config_entry);
@@ -140,6 +143,9 @@ free_uniqueness_config(struct attr_uniqueness_config *config)
  * uniqueness-top-entry-oc: organizationalUnit
  * uniqueness-subtree-entries-oc: person
  *
+ * With either, uniqueness-use-index: on looks the values up in the
+ * equality indexes instead of searching for them.
+ *
  * If both are present:
  *  - uniqueness-subtrees
  *  - uniqueness-top-entry-oc/uniqueness-subtree-entries-oc
@@ -277,6 +283,9 @@ uniqueness_entry_to_config(Slapi_PBlock *pb, Slapi_Entry *config_entry)
         /* enforce uniqueness, in the modified entry subtree, only to entries having this objectclass */
         tmp_config->subtree_entries_oc = slapi_entry_attr_get_charptr(config_entry, ATTR_UNIQUENESS_SUBTREE_ENTRIES_OC);
 
+        /* check the values in the equality indexes, by default it searches them */
+        tmp_config->use_index = slapi_entry_attr_get_bool(config_entry, ATTR_UNIQUENESS_USE_INDEX);
+
     } else {
         int result;
         char *attrName = NULL;
@@ -589,7 +598,7 @@ create_filter(const char **attributes, const struct berval *value, const char *r
  *   LDAP_OPERATIONS_ERROR - a server failure.
  */
 static int
-search(Slapi_DN *baseDN, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *target, Slapi_DN **excludes)
+search(Slapi_DN *baseDN, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *target, Slapi_DN **excludes, PRBool use_index)
 {
     int result;
 
@@ -606,6 +615,10 @@ search(Slapi_DN *baseDN, const char **attrNames, Slapi_Attr *attr, struct berval
     if ((Slapi_Attr *)NULL == attr && (struct berval **)NULL == values)
         return result;
 
+    if (use_index && search_index(baseDN, attrNames, attr, values, requiredObjectClass, target, excludes, &result)) {
+        return result;
+    }
+
     /*
    * Perform the search for each value provided
    *
@@ -758,6 +771,103 @@ search_one_berval(Slapi_DN *baseDN, const char **attrNames, const struct berval
     return result;
 }
 
+/* ------------------------------------------------------------ */
+/*
+ * search_index - with uniqueness-use-index, look the values up in the
+ *   equality indexes of the backend holding baseDN instead of searching
+ *   for them, one key lookup per value and attribute. The backend leaves
+ *   out the entries the search would not return (tombstones, subentries
+ *   and replication conflicts), so both give the same result.
+ *
+ * Return:
+ *   1 - the index told, *result is set as search_one_berval would set it
+ *   0 - an attribute is not indexed for equality, a value is over the
+ *     idlistscanlimit, or baseDN spans several backends: search instead
+ */
+static int
+search_index(Slapi_DN *baseDN, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *target, Slapi_DN **excludes, int *result)
+{
+    Slapi_Backend *be = slapi_be_select(baseDN);
+    Slapi_Backend *other = NULL;
+    struct berval **attr_values = NULL;
+    char *cookie = NULL;
+    int indexed = 1;
+
+    if (be == NULL) {
+        return 0;
+    }
+    /* The entries of a sub suffix are in the indexes of another backend */
+    for (other = slapi_get_first_backend(&cookie); other; other = slapi_get_next_backend(cookie)) {
+        const Slapi_DN *suffix = slapi_be_getsuffix(other, 0);
+
+        if (other != be && suffix && slapi_sdn_issuffix(suffix, baseDN)) {
+            slapi_ch_free_string(&cookie);
+            return 0;
+        }
+    }
+    slapi_ch_free_string(&cookie);
+
+    if (attr) {
+        slapi_attr_get_bervals_copy(attr, &attr_values);
+        values = attr_values;
+    }
+
+    *result = LDAP_SUCCESS;
+    for (size_t i = 0; attrNames[i] && indexed && *result == LDAP_SUCCESS; i++) {
+        back_info_index_lookup lookup = {0};
+
+        lookup.type = attrNames[i];
+        lookup.values = values;
+        if (slapi_back_ctrl_info(be, BACK_INFO_INDEX_LOOKUP, &lookup) != 0 || lookup.unindexed) {
+            indexed = 0;
+            break;
+        }
+        /*
+         * Any entry found in the subtree with the required objectclass is a
+         * Constraint Violation, unless it is the target entry or excluded.
+         */
+        for (size_t j = 0; lookup.entries && lookup.entries[j]; j++) {
+            Slapi_Entry *e = lookup.entries[j];
+            Slapi_DN *entry_dn = slapi_entry_get_sdn(e);
+            int excluded = 0;
+
+#ifdef DEBUG
+            slapi_log_err(SLAPI_LOG_PLUGIN, plugin_name,
+                          "search_index - INDEX entry dn=%s\n", slapi_entry_get_dn(e));
+#endif
+            if (!slapi_sdn_issuffix(entry_dn, baseDN) ||
+                (target && slapi_sdn_compare(entry_dn, target) == 0) ||
+                (requiredObjectClass && !slapi_entry_attr_hasvalue(e, SLAPI_ATTR_OBJECTCLASS, requiredObjectClass))) {
+                continue;
+            }
+            for (size_t k = 0; excludes && excludes[k]; k++) {
+                if (slapi_sdn_issuffix(entry_dn, excludes[k])) {
+                    excluded = 1;
+                    break;
+                }
+            }
+            if (!excluded) {
+                *result = LDAP_CONSTRAINT_VIOLATION;
+                break;
+            }
+        }
+        for (size_t j = 0; lookup.entries && lookup.entries[j]; j++) {
+            slapi_entry_free(lookup.entries[j]);
+        }
+        slapi_ch_free((void **)&lookup.entries);
+    }
+
+    if (attr_values) {
+        ber_bvecfree(attr_values);
+    }
+
+    slapi_log_err(SLAPI_LOG_PLUGIN, plugin_name,
+                  "search_index - Index lookup under %s %s (result=%d)\n", slapi_sdn_get_dn(baseDN),
+                  indexed ? "complete" : "not usable, searching", *result);
+
+    return indexed;
+}
+
 /* ------------------------------------------------------------ */
 /*
  * searchAllSubtrees - search all subtrees in argv for entries
@@ -775,7 +885,7 @@ search_one_berval(Slapi_DN *baseDN, const char **attrNames, const struct berval
  *   LDAP_OPERATIONS_ERROR - a server failure.
  */
 static int
-searchAllSubtrees(Slapi_DN **subtrees, Slapi_DN **exclude_subtrees, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *destinationSDN, Slapi_DN *sourceSDN, PRBool unique_in_all_subtrees)
+searchAllSubtrees(Slapi_DN **subtrees, Slapi_DN **exclude_subtrees, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *destinationSDN, Slapi_DN *sourceSDN, PRBool unique_in_all_subtrees, PRBool use_index)
 {
     int result = LDAP_SUCCESS;
     int i;
@@ -828,7 +938,7 @@ searchAllSubtrees(Slapi_DN **subtrees, Slapi_DN **exclude_subtrees, const char *
      * worry about that here.
      */
         if (unique_in_all_subtrees || slapi_sdn_issuffix(destinationSDN, sufdn)) {
-            result = search(sufdn, attrNames, attr, values, requiredObjectClass, sourceSDN, exclude_subtrees);
+            result = search(sufdn, attrNames, attr, values, requiredObjectClass, sourceSDN, exclude_subtrees, use_index);
             if (result)
                 break;
         }
@@ -908,7 +1018,7 @@ getArguments(Slapi_PBlock *pb, char **attrName, char **markerObjectClass, char *
  *   LDAP_OPERATIONS_ERROR - a server failure.
  */
 static int
-findSubtreeAndSearch(Slapi_DN *destinationSDN, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *sourceSDN, const char *markerObjectClass, Slapi_DN **excludes)
+findSubtreeAndSearch(Slapi_DN *destinationSDN, const char **attrNames, Slapi_Attr *attr, struct berval **values, const char *requiredObjectClass, Slapi_DN *sourceSDN, const char *markerObjectClass, Slapi_DN **excludes, PRBool use_index)
 {
     int result = LDAP_SUCCESS;
     Slapi_PBlock *spb = NULL;
@@ -924,7 +1034,7 @@ findSubtreeAndSearch(Slapi_DN *destinationSDN, const char **attrNames, Slapi_Att
            * to have the attribute already.
            */
             result = search(curpar, attrNames, attr, values, requiredObjectClass,
-                            sourceSDN, excludes);
+                            sourceSDN, excludes, use_index);
             break;
         }
         newpar = slapi_sdn_new();
@@ -1041,11 +1151,12 @@ preop_add(Slapi_PBlock *pb)
                 /* Subtree defined by location of marker object class */
                 result = findSubtreeAndSearch(targetSDN, attrNames, attr, NULL,
                                               requiredObjectClass, targetSDN,
-                                              markerObjectClass, config->exclude_subtrees);
+                                              markerObjectClass, config->exclude_subtrees, config->use_index);
             } else {
                 /* Subtrees listed on invocation line */
                 result = searchAllSubtrees(config->subtrees, config->exclude_subtrees, attrNames, attr, NULL,
-                                           requiredObjectClass, targetSDN, targetSDN, config->unique_in_all_subtrees);
+                                           requiredObjectClass, targetSDN, targetSDN, config->unique_in_all_subtrees,
+                                           config->use_index);
             }
             if (result != LDAP_SUCCESS) {
                 break;
@@ -1214,11 +1325,12 @@ preop_modify(Slapi_PBlock *pb)
             /* Subtree defined by location of marker object class */
             result = findSubtreeAndSearch(targetSDN, attrNames, NULL,
                                           mod->mod_bvalues, requiredObjectClass,
-                                          targetSDN, markerObjectClass, config->exclude_subtrees);
+                                          targetSDN, markerObjectClass, config->exclude_subtrees, config->use_index);
         } else {
             /* Subtrees listed on invocation line */
             result = searchAllSubtrees(config->subtrees, config->exclude_subtrees, attrNames, NULL,
-                                       mod->mod_bvalues, requiredObjectClass, targetSDN, targetSDN, config->unique_in_all_subtrees);
+                                       mod->mod_bvalues, requiredObjectClass, targetSDN, targetSDN, config->unique_in_all_subtrees,
+                                       config->use_index);
         }
     }
     END
@@ -1393,11 +1505,12 @@ preop_modrdn(Slapi_PBlock *pb)
                 /* Subtree defined by location of marker object class */
                 result = findSubtreeAndSearch(destinationSDN, attrNames, attr, NULL,
                                               requiredObjectClass, sourceSDN,
-                                              markerObjectClass, config->exclude_subtrees);
+                                              markerObjectClass, config->exclude_subtrees, config->use_index);
             } else {
                 /* Subtrees listed on invocation line */
                 result = searchAllSubtrees(config->subtrees, config->exclude_subtrees, attrNames, attr, NULL,
-                                           requiredObjectClass, destinationSDN, sourceSDN, config->unique_in_all_subtrees);
+                                           requiredObjectClass, destinationSDN, sourceSDN, config->unique_in_all_subtrees,
+                                           config->use_index);
             }
             if (result != LDAP_SUCCESS) {
                 break;
@@ -15,6 +15,7 @@
 
 #include "slap.h"
 #include <plhash.h>
+#include <pthread.h>
 
 /*
  * Note: if both the oid2asi and name2asi locks are acquired at the
@@ -49,6 +50,37 @@ static PLHashTable *oid2asi_tmp = NULL;
 static PLHashTable *name2asi_tmp = NULL;
 static asyntaxinfo *global_at_tmp = NULL;
 
+/*
+ * Lookups don't use the hash tables above directly: they use an immutable
+ * snapshot of them, so readers take no lock.  Every change of the tables
+ * marks the snapshot stale, and the snapshot is rebuilt by a reader once
+ * enough lookups went to the locked tables meanwhile (the schema is loaded
+ * one attribute at a time at startup, rebuilding it after each one would
+ * be quadratic).
+ *
+ * A snapshot holds a reference on every asyntaxinfo it contains, so they
+ * outlive their deletion from the schema as long as a reader may find
+ * them.  Each thread keeps a reference on the last snapshot it used and
+ * only touches the snapshot refcount (and lock) when a new one has been
+ * published.
+ */
+typedef struct asyntax_snapshot
+{
+    uint64_t ass_refcnt;
+    PLHashTable *ass_name2asi;
+    PLHashTable *ass_oid2asi;
+    struct asyntaxinfo **ass_asi; /* one reference held per table entry */
+    size_t ass_count;
+} asyntax_snapshot;
+
+static asyntax_snapshot *asi_snapshot = NULL;
+/* serializes the rebuilds and the acquisition of a new snapshot */
+static Slapi_Mutex *asi_snapshot_lock = NULL;
+static pthread_key_t asi_snapshot_key;
+static int32_t asi_snapshot_stale = 1;
+static int32_t asi_snapshot_misses = 0;
+#define ASI_SNAPSHOT_REBUILD_MISSES 64
+
 static int asi_locking = 1;
 #define AS_LOCK_READ(l)         \
     if (asi_locking) {          \
@@ -77,7 +109,7 @@ static void attr_syntax_delete_no_lock(struct asyntaxinfo *asip,
 static struct asyntaxinfo *attr_syntax_get_by_oid_locking_optional(const char *oid, PRBool use_lock, PRUint32 schema_flags);
 static void attr_syntax_insert(struct asyntaxinfo *asip);
 static void attr_syntax_insert_tmp(struct asyntaxinfo *asip);
-static void attr_syntax_remove(struct asyntaxinfo *asip);
+static void attr_syntax_remove(struct asyntaxinfo **list, struct asyntaxinfo *asip);
 
 #ifdef ATTR_LDAP_DEBUG
 static void attr_syntax_print(void);
@@ -153,6 +185,199 @@ attr_syntax_new(void)
     return (struct asyntaxinfo *)slapi_ch_calloc(1, sizeof(struct asyntaxinfo));
 }
 
+/*
+ * Mark the current snapshot as outdated.  Called with the tables write
+ * locked, before changing them.
+ */
+static void
+attr_syntax_snapshot_invalidate(void)
+{
+    slapi_atomic_store_32(&asi_snapshot_stale, 1, __ATOMIC_RELEASE);
+}
+
+static void
+attr_syntax_snapshot_release(asyntax_snapshot *snap)
+{
+    size_t i;
+
+    if (NULL == snap || 0 != slapi_atomic_decr_64(&(snap->ass_refcnt), __ATOMIC_ACQ_REL)) {
+        return;
+    }
+    for (i = 0; i < snap->ass_count; i++) {
+        attr_syntax_return(snap->ass_asi[i]);
+    }
+    PL_HashTableDestroy(snap->ass_name2asi);
+    PL_HashTableDestroy(snap->ass_oid2asi);
+    slapi_ch_free((void **)&snap->ass_asi);
+    slapi_ch_free((void **)&snap);
+}
+
+static void
+attr_syntax_snapshot_thread_release(void *arg)
+{
+    attr_syntax_snapshot_release((asyntax_snapshot *)arg);
+}
+
+struct snapshot_copy_arg
+{
+    asyntax_snapshot *snap;
+    PLHashTable *ht;
+};
+
+static PRIntn
+attr_syntax_snapshot_copy_entry(PLHashEntry *he, PRIntn i __attribute__((unused)), void *arg)
+{
+    struct snapshot_copy_arg *sca = (struct snapshot_copy_arg *)arg;
+    struct asyntaxinfo *asi = (struct asyntaxinfo *)he->value;
+
+    /* the key points into the asi, which the snapshot keeps alive */
+    PL_HashTableAdd(sca->ht, he->key, asi);
+    slapi_atomic_incr_64(&(asi->asi_refcnt), __ATOMIC_RELEASE);
+    sca->snap->ass_asi[sca->snap->ass_count++] = asi;
+
+    return HT_ENUMERATE_NEXT;
+}
+
+/*
+ * Copy the current tables into a new snapshot.  The caller holds the
+ * tables read locked.
+ */
+static asyntax_snapshot *
+attr_syntax_snapshot_new(void)
+{
+    asyntax_snapshot *snap;
+    struct snapshot_copy_arg sca;
+
+    if (NULL == name2asi || NULL == oid2asi) {
+        return NULL;
+    }
+    snap = (asyntax_snapshot *)slapi_ch_calloc(1, sizeof(asyntax_snapshot));
+    snap->ass_refcnt = 1; /* the published one */
+    snap->ass_name2asi = PL_NewHashTable(2047, hashNocaseString,
+                                         hashNocaseCompare,
+                                         PL_CompareValues, 0, 0);
+    snap->ass_oid2asi = PL_NewHashTable(2047, hashNocaseString,
+                                        hashNocaseCompare,
+                                        PL_CompareValues, 0, 0);
+    snap->ass_asi = (struct asyntaxinfo **)slapi_ch_calloc(
+        name2asi->nentries + oid2asi->nentries + 1, sizeof(struct asyntaxinfo *));
+    if (NULL == snap->ass_name2asi || NULL == snap->ass_oid2asi) {
+        attr_syntax_snapshot_release(snap);
+        return NULL;
+    }
+
+    sca.snap = snap;
+    sca.ht = snap->ass_name2asi;
+    PL_HashTableEnumerateEntries(name2asi, attr_syntax_snapshot_copy_entry, &sca);
+    sca.ht = snap->ass_oid2asi;
+    PL_HashTableEnumerateEntries(oid2asi, attr_syntax_snapshot_copy_entry, &sca);
+
+    return snap;
+}
+
+/*
+ * Publish a snapshot of the current tables if the previous one is stale.
+ * Returns 0 if the published snapshot is up to date.
+ */
+static int
+attr_syntax_snapshot_rebuild(void)
+{
+    asyntax_snapshot *snap, *old = NULL;
+    int rc = 0;
+
+    slapi_lock_mutex(asi_snapshot_lock);
+    if (slapi_atomic_load_32(&asi_snapshot_stale, __ATOMIC_ACQUIRE)) {
+        AS_LOCK_READ(oid2asi_lock);
+        AS_LOCK_READ(name2asi_lock);
+        if ((snap = attr_syntax_snapshot_new())) {
+            old = asi_snapshot;
+            __atomic_store_n(&asi_snapshot, snap, __ATOMIC_RELEASE);
+            slapi_atomic_store_32(&asi_snapshot_misses, 0, __ATOMIC_RELAXED);
+            /* only cleared once the new snapshot is visible */
+            slapi_atomic_store_32(&asi_snapshot_stale, 0, __ATOMIC_RELEASE);
+        } else {
+            rc = 1;
+        }
+        AS_UNLOCK_READ(name2asi_lock);
+        AS_UNLOCK_READ(oid2asi_lock);
+    }
+    slapi_unlock_mutex(asi_snapshot_lock);
+
+    /* threads still using the old one keep it alive */
+    attr_syntax_snapshot_release(old);
+
+    return rc;
+}
+
+/*
+ * Return the snapshot the calling thread should use, or NULL if the
+ * lookup must go to the locked tables.  The thread keeps its reference
+ * on the snapshot until a newer one is published, so the caller does not
+ * have to release it.
+ */
+static asyntax_snapshot *
+attr_syntax_snapshot_acquire(void)
+{
+    asyntax_snapshot *cached, *current;
+
+    if (NULL == asi_snapshot_lock) {
+        return NULL;
+    }
+    if (slapi_atomic_load_32(&asi_snapshot_stale, __ATOMIC_ACQUIRE)) {
+        if (slapi_atomic_incr_32(&asi_snapshot_misses, __ATOMIC_RELAXED) < ASI_SNAPSHOT_REBUILD_MISSES ||
+            attr_syntax_snapshot_rebuild()) {
+            return NULL;
+        }
+    }
+
+    current = __atomic_load_n(&asi_snapshot, __ATOMIC_ACQUIRE);
+    cached = (asyntax_snapshot *)pthread_getspecific(asi_snapshot_key);
+    if (cached == current) {
+        return cached;
+    }
+
+    /* a new snapshot was published, move to it */
+    slapi_lock_mutex(asi_snapshot_lock);
+    current = asi_snapshot;
+    if (current) {
+        slapi_atomic_incr_64(&(current->ass_refcnt), __ATOMIC_RELEASE);
+    }
+    slapi_unlock_mutex(asi_snapshot_lock);
+
+    pthread_setspecific(asi_snapshot_key, current);
+    attr_syntax_snapshot_release(cached);
+
+    return current;
+}
+
+/*
+ * Lock free lookup of a name (then of an oid) or of an oid only.
+ * Returns 0 and a referenced asi (or NULL if not found) on success, and
+ * -1 if there is no up to date snapshot and the tables must be used.
+ */
+static int
+attr_syntax_snapshot_get(const char *name, PRBool by_name, struct asyntaxinfo **asip)
+{
+    asyntax_snapshot *snap = attr_syntax_snapshot_acquire();
+    struct asyntaxinfo *asi = NULL;
+
+    if (NULL == snap) {
+        return -1;
+    }
+    if (by_name) {
+        asi = (struct asyntaxinfo *)PL_HashTableLookup_const(snap->ass_name2asi, name);
+    }
+    if (NULL == asi) {
+        asi = (struct asyntaxinfo *)PL_HashTableLookup_const(snap->ass_oid2asi, name);
+    }
+    if (asi) {
+        slapi_atomic_incr_64(&(asi->asi_refcnt), __ATOMIC_RELEASE);
+    }
+    *asip = asi;
+
+    return 0;
+}
+
 /*
  * Given an OID, return the syntax info.  If there is more than one
  * attribute syntax with the same OID (i.e. aliases), the first one
@@ -184,6 +409,10 @@ attr_syntax_get_by_oid_locking_optional(const char *oid, PRBool use_lock, PRUint
     PLHashTable *ht = oid2asi;
     int using_tmp_ht = 0;
 
+    if (use_lock && !(schema_flags & DSE_SCHEMA_LOCKED) &&
+        0 == attr_syntax_snapshot_get(oid, PR_FALSE, &asi)) {
+        return asi;
+    }
     if (schema_flags & DSE_SCHEMA_LOCKED) {
         ht = oid2asi_tmp;
         using_tmp_ht = 1;
@@ -232,6 +461,7 @@ attr_syntax_add_by_oid(const char *oid, struct asyntaxinfo *a, PRUint32 schema_f
             AS_LOCK_WRITE(oid2asi_lock);
         }
 
+        attr_syntax_snapshot_invalidate();
         PL_HashTableAdd(oid2asi, oid, a);
 
         if (lock) {
@@ -261,8 +491,8 @@ attr_syntax_get_by_name_with_default(const char *name)
     asi = attr_syntax_get_by_name_locking_optional(name, PR_TRUE, 0);
     if (asi == NULL)
         asi = attr_syntax_get_by_name(ATTR_WITH_OCTETSTRING_SYNTAX, 0);
-    if (asi == NULL)
-        asi = default_asi;
+    if (asi == NULL && (asi = default_asi) != NULL)
+        slapi_atomic_incr_64(&(asi->asi_refcnt), __ATOMIC_RELEASE);
     return asi;
 }
 
@@ -281,6 +511,10 @@ attr_syntax_get_by_name_locking_optional(const char *name, PRBool use_lock, PRUi
     PLHashTable *ht = name2asi;
     int using_tmp_ht = 0;
 
+    if (use_lock && !(schema_flags & DSE_SCHEMA_LOCKED) &&
+        0 == attr_syntax_snapshot_get(name, PR_TRUE, &asi)) {
+        return asi;
+    }
     if (schema_flags & DSE_SCHEMA_LOCKED) {
         ht = name2asi_tmp;
         using_tmp_ht = 1;
@@ -354,9 +588,10 @@ attr_syntax_exist_by_name_nolock(char *name) {
 
 /*
  * Give up a reference to an asi.
- * If the asi has been marked for delete, free it.  This would be a bit
- * easier if we could upgrade a read lock to a write one... but NSPR does
- * not support that paradigm.
+ * The schema itself holds a reference on each asi it contains, so the last
+ * one is dropped only once the asi has been deleted from the tables and
+ * from the global list, and is no longer part of any snapshot: nobody can
+ * find it anymore and it can be freed without taking a lock.
  */
 void
 attr_syntax_return(struct asyntaxinfo *asi)
@@ -365,39 +600,14 @@ attr_syntax_return(struct asyntaxinfo *asi)
 }
 
 void
-attr_syntax_return_locking_optional(struct asyntaxinfo *asi, PRBool use_lock)
+attr_syntax_return_locking_optional(struct asyntaxinfo *asi, PRBool use_lock __attribute__((unused)))
 {
-    int locked = 0;
-    if (use_lock) {
-        AS_LOCK_READ(name2asi_lock);
-        locked = 1;
-    }
     if (NULL != asi) {
-        PRBool delete_it = PR_FALSE;
         if (0 == slapi_atomic_decr_64(&(asi->asi_refcnt), __ATOMIC_ACQ_REL)) {
-            delete_it = asi->asi_marked_for_delete;
-        }
-
-        if (delete_it) {
-            if (asi->asi_marked_for_delete) { /* one final check */
-                if (use_lock) {
-                    AS_UNLOCK_READ(name2asi_lock);
-                    AS_LOCK_WRITE(name2asi_lock);
-                }
-                /* ref count is 0 and it's flagged for
-                 * deletion, so it's safe to free now */
-                attr_syntax_remove(asi);
-                attr_syntax_free(asi);
-                if (use_lock) {
-                    AS_UNLOCK_WRITE(name2asi_lock);
-                    locked = 0;
-                }
-            }
+            PR_ASSERT(asi->asi_marked_for_delete);
+            attr_syntax_free(asi);
         }
     }
-    if (locked) {
-        AS_UNLOCK_READ(name2asi_lock);
-    }
 }
 
 /*
@@ -431,6 +641,7 @@ attr_syntax_add_by_name(struct asyntaxinfo *a, PRUint32 schema_flags, int lock)
         if (lock) {
             AS_LOCK_WRITE(name2asi_lock);
         }
+        attr_syntax_snapshot_invalidate();
         /* insert the attr into the global linked list */
         attr_syntax_insert(a);
 
@@ -486,6 +697,8 @@ attr_syntax_delete_no_lock(struct asyntaxinfo *asi,
 
     if (schema_flags & DSE_SCHEMA_LOCKED) {
         using_tmp_ht = 1;
+    } else {
+        attr_syntax_snapshot_invalidate();
     }
     if (oid2asi && remove_from_oidtable) {
         if (using_tmp_ht) {
@@ -508,15 +721,12 @@ attr_syntax_delete_no_lock(struct asyntaxinfo *asi,
                 PL_HashTableRemove(ht, asi->asi_aliases[i]);
             }
         }
-        if (slapi_atomic_load_64(&(asi->asi_refcnt), __ATOMIC_ACQUIRE) > 0) {
+        if (!asi->asi_marked_for_delete) {
             asi->asi_marked_for_delete = PR_TRUE;
-        } else {
-            /* This is ok, but the correct thing is to call delete first,
-             * then to call return.  The last return will then take care of
-             * the free.  The only way this free would happen here is if
-             * you return the syntax before calling delete. */
-            attr_syntax_remove(asi);
-            attr_syntax_free(asi);
+            attr_syntax_remove(using_tmp_ht ? &global_at_tmp : &global_at, asi);
+            /* Drop the reference of the schema.  If the caller (or a
+             * snapshot) still holds one, the last return frees it. */
+            attr_syntax_return(asi);
         }
     }
 }
@@ -786,8 +996,8 @@ attr_syntax_get_plugin_by_name_with_default(const char *type)
          * attribute type that has that syntax.
          */
         asi = attr_syntax_get_by_name(ATTR_WITH_OCTETSTRING_SYNTAX, 0);
-        if (asi == NULL)
-            asi = default_asi;
+        if (asi == NULL && (asi = default_asi) != NULL)
+            slapi_atomic_incr_64(&(asi->asi_refcnt), __ATOMIC_RELEASE);
     }
     if (NULL != asi) {
         plugin = asi->asi_plugin;
@@ -854,7 +1064,7 @@ attr_syntax_insert_tmp(struct asyntaxinfo *asip)
 }
 
 static void
-attr_syntax_remove(struct asyntaxinfo *asip)
+attr_syntax_remove(struct asyntaxinfo **list, struct asyntaxinfo *asip)
 {
     struct asyntaxinfo *prev, *next;
 
@@ -862,15 +1072,14 @@ attr_syntax_remove(struct asyntaxinfo *asip)
     next = asip->asi_next;
     if (prev) {
         prev->asi_next = next;
-        if (next) {
-            next->asi_prev = prev;
-        }
-    } else {
-        if (next) {
-            next->asi_prev = NULL;
-        }
-        global_at = next;
+    } else if (*list == asip) {
+        *list = next;
     }
+    if (next) {
+        next->asi_prev = prev;
+    }
+    asip->asi_prev = NULL;
+    asip->asi_next = NULL;
 }
 
 /*
@@ -947,6 +1156,9 @@ attr_syntax_add(struct asyntaxinfo *asip, PRUint32 schema_flags)
     /* ditto for the override one */
     asip->asi_flags &= ~SLAPI_ATTR_FLAG_OVERRIDE;
 
+    /* the schema holds a reference until the attribute is deleted */
+    slapi_atomic_incr_64(&(asip->asi_refcnt), __ATOMIC_RELEASE);
+
     attr_syntax_add_by_oid(asip->asi_oid, asip, schema_flags, !nolock);
     attr_syntax_add_by_name(asip, schema_flags, !nolock);
 
@@ -979,6 +1191,10 @@ attr_syntax_create_default(const char *name, const char *oid, const char *syntax
                             &default_asi);
     if (rc == 0 && default_asi->asi_plugin == 0)
         default_asi->asi_plugin = attr_syntax_default_plugin(syntax);
+    if (rc == 0) {
+        /* never freed, lookups falling back on it take a reference too */
+        slapi_atomic_incr_64(&(default_asi->asi_refcnt), __ATOMIC_RELEASE);
+    }
     return (rc);
 }
 
@@ -1322,6 +1538,7 @@ attr_syntax_enumerate_attrs(AttrEnumFunc aef, void *arg, PRBool writelock)
     if (writelock) {
         AS_LOCK_WRITE(oid2asi_lock);
         AS_LOCK_WRITE(name2asi_lock);
+        attr_syntax_snapshot_invalidate();
     } else {
         AS_LOCK_READ(oid2asi_lock);
         AS_LOCK_READ(name2asi_lock);
@@ -1463,6 +1680,13 @@ attr_syntax_init(void)
                           "slapi_new_rwlock() for oid2asi lock failed\n");
             return 1;
         }
+        /* Without snapshot, lookups simply keep using the locked tables */
+        if (pthread_key_create(&asi_snapshot_key, attr_syntax_snapshot_thread_release) != 0) {
+            slapi_log_err(SLAPI_LOG_ERR, "attr_syntax_init",
+                          "pthread_key_create() for the schema snapshot failed\n");
+        } else {
+            asi_snapshot_lock = slapi_new_mutex();
+        }
     }
 
     if (!oid2asi_tmp) {
@@ -1641,14 +1865,24 @@ attr_syntax_swap_ht()
 {
     struct asyntaxinfo *next;
 
+    attr_syntax_snapshot_invalidate();
+
     /* Remove the old hash tables */
     PL_HashTableDestroy(name2asi);
     PL_HashTableDestroy(oid2asi);
 
-    /* Free the global attr linked list */
+    /*
+     * Drop the global attr linked list.  The attributes still referenced
+     * (by the current snapshot for instance) are freed by their last user.
+     */
     while (global_at) {
         next = global_at->asi_next;
-        attr_syntax_free(global_at);
+        global_at->asi_prev = NULL;
+        global_at->asi_next = NULL;
+        if (!global_at->asi_marked_for_delete) {
+            global_at->asi_marked_for_delete = PR_TRUE;
+            attr_syntax_return(global_at);
+        }
         global_at = next;
     }
 
@@ -17,6 +17,16 @@
 
 static const char *sourcefile = "ancestorid.c";
 
+/*
+ * Set while the subtreepath index is in use: ancestorid is no longer
+ * maintained, it is rebuilt when subtreepath is disabled again.
+ */
+#define ANCESTORID_STALE_KEY "#stale"
+#define ANCESTORID_REBUILD_BATCH 1000 /* entries indexed per transaction on rebuild */
+#define ANCESTORID_MAX_DEPTH 1024      /* guards against loops in a broken entryrdn */
+
+static int ancestorid_is_marked_stale(backend *be);
+
 static int
 ancestorid_addordel(
     backend *be,
@@ -347,18 +357,23 @@ out:
     return ret;
 }
 
-int
-ldbm_ancestorid_read_ext(
+static int
+ancestorid_read(
     backend *be,
     back_txn *txn,
     ID id,
     IDList **idl,
-    int allidslimit)
+    int allidslimit,
+    int stale)
 {
     int ret = 0;
     struct berval bv;
     char keybuf[24];
 
+    if (stale) {
+        return ldbm_subtreepath_read_descendants(be, txn, id, idl, allidslimit);
+    }
+
     bv.bv_val = keybuf;
     bv.bv_len = PR_snprintf(keybuf, sizeof(keybuf), "%lu", (u_long)id);
 
@@ -367,6 +382,18 @@ ldbm_ancestorid_read_ext(
     return ret;
 }
 
+int
+ldbm_ancestorid_read_ext(
+    backend *be,
+    back_txn *txn,
+    ID id,
+    IDList **idl,
+    int allidslimit)
+{
+    return ancestorid_read(be, txn, id, idl, allidslimit, ldbm_ancestorid_is_stale(be));
+}
+
+/* Used by the command line tools too, which do not start the instance */
 int
 ldbm_ancestorid_read(
     backend *be,
@@ -374,5 +401,237 @@ ldbm_ancestorid_read(
     ID id,
     IDList **idl)
 {
-    return ldbm_ancestorid_read_ext(be, txn, id, idl, 0);
+    return ancestorid_read(be, txn, id, idl, 0, ancestorid_is_marked_stale(be));
+}
+
+static int
+ancestorid_stale_op(backend *be, dbi_db_t *db, struct attrinfo *ai, int flags)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    dbi_val_t key = {0};
+    back_txn txn;
+    int ret;
+
+    dblayer_value_set_buffer(be, &key, ANCESTORID_STALE_KEY, sizeof(ANCESTORID_STALE_KEY));
+    dblayer_txn_init(li, &txn);
+    ret = dblayer_txn_begin(be, NULL, &txn);
+    if (ret) {
+        return ret;
+    }
+    if (flags & BE_INDEX_ADD) {
+        ret = idl_insert_key(be, db, &key, 1, &txn, ai, NULL);
+    } else {
+        ret = idl_delete_key(be, db, &key, 1, &txn, ai);
+    }
+    if (ret) {
+        dblayer_txn_abort(be, &txn);
+    } else {
+        ret = dblayer_txn_commit(be, &txn);
+    }
+    return ret;
+}
+
+/* Reads the marker from the index file, if there is one */
+static int
+ancestorid_is_marked_stale(backend *be)
+{
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    dbi_val_t key = {0};
+    dbi_val_t data = {0};
+    int ret;
+
+    ainfo_get(be, (char *)LDBM_ANCESTORID_STR, &ai);
+    if (ai == NULL || dblayer_get_index_file(be, ai, &db, 0) != 0) {
+        return 0;
+    }
+    dblayer_value_set_buffer(be, &key, ANCESTORID_STALE_KEY, sizeof(ANCESTORID_STALE_KEY));
+    dblayer_value_init(be, &data);
+    ret = dblayer_db_op(be, db, NULL, DBI_OP_GET, &key, &data);
+    dblayer_value_free(be, &data);
+    dblayer_release_index_file(be, ai, db);
+    return ret == 0;
+}
+
+/* Indexes an entry under all its ancestors, found in entryrdn */
+static int
+ancestorid_index_ancestors(backend *be, dbi_db_t *db, struct attrinfo *ai, const char *suffix, ID id, back_txn *txn)
+{
+    ID node_id = id;
+    int ret = 0;
+
+    for (size_t depth = 0; ret == 0; depth++) {
+        char *prdn = NULL;
+        ID pid = 0;
+        int allids = IDL_INSERT_NORMAL;
+
+        if (depth == ANCESTORID_MAX_DEPTH) {
+            ret = LDAP_OPERATIONS_ERROR;
+            break;
+        }
+        ret = entryrdn_get_parent(be, suffix, node_id, &prdn, &pid, txn);
+        slapi_ch_free_string(&prdn);
+        if (ret || pid == node_id) {
+            /* reached the suffix */
+            break;
+        }
+        ret = ancestorid_addordel(be, db, pid, id, txn, ai, BE_INDEX_ADD, &allids);
+        node_id = pid;
+    }
+    return ret;
+}
+
+/*
+ * Builds the index again from entryrdn, in batches of transactions. The
+ * marker is kept until the end, so that an interrupted rebuild is resumed
+ * at the next start.
+ */
+static int
+ancestorid_rebuild(backend *be)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    const Slapi_DN *suffix = slapi_be_getsuffix(be, 0);
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    IDList *idl = NULL;
+    back_txn txn;
+    ID suffixid = 0;
+    NIDS done = 0;
+    int txn_open = 0;
+    int ret;
+
+    ainfo_get(be, (char *)LDBM_ANCESTORID_STR, &ai);
+    if (ai == NULL || suffix == NULL) {
+        return LDAP_OPERATIONS_ERROR;
+    }
+    ret = dblayer_erase_index_file(be, ai, PR_TRUE, 0);
+    if (ret == 0) {
+        ret = dblayer_get_index_file(be, ai, &db, DBOPEN_CREATE);
+    }
+    if (ret) {
+        ldbm_nasty("ancestorid_rebuild", sourcefile, 13150, ret);
+        return ret;
+    }
+    ret = ancestorid_stale_op(be, db, ai, BE_INDEX_ADD);
+    if (ret) {
+        goto out;
+    }
+
+    ret = entryrdn_index_read(be, suffix, &suffixid, NULL);
+    if (ret == 0) {
+        ret = entryrdn_get_subordinates(be, suffix, suffixid, &idl, NULL, 0);
+    }
+    if (ret == DBI_RC_NOTFOUND) {
+        /* empty backend, or no subordinates */
+        ret = 0;
+    } else if (ret) {
+        goto out;
+    }
+
+    slapi_log_err(SLAPI_LOG_INFO, "ancestorid_rebuild", "%s: indexing the ancestors of %lu entries\n",
+                  inst->inst_name, (u_long)IDL_NIDS(idl));
+    dblayer_txn_init(li, &txn);
+    for (NIDS i = 0; ret == 0 && i < IDL_NIDS(idl); i++) {
+        char *dn = NULL;
+        int tombstone;
+
+        /* tombstones are not in ancestorid */
+        ret = entryrdn_lookup_dn(be, slapi_sdn_get_ndn(suffix), idl->b_ids[i], &dn, NULL, NULL);
+        tombstone = (ret == 0 && dn && slapi_is_special_rdn(dn, RDN_IS_TOMBSTONE));
+        slapi_ch_free_string(&dn);
+        if (ret || tombstone) {
+            continue;
+        }
+        if (!txn_open) {
+            ret = dblayer_txn_begin(be, NULL, &txn);
+            if (ret) {
+                break;
+            }
+            txn_open = 1;
+        }
+        ret = ancestorid_index_ancestors(be, db, ai, slapi_sdn_get_ndn(suffix), idl->b_ids[i], &txn);
+        if (ret == 0 && ++done % ANCESTORID_REBUILD_BATCH == 0) {
+            ret = dblayer_txn_commit(be, &txn);
+            txn_open = 0;
+        }
+    }
+    if (txn_open) {
+        if (ret) {
+            dblayer_txn_abort(be, &txn);
+            goto out;
+        }
+        ret = dblayer_txn_commit(be, &txn);
+    }
+    if (ret == 0) {
+        ret = ancestorid_stale_op(be, db, ai, BE_INDEX_DEL);
+    }
+
+out:
+    dblayer_release_index_file(be, ai, db);
+    idl_free(&idl);
+    return ret;
+}
+
+/*
+ * The subtreepath index is in use: stop maintaining ancestorid. The marker
+ * is written first, so that it is rebuilt if subtreepath is disabled.
+ */
+int
+ldbm_ancestorid_set_stale(backend *be)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    int ret = 0;
+
+    if (!ancestorid_is_marked_stale(be)) {
+        ainfo_get(be, (char *)LDBM_ANCESTORID_STR, &ai);
+        if (ai == NULL) {
+            return LDAP_OPERATIONS_ERROR;
+        }
+        ret = dblayer_get_index_file(be, ai, &db, DBOPEN_CREATE);
+        if (ret == 0) {
+            ret = ancestorid_stale_op(be, db, ai, BE_INDEX_ADD);
+            dblayer_release_index_file(be, ai, db);
+        }
+    }
+    if (ret == 0) {
+        inst->inst_ancestorid_stale = 1;
+    }
+    return ret;
+}
+
+/*
+ * The subtreepath index is not in use: rebuild ancestorid if it was not
+ * maintained. Until it is, it keeps being read from the other indexes.
+ */
+int
+ldbm_ancestorid_repair(backend *be)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    int ret;
+
+    inst->inst_ancestorid_stale = ancestorid_is_marked_stale(be);
+    if (!inst->inst_ancestorid_stale) {
+        return 0;
+    }
+    ret = ancestorid_rebuild(be);
+    if (ret) {
+        slapi_log_err(SLAPI_LOG_ERR, "ldbm_ancestorid_repair",
+                      "%s: failed to rebuild the %s index (%d)\n",
+                      inst->inst_name, LDBM_ANCESTORID_STR, ret);
+        return ret;
+    }
+    inst->inst_ancestorid_stale = 0;
+    return 0;
+}
+
+/* Is ancestorid left out of the updates? */
+int
+ldbm_ancestorid_is_stale(backend *be)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+
+    return inst->inst_ancestorid_stale;
 }
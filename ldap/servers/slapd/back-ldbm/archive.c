@@ -276,6 +276,7 @@ ldbm_back_ldbm2archive(Slapi_PBlock *pb)
     slapi_pblock_get(pb, SLAPI_SEQ_VAL, &rawdirectory);
     slapi_pblock_get(pb, SLAPI_TASK_FLAGS, &task_flags);
     li->li_flags = run_from_cmdline = (task_flags & SLAPI_TASK_RUNNING_FROM_COMMANDLINE);
+    li->li_flags |= (task_flags & SLAPI_TASK_BACKUP_INCREMENTAL);
 
     slapi_pblock_get(pb, SLAPI_BACKEND_TASK, &task);
 
@@ -623,6 +623,8 @@ struct ldbminfo
     int li_reslimit_allids_handle;        /* allids aka idlistscan */
     int li_pagedlookthroughlimit;
     int li_pagedallidsthreshold;
+    int li_pagedspillthreshold; /* ids above which paged candidates are spilled */
+    int li_subtreepath;         /* maintain the subtreepath index */
     int li_reslimit_pagedlookthrough_handle;
     int li_reslimit_pagedallids_handle; /* allids aka idlistscan */
     int li_rangelookthroughlimit;
@@ -646,6 +648,7 @@ struct ldbminfo
  * task flag (pb_task_flags) *
  *   SLAPI_TASK_RUNNING_AS_TASK
  *   SLAPI_TASK_RUNNING_FROM_COMMANDLINE
+ *   SLAPI_TASK_BACKUP_INCREMENTAL
  */
 /* allow conf w/o CONFIG_FLAG_ALLOW_RUNNING_CHANGE to be updated */
 #define LI_FORCE_MOD_CONFIG 0x10
@@ -785,6 +788,8 @@ typedef struct ldbm_instance
     int require_index;               /* set to 1 to require an index be used in search */
     int require_internalop_index;    /* set to 1 to require an index be used in an internal search */
     struct cache inst_dncache;       /* The dn cache for this instance. */
+    int inst_subtreepath_ready;      /* the subtreepath index is complete */
+    int inst_ancestorid_stale;       /* the ancestorid index is not maintained */
 } ldbm_instance;
 
 /*
@@ -805,6 +810,7 @@ typedef struct _back_search_result_set
     int sr_current_sizelimit;     /* Current sizelimit */
     Slapi_Filter *sr_norm_filter; /* search filter pre-normalized */
     Slapi_Filter *sr_norm_filter_intent; /* intended search filter pre-normalized */
+    size_t sr_spilled_size;       /* size of the file mapping, when the candidates are spilled */
 } back_search_result_set;
 #define SR_FLAG_MUST_APPLY_FILTER_TEST 1 /* If set in sr_flags, means that we MUST apply the filter test */
 
@@ -832,6 +838,7 @@ typedef struct _back_search_result_set
 #define LDBM_PAGEDALLIDSLIMIT_AT "nsPagedIDListScanLimit"
 
 #define LDBM_ANCESTORID_STR                "ancestorid"
+#define LDBM_SUBTREEPATH_STR               "subtreepath"
 #define LDBM_ENTRYDN_STR                   SLAPI_ATTR_ENTRYDN
 #define LDBM_LONG_ENTRYRDN_STR             "@long-entryrdn"
 #define LDBM_ENTRYRDN_STR                  "entryrdn"
@@ -14,6 +14,7 @@
 /* cache.c - routines to maintain an in-core cache of entries */
 
 #include "back-ldbm.h"
+#include "slapd-probes.h"
 
 #ifdef DEBUG
 #define LDAP_CACHE_DEBUG
@@ -681,11 +682,12 @@ cache_init(struct cache *cache, uint64_t maxsize, int64_t maxentries, int type)
         if (cache->c_hits) {
             slapi_counter_destroy(&cache->c_hits);
         }
-        cache->c_hits = slapi_counter_new();
+        /* Updated by every lookup, outside of the cache lock */
+        cache->c_hits = slapi_counter_new_sharded();
         if (cache->c_tries) {
             slapi_counter_destroy(&cache->c_tries);
         }
-        cache->c_tries = slapi_counter_new();
+        cache->c_tries = slapi_counter_new_sharded();
     } else {
         slapi_log_err(SLAPI_LOG_NOTICE,
                       "cache_init", "slapi counter is not available.\n");
@@ -1389,8 +1391,10 @@ cache_find_dn(struct cache *cache, const char *dn, unsigned long ndnlen)
         e->ep_refcnt++;
         cache_unlock(cache);
         slapi_counter_increment(cache->c_hits);
+        SLAPD_PROBE1(entrycache__hit, SLAPD_PROBE_CACHE_BY_DN);
     } else {
         cache_unlock(cache);
+        SLAPD_PROBE1(entrycache__miss, SLAPD_PROBE_CACHE_BY_DN);
     }
     slapi_counter_increment(cache->c_tries);
 
@@ -1421,8 +1425,10 @@ cache_find_id(struct cache *cache, ID id)
         e->ep_refcnt++;
         cache_unlock(cache);
         slapi_counter_increment(cache->c_hits);
+        SLAPD_PROBE1(entrycache__hit, SLAPD_PROBE_CACHE_BY_ID);
     } else {
         cache_unlock(cache);
+        SLAPD_PROBE1(entrycache__miss, SLAPD_PROBE_CACHE_BY_ID);
     }
     slapi_counter_increment(cache->c_tries);
 
@@ -1453,8 +1459,10 @@ cache_find_uuid(struct cache *cache, const char *uuid)
         e->ep_refcnt++;
         cache_unlock(cache);
         slapi_counter_increment(cache->c_hits);
+        SLAPD_PROBE1(entrycache__hit, SLAPD_PROBE_CACHE_BY_UUID);
     } else {
         cache_unlock(cache);
+        SLAPD_PROBE1(entrycache__miss, SLAPD_PROBE_CACHE_BY_UUID);
     }
     slapi_counter_increment(cache->c_tries);
 
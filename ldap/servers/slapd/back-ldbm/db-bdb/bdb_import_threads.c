@@ -2483,6 +2483,7 @@ bdb_import_foreman(void *param)
             slapi_sdn_init_dn_passin(&fi->entry->ep_entry->e_sdn, new_dn);
 
             /* Replacing entrydn attribute value */
+            entry_attrs_changed(fi->entry->ep_entry);
             orig_entrydn = attrlist_remove(&fi->entry->ep_entry->e_attrs,
                                            "entrydn");
             /* released in forman_do_entrydn */
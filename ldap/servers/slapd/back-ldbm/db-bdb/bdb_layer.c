@@ -6938,6 +6938,25 @@ bdb_get_entries_count(dbi_db_t *db, dbi_txn_t *txn, int *count)
     return rc;
 }
 
+int
+bdb_get_db_size(dbi_db_t *db, dbi_txn_t *txn, uint64_t *size)
+{
+    DB_BTREE_STAT *stats = NULL;
+    int rc;
+
+    /* page count and page size are available without walking the tree */
+    rc = ((DB*)db)->stat(db, (DB_TXN*)txn, (void *)&stats, DB_FAST_STAT);
+    if (rc != 0) {
+        slapi_log_err(SLAPI_LOG_ERR, "bdb_get_db_size",
+                      "Failed to get bd statistics: db error - %d %s\n",
+                      rc, db_strerror(rc));
+        rc = DBI_RC_OTHER;
+    }
+    *size = rc ? 0 : (uint64_t)stats->bt_pagecnt * stats->bt_pagesize;
+    slapi_ch_free((void **)&stats);
+    return rc;
+}
+
 int
 bdb_public_cursor_get_count(dbi_cursor_t *cursor, dbi_recno_t *count)
 {
@@ -190,6 +190,7 @@ next:
     /* Set current parentid to e_aux_attrs to remove it from the index file. */
     if (save_old_pid) {
         Slapi_Attr *pid_attr = NULL;
+        entry_attrs_changed(ep->ep_entry);
         pid_attr = attrlist_remove(&ep->ep_entry->e_attrs, "parentid");
         if (pid_attr) {
             attrlist_add(&ep->ep_entry->e_aux_attrs, pid_attr);
@@ -20,7 +20,7 @@
     do {                                              \
         val.bv_val = buf;                             \
         val.bv_len = strlen(buf);                     \
-        attrlist_replace(&e->e_attrs, (_attr), vals); \
+        entry_replace_values(e, (_attr), vals); \
     } while (0)
 
 #define MSETF(_attr, _x)                                   \
@@ -127,7 +127,7 @@ bdb_monitor_instance_search(Slapi_PBlock *pb __attribute__((unused)),
         cache_debug_hash(&(inst->inst_cache), &x);
         val.bv_val = x;
         val.bv_len = strlen(x);
-        attrlist_replace(&e->e_attrs, "entrycache-hashtables", vals);
+        entry_replace_values(e, "entrycache-hashtables", vals);
         slapi_ch_free((void **)&x);
     }
 #endif
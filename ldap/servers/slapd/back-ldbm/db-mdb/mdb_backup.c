@@ -0,0 +1,756 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pk11pub.h>
+#include <sechash.h>
+#include "mdb_layer.h"
+
+/*
+ * Online backup of the lmdb database
+ *
+ * The database is streamed by mdb_env_copyfd (the non compacting copy, so
+ * the page numbers of the image are the ones of data.mdb) through a pipe
+ * and cut in chunks of DBMDB_BACKUP_CHUNK_SIZE bytes. The length and the
+ * SHA-256 digest of every chunk are stored in the BACKUP_PAGEMAP file of the
+ * backup directory.
+ *
+ * lmdb pages do not record the txn that wrote them, so an incremental
+ * backup finds the pages modified since the previous backup (whose
+ * directory and txnid are kept in BACKUP_STATEFILE in the db home) by
+ * comparing the chunk lengths and digests with the ones of that backup: a
+ * chunk is only skipped if both match, a weak checksum collision would
+ * silently corrupt the restored database. Only the chunks that differ are
+ * written to the BACKUP_INCRFILE file, as { chunk index, length, data }
+ * records.
+ *
+ * Restoring an incremental backup copies the data.mdb of the full backup at
+ * the root of the chain, then applies the chunks of every incremental backup
+ * from the oldest to the newest one.
+ *
+ * The reads from the pipe are throttled to nsslapd-mdb-backup-max-throughput
+ * (which also slows down mdb_env_copyfd as the pipe fills up) and the
+ * written files are dropped from the page cache once synced.
+ */
+
+#define DBMDB_BACKUP_CHUNK_SIZE   (64 * 1024)
+#define DBMDB_BACKUP_MAGIC        0x4d444249   /* "MDBI" */
+#define DBMDB_BACKUP_VERSION      2            /* 1 had a 64 bits checksum per chunk */
+#define DBMDB_BACKUP_MAX_CHAIN    1000         /* guards against base directories loops */
+#define DBMDB_BACKUP_STATUS_DELAY 10           /* seconds between two task status updates */
+
+/*
+ * Location of the txnid in the lmdb meta pages (the two first pages of the
+ * image), as laid out by MDB_page and MDB_meta in mdb.c
+ */
+#define MDB_META_MAGIC            0xBEEFC0DE
+#define MDB_META_PAGEHDRSZ        (sizeof(size_t) + 4 * sizeof(uint16_t))
+#define MDB_META_MAGIC_OFFSET     MDB_META_PAGEHDRSZ
+#define MDB_META_TXNID_OFFSET     (MDB_META_PAGEHDRSZ + 2 * sizeof(uint32_t) + 2 * sizeof(size_t) + \
+                                   2 * (sizeof(uint32_t) + 2 * sizeof(uint16_t) + 5 * sizeof(size_t)) + \
+                                   sizeof(size_t))
+
+/* BACKUP_PAGEMAP header, followed by one dbmdb_backup_sum_t per chunk (native byte order) */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t txnid;            /* last txn included in the backup */
+    uint64_t size;             /* size of the database image */
+    uint32_t chunksize;
+    uint32_t incremental;      /* chunks are in BACKUP_INCRFILE, unchanged ones are in basedir */
+    uint64_t basetxnid;        /* txnid of the backup in basedir */
+    char basedir[MAXPATHLEN];
+} dbmdb_backup_header_t;
+
+typedef struct
+{
+    uint32_t len;
+    uint32_t pad;
+    unsigned char digest[SHA256_LENGTH];
+} dbmdb_backup_sum_t;
+
+/* BACKUP_INCRFILE record header, followed by the chunk data */
+typedef struct
+{
+    uint64_t chunk;
+    uint32_t len;
+    uint32_t pad;
+} dbmdb_backup_record_t;
+
+typedef struct
+{
+    MDB_env *env;
+    int fd;                    /* write end of the pipe */
+    int rc;
+} dbmdb_backup_copier_t;
+
+typedef struct
+{
+    Slapi_Task *task;
+    uint64_t max_rate;         /* bytes per second, 0 means unlimited */
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    struct timespec start;
+    time_t last_status;
+} dbmdb_backup_stats_t;
+
+
+static int
+dbmdb_backup_chunk_sum(const char *data, size_t len, dbmdb_backup_sum_t *sum)
+{
+    memset(sum, 0, sizeof(*sum));
+    sum->len = len;
+    return PK11_HashBuf(SEC_OID_SHA256, sum->digest, (const unsigned char *)data, len) == SECSuccess ? 0 : -1;
+}
+
+/* A chunk is unchanged only if both its length and its digest match */
+static int
+dbmdb_backup_chunk_unchanged(const dbmdb_backup_sum_t *sum, const dbmdb_backup_sum_t *basesum)
+{
+    return sum->len == basesum->len && memcmp(sum->digest, basesum->digest, sizeof(sum->digest)) == 0;
+}
+
+/* Read len bytes unless EOF is reached first. Returns the number of bytes read or -1 */
+static ssize_t
+dbmdb_backup_read(int fd, char *buf, size_t len)
+{
+    size_t done = 0;
+
+    while (done < len) {
+        ssize_t rc = read(fd, buf + done, len - done);
+        if (rc == 0) {
+            break;
+        }
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        done += rc;
+    }
+    return done;
+}
+
+static int
+dbmdb_backup_write(int fd, const void *buf, size_t len, dbmdb_backup_stats_t *stats)
+{
+    const char *pt = buf;
+
+    while (len > 0) {
+        ssize_t rc = write(fd, pt, len);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        pt += rc;
+        len -= rc;
+        if (stats) {
+            stats->bytes_written += rc;
+        }
+    }
+    return 0;
+}
+
+static double
+dbmdb_backup_elapsed(dbmdb_backup_stats_t *stats)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - stats->start.tv_sec) + (now.tv_nsec - stats->start.tv_nsec) / 1e9;
+}
+
+static double
+dbmdb_backup_rate(uint64_t bytes, double elapsed)
+{
+    return elapsed > 0 ? bytes / elapsed / MEGABYTE : 0;
+}
+
+/* Sleeps as needed to keep the read throughput below max_rate and updates the task status */
+static void
+dbmdb_backup_throttle(dbmdb_backup_stats_t *stats)
+{
+    double elapsed = dbmdb_backup_elapsed(stats);
+
+    if (stats->max_rate) {
+        double expected = (double)stats->bytes_read / stats->max_rate;
+        if (expected > elapsed) {
+            double delay = expected - elapsed;
+            usleep((useconds_t)((delay > 1.0 ? 1.0 : delay) * 1000000));
+        }
+    }
+    if (stats->task && slapi_current_rel_time_t() - stats->last_status >= DBMDB_BACKUP_STATUS_DELAY) {
+        stats->last_status = slapi_current_rel_time_t();
+        slapi_task_log_status(stats->task,
+                              "Backup: %" PRIu64 " MB read, %" PRIu64 " MB written (%.1f MB/s)",
+                              stats->bytes_read / MEGABYTE, stats->bytes_written / MEGABYTE,
+                              dbmdb_backup_rate(stats->bytes_read, elapsed));
+    }
+}
+
+/* Flush a backup file and drop it from the page cache */
+static int
+dbmdb_backup_close(int fd)
+{
+    int rc = fsync(fd);
+
+    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    rc = close(fd) || rc;
+    return rc ? -1 : 0;
+}
+
+/*
+ * Read the BACKUP_PAGEMAP of a backup directory.
+ * If sums is not NULL, the chunk sums are returned in *sums (to be freed by
+ * the caller): only the pagemaps of the current version have them, the
+ * header of older ones is enough to restore them.
+ * The header is checked against the size of the file, so that a corrupted
+ * pagemap is rejected rather than sizing the allocations.
+ */
+static int
+dbmdb_backup_read_pagemap(const char *dir, dbmdb_backup_header_t *hdr, dbmdb_backup_sum_t **sums, uint64_t *nbsums)
+{
+    char *path = slapi_ch_smprintf("%s/%s", dir, BACKUP_PAGEMAP);
+    int fd = open(path, O_RDONLY);
+    struct stat sbuf;
+    size_t sumsize;
+    uint64_t nb;
+    int rc = -1;
+
+    if (fd < 0) {
+        slapi_ch_free_string(&path);
+        return -1;
+    }
+    if (fstat(fd, &sbuf) < 0 || sbuf.st_size < (off_t)sizeof(*hdr) ||
+        dbmdb_backup_read(fd, (char *)hdr, sizeof(*hdr)) != (ssize_t)sizeof(*hdr) ||
+        hdr->magic != DBMDB_BACKUP_MAGIC || hdr->chunksize == 0 || hdr->chunksize > 2 * DBMDB_BACKUP_CHUNK_SIZE) {
+        goto done;
+    }
+    if (hdr->version == DBMDB_BACKUP_VERSION) {
+        sumsize = sizeof(dbmdb_backup_sum_t);
+    } else if (hdr->version == 1 && sums == NULL) {
+        sumsize = sizeof(uint64_t);
+    } else {
+        goto done;
+    }
+    hdr->basedir[MAXPATHLEN - 1] = '\0';
+    nb = hdr->size / hdr->chunksize + (hdr->size % hdr->chunksize != 0);
+    if (nb != (sbuf.st_size - sizeof(*hdr)) / sumsize) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_read_pagemap",
+                      "%s is corrupted: a database of %" PRIu64 " bytes does not match a file of %" PRIu64 " bytes\n",
+                      path, hdr->size, (uint64_t)sbuf.st_size);
+        goto done;
+    }
+    if (sums) {
+        *sums = (dbmdb_backup_sum_t *)slapi_ch_malloc(nb * sumsize + 1);
+        if (dbmdb_backup_read(fd, (char *)*sums, nb * sumsize) != (ssize_t)(nb * sumsize)) {
+            slapi_ch_free((void **)sums);
+            goto done;
+        }
+        *nbsums = nb;
+    }
+    rc = 0;
+done:
+    close(fd);
+    slapi_ch_free_string(&path);
+    return rc;
+}
+
+static int
+dbmdb_backup_write_pagemap(const char *dir, dbmdb_backup_header_t *hdr, dbmdb_backup_sum_t *sums, uint64_t nbsums)
+{
+    char *path = slapi_ch_smprintf("%s/%s", dir, BACKUP_PAGEMAP);
+    int fd = open(path, O_CREAT | O_EXCL | O_WRONLY, 0600);
+    int rc = -1;
+
+    if (fd >= 0) {
+        rc = dbmdb_backup_write(fd, hdr, sizeof(*hdr), NULL) ||
+             dbmdb_backup_write(fd, sums, nbsums * sizeof(dbmdb_backup_sum_t), NULL);
+        rc = dbmdb_backup_close(fd) || rc;
+    }
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_write_pagemap",
+                      "Failed to write %s: %s\n", path, strerror(errno));
+    }
+    slapi_ch_free_string(&path);
+    return rc ? -1 : 0;
+}
+
+/* Returns the directory of the last successful backup (to be freed by the caller) */
+static char *
+dbmdb_backup_get_last(dbmdb_ctx_t *ctx)
+{
+    char *path = slapi_ch_smprintf("%s/%s", ctx->home, BACKUP_STATEFILE);
+    char line[MAXPATHLEN + 16];
+    char *dir = NULL;
+    FILE *fh = fopen(path, "r");
+
+    slapi_ch_free_string(&path);
+    if (fh == NULL) {
+        return NULL;
+    }
+    while (fgets(line, sizeof(line), fh)) {
+        char *pt = strchr(line, '\n');
+        if (pt) {
+            *pt = '\0';
+        }
+        if (strncmp(line, "directory=", 10) == 0 && line[10]) {
+            slapi_ch_free_string(&dir);
+            dir = slapi_ch_strdup(line + 10);
+        }
+    }
+    fclose(fh);
+    return dir;
+}
+
+static void
+dbmdb_backup_set_last(dbmdb_ctx_t *ctx, const char *dir, uint64_t txnid)
+{
+    char *path = slapi_ch_smprintf("%s/%s", ctx->home, BACKUP_STATEFILE);
+    char *tmppath = slapi_ch_smprintf("%s.tmp", path);
+    FILE *fh = fopen(tmppath, "w");
+    int rc = -1;
+
+    if (fh) {
+        rc = fprintf(fh, "txnid=%" PRIu64 "\ndirectory=%s\n", txnid, dir) < 0;
+        rc = fclose(fh) || rc;
+        if (rc == 0) {
+            rc = rename(tmppath, path);
+        }
+    }
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_WARNING, "dbmdb_backup_set_last",
+                      "Failed to update %s, the next incremental backup will be a full one.\n", path);
+        unlink(tmppath);
+    }
+    slapi_ch_free_string(&tmppath);
+    slapi_ch_free_string(&path);
+}
+
+static void *
+dbmdb_backup_copier(void *arg)
+{
+    dbmdb_backup_copier_t *cp = arg;
+
+    cp->rc = mdb_env_copyfd(cp->env, cp->fd);
+    close(cp->fd);
+    return NULL;
+}
+
+/* Get the txnid from the meta pages, as they are read */
+static void
+dbmdb_backup_get_txnid(const char *buf, uint64_t offset, size_t len, int psize, uint64_t *txnid)
+{
+    for (size_t meta = 0; meta < 2; meta++) {
+        uint64_t pos = meta * psize;
+        uint32_t magic;
+        uint64_t id;
+
+        if (pos < offset || pos + MDB_META_TXNID_OFFSET + sizeof(id) > offset + len) {
+            continue;
+        }
+        memcpy(&magic, buf + pos - offset + MDB_META_MAGIC_OFFSET, sizeof(magic));
+        memcpy(&id, buf + pos - offset + MDB_META_TXNID_OFFSET, sizeof(id));
+        if (magic == MDB_META_MAGIC && id > *txnid) {
+            *txnid = id;
+        }
+    }
+}
+
+/*
+ * Copy the database into dest_dir (which must exist and be empty).
+ * If incremental is set and the last backup can be used as base, only the
+ * chunks that changed since that backup are copied.
+ */
+int
+dbmdb_backup_db(struct ldbminfo *li, const char *dest_dir, int incremental, Slapi_Task *task)
+{
+    dbmdb_ctx_t *ctx = MDB_CONFIG(li);
+    dbmdb_backup_header_t base = {0};
+    dbmdb_backup_header_t hdr = {0};
+    dbmdb_backup_copier_t cp = {0};
+    dbmdb_backup_stats_t stats = {0};
+    dbmdb_backup_sum_t *basesums = NULL;
+    uint64_t nbbasesums = 0;
+    dbmdb_backup_sum_t *sums = NULL;
+    uint64_t nbsums = 0;
+    uint64_t maxsums = 0;
+    uint64_t nbchanged = 0;
+    char *basedir = NULL;
+    char *path = NULL;
+    char *buf = NULL;
+    int pipefd[2] = {-1, -1};
+    int outfd = -1;
+    pthread_t copier;
+    MDB_stat st = {0};
+    double elapsed;
+    ssize_t len;
+    int rc = -1;
+
+    mdb_env_stat(ctx->env, &st);
+    hdr.magic = DBMDB_BACKUP_MAGIC;
+    hdr.version = DBMDB_BACKUP_VERSION;
+    hdr.chunksize = DBMDB_BACKUP_CHUNK_SIZE;
+    if (hdr.chunksize < 2 * st.ms_psize) {
+        /* Keep the meta pages in the first chunk */
+        hdr.chunksize = 2 * st.ms_psize;
+    }
+
+    if (incremental) {
+        basedir = dbmdb_backup_get_last(ctx);
+        if (basedir == NULL || strcmp(basedir, dest_dir) == 0 ||
+            dbmdb_backup_read_pagemap(basedir, &base, &basesums, &nbbasesums) ||
+            base.chunksize != hdr.chunksize) {
+            slapi_log_err(SLAPI_LOG_NOTICE, "dbmdb_backup_db",
+                          "No usable previous backup (%s), performing a full backup.\n",
+                          basedir ? basedir : "none");
+            if (task) {
+                slapi_task_log_notice(task, "No usable previous backup (%s), performing a full backup.",
+                                      basedir ? basedir : "none");
+            }
+            incremental = 0;
+            slapi_ch_free((void **)&basesums);
+            nbbasesums = 0;
+        } else {
+            hdr.incremental = 1;
+            hdr.basetxnid = base.txnid;
+            PL_strncpyz(hdr.basedir, basedir, sizeof(hdr.basedir));
+            slapi_log_err(SLAPI_LOG_INFO, "dbmdb_backup_db",
+                          "Incremental backup based on %s (txn %" PRIu64 ").\n", basedir, base.txnid);
+            if (task) {
+                slapi_task_log_notice(task, "Incremental backup based on %s (txn %" PRIu64 ").",
+                                      basedir, base.txnid);
+            }
+        }
+    }
+
+    path = slapi_ch_smprintf("%s/%s", dest_dir, incremental ? BACKUP_INCRFILE : DBMAPFILE);
+    outfd = open(path, O_CREAT | O_EXCL | O_WRONLY, li->li_mode | 0400);
+    if (outfd < 0) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to create %s: %s\n", path, strerror(errno));
+        goto done;
+    }
+    if (pipe(pipefd)) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to create a pipe: %s\n", strerror(errno));
+        goto done;
+    }
+    cp.env = ctx->env;
+    cp.fd = pipefd[1];
+    if (pthread_create(&copier, NULL, dbmdb_backup_copier, &cp)) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to start the copy thread\n");
+        goto done;
+    }
+    pipefd[1] = -1; /* closed by the copier */
+
+    stats.task = task;
+    stats.max_rate = (uint64_t)ctx->dsecfg.backup_max_throughput * MEGABYTE;
+    stats.last_status = slapi_current_rel_time_t();
+    clock_gettime(CLOCK_MONOTONIC, &stats.start);
+    buf = slapi_ch_malloc(hdr.chunksize);
+
+    rc = 0;
+    while ((len = dbmdb_backup_read(pipefd[0], buf, hdr.chunksize)) > 0) {
+        dbmdb_backup_get_txnid(buf, stats.bytes_read, len, st.ms_psize, &hdr.txnid);
+        if (nbsums == maxsums) {
+            maxsums = maxsums ? 2 * maxsums : 1024;
+            sums = (dbmdb_backup_sum_t *)slapi_ch_realloc((char *)sums, maxsums * sizeof(dbmdb_backup_sum_t));
+        }
+        if (dbmdb_backup_chunk_sum(buf, len, &sums[nbsums])) {
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to compute the digest of chunk %" PRIu64 "\n", nbsums);
+            rc = -1;
+            break;
+        }
+        if (!incremental) {
+            rc = dbmdb_backup_write(outfd, buf, len, &stats);
+            nbchanged++;
+        } else if (nbsums >= nbbasesums || !dbmdb_backup_chunk_unchanged(&sums[nbsums], &basesums[nbsums])) {
+            dbmdb_backup_record_t rec = {0};
+            rec.chunk = nbsums;
+            rec.len = len;
+            rc = dbmdb_backup_write(outfd, &rec, sizeof(rec), &stats) ||
+                 dbmdb_backup_write(outfd, buf, len, &stats);
+            nbchanged++;
+        } else {
+            rc = 0;
+        }
+        if (rc) {
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to write %s: %s\n", path, strerror(errno));
+            break;
+        }
+        nbsums++;
+        stats.bytes_read += len;
+        if (g_get_shutdown() || c_get_shutdown()) {
+            slapi_log_err(SLAPI_LOG_WARNING, "dbmdb_backup_db", "Server shutting down, backup aborted\n");
+            rc = -1;
+            break;
+        }
+        dbmdb_backup_throttle(&stats);
+    }
+    if (len < 0) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to read the database copy: %s\n", strerror(errno));
+        rc = -1;
+    }
+    if (rc) {
+        /* Let mdb_env_copyfd complete rather than failing on a closed pipe */
+        while (dbmdb_backup_read(pipefd[0], buf, hdr.chunksize) > 0)
+            ;
+    }
+    pthread_join(copier, NULL);
+    if (rc == 0 && cp.rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Failed to copy the database: %s\n", mdb_strerror(cp.rc));
+        rc = -1;
+    }
+    if (rc == 0 && hdr.txnid == 0) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_db", "Unable to find the lmdb meta pages in the database copy.\n");
+        rc = -1;
+    }
+    if (rc == 0) {
+        rc = dbmdb_backup_close(outfd);
+        outfd = -1;
+    }
+    if (rc == 0) {
+        hdr.size = stats.bytes_read;
+        rc = dbmdb_backup_write_pagemap(dest_dir, &hdr, sums, nbsums);
+    }
+    if (rc == 0) {
+        dbmdb_backup_set_last(ctx, dest_dir, hdr.txnid);
+        elapsed = dbmdb_backup_elapsed(&stats);
+        slapi_log_err(SLAPI_LOG_INFO, "dbmdb_backup_db",
+                      "%s backup of txn %" PRIu64 " to %s: %" PRIu64 "/%" PRIu64 " chunks copied, "
+                      "%" PRIu64 " bytes read, %" PRIu64 " bytes written in %.1f seconds (%.1f MB/s)\n",
+                      incremental ? "Incremental" : "Full", hdr.txnid, dest_dir, nbchanged, nbsums,
+                      stats.bytes_read, stats.bytes_written, elapsed,
+                      dbmdb_backup_rate(stats.bytes_read, elapsed));
+        if (task) {
+            slapi_task_log_notice(task, "%s backup of txn %" PRIu64 ": %" PRIu64 "/%" PRIu64 " chunks copied, "
+                                  "%" PRIu64 " bytes read, %" PRIu64 " bytes written in %.1f seconds (%.1f MB/s)",
+                                  incremental ? "Incremental" : "Full", hdr.txnid, nbchanged, nbsums,
+                                  stats.bytes_read, stats.bytes_written, elapsed,
+                                  dbmdb_backup_rate(stats.bytes_read, elapsed));
+            slapi_task_log_status(task, "Backup: %" PRIu64 " bytes read, %" PRIu64 " bytes written (%.1f MB/s)",
+                                  stats.bytes_read, stats.bytes_written,
+                                  dbmdb_backup_rate(stats.bytes_read, elapsed));
+        }
+    }
+
+done:
+    if (outfd >= 0) {
+        close(outfd);
+    }
+    if (pipefd[0] >= 0) {
+        close(pipefd[0]);
+    }
+    if (pipefd[1] >= 0) {
+        close(pipefd[1]);
+    }
+    slapi_ch_free((void **)&buf);
+    slapi_ch_free((void **)&sums);
+    slapi_ch_free((void **)&basesums);
+    slapi_ch_free_string(&basedir);
+    slapi_ch_free_string(&path);
+    return rc;
+}
+
+/*
+ * Returns the chain of backup directories needed to restore src_dir, from the
+ * full backup to src_dir (to be freed with charray_free)
+ */
+static char **
+dbmdb_backup_get_chain(const char *src_dir, Slapi_Task *task)
+{
+    dbmdb_backup_header_t hdr = {0};
+    dbmdb_backup_header_t base = {0};
+    char **chain = NULL;
+    char *dir = slapi_ch_strdup(src_dir);
+    int depth = 0;
+
+    if (dbmdb_backup_read_pagemap(dir, &hdr, NULL, NULL)) {
+        /* No pagemap: a full backup made by an older version */
+        charray_add(&chain, dir);
+        return chain;
+    }
+    charray_add(&chain, dir);
+    while (hdr.incremental) {
+        if (++depth > DBMDB_BACKUP_MAX_CHAIN ||
+            dbmdb_backup_read_pagemap(hdr.basedir, &base, NULL, NULL) ||
+            base.txnid != hdr.basetxnid || base.chunksize != hdr.chunksize) {
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_get_chain",
+                          "Backup %s is based on %s (txn %" PRIu64 ") which is missing or has been replaced.\n",
+                          dir, hdr.basedir, hdr.basetxnid);
+            if (task) {
+                slapi_task_log_notice(task, "Restore: backup %s is based on %s (txn %" PRIu64 ") "
+                                            "which is missing or has been replaced.",
+                                      dir, hdr.basedir, hdr.basetxnid);
+            }
+            charray_free(chain);
+            return NULL;
+        }
+        dir = slapi_ch_strdup(hdr.basedir);
+        charray_add(&chain, dir);
+        hdr = base;
+    }
+    /* Oldest backup first */
+    for (size_t i = 0, j = depth; i < j; i++, j--) {
+        char *tmp = chain[i];
+        chain[i] = chain[j];
+        chain[j] = tmp;
+    }
+    return chain;
+}
+
+/* Returns 1 if src_dir holds an incremental backup */
+int
+dbmdb_backup_is_incremental(const char *src_dir)
+{
+    dbmdb_backup_header_t hdr = {0};
+
+    return dbmdb_backup_read_pagemap(src_dir, &hdr, NULL, NULL) == 0 && hdr.incremental;
+}
+
+/* Check that every backup needed to restore src_dir is available */
+int
+dbmdb_backup_check_chain(const char *src_dir, Slapi_Task *task)
+{
+    char **chain = dbmdb_backup_get_chain(src_dir, task);
+    char *path;
+    struct stat sbuf;
+    int rc = 0;
+
+    if (chain == NULL) {
+        return -1;
+    }
+    path = slapi_ch_smprintf("%s/%s", chain[0], DBMAPFILE);
+    if (stat(path, &sbuf) < 0 || sbuf.st_size == 0) {
+        rc = -1;
+    }
+    slapi_ch_free_string(&path);
+    for (size_t i = 1; rc == 0 && chain[i]; i++) {
+        path = slapi_ch_smprintf("%s/%s", chain[i], BACKUP_INCRFILE);
+        if (stat(path, &sbuf) < 0) {
+            rc = -1;
+        }
+        slapi_ch_free_string(&path);
+    }
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_check_chain",
+                      "The backups needed to restore %s are incomplete.\n", src_dir);
+        if (task) {
+            slapi_task_log_notice(task, "Restore: the backups needed to restore %s are incomplete.", src_dir);
+        }
+    }
+    charray_free(chain);
+    return rc;
+}
+
+/* Apply the chunks of an incremental backup to the database file */
+static int
+dbmdb_backup_apply(const char *dir, int dbfd, uint32_t chunksize, char *buf)
+{
+    char *path = slapi_ch_smprintf("%s/%s", dir, BACKUP_INCRFILE);
+    int fd = open(path, O_RDONLY);
+    dbmdb_backup_record_t rec;
+    ssize_t len;
+    int rc = -1;
+
+    if (fd < 0) {
+        goto done;
+    }
+    while ((len = dbmdb_backup_read(fd, (char *)&rec, sizeof(rec))) == sizeof(rec)) {
+        if (rec.len > chunksize ||
+            dbmdb_backup_read(fd, buf, rec.len) != (ssize_t)rec.len ||
+            pwrite(dbfd, buf, rec.len, rec.chunk * chunksize) != (ssize_t)rec.len) {
+            goto done;
+        }
+    }
+    rc = len == 0 ? 0 : -1;
+done:
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup_apply", "Failed to apply %s: %s\n", path, strerror(errno));
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    slapi_ch_free_string(&path);
+    return rc;
+}
+
+/*
+ * Rebuild the database file from the backup in src_dir, applying the
+ * incremental backups chain if needed.
+ */
+int
+dbmdb_restore_db(struct ldbminfo *li, const char *src_dir, Slapi_Task *task)
+{
+    dbmdb_backup_header_t hdr = {0};
+    char **chain = dbmdb_backup_get_chain(src_dir, task);
+    char *dbpath = slapi_ch_smprintf("%s/%s", MDB_CONFIG(li)->home, DBMAPFILE);
+    char *path = NULL;
+    char *buf = NULL;
+    int dbfd = -1;
+    int rc = -1;
+
+    if (chain == NULL) {
+        goto done;
+    }
+    path = slapi_ch_smprintf("%s/%s", chain[0], DBMAPFILE);
+    if (dbmdb_copyfile(path, dbpath, PR_TRUE, li->li_mode)) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_restore_db", "Failed to copy database map file to %s.\n", dbpath);
+        if (task) {
+            slapi_task_log_notice(task, "Restore: Failed to copy database map file to %s.\n", dbpath);
+        }
+        goto done;
+    }
+    if (chain[1] == NULL) {
+        rc = 0;
+        goto done;
+    }
+
+    if (dbmdb_backup_read_pagemap(src_dir, &hdr, NULL, NULL)) {
+        goto done;
+    }
+    dbfd = open(dbpath, O_WRONLY);
+    if (dbfd < 0) {
+        goto done;
+    }
+    buf = slapi_ch_malloc(hdr.chunksize);
+    for (size_t i = 1; chain[i]; i++) {
+        slapi_log_err(SLAPI_LOG_INFO, "dbmdb_restore_db", "Applying incremental backup %s\n", chain[i]);
+        if (task) {
+            slapi_task_log_notice(task, "Restore: applying incremental backup %s", chain[i]);
+        }
+        if (dbmdb_backup_apply(chain[i], dbfd, hdr.chunksize, buf)) {
+            goto done;
+        }
+    }
+    if (ftruncate(dbfd, hdr.size) == 0 && fsync(dbfd) == 0) {
+        rc = 0;
+    }
+
+done:
+    if (dbfd >= 0) {
+        close(dbfd);
+    }
+    if (rc && task) {
+        slapi_task_log_notice(task, "Restore: failed to rebuild the database from %s.", src_dir);
+    }
+    charray_free(chain);
+    slapi_ch_free((void **)&buf);
+    slapi_ch_free_string(&path);
+    slapi_ch_free_string(&dbpath);
+    return rc;
+}
@@ -152,6 +152,7 @@ int mdb_init(struct ldbminfo *li, config_info *config_array)
     strncpy(conf->home, li->li_directory, MAXPATHLEN-1);
     pthread_mutex_init(&conf->dbis_lock, NULL);
     pthread_mutex_init(&conf->rcmutex, NULL);
+    pthread_mutex_init(&conf->rcindex_mutex, NULL);
     pthread_rwlock_init(&conf->dbmdb_env_lock, NULL);
 
     dbmdb_ctx_t_setup_default(li);
@@ -177,6 +178,7 @@ int mdb_init(struct ldbminfo *li, config_info *config_array)
     priv->dblayer_txn_begin_fn = &dbmdb_txn_begin;
     priv->dblayer_txn_commit_fn = &dbmdb_txn_commit;
     priv->dblayer_txn_abort_fn = &dbmdb_txn_abort;
+    priv->dblayer_txn_wait_durable_fn = &dbmdb_txn_wait_durable;
     priv->dblayer_get_info_fn = &dbmdb_get_info;
     priv->dblayer_set_info_fn = &dbmdb_set_info;
     priv->dblayer_back_ctrl_fn = &dbmdb_back_ctrl;
@@ -215,6 +217,7 @@ int mdb_init(struct ldbminfo *li, config_info *config_array)
     priv->dblayer_dbi_txn_abort_fn = &dbmdb_dbi_txn_abort;
     priv->dblayer_get_entries_count_fn = &dbmdb_get_entries_count;
     priv->dblayer_cursor_get_count_fn = &dbmdb_public_cursor_get_count;
+    priv->dblayer_get_db_size_fn = &dbmdb_get_db_size;
     priv->dblayer_private_open_fn = &dbmdb_public_private_open;
     priv->dblayer_private_close_fn = &dbmdb_public_private_close;
     priv->ldbm_back_wire_import_fn = &dbmdb_ldbm_back_wire_import;
@@ -227,6 +230,7 @@ int mdb_init(struct ldbminfo *li, config_info *config_array)
     priv->dblayer_get_db_suffix_fn = &dbmdb_public_get_db_suffix;
     priv->dblayer_compact_fn = &dbmdb_public_dblayer_compact;
     priv->dblayer_clear_vlv_cache_fn = &dbmdb_public_clear_vlv_cache;
+    priv->dblayer_update_vlv_cache_fn = &dbmdb_public_update_vlv_cache;
     priv->dblayer_dbi_db_remove_fn = &dbmdb_public_delete_db;
     priv->dblayer_idl_new_fetch_fn = &dbmdb_idl_new_fetch;
     priv->dblayer_cursor_iterate_fn = &dbmdb_dblayer_cursor_iterate;
@@ -475,6 +479,60 @@ dbmdb_ctx_t_db_durable_transactions_set(void *arg, void *value, char *errorbuf _
     return retval;
 }
 
+static void *
+dbmdb_ctx_t_group_commit_window_get(void *arg)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+
+    return (void *)((uintptr_t)(MDB_CONFIG(li)->group_commit.window));
+}
+
+static int
+dbmdb_ctx_t_group_commit_window_set(void *arg, void *value, char *errorbuf, int phase __attribute__((unused)), int apply)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+    int val = (int)((uintptr_t)value);
+
+    if (val < 0) {
+        slapi_create_errormsg(errorbuf, SLAPI_DSE_RETURNTEXT_SIZE,
+                              "Error: Invalid value for %s (%d). Must be 0 (disabled) or a number of milliseconds.",
+                              CONFIG_MDB_GROUP_COMMIT_WINDOW, val);
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+    if (apply) {
+        MDB_CONFIG(li)->group_commit.window = val;
+    }
+
+    return LDAP_SUCCESS;
+}
+
+static void *
+dbmdb_ctx_t_backup_max_throughput_get(void *arg)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+
+    return (void *)((uintptr_t)(MDB_CONFIG(li)->dsecfg.backup_max_throughput));
+}
+
+static int
+dbmdb_ctx_t_backup_max_throughput_set(void *arg, void *value, char *errorbuf, int phase __attribute__((unused)), int apply)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+    int val = (int)((uintptr_t)value);
+
+    if (val < 0) {
+        slapi_create_errormsg(errorbuf, SLAPI_DSE_RETURNTEXT_SIZE,
+                              "Error: Invalid value for %s (%d). Must be 0 (unlimited) or a number of megabytes per second.",
+                              CONFIG_MDB_BACKUP_MAX_THROUGHPUT, val);
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+    if (apply) {
+        MDB_CONFIG(li)->dsecfg.backup_max_throughput = val;
+    }
+
+    return LDAP_SUCCESS;
+}
+
 static int
 dbmdb_ctx_t_set_bypass_filter_test(void *arg,
                                    void *value,
@@ -556,6 +614,8 @@ static config_info dbmdb_ctx_t_param[] = {
     {CONFIG_MDB_MAX_DBS, CONFIG_TYPE_INT, "512", &dbmdb_ctx_t_db_max_dbs_get, &dbmdb_ctx_t_db_max_dbs_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
     {CONFIG_MAXPASSBEFOREMERGE, CONFIG_TYPE_INT, "100", &dbmdb_ctx_t_maxpassbeforemerge_get, &dbmdb_ctx_t_maxpassbeforemerge_set, 0},
     {CONFIG_DB_DURABLE_TRANSACTIONS, CONFIG_TYPE_ONOFF, "on", &dbmdb_ctx_t_db_durable_transactions_get, &dbmdb_ctx_t_db_durable_transactions_set, CONFIG_FLAG_ALWAYS_SHOW},
+    {CONFIG_MDB_GROUP_COMMIT_WINDOW, CONFIG_TYPE_INT, "0", &dbmdb_ctx_t_group_commit_window_get, &dbmdb_ctx_t_group_commit_window_set, CONFIG_FLAG_ALWAYS_SHOW},
+    {CONFIG_MDB_BACKUP_MAX_THROUGHPUT, CONFIG_TYPE_INT, "0", &dbmdb_ctx_t_backup_max_throughput_get, &dbmdb_ctx_t_backup_max_throughput_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
     {CONFIG_BYPASS_FILTER_TEST, CONFIG_TYPE_STRING, "on", &dbmdb_ctx_t_get_bypass_filter_test, &dbmdb_ctx_t_set_bypass_filter_test, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
     {CONFIG_SERIAL_LOCK, CONFIG_TYPE_ONOFF, "on", &dbmdb_ctx_t_serial_lock_get, &dbmdb_ctx_t_serial_lock_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
     {NULL, 0, NULL, NULL, NULL, 0}};
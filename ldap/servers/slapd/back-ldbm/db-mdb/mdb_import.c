@@ -1614,6 +1614,384 @@ dbmdb_ldbm_back_wire_import(Slapi_PBlock *pb)
     return -1;
 }
 
+/****************************************************************************/
+/*********** Snapshot (i.e replication total update) specific code **********/
+/****************************************************************************/
+
+/*
+ * Unlike the bulk import, the snapshot ships the records of the backend
+ * databases as they are: the entries are neither parsed nor indexed on the
+ * consumer. The env is shared by all the backends, so the records of the
+ * backend databases are shipped rather than the map file. The replication
+ * changelog is not shipped (the consumer keeps its own) and neither are the
+ * vlv record number caches (rebuilt when needed).
+ * The records are only meaningful for a consumer that has the same index
+ * configuration: both servers compute a fingerprint of their indexes and the
+ * consumer refuses the snapshot when they differ. The records are refused
+ * when the attributes are encrypted because the keys are local to each server.
+ */
+
+static int
+dbmdb_snapshot_skip_dbname(const char *dbname)
+{
+    return (*dbname == '~' || strstr(dbname, CHANGELOG_PATTERN) != NULL);
+}
+
+/* Add the definition of an index (type, rules and key lengths) to the list */
+static int32_t
+dbmdb_snapshot_fingerprint_attr(caddr_t n, caddr_t p)
+{
+    struct attrinfo *ai = (struct attrinfo *)n;
+    char ***items = (char ***)p;
+    char *item = NULL;
+    char *tmp = NULL;
+    size_t i;
+
+    if (!IS_INDEXED(ai->ai_indexmask)) {
+        return 0;
+    }
+    item = slapi_ch_smprintf("%s:%x", ai->ai_type, ai->ai_indexmask & INDEX_ANY);
+    for (i = 0; ai->ai_index_rules && ai->ai_index_rules[i]; i++) {
+        tmp = slapi_ch_smprintf("%s%c%s", item, i ? ',' : ':', ai->ai_index_rules[i]);
+        slapi_ch_free_string(&item);
+        item = tmp;
+    }
+    if (ai->ai_substr_lens) {
+        tmp = slapi_ch_smprintf("%s:%d,%d,%d", item,
+                                ai->ai_substr_lens[INDEX_SUBSTRBEGIN],
+                                ai->ai_substr_lens[INDEX_SUBSTRMIDDLE],
+                                ai->ai_substr_lens[INDEX_SUBSTREND]);
+        slapi_ch_free_string(&item);
+        item = tmp;
+    }
+    for (tmp = item; *tmp; tmp++) {
+        *tmp = tolower((unsigned char)*tmp);
+    }
+    charray_add(items, item);
+    return 0;
+}
+
+static int
+dbmdb_snapshot_fingerprint_cmp(const void *a, const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+ * The fingerprint of the index configuration of the backend: the sorted
+ * definitions of the attribute and vlv indexes. Two backends with the same
+ * fingerprint build the same records from the same entries.
+ */
+int
+dbmdb_snapshot_fingerprint(backend *be, back_info_snapshot *snap)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    struct vlvSearch *ps = NULL;
+    char **items = NULL;
+    size_t nitems = 0;
+    size_t len = 1;
+    size_t i;
+
+    avl_apply(inst->inst_attrs, dbmdb_snapshot_fingerprint_attr, (caddr_t)&items, -1, AVL_INORDER);
+    slapi_rwlock_rdlock(be->vlvSearchList_lock);
+    for (ps = (struct vlvSearch *)be->vlvSearchList; ps; ps = ps->vlv_next) {
+        struct vlvIndex *pi = ps->vlv_index;
+        for (; pi; pi = pi->vlv_next) {
+            charray_add(&items, slapi_ch_smprintf("%s:vlv:%s:%d:%s:%s",
+                                                  pi->vlv_attrinfo->ai_type,
+                                                  slapi_sdn_get_ndn(ps->vlv_base),
+                                                  ps->vlv_scope, ps->vlv_filter,
+                                                  pi->vlv_sortspec));
+        }
+    }
+    slapi_rwlock_unlock(be->vlvSearchList_lock);
+
+    for (i = 0; items && items[i]; i++) {
+        len += strlen(items[i]) + 1;
+    }
+    nitems = i;
+    if (nitems > 1) {
+        qsort(items, nitems, sizeof(char *), dbmdb_snapshot_fingerprint_cmp);
+    }
+    snap->fingerprint = (char *)slapi_ch_calloc(1, len);
+    for (i = 0; i < nitems; i++) {
+        strcat(snap->fingerprint, items[i]);
+        strcat(snap->fingerprint, ";");
+    }
+    charray_free(items);
+    return 0;
+}
+
+/*
+ * The databases a snapshot may write in: id2entry and the configured
+ * attribute and vlv indexes of the backend. Returns the attrinfo of the
+ * index (NULL for id2entry), or -1 if the name is not one of them.
+ */
+static int
+dbmdb_snapshot_dbname_attrinfo(backend *be, const char *dbname, struct attrinfo **ai)
+{
+    char *type = NULL;
+    char *pt = NULL;
+    int rc = -1;
+
+    *ai = NULL;
+    if (!dbname || strchr(dbname, '/') || dbmdb_snapshot_skip_dbname(dbname)) {
+        return -1;
+    }
+    type = slapi_ch_strdup(dbname);
+    pt = strrchr(type, '.');
+    if (!pt || strcasecmp(pt, LDBM_FILENAME_SUFFIX) != 0) {
+        slapi_ch_free_string(&type);
+        return -1;
+    }
+    *pt = '\0';
+    if (strcasecmp(type, ID2ENTRY) == 0) {
+        rc = 0;
+    } else {
+        struct vlvIndex *pi = NULL;
+
+        ainfo_get(be, type, ai);
+        if (*ai && strcasecmp((*ai)->ai_type, type) == 0 && IS_INDEXED((*ai)->ai_indexmask)) {
+            rc = 0;
+        } else {
+            *ai = NULL;
+            slapi_rwlock_rdlock(be->vlvSearchList_lock);
+            pi = vlvSearch_findindexname((struct vlvSearch *)be->vlvSearchList, type);
+            if (pi) {
+                *ai = pi->vlv_attrinfo;
+                rc = 0;
+            }
+            slapi_rwlock_unlock(be->vlvSearchList_lock);
+        }
+    }
+    slapi_ch_free_string(&type);
+    return rc;
+}
+
+/* Walk all the records of the backend databases in a single read txn */
+int
+dbmdb_snapshot_read(backend *be, back_info_snapshot *snap)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    size_t prefixlen = strlen(inst->inst_name) + 1;
+    dbmdb_dbi_t **dbilist = NULL;
+    dbi_txn_t *txn = NULL;
+    int nbdbis = 0;
+    int rc = 0;
+    int i;
+
+    if (inst->attrcrypt_configured) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_snapshot_read",
+                      "%s: Unable to read a snapshot of a backend with encrypted attributes.\n",
+                      inst->inst_name);
+        return -1;
+    }
+    rc = START_TXN(&txn, NULL, TXNFL_RDONLY);
+    if (rc) {
+        return dbmdb_map_error(__FUNCTION__, rc);
+    }
+    dbilist = dbmdb_list_dbis(MDB_CONFIG(li), be, NULL, PR_FALSE, &nbdbis);
+    for (i = 0; !rc && i < nbdbis; i++) {
+        if (dbilist[i]->state.state & DBIST_DIRTY) {
+            /* An import or a reindex is in progress */
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_snapshot_read",
+                          "%s: Unable to read a snapshot while %s is being rebuilt.\n",
+                          inst->inst_name, dbilist[i]->dbname);
+            rc = -1;
+        }
+    }
+    for (i = 0; !rc && i < nbdbis; i++) {
+        back_info_snapshot_record record = {0};
+        MDB_cursor *cursor = NULL;
+        int stopped = 0;
+        MDB_val key = {0};
+        MDB_val data = {0};
+
+        record.dbname = dbilist[i]->dbname + prefixlen;
+        if (dbmdb_snapshot_skip_dbname(record.dbname)) {
+            continue;
+        }
+        rc = MDB_CURSOR_OPEN(TXN(txn), dbilist[i]->dbi, &cursor);
+        if (rc) {
+            rc = dbmdb_map_error(__FUNCTION__, rc);
+            break;
+        }
+        rc = MDB_CURSOR_GET(cursor, &key, &data, MDB_FIRST);
+        while (rc == 0) {
+            record.key.bv_val = key.mv_data;
+            record.key.bv_len = key.mv_size;
+            record.data.bv_val = data.mv_data;
+            record.data.bv_len = data.mv_size;
+            if (snap->record_fn(snap->arg, &record)) {
+                stopped = 1;
+                break;
+            }
+            rc = MDB_CURSOR_GET(cursor, &key, &data, MDB_NEXT);
+        }
+        MDB_CURSOR_CLOSE(cursor);
+        if (stopped) {
+            rc = -1;
+        } else if (rc == MDB_NOTFOUND) {
+            rc = 0;
+        } else {
+            rc = dbmdb_map_error(__FUNCTION__, rc);
+        }
+    }
+    slapi_ch_free((void **)&dbilist);
+    /* Nothing was written, so aborting the txn is enough */
+    END_TXN(&txn, 1);
+    return rc;
+}
+
+/*
+ * Take the backend offline and remove its databases, as a bulk import does.
+ * The snapshot is refused, before anything is removed, if the index
+ * configuration of the supplier differs from ours.
+ */
+int
+dbmdb_snapshot_start(backend *be, back_info_snapshot *snap)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    back_info_snapshot local = {0};
+    int rc = 0;
+
+    if (inst->attrcrypt_configured) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_snapshot_start",
+                      "%s: Unable to write a snapshot in a backend with encrypted attributes.\n",
+                      inst->inst_name);
+        return -1;
+    }
+    dbmdb_snapshot_fingerprint(be, &local);
+    if (!snap->fingerprint || strcmp(snap->fingerprint, local.fingerprint) != 0) {
+        slapi_log_err(SLAPI_LOG_INFO, "dbmdb_snapshot_start",
+                      "%s: The index configuration differs from the supplier one, "
+                      "the snapshot is refused.\n", inst->inst_name);
+        slapi_ch_free_string(&local.fingerprint);
+        return -1;
+    }
+    slapi_ch_free_string(&local.fingerprint);
+    PR_Lock(inst->inst_config_mutex);
+    if (inst->inst_flags & INST_FLAG_BUSY) {
+        PR_Unlock(inst->inst_config_mutex);
+        slapi_log_err(SLAPI_LOG_WARNING, "dbmdb_snapshot_start",
+                      "'%s' is already in the middle of another task and cannot be disturbed.\n",
+                      inst->inst_name);
+        return SLAPI_BI_ERR_BUSY;
+    }
+    inst->inst_flags |= INST_FLAG_BUSY;
+    PR_Unlock(inst->inst_config_mutex);
+
+    slapi_mtn_be_disable(be);
+    cache_clear(&inst->inst_cache, CACHE_TYPE_ENTRY);
+    cache_clear(&inst->inst_dncache, CACHE_TYPE_DN);
+    dblayer_instance_close(be);
+    /* it's okay to fail -- it might already be gone */
+    dbmdb_delete_instance_dir(be);
+    rc = dbmdb_instance_start(be, DBLAYER_IMPORT_MODE);
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_snapshot_start",
+                      "%s: Failed to start the backend, error %d.\n", inst->inst_name, rc);
+        instance_set_not_busy(inst);
+    }
+    return rc;
+}
+
+/*
+ * Store a batch of records in a single write txn. The databases are opened
+ * first because they cannot be created while a txn is pending. They are
+ * flagged dirty until the snapshot is done, so a partial copy is never used.
+ */
+int
+dbmdb_snapshot_write(backend *be, back_info_snapshot *snap)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    dbmdb_dbi_t **dbis = NULL;
+    dbi_txn_t *txn = NULL;
+    int rc = 0;
+    size_t i;
+
+    if (snap->nrecords == 0) {
+        return 0;
+    }
+    dbis = (dbmdb_dbi_t **)slapi_ch_calloc(snap->nrecords, sizeof(dbmdb_dbi_t *));
+    for (i = 0; !rc && i < snap->nrecords; i++) {
+        const char *dbname = snap->records[i].dbname;
+        struct attrinfo *ai = NULL;
+
+        /* The records of a database are usually consecutive */
+        if (i > 0 && dbname && strcmp(dbname, snap->records[i - 1].dbname) == 0) {
+            dbis[i] = dbis[i - 1];
+            continue;
+        }
+        /* The names come from the wire: only our own databases may be
+         * created, and index databases need the key compare function
+         * of their attribute */
+        if (dbmdb_snapshot_dbname_attrinfo(be, dbname, &ai)) {
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_snapshot_write",
+                          "%s: Refusing to write in database %s.\n",
+                          inst->inst_name, dbname ? dbname : "(null)");
+            rc = -1;
+            break;
+        }
+        rc = dbmdb_open_dbi_from_filename(&dbis[i], be, dbname, ai,
+                                          MDB_CREATE | MDB_MARK_DIRTY_DBI);
+        if (rc) {
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_snapshot_write",
+                          "%s: Failed to open database %s, error %d.\n",
+                          inst->inst_name, dbname, rc);
+        }
+    }
+    if (!rc) {
+        rc = START_TXN(&txn, NULL, 0);
+    }
+    for (i = 0; !rc && i < snap->nrecords; i++) {
+        MDB_val key = {0};
+        MDB_val data = {0};
+
+        key.mv_data = snap->records[i].key.bv_val;
+        key.mv_size = snap->records[i].key.bv_len;
+        data.mv_data = snap->records[i].data.bv_val;
+        data.mv_size = snap->records[i].data.bv_len;
+        rc = MDB_PUT(TXN(txn), dbis[i]->dbi, &key, &data, 0);
+    }
+    if (txn) {
+        rc = END_TXN(&txn, rc);
+    }
+    slapi_ch_free((void **)&dbis);
+    return (rc == -1) ? rc : dbmdb_map_error(__FUNCTION__, rc);
+}
+
+/* Bring the backend back online, or leave it empty and offline if aborted */
+int
+dbmdb_snapshot_done(backend *be, back_info_snapshot *snap)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    int rc = 0;
+
+    dblayer_instance_close(be);
+    if (!snap->abort) {
+        rc = dbmdb_instance_start(be, DBLAYER_NORMAL_MODE);
+        if (rc == 0) {
+            /* Reset USN slapi_counter with the last key of the entryUSN index */
+            ldbm_set_last_usn(be);
+            rc = dbmdb_clear_dirty_flags(be);
+        }
+        if (rc == 0) {
+            slapi_mtn_be_enable(be);
+            slapi_log_err(SLAPI_LOG_INFO, "dbmdb_snapshot_done",
+                          "Backend %s is now online.\n", slapi_be_get_name(be));
+        } else {
+            dblayer_instance_close(be);
+        }
+    }
+    if (snap->abort || rc) {
+        dbmdb_delete_instance_dir(be);
+    }
+    instance_set_not_busy(inst);
+    return rc;
+}
+
 /*
  * Debug function (to use when debbuging with gdb)
  */
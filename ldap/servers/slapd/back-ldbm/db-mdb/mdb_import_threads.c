@@ -2905,6 +2905,7 @@ dbmdb_add_op_attrs(ImportJob *job, struct backentry *ep, ID pid)
     /* Set current parentid to e_aux_attrs to remove it from the index file. */
     if (ctx->role == IM_UPGRADE) {
         Slapi_Attr *pid_attr = NULL;
+        entry_attrs_changed(ep->ep_entry);
         pid_attr = attrlist_remove(&ep->ep_entry->e_attrs, "parentid");
         if (pid_attr) {
             attrlist_add(&ep->ep_entry->e_aux_attrs, pid_attr);
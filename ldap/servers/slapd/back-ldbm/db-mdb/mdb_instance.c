@@ -788,8 +788,10 @@ void dbmdb_ctx_close(dbmdb_ctx_t *ctx)
         slapi_ch_free((void**)&ctx->dbi_slots);
         dbi_slots = NULL;
         dbi_nbslots = 0;
+        dbmdb_recno_cache_free_indexes(ctx);
         pthread_mutex_destroy(&ctx->dbis_lock);
         pthread_mutex_destroy(&ctx->rcmutex);
+        pthread_mutex_destroy(&ctx->rcindex_mutex);
         pthread_rwlock_destroy(&ctx->dbmdb_env_lock);
     }
 }
@@ -1418,8 +1420,8 @@ int dbmdb_recno_cache_get_mode(dbmdb_recno_cache_ctx_t *rcctx)
     rcctx->rcdbi = dbi_get_by_name(ctx, rcctx->cursor->be, rcdbname);
     if (rcctx->rcdbi) {
         /* DBI cache was found,  Let check that it is usuable */
-        rcctx->key.mv_data = "OK";
-        rcctx->key.mv_size = 2;
+        rcctx->key.mv_data = RECNOCACHE_VALID_KEY;
+        rcctx->key.mv_size = strlen(RECNOCACHE_VALID_KEY);
         rc = MDB_GET(txn, rcctx->rcdbi->dbi, &rcctx->key, &rcctx->data);
         if (rc == MDB_SUCCESS) {
             rcctx->mode = RCMODE_USE_CURSOR_TXN;
@@ -23,7 +23,7 @@ Slapi_ComponentId *dbmdb_componentid;
 
 #define BULKOP_MAX_RECORDS  100 /* Max records handled by a single bulk operations */
 
-#define RECNO_CACHE_INTERVAL 1000  /* 1 key added in cache for every RECNO_CACHE_INTERVAL vlv keys */
+#define RECNO_CACHE_INTERVAL 1000  /* Number of vlv records per recno cache block (between 1 and twice that after updates) */
 
 /* bulkdata->v.data contents */
 typedef struct {
@@ -83,6 +83,7 @@ static int dbmdb_force_checkpoint(struct ldbminfo *li);
 #define FLUSH_REMOTEOFF 0
 
 static const char *backupfilelists[] = { INFOFILE, DBMAPFILE, DSE_INSTANCE, DSE_INDEX, NULL };
+static const char *incrbackupfilelists[] = { BACKUP_PAGEMAP, BACKUP_INCRFILE, NULL };
 
 /*
  * if ATTRINFO_DEBUG_DELAY > 0
@@ -193,6 +194,9 @@ dbmdb_start(struct ldbminfo *li, int dbmode)
          * So we determine here the max key lenght
          */
         li->li_max_key_len = mdb_env_get_maxkeysize(MDB_CONFIG(li)->env) - sizeof (ID);
+        if (!readonly && (dbmode & DBLAYER_NORMAL_MODE)) {
+            dbmdb_group_commit_start(MDB_CONFIG(li));
+        }
     }
     return rc;
 }
@@ -282,7 +286,8 @@ dbmdb_instance_start(backend *be, int mode)
 void
 dbmdb_pre_close(struct ldbminfo *li)
 {
-    /* There is no database threads ==> nothing to do */
+    /* The group commit flusher is the only database thread */
+    dbmdb_group_commit_stop(MDB_CONFIG(li));
 }
 
 int
@@ -943,8 +948,8 @@ dbmdb_backup(struct ldbminfo *li, char *dest_dir, Slapi_Task *task)
         }
         goto error_out;
     }
-    /* Copy the mdb database */
-    return_value = mdb_env_copy(conf->env, dest_dir);
+    /* Copy the mdb database (only the pages changed since the last backup if incremental) */
+    return_value = dbmdb_backup_db(li, dest_dir, li->li_flags & SLAPI_TASK_BACKUP_INCREMENTAL, task);
     if (return_value) {
         slapi_log_err(SLAPI_LOG_ERR, "dbmdb_backup", "Failed to backup mdb database to %s.\n", dest_dir);
         if (task) {
@@ -1001,6 +1006,11 @@ error_out:
         unlink(pathname2);
         slapi_ch_free_string(&pathname2);
     }
+    for (pt=incrbackupfilelists; *pt; pt++) {
+        pathname2 = slapi_ch_smprintf("%s/%s", dest_dir, *pt);
+        unlink(pathname2);
+        slapi_ch_free_string(&pathname2);
+    }
     rmdir(dest_dir);
     return_value = LDAP_UNWILLING_TO_PERFORM;
 bail:
@@ -1047,6 +1057,7 @@ dbmdb_restore(struct ldbminfo *li, char *src_dir, Slapi_Task *task)
     struct stat sbuf;
     const char **pt;
     char *pathname;
+    int incremental;
 
     PR_ASSERT(NULL != li);
     PR_ASSERT(NULL != li->li_dblayer_private);
@@ -1076,7 +1087,12 @@ dbmdb_restore(struct ldbminfo *li, char *src_dir, Slapi_Task *task)
     }
 
     /* Check that all files are present and not empty */
+    incremental = dbmdb_backup_is_incremental(src_dir);
     for (pt=backupfilelists; *pt; pt++) {
+        if (incremental && strcmp(*pt, DBMAPFILE) == 0) {
+            /* The database is rebuilt from the backups chain */
+            continue;
+        }
         pathname = slapi_ch_smprintf("%s/%s", src_dir, *pt);
         if (stat(pathname, &sbuf) < 0 || sbuf.st_size == 0) {
             slapi_log_err(SLAPI_LOG_ERR, "dbmdb_restore",
@@ -1091,6 +1107,10 @@ dbmdb_restore(struct ldbminfo *li, char *src_dir, Slapi_Task *task)
         slapi_ch_free_string(&pathname);
     }
 
+    if (dbmdb_backup_check_chain(src_dir, task)) {
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+
     /* Check that current backend instance are compatible with backup. */
     /* And reset index configuration to the backup one */
     tmp_rval = dbmdb_dse_conf_verify(li, src_dir);
@@ -1109,7 +1129,7 @@ dbmdb_restore(struct ldbminfo *li, char *src_dir, Slapi_Task *task)
     dbmdb_delete_db(li);
 
     /* Copy db and info files */
-    if (dbmdb_restore_file(li, task, src_dir, DBMAPFILE) ||
+    if (dbmdb_restore_db(li, src_dir, task) ||
         dbmdb_restore_file(li, task, src_dir, INFOFILE)) {
         return_value = -1;
         goto error_out;
@@ -1542,6 +1562,26 @@ dbmdb_back_ctrl(Slapi_Backend *be, int cmd, void *info)
         slapi_pblock_destroy(pb);
         break;
     }
+    case BACK_INFO_SNAPSHOT_FINGERPRINT: {
+        rc = dbmdb_snapshot_fingerprint(be, (back_info_snapshot *)info);
+        break;
+    }
+    case BACK_INFO_SNAPSHOT_READ: {
+        rc = dbmdb_snapshot_read(be, (back_info_snapshot *)info);
+        break;
+    }
+    case BACK_INFO_SNAPSHOT_START: {
+        rc = dbmdb_snapshot_start(be, (back_info_snapshot *)info);
+        break;
+    }
+    case BACK_INFO_SNAPSHOT_WRITE: {
+        rc = dbmdb_snapshot_write(be, (back_info_snapshot *)info);
+        break;
+    }
+    case BACK_INFO_SNAPSHOT_DONE: {
+        rc = dbmdb_snapshot_done(be, (back_info_snapshot *)info);
+        break;
+    }
     default:
         break;
     }
@@ -1954,15 +1994,39 @@ int dbmdb_public_cursor_bulkop(dbi_cursor_t *cursor,  dbi_op_t op, dbi_val_t *ke
     return rc;
 }
 
+/*
+ * The recno cache splits the vlv index in blocks of consecutive records and
+ * keeps the number of records of each block, keyed by the block first record.
+ * The vlv updates maintain the counts within the write txn, so the cache stays
+ * valid while the index changes. The position of a record is the sum of the
+ * counts of the blocks before it plus its rank within its block.
+ *
+ * The block keys are encoded so that their memcmp order is the vlv index order
+ * (i.e: the key order then the entry id order):
+ *    'B' + vlv key with 0x00 bytes escaped as 0x00 0xff + 0x00 0x00 + entry id in big endian
+ */
 void dbmdb_generate_recno_cache_key_by_data(MDB_val *cache_key, MDB_val *key, MDB_val *data)
 {
-    char *ptdata;
-    cache_key->mv_size = 1+key->mv_size+data->mv_size + sizeof (key->mv_size);
-    ptdata = cache_key->mv_data = slapi_ch_malloc(cache_key->mv_size);
-    ptdata[0] = 'D';
-    memcpy(&ptdata[1], key->mv_data, key->mv_size);
-    memcpy(&ptdata[1+key->mv_size], data->mv_data, data->mv_size);
-    memcpy(&ptdata[1+key->mv_size+data->mv_size], &key->mv_size, sizeof (key->mv_size));
+    unsigned char *ptkey = key->mv_data;
+    unsigned char *pt;
+    ID id = 0;
+
+    pt = cache_key->mv_data = slapi_ch_malloc(1 + 2 * key->mv_size + 2 + sizeof id);
+    *pt++ = 'B';
+    for (size_t i = 0; i < key->mv_size; i++) {
+        *pt++ = ptkey[i];
+        if (ptkey[i] == 0) {
+            *pt++ = 0xff;
+        }
+    }
+    *pt++ = 0;
+    *pt++ = 0;
+    memcpy(&id, data->mv_data, data->mv_size < sizeof id ? data->mv_size : sizeof id);
+    *pt++ = (id >> 24) & 0xff;
+    *pt++ = (id >> 16) & 0xff;
+    *pt++ = (id >> 8) & 0xff;
+    *pt++ = id & 0xff;
+    cache_key->mv_size = pt - (unsigned char *)cache_key->mv_data;
 }
 
 void dbmdb_generate_recno_cache_key_by_recno(MDB_val *cache_key, dbi_recno_t recno)
@@ -2045,64 +2109,321 @@ new_rce(int recno, MDB_val *key, MDB_val *data)
     return rce;
 }
 
-dbmdb_recno_cache_elmt_t *
-dup_rce(dbmdb_recno_cache_elmt_t *rce)
+/* Decode a block key into the vlv record it starts with */
+static dbmdb_recno_cache_elmt_t *
+block2rce(dbi_recno_t recno, MDB_val *blockkey)
+{
+    unsigned char *pt = blockkey->mv_data;
+    unsigned char *end = pt + blockkey->mv_size;
+    dbmdb_recno_cache_elmt_t *rce = NULL;
+    MDB_val data = {0};
+    MDB_val key = {0};
+    ID id = 0;
+
+    key.mv_data = slapi_ch_malloc(blockkey->mv_size);
+    for (pt++; pt + 1 < end && (pt[0] || pt[1]); pt += pt[0] ? 1 : 2) {
+        ((unsigned char *)key.mv_data)[key.mv_size++] = *pt;
+    }
+    pt += 2;
+    if (end - pt == sizeof id) {
+        id = ((ID)pt[0] << 24) | ((ID)pt[1] << 16) | ((ID)pt[2] << 8) | (ID)pt[3];
+        data.mv_data = &id;
+        data.mv_size = sizeof id;
+        rce = new_rce(recno, &key, &data);
+    } else {
+        slapi_log_err(SLAPI_LOG_ERR, "block2rce", "Invalid vlv cache block key (size %zu).\n",
+                      blockkey->mv_size);
+    }
+    slapi_ch_free(&key.mv_data);
+    return rce;
+}
+
+/*
+ * Block index of a recno cache: the first record number and the key of
+ * every block, as seen by the read txns of one snapshot. Looking a record
+ * up is then a binary search instead of a walk of the blocks summing their
+ * counts. The index is immutable and shared by the readers of the snapshot
+ * (ctx->rcindexes keeps the one of the most recent snapshot).
+ */
+typedef struct dbmdb_recno_cache_index
+{
+    uint64_t refcnt;              /* protected by ctx->rcindex_mutex */
+    size_t txnid;                 /* the snapshot */
+    size_t nblocks;
+    dbi_recno_t *firsts;          /* nblocks+1 items: the last one is past the last record */
+    MDB_val *keys;
+} dbmdb_recno_cache_index_t;
+
+#define VD(val)  ((char*)((val).mv_data))
+
+static void dbmdb_recno_cache_dup_key(MDB_val *dest, MDB_val *src);
+
+static void
+dbmdb_recno_cache_index_free(dbmdb_recno_cache_index_t *rci)
+{
+    for (size_t i = 0; i < rci->nblocks; i++) {
+        slapi_ch_free(&rci->keys[i].mv_data);
+    }
+    slapi_ch_free((void **)&rci->keys);
+    slapi_ch_free((void **)&rci->firsts);
+    slapi_ch_free((void **)&rci);
+}
+
+static void
+dbmdb_recno_cache_index_release(dbmdb_ctx_t *ctx, dbmdb_recno_cache_index_t *rci)
+{
+    uint64_t refcnt;
+
+    if (rci == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&ctx->rcindex_mutex);
+    refcnt = --rci->refcnt;
+    pthread_mutex_unlock(&ctx->rcindex_mutex);
+    if (refcnt == 0) {
+        dbmdb_recno_cache_index_free(rci);
+    }
+}
+
+/* Called when the db env is closed */
+void
+dbmdb_recno_cache_free_indexes(dbmdb_ctx_t *ctx)
+{
+    if (ctx->rcindexes) {
+        for (size_t i = 0; i < ctx->startcfg.max_dbs; i++) {
+            dbmdb_recno_cache_index_release(ctx, ctx->rcindexes[i]);
+        }
+        slapi_ch_free((void **)&ctx->rcindexes);
+    }
+}
+
+/* Walk the blocks once to index them */
+static dbmdb_recno_cache_index_t *
+dbmdb_recno_cache_index_build(MDB_cursor *cursor, size_t txnid)
+{
+    dbmdb_recno_cache_index_t *rci = (dbmdb_recno_cache_index_t *)slapi_ch_calloc(1, sizeof *rci);
+    dbi_recno_t first = 1;
+    size_t maxblocks = 0;
+    MDB_val data = {0};
+    MDB_val key = {0};
+    uint32_t count = 0;
+    int rc = 0;
+
+    rci->refcnt = 1;
+    rci->txnid = txnid;
+    key.mv_data = "B";
+    key.mv_size = 1;
+    rc = MDB_CURSOR_GET(cursor, &key, &data, MDB_SET_RANGE);
+    while (rc == 0 && VD(key)[0] == 'B') {
+        if (rci->nblocks == maxblocks) {
+            maxblocks = maxblocks ? 2 * maxblocks : 64;
+            rci->keys = (MDB_val *)slapi_ch_realloc((char *)rci->keys, maxblocks * sizeof(MDB_val));
+            rci->firsts = (dbi_recno_t *)slapi_ch_realloc((char *)rci->firsts, (maxblocks + 1) * sizeof(dbi_recno_t));
+        }
+        memcpy(&count, data.mv_data, sizeof count);
+        dbmdb_recno_cache_dup_key(&rci->keys[rci->nblocks], &key);
+        rci->firsts[rci->nblocks++] = first;
+        first += count;
+        rc = MDB_CURSOR_GET(cursor, &key, &data, MDB_NEXT);
+    }
+    if (rc != 0 && rc != MDB_NOTFOUND) {
+        dbmdb_recno_cache_index_free(rci);
+        return NULL;
+    }
+    if (rci->firsts == NULL) {
+        rci->firsts = (dbi_recno_t *)slapi_ch_malloc(sizeof(dbi_recno_t));
+    }
+    rci->firsts[rci->nblocks] = first;
+    return rci;
+}
+
+/*
+ * Get the block index of the snapshot of a read txn, building it if
+ * needed. Returns NULL within a write txn: its blocks may still change.
+ */
+static dbmdb_recno_cache_index_t *
+dbmdb_recno_cache_index_get(dbmdb_ctx_t *ctx, MDB_txn *txn, MDB_cursor *cursor, MDB_dbi rcdbi)
+{
+    dbmdb_recno_cache_index_t *rci = NULL;
+    dbmdb_recno_cache_index_t *old = NULL;
+    size_t txnid = mdb_txn_id(txn);
+    MDB_envinfo info = {0};
+
+    /* A write txn has the id of the next committed txn */
+    if (mdb_env_info(ctx->env, &info) || txnid > info.me_last_txnid || rcdbi >= ctx->startcfg.max_dbs) {
+        return NULL;
+    }
+    pthread_mutex_lock(&ctx->rcindex_mutex);
+    if (ctx->rcindexes == NULL) {
+        ctx->rcindexes = (dbmdb_recno_cache_index_t **)slapi_ch_calloc(ctx->startcfg.max_dbs, sizeof(dbmdb_recno_cache_index_t *));
+    }
+    rci = ctx->rcindexes[rcdbi];
+    if (rci && rci->txnid == txnid) {
+        rci->refcnt++;
+        pthread_mutex_unlock(&ctx->rcindex_mutex);
+        return rci;
+    }
+    pthread_mutex_unlock(&ctx->rcindex_mutex);
+
+    rci = dbmdb_recno_cache_index_build(cursor, txnid);
+    if (rci == NULL) {
+        return NULL;
+    }
+    pthread_mutex_lock(&ctx->rcindex_mutex);
+    old = ctx->rcindexes[rcdbi];
+    if (old == NULL || old->txnid < txnid) {
+        /* Keep the index of the most recent snapshot */
+        ctx->rcindexes[rcdbi] = rci;
+        rci->refcnt++;
+    } else {
+        old = NULL;
+    }
+    pthread_mutex_unlock(&ctx->rcindex_mutex);
+    dbmdb_recno_cache_index_release(ctx, old);
+    return rci;
+}
+
+/* Binary search of the block index, see dbmdb_recno_cache_search */
+static void
+dbmdb_recno_cache_index_search(dbmdb_recno_cache_index_t *rci, int by_recno, dbi_recno_t recno,
+                               MDB_val *cache_key, MDB_val *blockkey, dbi_recno_t *blockrecno)
 {
-    MDB_val key, data;
-    key.mv_size = rce->key.mv_size;
-    key.mv_data = &rce[1];
-    data.mv_size = rce->data.mv_size;
-    data.mv_data = ((char*)&rce[1]) + key.mv_size;
-    return new_rce(rce->recno, &key, &data);
+    size_t lo = 0;
+    size_t hi = rci->nblocks;
+
+    if (by_recno) {
+        if (rci->nblocks == 0 || recno >= rci->firsts[rci->nblocks]) {
+            return;
+        }
+        /* The last block starting at or before recno */
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (rci->firsts[mid] <= recno) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        *blockkey = rci->keys[lo];
+        *blockrecno = rci->firsts[lo];
+    } else {
+        /* The number of blocks starting at or before the key */
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (dbmdb_cmp_vals(&rci->keys[mid], cache_key) <= 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > 0) {
+            *blockkey = rci->keys[lo - 1];
+            *blockrecno = rci->firsts[lo - 1];
+        }
+    }
 }
 
-/* Search in the cache the greatest entry smaller or equal to the searched key */
+/*
+ * Search in the cache the block holding the searched record (cache_key generated
+ * by data) or the searched record number (cache_key generated by recno) and
+ * returns its first record and the record number of that first record.
+ * Read txns search the block index of their snapshot, write txns walk the blocks.
+ */
 int dbmdb_recno_cache_search(dbmdb_recno_cache_ctx_t *rcctx)
 {
+    dbmdb_recno_cache_index_t *rci = NULL;
+    dbmdb_ctx_t *ctx = NULL;
     dbmdb_txn_ctx_t txn_ctx = {0};
+    dbi_recno_t blockrecno = 0;
+    dbi_recno_t recno = 0;
+    dbi_recno_t first = 1;
+    MDB_val blockkey = {0};
+    uint32_t count = 0;
+    int by_recno = 0;
     int rc = 0;
-#define VD(val)  ((char*)((val).mv_data))
 
-    /* Search for GREATER OR EQUAL record */
-    rcctx->key = rcctx->cache_key;
     rcctx->rce = NULL;
+    by_recno = (VD(rcctx->cache_key)[0] == 'R');
+    if (by_recno) {
+        recno = strtoul(VD(rcctx->cache_key) + 1, NULL, 10);
+    }
     rc = dbmdb_begin_recno_cache_txn(rcctx, &txn_ctx, rcctx->rcdbi->dbi);
-    if (!rc) {
+    if (!rc && rcctx->mode == RCMODE_USE_CURSOR_TXN && rcctx->cursor) {
+        ctx = MDB_CONFIG((struct ldbminfo *)rcctx->cursor->be->be_database->plg_private);
+        rci = dbmdb_recno_cache_index_get(ctx, txn_ctx.txn, txn_ctx.cursor, rcctx->rcdbi->dbi);
+    }
+    if (rci) {
+        dbmdb_recno_cache_index_search(rci, by_recno, recno, &rcctx->cache_key, &blockkey, &blockrecno);
+        rc = 0;
+    } else if (!rc) {
+        rcctx->key.mv_data = "B";
+        rcctx->key.mv_size = 1;
         rc = MDB_CURSOR_GET(txn_ctx.cursor, &rcctx->key, &rcctx->data, MDB_SET_RANGE);
     }
-    rcctx->rce = NULL;
-    if (rc == 0 && VD(rcctx->cache_key)[0] == VD(rcctx->key)[0] &&
-        dbmdb_cmp_vals(&rcctx->cache_key, &rcctx->key) == 0) {
-        /* Found directly searched entry */
-        rcctx->rce = dup_rce(rcctx->data.mv_data);
-    } else {
-        if (rc == MDB_NOTFOUND) {
-            rc = MDB_CURSOR_GET(txn_ctx.cursor, &rcctx->key, &rcctx->data, MDB_LAST);
-        } else if (rc == 0) {
-            rc = MDB_CURSOR_GET(txn_ctx.cursor, &rcctx->key, &rcctx->data, MDB_PREV);
+    /* Without index, walk the blocks, summing their counts */
+    while (!rci && rc == 0 && VD(rcctx->key)[0] == 'B') {
+        memcpy(&count, rcctx->data.mv_data, sizeof count);
+        if (by_recno) {
+            if (recno < first + count) {
+                blockkey = rcctx->key;
+                blockrecno = first;
+                break;
+            }
+        } else {
+            if (dbmdb_cmp_vals(&rcctx->key, &rcctx->cache_key) > 0) {
+                break;
+            }
+            blockkey = rcctx->key;
+            blockrecno = first;
         }
-        if (rc == 0 && VD(rcctx->cache_key)[0] == VD(rcctx->key)[0]) {
-            rcctx->rce = dup_rce(rcctx->data.mv_data);
+        first += count;
+        rc = MDB_CURSOR_GET(txn_ctx.cursor, &rcctx->key, &rcctx->data, MDB_NEXT);
+    }
+    if (rc == 0 || rc == MDB_NOTFOUND) {
+        rc = MDB_NOTFOUND;
+        if (blockrecno) {
+            rcctx->rce = block2rce(blockrecno, &blockkey);
+            rc = rcctx->rce ? 0 : MDB_CORRUPTED;
         }
     }
+    if (rci) {
+        dbmdb_recno_cache_index_release(ctx, rci);
+    }
 
     rc = dbmdb_end_recno_cache_txn(&txn_ctx, rc);
     return rc;
 }
 
+/* Store the record count of a block */
+static int
+dbmdb_recno_cache_put_block(MDB_txn *txn, MDB_dbi rcdbi, MDB_val *blockkey, uint32_t count)
+{
+    MDB_val data = {0};
+    int rc = 0;
+
+    data.mv_data = &count;
+    data.mv_size = sizeof count;
+    /* The cache dbi supports duplicates: remove the old count first */
+    rc = MDB_DEL(txn, rcdbi, blockkey, NULL);
+    if (rc == 0 || rc == MDB_NOTFOUND) {
+        rc = MDB_PUT(txn, rcdbi, blockkey, &data, 0);
+    }
+    return rc;
+}
+
 /* create or recreate the recno cache */
 void *dbmdb_recno_cache_build(void *arg)
 {
     dbmdb_recno_cache_ctx_t *rcctx = arg;
-    dbmdb_recno_cache_elmt_t *rce = NULL;
     dbmdb_txn_ctx_t txn_ctx = {0};
-    dbi_recno_t recno = 1;
+    uint32_t interval = RECNO_CACHE_INTERVAL;
+    MDB_val blockkey = {0};
     MDB_val rcdata = {0};
     MDB_val rckey = {0};
     MDB_stat stat = {0};
     MDB_val data = {0};
     MDB_val key = {0};
-    int len = 0;
+    uint32_t count = 0;
     int rc = 0;
 
     DBG_LOG(DBGMDB_LEVEL_VLV, "dbmdb_recno_cache_build(%s)", rcctx->rcdbname);
@@ -2115,8 +2436,8 @@ void *dbmdb_recno_cache_build(void *arg)
         rc = dbmdb_begin_recno_cache_txn(rcctx, &txn_ctx, rcctx->dbi->dbi);
     }
     if (rc == 0) {
-        key.mv_data = "OK";
-        key.mv_size = 2;
+        key.mv_data = RECNOCACHE_VALID_KEY;
+        key.mv_size = strlen(RECNOCACHE_VALID_KEY);
         rc = MDB_GET(txn_ctx.txn, rcctx->rcdbi->dbi, &key, &data);
         if (rc == 0) {
             /* Cache is already uptodate ==> nothing to build. */
@@ -2131,59 +2452,53 @@ void *dbmdb_recno_cache_build(void *arg)
     }
     if (rc == 0) {
         rc = MDB_CURSOR_GET(txn_ctx.cursor, &key, &data, MDB_FIRST);
-        recno = 1;
     }
     while (rc == 0) {
-        slapi_log_err(SLAPI_LOG_DEBUG, "dbmdb_recno_cache_build", "recno=%d\n", recno);
-        if (recno % RECNO_CACHE_INTERVAL == 1) {
-            /* Prepare the cache data */
-            len = sizeof(*rce) + data.mv_size + key.mv_size;
-            rce = (dbmdb_recno_cache_elmt_t*)slapi_ch_malloc(len);
-            rce->len = len;
-            rce->recno = recno;
-            rce->key.mv_size = key.mv_size;
-            rce->key.mv_data = &rce[1];
-            rce->data.mv_size = data.mv_size;
-            rce->data.mv_data = ((char*)&rce[1])+rce->key.mv_size;
-            memcpy(rce->key.mv_data, key.mv_data, key.mv_size);
-            memcpy(rce->data.mv_data, data.mv_data, data.mv_size);
-            rcdata.mv_data = rce;
-            rcdata.mv_size = len;
-            dbmdb_generate_recno_cache_key_by_recno(&rckey, recno);
-            rc = MDB_PUT(txn_ctx.txn, rcctx->rcdbi->dbi, &rckey, &rcdata, 0);
-            slapi_ch_free(&rckey.mv_data);
+        if (count == 0) {
+            /* First record of a new block */
+            dbmdb_generate_recno_cache_key_by_data(&blockkey, &key, &data);
+        }
+        if (++count == RECNO_CACHE_INTERVAL) {
+            rc = dbmdb_recno_cache_put_block(txn_ctx.txn, rcctx->rcdbi->dbi, &blockkey, count);
+            txn_ctx.flags |= DBMDB_TXNCTX_NEED_COMMIT;
+            slapi_ch_free(&blockkey.mv_data);
+            count = 0;
             if (rc) {
                 slapi_log_err(SLAPI_LOG_ERR, "dbmdb_recno_cache_build",
-                              "Failed to write record in db %s, key=%s error: %s\n",
-                              rcctx->rcdbi->dbname, (char*)(key.mv_data), mdb_strerror(rc));
-            } else {
-                dbmdb_generate_recno_cache_key_by_data(&rckey, &key, &data);
-                rc = MDB_PUT(txn_ctx.txn, rcctx->rcdbi->dbi, &rckey, &rcdata, 0);
-                slapi_ch_free(&rckey.mv_data);
-                txn_ctx.flags |= DBMDB_TXNCTX_NEED_COMMIT;
-                if (rc) {
-                    slapi_log_err(SLAPI_LOG_ERR, "dbmdb_recno_cache_build",
-                                  "Failed to write record in db %s, key=%s error: %s\n",
-                                  rcctx->rcdbi->dbname, (char*)(key.mv_data), mdb_strerror(rc));
-                }
+                              "Failed to write record in db %s, error: %s\n",
+                              rcctx->rcdbi->dbname, mdb_strerror(rc));
+                break;
             }
-            slapi_ch_free(&rcdata.mv_data);
         }
         rc = MDB_CURSOR_GET(txn_ctx.cursor, &key, &data, MDB_NEXT);
-        recno++;
     }
+    if (rc == MDB_NOTFOUND && count > 0) {
+        /* Last block is partial */
+        rc = dbmdb_recno_cache_put_block(txn_ctx.txn, rcctx->rcdbi->dbi, &blockkey, count);
+        txn_ctx.flags |= DBMDB_TXNCTX_NEED_COMMIT;
+        if (rc) {
+            slapi_log_err(SLAPI_LOG_ERR, "dbmdb_recno_cache_build",
+                          "Failed to write record in db %s, error: %s\n",
+                          rcctx->rcdbi->dbname, mdb_strerror(rc));
+        } else {
+            rc = MDB_NOTFOUND;
+        }
+    }
+    slapi_ch_free(&blockkey.mv_data);
     if (rc == MDB_NOTFOUND) {
         /* Mark the cache as valid */
-        rckey.mv_data = "OK";
-        rckey.mv_size = 2;
-        rc = MDB_PUT(txn_ctx.txn, rcctx->rcdbi->dbi, &rckey, &rckey, 0);
+        rckey.mv_data = RECNOCACHE_VALID_KEY;
+        rckey.mv_size = strlen(RECNOCACHE_VALID_KEY);
+        rcdata.mv_data = &interval;
+        rcdata.mv_size = sizeof interval;
+        rc = MDB_PUT(txn_ctx.txn, rcctx->rcdbi->dbi, &rckey, &rcdata, 0);
         if (rc) {
             slapi_log_err(SLAPI_LOG_ERR, "dbmdb_recno_cache_build",
                           "Failed to write record in db %s, key=%s error: %s\n",
                           rcctx->rcdbi->dbname, (char*)(rckey.mv_data), mdb_strerror(rc));
             }
         txn_ctx.flags |= DBMDB_TXNCTX_NEED_COMMIT;
-    } else {
+    } else if (rc) {
         slapi_log_err(SLAPI_LOG_ERR, "dbmdb_recno_cache_build",
                       "Failed to walk record in db %s, error: %s\n",
                       rcctx->rcdbi->dbname, mdb_strerror(rc));
@@ -2198,7 +2513,7 @@ cache_built:
     return NULL;
 }
 
-/* Find nearest recno cache record from the key */
+/* Find the recno cache block holding the key */
 int dbmdb_recno_cache_lookup(dbi_cursor_t *cursor, MDB_val *cache_key, dbmdb_recno_cache_elmt_t **rce)
 {
     dbmdb_recno_cache_ctx_t rcctx = {0};
@@ -2244,6 +2559,257 @@ int dbmdb_recno_cache_lookup(dbi_cursor_t *cursor, MDB_val *cache_key, dbmdb_rec
     return rc;
 }
 
+/*
+ * Find the block holding the record whose cache key is reckey.
+ * Returns a copy of the block key and the block count.
+ */
+static int
+dbmdb_recno_cache_find_block(MDB_cursor *rccur, MDB_val *reckey, MDB_val *blockkey, uint32_t *count)
+{
+    MDB_val data = {0};
+    MDB_val key = *reckey;
+    int rc = 0;
+
+    rc = MDB_CURSOR_GET(rccur, &key, &data, MDB_SET_RANGE);
+    if (rc != 0 || dbmdb_cmp_vals(&key, reckey) != 0) {
+        /* Greatest block key smaller than the record */
+        if (rc == MDB_NOTFOUND) {
+            rc = MDB_CURSOR_GET(rccur, &key, &data, MDB_LAST);
+        } else if (rc == 0) {
+            rc = MDB_CURSOR_GET(rccur, &key, &data, MDB_PREV);
+        }
+        if (rc == 0 && VD(key)[0] != 'B') {
+            rc = MDB_NOTFOUND;
+        }
+    }
+    if (rc == 0) {
+        blockkey->mv_size = key.mv_size;
+        blockkey->mv_data = slapi_ch_malloc(key.mv_size);
+        memcpy(blockkey->mv_data, key.mv_data, key.mv_size);
+        memcpy(count, data.mv_data, sizeof *count);
+    }
+    return rc;
+}
+
+/* Duplicate a block key */
+static void
+dbmdb_recno_cache_dup_key(MDB_val *dest, MDB_val *src)
+{
+    dest->mv_size = src->mv_size;
+    dest->mv_data = slapi_ch_malloc(src->mv_size);
+    memcpy(dest->mv_data, src->mv_data, src->mv_size);
+}
+
+/*
+ * Account for a record about to be added to the vlv index.
+ * firstkey is the key of a record already in the vlv index that starts the
+ * block: the block is split in two halves when it becomes too large.
+ */
+static int
+dbmdb_recno_cache_insert(MDB_txn *txn, MDB_dbi rcdbi, MDB_cursor *rccur, MDB_cursor *vlvcur, MDB_val *reckey)
+{
+    dbmdb_recno_cache_elmt_t *rce = NULL;
+    MDB_val firstkey = {0};
+    MDB_val blockkey = {0};
+    MDB_val splitkey = {0};
+    MDB_val data = {0};
+    MDB_val key = {0};
+    uint32_t count = 0;
+    uint32_t nb = 0;
+    int rc = 0;
+
+    rc = dbmdb_recno_cache_find_block(rccur, reckey, &firstkey, &count);
+    if (rc == 0) {
+        dbmdb_recno_cache_dup_key(&blockkey, &firstkey);
+    } else if (rc == MDB_NOTFOUND) {
+        /* The record is before the first block: it becomes its first record */
+        key.mv_data = "B";
+        key.mv_size = 1;
+        rc = MDB_CURSOR_GET(rccur, &key, &data, MDB_SET_RANGE);
+        if (rc == 0 && VD(key)[0] == 'B') {
+            dbmdb_recno_cache_dup_key(&firstkey, &key);
+            memcpy(&count, data.mv_data, sizeof count);
+            rc = MDB_DEL(txn, rcdbi, &firstkey, NULL);
+        } else if (rc == 0 || rc == MDB_NOTFOUND) {
+            /* The vlv index is empty */
+            count = 0;
+            rc = 0;
+        }
+        dbmdb_recno_cache_dup_key(&blockkey, reckey);
+    }
+    if (rc) {
+        goto out;
+    }
+    count++;
+    if (count <= 2 * RECNO_CACHE_INTERVAL) {
+        rc = dbmdb_recno_cache_put_block(txn, rcdbi, &blockkey, count);
+        goto out;
+    }
+
+    /* Split the block after RECNO_CACHE_INTERVAL of its current records */
+    rce = block2rce(0, &firstkey);
+    rc = rce ? MDB_CURSOR_GET(vlvcur, &rce->key, &rce->data, MDB_GET_BOTH) : MDB_CORRUPTED;
+    for (nb = 0; rc == 0 && nb < RECNO_CACHE_INTERVAL; nb++) {
+        rc = MDB_CURSOR_GET(vlvcur, &key, &data, MDB_NEXT);
+    }
+    if (rc == 0) {
+        dbmdb_generate_recno_cache_key_by_data(&splitkey, &key, &data);
+        nb = RECNO_CACHE_INTERVAL + (dbmdb_cmp_vals(reckey, &splitkey) < 0);
+        rc = dbmdb_recno_cache_put_block(txn, rcdbi, &blockkey, nb);
+    }
+    if (rc == 0) {
+        rc = dbmdb_recno_cache_put_block(txn, rcdbi, &splitkey, count - nb);
+    }
+
+out:
+    slapi_ch_free((void**)&rce);
+    slapi_ch_free(&splitkey.mv_data);
+    slapi_ch_free(&blockkey.mv_data);
+    slapi_ch_free(&firstkey.mv_data);
+    return rc;
+}
+
+/*
+ * Account for a record about to be removed from the vlv index (vlvcur is
+ * positioned on that record). Small blocks are merged with the next one.
+ */
+static int
+dbmdb_recno_cache_remove(MDB_txn *txn, MDB_dbi rcdbi, MDB_cursor *rccur, MDB_cursor *vlvcur, MDB_val *reckey)
+{
+    MDB_val blockkey = {0};
+    MDB_val nextkey = {0};
+    MDB_val data = {0};
+    MDB_val key = {0};
+    uint32_t nextcount = 0;
+    uint32_t count = 0;
+    int rc = 0;
+
+    rc = dbmdb_recno_cache_find_block(rccur, reckey, &blockkey, &count);
+    if (rc == MDB_NOTFOUND || (rc == 0 && count == 0)) {
+        /* Every record is in a block */
+        rc = MDB_CORRUPTED;
+    }
+    if (rc) {
+        goto out;
+    }
+    count--;
+    if (dbmdb_cmp_vals(&blockkey, reckey) == 0) {
+        /* The block first record is removed: the next record starts the block */
+        rc = MDB_DEL(txn, rcdbi, &blockkey, NULL);
+        slapi_ch_free(&blockkey.mv_data);
+        if (rc == 0 && count > 0) {
+            rc = MDB_CURSOR_GET(vlvcur, &key, &data, MDB_NEXT);
+            if (rc == 0) {
+                dbmdb_generate_recno_cache_key_by_data(&blockkey, &key, &data);
+            }
+        }
+    }
+    if (rc || count == 0) {
+        goto out;
+    }
+    if (count < RECNO_CACHE_INTERVAL / 2) {
+        /* Merge with the next block if the result is not too large */
+        key = blockkey;
+        rc = MDB_CURSOR_GET(rccur, &key, &data, MDB_SET_RANGE);
+        if (rc == 0 && dbmdb_cmp_vals(&key, &blockkey) == 0) {
+            rc = MDB_CURSOR_GET(rccur, &key, &data, MDB_NEXT);
+        }
+        if (rc == 0 && VD(key)[0] == 'B') {
+            memcpy(&nextcount, data.mv_data, sizeof nextcount);
+            if (count + nextcount <= 2 * RECNO_CACHE_INTERVAL) {
+                dbmdb_recno_cache_dup_key(&nextkey, &key);
+                rc = MDB_DEL(txn, rcdbi, &nextkey, NULL);
+                count += nextcount;
+            }
+        } else if (rc == 0 || rc == MDB_NOTFOUND) {
+            rc = 0;
+        }
+    }
+    if (rc == 0) {
+        rc = dbmdb_recno_cache_put_block(txn, rcdbi, &blockkey, count);
+    }
+
+out:
+    slapi_ch_free(&nextkey.mv_data);
+    slapi_ch_free(&blockkey.mv_data);
+    return rc;
+}
+
+/*
+ * Keep the recno cache in sync with a vlv index update.
+ * Must be called in the write txn, before the record is added to or removed
+ * from the vlv index. If the cache cannot be updated it is invalidated, and
+ * will be rebuilt by the next lookup.
+ */
+int
+dbmdb_public_update_vlv_cache(Slapi_Backend *be, dbi_txn_t *txn, dbi_db_t *db, dbi_val_t *key, dbi_val_t *data, int insert)
+{
+    char *rcdbname = dbmdb_recno_cache_get_dbname(((dbmdb_dbi_t*)db)->dbname);
+    dbmdb_dbi_t *dbi = (dbmdb_dbi_t*)db;
+    dbmdb_dbi_t *rcdbi = NULL;
+    MDB_cursor *vlvcur = NULL;
+    MDB_cursor *rccur = NULL;
+    MDB_val reckey = {0};
+    MDB_val valid = {0};
+    MDB_val vdata = {0};
+    MDB_val vkey = {0};
+    MDB_val val = {0};
+    MDB_val dat = {0};
+    int rc = 0;
+
+    DBG_LOG(DBGMDB_LEVEL_VLV, "dbmdb_public_update_vlv_cache(%s) insert=%d", rcdbname, insert);
+    valid.mv_data = RECNOCACHE_VALID_KEY;
+    valid.mv_size = strlen(RECNOCACHE_VALID_KEY);
+    rc = dbmdb_open_dbi_from_filename(&rcdbi, be, rcdbname, NULL, 0);
+    slapi_ch_free_string(&rcdbname);
+    if (rc == 0) {
+        rc = MDB_GET(TXN(txn), rcdbi->dbi, &valid, &val);
+    }
+    if (rc) {
+        /* No usable cache: the next lookup will rebuild it */
+        return 0;
+    }
+
+    dbmdb_dbival2dbt(key, &vkey, PR_FALSE);
+    dbmdb_dbival2dbt(data, &vdata, PR_FALSE);
+    rc = MDB_CURSOR_OPEN(TXN(txn), dbi->dbi, &vlvcur);
+    if (rc == 0) {
+        rc = MDB_CURSOR_OPEN(TXN(txn), rcdbi->dbi, &rccur);
+    }
+    if (rc == 0) {
+        /* Counts only change if the record is really added or removed */
+        val = vkey;
+        dat = vdata;
+        rc = MDB_CURSOR_GET(vlvcur, &val, &dat, MDB_GET_BOTH);
+        if (rc == 0 || rc == MDB_NOTFOUND) {
+            int found = (rc == 0);
+            rc = 0;
+            if (found != insert) {
+                dbmdb_generate_recno_cache_key_by_data(&reckey, &vkey, &vdata);
+                if (insert) {
+                    rc = dbmdb_recno_cache_insert(TXN(txn), rcdbi->dbi, rccur, vlvcur, &reckey);
+                } else {
+                    rc = dbmdb_recno_cache_remove(TXN(txn), rcdbi->dbi, rccur, vlvcur, &reckey);
+                }
+                slapi_ch_free(&reckey.mv_data);
+            }
+        }
+    }
+    if (rccur) {
+        MDB_CURSOR_CLOSE(rccur);
+    }
+    if (vlvcur) {
+        MDB_CURSOR_CLOSE(vlvcur);
+    }
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_WARNING, "dbmdb_public_update_vlv_cache",
+                      "Failed to update vlv cache %s (%s), it will be rebuilt.\n",
+                      rcdbi->dbname, mdb_strerror(rc));
+        rc = MDB_DEL(TXN(txn), rcdbi->dbi, &valid, NULL);
+    }
+    return rc;
+}
+
 int dbmdb_cmp_vals(MDB_val *v1, MDB_val *v2)
 {
     int l;
@@ -2268,23 +2834,13 @@ int dbmdb_cmp_vals(MDB_val *v1, MDB_val *v2)
     return rc;
 }
 
-int dbmdb_cmp_dbi_record(MDB_dbi dbi, MDB_val *key1, MDB_val *data1, MDB_val *key2, MDB_val *data2)
+/* Compare two records using the comparison functions of the cursor dbi */
+static int
+dbmdb_cmp_cursor_records(MDB_cursor *cur, MDB_val *key1, MDB_val *data1, MDB_val *key2, MDB_val *data2)
 {
-    int rc = 0;
-    int n1 = key1 && key1->mv_data && key1->mv_size;
-    int n2 = key2 && key2->mv_data && key2->mv_size;
-
-    rc = n1 - n2 ;
-    if (rc == 0) {
-        rc = dbmdb_cmp_vals(key1, key2);
-    }
-    if (rc == 0) {
-        n1 = data1 && data1->mv_data && data1->mv_size;
-        n2 = data2 && data2->mv_data && data2->mv_size;
-        rc = n1 - n2 ;
-    }
+    int rc = mdb_cmp(mdb_cursor_txn(cur), mdb_cursor_dbi(cur), key1, key2);
     if (rc == 0) {
-        rc = dbmdb_cmp_vals(data1, data2);
+        rc = mdb_dcmp(mdb_cursor_txn(cur), mdb_cursor_dbi(cur), data1, data2);
     }
     return rc;
 }
@@ -2318,20 +2874,25 @@ int dbmdb_cursor_get_recno(dbi_cursor_t *cursor, MDB_val *dbmdb_key, MDB_val *db
     dbmdb_generate_recno_cache_key_by_data(&cache_key, &curpos_key, &curpos_data);
 
     rc = dbmdb_recno_cache_lookup(cursor, &cache_key, &rce);
+    slapi_ch_free(&cache_key.mv_data);
     if (rc == 0) {
         rc = MDB_CURSOR_OPEN(mdb_cursor_txn(cursor->cur), mdb_cursor_dbi(cursor->cur), &newcur);
     }
     if (rc == 0) {
-        rc = MDB_CURSOR_GET(newcur, &rce->key, &rce->data, MDB_SET);
+        rc = MDB_CURSOR_GET(newcur, &rce->key, &rce->data, MDB_GET_BOTH);
     }
+    /* Step from the block first record to the current one */
     while (rc == 0) {
-        cmpres = dbmdb_cmp_dbi_record(mdb_cursor_dbi(cursor->cur), &curpos_key, &curpos_data, &rce->key, &rce->data);
+        cmpres = dbmdb_cmp_cursor_records(newcur, &curpos_key, &curpos_data, &rce->key, &rce->data);
         if (cmpres <= 0) {
             break;
         }
         rce->recno++;
         rc = MDB_CURSOR_GET(newcur, &rce->key, &rce->data, MDB_NEXT);
     }
+    if (newcur) {
+        MDB_CURSOR_CLOSE(newcur);
+    }
     if (cmpres < 0) {
         rc = MDB_NOTFOUND;
     }
@@ -2366,9 +2927,11 @@ int dbmdb_cursor_set_recno(dbi_cursor_t *cursor, MDB_val *dbmdb_key, MDB_val *db
 #endif
     dbmdb_generate_recno_cache_key_by_recno(&cache_key, recno);
     rc = dbmdb_recno_cache_lookup(cursor, &cache_key, &rce);
+    slapi_ch_free(&cache_key.mv_data);
     if (rc ==0) {
-        rc = MDB_CURSOR_GET(cursor->cur, &rce->key, &rce->data, MDB_SET_RANGE);
+        rc = MDB_CURSOR_GET(cursor->cur, &rce->key, &rce->data, MDB_GET_BOTH);
     }
+    /* Step from the block first record to the searched one */
     while (rc == 0 && recno > rce->recno) {
         DBG_LOG(DBGMDB_LEVEL_VLV, "Current record index is %d Target is %d", rce->recno, recno);
         rce->recno++;
@@ -2379,13 +2942,12 @@ int dbmdb_cursor_set_recno(dbi_cursor_t *cursor, MDB_val *dbmdb_key, MDB_val *db
         DBG_LOG(DBGMDB_LEVEL_VLV, "SUCCESS");
         memcpy(dbmdb_data->mv_data , rce->data.mv_data, dbmdb_data->mv_size);
     } else {
-        DBG_LOG(DBGMDB_LEVEL_VLV, "FAILURE: rc=%d dbmdb_data->mv_size=%d rce->data.mv_size=%d", rc, dbmdb_data->mv_size, rce->data.mv_size);
+        DBG_LOG(DBGMDB_LEVEL_VLV, "FAILURE: rc=%d dbmdb_data->mv_size=%d rce->data.mv_size=%d", rc, dbmdb_data->mv_size, rce ? rce->data.mv_size : 0);
     }
 
     slapi_ch_free((void**)&rce);
     return rc;
 }
-
 int dbmdb_public_cursor_op(dbi_cursor_t *cursor,  dbi_op_t op, dbi_val_t *key, dbi_val_t *data)
 {
     MDB_cursor *dbmdb_cur = (MDB_cursor*)cursor->cur;
@@ -2648,6 +3210,25 @@ dbmdb_get_entries_count(dbi_db_t *db, dbi_txn_t *txn, int *count)
     return dbmdb_map_error(__FUNCTION__, rc);
 }
 
+/* Get the size of the pages used by a dbi */
+int
+dbmdb_get_db_size(dbi_db_t *db, dbi_txn_t *txn, uint64_t *size)
+{
+    dbmdb_dbi_t *dbmdb_db = (dbmdb_dbi_t*)db;
+    MDB_stat stats = {0};
+    int rc = 0;
+
+    *size = 0;
+    rc = START_TXN(&txn, txn, TXNFL_RDONLY);
+    if (rc == 0)
+        rc = mdb_stat(TXN(txn), dbmdb_db->dbi, &stats);
+    if (rc == 0)
+        *size = (uint64_t)(stats.ms_branch_pages + stats.ms_leaf_pages +
+                           stats.ms_overflow_pages) * stats.ms_psize;
+    END_TXN(&txn, 1);
+    return dbmdb_map_error(__FUNCTION__, rc);
+}
+
 /* Get the number of duplicates for current key */
 int
 dbmdb_public_cursor_get_count(dbi_cursor_t *cursor, dbi_recno_t *count)
@@ -2861,8 +3442,8 @@ dbmdb_public_clear_vlv_cache(Slapi_Backend *be, dbi_txn_t *txn, dbi_db_t *db)
     int rc = 0;
 
     DBG_LOG(DBGMDB_LEVEL_VLV, "dbmdb_public_clear_vlv_cache(%s)", rcdbname);
-    ok.mv_data = "OK";
-    ok.mv_size = 2;
+    ok.mv_data = RECNOCACHE_VALID_KEY;
+    ok.mv_size = strlen(RECNOCACHE_VALID_KEY);
     rc = dbmdb_open_dbi_from_filename(&rcdbi, be, rcdbname, NULL, 0);
     if (rc == 0) {
         rc = MDB_DEL(TXN(txn), rcdbi->dbi, &ok, NULL);
@@ -41,6 +41,8 @@
 #define CONFIG_MDB_MAX_SIZE       "nsslapd-mdb-max-size"
 #define CONFIG_MDB_MAX_READERS    "nsslapd-mdb-max-readers"
 #define CONFIG_MDB_MAX_DBS        "nsslapd-mdb-max-dbs"
+#define CONFIG_MDB_GROUP_COMMIT_WINDOW "nsslapd-mdb-group-commit-window"
+#define CONFIG_MDB_BACKUP_MAX_THROUGHPUT "nsslapd-mdb-backup-max-throughput"
 
 #define DBMDB_DB_MINSIZE             ( 4LL * MEGABYTE )
 #define DBMDB_DISK_RESERVE(disksize) ((disksize)*2ULL/1000ULL)
@@ -63,9 +65,13 @@
 #define DSE_INDEX           "dse_index.ldif"        /* dse file in backup */
 #define DBMAPFILE           "data.mdb"
 #define INFOFILE            "INFO.mdb"
+#define BACKUP_PAGEMAP      "data.mdb.pagemap"      /* chunk lengths and digests in backup */
+#define BACKUP_INCRFILE     "data.mdb.incr"         /* chunks changed since the base backup */
+#define BACKUP_STATEFILE    "BACKUP.mdb"            /* last backup, in db home */
 #define DBNAMES             "__DBNAMES"
 #define CHANGELOG_PATTERN   "changelog"   /* pattern in changelog dbi name */
 #define RECNOCACHE_PREFIX   "~recno-cache/"
+#define RECNOCACHE_VALID_KEY "OK-blocks"  /* Present when the recno cache block counts are usable */
 
 
 /* config parameters */
@@ -76,6 +82,7 @@ typedef struct
     int max_readers;
     int max_dbs;
     uint64_t max_size;
+    int backup_max_throughput;    /* MB/s read by the backups (0: unlimited) */
 } dbmdb_cfg_t;
 
 /* config parameters limits */
@@ -156,6 +163,25 @@ typedef struct {
     cumuled_time_t lifetime;
 } dbmdb_perfctrs_txn_t;
 
+/*
+ * Group commit: the write txns are committed without sync and the
+ * committers wait for a mdb_env_sync issued by the flusher thread on
+ * behalf of all the txns committed within the window.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t flush_cv;       /* wakes up the flusher */
+    pthread_cond_t done_cv;        /* wakes up the committers */
+    pthread_t flusher;
+    int window;                    /* ms a sync may wait for more committers (0: disabled) */
+    int running;
+    int stopping;
+    uint64_t commit_seq;           /* last txn committed */
+    uint64_t synced_seq;           /* last txn made durable */
+    uint64_t nbsync;               /* number of syncs */
+    uint64_t nbsynced;             /* number of txns made durable by these syncs */
+} dbmdb_group_commit_t;
+
 /* structure which holds our stuff */
 typedef struct dbmdb_ctx_t
 {
@@ -166,6 +192,8 @@ typedef struct dbmdb_ctx_t
     char home[MAXPATHLEN];         /* Home directory */
     pthread_mutex_t dbis_lock;     /* protects dbis access */
     pthread_mutex_t rcmutex;       /* recnum cache mutex */
+    pthread_mutex_t rcindex_mutex; /* protects rcindexes and their refcounts */
+    struct dbmdb_recno_cache_index **rcindexes; /* recnum cache block indexes, by recnum cache dbi */
     pthread_mutex_t perf_lock;     /* txn perf mutex */
     dbmdb_dbi_t *dbi_slots;        /* dbi instances array directly indexed by mdb dbi indices (startcfg.dbmdb_max_dbs slots) */
                                    /* Note: element in above table are only removed when db env get closed */
@@ -177,6 +205,7 @@ typedef struct dbmdb_ctx_t
     perfctrs_private *perf_private;  /* Performance counter data (shared memory) */
     dbmdb_perfctrs_txn_t perf_rotxn; /* Read Only Txn Performance counter */
     dbmdb_perfctrs_txn_t perf_rwtxn; /* Read Write Txn Performance counter */
+    dbmdb_group_commit_t group_commit;
 } dbmdb_ctx_t;
 
 /*
@@ -190,7 +219,7 @@ typedef struct dbmdb_cursor_t
     MDB_cursor *cur;
 } dbmdb_cursor_t;
 
-/* recno cache data */
+/* recno cache lookup result: a block first record and its record number */
 typedef struct {
     MDB_val data;
     MDB_val key;
@@ -331,10 +360,12 @@ dblayer_dbi_txn_commit_fn_t dbmdb_dbi_txn_commit;
 dblayer_dbi_txn_abort_fn_t dbmdb_dbi_txn_abort;
 dblayer_get_entries_count_fn_t dbmdb_get_entries_count;
 dblayer_cursor_get_count_fn_t dbmdb_public_cursor_get_count;
+dblayer_get_db_size_fn_t dbmdb_get_db_size;
 dblayer_private_open_fn_t dbmdb_public_private_open;
 dblayer_private_close_fn_t dbmdb_public_private_close;
 dblayer_compact_fn_t dbmdb_public_dblayer_compact;
 dblayer_clear_vlv_cache_fn_t dbmdb_public_clear_vlv_cache;
+dblayer_update_vlv_cache_fn_t dbmdb_public_update_vlv_cache;
 dblayer_idl_new_fetch_fn_t dbmdb_idl_new_fetch;
 
 
@@ -399,6 +430,11 @@ int dbmdb_import_subcount_mother_count(import_subcount_stuff *mothers, ID parent
 void dbmdb_import_configure_index_buffer_size(size_t size);
 size_t dbmdb_import_get_index_buffer_size(void);
 int dbmdb_ldbm_back_wire_import(Slapi_PBlock *pb);
+int dbmdb_snapshot_fingerprint(backend *be, back_info_snapshot *snap);
+int dbmdb_snapshot_read(backend *be, back_info_snapshot *snap);
+int dbmdb_snapshot_start(backend *be, back_info_snapshot *snap);
+int dbmdb_snapshot_write(backend *be, back_info_snapshot *snap);
+int dbmdb_snapshot_done(backend *be, back_info_snapshot *snap);
 void *dbmdb_factory_constructor(void *object, void *parent);
 void dbmdb_factory_destructor(void *extension, void *object, void *parent);
 int dbmdb_check_db_version(struct ldbminfo *li, int *action);
@@ -490,6 +526,7 @@ int dbmdb_open_cursor(dbmdb_cursor_t *dbicur, dbmdb_ctx_t *ctx, dbmdb_dbi_t *dbi
 int dbmdb_close_cursor(dbmdb_cursor_t *dbicur, int rc);
 int dbmdb_make_env(dbmdb_ctx_t *ctx, int readOnly, mdb_mode_t mode);
 void dbmdb_ctx_close(dbmdb_ctx_t *ctx);
+void dbmdb_recno_cache_free_indexes(dbmdb_ctx_t *ctx);
 int dbmdb_dbitxn_begin(dbmdb_cursor_t *dbicur, const char *funcname, MDB_txn *parent, int readonly);
 int dbmdb_dbitxn_end(dbmdb_cursor_t *dbicur, const char *funcname, int return_code);
 dbi_dbslist_t *dbmdb_list_dbs(const char *dbhome);
@@ -513,4 +550,13 @@ void init_mdbtxn(dbmdb_ctx_t *ctx);
 MDB_txn *dbmdb_txn(dbi_txn_t *txn);
 int dbmdb_is_read_only_txn_thread(void);
 int dbmdb_has_a_txn(void);
+int dbmdb_group_commit_start(dbmdb_ctx_t *ctx);
+void dbmdb_group_commit_stop(dbmdb_ctx_t *ctx);
+void dbmdb_txn_wait_durable(struct ldbminfo *li);
+
+/* mdb_backup.c */
+int dbmdb_backup_db(struct ldbminfo *li, const char *dest_dir, int incremental, Slapi_Task *task);
+int dbmdb_backup_is_incremental(const char *src_dir);
+int dbmdb_backup_check_chain(const char *src_dir, Slapi_Task *task);
+int dbmdb_restore_db(struct ldbminfo *li, const char *src_dir, Slapi_Task *task);
 
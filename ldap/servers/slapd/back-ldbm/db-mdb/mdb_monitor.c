@@ -20,7 +20,7 @@
     do {                                              \
         val.bv_val = buf;                             \
         val.bv_len = strlen(buf);                     \
-        attrlist_replace(&e->e_attrs, (_attr), vals); \
+        entry_replace_values(e, (_attr), vals); \
     } while (0)
 
 #define MSETF(_attr, _x)                                   \
@@ -133,7 +133,7 @@ dbmdb_monitor_instance_search(Slapi_PBlock *pb __attribute__((unused)),
         cache_debug_hash(&(inst->inst_cache), &x);
         val.bv_val = x;
         val.bv_len = strlen(x);
-        attrlist_replace(&e->e_attrs, "entrycache-hashtables", vals);
+        entry_replace_values(e, "entrycache-hashtables", vals);
         slapi_ch_free((void **)&x);
     }
 #endif
@@ -318,6 +318,13 @@ dbmdb_dbmonitor_search(Slapi_PBlock *pb __attribute__((unused)),
     PR_snprintf(buf, sizeof(buf), "%lu", ctx->perf_rwtxn.lifetime.ns/ctx->perf_rwtxn.lifetime.nbsamples);
     MSET("lifeTimeRWtxn");
 
+    if (ctx->group_commit.running) {
+        PR_snprintf(buf, sizeof(buf), "%lu", ctx->group_commit.nbsync);
+        MSET("groupCommitSyncs");
+        PR_snprintf(buf, sizeof(buf), "%lu", ctx->group_commit.nbsynced);
+        MSET("groupCommitSyncedRWtxn");
+    }
+
     PR_snprintf(buf, sizeof(buf), "%lu", ctx->perf_rotxn.nbwaiting);
     MSET("waitingROtxn");
     PR_snprintf(buf, sizeof(buf), "%lu", ctx->perf_rotxn.nbactive);
@@ -33,6 +33,8 @@ typedef struct dbmdb_txn_t {
 static PRUintn thread_private_mdb_txn_stack;
 static dbmdb_ctx_t *g_ctx;  /* Global dbmdb context */
 
+static void dbmdb_group_commit_notify(dbmdb_ctx_t *ctx);
+
 static void
 cleanup_mdbtxn_stack(void *arg)
 {
@@ -237,11 +239,222 @@ int dbmdb_end_txn(const char *funcname, int rc, dbi_txn_t **txn)
 
         ltxn->txn = NULL;
         pop_mdbtxn();
+        if (rc == 0 && !ltxn->parent && (ltxn->flags & (TXNFL_DBI|TXNFL_RDONLY)) != TXNFL_RDONLY) {
+            dbmdb_group_commit_notify(g_ctx);
+        }
         slapi_ch_free((void**)txn);
     }
     return rc;
 }
 
+/*
+ * Group commit
+ *
+ * When nsslapd-mdb-group-commit-window is set, the env is open with MDB_NOSYNC
+ * so that committing a write txn does not sync the map. The flusher thread
+ * issues a single mdb_env_sync for every txn committed until then, waiting at
+ * most the window for the txns still in progress to commit and join the sync.
+ * The backend operations wait in dbmdb_txn_wait_durable(), once the backend
+ * lock is released, until their txn has been synced.
+ */
+
+/* Max time the flusher sleeps when there is no txn to sync */
+#define GROUP_COMMIT_IDLE_SYNC_MS 1000
+
+static void
+group_commit_deadline(struct timespec *deadline, int ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/* Tells whether other write txns may still join the current batch */
+static int
+group_commit_has_writers(dbmdb_ctx_t *ctx)
+{
+    int writers;
+
+    PERF_LOCK();
+    writers = (ctx->perf_rwtxn.nbactive + ctx->perf_rwtxn.nbwaiting) > 0;
+    PERF_UNLOCK();
+    return writers;
+}
+
+static void *
+dbmdb_group_commit_flusher(void *arg)
+{
+    dbmdb_ctx_t *ctx = (dbmdb_ctx_t *)arg;
+    dbmdb_group_commit_t *gc = &ctx->group_commit;
+    size_t last_synced_txnid = 0;
+    struct timespec deadline;
+    MDB_envinfo envinfo = {0};
+    uint64_t target;
+    int rc;
+
+    pthread_mutex_lock(&gc->lock);
+    while (1) {
+        if (gc->commit_seq == gc->synced_seq) {
+            if (gc->stopping) {
+                break;
+            }
+            group_commit_deadline(&deadline, GROUP_COMMIT_IDLE_SYNC_MS);
+            if (pthread_cond_timedwait(&gc->flush_cv, &gc->lock, &deadline) == ETIMEDOUT) {
+                /*
+                 * Some txns are committed without dbmdb_end_txn (i.e dbi
+                 * creation) so sync from time to time if the map changed.
+                 */
+                pthread_mutex_unlock(&gc->lock);
+                if (mdb_env_info(ctx->env, &envinfo) == 0 && envinfo.me_last_txnid != last_synced_txnid) {
+                    mdb_env_sync(ctx->env, 1);
+                    last_synced_txnid = envinfo.me_last_txnid;
+                }
+                pthread_mutex_lock(&gc->lock);
+            }
+            continue;
+        }
+
+        /* Let the txns in progress join this sync until the window expires */
+        group_commit_deadline(&deadline, gc->window);
+        while (!gc->stopping && group_commit_has_writers(ctx)) {
+            if (pthread_cond_timedwait(&gc->flush_cv, &gc->lock, &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+
+        target = gc->commit_seq;
+        pthread_mutex_unlock(&gc->lock);
+        (void) mdb_env_info(ctx->env, &envinfo);
+        rc = mdb_env_sync(ctx->env, 1);
+        if (rc) {
+            /* Like a failed log flush with bdb, the committers are not told */
+            slapi_log_err(SLAPI_LOG_CRIT, "dbmdb_group_commit_flusher",
+                          "Serious Error---Failed to sync the database environment, err=%d (%s)\n",
+                          rc, mdb_strerror(rc));
+            if (LDBM_OS_ERR_IS_DISKFULL(rc)) {
+                operation_out_of_disk_space();
+            }
+        }
+        pthread_mutex_lock(&gc->lock);
+        last_synced_txnid = envinfo.me_last_txnid;
+        gc->nbsync++;
+        gc->nbsynced += target - gc->synced_seq;
+        gc->synced_seq = target;
+        pthread_cond_broadcast(&gc->done_cv);
+    }
+    pthread_mutex_unlock(&gc->lock);
+    return NULL;
+}
+
+/* Starts the flusher if the group commit is configured */
+int
+dbmdb_group_commit_start(dbmdb_ctx_t *ctx)
+{
+    dbmdb_group_commit_t *gc = &ctx->group_commit;
+    pthread_condattr_t condattr;
+    int rc;
+
+    if (gc->window <= 0 || gc->running) {
+        return 0;
+    }
+    rc = mdb_env_set_flags(ctx->env, MDB_NOSYNC, 1);
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_group_commit_start",
+                      "Failed to set MDB_NOSYNC flag, group commit is disabled. err=%d (%s)\n",
+                      rc, mdb_strerror(rc));
+        return rc;
+    }
+    pthread_mutex_init(&gc->lock, NULL);
+    pthread_condattr_init(&condattr);
+    pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&gc->flush_cv, &condattr);
+    pthread_cond_init(&gc->done_cv, NULL);
+    pthread_condattr_destroy(&condattr);
+    gc->commit_seq = gc->synced_seq = 0;
+    gc->stopping = 0;
+
+    rc = pthread_create(&gc->flusher, NULL, dbmdb_group_commit_flusher, ctx);
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dbmdb_group_commit_start",
+                      "Failed to create the flusher thread, group commit is disabled. err=%d\n", rc);
+        mdb_env_set_flags(ctx->env, MDB_NOSYNC, 0);
+        pthread_cond_destroy(&gc->done_cv);
+        pthread_cond_destroy(&gc->flush_cv);
+        pthread_mutex_destroy(&gc->lock);
+        return rc;
+    }
+    gc->running = 1;
+    slapi_log_err(SLAPI_LOG_INFO, "dbmdb_group_commit_start",
+                  "Group commit enabled, window is %d ms\n", gc->window);
+    return 0;
+}
+
+/* Syncs the pending txns then stops the flusher (no more txn may be in progress) */
+void
+dbmdb_group_commit_stop(dbmdb_ctx_t *ctx)
+{
+    dbmdb_group_commit_t *gc = &ctx->group_commit;
+
+    if (!gc->running) {
+        return;
+    }
+    pthread_mutex_lock(&gc->lock);
+    gc->stopping = 1;
+    pthread_cond_signal(&gc->flush_cv);
+    pthread_mutex_unlock(&gc->lock);
+    pthread_join(gc->flusher, NULL);
+
+    gc->running = 0;
+    mdb_env_set_flags(ctx->env, MDB_NOSYNC, 0);
+    mdb_env_sync(ctx->env, 1);
+    pthread_cond_destroy(&gc->done_cv);
+    pthread_cond_destroy(&gc->flush_cv);
+    pthread_mutex_destroy(&gc->lock);
+}
+
+/* A write txn has been committed: let the flusher know it has to be synced */
+static void
+dbmdb_group_commit_notify(dbmdb_ctx_t *ctx)
+{
+    dbmdb_group_commit_t *gc = &ctx->group_commit;
+
+    if (!gc->running) {
+        return;
+    }
+    pthread_mutex_lock(&gc->lock);
+    gc->commit_seq++;
+    pthread_cond_signal(&gc->flush_cv);
+    pthread_mutex_unlock(&gc->lock);
+}
+
+/*
+ * Waits until the txns committed so far (including the ones committed
+ * by the current thread) are durable.
+ * Must not be called while holding a txn or the backend lock, otherwise
+ * the other committers could not join the sync.
+ */
+void
+dbmdb_txn_wait_durable(struct ldbminfo *li)
+{
+    dbmdb_ctx_t *ctx = MDB_CONFIG(li);
+    dbmdb_group_commit_t *gc = &ctx->group_commit;
+    uint64_t target;
+
+    if (!gc->running || !ctx->dsecfg.durable_transactions || dbmdb_has_a_txn()) {
+        return;
+    }
+    pthread_mutex_lock(&gc->lock);
+    target = gc->commit_seq;
+    while (gc->synced_seq < target) {
+        pthread_cond_wait(&gc->done_cv, &gc->lock);
+    }
+    pthread_mutex_unlock(&gc->lock);
+}
+
 /* Convert dbi_txn_t to MDB_txn */
 MDB_txn *dbmdb_txn(dbi_txn_t *txn)
 {
@@ -360,6 +360,13 @@ int dblayer_get_entries_count(Slapi_Backend *be, dbi_db_t *db, dbi_txn_t *txn, i
     return priv->dblayer_get_entries_count_fn(db, txn, count);
 }
 
+/* Get the space used by a database instance (in bytes) */
+int dblayer_get_db_size(Slapi_Backend *be, dbi_db_t *db, dbi_txn_t *txn, uint64_t *size)
+{
+    dblayer_private *priv = dblayer_get_priv(be);
+    return priv->dblayer_get_db_size_fn(db, txn, size);
+}
+
 const char *dblayer_op2str(dbi_op_t op)
 {
     static const char *str[] = {
@@ -64,6 +64,7 @@
 #endif
 #include "back-ldbm.h"
 #include "dblayer.h"
+#include "slapd-probes.h"
 #include <prthread.h>
 #include <prclist.h>
 
@@ -462,6 +463,10 @@ dblayer_instance_close(backend *be)
                       inst->inst_name);
     }
 
+    /* e.g. an import recreates the index files: rebuilt at the next start */
+    inst->inst_subtreepath_ready = 0;
+    inst->inst_ancestorid_stale = 0;
+
     return_value = dblayer_close_indexes(be);
     return_value |= dblayer_close_changelog(be);
 
@@ -740,6 +745,7 @@ dblayer_txn_begin(backend *be, back_txnid parent_txn, back_txn *txn)
 {
     struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
     int rc = 0;
+    SLAPD_PROBE1(txn__begin, txn);
     if (DBLOCK_INSIDE_TXN(li)) {
         rc = dblayer_txn_begin_ext(li, parent_txn, txn, PR_TRUE);
         if (!rc && SERIALLOCK(li)) {
@@ -781,6 +787,7 @@ int
 dblayer_txn_commit(backend *be, back_txn *txn)
 {
     struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    dblayer_private *priv = (dblayer_private *)li->li_dblayer_private;
     int rc;
     if (DBLOCK_INSIDE_TXN(li)) {
         if (SERIALLOCK(li)) {
@@ -793,6 +800,11 @@ dblayer_txn_commit(backend *be, back_txn *txn)
             dblayer_unlock_backend(be);
         }
     }
+    /* With group commit, the txn is durable once the pending sync is done */
+    if (0 == rc && priv->dblayer_txn_wait_durable_fn) {
+        priv->dblayer_txn_wait_durable_fn(li);
+    }
+    SLAPD_PROBE2(txn__commit, txn, rc);
     return rc;
 }
 
@@ -832,6 +844,7 @@ dblayer_txn_abort(backend *be, back_txn *txn)
             dblayer_unlock_backend(be);
         }
     }
+    SLAPD_PROBE2(txn__abort, txn, rc);
     return rc;
 }
 
@@ -1349,6 +1362,11 @@ ldbm_back_ctrl_info(Slapi_Backend *be, int cmd, void *info)
     }
     dblayer_private *prv = (dblayer_private *)li->li_dblayer_private;
 
+    /* Does not depend on the database implementation */
+    if (cmd == BACK_INFO_INDEX_LOOKUP) {
+        return index_lookup_entries(be, (back_info_index_lookup *)info);
+    }
+
     return  prv->dblayer_back_ctrl_fn(be, cmd, info);
 }
 
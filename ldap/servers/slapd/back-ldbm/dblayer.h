@@ -75,6 +75,7 @@ typedef int dblayer_restore_fn_t(struct ldbminfo *li, char *src_dir, Slapi_Task
 typedef int dblayer_txn_begin_fn_t(struct ldbminfo *li, back_txnid parent_txn, back_txn *txn, PRBool use_lock);
 typedef int dblayer_txn_commit_fn_t(struct ldbminfo *li, back_txn *txn, PRBool use_lock);
 typedef int dblayer_txn_abort_fn_t(struct ldbminfo *li, back_txn *txn, PRBool use_lock);
+typedef void dblayer_txn_wait_durable_fn_t(struct ldbminfo *li);
 typedef int dblayer_get_info_fn_t(Slapi_Backend *be, int cmd, void **info);
 typedef int dblayer_set_info_fn_t(Slapi_Backend *be, int cmd, void **info);
 typedef int dblayer_back_ctrl_fn_t(Slapi_Backend *be, int cmd, void *info);
@@ -112,6 +113,7 @@ typedef int dblayer_dbi_txn_commit_fn_t(dbi_txn_t *txn);
 typedef int dblayer_dbi_txn_abort_fn_t(dbi_txn_t *txn);
 typedef int dblayer_get_entries_count_fn_t(dbi_db_t *db, dbi_txn_t *txn, int *count);
 typedef int dblayer_cursor_get_count_fn_t(dbi_cursor_t *cursor, dbi_recno_t *count);
+typedef int dblayer_get_db_size_fn_t(dbi_db_t *db, dbi_txn_t *txn, uint64_t *size);
 typedef int dblayer_private_open_fn_t(backend *be, const char *db_filename, int rw, dbi_env_t **env, dbi_db_t **db);
 typedef int dblayer_private_close_fn_t(struct ldbminfo *li, dbi_env_t **env, dbi_db_t **db);
 typedef int ldbm_back_wire_import_fn_t(Slapi_PBlock *pb);
@@ -123,6 +125,7 @@ typedef int dblayer_show_stat_fn_t(const char *dbhome, FILE *fout, FILE *ferr);
 typedef int dblayer_in_import_fn_t(ldbm_instance *inst);
 typedef const char *dblayer_get_db_suffix_fn_t(void);
 typedef int dblayer_clear_vlv_cache_fn_t(backend *be, dbi_txn_t *txn, dbi_db_t *db);
+typedef int dblayer_update_vlv_cache_fn_t(backend *be, dbi_txn_t *txn, dbi_db_t *db, dbi_val_t *key, dbi_val_t *data, int insert);
 typedef int dblayer_dbi_db_remove_fn_t(backend *be, dbi_db_t *db);
 typedef IDList *dblayer_idl_new_fetch_fn_t(backend *be, dbi_db_t *db, dbi_val_t *inkey, dbi_txn_t *txn,
                                   struct attrinfo *a, int *flag_err, int allidslimit);
@@ -158,6 +161,7 @@ struct dblayer_private
     dblayer_txn_begin_fn_t *dblayer_txn_begin_fn;
     dblayer_txn_commit_fn_t *dblayer_txn_commit_fn;
     dblayer_txn_abort_fn_t *dblayer_txn_abort_fn;
+    dblayer_txn_wait_durable_fn_t *dblayer_txn_wait_durable_fn; /* optional: waits for committed txns to be durable */
     dblayer_get_info_fn_t *dblayer_get_info_fn;
     dblayer_set_info_fn_t *dblayer_set_info_fn;
     dblayer_back_ctrl_fn_t *dblayer_back_ctrl_fn;
@@ -197,6 +201,7 @@ struct dblayer_private
     dblayer_dbi_txn_abort_fn_t *dblayer_dbi_txn_abort_fn;
     dblayer_get_entries_count_fn_t *dblayer_get_entries_count_fn;
     dblayer_cursor_get_count_fn_t *dblayer_cursor_get_count_fn;
+    dblayer_get_db_size_fn_t *dblayer_get_db_size_fn;
     dblayer_private_open_fn_t *dblayer_private_open_fn;
     dblayer_private_close_fn_t *dblayer_private_close_fn;
     ldbm_back_wire_import_fn_t *ldbm_back_wire_import_fn;
@@ -209,6 +214,7 @@ struct dblayer_private
     dblayer_get_db_suffix_fn_t *dblayer_get_db_suffix_fn;
     dblayer_compact_fn_t *dblayer_compact_fn;
     dblayer_clear_vlv_cache_fn_t *dblayer_clear_vlv_cache_fn;
+    dblayer_update_vlv_cache_fn_t *dblayer_update_vlv_cache_fn;
     dblayer_dbi_db_remove_fn_t *dblayer_dbi_db_remove_fn;
     dblayer_idl_new_fetch_fn_t *dblayer_idl_new_fetch_fn;
     dblayer_cursor_iterate_fn_t *dblayer_cursor_iterate_fn;
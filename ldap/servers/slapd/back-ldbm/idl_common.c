@@ -14,6 +14,7 @@
 /* Common IDL code, used in both old and new indexing schemes */
 
 #include "back-ldbm.h"
+#include <sys/mman.h>
 
 size_t
 idl_sizeof(IDList *idl)
@@ -86,6 +87,91 @@ idl_free(IDList **idl)
     slapi_ch_free((void **)idl);
 }
 
+static int
+idl_spill_write(int fd, const void *buf, size_t len)
+{
+    const char *p = buf;
+
+    while (len > 0) {
+        ssize_t rc = write(fd, p, len);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += rc;
+        len -= rc;
+    }
+    return 0;
+}
+
+/*
+ * idl_spill - copy an id list to an unlinked temporary file in dir, and
+ * map it read only. Unlike the heap, the pages of the mapping can be
+ * reclaimed by the kernel while the list is not read, so long lived
+ * lists can be kept at little memory cost. The mapped list can only be
+ * read (e.g. with the idl_iterator functions), and must be released
+ * with idl_spill_free(). The caller keeps the ownership of idl.
+ *
+ * Returns the mapped list and its size in *size, or NULL on failure.
+ */
+IDList *
+idl_spill(IDList *idl, const char *dir, size_t *size)
+{
+    IDList header = {0};
+    char *path = NULL;
+    void *map = MAP_FAILED;
+    size_t len;
+    int fd;
+
+    if (NULL == idl || ALLIDS(idl) || 0 == idl->b_nids || NULL == dir) {
+        return NULL;
+    }
+    path = slapi_ch_smprintf("%s/spill-XXXXXX", dir);
+    fd = mkstemp(path);
+    if (fd < 0) {
+        slapi_log_err(SLAPI_LOG_ERR, "idl_spill",
+                      "Failed to create %s: %s (%d)\n", path, slapd_system_strerror(errno), errno);
+        slapi_ch_free_string(&path);
+        return NULL;
+    }
+    /* The file is gone as soon as it is unmapped */
+    unlink(path);
+
+    header.b_nmax = idl->b_nids;
+    header.b_nids = idl->b_nids;
+    len = offsetof(IDList, b_ids) + idl->b_nids * sizeof(ID);
+    if (idl_spill_write(fd, &header, offsetof(IDList, b_ids)) ||
+        idl_spill_write(fd, idl->b_ids, idl->b_nids * sizeof(ID))) {
+        slapi_log_err(SLAPI_LOG_ERR, "idl_spill",
+                      "Failed to write %s: %s (%d)\n", path, slapd_system_strerror(errno), errno);
+    } else {
+        map = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+        if (MAP_FAILED == map) {
+            slapi_log_err(SLAPI_LOG_ERR, "idl_spill",
+                          "Failed to map %s: %s (%d)\n", path, slapd_system_strerror(errno), errno);
+        }
+    }
+    close(fd);
+    slapi_ch_free_string(&path);
+    if (MAP_FAILED == map) {
+        return NULL;
+    }
+    *size = len;
+    return (IDList *)map;
+}
+
+void
+idl_spill_free(IDList **idl, size_t size)
+{
+    if ((NULL == idl) || (NULL == *idl)) {
+        return;
+    }
+    munmap(*idl, size);
+    *idl = NULL;
+}
+
 
 /*
  * idl_append - append an id to an id list.
@@ -493,14 +493,25 @@ index_addordel_entry(
          * . . . only if we are not deleting a tombstone entry -
          * tombstone entries are not in the ancestor id index -
          * see bug 603279
+         * . . . and not while the subtreepath index replaces it
          */
-        if (!((flags & BE_INDEX_TOMBSTONE) && (flags & BE_INDEX_DEL))) {
+        if (!((flags & BE_INDEX_TOMBSTONE) && (flags & BE_INDEX_DEL)) && !ldbm_ancestorid_is_stale(be)) {
             result = ldbm_ancestorid_index_entry(be, e, flags, txn);
             if (result != 0) {
                 return (result);
             }
         }
 
+        /*
+         * update subtreepath index, tombstones are not added but
+         * may have been by an older rebuild, so also when deleting
+         * a tombstone entry
+         */
+        result = ldbm_subtreepath_index_entry(be, e, flags, txn);
+        if (result != 0) {
+            return (result);
+        }
+
         result = entryrdn_index_entry(be, e, flags, txn);
         if (result != 0) {
             ldbm_nasty("index_addordel_entry", errmsg, 1031, result);
@@ -1126,6 +1137,75 @@ index_read_ext(
     return index_read_ext_allids(NULL, be, type, indextype, val, txn, err, unindexed, 0);
 }
 
+/*
+ * Looks values of an attribute up in its equality index, and returns
+ * copies of the entries having one of them (BACK_INFO_INDEX_LOOKUP).
+ * The entries a search leaves out unless asked for (tombstones,
+ * ldapsubentries and replication conflicts) are not returned.
+ *
+ * The lookup is done in the transaction of the calling thread: from a
+ * betxn plugin, it sees the updates of the operation.
+ */
+int
+index_lookup_entries(backend *be, back_info_index_lookup *lookup)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    back_txn txn = {NULL};
+    Slapi_Attr sattr;
+    size_t nentries = 0;
+    int rc = 0;
+
+    lookup->entries = NULL;
+    lookup->unindexed = 0;
+    dblayer_txn_init(li, &txn);
+    slapi_attr_init(&sattr, lookup->type);
+
+    for (size_t i = 0; lookup->values && lookup->values[i] && rc == 0 && !lookup->unindexed; i++) {
+        Slapi_Value sv = {0};
+        Slapi_Value **keys = NULL;
+
+        sv.bv = *lookup->values[i];
+        slapi_attr_assertion2keys_ava_sv(&sattr, &sv, &keys, LDAP_FILTER_EQUALITY);
+        for (size_t k = 0; keys && keys[k] && rc == 0 && !lookup->unindexed; k++) {
+            IDList *idl = index_read_ext(be, (char *)lookup->type, indextype_EQUALITY,
+                                         slapi_value_get_berval(keys[k]), &txn, &rc, &lookup->unindexed);
+
+            if (idl && ALLIDS(idl)) {
+                /* over the idlistscanlimit: the index cannot tell */
+                lookup->unindexed = 1;
+            }
+            for (ID id = idl_firstid(idl); rc == 0 && !lookup->unindexed && id != NOID; id = idl_nextid(idl, id)) {
+                struct backentry *e = id2entry(be, id, &txn, &rc);
+
+                if (e == NULL) {
+                    continue;
+                }
+                if (!slapi_entry_flag_is_set(e->ep_entry, SLAPI_ENTRY_FLAG_TOMBSTONE) &&
+                    !slapi_entry_flag_is_set(e->ep_entry, SLAPI_ENTRY_FLAG_LDAPSUBENTRY) &&
+                    !slapi_entry_attr_exists(e->ep_entry, ATTR_NSDS5_REPLCONFLICT)) {
+                    lookup->entries = (Slapi_Entry **)slapi_ch_realloc((char *)lookup->entries,
+                                                                       (nentries + 2) * sizeof(Slapi_Entry *));
+                    lookup->entries[nentries++] = slapi_entry_dup(e->ep_entry);
+                    lookup->entries[nentries] = NULL;
+                }
+                CACHE_RETURN(&inst->inst_cache, &e);
+            }
+            idl_free(&idl);
+        }
+        valuearray_free(&keys);
+    }
+    attr_done(&sattr);
+
+    if (rc || lookup->unindexed) {
+        for (size_t i = 0; i < nentries; i++) {
+            slapi_entry_free(lookup->entries[i]);
+        }
+        slapi_ch_free((void **)&lookup->entries);
+    }
+    return rc;
+}
+
 /* This function compares two index keys.  It is assumed
    that the values are already normalized, since they should have
    been when the index was created (by int_values2keys).
@@ -229,6 +229,11 @@ ldbm_instance_create_default_indexes(backend *be)
     attr_index_config(be, "ldbm index init", 0, e, 1, 0, NULL);
     slapi_entry_free(e);
 
+    /* subtreepath is another pseudo index, see subtreepath.c */
+    e = ldbm_instance_init_config_entry(LDBM_SUBTREEPATH_STR, "eq", 0, 0, 0);
+    attr_index_config(be, "ldbm index init", 0, e, 1, 0, NULL);
+    slapi_entry_free(e);
+
     return 0;
 }
 
@@ -254,6 +259,10 @@ ldbm_instance_start(backend *be)
 
     PR_Unlock(be->be_state_lock);
 
+    if (rc == 0) {
+        rc = ldbm_subtreepath_start(be);
+    }
+
     return rc;
 }
 
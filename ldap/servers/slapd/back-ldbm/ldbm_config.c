@@ -416,6 +416,60 @@ ldbm_config_pagedallidsthreshold_set(void *arg, void *value, char *errorbuf __at
     return retval;
 }
 
+static void *
+ldbm_config_pagedspillthreshold_get(void *arg)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+
+    return (void *)((uintptr_t)(li->li_pagedspillthreshold));
+}
+
+static int
+ldbm_config_pagedspillthreshold_set(void *arg, void *value, char *errorbuf, int phase __attribute__((unused)), int apply)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+    int val = (int)((uintptr_t)value);
+
+    /* value of 0 means the candidates of paged searches always stay in memory */
+    if (val < 0) {
+        slapi_create_errormsg(errorbuf, SLAPI_DSE_RETURNTEXT_SIZE,
+                              "Invalid value for %s (%d). Must be 0 or greater\n",
+                              CONFIG_PAGEDSPILLTHRESHOLD, val);
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+
+    if (apply) {
+        li->li_pagedspillthreshold = val;
+    }
+
+    return LDAP_SUCCESS;
+}
+
+static void *
+ldbm_config_subtreepath_get(void *arg)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+
+    return (void *)((uintptr_t)li->li_subtreepath);
+}
+
+static int
+ldbm_config_subtreepath_set(void *arg,
+                            void *value,
+                            char *errorbuf __attribute__((unused)),
+                            int phase __attribute__((unused)),
+                            int apply)
+{
+    struct ldbminfo *li = (struct ldbminfo *)arg;
+
+    /* taken into account when the instances start */
+    if (apply) {
+        li->li_subtreepath = (int)((uintptr_t)value);
+    }
+
+    return LDAP_SUCCESS;
+}
+
 static void *
 ldbm_config_directory_get(void *arg)
 {
@@ -944,6 +998,8 @@ static config_info ldbm_config[] = {
     {CONFIG_USE_LEGACY_ERRORCODE, CONFIG_TYPE_ONOFF, "off", &ldbm_config_legacy_errcode_get, &ldbm_config_legacy_errcode_set, 0},
     {CONFIG_PAGEDLOOKTHROUGHLIMIT, CONFIG_TYPE_INT, "0", &ldbm_config_pagedlookthroughlimit_get, &ldbm_config_pagedlookthroughlimit_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
     {CONFIG_PAGEDIDLISTSCANLIMIT, CONFIG_TYPE_INT, "0", &ldbm_config_pagedallidsthreshold_get, &ldbm_config_pagedallidsthreshold_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
+    {CONFIG_PAGEDSPILLTHRESHOLD, CONFIG_TYPE_INT, "100000", &ldbm_config_pagedspillthreshold_get, &ldbm_config_pagedspillthreshold_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
+    {CONFIG_SUBTREEPATH_INDEX, CONFIG_TYPE_ONOFF, "off", &ldbm_config_subtreepath_get, &ldbm_config_subtreepath_set, CONFIG_FLAG_ALWAYS_SHOW},
     {CONFIG_RANGELOOKTHROUGHLIMIT, CONFIG_TYPE_INT, "5000", &ldbm_config_rangelookthroughlimit_get, &ldbm_config_rangelookthroughlimit_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
     {CONFIG_BACKEND_OPT_LEVEL, CONFIG_TYPE_INT, "1", &ldbm_config_backend_opt_level_get, &ldbm_config_backend_opt_level_set, CONFIG_FLAG_ALWAYS_SHOW},
     {CONFIG_BACKEND_IMPLEMENT, CONFIG_TYPE_STRING, "bdb", &ldbm_config_backend_implement_get, &ldbm_config_backend_implement_set, CONFIG_FLAG_ALWAYS_SHOW | CONFIG_FLAG_ALLOW_RUNNING_CHANGE},
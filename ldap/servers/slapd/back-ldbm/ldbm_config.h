@@ -61,6 +61,8 @@ struct config_info
 #define CONFIG_PAGEDLOOKTHROUGHLIMIT "nsslapd-pagedlookthroughlimit"
 #define CONFIG_IDLISTSCANLIMIT "nsslapd-idlistscanlimit"
 #define CONFIG_PAGEDIDLISTSCANLIMIT "nsslapd-pagedidlistscanlimit"
+#define CONFIG_PAGEDSPILLTHRESHOLD "nsslapd-pagedspillthreshold"
+#define CONFIG_SUBTREEPATH_INDEX "nsslapd-subtreepath-index"
 #define CONFIG_DIRECTORY "nsslapd-directory"
 #define CONFIG_MODE "nsslapd-mode"
 #define CONFIG_DBCACHESIZE "nsslapd-dbcachesize"
@@ -754,12 +754,12 @@ ldbm_instance_search_config_entry_callback(Slapi_PBlock *pb __attribute__((unuse
     returntext[0] = '\0';
 
     /* show the suffixes */
-    attrlist_delete(&e->e_attrs, CONFIG_INSTANCE_SUFFIX);
+    slapi_entry_attr_delete(e, CONFIG_INSTANCE_SUFFIX);
     suffix = slapi_be_getsuffix(inst->inst_be, 0);
     if (suffix != NULL) {
         val.bv_val = (char *)slapi_sdn_get_dn(suffix);
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&e->e_attrs, CONFIG_INSTANCE_SUFFIX, vals);
+        slapi_entry_attr_merge(e, CONFIG_INSTANCE_SUFFIX, vals);
     }
 
     PR_Lock(inst->inst_config_mutex);
@@ -1084,19 +1084,35 @@ ldbm_back_modrdn(Slapi_PBlock *pb)
         }
 
         /*
-         * Update ancestorid index.
+         * Update ancestorid index, unless the subtreepath index replaces it.
          */
         if (slapi_sdn_get_dn(dn_newsuperiordn) != NULL) {
-            retval = ldbm_ancestorid_move_subtree(be, sdn, &dn_newdn, e->ep_id, children, &txn);
-            if (retval != 0) {
-                if (retval == DBI_RC_RETRY) {
-                    continue;
+            if (!ldbm_ancestorid_is_stale(be)) {
+                retval = ldbm_ancestorid_move_subtree(be, sdn, &dn_newdn, e->ep_id, children, &txn);
+                if (retval != 0) {
+                    if (retval == DBI_RC_RETRY) {
+                        continue;
+                    }
+                    if (retval == DBI_RC_RUNRECOVERY || LDBM_OS_ERR_IS_DISKFULL(retval))
+                        disk_full = 1;
+                    MOD_SET_ERROR(ldap_result_code,
+                                  LDAP_OPERATIONS_ERROR, retry_count);
+                    goto error_return;
+                }
+            }
+            /* Update subtreepath index: only the moved subtree, before entryrdn changes */
+            if (newparententry) {
+                retval = ldbm_subtreepath_move_subtree(be, e->ep_id, newparententry->ep_id, &txn);
+                if (retval != 0) {
+                    if (retval == DBI_RC_RETRY) {
+                        continue;
+                    }
+                    if (retval == DBI_RC_RUNRECOVERY || LDBM_OS_ERR_IS_DISKFULL(retval))
+                        disk_full = 1;
+                    MOD_SET_ERROR(ldap_result_code,
+                                  LDAP_OPERATIONS_ERROR, retry_count);
+                    goto error_return;
                 }
-                if (retval == DBI_RC_RUNRECOVERY || LDBM_OS_ERR_IS_DISKFULL(retval))
-                    disk_full = 1;
-                MOD_SET_ERROR(ldap_result_code,
-                              LDAP_OPERATIONS_ERROR, retry_count);
-                goto error_return;
             }
         }
         /*
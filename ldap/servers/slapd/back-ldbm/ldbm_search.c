@@ -18,6 +18,7 @@
 
 #include "back-ldbm.h"
 #include "vlv_srch.h"
+#include "slapd-probes.h"
 
 /*
  * Used for ldap_result passed to ldbm_back_search_cleanup.
@@ -209,6 +210,42 @@ ldbm_back_search_cleanup(Slapi_PBlock *pb,
     return function_result;
 }
 
+/*
+ * A simple paged search keeps its candidate list until its last page is
+ * sent, possibly for a long time. Above nsslapd-pagedspillthreshold ids,
+ * the list is moved out of the heap to a file mapping, whose pages the
+ * kernel can reclaim. The heap copy is freed by ldbm_back_search_cleanup,
+ * as it is not the result set list anymore. The memory held by the search
+ * is reported for the connection monitor.
+ */
+static void
+ldbm_search_spill_candidates(Slapi_PBlock *pb, struct ldbminfo *li, back_search_result_set *sr)
+{
+    Connection *conn = NULL;
+    Operation *op = NULL;
+    IDList *spilled = NULL;
+    size_t mem = sizeof(back_search_result_set);
+    int threshold = li->li_pagedspillthreshold;
+    int pr_idx = -1;
+
+    if (sr->sr_candidates && !ALLIDS(sr->sr_candidates)) {
+        if (threshold > 0 && !sr->sr_virtuallistview &&
+            sr->sr_candidates->b_nids >= (NIDS)threshold) {
+            spilled = idl_spill(sr->sr_candidates, li->li_directory, &sr->sr_spilled_size);
+        }
+        if (spilled) {
+            sr->sr_candidates = spilled;
+        } else {
+            mem += idl_sizeof(sr->sr_candidates);
+        }
+    }
+
+    slapi_pblock_get(pb, SLAPI_OPERATION, &op);
+    slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
+    slapi_pblock_get(pb, SLAPI_PAGED_RESULTS_INDEX, &pr_idx);
+    pagedresults_set_search_result_mem(conn, op, mem, sr->sr_spilled_size, pr_idx);
+}
+
 static int
 ldbm_search_compile_filter(Slapi_Filter *f, void *arg __attribute__((unused)))
 {
@@ -662,8 +699,12 @@ ldbm_back_search(Slapi_PBlock *pb)
             }
         }
         if (candidates == NULL) {
-            int rc = build_candidate_list(pb, be, e, base, scope,
-                                          &lookup_returned_allids, &candidates);
+            int rc;
+
+            SLAPD_PROBE1(search__candidates__entry, scope);
+            rc = build_candidate_list(pb, be, e, base, scope,
+                                      &lookup_returned_allids, &candidates);
+            SLAPD_PROBE2(search__candidates__return, rc, IDL_NIDS(candidates));
             if (rc) {
                 /* Error result sent by build_candidate_list */
                 if (virtual_list_view) {
@@ -1025,6 +1066,10 @@ ldbm_back_search(Slapi_PBlock *pb)
     } else {
         slapi_log_err(SLAPI_LOG_FILTER, "ldbm_back_search", "Skipped Filter Test\n");
     }
+
+    if (op_is_pagedresults(operation) && (tmp_err == LDBM_SRCH_DEFAULT_RESULT)) {
+        ldbm_search_spill_candidates(pb, li, sr);
+    }
 bail:
     /* Fix for bugid #394184, SD, 05 Jul 00 */
     /* tmp_err == LDBM_SRCH_DEFAULT_RESULT: no error */
@@ -1346,20 +1391,35 @@ subtree_candidates(
 
         if (!has_tombstone_filter && !is_bulk_import) {
             struct component_keys_lookup *key_stat;
+            const char *index_name = LDBM_ANCESTORID_STR;
 
             if (op_stat) {
                 /* gather the index lookup statistics */
                 key_stat = (struct component_keys_lookup *) slapi_ch_calloc(1, sizeof (struct component_keys_lookup));
                 clock_gettime(CLOCK_MONOTONIC, &key_stat->key_lookup_start);
             }
-            *err = ldbm_ancestorid_read_ext(be, &txn, e->ep_id, &descendants, allidslimit);
+            if ((ldbm_subtreepath_is_ready(be) || ldbm_ancestorid_is_stale(be)) && !ALLIDS(candidates)) {
+                /* the path of each candidate, rather than all the descendants */
+                index_name = LDBM_SUBTREEPATH_STR;
+                *err = ldbm_subtreepath_restrict(be, &txn, e->ep_id, &candidates);
+                tmp = NULL;
+            } else {
+                if (ldbm_subtreepath_is_ready(be)) {
+                    /* a key range of the subtreepath index */
+                    index_name = LDBM_SUBTREEPATH_STR;
+                    *err = ldbm_subtreepath_read_ext(be, &txn, e->ep_id, &descendants, allidslimit);
+                } else {
+                    *err = ldbm_ancestorid_read_ext(be, &txn, e->ep_id, &descendants, allidslimit);
+                }
+                idl_insert(&descendants, e->ep_id);
+                candidates = idl_intersection(be, candidates, descendants);
+            }
             if (op_stat) {
                 clock_gettime(CLOCK_MONOTONIC, &key_stat->key_lookup_end);
-                /* records ancestorid lookups */
-                stat_add_srch_lookup(op_stat, key_stat, LDBM_ANCESTORID_STR, indextype_EQUALITY, key_value, descendants ? descendants->b_nids : 0);
+                /* records ancestorid (or subtreepath) lookups */
+                stat_add_srch_lookup(op_stat, key_stat, (char *)index_name,
+                                     indextype_EQUALITY, key_value, descendants ? descendants->b_nids : IDL_NIDS(candidates));
             }
-            idl_insert(&descendants, e->ep_id);
-            candidates = idl_intersection(be, candidates, descendants);
             idl_free(&tmp);
             idl_free(&descendants);
         }
@@ -1797,6 +1857,8 @@ ldbm_back_next_search_entry(Slapi_PBlock *pb)
             int filter_test = -1;
             int is_bulk_import = operation_is_flag_set(op, OP_FLAG_BULK_IMPORT);
 
+            SLAPD_PROBE1(search__filter__entry, e->ep_id);
+
             if (is_bulk_import) {
                 /* If it is from bulk import, no need to check. */
                 filter_test = 0;
@@ -1896,6 +1958,7 @@ ldbm_back_next_search_entry(Slapi_PBlock *pb)
                     }
                 }
             }
+            SLAPD_PROBE2(search__filter__return, e->ep_id, filter_test);
             slapi_log_err(SLAPI_LOG_FILTER, "ldbm_back_next_search_entry",
                           "filter test value %d %s \n", filter_test, slapi_entry_get_dn_const(e->ep_entry));
             if ((filter_test == 0) || (sr->sr_virtuallistview && (filter_test != -1)))
@@ -2039,7 +2102,9 @@ delete_search_result_set(Slapi_PBlock *pb, back_search_result_set **sr)
         pagedresults_set_search_result_pb(pb, NULL, 0);
         slapi_pblock_set(pb, SLAPI_SEARCH_RESULT_SET, NULL);
     }
-    if (NULL != (*sr)->sr_candidates) {
+    if ((*sr)->sr_spilled_size) {
+        idl_spill_free(&((*sr)->sr_candidates), (*sr)->sr_spilled_size);
+    } else if (NULL != (*sr)->sr_candidates) {
         idl_free(&((*sr)->sr_candidates));
     }
     rc = slapi_filter_apply((*sr)->sr_norm_filter, ldbm_search_free_compiled_filter,
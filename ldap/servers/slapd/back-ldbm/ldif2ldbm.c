@@ -207,8 +207,12 @@ int
 ldbm_back_ldbm2index(Slapi_PBlock *pb)
 {
     struct ldbminfo *li;
+    ldbm_instance *inst = NULL;
+    char *instance_name = NULL;
+    char **attrs = NULL;
     int32_t run_from_cmdline = 0;
     int task_flags;
+    int rc;
 
     slapi_pblock_get(pb, SLAPI_PLUGIN_PRIVATE, &li);
     slapi_pblock_get(pb, SLAPI_TASK_FLAGS, &task_flags);
@@ -225,7 +229,38 @@ ldbm_back_ldbm2index(Slapi_PBlock *pb)
 
     dblayer_private *priv = (dblayer_private *)li->li_dblayer_private;
 
-    return priv->dblayer_db2index_fn(pb);;
+    /*
+     * Reindexing subtreepath empties it: the searches must not use it
+     * until it is rebuilt from entryrdn, which is done here online and
+     * at the next start from the command line. Reindexing ancestorid
+     * drops the marker telling it is not maintained: set it again.
+     */
+    if (!run_from_cmdline) {
+        slapi_pblock_get(pb, SLAPI_BACKEND_INSTANCE_NAME, &instance_name);
+        slapi_pblock_get(pb, SLAPI_DB2INDEX_ATTRS, &attrs);
+        for (size_t i = 0; instance_name && attrs && attrs[i] && inst == NULL; i++) {
+            const char *types[] = {LDBM_SUBTREEPATH_STR, LDBM_ANCESTORID_STR};
+            for (size_t j = 0; j < sizeof(types) / sizeof(types[0]); j++) {
+                size_t len = strlen(types[j]);
+                if (attrs[i][0] == 't' && strncasecmp(attrs[i] + 1, types[j], len) == 0 &&
+                    (attrs[i][len + 1] == '\0' || attrs[i][len + 1] == ':')) {
+                    inst = ldbm_instance_find_by_name(li, instance_name);
+                    break;
+                }
+            }
+        }
+    }
+    if (inst) {
+        inst->inst_subtreepath_ready = 0;
+    }
+
+    rc = priv->dblayer_db2index_fn(pb);
+
+    if (inst && rc == 0) {
+        /* the marker went away with the old content: ready once rebuilt */
+        rc = ldbm_subtreepath_start(inst->inst_be);
+    }
+    return rc;
 }
 
 /*
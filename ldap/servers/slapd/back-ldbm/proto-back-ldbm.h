@@ -190,6 +190,8 @@ struct backentry *id2entry(backend *be, ID id, back_txn *txn, int *err);
  */
 IDList *idl_alloc(NIDS nids);
 void idl_free(IDList **idl);
+IDList *idl_spill(IDList *idl, const char *dir, size_t *size);
+void idl_spill_free(IDList **idl, size_t size);
 NIDS idl_length(IDList *idl);
 int idl_is_allids(IDList *idl);
 int idl_append(IDList *idl, ID id);
@@ -261,6 +263,7 @@ int id_array_init(Id_Array *new_guy, int size);
 
 IDList *index_read(backend *be, const char *type, const char *indextype, const struct berval *val, back_txn *txn, int *err);
 IDList *index_read_ext(backend *be, char *type, const char *indextype, const struct berval *val, back_txn *txn, int *err, int *unindexed);
+int index_lookup_entries(backend *be, back_info_index_lookup *lookup);
 IDList *index_read_ext_allids(Slapi_PBlock *pb, backend *be, char *type, const char *indextype, const struct berval *val, back_txn *txn, int *err, int *unindexed, int allidslimit);
 IDList *index_range_read(Slapi_PBlock *pb, backend *be, char *type, const char *indextype, int ftype, struct berval *val, struct berval *nextval, int range, back_txn *txn, int *err);
 IDList *index_range_read_ext(Slapi_PBlock *pb, backend *be, char *type, const char *indextype, int ftype, struct berval *val, struct berval *nextval, int range, back_txn *txn, int *err, int allidslimit);
@@ -599,6 +602,20 @@ int ldbm_ancestorid_move_subtree(
     ID id,
     IDList *subtree_idl,
     back_txn *txn);
+int ldbm_ancestorid_set_stale(backend *be);
+int ldbm_ancestorid_repair(backend *be);
+int ldbm_ancestorid_is_stale(backend *be);
+
+/*
+ * subtreepath.c
+ */
+int ldbm_subtreepath_index_entry(backend *be, struct backentry *e, int flags, back_txn *txn);
+int ldbm_subtreepath_read_ext(backend *be, back_txn *txn, ID id, IDList **idl, int allidslimit);
+int ldbm_subtreepath_read_descendants(backend *be, back_txn *txn, ID id, IDList **idl, int allidslimit);
+int ldbm_subtreepath_restrict(backend *be, back_txn *txn, ID baseid, IDList **candidates);
+int ldbm_subtreepath_move_subtree(backend *be, ID id, ID newparentid, back_txn *txn);
+int ldbm_subtreepath_start(backend *be);
+int ldbm_subtreepath_is_ready(backend *be);
 
 /*
  * import.c
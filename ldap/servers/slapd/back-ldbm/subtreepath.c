@@ -0,0 +1,754 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/*
+ * subtreepath.c - the subtreepath index
+ *
+ * Each entry is indexed under its path: the ids of its ancestors, from
+ * the suffix down to the entry itself, written as fixed width hex numbers
+ * separated by '/':
+ *
+ *     =00000001/00000002/00000007  ->  7
+ *
+ * Keys sort in tree order, so the descendants of an entry are the range
+ * of keys starting with its own key followed by '/'.
+ *
+ * A subtree search does not build the list of the descendants of its
+ * base: a candidate is in scope when the base is on its path, which is
+ * checked by walking up entryrdn from the candidate until the base, an
+ * ancestor already checked, or the suffix is reached. Only when the
+ * candidates are ALLIDS is the key range of the base read.
+ *
+ * Paths hold ids, not RDNs, so a rename keeps them. Moving an entry to a
+ * new superior rewrites the keys of the moved range only, the ancestors
+ * are not touched.
+ *
+ * The index is enabled with nsslapd-subtreepath-index. It is built from
+ * the entryrdn index when an instance starts, or when it is reindexed,
+ * and a marker key records that it is complete: until then (e.g. after an
+ * online import) searches use ancestorid. Once it is complete ancestorid
+ * is no longer maintained, and it is rebuilt at the start following the
+ * disabling of subtreepath (see ldbm_ancestorid_repair()).
+ *
+ * Like ancestorid, the index does not hold the tombstones.
+ */
+
+#include "back-ldbm.h"
+
+static const char *sourcefile = "subtreepath.c";
+
+#define SUBTREEPATH_READY_KEY "#ready"
+#define SUBTREEPATH_ID_LEN 8         /* "%08x" */
+#define SUBTREEPATH_MAX_DEPTH 1024   /* guards against loops in a broken entryrdn */
+#define SUBTREEPATH_REBUILD_BATCH 1000 /* entries indexed per transaction on rebuild */
+
+typedef struct
+{
+    const char *prefix;
+    size_t prefix_len;
+    IDList *idl;
+    int collect_keys; /* also collect the keys, when moving a subtree */
+    char **keys;
+    int allidslimit;
+} subtreepath_scan_ctx;
+
+/*
+ * Returns the path of an entry, from the suffix down to the entry, by
+ * walking up the entryrdn index. The caller frees it.
+ */
+static int
+subtreepath_get(backend *be, ID id, char **path, back_txn *txn)
+{
+    const char *suffix = slapi_sdn_get_ndn(slapi_be_getsuffix(be, 0));
+    ID *ids = NULL;
+    size_t nids = 0;
+    size_t len;
+    char *p;
+    int rc = 0;
+
+    *path = NULL;
+    if (suffix == NULL) {
+        return DBI_RC_NOTFOUND;
+    }
+    ids = (ID *)slapi_ch_malloc(SUBTREEPATH_MAX_DEPTH * sizeof(ID));
+    /*
+     * Only the suffix is looked up by its RDN (the suffix DN), the other
+     * entries are found by id.
+     */
+    for (;;) {
+        char *prdn = NULL;
+        ID pid = 0;
+
+        if (nids == SUBTREEPATH_MAX_DEPTH) {
+            slapi_log_err(SLAPI_LOG_ERR, "subtreepath_get",
+                          "Entry %lu is more than %d levels deep\n",
+                          (u_long)id, SUBTREEPATH_MAX_DEPTH);
+            rc = LDAP_OPERATIONS_ERROR;
+            goto out;
+        }
+        ids[nids++] = id;
+        rc = entryrdn_get_parent(be, suffix, id, &prdn, &pid, txn);
+        slapi_ch_free_string(&prdn);
+        if (rc) {
+            goto out;
+        }
+        if (pid == id) {
+            /* reached the suffix */
+            break;
+        }
+        id = pid;
+    }
+
+    len = 1 + nids * (SUBTREEPATH_ID_LEN + 1);
+    p = *path = slapi_ch_malloc(len);
+    *p++ = EQ_PREFIX;
+    while (nids > 0) {
+        p += sprintf(p, "%0*x", SUBTREEPATH_ID_LEN, (unsigned int)ids[--nids]);
+        if (nids > 0) {
+            *p++ = '/';
+        }
+    }
+out:
+    slapi_ch_free((void **)&ids);
+    return rc;
+}
+
+static int
+subtreepath_addordel(backend *be, dbi_db_t *db, struct attrinfo *ai, const char *path, ID id, int flags, back_txn *txn)
+{
+    dbi_val_t key = {0};
+    int ret;
+
+    /* include the null terminator, like the other index keys */
+    dblayer_value_set_buffer(be, &key, (void *)path, strlen(path) + 1);
+    if (flags & BE_INDEX_ADD) {
+        slapi_log_err(SLAPI_LOG_TRACE, "subtreepath_addordel", "Insert subtreepath %s:%lu\n",
+                      path, (u_long)id);
+        ret = idl_insert_key(be, db, &key, id, txn, ai, NULL);
+    } else {
+        slapi_log_err(SLAPI_LOG_TRACE, "subtreepath_addordel", "Delete subtreepath %s:%lu\n",
+                      path, (u_long)id);
+        ret = idl_delete_key(be, db, &key, id, txn, ai);
+    }
+    if (ret != 0 && ret != DBI_RC_RETRY) {
+        ldbm_nasty("subtreepath_addordel", sourcefile, 13210, ret);
+    }
+    return ret;
+}
+
+static int
+subtreepath_ready_op(backend *be, dbi_db_t *db, struct attrinfo *ai, int flags, back_txn *txn)
+{
+    return subtreepath_addordel(be, db, ai, SUBTREEPATH_READY_KEY, 1, flags, txn);
+}
+
+/*
+ * The index can not be maintained for an entry: stop using it, and
+ * have it rebuilt at the next start, rather than failing the update.
+ */
+static int
+subtreepath_invalidate(backend *be, dbi_db_t *db, struct attrinfo *ai, back_txn *txn)
+{
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+
+    inst->inst_subtreepath_ready = 0;
+    return subtreepath_ready_op(be, db, ai, BE_INDEX_DEL, txn);
+}
+
+/*
+ * Update the subtreepath index for a single entry. The path is derived
+ * from the parent, so the entryrdn key of the entry itself is not needed.
+ */
+int
+ldbm_subtreepath_index_entry(
+    backend *be,
+    struct backentry *e,
+    int flags, /* BE_INDEX_ADD, BE_INDEX_DEL */
+    back_txn *txn)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    char *parentpath = NULL;
+    char *path = NULL;
+    ID parentid;
+    int ret;
+
+    if (!li->li_subtreepath) {
+        return 0;
+    }
+    if ((flags & BE_INDEX_ADD) && slapi_entry_flag_is_set(e->ep_entry, SLAPI_ENTRY_FLAG_TOMBSTONE)) {
+        return 0;
+    }
+
+    ainfo_get(be, (char *)LDBM_SUBTREEPATH_STR, &ai);
+    if (ai == NULL) {
+        return 0;
+    }
+    ret = dblayer_get_index_file(be, ai, &db, DBOPEN_CREATE);
+    if (ret != 0) {
+        ldbm_nasty("ldbm_subtreepath_index_entry", sourcefile, 13200, ret);
+        return ret;
+    }
+
+    parentid = (ID)slapi_entry_attr_get_ulong(e->ep_entry, LDBM_PARENTID_STR);
+    if (parentid == 0) {
+        /* the suffix */
+        path = slapi_ch_smprintf("%c%0*x", EQ_PREFIX, SUBTREEPATH_ID_LEN, (unsigned int)e->ep_id);
+        ret = 0;
+    } else {
+        ret = subtreepath_get(be, parentid, &parentpath, txn);
+        if (ret == 0) {
+            path = slapi_ch_smprintf("%s/%0*x", parentpath, SUBTREEPATH_ID_LEN, (unsigned int)e->ep_id);
+        }
+    }
+    if (ret == DBI_RC_NOTFOUND) {
+        if (flags & BE_INDEX_DEL) {
+            /* e.g. a tombstone whose parent is gone: it is not indexed */
+            ret = 0;
+        } else {
+            slapi_log_err(SLAPI_LOG_WARNING, "ldbm_subtreepath_index_entry",
+                          "No path for %s\n", slapi_entry_get_dn_const(e->ep_entry));
+            ret = subtreepath_invalidate(be, db, ai, txn);
+        }
+    } else if (ret == 0) {
+        ret = subtreepath_addordel(be, db, ai, path, e->ep_id, flags, txn);
+    }
+    dblayer_release_index_file(be, ai, db);
+
+    slapi_ch_free_string(&parentpath);
+    slapi_ch_free_string(&path);
+    return ret;
+}
+
+/* Collects the ids, or the keys, of the range starting with ctx->prefix */
+static int
+subtreepath_scan_cb(dbi_val_t *key, dbi_val_t *data, void *arg)
+{
+    subtreepath_scan_ctx *ctx = (subtreepath_scan_ctx *)arg;
+    ID id;
+
+    if (key->data == NULL || key->size < ctx->prefix_len ||
+        memcmp(key->data, ctx->prefix, ctx->prefix_len) != 0) {
+        /* out of the range */
+        return DBI_RC_NOTFOUND;
+    }
+    if (data->size != sizeof(ID)) {
+        slapi_log_err(SLAPI_LOG_ERR, "subtreepath_scan_cb",
+                      "Database subtreepath index is corrupt; key %s has a data item with the wrong size (%ld)\n",
+                      (char *)key->data, (long)data->size);
+        return DBI_RC_NOTFOUND;
+    }
+    memcpy(&id, data->data, sizeof(ID));
+    idl_append_extend(&ctx->idl, id);
+    if (ctx->collect_keys) {
+        charray_add(&ctx->keys, slapi_ch_strdup((char *)key->data));
+    } else if (ctx->allidslimit > 0 && ctx->idl->b_nids > (NIDS)ctx->allidslimit) {
+        return DBI_RC_NOTFOUND;
+    }
+    return 0;
+}
+
+static int
+subtreepath_scan(backend *be, dbi_db_t *db, back_txn *txn, subtreepath_scan_ctx *ctx)
+{
+    dbi_cursor_t cursor = {0};
+    dbi_val_t startkey = {0};
+    int ret;
+
+    ret = dblayer_new_cursor(be, db, txn ? txn->back_txn_txn : NULL, &cursor);
+    if (ret != 0) {
+        ldbm_nasty("subtreepath_scan", sourcefile, 13220, ret);
+        return ret;
+    }
+    dblayer_value_set_buffer(be, &startkey, (void *)ctx->prefix, ctx->prefix_len);
+    ret = dblayer_cursor_iterate(&cursor, subtreepath_scan_cb, &startkey, ctx);
+    if (ret == DBI_RC_NOTFOUND) {
+        /* end of the index */
+        ret = 0;
+    }
+    dblayer_cursor_op(&cursor, DBI_OP_CLOSE, NULL, NULL);
+    return ret;
+}
+
+/*
+ * Returns the descendants of an entry (not the entry itself), sorted, or
+ * ALLIDS when there are more than allidslimit of them. This reads the
+ * whole subtree: a search only does it when its candidates are ALLIDS.
+ */
+int
+ldbm_subtreepath_read_ext(
+    backend *be,
+    back_txn *txn,
+    ID id,
+    IDList **idl,
+    int allidslimit)
+{
+    subtreepath_scan_ctx ctx = {0};
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    char *path = NULL;
+    char *prefix = NULL;
+    int ret;
+
+    *idl = NULL;
+    ret = subtreepath_get(be, id, &path, txn);
+    if (ret) {
+        goto out;
+    }
+    ainfo_get(be, (char *)LDBM_SUBTREEPATH_STR, &ai);
+    if (ai == NULL) {
+        ret = LDAP_OPERATIONS_ERROR;
+        goto out;
+    }
+    ret = dblayer_get_index_file(be, ai, &db, DBOPEN_CREATE);
+    if (ret != 0) {
+        ldbm_nasty("ldbm_subtreepath_read_ext", sourcefile, 13230, ret);
+        goto out;
+    }
+
+    prefix = slapi_ch_smprintf("%s/", path);
+    ctx.prefix = prefix;
+    ctx.prefix_len = strlen(prefix);
+    ctx.idl = idl_alloc(IDLIST_MIN_BLOCK_SIZE);
+    ctx.allidslimit = allidslimit;
+    ret = subtreepath_scan(be, db, txn, &ctx);
+    dblayer_release_index_file(be, ai, db);
+    if (ret) {
+        idl_free(&ctx.idl);
+        goto out;
+    }
+
+    if (allidslimit > 0 && ctx.idl->b_nids > (NIDS)allidslimit) {
+        idl_free(&ctx.idl);
+        *idl = idl_allids(be);
+    } else {
+        /* the keys are in tree order */
+        qsort(ctx.idl->b_ids, ctx.idl->b_nids, sizeof(ID), idl_sort_cmp);
+        *idl = ctx.idl;
+    }
+    slapi_log_err(SLAPI_LOG_TRACE, "ldbm_subtreepath_read_ext", "%s returns nids=%lu\n",
+                  path, (u_long)IDL_NIDS(*idl));
+
+out:
+    slapi_ch_free_string(&path);
+    slapi_ch_free_string(&prefix);
+    return ret;
+}
+
+/*
+ * An entry and its descendants are moved under a new parent: replace the
+ * old path prefix of their keys by the new one.
+ */
+int
+ldbm_subtreepath_move_subtree(
+    backend *be,
+    ID id,
+    ID newparentid,
+    back_txn *txn)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    subtreepath_scan_ctx ctx = {0};
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    char *oldpath = NULL;
+    char *newparentpath = NULL;
+    char *newpath = NULL;
+    int ret;
+
+    if (!li->li_subtreepath) {
+        return 0;
+    }
+
+    ainfo_get(be, (char *)LDBM_SUBTREEPATH_STR, &ai);
+    if (ai == NULL) {
+        return 0;
+    }
+    ret = dblayer_get_index_file(be, ai, &db, DBOPEN_CREATE);
+    if (ret != 0) {
+        ldbm_nasty("ldbm_subtreepath_move_subtree", sourcefile, 13240, ret);
+        return ret;
+    }
+
+    ret = subtreepath_get(be, id, &oldpath, txn);
+    if (ret == 0) {
+        ret = subtreepath_get(be, newparentid, &newparentpath, txn);
+    }
+    if (ret == DBI_RC_NOTFOUND) {
+        slapi_log_err(SLAPI_LOG_WARNING, "ldbm_subtreepath_move_subtree",
+                      "No path for %lu or %lu\n", (u_long)id, (u_long)newparentid);
+        ret = subtreepath_invalidate(be, db, ai, txn);
+        goto out;
+    } else if (ret) {
+        goto out;
+    }
+    newpath = slapi_ch_smprintf("%s/%0*x", newparentpath, SUBTREEPATH_ID_LEN, (unsigned int)id);
+
+    /* The entry and its descendants: the old path, and the old path followed by '/' */
+    ctx.prefix = oldpath;
+    ctx.prefix_len = strlen(oldpath);
+    ctx.idl = idl_alloc(IDLIST_MIN_BLOCK_SIZE);
+    ctx.collect_keys = 1;
+    ret = subtreepath_scan(be, db, txn, &ctx);
+    for (NIDS i = 0; ret == 0 && i < ctx.idl->b_nids; i++) {
+        const char *oldkey = ctx.keys[i];
+        char *newkey;
+
+        newkey = slapi_ch_smprintf("%s%s", newpath, oldkey + ctx.prefix_len);
+        ret = subtreepath_addordel(be, db, ai, oldkey, ctx.idl->b_ids[i], BE_INDEX_DEL, txn);
+        if (ret == 0) {
+            ret = subtreepath_addordel(be, db, ai, newkey, ctx.idl->b_ids[i], BE_INDEX_ADD, txn);
+        }
+        slapi_ch_free_string(&newkey);
+    }
+    slapi_log_err(SLAPI_LOG_TRACE, "ldbm_subtreepath_move_subtree", "Moved %lu keys from %s to %s (%d)\n",
+                  (u_long)ctx.idl->b_nids, oldpath, newpath, ret);
+    idl_free(&ctx.idl);
+    charray_free(ctx.keys);
+
+out:
+    dblayer_release_index_file(be, ai, db);
+    slapi_ch_free_string(&oldpath);
+    slapi_ch_free_string(&newparentpath);
+    slapi_ch_free_string(&newpath);
+    return ret;
+}
+
+static PLHashNumber
+subtreepath_hash_id(const void *key)
+{
+    return (PLHashNumber)(uintptr_t)key;
+}
+
+#define SUBTREEPATH_IN_SCOPE ((void *)1)
+#define SUBTREEPATH_OUT_OF_SCOPE ((void *)2)
+
+/*
+ * Keeps the candidates of a subtree search that are the base or one of its
+ * descendants. The verdict of every entry met on the way up is remembered,
+ * so each entry of the tree is looked up in entryrdn at most once. A
+ * candidate whose path can not be read is kept: the search checks the
+ * scope of each entry it returns anyway.
+ */
+int
+ldbm_subtreepath_restrict(
+    backend *be,
+    back_txn *txn,
+    ID baseid,
+    IDList **candidates)
+{
+    const char *suffix = slapi_sdn_get_ndn(slapi_be_getsuffix(be, 0));
+    IDList *in = NULL;
+    PLHashTable *seen = NULL;
+    ID *ids = NULL;
+    ID id;
+    idl_iterator iter;
+
+    if (suffix == NULL || *candidates == NULL || ALLIDS(*candidates)) {
+        return 0;
+    }
+    seen = PL_NewHashTable(256, subtreepath_hash_id, PL_CompareValues, PL_CompareValues, NULL, NULL);
+    PL_HashTableAdd(seen, (void *)(uintptr_t)baseid, SUBTREEPATH_IN_SCOPE);
+    ids = (ID *)slapi_ch_malloc(SUBTREEPATH_MAX_DEPTH * sizeof(ID));
+    in = idl_alloc(IDL_NIDS(*candidates));
+
+    iter = idl_iterator_init(*candidates);
+    while ((id = idl_iterator_dereference_increment(&iter, *candidates)) != NOID) {
+        void *verdict = NULL;
+        size_t nids = 0;
+        ID node = id;
+
+        while ((verdict = PL_HashTableLookup(seen, (void *)(uintptr_t)node)) == NULL) {
+            char *prdn = NULL;
+            ID pid = 0;
+
+            if (nids == SUBTREEPATH_MAX_DEPTH ||
+                entryrdn_get_parent(be, suffix, node, &prdn, &pid, txn) != 0) {
+                /* not known: kept, and not remembered */
+                verdict = SUBTREEPATH_IN_SCOPE;
+                nids = 0;
+                slapi_ch_free_string(&prdn);
+                break;
+            }
+            slapi_ch_free_string(&prdn);
+            ids[nids++] = node;
+            if (pid == node) {
+                /* reached the suffix */
+                verdict = SUBTREEPATH_OUT_OF_SCOPE;
+                break;
+            }
+            node = pid;
+        }
+        while (nids > 0) {
+            PL_HashTableAdd(seen, (void *)(uintptr_t)ids[--nids], verdict);
+        }
+        if (verdict == SUBTREEPATH_IN_SCOPE) {
+            /* candidates are sorted */
+            idl_append(in, id);
+        }
+    }
+    slapi_log_err(SLAPI_LOG_TRACE, "ldbm_subtreepath_restrict", "%lu of %lu candidates under %lu\n",
+                  (u_long)IDL_NIDS(in), (u_long)IDL_NIDS(*candidates), (u_long)baseid);
+
+    PL_HashTableDestroy(seen);
+    slapi_ch_free((void **)&ids);
+    idl_free(candidates);
+    *candidates = in;
+    return 0;
+}
+
+static int
+subtreepath_is_marked_ready(backend *be, dbi_db_t *db)
+{
+    dbi_val_t key = {0};
+    dbi_val_t data = {0};
+    int ret;
+
+    dblayer_value_set_buffer(be, &key, SUBTREEPATH_READY_KEY, sizeof(SUBTREEPATH_READY_KEY));
+    dblayer_value_init(be, &data);
+    ret = dblayer_db_op(be, db, NULL, DBI_OP_GET, &key, &data);
+    dblayer_value_free(be, &data);
+    return ret == 0;
+}
+
+/* Tombstones are stored in entryrdn under their "nsuniqueid=...,<rdn>" RDN */
+static int
+subtreepath_is_tombstone(backend *be, ID id, back_txn *txn)
+{
+    const char *suffix = slapi_sdn_get_ndn(slapi_be_getsuffix(be, 0));
+    char *dn = NULL;
+    int tombstone = 0;
+
+    if (entryrdn_lookup_dn(be, suffix, id, &dn, NULL, txn) == 0 && dn) {
+        tombstone = slapi_is_special_rdn(dn, RDN_IS_TOMBSTONE);
+    }
+    slapi_ch_free_string(&dn);
+    return tombstone;
+}
+
+/*
+ * Returns the descendants of an entry while ancestorid is not maintained:
+ * the key range of subtreepath when the index is complete, otherwise from
+ * entryrdn, tombstones included.
+ */
+int
+ldbm_subtreepath_read_descendants(
+    backend *be,
+    back_txn *txn,
+    ID id,
+    IDList **idl,
+    int allidslimit)
+{
+    const char *suffix = slapi_sdn_get_ndn(slapi_be_getsuffix(be, 0));
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    Slapi_DN sdn;
+    char *dn = NULL;
+    int ready = 0;
+    int ret;
+
+    *idl = NULL;
+    ainfo_get(be, (char *)LDBM_SUBTREEPATH_STR, &ai);
+    if (ai && dblayer_get_index_file(be, ai, &db, 0) == 0) {
+        ready = subtreepath_is_marked_ready(be, db);
+        dblayer_release_index_file(be, ai, db);
+    }
+    if (ready) {
+        return ldbm_subtreepath_read_ext(be, txn, id, idl, allidslimit);
+    }
+
+    ret = entryrdn_lookup_dn(be, suffix, id, &dn, NULL, txn);
+    if (ret) {
+        return ret;
+    }
+    slapi_sdn_init_dn_passin(&sdn, dn);
+    ret = entryrdn_get_subordinates(be, &sdn, id, idl, txn, 0);
+    slapi_sdn_done(&sdn);
+    if (ret == DBI_RC_NOTFOUND) {
+        /* no descendants */
+        ret = 0;
+    } else if (ret) {
+        return ret;
+    }
+    if (*idl == NULL) {
+        *idl = idl_alloc(0);
+    } else if (allidslimit > 0 && (*idl)->b_nids > (NIDS)allidslimit) {
+        idl_free(idl);
+        *idl = idl_allids(be);
+    } else {
+        qsort((*idl)->b_ids, (*idl)->b_nids, sizeof(ID), idl_sort_cmp);
+    }
+    return 0;
+}
+
+/* Indexes all the entries of the instance, in batches of transactions */
+static int
+subtreepath_rebuild(backend *be, dbi_db_t *db, struct attrinfo *ai)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    const Slapi_DN *suffix = slapi_be_getsuffix(be, 0);
+    IDList *idl = NULL;
+    back_txn txn;
+    ID suffixid = 0;
+    NIDS done = 0;
+    int txn_open = 0;
+    int ret;
+
+    ret = entryrdn_index_read(be, suffix, &suffixid, NULL);
+    if (ret == DBI_RC_NOTFOUND) {
+        /* empty backend */
+        ret = 0;
+        goto mark;
+    } else if (ret) {
+        goto out;
+    }
+    ret = entryrdn_get_subordinates(be, suffix, suffixid, &idl, NULL, 0);
+    if (ret == DBI_RC_NOTFOUND) {
+        ret = 0;
+    } else if (ret) {
+        goto out;
+    }
+
+    slapi_log_err(SLAPI_LOG_INFO, "subtreepath_rebuild", "%s: indexing the paths of %lu entries\n",
+                  inst->inst_name, (u_long)IDL_NIDS(idl) + 1);
+    dblayer_txn_init(li, &txn);
+    /* the suffix, then its subordinates (not sorted) */
+    for (NIDS i = 0; ret == 0 && i <= IDL_NIDS(idl); i++) {
+        ID id = (i == 0) ? suffixid : idl->b_ids[i - 1];
+        char *path = NULL;
+
+        if (i > 0 && subtreepath_is_tombstone(be, id, NULL)) {
+            continue;
+        }
+        if (!txn_open) {
+            ret = dblayer_txn_begin(be, NULL, &txn);
+            if (ret) {
+                break;
+            }
+            txn_open = 1;
+        }
+        ret = subtreepath_get(be, id, &path, &txn);
+        if (ret == 0) {
+            ret = subtreepath_addordel(be, db, ai, path, id, BE_INDEX_ADD, &txn);
+        }
+        slapi_ch_free_string(&path);
+        if (ret == 0 && ++done % SUBTREEPATH_REBUILD_BATCH == 0) {
+            ret = dblayer_txn_commit(be, &txn);
+            txn_open = 0;
+        }
+    }
+    if (txn_open) {
+        if (ret) {
+            dblayer_txn_abort(be, &txn);
+            goto out;
+        }
+        ret = dblayer_txn_commit(be, &txn);
+    }
+    if (ret) {
+        goto out;
+    }
+
+mark:
+    dblayer_txn_init(li, &txn);
+    ret = dblayer_txn_begin(be, NULL, &txn);
+    if (ret == 0) {
+        ret = subtreepath_ready_op(be, db, ai, BE_INDEX_ADD, &txn);
+        if (ret) {
+            dblayer_txn_abort(be, &txn);
+        } else {
+            ret = dblayer_txn_commit(be, &txn);
+        }
+    }
+out:
+    idl_free(&idl);
+    return ret;
+}
+
+/*
+ * Called when an instance starts. When the index is enabled, make sure it
+ * is complete, then stop maintaining ancestorid. When it is disabled, it
+ * is no longer maintained: drop the marker so that it is rebuilt when
+ * enabled again, and rebuild ancestorid if it was left out.
+ */
+int
+ldbm_subtreepath_start(backend *be)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+    dbi_db_t *db = NULL;
+    struct attrinfo *ai = NULL;
+    back_txn txn;
+    int ret;
+
+    inst->inst_subtreepath_ready = 0;
+    ainfo_get(be, (char *)LDBM_SUBTREEPATH_STR, &ai);
+    if (ai == NULL) {
+        return 0;
+    }
+
+    if (!li->li_subtreepath) {
+        ldbm_ancestorid_repair(be);
+        /* do not create the index file if it does not exist */
+        if (dblayer_get_index_file(be, ai, &db, 0) != 0) {
+            return 0;
+        }
+        dblayer_txn_init(li, &txn);
+        ret = dblayer_txn_begin(be, NULL, &txn);
+        if (ret == 0) {
+            ret = subtreepath_ready_op(be, db, ai, BE_INDEX_DEL, &txn);
+            if (ret) {
+                dblayer_txn_abort(be, &txn);
+            } else {
+                ret = dblayer_txn_commit(be, &txn);
+            }
+        }
+        dblayer_release_index_file(be, ai, db);
+        return ret;
+    }
+
+    ret = dblayer_get_index_file(be, ai, &db, DBOPEN_CREATE);
+    if (ret != 0) {
+        ldbm_nasty("ldbm_subtreepath_start", sourcefile, 13250, ret);
+        return ret;
+    }
+    if (!subtreepath_is_marked_ready(be, db)) {
+        ret = subtreepath_rebuild(be, db, ai);
+    }
+    dblayer_release_index_file(be, ai, db);
+
+    if (ret) {
+        slapi_log_err(SLAPI_LOG_ERR, "ldbm_subtreepath_start",
+                      "%s: failed to build the %s index (%d), subtree searches use %s\n",
+                      inst->inst_name, LDBM_SUBTREEPATH_STR, ret, LDBM_ANCESTORID_STR);
+        ldbm_ancestorid_repair(be);
+        return 0;
+    }
+    inst->inst_subtreepath_ready = 1;
+    if (ldbm_ancestorid_set_stale(be) != 0) {
+        /* not a problem, ancestorid keeps being maintained */
+        slapi_log_err(SLAPI_LOG_WARNING, "ldbm_subtreepath_start",
+                      "%s: failed to mark the %s index as not maintained\n",
+                      inst->inst_name, LDBM_ANCESTORID_STR);
+    }
+    return 0;
+}
+
+/* Can subtree searches use the subtreepath index? */
+int
+ldbm_subtreepath_is_ready(backend *be)
+{
+    struct ldbminfo *li = (struct ldbminfo *)be->be_database->plg_private;
+    ldbm_instance *inst = (ldbm_instance *)be->be_instance_info;
+
+    return li->li_subtreepath && inst->inst_subtreepath_ready;
+}
@@ -891,12 +891,16 @@ do_vlv_update_index(back_txn *txn, struct ldbminfo *li, Slapi_PBlock *pb, struct
     } else {
         /* Very bad idea to do this outside of a transaction */
     }
-    if (txn && !txn->back_special_handling_fn && priv->dblayer_clear_vlv_cache_fn) {
-        /* If there is a txn and it is not an import pseudo txn then clear the vlv cache */
-        priv->dblayer_clear_vlv_cache_fn(be, db_txn, db);
-    }
     data.size = sizeof(entry->ep_id);
     data.data = &entry->ep_id;
+    if (txn && !txn->back_special_handling_fn) {
+        /* If there is a txn and it is not an import pseudo txn then update or clear the vlv cache */
+        if (priv->dblayer_update_vlv_cache_fn) {
+            priv->dblayer_update_vlv_cache_fn(be, db_txn, db, &key->key, &data, insert);
+        } else if (priv->dblayer_clear_vlv_cache_fn) {
+            priv->dblayer_clear_vlv_cache_fn(be, db_txn, db);
+        }
+    }
 
     if (insert) {
         if (txn && txn->back_special_handling_fn) {
@@ -947,6 +951,11 @@ do_vlv_update_index(back_txn *txn, struct ldbminfo *li, Slapi_PBlock *pb, struct
                           pIndex->vlv_name, (char *)key->key.data);
         }
     }
+    if (rc && txn && !txn->back_special_handling_fn &&
+        priv->dblayer_update_vlv_cache_fn && priv->dblayer_clear_vlv_cache_fn) {
+        /* The vlv cache was updated for a change that did not happen */
+        priv->dblayer_clear_vlv_cache_fn(be, db_txn, db);
+    }
 
     vlv_key_delete(&key);
     dblayer_release_index_file(be, pIndex->vlv_attrinfo, db);
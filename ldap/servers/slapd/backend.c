@@ -80,6 +80,7 @@ be_init(Slapi_Backend *be, const char *type, const char *name, int isprivate, in
     be->be_name = slapi_ch_strdup(name);
     be->be_mapped = 0;
     be->be_usn_counter = NULL;
+    be->be_latency = latency_new();
 }
 
 void
@@ -96,6 +97,7 @@ be_done(Slapi_Backend *be)
     if (!config_get_entryusn_global()) {
         slapi_counter_destroy(&be->be_usn_counter);
     }
+    latency_free(&be->be_latency);
     PR_DestroyLock(be->be_state_lock);
     if (be->be_lock != NULL) {
         slapi_destroy_rwlock(be->be_lock);
@@ -148,20 +148,20 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
     CFG_LOCK_READ(slapdFrontendConfig);
 
     /* show backend config */
-    attrlist_delete(&e->e_attrs, "nsslapd-backendconfig");
+    slapi_entry_attr_delete(e, "nsslapd-backendconfig");
     for (i = 0;
          slapdFrontendConfig->backendconfig &&
          slapdFrontendConfig->backendconfig[i];
          i++) {
         val.bv_val = slapdFrontendConfig->backendconfig[i];
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&e->e_attrs, "nsslapd-backendconfig", vals);
+        slapi_entry_attr_merge(e, "nsslapd-backendconfig", vals);
     }
 
     CFG_UNLOCK_READ(slapdFrontendConfig);
 
     /* show other config entries */
-    attrlist_delete(&e->e_attrs, "nsslapd-backendconfig");
+    slapi_entry_attr_delete(e, "nsslapd-backendconfig");
     cookie = NULL;
     be = slapi_get_first_backend(&cookie);
     while (be) {
@@ -171,7 +171,7 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
             be_getconfigdn(be, &dn);
             val.bv_val = (char *)slapi_sdn_get_ndn(&dn);
             val.bv_len = strlen(val.bv_val);
-            attrlist_merge(&e->e_attrs, "nsslapd-backendconfig", vals);
+            slapi_entry_attr_merge(e, "nsslapd-backendconfig", vals);
             slapi_sdn_done(&dn);
         }
 
@@ -181,14 +181,14 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
     slapi_ch_free_string(&cookie);
 
     /* show be_type */
-    attrlist_delete(&e->e_attrs, "nsslapd-betype");
+    slapi_entry_attr_delete(e, "nsslapd-betype");
     cookie = NULL;
     be = slapi_get_first_backend(&cookie);
     while (be) {
         if (!be->be_private) {
             val.bv_val = be->be_type;
             val.bv_len = strlen(be->be_type);
-            attrlist_replace(&e->e_attrs, "nsslapd-betype", vals);
+            entry_replace_values(e, "nsslapd-betype", vals);
         }
 
         be = slapi_get_next_backend(cookie);
@@ -197,7 +197,7 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
     slapi_ch_free_string(&cookie);
 
     /* show private suffixes */
-    attrlist_delete(&e->e_attrs, "nsslapd-privatenamespaces");
+    slapi_entry_attr_delete(e, "nsslapd-privatenamespaces");
     cookie = NULL;
     be = slapi_get_first_backend(&cookie);
     while (be) {
@@ -207,7 +207,7 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
             if (base != NULL) {
                 val.bv_val = (void *)slapi_sdn_get_dn(base); /* jcm: had to cast away const */
                 val.bv_len = strlen(val.bv_val);
-                attrlist_merge(&e->e_attrs, "nsslapd-privatenamespaces", vals);
+                slapi_entry_attr_merge(e, "nsslapd-privatenamespaces", vals);
             }
         }
         be = slapi_get_next_backend(cookie);
@@ -216,12 +216,12 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
     slapi_ch_free_string(&cookie);
 
     /* show syntax plugins */
-    attrlist_delete(&e->e_attrs, CONFIG_PLUGIN_ATTRIBUTE);
+    slapi_entry_attr_delete(e, CONFIG_PLUGIN_ATTRIBUTE);
     for (pPlugin = slapi_get_global_syntax_plugins(); pPlugin != NULL;
          pPlugin = pPlugin->plg_next) {
         val.bv_val = pPlugin->plg_dn;
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&e->e_attrs, CONFIG_PLUGIN_ATTRIBUTE, vals);
+        slapi_entry_attr_merge(e, CONFIG_PLUGIN_ATTRIBUTE, vals);
     }
 
     /* show matching rule plugins */
@@ -229,15 +229,15 @@ read_config_dse(Slapi_PBlock *pb __attribute__((unused)),
          pPlugin = pPlugin->plg_next) {
         val.bv_val = pPlugin->plg_dn;
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&e->e_attrs, CONFIG_PLUGIN_ATTRIBUTE, vals);
+        slapi_entry_attr_merge(e, CONFIG_PLUGIN_ATTRIBUTE, vals);
     }
 
     /* show requiresrestart */
-    attrlist_delete(&e->e_attrs, "nsslapd-requiresrestart");
+    slapi_entry_attr_delete(e, "nsslapd-requiresrestart");
     for (i = 0; i < sizeof(requires_restart) / sizeof(requires_restart[0]); i++) {
         val.bv_val = (char *)requires_restart[i];
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&e->e_attrs, "nsslapd-requiresrestart", vals);
+        slapi_entry_attr_merge(e, "nsslapd-requiresrestart", vals);
     }
 
     /* show the rest of the configuration parameters */
@@ -22,6 +22,7 @@
 #include "prcvar.h"
 #include "prlog.h" /* for PR_ASSERT */
 #include "fe.h"
+#include "slapd-probes.h"
 #include <sasl/sasl.h>
 #if defined(LINUX)
 #include <netinet/tcp.h> /* for TCP_CORK */
@@ -30,6 +31,9 @@
 typedef Connection work_q_item;
 static void connection_threadmain(void *arg);
 static void connection_add_operation(Connection *conn, Operation *op);
+static int connection_apply_enabled_nolock(Connection *conn, Operation *op);
+static void connection_apply_barrier(Connection *conn, Operation *op);
+static void connection_apply_done(Connection *conn, Operation *op);
 static void connection_free_private_buffer(Connection *conn);
 static void op_copy_identity(Connection *conn, Operation *op);
 static void connection_set_ssl_ssf(Connection *conn);
@@ -149,6 +153,7 @@ connection_done(Connection *conn)
     /* free the private content, the buffer has been freed by above connection_cleanup */
     slapi_ch_free((void **)&conn->c_private);
     pthread_mutex_destroy(&(conn->c_mutex));
+    pthread_cond_destroy(&(conn->c_apply_cv));
     if (NULL != conn->c_sb) {
         ber_sockbuf_free(conn->c_sb);
     }
@@ -194,6 +199,7 @@ connection_cleanup(Connection *conn)
     conn->c_ldapversion = 0;
 
     conn->c_isreplication_session = 0;
+    conn->c_parallel_apply = 0;
     slapi_ch_free((void **)&conn->cin_addr);
     slapi_ch_free((void **)&conn->cin_destaddr);
     slapi_ch_free((void **)&conn->cin_addr_aclip);
@@ -1710,6 +1716,7 @@ connection_threadmain(void *arg)
 
     while (1) {
         int is_timedout = 0;
+        int parallel_apply = 0;
         time_t curtime = 0;
 
         if (op_shutdown) {
@@ -1823,7 +1830,9 @@ connection_threadmain(void *arg)
         }
         maxthreads = conn->c_max_threads_per_conn;
         more_data = 0;
+        SLAPD_PROBE1(conn__read__entry, conn->c_connid);
         ret = connection_read_operation(conn, op, &tag, &more_data);
+        SLAPD_PROBE3(conn__read__return, conn->c_connid, ret, tag);
         if ((ret == CONN_DONE) || (ret == CONN_TIMEDOUT)) {
             slapi_log_err(SLAPI_LOG_CONNS, "connection_threadmain",
                           "conn %" PRIu64 " read not ready due to %d - thread_turbo_flag %d more_data %d "
@@ -1899,6 +1908,19 @@ connection_threadmain(void *arg)
             break;
         }
 
+        /*
+         * The updates of a replication session applied in parallel are
+         * ordered from here: the connection can be read again right away.
+         * A thread dedicated to the connection would read them one by one.
+         */
+        pthread_mutex_lock(&(conn->c_mutex));
+        parallel_apply = connection_apply_enabled_nolock(conn, op);
+        if (parallel_apply) {
+            op->o_apply_state = OP_APPLY_READ;
+            thread_turbo_flag = 0;
+        }
+        pthread_mutex_unlock(&(conn->c_mutex));
+
         /* if we got here, then we had some read activity */
         if (thread_turbo_flag) {
             /* turbo mode avoids handle_pr_read_ready which avoids setting c_idlesince
@@ -1915,10 +1937,10 @@ connection_threadmain(void *arg)
          * more_data: [blackflag 624234]
          * If the connection is from a replication supplier, don't make it readable here.
          * We want to ensure that replication operations are processed strictly in the order
-         * they are received off the wire.
+         * they are received off the wire, unless they are applied in parallel.
          */
         replication_connection = conn->c_isreplication_session;
-        if ((tag != LDAP_REQ_UNBIND) && !thread_turbo_flag && !replication_connection) {
+        if ((tag != LDAP_REQ_UNBIND) && !thread_turbo_flag && (!replication_connection || parallel_apply)) {
             if (!more_data) {
                 conn->c_flags &= ~CONN_FLAG_MAX_THREADS;
                 pthread_mutex_lock(&(conn->c_mutex));
@@ -1989,12 +2011,22 @@ connection_threadmain(void *arg)
             operation_set_flag(op, OP_FLAG_REPLICATED);
         }
 
+        /* Only adds, modifies and deletes are applied concurrently */
+        if (parallel_apply && (tag != LDAP_REQ_ADD) && (tag != LDAP_REQ_MODIFY) && (tag != LDAP_REQ_DELETE)) {
+            connection_apply_barrier(conn, op);
+        }
+
         /*
          * Call the do_<operation> function to process this request.
          */
+        SLAPD_PROBE3(op__dispatch, conn->c_connid, op->o_opid, tag);
         connection_dispatch_operation(conn, op, pb);
+        SLAPD_PROBE3(op__done, conn->c_connid, op->o_opid, tag);
 
     done:
+        if (parallel_apply) {
+            connection_apply_done(conn, op);
+        }
         if (doshutdown) {
             pthread_mutex_lock(&(conn->c_mutex));
             connection_remove_operation_ext(pb, conn, op);
@@ -2067,7 +2099,7 @@ connection_threadmain(void *arg)
                      * Don't release the connection now.
                      * But note down what to do.
                      */
-                    if (replication_connection || (1 == is_timedout)) {
+                    if ((replication_connection && !parallel_apply) || (1 == is_timedout)) {
                         connection_make_readable_nolock(conn);
                         need_wakeup = 1;
                     }
@@ -2167,6 +2199,7 @@ add_work_q(work_q_item *wqitem, struct Slapi_op_stack *op_stack_obj)
     if (work_q_size > work_q_size_max) {
         work_q_size_max = work_q_size;
     }
+    SLAPD_PROBE2(workq__enqueue, op_stack_obj->op, work_q_size);
     pthread_cond_signal(&work_q_cv); /* notify waiters in connection_wait_for_new_work */
     pthread_mutex_unlock(&work_q_lock);
 }
@@ -2196,6 +2229,7 @@ get_work_q(struct Slapi_op_stack **op_stack_obj)
     wqitem = tmp->work_item;
     *op_stack_obj = tmp->op_stack_obj;
     PR_AtomicDecrement(&work_q_size); /* decrement q size */
+    SLAPD_PROBE2(workq__dequeue, tmp->op_stack_obj->op, work_q_size);
     /* Free the memory used by the item found. */
     destroy_work_q(&tmp);
 
@@ -2295,6 +2329,10 @@ connection_remove_operation(Connection *conn, Operation *op)
                       (int)op->o_msgid, conn->c_connid);
     } else {
         *tmp = (*tmp)->o_next;
+        if (op->o_apply_state != OP_APPLY_NONE) {
+            /* the next operations no longer wait for this one */
+            pthread_cond_broadcast(&(conn->c_apply_cv));
+        }
     }
 }
 
@@ -2336,6 +2374,236 @@ connection_operations_pending(Connection *conn, Operation *op2ignore, int test_r
     return (op != NULL);
 }
 
+/*
+ * Parallel apply of the updates of a replication session.
+ *
+ * The updates of a session arrive in order on one connection. Applied in
+ * parallel, the connection is read again as soon as an operation is read
+ * and its operations run concurrently, each of them only waiting for
+ * previous operations of the connection (c_ops is in the order they were
+ * read):
+ * - an add, modify or delete waits for the previous updates to register
+ *   the entries they apply to, registers its own, then waits for the
+ *   previous updates of the same entries. The replication plugin registers
+ *   the update once its csn is in the pending list of the RUV, so the csns
+ *   of the session enter it in order.
+ * - any other operation (modrdn, end of session...) waits for all the
+ *   previous operations, and the next ones wait for it.
+ * - an add whose parent is missing creates a glue entry for it, so it also
+ *   applies to its parent: the adds of its siblings wait for it instead of
+ *   creating the glue entry concurrently.
+ * - the results are sent in the order of the operations, the result of an
+ *   update is held until the previous operations sent theirs.
+ * All the waits are for previous operations, so they cannot deadlock.
+ */
+
+/* Call with conn->c_mutex locked */
+static int
+connection_apply_enabled_nolock(Connection *conn, Operation *op)
+{
+    if (!conn->c_isreplication_session) {
+        return 0;
+    }
+    if (conn->c_parallel_apply) {
+        return 1;
+    }
+    /* The session stops being applied in parallel once its pending operations are done */
+    for (Operation *o = conn->c_ops; o != NULL; o = o->o_next) {
+        if (o != op && o->o_apply_state != OP_APPLY_NONE) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Two updates conflict if one applies to an entry the other applies to or
+ * depends on: the adds of two entries of the same parent do not conflict,
+ * the add of an entry and of its parent do.
+ */
+static int
+connection_apply_conflicts(Operation *op, Operation *prev)
+{
+    if (prev->o_apply_state == OP_APPLY_BARRIER || prev->o_apply_keys == NULL || op->o_apply_keys == NULL) {
+        return 1;
+    }
+    for (size_t i = 0; op->o_apply_keys[i]; i++) {
+        if (charray_inlist(prev->o_apply_keys, op->o_apply_keys[i]) ||
+            charray_inlist(prev->o_apply_deps, op->o_apply_keys[i])) {
+            return 1;
+        }
+    }
+    for (size_t i = 0; op->o_apply_deps && op->o_apply_deps[i]; i++) {
+        if (charray_inlist(prev->o_apply_keys, op->o_apply_deps[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * The replication plugin registers the parent of an add among the entries
+ * it applies to when the parent is missing. The parent is also missing once
+ * a previous delete of the connection is applied, which may happen after
+ * the plugin looked it up: register it too.
+ * Call with conn->c_mutex locked.
+ */
+static void
+connection_apply_missing_parent_nolock(Connection *conn, Operation *op)
+{
+    if (operation_get_type(op) != SLAPI_OPERATION_ADD) {
+        return;
+    }
+    for (size_t i = 0; op->o_apply_deps && op->o_apply_deps[i]; i++) {
+        if (charray_inlist(op->o_apply_keys, op->o_apply_deps[i])) {
+            continue;
+        }
+        for (Operation *o = conn->c_ops; o != NULL && o != op; o = o->o_next) {
+            if (o->o_apply_state != OP_APPLY_NONE && operation_get_type(o) == SLAPI_OPERATION_DELETE &&
+                charray_inlist(o->o_apply_keys, op->o_apply_deps[i])) {
+                charray_add(&op->o_apply_keys, slapi_ch_strdup(op->o_apply_deps[i]));
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * Returns non-zero while a previous operation is in a state op waits for:
+ * - OP_APPLY_REGISTERED: an operation that did not register yet.
+ * - OP_APPLY_RUNNING: an update of the same entries that is not applied.
+ * - OP_APPLY_SENT: an operation that did not send its result.
+ * Call with conn->c_mutex locked.
+ */
+static int
+connection_apply_must_wait_nolock(Connection *conn, Operation *op, int wait_for)
+{
+    if (conn->c_flags & CONN_FLAG_CLOSING) {
+        return 0;
+    }
+    for (Operation *o = conn->c_ops; o != NULL && o != op; o = o->o_next) {
+        if (o->o_apply_state == OP_APPLY_NONE) {
+            continue;
+        }
+        switch (wait_for) {
+        case OP_APPLY_REGISTERED:
+            if (o->o_apply_state < OP_APPLY_REGISTERED) {
+                return 1;
+            }
+            break;
+        case OP_APPLY_RUNNING:
+            if (o->o_apply_state < OP_APPLY_APPLIED && connection_apply_conflicts(op, o)) {
+                return 1;
+            }
+            break;
+        default:
+            if (o->o_apply_state < OP_APPLY_SENT) {
+                return 1;
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+static void
+connection_apply_wait_nolock(Connection *conn, Operation *op, int wait_for)
+{
+    while (connection_apply_must_wait_nolock(conn, op, wait_for)) {
+        pthread_cond_wait(&(conn->c_apply_cv), &(conn->c_mutex));
+    }
+}
+
+static void
+connection_apply_set_state_nolock(Connection *conn, Operation *op, int state)
+{
+    op->o_apply_state = state;
+    pthread_cond_broadcast(&(conn->c_apply_cv));
+}
+
+/* The operation runs once all the previous operations are done */
+static void
+connection_apply_barrier(Connection *conn, Operation *op)
+{
+    pthread_mutex_lock(&(conn->c_mutex));
+    connection_apply_wait_nolock(conn, op, OP_APPLY_SENT);
+    connection_apply_set_state_nolock(conn, op, OP_APPLY_BARRIER);
+    pthread_mutex_unlock(&(conn->c_mutex));
+}
+
+/* The operation is applied: send its result in turn */
+static void
+connection_apply_done(Connection *conn, Operation *op)
+{
+    pthread_mutex_lock(&(conn->c_mutex));
+    connection_apply_set_state_nolock(conn, op, OP_APPLY_APPLIED);
+    connection_apply_wait_nolock(conn, op, OP_APPLY_SENT);
+    pthread_mutex_unlock(&(conn->c_mutex));
+
+    /* The next operations wait for this one, the result can be written unlocked */
+    send_held_result(conn, op);
+
+    pthread_mutex_lock(&(conn->c_mutex));
+    connection_apply_set_state_nolock(conn, op, OP_APPLY_SENT);
+    pthread_mutex_unlock(&(conn->c_mutex));
+}
+
+void
+slapi_connection_set_parallel_apply(Slapi_Connection *conn, int parallel_apply)
+{
+    pthread_mutex_lock(&(conn->c_mutex));
+    conn->c_parallel_apply = parallel_apply;
+    pthread_mutex_unlock(&(conn->c_mutex));
+}
+
+int
+slapi_operation_apply_wait_turn(Slapi_PBlock *pb)
+{
+    Connection *conn = NULL;
+    Operation *op = NULL;
+
+    slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
+    slapi_pblock_get(pb, SLAPI_OPERATION, &op);
+    if (conn == NULL || op == NULL || op->o_apply_state != OP_APPLY_READ) {
+        return 0;
+    }
+    pthread_mutex_lock(&(conn->c_mutex));
+    connection_apply_wait_nolock(conn, op, OP_APPLY_REGISTERED);
+    pthread_mutex_unlock(&(conn->c_mutex));
+    return 1;
+}
+
+int
+slapi_operation_apply_register(Slapi_PBlock *pb, char **keys, char **deps)
+{
+    Connection *conn = NULL;
+    Operation *op = NULL;
+    int running = 0;
+
+    slapi_pblock_get(pb, SLAPI_CONNECTION, &conn);
+    slapi_pblock_get(pb, SLAPI_OPERATION, &op);
+    if (conn == NULL || op == NULL || op->o_apply_state != OP_APPLY_READ) {
+        charray_free(keys);
+        charray_free(deps);
+        return 0;
+    }
+    pthread_mutex_lock(&(conn->c_mutex));
+    op->o_apply_keys = keys;
+    op->o_apply_deps = deps;
+    connection_apply_missing_parent_nolock(conn, op);
+    connection_apply_set_state_nolock(conn, op, OP_APPLY_REGISTERED);
+    connection_apply_wait_nolock(conn, op, OP_APPLY_RUNNING);
+    connection_apply_set_state_nolock(conn, op, OP_APPLY_RUNNING);
+    for (Operation *o = conn->c_ops; o != NULL; o = o->o_next) {
+        if (o->o_apply_state == OP_APPLY_RUNNING) {
+            running++;
+        }
+    }
+    pthread_mutex_unlock(&(conn->c_mutex));
+
+    return running;
+}
+
 
 /* Copy the authorization identity from the connection struct into the
  * operation struct.  We do this late, because an operation might start
@@ -2533,6 +2801,8 @@ disconnect_server_nomutex_ext(Connection *conn, PRUint64 opconnid, int opid, PRE
 
         conn->c_gettingber = 0;
         connection_abandon_operations(conn);
+        /* the operations waiting for their turn to apply give up */
+        pthread_cond_broadcast(&(conn->c_apply_cv));
         /* needed here to ensure simple paged results timeout properly and
          * don't impact subsequent ops */
         pagedresults_reset_timedout_nolock(conn);
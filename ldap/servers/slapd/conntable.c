@@ -182,6 +182,11 @@ connection_table_new(int table_size)
                 exit(1);
             }
 
+            if (pthread_cond_init(&(ct->c[ct_list][i].c_apply_cv), NULL) != 0) {
+                slapi_log_err(SLAPI_LOG_ERR, "connection_table_new", "pthread_cond_init failed\n");
+                exit(1);
+            }
+
             ct->c[ct_list][i].c_pdumutex = PR_NewLock();
             if (ct->c[ct_list][i].c_pdumutex == NULL) {
                 slapi_log_err(SLAPI_LOG_ERR, "connection_table_new", "PR_NewLock failed\n");
@@ -564,16 +569,21 @@ connection_table_as_entry(Connection_Table *ct, Slapi_Entry *e)
     size_t ct_list;
     size_t i;
     int nconns, nreadwaiters;
+    size_t pr_mem = 0, pr_spilled = 0;
     struct tm utm;
 
     vals[0] = &val;
     vals[1] = NULL;
 
-    attrlist_delete(&e->e_attrs, "connection");
+    slapi_entry_attr_delete(e, "connection");
+    slapi_entry_attr_delete(e, "pagedresults");
     nconns = 0;
     nreadwaiters = 0;
     for (ct_list = 0; ct_list < (ct != NULL ? ct->list_num : 0); ct_list++) {
         for (i = 0; i < ct->list_size; i++) {
+            uint64_t in_use_connid;
+            int in_use;
+
             PR_Lock(ct->table_mutex);
             if (ct->c[ct_list][i].c_state == CONN_STATE_FREE) {
                 PR_Unlock(ct->table_mutex);
@@ -583,7 +593,9 @@ connection_table_as_entry(Connection_Table *ct, Slapi_Entry *e)
             PR_Unlock(ct->table_mutex);
 
             pthread_mutex_lock(&(ct->c[ct_list][i].c_mutex));
-            if (ct->c[ct_list][i].c_sd != SLAPD_INVALID_SOCKET) {
+            in_use = (ct->c[ct_list][i].c_sd != SLAPD_INVALID_SOCKET);
+            in_use_connid = ct->c[ct_list][i].c_connid;
+            if (in_use) {
                 char buf2[SLAPI_TIMESTAMP_BUFSIZE+1];
                 size_t lendn = ct->c[ct_list][i].c_dn ? strlen(ct->c[ct_list][i].c_dn) : 6; /* "NULLDN" */
                 size_t lenip = ct->c[ct_list][i].c_ipaddr ? strlen(ct->c[ct_list][i].c_ipaddr) : 0;
@@ -653,42 +665,74 @@ connection_table_as_entry(Connection_Table *ct, Slapi_Entry *e)
                         ct->c[ct_list][i].c_ipaddr);
                 val.bv_val = bufptr;
                 val.bv_len = strlen(bufptr);
-                attrlist_merge(&e->e_attrs, "connection", vals);
+                slapi_entry_attr_merge(e, "connection", vals);
                 slapi_ch_free_string(&newbuf);
             }
             pthread_mutex_unlock(&(ct->c[ct_list][i].c_mutex));
+
+            /*
+             * Memory held by the paged searches in progress, bounded by
+             * nsslapd-pagedspillthreshold. The pageresult lock can not be
+             * taken while holding c_mutex.
+             *
+             * connid:searches:memory:spilled
+             */
+            if (in_use) {
+                size_t mem, spilled;
+                int searches = pagedresults_get_mem_usage(&ct->c[ct_list][i], &mem, &spilled);
+
+                if (searches > 0) {
+                    snprintf(buf, sizeof(buf), "%" PRIu64 ":%d:%zu:%zu",
+                             in_use_connid, searches, mem, spilled);
+                    val.bv_val = buf;
+                    val.bv_len = strlen(buf);
+                    slapi_entry_attr_merge(e, "pagedresults", vals);
+                    pr_mem += mem;
+                    pr_spilled += spilled;
+                }
+            }
         }
     }
 
     snprintf(buf, sizeof(buf), "%d", nconns);
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "currentconnections", vals);
+    entry_replace_values(e, "currentconnections", vals);
 
     snprintf(buf, sizeof(buf), "%" PRIu64, slapi_counter_get_value(num_conns));
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "totalconnections", vals);
+    entry_replace_values(e, "totalconnections", vals);
 
     snprintf(buf, sizeof(buf), "%" PRIu64, slapi_counter_get_value(conns_in_maxthreads));
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "currentconnectionsatmaxthreads", vals);
+    entry_replace_values(e, "currentconnectionsatmaxthreads", vals);
 
     snprintf(buf, sizeof(buf), "%" PRIu64, slapi_counter_get_value(max_threads_count));
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "maxthreadsperconnhits", vals);
+    entry_replace_values(e, "maxthreadsperconnhits", vals);
 
     snprintf(buf, sizeof(buf), "%d", (ct != NULL ? ct->size : 0));
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "dtablesize", vals);
+    entry_replace_values(e, "dtablesize", vals);
 
     snprintf(buf, sizeof(buf), "%d", nreadwaiters);
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "readwaiters", vals);
+    entry_replace_values(e, "readwaiters", vals);
+
+    snprintf(buf, sizeof(buf), "%zu", pr_mem);
+    val.bv_val = buf;
+    val.bv_len = strlen(buf);
+    entry_replace_values(e, "currentpagedresultsmemory", vals);
+
+    snprintf(buf, sizeof(buf), "%zu", pr_spilled);
+    val.bv_val = buf;
+    val.bv_len = strlen(buf);
+    entry_replace_values(e, "currentpagedresultsspilled", vals);
 }
 
 void
@@ -1276,6 +1276,9 @@ slapd_daemon(daemon_ports_t *ports)
         uniqueIDGenCleanup();
     }
 
+    /* write the pending dse.ldif changes while the plugins are still there */
+    dse_flush_all();
+
     plugin_closeall(1 /* Close Backends */, 1 /* Close Globals */);
 
     destroysignalpipe();
@@ -23,6 +23,16 @@
  * in-core entry is updated, then dse_write_file() is
  * called to commit the changes to disk.
  *
+ * When nsslapd-dse-write-delay is set, the changes are not written
+ * before the operation returns: a writer thread per dse coalesces
+ * them and rewrites the file at most nsslapd-dse-write-delay ms after
+ * the first pending change.  The file content is serialized in memory
+ * under the dse lock, the file itself is written once the lock has
+ * been released.
+ *
+ * Entries below cn=tasks,cn=config are transient (task_cleanup()
+ * removes them at startup) so they are never written to the file.
+ *
  * This is designed for a small number of DSEs, say
  * a maximum of 10 or 20.  If large numbers of DSEs
  * need to be stored, this approach of writing out
@@ -74,6 +84,9 @@
 #define DSE_USE_LOCK 1
 #define DSE_NO_LOCK 0
 
+/* normalized suffix of the transient task entries */
+#define DSE_TASKS_SUFFIX ",cn=tasks,cn=config"
+
 struct dse_callback
 {
     int operation;
@@ -104,6 +117,17 @@ struct dse
     int dse_readonly_error_reported; /* used to ensure that read-only errors are logged only once */
     pthread_mutex_t dse_backup_lock; /* used to block write when online backup is in progress */
     bool dse_backup_in_progress;     /* tell that online backup is in progress (protected by dse_rwlock) */
+    uint64_t dse_snapshot_gen;       /* last serialized content (protected by dse_rwlock) */
+    pthread_mutex_t dse_file_lock;   /* serializes the file writes */
+    uint64_t dse_file_gen;           /* content in the file (protected by dse_file_lock) */
+    pthread_mutex_t dse_writer_lock; /* protects the delayed writer fields below */
+    pthread_cond_t dse_writer_cv;
+    pthread_t dse_writer;
+    bool dse_writer_running;
+    bool dse_writer_stopping;
+    bool dse_dirty;                  /* a write is pending */
+    struct timespec dse_dirty_deadline; /* when the pending write is due */
+    struct dse *dse_writer_next;     /* list of the dse having a running writer */
 };
 
 struct dse_node
@@ -118,8 +142,28 @@ typedef struct dse_search_set
     int current_entry;
 } dse_search_set;
 
+/* the serialized content of a dse file */
+typedef struct dse_snapshot
+{
+    char *buf;
+    size_t len;
+    size_t size;
+    uint64_t gen;
+} dse_snapshot;
+
+/* the dse having a running delayed writer, for dse_flush_all() */
+static pthread_mutex_t dse_writers_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct dse *dse_writers = NULL;
+/* keeps the dse of dse_writers alive while dse_flush_writers() writes them */
+static pthread_mutex_t dse_writers_flush_lock = PTHREAD_MUTEX_INITIALIZER;
+/* held by an online backup while it copies the dse files */
+static pthread_mutex_t dse_files_backup_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static int dse_permission_to_write(struct dse *pdse, int loglevel);
 static int dse_write_file_nolock(struct dse *pdse);
+static int dse_write_file_now_nolock(struct dse *pdse);
+static void dse_flush_writers(void);
+static void dse_writer_stop(struct dse *pdse);
 static int dse_apply_nolock(struct dse *pdse, int32_t (*fp)(caddr_t, caddr_t), caddr_t arg);
 static int dse_replace_entry(struct dse *pdse, Slapi_Entry *e, int write_file, int use_lock);
 static dse_search_set *dse_search_set_new(void);
@@ -190,6 +234,44 @@ dse_lock_unlock(struct dse *pdse, int use_lock)
     }
 }
 
+/*
+ * Entries below cn=tasks,cn=config only live until the next restart,
+ * task_cleanup() removes them, so they are not worth writing.
+ */
+static bool
+dse_is_transient_entry(const Slapi_DN *sdn)
+{
+    const char *ndn = slapi_sdn_get_ndn(sdn);
+    size_t suffixlen = sizeof(DSE_TASKS_SUFFIX) - 1;
+    size_t len = ndn ? strlen(ndn) : 0;
+
+    return len > suffixlen && strcmp(ndn + len - suffixlen, DSE_TASKS_SUFFIX) == 0;
+}
+
+static void
+dse_writer_deadline(struct timespec *deadline, int ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+/* The deadlines are computed on the monotonic clock */
+static void
+dse_writer_cv_init(pthread_cond_t *cv)
+{
+    pthread_condattr_t condattr;
+
+    pthread_condattr_init(&condattr);
+    pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+    pthread_cond_init(cv, &condattr);
+    pthread_condattr_destroy(&condattr);
+}
+
 /* Call cb(pdse) */
 INLINE_DIRECTIVE static void
 dse_call_cb(void (*cb)(struct dse*))
@@ -226,17 +308,23 @@ dse_backup_unlock_cb(struct dse *pdse)
     pthread_mutex_unlock(&pdse->dse_backup_lock);
 }
 
-/* Tells that a backup thread is starting */
+/*
+ * Tells that a backup thread is starting: the delayed changes are written
+ * then the files are not replaced until dse_backup_unlock() is called.
+ */
 void
 dse_backup_lock()
 {
+    dse_flush_writers();
     dse_call_cb(dse_backup_lock_cb);
+    pthread_mutex_lock(&dse_files_backup_lock);
 }
 
 /* Tells that a backup thread is ending */
 void
 dse_backup_unlock()
 {
+    pthread_mutex_unlock(&dse_files_backup_lock);
     dse_call_cb(dse_backup_unlock_cb);
 }
 
@@ -473,6 +561,9 @@ dse_new(char *filename, char *tmpfilename, char *backfilename, char *startokfile
             pdse->dse_is_updateable = dse_permission_to_write(pdse,
                                                               SLAPI_LOG_TRACE);
             pthread_mutex_init(&pdse->dse_backup_lock, NULL);
+            pthread_mutex_init(&pdse->dse_file_lock, NULL);
+            pthread_mutex_init(&pdse->dse_writer_lock, NULL);
+            dse_writer_cv_init(&pdse->dse_writer_cv);
         }
         slapi_ch_free((void **)&realconfigdir);
     }
@@ -509,6 +600,8 @@ dse_destroy(struct dse *pdse)
     if (NULL == pdse) {
         return 0; /* no one checks this return value */
     }
+    /* write the pending changes while the file names are still there */
+    dse_writer_stop(pdse);
     dse_lock_write(pdse, DSE_USE_LOCK);
     slapi_ch_free((void **)&(pdse->dse_filename));
     slapi_ch_free((void **)&(pdse->dse_tmpfile));
@@ -522,6 +615,9 @@ dse_destroy(struct dse *pdse)
     if (pdse->dse_rwlock) {
         slapi_destroy_rwlock(pdse->dse_rwlock);
     }
+    pthread_cond_destroy(&pdse->dse_writer_cv);
+    pthread_mutex_destroy(&pdse->dse_writer_lock);
+    pthread_mutex_destroy(&pdse->dse_file_lock);
     slapi_ch_free((void **)&pdse);
     slapi_log_err(SLAPI_DSE_TRACELEVEL, "dse_destroy", "Removed [%d] entries from the dse tree.\n",
                   nentries);
@@ -651,13 +747,13 @@ dse_updateNumSubordinates(Slapi_Entry *entry, int op)
         val.bv_len = strlen(val.bv_val);
         switch (mod_op) {
         case LDAP_MOD_ADD:
-            attrlist_merge(&entry->e_attrs, subordinatecount, vals);
+            slapi_entry_attr_merge(entry, subordinatecount, vals);
             break;
         case LDAP_MOD_REPLACE:
-            attrlist_replace(&entry->e_attrs, subordinatecount, vals);
+            entry_replace_values(entry, subordinatecount, vals);
             break;
         case LDAP_MOD_DELETE:
-            attrlist_delete(&entry->e_attrs, subordinatecount);
+            slapi_entry_attr_delete(entry, subordinatecount);
             break;
         }
     }
@@ -924,8 +1020,7 @@ dse_read_file(struct dse *pdse, Slapi_PBlock *pb)
  */
 typedef struct _fpw
 {
-    PRFileDesc *fpw_prfd;
-    int fpw_rc;
+    dse_snapshot *fpw_snap;
     struct dse *fpw_pdse;
 } FPWrapper;
 
@@ -1141,82 +1236,343 @@ check_if_readonly(struct dse *pdse)
 }
 
 /*
- * Write the AVL tree of entries back to the LDIF file.
+ * Serialize the AVL tree of entries as the content of the LDIF file.
+ * The caller must hold the dse write lock.
  */
-static int
-dse_write_file_nolock(struct dse *pdse)
+static void
+dse_snapshot_nolock(struct dse *pdse, dse_snapshot *snap)
 {
     FPWrapper fpw;
+
+    snap->buf = NULL;
+    snap->len = 0;
+    snap->size = 0;
+    snap->gen = ++pdse->dse_snapshot_gen;
+
+    fpw.fpw_snap = snap;
+    fpw.fpw_pdse = pdse;
+    avl_apply(pdse->dse_tree, dse_write_entry, &fpw, STOP_TRAVERSAL, AVL_INORDER);
+}
+
+static void
+dse_snapshot_append(dse_snapshot *snap, const char *s, size_t len)
+{
+    if (snap->len + len > snap->size) {
+        snap->size = 2 * (snap->len + len);
+        snap->buf = slapi_ch_realloc(snap->buf, snap->size);
+    }
+    memcpy(snap->buf + snap->len, s, len);
+    snap->len += len;
+}
+
+/*
+ * Write a snapshot in the temporary file then rename it to the LDIF file.
+ * A snapshot older than the content already written is dropped.
+ * The file is not replaced while an online backup copies it.
+ */
+static int
+dse_write_snapshot(struct dse *pdse, dse_snapshot *snap)
+{
+    PRFileDesc *prfd = NULL;
     int rc = 0;
 
-    if (dont_ever_write_dse_files || check_if_readonly(pdse)) {
+    pthread_mutex_lock(&dse_files_backup_lock);
+    pthread_mutex_lock(&pdse->dse_file_lock);
+    if (snap->gen <= pdse->dse_file_gen) {
+        pthread_mutex_unlock(&pdse->dse_file_lock);
+        pthread_mutex_unlock(&dse_files_backup_lock);
         return rc;
     }
 
-    fpw.fpw_rc = 0;
-    fpw.fpw_prfd = NULL;
-
-    if (NULL != pdse->dse_filename) {
-        if ((fpw.fpw_prfd = PR_Open(pdse->dse_tmpfile, PR_RDWR | PR_CREATE_FILE | PR_TRUNCATE, SLAPD_DEFAULT_DSE_FILE_MODE)) == NULL) {
-            rc = PR_GetOSError();
-            slapi_log_err(SLAPI_LOG_ERR, "dse_write_file_nolock", "Cannot open "
-                                                                  "temporary DSE file \"%s\" for update: OS error %d (%s)\n",
-                          pdse->dse_tmpfile, rc, slapd_system_strerror(rc));
+    if ((prfd = PR_Open(pdse->dse_tmpfile, PR_RDWR | PR_CREATE_FILE | PR_TRUNCATE, SLAPD_DEFAULT_DSE_FILE_MODE)) == NULL) {
+        rc = PR_GetOSError();
+        slapi_log_err(SLAPI_LOG_ERR, "dse_write_snapshot", "Cannot open "
+                                                           "temporary DSE file \"%s\" for update: OS error %d (%s)\n",
+                      pdse->dse_tmpfile, rc, slapd_system_strerror(rc));
+    } else if (snap->len > 0 && slapi_write_buffer(prfd, snap->buf, (PRInt32)snap->len) != (PRInt32)snap->len) {
+        rc = PR_GetOSError();
+        slapi_log_err(SLAPI_LOG_ERR, "dse_write_snapshot", "Cannot write "
+                                                           " temporary DSE file \"%s\": OS error %d (%s)\n",
+                      pdse->dse_tmpfile, rc, slapd_system_strerror(rc));
+        (void)PR_Close(prfd);
+    } else {
+        (void)PR_Close(prfd);
+        if (pdse->dse_fileback != NULL) {
+            rc = slapi_destructive_rename(pdse->dse_filename, pdse->dse_fileback);
+            if (rc != 0) {
+                slapi_log_err(SLAPI_LOG_ERR, "dse_write_snapshot", "Cannot backup"
+                                                                   " DSE file \"%s\" to \"%s\": OS error %d (%s)\n",
+                              pdse->dse_filename, pdse->dse_fileback,
+                              rc, slapd_system_strerror(rc));
+            }
+        }
+        rc = slapi_destructive_rename(pdse->dse_tmpfile, pdse->dse_filename);
+        if (rc != 0) {
+            slapi_log_err(SLAPI_LOG_ERR, "dse_write_snapshot", "Cannot rename"
+                                                               " temporary DSE file \"%s\" to \"%s\":"
+                                                               " OS error %d (%s)\n",
+                          pdse->dse_tmpfile, pdse->dse_filename,
+                          rc, slapd_system_strerror(rc));
         } else {
-            fpw.fpw_pdse = pdse;
-            if (avl_apply(pdse->dse_tree, dse_write_entry, &fpw, STOP_TRAVERSAL, AVL_INORDER) == STOP_TRAVERSAL) {
-                rc = fpw.fpw_rc;
-                slapi_log_err(SLAPI_LOG_ERR, "dse_write_file_nolock", "Cannot write "
-                                                                      " temporary DSE file \"%s\": OS error %d (%s)\n",
-                              pdse->dse_tmpfile, rc, slapd_system_strerror(rc));
-                (void)PR_Close(fpw.fpw_prfd);
-                fpw.fpw_prfd = NULL;
-            } else {
-                (void)PR_Close(fpw.fpw_prfd);
-                fpw.fpw_prfd = NULL;
-                if (pdse->dse_fileback != NULL) {
-                    rc = slapi_destructive_rename(pdse->dse_filename, pdse->dse_fileback);
-                    if (rc != 0) {
-                        slapi_log_err(SLAPI_LOG_ERR, "dse_write_file_nolock", "Cannot backup"
-                                                                              " DSE file \"%s\" to \"%s\": OS error %d (%s)\n",
-                                      pdse->dse_filename, pdse->dse_fileback,
-                                      rc, slapd_system_strerror(rc));
-                    }
-                }
-                rc = slapi_destructive_rename(pdse->dse_tmpfile, pdse->dse_filename);
-                if (rc != 0) {
-                    slapi_log_err(SLAPI_LOG_ERR, "dse_write_file_nolock", "Cannot rename"
-                                                                          " temporary DSE file \"%s\" to \"%s\":"
-                                                                          " OS error %d (%s)\n",
-                                  pdse->dse_tmpfile, pdse->dse_filename,
-                                  rc, slapd_system_strerror(rc));
-                }
-                /*
-                 * We have now written to the tmp location, and renamed it
-                 * we need to open and fsync the dir to make the rename stick.
-                 */
-                int fp_configdir =
+            pdse->dse_file_gen = snap->gen;
+        }
+        /*
+         * We have now written to the tmp location, and renamed it
+         * we need to open and fsync the dir to make the rename stick.
+         */
+        int fp_configdir =
 #ifdef O_PATH
-                    open(pdse->dse_configdir, O_PATH | O_DIRECTORY)
+            open(pdse->dse_configdir, O_PATH | O_DIRECTORY)
 #else
-                    open(pdse->dse_configdir, O_RDONLY | O_DIRECTORY)
+            open(pdse->dse_configdir, O_RDONLY | O_DIRECTORY)
 #endif
-                    ;
-                if (fp_configdir != -1) {
-                    fsync(fp_configdir);
-                    close(fp_configdir);
-                }
+            ;
+        if (fp_configdir != -1) {
+            fsync(fp_configdir);
+            close(fp_configdir);
+        }
+    }
+    pthread_mutex_unlock(&pdse->dse_file_lock);
+    pthread_mutex_unlock(&dse_files_backup_lock);
+
+    return rc;
+}
+
+/*
+ * Write the AVL tree of entries back to the LDIF file before returning.
+ * The caller must hold the dse write lock.
+ */
+static int
+dse_write_file_now_nolock(struct dse *pdse)
+{
+    dse_snapshot snap;
+    int rc = 0;
+
+    if (dont_ever_write_dse_files || check_if_readonly(pdse)) {
+        return rc;
+    }
+
+    if (NULL != pdse->dse_filename) {
+        dse_snapshot_nolock(pdse, &snap);
+        rc = dse_write_snapshot(pdse, &snap);
+        slapi_ch_free((void **)&snap.buf);
+    }
+
+    return rc;
+}
+
+/*
+ * Done by the writer thread: the tree is serialized under the dse lock
+ * but the file is written once the lock is released.
+ */
+static void
+dse_write_file_delayed(struct dse *pdse)
+{
+    dse_snapshot snap = {0};
+    bool write = false;
+
+    dse_lock_write(pdse, DSE_USE_LOCK);
+    if (!dont_ever_write_dse_files && NULL != pdse->dse_filename && !check_if_readonly(pdse)) {
+        dse_snapshot_nolock(pdse, &snap);
+        write = true;
+    }
+    dse_lock_unlock(pdse, DSE_USE_LOCK);
+
+    if (write) {
+        dse_write_snapshot(pdse, &snap);
+        slapi_ch_free((void **)&snap.buf);
+    }
+}
+
+/*
+ * The first change marking the dse dirty sets the deadline of the write,
+ * the changes done before it expires are written together.
+ */
+static void *
+dse_writer_thread(void *arg)
+{
+    struct dse *pdse = (struct dse *)arg;
+
+    pthread_mutex_lock(&pdse->dse_writer_lock);
+    while (1) {
+        if (!pdse->dse_dirty) {
+            if (pdse->dse_writer_stopping) {
+                break;
+            }
+            pthread_cond_wait(&pdse->dse_writer_cv, &pdse->dse_writer_lock);
+            continue;
+        }
+        while (!pdse->dse_writer_stopping) {
+            if (pthread_cond_timedwait(&pdse->dse_writer_cv, &pdse->dse_writer_lock,
+                                       &pdse->dse_dirty_deadline) == ETIMEDOUT) {
+                break;
             }
         }
-        if (fpw.fpw_prfd)
-            (void)PR_Close(fpw.fpw_prfd);
+        pdse->dse_dirty = false;
+        pthread_mutex_unlock(&pdse->dse_writer_lock);
+        dse_write_file_delayed(pdse);
+        pthread_mutex_lock(&pdse->dse_writer_lock);
     }
+    pthread_mutex_unlock(&pdse->dse_writer_lock);
+
+    return NULL;
+}
+
+/* Called with dse_writer_lock */
+static int
+dse_writer_start(struct dse *pdse)
+{
+    int rc = pthread_create(&pdse->dse_writer, NULL, dse_writer_thread, pdse);
+
+    if (rc) {
+        slapi_log_err(SLAPI_LOG_ERR, "dse_writer_start",
+                      "Failed to create the writer thread of %s (%d), changes are written synchronously\n",
+                      pdse->dse_filename, rc);
+        return rc;
+    }
+    pdse->dse_writer_running = true;
+
+    pthread_mutex_lock(&dse_writers_lock);
+    pdse->dse_writer_next = dse_writers;
+    dse_writers = pdse;
+    pthread_mutex_unlock(&dse_writers_lock);
+
+    return 0;
+}
 
-    dse_backup_unlock();
+/*
+ * Hand the write over to the writer thread of the dse.
+ * Returns non zero if the file must be written synchronously.
+ */
+static int
+dse_writer_schedule(struct dse *pdse, int delay)
+{
+    int rc = 0;
+
+    pthread_mutex_lock(&pdse->dse_writer_lock);
+    if (pdse->dse_writer_stopping) {
+        rc = -1;
+    } else if (!pdse->dse_writer_running && (rc = dse_writer_start(pdse)) != 0) {
+        pdse->dse_writer_stopping = true;
+    } else if (!pdse->dse_dirty) {
+        pdse->dse_dirty = true;
+        dse_writer_deadline(&pdse->dse_dirty_deadline, delay);
+        pthread_cond_signal(&pdse->dse_writer_cv);
+    }
+    pthread_mutex_unlock(&pdse->dse_writer_lock);
 
     return rc;
 }
 
+/*
+ * Write the pending changes and stop the writer thread.
+ * The later changes of this dse are written synchronously.
+ * Must not be called with the dse lock.
+ */
+static void
+dse_writer_stop(struct dse *pdse)
+{
+    struct dse **pp;
+    bool running;
+
+    pthread_mutex_lock(&pdse->dse_writer_lock);
+    running = pdse->dse_writer_running;
+    pdse->dse_writer_running = false;
+    pdse->dse_writer_stopping = true;
+    pthread_cond_signal(&pdse->dse_writer_cv);
+    pthread_mutex_unlock(&pdse->dse_writer_lock);
+
+    if (!running) {
+        return;
+    }
+    pthread_join(pdse->dse_writer, NULL);
+
+    pthread_mutex_lock(&dse_writers_flush_lock);
+    pthread_mutex_lock(&dse_writers_lock);
+    for (pp = &dse_writers; *pp; pp = &(*pp)->dse_writer_next) {
+        if (*pp == pdse) {
+            *pp = pdse->dse_writer_next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&dse_writers_lock);
+    pthread_mutex_unlock(&dse_writers_flush_lock);
+}
+
+/*
+ * Write the pending changes of all the dse files now, the writer threads
+ * keep running.  Used before an online backup copies the files.
+ * Must not be called with a dse lock.
+ */
+static void
+dse_flush_writers(void)
+{
+    struct dse **pending = NULL;
+    struct dse *pdse;
+    size_t count = 0;
+    size_t i;
+
+    pthread_mutex_lock(&dse_writers_flush_lock);
+    pthread_mutex_lock(&dse_writers_lock);
+    for (pdse = dse_writers; pdse; pdse = pdse->dse_writer_next) {
+        count++;
+    }
+    if (count) {
+        pending = (struct dse **)slapi_ch_malloc(count * sizeof(struct dse *));
+        for (i = 0, pdse = dse_writers; pdse; pdse = pdse->dse_writer_next) {
+            pending[i++] = pdse;
+        }
+    }
+    pthread_mutex_unlock(&dse_writers_lock);
+
+    /*
+     * The snapshot taken here is newer than the one a writer thread may
+     * be writing, which is then dropped by dse_write_snapshot().
+     */
+    for (i = 0; i < count; i++) {
+        dse_write_file_delayed(pending[i]);
+    }
+    pthread_mutex_unlock(&dse_writers_flush_lock);
+    slapi_ch_free((void **)&pending);
+}
+
+/*
+ * Write the pending changes of all the dse files.  Called at shutdown
+ * before the plugins are closed, as the write callbacks may need them.
+ */
+void
+dse_flush_all(void)
+{
+    struct dse *pdse;
+
+    pthread_mutex_lock(&dse_writers_lock);
+    while ((pdse = dse_writers) != NULL) {
+        pthread_mutex_unlock(&dse_writers_lock);
+        dse_writer_stop(pdse);
+        pthread_mutex_lock(&dse_writers_lock);
+    }
+    pthread_mutex_unlock(&dse_writers_lock);
+}
+
+/*
+ * Write the AVL tree of entries back to the LDIF file, or let the writer
+ * thread do it within nsslapd-dse-write-delay ms.
+ * The caller must hold the dse write lock.
+ */
+static int
+dse_write_file_nolock(struct dse *pdse)
+{
+    int delay = config_get_dse_write_delay();
+
+    if (dont_ever_write_dse_files) {
+        return 0;
+    }
+    if (delay > 0 && NULL != pdse->dse_filename && dse_writer_schedule(pdse, delay) == 0) {
+        return 0;
+    }
+    return dse_write_file_now_nolock(pdse);
+}
+
 /*
  * Local function for writing an entry to a file.
  * Called by the AVL code during traversal.
@@ -1229,7 +1585,7 @@ dse_write_entry(caddr_t data, caddr_t arg)
     char *s;
     PRInt32 len;
 
-    if (NULL != n && NULL != n->entry) {
+    if (NULL != n && NULL != n->entry && !dse_is_transient_entry(slapi_entry_get_sdn_const(n->entry))) {
         int returncode;
         char returntext[SLAPI_DSE_RETURNTEXT_SIZE] = "";
         /* need to make a duplicate here for two reasons:
@@ -1248,18 +1604,8 @@ dse_write_entry(caddr_t data, caddr_t arg)
              * we store all attribute types.
              */
             if ((s = slapi_entry2str_with_options(ec, &len, 0)) != NULL) {
-                if (slapi_write_buffer(fpw->fpw_prfd, s, len) != len) {
-                    fpw->fpw_rc = PR_GetOSError();
-                    ;
-                    slapi_ch_free((void **)&s);
-                    return STOP_TRAVERSAL;
-                }
-                if (slapi_write_buffer(fpw->fpw_prfd, "\n", 1) != 1) {
-                    fpw->fpw_rc = PR_GetOSError();
-                    ;
-                    slapi_ch_free((void **)&s);
-                    return STOP_TRAVERSAL;
-                }
+                dse_snapshot_append(fpw->fpw_snap, s, len);
+                dse_snapshot_append(fpw->fpw_snap, "\n", 1);
                 slapi_ch_free((void **)&s);
             }
         }
@@ -1305,7 +1651,7 @@ dse_add_entry_pb(struct dse *pdse, Slapi_Entry *e, Slapi_PBlock *pb)
         } else { /* entry was merged, free temp unused data */
             dse_node_delete(&n);
         }
-        if (!dont_write_file) {
+        if (!dont_write_file && !dse_is_transient_entry(slapi_entry_get_sdn_const(e))) {
             dse_write_file_nolock(pdse);
         }
     } else {                 /* duplicate entry ignored */
@@ -1585,7 +1931,9 @@ dse_delete_entry(struct dse *pdse, Slapi_PBlock *pb, const Slapi_Entry *e)
         /* Decrement the numsubordinate count of the parent entry */
         dse_updateNumSubOfParent(pdse, slapi_entry_get_sdn_const(e),
                                  SLAPI_OPERATION_DELETE);
-        dse_write_file_nolock(pdse);
+        if (!dse_is_transient_entry(slapi_entry_get_sdn_const(e))) {
+            dse_write_file_nolock(pdse);
+        }
     }
     dse_lock_unlock(pdse, DSE_USE_LOCK);
 
@@ -2239,7 +2587,7 @@ dse_modify(Slapi_PBlock *pb) /* JCM There should only be one exit point from thi
 
     /* Change the entry itself both on disk and in the AVL tree */
     /* dse_replace_entry free's the existing entry. */
-    if (dse_replace_entry(pdse, ecc, !dont_write_file, DSE_USE_LOCK) != 0) {
+    if (dse_replace_entry(pdse, ecc, !dont_write_file && !dse_is_transient_entry(sdn), DSE_USE_LOCK) != 0) {
         returncode = LDAP_OPERATIONS_ERROR;
         retval = -1;
         goto done;
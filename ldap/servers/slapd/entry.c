@@ -42,6 +42,8 @@ static struct _entry_vattr *entry_vattr_lookup_nolock(const Slapi_Entry *e, cons
 static void entry_vattr_add_nolock(Slapi_Entry *e, const char *type, Slapi_Attr *attr);
 static void entry_vattr_free_nolock(Slapi_Entry *e);
 
+static Slapi_Attr *entry_attr_find(const Slapi_Entry *e, const char *type);
+
 /* protected attributes which are not included in the flattened entry,
  * which will be stored in the db. */
 static char **protected_attrs_all = NULL;
@@ -438,6 +440,7 @@ str2entry_fast(const char *rawdn, const Slapi_RDN *srdn, const char *s, int flag
             if (a == NULL) {
                 switch (attr_state) {
                 case ATTRIBUTE_PRESENT:
+                    entry_attrs_changed(e);
                     if (attrlist_append_nosyntax_init(&e->e_attrs, type.bv_val, &a) == 0 /* Found */) {
                         slapi_log_err(SLAPI_LOG_ERR, "str2entry_fast",
                                       "Non-contiguous attribute values for %s\n", type.bv_val);
@@ -1127,11 +1130,6 @@ str2entry_dupcheck(const char *rawdn, const char *s, int flags, int read_statein
         goto free_and_return;
     }
 
-    /* get the read lock of name2asi for performance purpose.
-       It reduces read locking by per-entry lock, instead of per-attribute.
-    */
-    attr_syntax_read_lock();
-
     /*
      * For each unique attribute in the array,
      * Create a Slapi_Attr and set it's present and deleted values.
@@ -1162,10 +1160,12 @@ str2entry_dupcheck(const char *rawdn, const char *s, int flags, int read_statein
                 }
             } else {
                 alist = &e->e_attrs;
+                entry_attrs_changed(e);
             }
             if (alist != NULL) {
                 Slapi_Attr **a = NULL;
-                attrlist_find_or_create_locking_optional(alist, sa->sa_type, &a, PR_FALSE);
+                /* the attribute syntax lookup goes to the lock free schema snapshot */
+                attrlist_find_or_create(alist, sa->sa_type, &a);
                 slapi_valueset_add_attr_valuearray_ext(
                     *a,
                     &(*a)->a_present_values,
@@ -1190,9 +1190,6 @@ str2entry_dupcheck(const char *rawdn, const char *s, int flags, int read_statein
         }
     }
 
-    /* release read lock of name2asi, per-entry lock */
-    attr_syntax_unlock_read();
-
     /* If this is a tombstone, it requires a special treatment for rdn. */
     if (e->e_flags & SLAPI_ENTRY_FLAG_TOMBSTONE) {
         /* tombstone */
@@ -1877,6 +1874,7 @@ slapi_entry_init(Slapi_Entry *e, char *dn, Slapi_Attr *a)
     slapi_sdn_set_dn_passin(slapi_entry_get_sdn(e), dn);
     e->e_uniqueid = NULL;
     e->e_attrs = a;
+    e->e_attrs_index = NULL;
     e->e_dncsnset = NULL;
     e->e_maxcsn = NULL;
     e->e_deleted_attrs = NULL;
@@ -1892,6 +1890,7 @@ slapi_entry_init_ext(Slapi_Entry *e, Slapi_DN *sdn, Slapi_Attr *a)
     slapi_sdn_copy(sdn, slapi_entry_get_sdn(e));
     e->e_uniqueid = NULL;
     e->e_attrs = a;
+    e->e_attrs_index = NULL;
     e->e_dncsnset = NULL;
     e->e_maxcsn = NULL;
     e->e_deleted_attrs = NULL;
@@ -1913,6 +1912,7 @@ slapi_entry_free(Slapi_Entry *e) /* JCM - Should be ** so that we can NULL the p
         csnset_free(&e->e_dncsnset);
         csn_free(&e->e_maxcsn);
         slapi_ch_free((void **)&e->e_uniqueid);
+        entry_attrs_changed(e);
         attrlist_free(e->e_attrs);
         attrlist_free(e->e_deleted_attrs);
         VATTR_WRITE_LOCK(e);
@@ -2229,6 +2229,112 @@ slapi_entry_next_attr(const Slapi_Entry *e, Slapi_Attr *prevattr, Slapi_Attr **a
     return (*a ? 0 : -1);
 }
 
+/*
+ * The attributes of an entry with more than ENTRY_ATTRS_INDEX_THRESHOLD of
+ * them are indexed by type in an open addressing hash table, built by the
+ * first lookup and dropped by any change of the list (entry_attrs_changed).
+ * The entries of the cache are looked up by concurrent readers: the first
+ * one to build the index publishes it, the others free theirs.
+ */
+#define ENTRY_ATTRS_INDEX_THRESHOLD 8
+
+struct entry_attrs_index
+{
+    size_t eai_mask;         /* number of slots - 1 */
+    Slapi_Attr *eai_slots[]; /* linear probing, NULL terminates a probe */
+};
+
+/* for the entries with few attributes, which are looked up in the list */
+static struct entry_attrs_index entry_attrs_not_indexed = {0};
+
+static size_t
+entry_attrs_hash(const char *type)
+{
+    size_t h = 5381;
+
+    for (; *type != '\0'; type++) {
+        h = h * 33 + tolower((unsigned char)*type);
+    }
+    return h;
+}
+
+static struct entry_attrs_index *
+entry_attrs_index_build(const Slapi_Entry *e)
+{
+    struct entry_attrs_index *idx = &entry_attrs_not_indexed;
+    struct entry_attrs_index *published = NULL;
+    Slapi_Attr *a;
+    size_t nattrs = 0;
+    size_t nslots = 1;
+
+    for (a = e->e_attrs; a != NULL; a = a->a_next) {
+        nattrs++;
+    }
+    if (nattrs > ENTRY_ATTRS_INDEX_THRESHOLD) {
+        while (nslots < 2 * nattrs) {
+            nslots <<= 1;
+        }
+        idx = (struct entry_attrs_index *)slapi_ch_calloc(1, sizeof(struct entry_attrs_index) + nslots * sizeof(Slapi_Attr *));
+        idx->eai_mask = nslots - 1;
+        for (a = e->e_attrs; a != NULL; a = a->a_next) {
+            size_t i = entry_attrs_hash(a->a_type) & idx->eai_mask;
+
+            while (idx->eai_slots[i] != NULL && strcasecmp(idx->eai_slots[i]->a_type, a->a_type) != 0) {
+                i = (i + 1) & idx->eai_mask;
+            }
+            /* like attrlist_find(), the first of the attributes of a type wins */
+            if (idx->eai_slots[i] == NULL) {
+                idx->eai_slots[i] = a;
+            }
+        }
+    }
+
+    if (!__atomic_compare_exchange_n(&((Slapi_Entry *)e)->e_attrs_index, &published, idx, 0,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        if (idx != &entry_attrs_not_indexed) {
+            slapi_ch_free((void **)&idx);
+        }
+        idx = published;
+    }
+    return idx;
+}
+
+/* The attribute of the entry with the given type, present or not */
+static Slapi_Attr *
+entry_attr_find(const Slapi_Entry *e, const char *type)
+{
+    struct entry_attrs_index *idx = __atomic_load_n(&e->e_attrs_index, __ATOMIC_ACQUIRE);
+
+    if (idx == NULL) {
+        idx = entry_attrs_index_build(e);
+    }
+    if (idx == &entry_attrs_not_indexed) {
+        return attrlist_find(e->e_attrs, type);
+    }
+    for (size_t i = entry_attrs_hash(type) & idx->eai_mask;; i = (i + 1) & idx->eai_mask) {
+        Slapi_Attr *a = idx->eai_slots[i];
+
+        if (a == NULL || strcasecmp(a->a_type, type) == 0) {
+            return a;
+        }
+    }
+}
+
+/*
+ * Called before the list of attributes of an entry changes, by its owner:
+ * no lookup may be running.
+ */
+void
+entry_attrs_changed(Slapi_Entry *e)
+{
+    struct entry_attrs_index *idx = e->e_attrs_index;
+
+    e->e_attrs_index = NULL;
+    if (idx != NULL && idx != &entry_attrs_not_indexed) {
+        slapi_ch_free((void **)&idx);
+    }
+}
+
 int
 slapi_entry_attr_find(const Slapi_Entry *e, const char *type, Slapi_Attr **a)
 {
@@ -2237,7 +2343,7 @@ slapi_entry_attr_find(const Slapi_Entry *e, const char *type, Slapi_Attr **a)
     if (e == NULL) {
         return r;
     }
-    *a = attrlist_find(e->e_attrs, type);
+    *a = entry_attr_find(e, type);
     if (*a != NULL) {
         if (valueset_isempty(&((*a)->a_present_values))) {
             /*
@@ -2576,6 +2682,9 @@ slapi_entry_attr_merge(Slapi_Entry *e, const char *type, struct berval **vals)
 int
 slapi_entry_attr_merge_sv(Slapi_Entry *e, const char *type, Slapi_Value **vals)
 {
+    if (entry_attr_find(e, type) == NULL) {
+        entry_attrs_changed(e); /* the attribute is created */
+    }
     attrlist_merge_valuearray(&e->e_attrs, type, vals);
     return 0;
 }
@@ -2648,6 +2757,7 @@ slapi_entry_vattrcache_merge_sv(Slapi_Entry *e, const char *type, Slapi_ValueSet
 int
 slapi_entry_attr_delete(Slapi_Entry *e, const char *type)
 {
+    entry_attrs_changed(e);
     return (attrlist_delete(&e->e_attrs, type));
 }
 
@@ -2671,7 +2781,9 @@ int
 slapi_entry_add_value(Slapi_Entry *e, const char *type, const Slapi_Value *value)
 {
     Slapi_Attr **a = NULL;
-    attrlist_find_or_create(&e->e_attrs, type, &a);
+    if (attrlist_find_or_create(&e->e_attrs, type, &a) /* created */) {
+        entry_attrs_changed(e);
+    }
     if (value != (Slapi_Value *)NULL) {
         slapi_valueset_add_attr_value_ext(*a, &(*a)->a_present_values, (Slapi_Value *)value, 0);
     }
@@ -2683,7 +2795,9 @@ int
 slapi_entry_add_string(Slapi_Entry *e, const char *type, const char *value)
 {
     Slapi_Attr **a = NULL;
-    attrlist_find_or_create(&e->e_attrs, type, &a);
+    if (attrlist_find_or_create(&e->e_attrs, type, &a) /* created */) {
+        entry_attrs_changed(e);
+    }
     valueset_add_string(*a, &(*a)->a_present_values, value, CSN_TYPE_UNKNOWN, NULL);
     return 0;
 }
@@ -2691,7 +2805,7 @@ slapi_entry_add_string(Slapi_Entry *e, const char *type, const char *value)
 int
 slapi_entry_delete_string(Slapi_Entry *e, const char *type, const char *value)
 {
-    Slapi_Attr *a = attrlist_find(e->e_attrs, type);
+    Slapi_Attr *a = entry_attr_find(e, type);
     if (a != NULL)
         valueset_remove_string(a, &a->a_present_values, value);
     return 0;
@@ -3663,6 +3777,7 @@ slapi_entry_add_values_sv(Slapi_Entry *e,
     } else {
         Slapi_Attr **a = NULL;
         Slapi_Attr **alist = &e->e_attrs;
+        entry_attrs_changed(e);
         attrlist_find_or_create(alist, type, &a);
         if (slapi_attr_is_dn_syntax_attr(*a)) {
             valuearray_dn_normalize_value(vals);
@@ -3748,6 +3863,7 @@ delete_values_sv_internal(
     if (valuestodelete == NULL || valuestodelete[0] == NULL) {
         slapi_log_err(SLAPI_LOG_ARGS, "delete_values_sv_internal",
                       "removing entire attribute %s\n", type);
+        entry_attrs_changed(e);
         retVal = attrlist_delete(&e->e_attrs, type);
         if (flags & SLAPI_VALUE_FLAG_IGNOREERROR) {
             return LDAP_SUCCESS;
@@ -3756,7 +3872,7 @@ delete_values_sv_internal(
     }
 
     /* delete specific values - find the attribute first */
-    a = attrlist_find(e->e_attrs, type);
+    a = entry_attr_find(e, type);
     if (a == NULL) {
         slapi_log_err(SLAPI_LOG_ARGS, "delete_values_sv_internal",
                       "Could not find attribute %s\n", type);
@@ -3773,6 +3889,7 @@ delete_values_sv_internal(
              * all values have been deleted -- remove entire attribute
              */
             if (valueset_isempty(&a->a_present_values)) {
+                entry_attrs_changed(e);
                 attrlist_delete(&e->e_attrs, a->a_type);
             }
         } else {
@@ -3820,6 +3937,7 @@ entry_replace_values(
     const char *type,
     struct berval **vals)
 {
+    entry_attrs_changed(e);
     return attrlist_replace(&e->e_attrs, type, vals);
 }
 
@@ -3830,6 +3948,7 @@ entry_replace_values_with_flags(
     struct berval **vals,
     int flags)
 {
+    entry_attrs_changed(e);
     return attrlist_replace_with_flags(&e->e_attrs, type, vals, flags);
 }
 
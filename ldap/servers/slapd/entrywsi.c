@@ -64,6 +64,7 @@ entry_deleted_value_to_zapped_value(Slapi_Attr *a, Slapi_Value *v)
 static int
 entry_present_attribute_to_deleted_attribute(Slapi_Entry *e, Slapi_Attr *a)
 {
+    entry_attrs_changed(e);
     attrlist_remove(&e->e_attrs, a->a_type);
     attrlist_add(&e->e_deleted_attrs, a);
     return LDAP_SUCCESS;
@@ -73,6 +74,7 @@ static int
 entry_deleted_attribute_to_present_attribute(Slapi_Entry *e, Slapi_Attr *a)
 {
     attrlist_remove(&e->e_deleted_attrs, a->a_type);
+    entry_attrs_changed(e);
     attrlist_add(&e->e_attrs, a);
     return LDAP_SUCCESS;
 }
@@ -350,6 +352,7 @@ entry_add_present_attribute_wsi(Slapi_Entry *e, Slapi_Attr *a)
 {
     PR_ASSERT(e != NULL);
     PR_ASSERT(a != NULL);
+    entry_attrs_changed(e);
     attrlist_add(&e->e_attrs, a);
     return 0;
 }
@@ -383,6 +386,7 @@ entry_add_present_values_wsi(Slapi_Entry *e, const char *type, struct berval **b
         /* Create a new attribute */
         a = slapi_attr_new();
         slapi_attr_init(a, type);
+        entry_attrs_changed(e);
         attrlist_add(&e->e_attrs, a);
     }
 
@@ -926,6 +930,7 @@ entry_apply_mod_wsi(Slapi_Entry *e, const LDAPMod *mod, const CSN *csn, int urp)
             Slapi_Attr *a;
 
             /* remove the attribute from the attr list */
+            entry_attrs_changed(e);
             a = attrlist_remove(&e->e_attrs, mod->mod_type);
             if (a && a->a_present_values.va) {
                 /* a->a_present_values.va is consumed if successful. */
@@ -25,12 +25,46 @@ There is also an initialization point which must be
 called by the server to initialize the event queue system:
 eq_start_rel(), and an entry point used to shut down the system:
 eq_stop_rel().
+
+The pending events are kept in a hierarchical timing wheel with
+a millisecond tick: EQ_WHEEL_LEVELS levels of EQ_WHEEL_SLOTS
+slots, each level covering EQ_WHEEL_SLOTS times the range of the
+previous one (256 ms, 65 s, 4.6 h and 49 days). An event is put
+in the level whose range contains its expiration time, and moved
+down (cascaded) to the lower levels as the wheel turns. Inserting
+or cancelling an event is O(1).
+
+The scheduler thread turns the wheel and moves the expired events
+to a run queue served by the executor threads. There is a single one
+by default, so the callbacks run one after the other as they always
+did; more (nsslapd-eventq-threads) keep a slow callback from delaying
+the other events, but only suit callbacks that can run concurrently.
+A repeating event is only rescheduled once its callback has returned,
+so a callback never runs concurrently with itself. The runtime of
+every callback is accounted, and the slow ones are logged.
+
+The unit tests replace the clock (eq_set_clock_rel) and run the
+expired events from their own thread (eq_run_expired_rel).
 *********************************************************** */
 
 #include "slap.h"
 #include "prlock.h"
 #include "prcvar.h"
 #include "prinit.h"
+#include <plhash.h>
+
+#define EQ_WHEEL_LEVELS 4
+#define EQ_WHEEL_BITS 8
+#define EQ_WHEEL_SLOTS (1 << EQ_WHEEL_BITS)
+#define EQ_WHEEL_MASK (EQ_WHEEL_SLOTS - 1)
+#define EQ_WHEEL_RANGE (1ULL << (EQ_WHEEL_LEVELS * EQ_WHEEL_BITS)) /* ms */
+#define EQ_SLOW_CALLBACK_MS 1000 /* callbacks running longer are logged */
+
+/* Event states */
+#define EC_QUEUED 0    /* in the wheel */
+#define EC_RUNNABLE 1  /* in the run queue */
+#define EC_RUNNING 2   /* callback in progress */
+#define EC_CANCELLED 3 /* cancelled while runnable or running */
 
 /*
  * Private definition of slapi_eq_context. Only this
@@ -39,12 +73,18 @@ eq_stop_rel().
  */
 typedef struct _slapi_eq_context
 {
-    time_t ec_when;
-    time_t ec_interval;
+    uint64_t ec_when;     /* ms */
+    uint64_t ec_interval; /* ms, 0 for one-time events */
     slapi_eq_fn_t ec_fn;
     void *ec_arg;
     Slapi_Eq_Context ec_id;
+    int ec_state;
     struct _slapi_eq_context *ec_next;
+    struct _slapi_eq_context **ec_pprev; /* wheel slot or previous ec_next */
+    /* runtime accounting */
+    uint64_t ec_calls;
+    uint64_t ec_runtime_ms;
+    uint64_t ec_max_runtime_ms;
 } slapi_eq_context;
 
 /*
@@ -53,8 +93,19 @@ typedef struct _slapi_eq_context
 typedef struct _event_queue
 {
     pthread_mutex_t eq_lock;
-    pthread_cond_t eq_cv;
-    slapi_eq_context *eq_queue;
+    pthread_cond_t eq_cv;     /* wakes up the scheduler */
+    pthread_cond_t eq_run_cv; /* wakes up the executors */
+    slapi_eq_context *eq_wheel[EQ_WHEEL_LEVELS][EQ_WHEEL_SLOTS];
+    uint64_t eq_now;          /* next tick of the wheel to process (ms) */
+    uint64_t eq_count;        /* events in the wheel */
+    slapi_eq_context *eq_runq;
+    slapi_eq_context *eq_runq_tail;
+    PLHashTable *eq_ids;      /* ec_id -> context */
+    uintptr_t eq_last_id;
+    int eq_nthreads;
+    PRThread **eq_threads;
+    uint64_t eq_calls;        /* callbacks run */
+    uint64_t eq_slow_calls;   /* callbacks that ran longer than EQ_SLOW_CALLBACK_MS */
 } event_queue;
 
 /*
@@ -74,19 +125,54 @@ static PRThread *eq_loop_rel_tid = NULL;
 static int eq_rel_running = 0;
 static int eq_rel_stopped = 0;
 static int eq_rel_initialized = 0;
-static pthread_mutex_t ss_rel_lock;
-static pthread_cond_t ss_rel_cv;
 PRCallOnceType init_once_rel = {0};
 
 /* Forward declarations */
 static slapi_eq_context *eq_new_rel(slapi_eq_fn_t fn, void *arg, time_t when, unsigned long interval);
-static void eq_enqueue_rel(slapi_eq_context *newec);
-static slapi_eq_context *eq_dequeue_rel(time_t now);
+static Slapi_Eq_Context eq_enqueue_rel(slapi_eq_context *newec);
+static void eq_wheel_add(slapi_eq_context *ec);
+static void eq_free_rel(slapi_eq_context *ec);
 static PRStatus eq_create_rel(void);
+static uint64_t eq_current_ms(void);
+
+/*
+ * The clock of the wheel, in ms
+ */
+static uint64_t (*eq_clock)(void) = eq_current_ms;
 
 
 /* ******************************************************** */
 
+static uint64_t
+eq_current_ms(void)
+{
+    struct timespec now = slapi_current_rel_time_hr();
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+/*
+ * Replace the clock of the wheel, for the unit tests. Must be called
+ * before eq_init_rel().
+ */
+void
+eq_set_clock_rel(uint64_t (*clock)(void))
+{
+    eq_clock = clock ? clock : eq_current_ms;
+}
+
+static PLHashNumber
+eq_hash_id(const void *key)
+{
+    return (PLHashNumber)(uintptr_t)key;
+}
+
+/* Must be called with eq_lock held */
+static slapi_eq_context *
+eq_lookup_rel(Slapi_Eq_Context ctx)
+{
+    return ctx ? (slapi_eq_context *)PL_HashTableLookup(eq_rel->eq_ids, ctx) : NULL;
+}
+
 
 /*
  * slapi_eq_once_rel: cause an event to happen exactly once.
@@ -110,9 +196,7 @@ slapi_eq_once_rel(slapi_eq_fn_t fn, void *arg, time_t when)
         Slapi_Eq_Context id;
 
         tmp = eq_new_rel(fn, arg, when, 0UL);
-        id = tmp->ec_id;
-
-        eq_enqueue_rel(tmp);
+        id = eq_enqueue_rel(tmp);
 
         /* After this point, <tmp> may have      */
         /* been freed, depending on the thread   */
@@ -146,12 +230,14 @@ slapi_eq_repeat_rel(slapi_eq_fn_t fn, void *arg, time_t when, unsigned long inte
     slapi_eq_context *tmp;
     PR_ASSERT(eq_rel_initialized);
     if (!eq_rel_stopped) {
+        Slapi_Eq_Context id;
+
         tmp = eq_new_rel(fn, arg, when, interval);
-        eq_enqueue_rel(tmp);
+        id = eq_enqueue_rel(tmp);
         slapi_log_err(SLAPI_LOG_HOUSE, NULL,
                       "added repeating event id %p at time %ld, interval %lu\n",
-                      tmp->ec_id, when, interval);
-        return (tmp->ec_id);
+                      id, when, interval);
+        return (id);
     }
     return NULL; /* JCM - Not sure if this should be 0 or something else. */
 }
@@ -161,25 +247,42 @@ slapi_eq_repeat_rel(slapi_eq_fn_t fn, void *arg, time_t when, unsigned long inte
  * slapi_eq_cancel_rel: cancel a pending event.
  * Arguments:
  *  ctx: the context of the event which should be de-scheduled
+ * A repeating event whose callback is running is not rescheduled.
+ * A one-time event whose callback is running is not found.
  */
 int
 slapi_eq_cancel_rel(Slapi_Eq_Context ctx)
 {
-    slapi_eq_context **p, *tmp = NULL;
+    slapi_eq_context *ec;
     int found = 0;
 
     PR_ASSERT(eq_rel_initialized);
     if (!eq_rel_stopped) {
         pthread_mutex_lock(&(eq_rel->eq_lock));
-        p = &(eq_rel->eq_queue);
-        while (!found && *p != NULL) {
-            if ((*p)->ec_id == ctx) {
-                tmp = *p;
-                *p = (*p)->ec_next;
-                slapi_ch_free((void **)&tmp);
+        ec = eq_lookup_rel(ctx);
+        if (ec) {
+            switch (ec->ec_state) {
+            case EC_QUEUED:
+                /* Unlink it from its wheel slot */
+                *ec->ec_pprev = ec->ec_next;
+                if (ec->ec_next) {
+                    ec->ec_next->ec_pprev = ec->ec_pprev;
+                }
+                eq_rel->eq_count--;
+                eq_free_rel(ec);
                 found = 1;
-            } else {
-                p = &((*p)->ec_next);
+                break;
+            case EC_RUNNABLE:
+                /* The executor frees it */
+                ec->ec_state = EC_CANCELLED;
+                found = 1;
+                break;
+            case EC_RUNNING:
+                ec->ec_state = EC_CANCELLED;
+                found = (ec->ec_interval != 0);
+                break;
+            default:
+                break;
             }
         }
         pthread_mutex_unlock(&(eq_rel->eq_lock));
@@ -207,127 +310,305 @@ eq_new_rel(slapi_eq_fn_t fn, void *arg, time_t when, unsigned long interval)
      * has expired, we'll be executed anyway. save the cycles, and just set
      * ec_when.
      */
-    retptr->ec_when = when;
-    retptr->ec_interval = interval == 0UL ? 0UL : (interval + 999) / 1000;
-    retptr->ec_id = (Slapi_Eq_Context)retptr;
+    retptr->ec_when = when > 0 ? (uint64_t)when * 1000 : 0;
+    retptr->ec_interval = interval;
     return retptr;
 }
 
+/* Must be called with eq_lock held, once the event is out of the wheel and run queue */
+static void
+eq_free_rel(slapi_eq_context *ec)
+{
+    PL_HashTableRemove(eq_rel->eq_ids, ec->ec_id);
+    slapi_ch_free((void **)&ec);
+}
+
 
 /*
- * Add a new event to the event queue.
+ * Put an event in the wheel slot matching its expiration time.
+ * Must be called with eq_lock held.
  */
 static void
+eq_wheel_add(slapi_eq_context *ec)
+{
+    uint64_t expires = ec->ec_when;
+    uint64_t delta;
+    slapi_eq_context **slot;
+    int level;
+
+    if (expires < eq_rel->eq_now) {
+        /* Already expired: run it at the next tick */
+        expires = eq_rel->eq_now;
+    }
+    delta = expires - eq_rel->eq_now;
+    if (delta >= EQ_WHEEL_RANGE) {
+        /* Park it in the last level, it is cascaded again later */
+        expires = eq_rel->eq_now + EQ_WHEEL_RANGE - 1;
+        delta = EQ_WHEEL_RANGE - 1;
+    }
+    for (level = 0; level < EQ_WHEEL_LEVELS - 1; level++) {
+        if (delta < (1ULL << ((level + 1) * EQ_WHEEL_BITS))) {
+            break;
+        }
+    }
+    slot = &eq_rel->eq_wheel[level][(expires >> (level * EQ_WHEEL_BITS)) & EQ_WHEEL_MASK];
+
+    ec->ec_state = EC_QUEUED;
+    ec->ec_next = *slot;
+    if (*slot) {
+        (*slot)->ec_pprev = &ec->ec_next;
+    }
+    ec->ec_pprev = slot;
+    *slot = ec;
+    eq_rel->eq_count++;
+}
+
+
+/*
+ * Add a new event to the event queue.
+ */
+static Slapi_Eq_Context
 eq_enqueue_rel(slapi_eq_context *newec)
 {
-    slapi_eq_context **p;
+    Slapi_Eq_Context id;
 
     PR_ASSERT(NULL != newec);
     pthread_mutex_lock(&(eq_rel->eq_lock));
-    /* Insert <newec> in order (sorted by start time) in the list */
-    for (p = &(eq_rel->eq_queue); *p != NULL; p = &((*p)->ec_next)) {
-        if ((*p)->ec_when > newec->ec_when) {
-            break;
+    /* Ids are never reused, so cancelling an event that already ran is harmless */
+    id = newec->ec_id = (Slapi_Eq_Context)++eq_rel->eq_last_id;
+    PL_HashTableAdd(eq_rel->eq_ids, newec->ec_id, newec);
+    eq_wheel_add(newec);
+    pthread_cond_signal(&(eq_rel->eq_cv)); /* wake up scheduler thread */
+    pthread_mutex_unlock(&(eq_rel->eq_lock));
+    return id;
+}
+
+
+/*
+ * Move the events of a slot to the lower levels.
+ * Returns the slot index. Must be called with eq_lock held.
+ */
+static int
+eq_wheel_cascade(int level)
+{
+    int idx = (eq_rel->eq_now >> (level * EQ_WHEEL_BITS)) & EQ_WHEEL_MASK;
+    slapi_eq_context *ec = eq_rel->eq_wheel[level][idx];
+
+    eq_rel->eq_wheel[level][idx] = NULL;
+    while (ec) {
+        slapi_eq_context *next = ec->ec_next;
+        eq_rel->eq_count--;
+        eq_wheel_add(ec);
+        ec = next;
+    }
+    return idx;
+}
+
+
+/*
+ * Process the wheel ticks up to <now> and move the expired
+ * events to the run queue. Must be called with eq_lock held.
+ */
+static void
+eq_wheel_advance(uint64_t now)
+{
+    if (eq_rel->eq_count == 0) {
+        eq_rel->eq_now = now + 1;
+        return;
+    }
+    while (eq_rel->eq_now <= now) {
+        int idx = eq_rel->eq_now & EQ_WHEEL_MASK;
+        slapi_eq_context *ec;
+
+        if (idx == 0) {
+            for (int level = 1; level < EQ_WHEEL_LEVELS && eq_wheel_cascade(level) == 0; level++)
+                ;
         }
+        ec = eq_rel->eq_wheel[0][idx];
+        eq_rel->eq_wheel[0][idx] = NULL;
+        while (ec) {
+            slapi_eq_context *next = ec->ec_next;
+            eq_rel->eq_count--;
+            ec->ec_state = EC_RUNNABLE;
+            ec->ec_next = NULL;
+            ec->ec_pprev = NULL;
+            if (eq_rel->eq_runq_tail) {
+                eq_rel->eq_runq_tail->ec_next = ec;
+            } else {
+                eq_rel->eq_runq = ec;
+            }
+            eq_rel->eq_runq_tail = ec;
+            ec = next;
+        }
+        eq_rel->eq_now++;
     }
-    if (NULL != *p) {
-        newec->ec_next = *p;
-    } else {
-        newec->ec_next = NULL;
+    if (eq_rel->eq_runq) {
+        pthread_cond_broadcast(&(eq_rel->eq_run_cv));
     }
-    *p = newec;
-    pthread_cond_signal(&(eq_rel->eq_cv)); /* wake up scheduler thread */
-    pthread_mutex_unlock(&(eq_rel->eq_lock));
 }
 
 
 /*
- * If there is an event in the queue scheduled at time
- * <now> or before, dequeue it and return a pointer
- * to it. Otherwise, return NULL.
+ * Returns the tick at which the scheduler needs to wake up: the
+ * first non empty slot of the first level, or the next cascade of
+ * a non empty slot of an upper level if it comes first (the events
+ * it holds may be due before the ones of the first level).
+ * Must be called with eq_lock held.
  */
-static slapi_eq_context *
-eq_dequeue_rel(time_t now)
+static uint64_t
+eq_wheel_next_expiry(void)
 {
-    slapi_eq_context *retptr = NULL;
+    uint64_t next = UINT64_MAX;
+    int idx = eq_rel->eq_now & EQ_WHEEL_MASK;
 
-    pthread_mutex_lock(&(eq_rel->eq_lock));
-    if (NULL != eq_rel->eq_queue && eq_rel->eq_queue->ec_when <= now) {
-        retptr = eq_rel->eq_queue;
-        eq_rel->eq_queue = retptr->ec_next;
+    for (int i = 0; i < EQ_WHEEL_SLOTS; i++) {
+        if (eq_rel->eq_wheel[0][(idx + i) & EQ_WHEEL_MASK]) {
+            next = eq_rel->eq_now + i;
+            break;
+        }
     }
-    pthread_mutex_unlock(&(eq_rel->eq_lock));
-    return retptr;
+    for (int level = 1; level < EQ_WHEEL_LEVELS; level++) {
+        int shift = level * EQ_WHEEL_BITS;
+        uint64_t base = eq_rel->eq_now >> shift;
+        /* the current slot is cascaded when the index wraps around */
+        for (int k = 1; k <= EQ_WHEEL_SLOTS; k++) {
+            if (eq_rel->eq_wheel[level][(base + k) & EQ_WHEEL_MASK]) {
+                uint64_t when = (base + k) << shift;
+                if (when < next) {
+                    next = when;
+                }
+                break;
+            }
+        }
+    }
+    return next;
 }
 
 
 /*
- * Call all events which are due to run.
+ * Run the callback of the first event of the run queue, and requeue
+ * it if it repeats.
  * Note that if we've missed a schedule
  * opportunity, we don't try to catch up
  * by calling the function repeatedly.
+ * Must be called with eq_lock held, which is released during the callback.
  */
 static void
-eq_call_all_rel(void)
+eq_run_first_rel(void)
 {
-    slapi_eq_context *p;
-    time_t curtime = slapi_current_rel_time_t();
+    slapi_eq_context *p = eq_rel->eq_runq;
+    uint64_t start, runtime;
 
-    while ((p = eq_dequeue_rel(curtime)) != NULL) {
-        /* Call the scheduled function */
-        p->ec_fn(p->ec_when, p->ec_arg);
-        slapi_log_err(SLAPI_LOG_HOUSE, NULL,
-                      "Event id %p called at %ld (scheduled for %ld)\n",
-                      p->ec_id, curtime, p->ec_when);
-        if (0UL != p->ec_interval) {
-            /* This is a repeating event. Requeue it. */
-            do {
-                p->ec_when += p->ec_interval;
-            } while (p->ec_when < curtime);
-            eq_enqueue_rel(p);
-        } else {
-            slapi_ch_free((void **)&p);
+    eq_rel->eq_runq = p->ec_next;
+    if (eq_rel->eq_runq == NULL) {
+        eq_rel->eq_runq_tail = NULL;
+    }
+    p->ec_next = NULL;
+    if (p->ec_state == EC_CANCELLED) {
+        eq_free_rel(p);
+        return;
+    }
+    p->ec_state = EC_RUNNING;
+    pthread_mutex_unlock(&(eq_rel->eq_lock));
+
+    /* Call the scheduled function */
+    start = eq_clock();
+    p->ec_fn((time_t)(p->ec_when / 1000), p->ec_arg);
+    runtime = eq_clock() - start;
+    slapi_log_err(SLAPI_LOG_HOUSE, NULL,
+                  "Event id %p called at %" PRIu64 " ms (scheduled for %" PRIu64 " ms), ran for %" PRIu64 " ms\n",
+                  p->ec_id, start, p->ec_when, runtime);
+
+    pthread_mutex_lock(&(eq_rel->eq_lock));
+    p->ec_calls++;
+    p->ec_runtime_ms += runtime;
+    if (runtime > p->ec_max_runtime_ms) {
+        p->ec_max_runtime_ms = runtime;
+    }
+    eq_rel->eq_calls++;
+    if (runtime >= EQ_SLOW_CALLBACK_MS) {
+        eq_rel->eq_slow_calls++;
+        slapi_log_err(SLAPI_LOG_NOTICE, "eq_executor_rel",
+                      "Event id %p (function %p) ran for %" PRIu64 " ms "
+                      "(%" PRIu64 " calls, %" PRIu64 " ms in total, %" PRIu64 " ms at most)\n",
+                      p->ec_id, p->ec_fn, runtime, p->ec_calls,
+                      p->ec_runtime_ms, p->ec_max_runtime_ms);
+    }
+    if (0UL != p->ec_interval && p->ec_state != EC_CANCELLED) {
+        /* This is a repeating event. Requeue it. */
+        uint64_t curtime = eq_clock();
+        do {
+            p->ec_when += p->ec_interval;
+        } while (p->ec_when < curtime);
+        eq_wheel_add(p);
+        pthread_cond_signal(&(eq_rel->eq_cv));
+    } else {
+        eq_free_rel(p);
+    }
+}
+
+/*
+ * The executor threads: run the callbacks of the
+ * expired events.
+ */
+static void
+eq_executor_rel(void *arg __attribute__((unused)))
+{
+    pthread_mutex_lock(&(eq_rel->eq_lock));
+    while (eq_rel_running) {
+        if (eq_rel->eq_runq == NULL) {
+            pthread_cond_wait(&(eq_rel->eq_run_cv), &(eq_rel->eq_lock));
+            continue;
         }
+        eq_run_first_rel();
+    }
+    pthread_mutex_unlock(&(eq_rel->eq_lock));
+}
+
+/*
+ * Turn the wheel up to the current time of the clock and run the
+ * expired events from the calling thread, for the unit tests (the
+ * event queue is not started). Returns the tick at which the next
+ * event may expire, UINT64_MAX if there is none.
+ */
+uint64_t
+eq_run_expired_rel(void)
+{
+    uint64_t next;
+
+    pthread_mutex_lock(&(eq_rel->eq_lock));
+    eq_wheel_advance(eq_clock());
+    while (eq_rel->eq_runq) {
+        eq_run_first_rel();
     }
+    next = eq_wheel_next_expiry();
+    pthread_mutex_unlock(&(eq_rel->eq_lock));
+    return next;
 }
 
 
 /*
- * The main event queue loop.
+ * The main event queue loop: turns the wheel.
  */
 static void
 eq_loop_rel(void *arg __attribute__((unused)))
 {
+    pthread_mutex_lock(&(eq_rel->eq_lock));
     while (eq_rel_running) {
-        time_t curtime = slapi_current_rel_time_t();
-        int until;
+        uint64_t next;
 
-        pthread_mutex_lock(&(eq_rel->eq_lock));
-        while (!((NULL != eq_rel->eq_queue) && (eq_rel->eq_queue->ec_when <= curtime))) {
-            if (!eq_rel_running) {
-                pthread_mutex_unlock(&(eq_rel->eq_lock));
-                goto bye;
-            }
-            /* Compute new timeout */
-            if (NULL != eq_rel->eq_queue) {
-                struct timespec current_time = slapi_current_rel_time_hr();
-                until = eq_rel->eq_queue->ec_when - curtime;
-                current_time.tv_sec += until;
-                pthread_cond_timedwait(&eq_rel->eq_cv, &eq_rel->eq_lock, &current_time);
-            } else {
-                pthread_cond_wait(&eq_rel->eq_cv, &eq_rel->eq_lock);
-            }
-            curtime = slapi_current_rel_time_t();
+        eq_wheel_advance(eq_clock());
+        next = eq_wheel_next_expiry();
+        if (next == UINT64_MAX) {
+            pthread_cond_wait(&eq_rel->eq_cv, &eq_rel->eq_lock);
+        } else {
+            struct timespec deadline;
+            deadline.tv_sec = next / 1000;
+            deadline.tv_nsec = (next % 1000) * 1000000;
+            pthread_cond_timedwait(&eq_rel->eq_cv, &eq_rel->eq_lock, &deadline);
         }
-        /* There is some work to do */
-        pthread_mutex_unlock(&(eq_rel->eq_lock));
-        eq_call_all_rel();
     }
-bye:
-    eq_rel_stopped = 1;
-    pthread_mutex_lock(&ss_rel_lock);
-    pthread_cond_broadcast(&ss_rel_cv);
-    pthread_mutex_unlock(&ss_rel_lock);
+    pthread_mutex_unlock(&(eq_rel->eq_lock));
 }
 
 
@@ -365,23 +646,16 @@ eq_create_rel(void)
                       rc, strerror(rc));
         exit(1);
     }
-
-    /* Init the "ss" mutex and condition var */
-    if (pthread_mutex_init(&ss_rel_lock, NULL) != 0) {
+    if ((rc = pthread_cond_init(&eq_rel->eq_run_cv, &condAttr)) != 0) {
         slapi_log_err(SLAPI_LOG_ERR, "eq_create_rel",
-                      "Failed to create ss lock: error %d (%s)\n",
-                      rc, strerror(rc));
-        exit(1);
-    }
-    if ((rc = pthread_cond_init(&ss_rel_cv, &condAttr)) != 0) {
-        slapi_log_err(SLAPI_LOG_ERR, "eq_create_rel",
-                      "Failed to create new ss condition variable. error %d (%s)\n",
+                      "Failed to create new executor condition variable. error %d (%s)\n",
                       rc, strerror(rc));
         exit(1);
     }
     pthread_condattr_destroy(&condAttr); /* no longer needed */
 
-    eq_rel->eq_queue = NULL;
+    eq_rel->eq_ids = PL_NewHashTable(64, eq_hash_id, PL_CompareValues, PL_CompareValues, NULL, NULL);
+    eq_rel->eq_now = eq_clock();
     eq_rel_initialized = 1;
     return PR_SUCCESS;
 }
@@ -391,20 +665,35 @@ eq_create_rel(void)
  * eq_start_rel: start the event queue system.
  *
  * This should be called exactly once. It will start a
- * thread which wakes up periodically and schedules events.
+ * thread which wakes up when events expire, and the
+ * threads which run their callbacks.
  */
 void
 eq_start_rel()
 {
+    int nthreads = config_get_eventq_threads();
+
     PR_ASSERT(eq_rel_initialized);
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
     eq_rel_running = 1;
+    eq_rel->eq_threads = (PRThread **)slapi_ch_calloc(nthreads, sizeof(PRThread *));
+    for (eq_rel->eq_nthreads = 0; eq_rel->eq_nthreads < nthreads; eq_rel->eq_nthreads++) {
+        if ((eq_rel->eq_threads[eq_rel->eq_nthreads] = PR_CreateThread(PR_USER_THREAD, (VFP)eq_executor_rel,
+                                                                       NULL, PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD, PR_JOINABLE_THREAD,
+                                                                       SLAPD_DEFAULT_THREAD_STACKSIZE)) == NULL) {
+            slapi_log_err(SLAPI_LOG_ERR, "eq_start_rel", "eq_executor_rel PR_CreateThread failed\n");
+            exit(1);
+        }
+    }
     if ((eq_loop_rel_tid = PR_CreateThread(PR_USER_THREAD, (VFP)eq_loop_rel,
                                        NULL, PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD, PR_JOINABLE_THREAD,
                                        SLAPD_DEFAULT_THREAD_STACKSIZE)) == NULL) {
         slapi_log_err(SLAPI_LOG_ERR, "eq_start_rel", "eq_loop_rel PR_CreateThread failed\n");
         exit(1);
     }
-    slapi_log_err(SLAPI_LOG_HOUSE, NULL, "event queue services have started\n");
+    slapi_log_err(SLAPI_LOG_HOUSE, NULL, "event queue services have started (%d executor threads)\n", nthreads);
 }
 
 
@@ -439,38 +728,30 @@ eq_stop_rel()
 {
     slapi_eq_context *p, *q;
 
-    if (NULL == eq_rel) { /* never started */
+    if (!eq_rel_initialized) { /* never started */
         eq_rel_stopped = 1;
         return;
     }
 
-    eq_rel_stopped = 0;
-    eq_rel_running = 0;
     /*
-     * Signal the eq thread function to stop, and wait until
-     * it acknowledges by setting eq_rel_stopped.
+     * Signal the eq threads to stop, the executors complete
+     * the callback they are running.
      */
-    while (!eq_rel_stopped) {
-        struct timespec current_time = {0};
-
-        pthread_mutex_lock(&(eq_rel->eq_lock));
-        pthread_cond_broadcast(&(eq_rel->eq_cv));
-        pthread_mutex_unlock(&(eq_rel->eq_lock));
+    pthread_mutex_lock(&(eq_rel->eq_lock));
+    eq_rel_running = 0;
+    pthread_cond_broadcast(&(eq_rel->eq_cv));
+    pthread_cond_broadcast(&(eq_rel->eq_run_cv));
+    pthread_mutex_unlock(&(eq_rel->eq_lock));
 
-        pthread_mutex_lock(&ss_rel_lock);
-        clock_gettime(CLOCK_MONOTONIC, &current_time);
-        if (current_time.tv_nsec + 100000000 > 1000000000) {
-            /* nanoseconds will overflow, adjust the seconds and nanoseconds */
-            current_time.tv_sec++;
-            /* Add the remainder to nanoseconds */
-            current_time.tv_nsec = (current_time.tv_nsec + 100000000) - 1000000000;
-        } else {
-            current_time.tv_nsec += 100000000; /* 100 ms */
-        }
-        pthread_cond_timedwait(&ss_rel_cv, &ss_rel_lock, &current_time);
-        pthread_mutex_unlock(&ss_rel_lock);
+    if (eq_loop_rel_tid) {
+        (void)PR_JoinThread(eq_loop_rel_tid);
+    }
+    for (int i = 0; i < eq_rel->eq_nthreads; i++) {
+        (void)PR_JoinThread(eq_rel->eq_threads[i]);
     }
-    (void)PR_JoinThread(eq_loop_rel_tid);
+    slapi_ch_free((void **)&eq_rel->eq_threads);
+    eq_rel->eq_nthreads = 0;
+    eq_rel_stopped = 1;
     /*
      * XXXggood we don't free the actual event queue data structures.
      * This is intentional, to allow enqueueing/cancellation of events
@@ -479,18 +760,29 @@ eq_stop_rel()
      * easily.
      */
     pthread_mutex_lock(&(eq_rel->eq_lock));
-    p = eq_rel->eq_queue;
-    while (p != NULL) {
+    for (int level = 0; level < EQ_WHEEL_LEVELS; level++) {
+        for (int i = 0; i < EQ_WHEEL_SLOTS; i++) {
+            for (p = eq_rel->eq_wheel[level][i]; p != NULL; p = q) {
+                q = p->ec_next;
+                /* Some ec_arg could get leaked here in shutdown (e.g., replica_name)
+                 * This can be fixed by specifying a flag when the context is queued.
+                 * [After 6.2]
+                 */
+                eq_free_rel(p);
+            }
+            eq_rel->eq_wheel[level][i] = NULL;
+        }
+    }
+    for (p = eq_rel->eq_runq; p != NULL; p = q) {
         q = p->ec_next;
-        slapi_ch_free((void **)&p);
-        /* Some ec_arg could get leaked here in shutdown (e.g., replica_name)
-         * This can be fixed by specifying a flag when the context is queued.
-         * [After 6.2]
-         */
-        p = q;
+        eq_free_rel(p);
     }
+    eq_rel->eq_runq = eq_rel->eq_runq_tail = NULL;
+    eq_rel->eq_count = 0;
+    slapi_log_err(SLAPI_LOG_HOUSE, NULL,
+                  "event queue services have shut down (%" PRIu64 " callbacks run, %" PRIu64 " slow ones)\n",
+                  eq_rel->eq_calls, eq_rel->eq_slow_calls);
     pthread_mutex_unlock(&(eq_rel->eq_lock));
-    slapi_log_err(SLAPI_LOG_HOUSE, NULL, "event queue services have shut down\n");
 }
 
 /*
@@ -499,21 +791,17 @@ eq_stop_rel()
 void *
 slapi_eq_get_arg_rel(Slapi_Eq_Context ctx)
 {
-    slapi_eq_context **p;
+    slapi_eq_context *ec;
+    void *arg = NULL;
 
     PR_ASSERT(eq_rel_initialized);
     if (eq_rel && !eq_rel_stopped) {
         pthread_mutex_lock(&(eq_rel->eq_lock));
-        p = &(eq_rel->eq_queue);
-        while (p && *p != NULL) {
-            if ((*p)->ec_id == ctx) {
-                pthread_mutex_unlock(&(eq_rel->eq_lock));
-                return (*p)->ec_arg;
-            } else {
-                p = &((*p)->ec_next);
-            }
+        ec = eq_lookup_rel(ctx);
+        if (ec && ec->ec_state != EC_CANCELLED) {
+            arg = ec->ec_arg;
         }
         pthread_mutex_unlock(&(eq_rel->eq_lock));
     }
-    return NULL;
+    return arg;
 }
@@ -103,6 +103,11 @@ static const char *internal_entries[] =
         "objectclass:extensibleObject\n"
         "cn:counters\n",
 
+        "dn:cn=latency,cn=monitor\n"
+        "objectclass:top\n"
+        "objectclass:extensibleObject\n"
+        "cn:latency\n",
+
         "dn:cn=sasl,cn=config\n"
         "objectclass:top\n"
         "objectclass:nsContainer\n"
@@ -2774,23 +2779,23 @@ search_encryption(Slapi_PBlock *pb __attribute__((unused)),
     vals[0] = &val;
     vals[1] = NULL;
 
-    attrlist_delete(&entry->e_attrs, "nsSSLSupportedCiphers");
+    slapi_entry_attr_delete(entry, "nsSSLSupportedCiphers");
     while (cipherList && *cipherList) /* iterarate thru each of them and add to the attr value */
     {
         char *cipher = *cipherList;
         val.bv_val = (char *)cipher;
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&entry->e_attrs, "nsSSLSupportedCiphers", vals);
+        slapi_entry_attr_merge(entry, "nsSSLSupportedCiphers", vals);
         cipherList++;
     }
 
-    attrlist_delete(&entry->e_attrs, "nsSSLEnabledCiphers");
+    slapi_entry_attr_delete(entry, "nsSSLEnabledCiphers");
     while (enabledCipherList && *enabledCipherList) /* iterarate thru each of them and add to the attr value */
     {
         char *cipher = *enabledCipherList;
         val.bv_val = (char *)cipher;
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&entry->e_attrs, "nsSSLEnabledCiphers", vals);
+        slapi_entry_attr_merge(entry, "nsSSLEnabledCiphers", vals);
         enabledCipherList++;
     }
 
@@ -2879,6 +2884,18 @@ search_snmp(Slapi_PBlock *pb __attribute__((unused)),
     return SLAPI_DSE_CALLBACK_OK;
 }
 
+int
+search_latency(Slapi_PBlock *pb __attribute__((unused)),
+               Slapi_Entry *entryBefore,
+               Slapi_Entry *e __attribute__((unused)),
+               int *returncode __attribute__((unused)),
+               char *returntext __attribute__((unused)),
+               void *arg __attribute__((unused)))
+{
+    latency_as_entry(entryBefore);
+    return SLAPI_DSE_CALLBACK_OK;
+}
+
 /*
  * Called from main.c to install the internal backends
  */
@@ -2898,6 +2915,7 @@ setup_internal_backends(char *configdir)
         Slapi_DN monitor;
         Slapi_DN counters;
         Slapi_DN snmp;
+        Slapi_DN latency;
         Slapi_DN root;
         Slapi_Backend *be;
         Slapi_DN encryption;
@@ -2908,6 +2926,7 @@ setup_internal_backends(char *configdir)
         slapi_sdn_init_ndn_byref(&monitor, "cn=monitor");
         slapi_sdn_init_ndn_byref(&counters, "cn=counters,cn=monitor");
         slapi_sdn_init_ndn_byref(&snmp, "cn=snmp,cn=monitor");
+        slapi_sdn_init_ndn_byref(&latency, "cn=latency,cn=monitor");
         slapi_sdn_init_ndn_byref(&diskspace, "cn=disk space,cn=monitor");
         slapi_sdn_init_ndn_byref(&root, "");
 
@@ -2923,6 +2942,7 @@ setup_internal_backends(char *configdir)
         dse_register_callback(pfedse, SLAPI_OPERATION_SEARCH, DSE_FLAG_PREOP, &monitor, LDAP_SCOPE_SUBTREE, EGG_FILTER, search_easter_egg, NULL, NULL); /* Egg */
         dse_register_callback(pfedse, SLAPI_OPERATION_SEARCH, DSE_FLAG_PREOP, &counters, LDAP_SCOPE_BASE, "(objectclass=*)", search_counters, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_SEARCH, DSE_FLAG_PREOP, &snmp, LDAP_SCOPE_BASE, "(objectclass=*)", search_snmp, NULL, NULL);
+        dse_register_callback(pfedse, SLAPI_OPERATION_SEARCH, DSE_FLAG_PREOP, &latency, LDAP_SCOPE_BASE, "(objectclass=*)", search_latency, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_SEARCH, DSE_FLAG_PREOP, &encryption, LDAP_SCOPE_BASE, "(objectclass=*)", search_encryption, NULL, NULL);
 
         /* Modify */
@@ -2937,6 +2957,7 @@ setup_internal_backends(char *configdir)
         dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &monitor, LDAP_SCOPE_BASE, "(objectclass=*)", dont_allow_that, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &counters, LDAP_SCOPE_BASE, "(objectclass=*)", dont_allow_that, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &snmp, LDAP_SCOPE_BASE, "(objectclass=*)", dont_allow_that, NULL, NULL);
+        dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &latency, LDAP_SCOPE_BASE, "(objectclass=*)", dont_allow_that, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &root, LDAP_SCOPE_BASE, "(objectclass=*)", dont_allow_that, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &encryption, LDAP_SCOPE_BASE, "(objectclass=*)", dont_allow_that, NULL, NULL);
         dse_register_callback(pfedse, SLAPI_OPERATION_DELETE, DSE_FLAG_PREOP, &saslmapping, LDAP_SCOPE_SUBTREE, "(objectclass=nsSaslMapping)", sasl_map_config_delete, NULL, NULL);
@@ -2968,6 +2989,7 @@ setup_internal_backends(char *configdir)
         slapi_sdn_done(&monitor);
         slapi_sdn_done(&counters);
         slapi_sdn_done(&snmp);
+        slapi_sdn_done(&latency);
         slapi_sdn_done(&root);
         slapi_sdn_done(&saslmapping);
         slapi_sdn_done(&plugins);
@@ -0,0 +1,295 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+/*
+ * latency.c - latency histograms
+ *
+ * Latencies are recorded in microseconds in log-linear buckets (in
+ * the spirit of HDR histograms): each power of 2 is split into
+ * LATENCY_SUB_BUCKETS buckets, so a percentile is known with a ~12%
+ * precision, from 1 microsecond up to ~19 hours.
+ *
+ * Recording is lock free: it is a couple of relaxed atomic increments.
+ * The buckets are never reset. Instead each reader (cn=latency,cn=monitor
+ * and cn=snmp,cn=monitor) remembers the buckets it saw at its previous
+ * read, and reports the latencies of the window since that read. Readers
+ * do not interfere with each other.
+ */
+
+#include "slap.h"
+#include "fe.h"
+
+#define LATENCY_SUB_BITS 3
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_BITS 36
+#define LATENCY_NB_BUCKETS ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+struct slapi_latency
+{
+    uint64_t buckets[LATENCY_NB_BUCKETS]; /* since startup */
+    uint64_t sum;                         /* microseconds, since startup */
+    /* buckets and sum at the previous read of each reader */
+    uint64_t seen[LATENCY_NB_READERS][LATENCY_NB_BUCKETS + 1];
+};
+
+/* Serializes the readers, recording never takes it */
+static pthread_mutex_t latency_read_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Operation latencies, per operation type */
+#define LATENCY_WAIT_TIME 0
+#define LATENCY_OP_TIME 1
+
+static struct
+{
+    ber_tag_t tag;
+    const char *name;      /* cn=latency,cn=monitor attribute prefix */
+    const char *snmp_name; /* cn=snmp,cn=monitor attribute prefix */
+    Slapi_Latency latency[2];
+} latency_ops[] = {
+    {LDAP_REQ_BIND, "bind", "Bind"},
+    {LDAP_REQ_SEARCH, "search", "Search"},
+    {LDAP_REQ_COMPARE, "compare", "Compare"},
+    {LDAP_REQ_ADD, "add", "Add"},
+    {LDAP_REQ_DELETE, "delete", "Delete"},
+    {LDAP_REQ_MODIFY, "modify", "Modify"},
+    {LDAP_REQ_MODRDN, "modrdn", "ModRDN"},
+    {LDAP_REQ_EXTENDED, "extended", "Extended"},
+};
+#define LATENCY_NB_OPS (sizeof(latency_ops) / sizeof(latency_ops[0]))
+
+Slapi_Latency *
+latency_new(void)
+{
+    return (Slapi_Latency *)slapi_ch_calloc(1, sizeof(Slapi_Latency));
+}
+
+void
+latency_free(Slapi_Latency **latency)
+{
+    slapi_ch_free((void **)latency);
+}
+
+static size_t
+latency_bucket(uint64_t usec)
+{
+    int bits;
+
+    if (usec < LATENCY_SUB_BUCKETS) {
+        return usec;
+    }
+    bits = 63 - __builtin_clzll(usec);
+    if (bits >= LATENCY_MAX_BITS) {
+        return LATENCY_NB_BUCKETS - 1;
+    }
+    return (bits - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS +
+           (usec >> (bits - LATENCY_SUB_BITS)) - LATENCY_SUB_BUCKETS;
+}
+
+/* Highest latency recorded in a bucket */
+static uint64_t
+latency_bucket_value(size_t bucket)
+{
+    size_t group = bucket / LATENCY_SUB_BUCKETS;
+    uint64_t mantissa = bucket % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS;
+
+    if (group == 0) {
+        return bucket;
+    }
+    return ((mantissa + 1) << (group - 1)) - 1;
+}
+
+void
+latency_record(Slapi_Latency *latency, const struct timespec *elapsed)
+{
+    uint64_t usec;
+
+    if (latency == NULL) {
+        return;
+    }
+    usec = (uint64_t)elapsed->tv_sec * 1000000 + elapsed->tv_nsec / 1000;
+    __atomic_add_fetch(&latency->buckets[latency_bucket(usec)], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&latency->sum, usec, __ATOMIC_RELAXED);
+}
+
+/*
+ * Summarizes the latencies recorded since the previous read
+ * by the same reader, and starts a new window for it.
+ */
+void
+latency_read(Slapi_Latency *latency, int reader, Slapi_Latency_Summary *summary)
+{
+    uint64_t window[LATENCY_NB_BUCKETS];
+    uint64_t targets[4];
+    uint64_t *results[4] = {&summary->p50, &summary->p90, &summary->p99, &summary->p999};
+    uint64_t sum;
+    uint64_t cumul = 0;
+    size_t t = 0;
+
+    memset(summary, 0, sizeof(*summary));
+    if (latency == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&latency_read_lock);
+    for (size_t i = 0; i < LATENCY_NB_BUCKETS; i++) {
+        uint64_t value = __atomic_load_n(&latency->buckets[i], __ATOMIC_RELAXED);
+        window[i] = value - latency->seen[reader][i];
+        latency->seen[reader][i] = value;
+        summary->count += window[i];
+    }
+    sum = __atomic_load_n(&latency->sum, __ATOMIC_RELAXED);
+    summary->avg = sum - latency->seen[reader][LATENCY_NB_BUCKETS];
+    latency->seen[reader][LATENCY_NB_BUCKETS] = sum;
+    pthread_mutex_unlock(&latency_read_lock);
+
+    if (summary->count == 0) {
+        summary->avg = 0;
+        return;
+    }
+    summary->avg /= summary->count;
+
+    /* Rank of each percentile, rounded up */
+    targets[0] = (summary->count * 500 + 999) / 1000;
+    targets[1] = (summary->count * 900 + 999) / 1000;
+    targets[2] = (summary->count * 990 + 999) / 1000;
+    targets[3] = (summary->count * 999 + 999) / 1000;
+    for (size_t i = 0; i < LATENCY_NB_BUCKETS; i++) {
+        if (window[i] == 0) {
+            continue;
+        }
+        cumul += window[i];
+        while (t < 4 && cumul >= targets[t]) {
+            *results[t++] = latency_bucket_value(i);
+        }
+        summary->max = latency_bucket_value(i);
+    }
+}
+
+/*
+ * Records the wait and operation times of a completed operation,
+ * per operation type and for the backend that served it.
+ */
+void
+latency_record_op(Slapi_PBlock *pb, Slapi_Operation *op)
+{
+    struct timespec wtime;
+    struct timespec optime;
+    Slapi_Backend *be = NULL;
+    ber_tag_t tag = operation_get_type(op);
+
+    slapi_operation_workq_time_elapsed(op, &wtime);
+    slapi_operation_op_time_elapsed(op, &optime);
+    for (size_t i = 0; i < LATENCY_NB_OPS; i++) {
+        if (latency_ops[i].tag == tag) {
+            latency_record(&latency_ops[i].latency[LATENCY_WAIT_TIME], &wtime);
+            latency_record(&latency_ops[i].latency[LATENCY_OP_TIME], &optime);
+            break;
+        }
+    }
+    slapi_pblock_get(pb, SLAPI_BACKEND, &be);
+    if (be) {
+        latency_record(be->be_latency, &optime);
+    }
+}
+
+static void
+latency_add_summary(Slapi_Entry *e, const char *prefix, const char *suffix, Slapi_Latency_Summary *summary)
+{
+    char type[64];
+    char value[32];
+    struct
+    {
+        const char *name;
+        uint64_t value;
+    } fields[] = {
+        {"Count", summary->count},
+        {"Avg", summary->avg},
+        {"P50", summary->p50},
+        {"P90", summary->p90},
+        {"P99", summary->p99},
+        {"P999", summary->p999},
+        {"Max", summary->max},
+    };
+
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        snprintf(type, sizeof(type), "%s%s%s", prefix, suffix, fields[i].name);
+        snprintf(value, sizeof(value), "%" PRIu64, fields[i].value);
+        slapi_entry_attr_set_charptr(e, type, value);
+    }
+}
+
+/*
+ * Adds a value describing a latency summary to a multi-valued
+ * attribute, e.g. backendOpTime: backend="userroot" count="12" ...
+ */
+void
+latency_merge_summary(Slapi_Entry *e, const char *type, const char *label, Slapi_Latency_Summary *summary)
+{
+    char buf[BUFSIZ];
+    struct berval val;
+    struct berval *vals[2] = {&val, NULL};
+
+    val.bv_len = snprintf(buf, sizeof(buf),
+                          "%s count=\"%" PRIu64 "\" avg=\"%" PRIu64 "\" p50=\"%" PRIu64 "\" p90=\"%" PRIu64
+                          "\" p99=\"%" PRIu64 "\" p999=\"%" PRIu64 "\" max=\"%" PRIu64 "\"",
+                          label, summary->count, summary->avg, summary->p50, summary->p90,
+                          summary->p99, summary->p999, summary->max);
+    val.bv_val = buf;
+    slapi_entry_attr_merge(e, type, vals);
+}
+
+/*
+ * cn=latency,cn=monitor: the latencies, in microseconds, since the
+ * previous read of the entry.
+ */
+void
+latency_as_entry(Slapi_Entry *e)
+{
+    Slapi_Latency_Summary summary;
+    Slapi_Backend *be;
+    char *cookie = NULL;
+    char label[BUFSIZ];
+
+    for (size_t i = 0; i < LATENCY_NB_OPS; i++) {
+        latency_read(&latency_ops[i].latency[LATENCY_WAIT_TIME], LATENCY_READER_MONITOR, &summary);
+        latency_add_summary(e, latency_ops[i].name, "WaitTime", &summary);
+        latency_read(&latency_ops[i].latency[LATENCY_OP_TIME], LATENCY_READER_MONITOR, &summary);
+        latency_add_summary(e, latency_ops[i].name, "OpTime", &summary);
+    }
+
+    slapi_entry_attr_delete(e, "backendOpTime");
+    be = slapi_get_first_backend(&cookie);
+    while (be) {
+        if (!be->be_private) {
+            latency_read(be->be_latency, LATENCY_READER_MONITOR, &summary);
+            snprintf(label, sizeof(label), "backend=\"%s\"", be->be_name);
+            latency_merge_summary(e, "backendOpTime", label, &summary);
+        }
+        be = slapi_get_next_backend(cookie);
+    }
+    slapi_ch_free((void **)&cookie);
+
+    slapi_entry_attr_delete(e, "pluginCallTime");
+    plugin_latency_as_entry(e, LATENCY_READER_MONITOR);
+}
+
+/* The operation latencies exported in cn=snmp,cn=monitor */
+void
+latency_snmp_as_entry(Slapi_Entry *e)
+{
+    Slapi_Latency_Summary summary;
+
+    for (size_t i = 0; i < LATENCY_NB_OPS; i++) {
+        latency_read(&latency_ops[i].latency[LATENCY_OP_TIME], LATENCY_READER_SNMP, &summary);
+        latency_add_summary(e, latency_ops[i].snmp_name, "OpTime", &summary);
+    }
+}
@@ -1022,6 +1022,10 @@ static struct config_get_and_set
      NULL, 0,
      (void **)&global_slapdFrontendConfig.num_listeners,
      CONFIG_INT, NULL, SLAPD_DEFAULT_NUM_LISTENERS_STR, NULL},
+    {CONFIG_EVENTQ_THREADS_ATTRIBUTE, config_set_eventq_threads,
+     NULL, 0,
+     (void **)&global_slapdFrontendConfig.eventq_threads,
+     CONFIG_INT, NULL, SLAPD_DEFAULT_EVENTQ_THREADS_STR, NULL},
     {CONFIG_MAXDESCRIPTORS_ATTRIBUTE, config_set_maxdescriptors,
      NULL, 0,
      (void **)&global_slapdFrontendConfig.maxdescriptors,
@@ -1457,6 +1461,10 @@ static struct config_get_and_set
      NULL, 0,
      (void **)&global_slapdFrontendConfig.tcp_keepalive_time, CONFIG_INT,
      (ConfigGetFunc)config_get_tcp_keepalive_time, SLAPD_DEFAULT_TCP_KEEPALIVE_TIME_STR, NULL},
+    {CONFIG_DSE_WRITE_DELAY, config_set_dse_write_delay,
+     NULL, 0,
+     (void **)&global_slapdFrontendConfig.dse_write_delay, CONFIG_INT,
+     (ConfigGetFunc)config_get_dse_write_delay, SLAPD_DEFAULT_DSE_WRITE_DELAY_STR, NULL},
     {CONFIG_REFERRAL_CHECK_PERIOD, config_set_referral_check_period,
      NULL, 0,
      (void **)&global_slapdFrontendConfig.referral_check_period,
@@ -1824,6 +1832,7 @@ FrontendConfig_init(void)
     cfg->snmp_index = SLAPD_DEFAULT_SNMP_INDEX;
     cfg->SSLclientAuth = SLAPD_DEFAULT_SSLCLIENTAUTH;
     cfg->num_listeners = SLAPD_DEFAULT_NUM_LISTENERS;
+    cfg->eventq_threads = SLAPD_DEFAULT_EVENTQ_THREADS;
     init_accesscontrol = cfg->accesscontrol = LDAP_ON;
 
     /* nagle triggers set/unset TCP_CORK setsockopt per operation
@@ -2044,6 +2053,7 @@ FrontendConfig_init(void)
 
     cfg->tcp_fin_timeout = SLAPD_DEFAULT_TCP_FIN_TIMEOUT;
     cfg->tcp_keepalive_time = SLAPD_DEFAULT_TCP_KEEPALIVE_TIME;
+    cfg->dse_write_delay = SLAPD_DEFAULT_DSE_WRITE_DELAY;
 
     /* Done, unlock!  */
     CFG_UNLOCK_WRITE(cfg);
@@ -5268,6 +5278,36 @@ config_set_num_listeners(const char *attrname, char *value, char *errorbuf, int
     return retVal;
 }
 
+/* The event queue executors are started once, changes apply at the next restart */
+int
+config_set_eventq_threads(const char *attrname, char *value, char *errorbuf, int apply)
+{
+    int retVal = LDAP_SUCCESS;
+    long nValue = 0;
+    char *endp = NULL;
+    slapdFrontendConfig_t *slapdFrontendConfig = getFrontendConfig();
+
+    if (config_value_is_null(attrname, value, errorbuf, 0)) {
+        return LDAP_OPERATIONS_ERROR;
+    }
+
+    errno = 0;
+    nValue = strtol(value, &endp, 10);
+    if (*endp != '\0' || errno == ERANGE || nValue < 1 || nValue > SLAPD_MAX_EVENTQ_THREADS) {
+        slapi_create_errormsg(errorbuf, SLAPI_DSE_RETURNTEXT_SIZE,
+                              "%s: invalid value \"%s\", it must range from 1 to %d.",
+                              attrname, value, SLAPD_MAX_EVENTQ_THREADS);
+        return LDAP_UNWILLING_TO_PERFORM;
+    }
+
+    if (apply) {
+        CFG_LOCK_WRITE(slapdFrontendConfig);
+        slapdFrontendConfig->eventq_threads = nValue;
+        CFG_UNLOCK_WRITE(slapdFrontendConfig);
+    }
+    return retVal;
+}
+
 int
 config_set_ioblocktimeout(const char *attrname, char *value, char *errorbuf, int apply)
 {
@@ -7292,6 +7332,19 @@ config_get_num_listeners(void)
     return retVal;
 }
 
+int
+config_get_eventq_threads(void)
+{
+    slapdFrontendConfig_t *slapdFrontendConfig = getFrontendConfig();
+    int retVal;
+
+    CFG_LOCK_READ(slapdFrontendConfig);
+    retVal = slapdFrontendConfig->eventq_threads;
+    CFG_UNLOCK_READ(slapdFrontendConfig);
+
+    return retVal;
+}
+
 /* return yes/no without actually copying the referral url
    we don't worry about another thread changing this value
    since we now return an integer */
@@ -9290,6 +9343,44 @@ config_get_tcp_keepalive_time()
     return retVal;
 }
 
+/*
+ * Maximum time (ms) a change to the dse files may wait before being
+ * written.  0 keeps the files written before the operation returns.
+ */
+int
+config_set_dse_write_delay(const char *attrname, char *value, char *errorbuf, int apply)
+{
+    slapdFrontendConfig_t *slapdFrontendConfig = getFrontendConfig();
+    long dse_write_delay;
+    char *endp;
+
+    if (config_value_is_null(attrname, value, errorbuf, 0)) {
+        return LDAP_OPERATIONS_ERROR;
+    }
+
+    errno = 0;
+    dse_write_delay = strtol(value, &endp, 10);
+    if (*endp != '\0' || errno == ERANGE || dse_write_delay < 0 || dse_write_delay > SLAPD_MAX_DSE_WRITE_DELAY) {
+        slapi_create_errormsg(errorbuf, SLAPI_DSE_RETURNTEXT_SIZE,
+                              "%s: invalid value \"%s\", it must range from 0 to %d.",
+                              attrname, value, SLAPD_MAX_DSE_WRITE_DELAY);
+        return LDAP_OPERATIONS_ERROR;
+    }
+
+    if (apply) {
+        slapi_atomic_store_32(&(slapdFrontendConfig->dse_write_delay), dse_write_delay, __ATOMIC_RELEASE);
+    }
+    return LDAP_SUCCESS;
+}
+
+int
+config_get_dse_write_delay()
+{
+    slapdFrontendConfig_t *slapdFrontendConfig = getFrontendConfig();
+
+    return slapi_atomic_load_32(&(slapdFrontendConfig->dse_write_delay), __ATOMIC_ACQUIRE);
+}
+
 /*
  * This function is intended to be used from the dse code modify callback.  It
  * is "optimized" for that case because it takes a berval** of values, which is
@@ -53,52 +53,52 @@ monitor_info(Slapi_PBlock *pb __attribute__((unused)),
     /* "version" value */
     val.bv_val = slapd_get_version_value();
     val.bv_len = strlen(val.bv_val);
-    attrlist_replace(&e->e_attrs, "version", vals);
+    entry_replace_values(e, "version", vals);
     slapi_ch_free((void **)&val.bv_val);
 
     val.bv_len = snprintf(buf, sizeof(buf), "%" PRIu64, g_get_active_threadcnt());
     val.bv_val = buf;
-    attrlist_replace(&e->e_attrs, "threads", vals);
+    entry_replace_values(e, "threads", vals);
 
     connection_table_as_entry(the_connection_table, e);
 
     val.bv_len = snprintf(buf, sizeof(buf), "%" PRIu64, g_get_num_ops_initiated());
     val.bv_val = buf;
-    attrlist_replace(&e->e_attrs, "opsinitiated", vals);
+    entry_replace_values(e, "opsinitiated", vals);
 
     val.bv_len = snprintf(buf, sizeof(buf), "%" PRIu64, g_get_num_ops_completed());
     val.bv_val = buf;
-    attrlist_replace(&e->e_attrs, "opscompleted", vals);
+    entry_replace_values(e, "opscompleted", vals);
 
     val.bv_len = snprintf(buf, sizeof(buf), "%" PRIu64, g_get_num_entries_sent());
     val.bv_val = buf;
-    attrlist_replace(&e->e_attrs, "entriessent", vals);
+    entry_replace_values(e, "entriessent", vals);
 
     val.bv_len = snprintf(buf, sizeof(buf), "%" PRIu64, g_get_num_bytes_sent());
     val.bv_val = buf;
-    attrlist_replace(&e->e_attrs, "bytessent", vals);
+    entry_replace_values(e, "bytessent", vals);
 
     gmtime_r(&curtime, &utm);
     strftime(buf, sizeof(buf), "%Y%m%d%H%M%SZ", &utm);
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "currenttime", vals);
+    entry_replace_values(e, "currenttime", vals);
 
     gmtime_r(&starttime, &utm);
     strftime(buf, sizeof(buf), "%Y%m%d%H%M%SZ", &utm);
     val.bv_val = buf;
     val.bv_len = strlen(buf);
-    attrlist_replace(&e->e_attrs, "starttime", vals);
+    entry_replace_values(e, "starttime", vals);
 
     val.bv_len = snprintf(buf, sizeof(buf), "%d", be_nbackends_public());
     val.bv_val = buf;
-    attrlist_replace(&e->e_attrs, "nbackends", vals);
+    entry_replace_values(e, "nbackends", vals);
 
     /*
      * Loop through the backends, and stuff the monitor dn's
      * into the entry we're sending back
      */
-    attrlist_delete(&e->e_attrs, "backendmonitordn");
+    slapi_entry_attr_delete(e, "backendmonitordn");
     cookie = NULL;
     be = slapi_get_first_backend(&cookie);
     while (be) {
@@ -108,7 +108,7 @@ monitor_info(Slapi_PBlock *pb __attribute__((unused)),
             be_getmonitordn(be, &dn);
             val.bv_val = (char *)slapi_sdn_get_dn(&dn);
             val.bv_len = strlen(val.bv_val);
-            attrlist_merge(&e->e_attrs, "backendmonitordn", vals);
+            slapi_entry_attr_merge(e, "backendmonitordn", vals);
             slapi_sdn_done(&dn);
         }
         be = slapi_get_next_backend(cookie);
@@ -150,7 +150,7 @@ monitor_disk_info (Slapi_PBlock *pb __attribute__((unused)),
                     "partition=\"%s\" size=\"%" PRIu64 "\" used=\"%" PRIu64 "\" available=\"%" PRIu64 "\" use%%=\"%" PRIu64 "\"",
                     dirs[i], total_space, used_space, avail_space, used_space * 100 / total_space);
             val.bv_val = buf;
-            attrlist_merge(&e->e_attrs, "dsDisk", vals);
+            slapi_entry_attr_merge(e, "dsDisk", vals);
         }
     }
     slapi_ch_array_free(dirs);
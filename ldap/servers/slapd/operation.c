@@ -224,6 +224,14 @@ operation_done(Slapi_Operation **op, Connection *conn)
         }
         slapi_ch_free_string(&(*op)->o_results.result_matched);
         slapi_ch_free_string(&(*op)->o_results.result_text);
+        charray_free((*op)->o_apply_keys);
+        (*op)->o_apply_keys = NULL;
+        charray_free((*op)->o_apply_deps);
+        (*op)->o_apply_deps = NULL;
+        if ((*op)->o_apply_result) {
+            ber_free((*op)->o_apply_result, 1);
+            (*op)->o_apply_result = NULL;
+        }
         int options = 0;
         /* save the old options */
         if ((*op)->o_ber) {
@@ -592,6 +600,55 @@ slapi_connection_acquire(Slapi_Connection *conn)
     return (rc);
 }
 
+/*
+ * Releases a reference taken with slapi_connection_acquire. The connection
+ * is not cleaned up, nor its slot reused, while a reference is held.
+ */
+int
+slapi_connection_release(Slapi_Connection *conn)
+{
+    int rc;
+
+    pthread_mutex_lock(&(conn->c_mutex));
+    /* rc = connection_release_nolock(conn); */
+    if (conn->c_refcnt <= 0) {
+        slapi_log_err(SLAPI_LOG_ERR, "slapi_connection_release",
+                      "conn=%" PRIu64 " fd=%d Attempt to release connection that is not acquired\n",
+                      conn->c_connid, conn->c_sd);
+        rc = -1;
+    } else {
+        conn->c_refcnt--;
+        rc = 0;
+    }
+    pthread_mutex_unlock(&(conn->c_mutex));
+    return (rc);
+}
+
+/*
+ * Returns non zero if the connection can take more data without waiting
+ * for the client to read, so that a thread sending unsolicited results
+ * can serve other clients meanwhile.  A closing connection is "writable":
+ * the send fails at once.
+ */
+int
+slapi_connection_is_writable(Slapi_Connection *conn)
+{
+    PRPollDesc pr_pd;
+    int rc = 1;
+
+    pthread_mutex_lock(&(conn->c_mutex));
+    if (!(conn->c_flags & CONN_FLAG_CLOSING) && conn->c_prfd != NULL) {
+        pr_pd.fd = conn->c_prfd;
+        pr_pd.in_flags = PR_POLL_WRITE;
+        pr_pd.out_flags = 0;
+        if (PR_Poll(&pr_pd, 1, PR_INTERVAL_NO_WAIT) == 0) {
+            rc = 0;
+        }
+    }
+    pthread_mutex_unlock(&(conn->c_mutex));
+    return (rc);
+}
+
 int
 slapi_connection_remove_operation(Slapi_PBlock *pb __attribute__((unused)), Slapi_Connection *conn, Slapi_Operation *op, int release)
 {
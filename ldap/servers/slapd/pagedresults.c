@@ -586,6 +586,61 @@ pagedresults_set_search_result_set_size_estimate(Connection *conn,
     return rc;
 }
 
+/*
+ * The backend reports the memory held by the search result set between
+ * two pages, and the part of it spilled to disk, for the connection monitor.
+ */
+int
+pagedresults_set_search_result_mem(Connection *conn, Operation *op, size_t mem, size_t spilled, int index)
+{
+    int rc = -1;
+    if (!op_is_pagedresults(op)) {
+        return rc; /* noop */
+    }
+    slapi_log_err(SLAPI_LOG_TRACE,
+                  "pagedresults_set_search_result_mem", "=> idx=%d\n", index);
+    if (conn && (index > -1)) {
+        pthread_mutex_lock(pageresult_lock_get_addr(conn));
+        if (index < conn->c_pagedresults.prl_maxlen) {
+            conn->c_pagedresults.prl_list[index].pr_search_result_mem = mem;
+            conn->c_pagedresults.prl_list[index].pr_search_result_spilled = spilled;
+        }
+        pthread_mutex_unlock(pageresult_lock_get_addr(conn));
+        rc = 0;
+    }
+    slapi_log_err(SLAPI_LOG_TRACE,
+                  "pagedresults_set_search_result_mem", "<= %d\n", rc);
+    return rc;
+}
+
+/*
+ * Sums the memory held by the paged searches in progress on the
+ * connection. Returns the number of paged searches in progress.
+ * Must not be called with c_mutex held.
+ */
+int
+pagedresults_get_mem_usage(Connection *conn, size_t *mem, size_t *spilled)
+{
+    int count = 0;
+
+    *mem = 0;
+    *spilled = 0;
+    if (NULL == conn) {
+        return count;
+    }
+    pthread_mutex_lock(pageresult_lock_get_addr(conn));
+    for (int i = 0; conn->c_pagedresults.prl_list && i < conn->c_pagedresults.prl_maxlen; i++) {
+        PagedResults *prp = conn->c_pagedresults.prl_list + i;
+        if (prp->pr_search_result_set) {
+            *mem += prp->pr_search_result_mem;
+            *spilled += prp->pr_search_result_spilled;
+            count++;
+        }
+    }
+    pthread_mutex_unlock(pageresult_lock_get_addr(conn));
+    return count;
+}
+
 int
 pagedresults_get_with_sort(Connection *conn, Operation *op, int index)
 {
@@ -1946,6 +1946,80 @@ plugin_call_one(struct slapdplugin *list, int operation, Slapi_PBlock *pb)
 }
 
 
+/* Pre and post operation callbacks, whose call times are recorded */
+static int
+plugin_is_op_callback(int type)
+{
+    switch (type) {
+    case SLAPI_PLUGIN_PREOPERATION:
+    case SLAPI_PLUGIN_POSTOPERATION:
+    case SLAPI_PLUGIN_BEPREOPERATION:
+    case SLAPI_PLUGIN_BEPOSTOPERATION:
+    case SLAPI_PLUGIN_BETXNPREOPERATION:
+    case SLAPI_PLUGIN_BETXNPOSTOPERATION:
+    case SLAPI_PLUGIN_INTERNAL_PREOPERATION:
+    case SLAPI_PLUGIN_INTERNAL_POSTOPERATION:
+    case SLAPI_PLUGIN_PREEXTOPERATION:
+    case SLAPI_PLUGIN_POSTEXTOPERATION:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static Slapi_Latency *
+plugin_get_latency(struct slapdplugin *plugin)
+{
+    Slapi_Latency *latency = __atomic_load_n(&plugin->plg_latency, __ATOMIC_ACQUIRE);
+
+    if (latency == NULL) {
+        Slapi_Latency *new_latency = latency_new();
+        if (__atomic_compare_exchange_n(&plugin->plg_latency, &latency, new_latency, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            latency = new_latency;
+        } else {
+            latency_free(&new_latency);
+        }
+    }
+    return latency;
+}
+
+static void
+plugin_record_latency(struct slapdplugin *plugin, struct timespec *start)
+{
+    struct timespec now;
+    struct timespec elapsed;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    slapi_timespec_diff(&now, start, &elapsed);
+    latency_record(plugin_get_latency(plugin), &elapsed);
+}
+
+/*
+ * cn=latency,cn=monitor: call times of the pre/post operation
+ * callbacks, for the plugins that were called since the startup
+ */
+void
+plugin_latency_as_entry(Slapi_Entry *e, int reader)
+{
+    Slapi_Latency_Summary summary;
+    char label[BUFSIZ];
+
+    slapi_rwlock_rdlock(global_rwlock);
+    for (int type = 0; type < PLUGIN_LIST_GLOBAL_MAX; type++) {
+        for (struct slapdplugin *plugin = global_plugin_list[type]; plugin; plugin = plugin->plg_next) {
+            Slapi_Latency *latency = __atomic_load_n(&plugin->plg_latency, __ATOMIC_ACQUIRE);
+            if (latency) {
+                latency_read(latency, reader, &summary);
+                snprintf(label, sizeof(label), "plugin=\"%s\" type=\"%s\"",
+                         plugin->plg_name, plugin_get_type_str(plugin->plg_type));
+                latency_merge_summary(e, "pluginCallTime", label, &summary);
+            }
+        }
+    }
+    slapi_rwlock_unlock(global_rwlock);
+}
+
 /*
  * Return codes:
  * - For preoperation plugins, returns the return code passed back from the first
@@ -1973,6 +2047,9 @@ plugin_call_func(struct slapdplugin *list, int operation, Slapi_PBlock *pb, int
             plugin_invoke_plugin_pb(list, operation, pb) &&
             list->plg_closed == 0) {
             char *n = list->plg_name;
+            /* Pre/post operation callbacks are only called once the plugin is started */
+            int timed = list->plg_started && plugin_is_op_callback(list->plg_type);
+            struct timespec start;
 
             slapi_log_err(SLAPI_LOG_TRACE, "plugin_call_func",
                           "Calling plugin '%s' #%d type %d\n",
@@ -1990,11 +2067,17 @@ plugin_call_func(struct slapdplugin *list, int operation, Slapi_PBlock *pb, int
              *  calling the START and CLOSE functions - prevents double starts and stops.
              */
             slapi_plugin_op_started(list);
+            if (timed) {
+                clock_gettime(CLOCK_MONOTONIC, &start);
+            }
             if (((SLAPI_PLUGIN_START_FN == operation && !list->plg_started) || /* Starting it up for the first time */
                  (SLAPI_PLUGIN_CLOSE_FN == operation && !list->plg_stopped) || /* Shutting down, plugin has been stopped */
                  (SLAPI_PLUGIN_START_FN != operation && list->plg_started)) && /* Started, and not trying to start again */
                 (rc = func(pb)) != 0) {
                 slapi_plugin_op_finished(list);
+                if (timed) {
+                    plugin_record_latency(list, &start);
+                }
                 if (SLAPI_PLUGIN_PREOPERATION == list->plg_type ||
                     SLAPI_PLUGIN_INTERNAL_PREOPERATION == list->plg_type ||
                     SLAPI_PLUGIN_PREEXTOPERATION == list->plg_type ||
@@ -2029,6 +2112,9 @@ plugin_call_func(struct slapdplugin *list, int operation, Slapi_PBlock *pb, int
                     list->plg_stopped = 1;
                 }
                 slapi_plugin_op_finished(list);
+                if (timed) {
+                    plugin_record_latency(list, &start);
+                }
             }
             /* counters_to_errors_log("after plugin call"); */
         }
@@ -2672,6 +2758,7 @@ plugin_free(struct slapdplugin *plugin)
     }
     release_componentid(plugin->plg_identity);
     slapi_counter_destroy(&plugin->plg_op_counter);
+    latency_free(&plugin->plg_latency);
     if (!plugin->plg_group) {
         plugin_config_cleanup(&plugin->plg_conf);
     }
@@ -357,6 +357,7 @@ int config_set_return_exact_case(const char *attrname, char *value, char *errorb
 int config_set_result_tweak(const char *attrname, char *value, char *errorbuf, int apply);
 int config_set_referral_mode(const char *attrname, char *url, char *errorbuf, int apply);
 int config_set_num_listeners(const char *attrname, char *value, char *errorbuf, int apply);
+int config_set_eventq_threads(const char *attrname, char *value, char *errorbuf, int apply);
 int config_set_maxbersize(const char *attrname, char *value, char *errorbuf, int apply);
 int config_set_maxsasliosize(const char *attrname, char *value, char *errorbuf, int apply);
 int config_set_versionstring(const char *attrname, char *versionstring, char *errorbuf, int apply);
@@ -535,6 +536,7 @@ int config_get_errorlog_log_format(void);
 char *config_get_errorlog_time_format(void);
 char *config_get_referral_mode(void);
 int config_get_num_listeners(void);
+int config_get_eventq_threads(void);
 int config_check_referral_mode(void);
 ber_len_t config_get_maxbersize(void);
 int32_t config_get_maxsasliosize(void);
@@ -654,6 +656,8 @@ int config_set_tcp_fin_timeout(const char *attrname, char *value, char *errorbuf
 int config_get_tcp_fin_timeout(void);
 int config_set_tcp_keepalive_time(const char *attrname, char *value, char *errorbuf, int apply);
 int config_get_tcp_keepalive_time(void);
+int config_set_dse_write_delay(const char *attrname, char *value, char *errorbuf, int apply);
+int config_get_dse_write_delay(void);
 
 int is_abspath(const char *);
 char *rel2abspath(char *);
@@ -781,6 +785,7 @@ struct dse_callback *dse_register_callback(struct dse *pdse, int operation, int
 void dse_remove_callback(struct dse *pdse, int operation, int flags, const Slapi_DN *base, int scope, const char *filter, dseCallbackFn fn);
 void dse_set_dont_ever_write_dse_files(void);
 void dse_unset_dont_ever_write_dse_files(void);
+void dse_flush_all(void);
 int dse_next_search_entry(Slapi_PBlock *pb);
 char *dse_read_next_entry(char *buf, char **lastp);
 void dse_search_set_release(void **ss);
@@ -994,6 +999,7 @@ int plugin_call_exop_plugins(Slapi_PBlock *pb, struct slapdplugin *p);
 Slapi_Backend *plugin_extended_op_getbackend(Slapi_PBlock *pb, struct slapdplugin *p);
 const char *plugin_extended_op_oid2string(const char *oid);
 void plugin_closeall(int close_backends, int close_globals);
+void plugin_latency_as_entry(Slapi_Entry *e, int reader);
 void plugin_dependency_freeall(void);
 void plugin_startall(int argc, char **argv, char **plugin_list);
 void plugin_get_plugin_dependencies(char *plugin_name, char ***names);
@@ -1107,6 +1113,7 @@ int send_ldap_search_entry(Slapi_PBlock *pb, Slapi_Entry *e, LDAPControl **ectrl
 void send_ldap_result(Slapi_PBlock *pb, int err, char *matched, char *text, int nentries, struct berval **urls);
 int send_ldap_search_entry_ext(Slapi_PBlock *pb, Slapi_Entry *e, LDAPControl **ectrls, char **attrs, int attrsonly, int send_result, int nentries, struct berval **urls);
 void send_ldap_result_ext(Slapi_PBlock *pb, int err, char *matched, char *text, int nentries, struct berval **urls, BerElement *ber);
+void send_held_result(Connection *conn, Operation *op);
 int send_ldap_intermediate(Slapi_PBlock *pb, LDAPControl **ectrls, char *responseName, struct berval *responseValue);
 void send_nobackend_ldap_result(Slapi_PBlock *pb);
 int send_ldap_referral(Slapi_PBlock *pb, Slapi_Entry *e, struct berval **refs, struct berval ***urls);
@@ -1413,6 +1420,8 @@ void auditfaillog_expose_unhashed_pw(void);
 void eq_init_rel(void);
 void eq_start_rel(void);
 void eq_stop_rel(void);
+void eq_set_clock_rel(uint64_t (*clock)(void));
+uint64_t eq_run_expired_rel(void);
 /* Deprecated eventq that uses REALTIME clock instead of MONOTONIC */
 void eq_init(void);
 void eq_start(void);
@@ -1518,6 +1527,18 @@ void counters_to_errors_log(const char *text);
  */
 void snmp_as_entry(Slapi_Entry *e);
 
+/*
+ * latency.c
+ */
+Slapi_Latency *latency_new(void);
+void latency_free(Slapi_Latency **latency);
+void latency_record(Slapi_Latency *latency, const struct timespec *elapsed);
+void latency_read(Slapi_Latency *latency, int reader, Slapi_Latency_Summary *summary);
+void latency_record_op(Slapi_PBlock *pb, Slapi_Operation *op);
+void latency_merge_summary(Slapi_Entry *e, const char *type, const char *label, Slapi_Latency_Summary *summary);
+void latency_as_entry(Slapi_Entry *e);
+void latency_snmp_as_entry(Slapi_Entry *e);
+
 /*
  * subentry.c
  */
@@ -1621,6 +1642,8 @@ int pagedresults_set_search_result_set_size_estimate(Connection *conn,
                                                      Operation *op,
                                                      int cnt,
                                                      int index);
+int pagedresults_set_search_result_mem(Connection *conn, Operation *op, size_t mem, size_t spilled, int index);
+int pagedresults_get_mem_usage(Connection *conn, size_t *mem, size_t *spilled);
 int pagedresults_get_with_sort(Connection *conn, Operation *op, int index);
 int pagedresults_set_with_sort(Connection *conn, Operation *op, int flags, int index);
 int pagedresults_get_unindexed(Connection *conn, Operation *op, int index);
@@ -25,6 +25,7 @@
 #include "slap.h"
 #include "pratom.h"
 #include "fe.h"
+#include "slapd-probes.h"
 #include "vattr_spi.h"
 #include "slapi-plugin.h"
 #include <ssl.h>
@@ -699,6 +700,10 @@ send_ldap_result_ext(
 log_and_return:
     operation->o_status = SLAPI_OP_STATUS_RESULT_SENT; /* in case this has not yet been set */
 
+    if (logit && !internal_op) {
+        latency_record_op(pb, operation);
+    }
+
     if (logit && (operation_is_flag_set(operation, OP_FLAG_ACTION_LOG_ACCESS) ||
                   (internal_op && config_get_plugin_logging()))) {
         log_result(pb, operation, err, tag, nentries);
@@ -1564,6 +1569,7 @@ send_ldap_search_entry_ext(
 
     slapi_log_err(SLAPI_LOG_TRACE, "send_ldap_search_entry_ext", "=> (%s)\n",
                   e ? slapi_entry_get_dn_const(e) : "null");
+    SLAPD_PROBE2(search__entry__send__entry, operation->o_connid, operation->o_opid);
 
     /* set current entry */
     slapi_pblock_set(pb, SLAPI_SEARCH_ENTRY_ORIG, e);
@@ -1809,42 +1815,22 @@ cleanup:
     }
     ber_free(ber, 1);
     slapi_log_err(SLAPI_LOG_TRACE, "send_ldap_search_entry_ext", "<= %d\n", rc);
+    SLAPD_PROBE3(search__entry__send__return, operation->o_connid, operation->o_opid, rc);
 
     return (rc);
 }
 
 
 /*
- * always frees the ber
+ * Writes the ber to the connection, and frees it
  */
 static int
-flush_ber(
-    Slapi_PBlock *pb,
-    Connection *conn,
-    Operation *op,
-    BerElement *ber,
-    int type)
+write_ber(Connection *conn, Operation *op, BerElement *ber, int type)
 {
     ber_len_t bytes;
     int rc = 0;
 
-    switch (type) {
-    case _LDAP_SEND_RESULT:
-        rc = plugin_call_plugins(pb, SLAPI_PLUGIN_PRE_RESULT_FN);
-        break;
-    case _LDAP_SEND_REFERRAL:
-        rc = plugin_call_plugins(pb, SLAPI_PLUGIN_PRE_REFERRAL_FN);
-        break;
-    case _LDAP_SEND_INTERMED:
-        break; /* not a plugin entry point */
-    }
-
-    if (rc != 0) {
-        ber_free(ber, 1);
-        return (rc);
-    }
-
-    if ((conn->c_flags & CONN_FLAG_CLOSING) || slapi_op_abandoned(pb)) {
+    if ((conn->c_flags & CONN_FLAG_CLOSING) || slapi_is_operation_abandoned(op)) {
         slapi_log_err(SLAPI_LOG_CONNS, "flush_ber",
                       "Skipped because the connection was marked to be closed or abandoned\n");
         ber_free(ber, 1);
@@ -1891,6 +1877,64 @@ flush_ber(
                 slapi_counter_add(g_get_per_thread_snmp_vars()->ops_tbl.dsBytesSent, bytes);
         }
     }
+    return (rc);
+}
+
+/*
+ * Sends the result of an update applied in parallel, held by flush_ber
+ * until the previous operations of the connection sent theirs.
+ */
+void
+send_held_result(Connection *conn, Operation *op)
+{
+    BerElement *ber = op->o_apply_result;
+
+    if (ber) {
+        op->o_apply_result = NULL;
+        write_ber(conn, op, ber, _LDAP_SEND_RESULT);
+    }
+}
+
+/*
+ * always frees the ber
+ */
+static int
+flush_ber(
+    Slapi_PBlock *pb,
+    Connection *conn,
+    Operation *op,
+    BerElement *ber,
+    int type)
+{
+    int rc = 0;
+
+    switch (type) {
+    case _LDAP_SEND_RESULT:
+        rc = plugin_call_plugins(pb, SLAPI_PLUGIN_PRE_RESULT_FN);
+        break;
+    case _LDAP_SEND_REFERRAL:
+        rc = plugin_call_plugins(pb, SLAPI_PLUGIN_PRE_REFERRAL_FN);
+        break;
+    case _LDAP_SEND_INTERMED:
+        break; /* not a plugin entry point */
+    }
+
+    if (rc != 0) {
+        ber_free(ber, 1);
+        return (rc);
+    }
+
+    if (op->o_apply_state > OP_APPLY_NONE && op->o_apply_state < OP_APPLY_BARRIER &&
+        type == _LDAP_SEND_RESULT && op->o_apply_result == NULL) {
+        /*
+         * An update applied in parallel: the supplier expects the results
+         * in the order it sent the updates, the result is sent once the
+         * previous operations of the connection sent theirs.
+         */
+        op->o_apply_result = ber;
+    } else {
+        rc = write_ber(conn, op, ber, type);
+    }
 
     switch (type) {
     case _LDAP_SEND_RESULT:
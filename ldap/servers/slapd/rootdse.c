@@ -122,23 +122,23 @@ read_root_dse(Slapi_PBlock *pb,
     vals[1] = NULL;
 
     /* loop through backend suffixes to get namingcontexts attr */
-    attrlist_delete(&e->e_attrs, "namingcontexts");
+    slapi_entry_attr_delete(e, "namingcontexts");
 
     sdn = slapi_get_first_suffix(&node, 0);
     while (sdn) {
         val.bv_val = (char *)slapi_sdn_get_dn(sdn); /* jcm: had to cast away const */
         val.bv_len = strlen(val.bv_val);
-        attrlist_merge(&e->e_attrs, "namingcontexts", vals);
+        slapi_entry_attr_merge(e, "namingcontexts", vals);
         sdn = slapi_get_next_suffix(&node, 0);
     }
 
     val.bv_val = config_get_default_naming_context();
     if (val.bv_val) {
         val.bv_len = strlen(val.bv_val);
-        attrlist_replace(&e->e_attrs, "defaultnamingcontext", vals);
+        entry_replace_values(e, "defaultnamingcontext", vals);
     }
 
-    attrlist_delete(&e->e_attrs, "nsBackendSuffix");
+    slapi_entry_attr_delete(e, "nsBackendSuffix");
     for (be = slapi_get_first_backend(&cookie); be != NULL;
          be = slapi_get_next_backend(cookie)) {
 
@@ -161,7 +161,7 @@ read_root_dse(Slapi_PBlock *pb,
         val.bv_len = strlen(base) + strlen(be_name) + 1;
         val.bv_val = slapi_ch_malloc(val.bv_len + 1);
         sprintf(val.bv_val, "%s:%s", be_name, base);
-        attrlist_merge(&e->e_attrs, "nsBackendSuffix", vals);
+        slapi_entry_attr_merge(e, "nsBackendSuffix", vals);
         slapi_ch_free((void **)&val.bv_val);
     }
     slapi_ch_free((void **)&cookie);
@@ -169,59 +169,59 @@ read_root_dse(Slapi_PBlock *pb,
     /* schema entry */
     val.bv_val = SLAPD_SCHEMA_DN;
     val.bv_len = sizeof(SLAPD_SCHEMA_DN) - 1;
-    attrlist_replace(&e->e_attrs, "subschemasubentry", vals);
+    entry_replace_values(e, "subschemasubentry", vals);
 
     /* supported extended operations */
-    attrlist_delete(&e->e_attrs, "supportedExtension");
+    slapi_entry_attr_delete(e, "supportedExtension");
     if ((strs = slapi_get_supported_extended_ops_copy()) != NULL) {
         for (i = 0; strs[i] != NULL; ++i) {
             val.bv_val = strs[i];
             val.bv_len = strlen(strs[i]);
-            attrlist_merge(&e->e_attrs, "supportedExtension", vals);
+            slapi_entry_attr_merge(e, "supportedExtension", vals);
         }
         charray_free(strs);
     }
 
     /* supported controls */
-    attrlist_delete(&e->e_attrs, "supportedControl");
+    slapi_entry_attr_delete(e, "supportedControl");
     if (slapi_get_supported_controls_copy(&strs, NULL) == 0 && strs != NULL) {
         for (i = 0; strs[i] != NULL; ++i) {
             val.bv_val = strs[i];
             val.bv_len = strlen(strs[i]);
-            attrlist_merge(&e->e_attrs, "supportedControl", vals);
+            slapi_entry_attr_merge(e, "supportedControl", vals);
         }
         charray_free(strs);
     }
 
     /* supported features */
-    attrlist_delete(&e->e_attrs, "supportedFeatures");
+    slapi_entry_attr_delete(e, "supportedFeatures");
     if (slapi_get_supported_features_copy(&strs) == 0 && strs != NULL) {
         for (i = 0; strs[i] != NULL; ++i) {
             val.bv_val = strs[i];
             val.bv_len = strlen(strs[i]);
-            attrlist_merge(&e->e_attrs, "supportedFeatures", vals);
+            slapi_entry_attr_merge(e, "supportedFeatures", vals);
         }
         charray_free(strs);
     }
 
     /* supported/accepted sasl mechanisms */
-    attrlist_delete(&e->e_attrs, "supportedSASLMechanisms");
+    slapi_entry_attr_delete(e, "supportedSASLMechanisms");
     if ((strs = ids_sasl_listmech(pb, PR_FALSE)) != NULL) {
         for (i = 0; strs[i] != NULL; ++i) {
             val.bv_val = strs[i];
             val.bv_len = strlen(strs[i]);
-            attrlist_merge(&e->e_attrs, "supportedSASLMechanisms", vals);
+            slapi_entry_attr_merge(e, "supportedSASLMechanisms", vals);
         }
         charray_free(strs);
     }
 
     /* available SASL mechs */
-    attrlist_delete(&e->e_attrs, "availableSASLMechanisms");
+    slapi_entry_attr_delete(e, "availableSASLMechanisms");
     if ((strs = ids_sasl_listmech(pb, PR_TRUE)) != NULL) {
         for (i = 0; strs[i] != NULL; ++i) {
             val.bv_val = strs[i];
             val.bv_len = strlen(strs[i]);
-            attrlist_merge(&e->e_attrs, "availableSASLMechanisms", vals);
+            slapi_entry_attr_merge(e, "availableSASLMechanisms", vals);
         }
         charray_free(strs);
     }
@@ -229,34 +229,34 @@ read_root_dse(Slapi_PBlock *pb,
     /* supported LDAP versions */
     val.bv_val = "2";
     val.bv_len = 1;
-    attrlist_replace(&e->e_attrs, "supportedldapversion", vals);
+    entry_replace_values(e, "supportedldapversion", vals);
     val.bv_val = "3";
     val.bv_len = 1;
-    attrlist_merge(&e->e_attrs, "supportedldapversion", vals);
+    slapi_entry_attr_merge(e, "supportedldapversion", vals);
 
     /* superior references (ref attribute) */
-    attrlist_delete(&e->e_attrs, "ref");
+    slapi_entry_attr_delete(e, "ref");
     if ((bvals = g_get_default_referral()) != NULL) {
         for (i = 0; bvals[i] != NULL; ++i) {
             val.bv_val = bvals[i]->bv_val;
             val.bv_len = bvals[i]->bv_len;
-            attrlist_merge(&e->e_attrs, "ref", vals);
+            slapi_entry_attr_merge(e, "ref", vals);
         }
     }
 
     /* RFC 3045 attributes: vendorName and vendorVersion */
     val.bv_val = SLAPD_VENDOR_NAME;
     val.bv_len = strlen(val.bv_val);
-    attrlist_replace(&e->e_attrs, "vendorName", vals);
+    entry_replace_values(e, "vendorName", vals);
     val.bv_val = slapd_get_version_value();
     val.bv_len = strlen(val.bv_val);
-    attrlist_replace(&e->e_attrs, "vendorVersion", vals);
+    entry_replace_values(e, "vendorVersion", vals);
     slapi_ch_free((void **)&val.bv_val);
 
     /* Server Data Version */
     if ((val.bv_val = (char *)get_server_dataversion()) != NULL) { /* jcm cast away const */
         val.bv_len = strlen(val.bv_val);
-        attrlist_replace(&e->e_attrs, attr_dataversion, vals);
+        entry_replace_values(e, attr_dataversion, vals);
     }
 
     /* machine data suffix
@@ -267,7 +267,7 @@ read_root_dse(Slapi_PBlock *pb,
      */
     if ((val.bv_val = get_config_DN()) != NULL) {
         val.bv_len = strlen(val.bv_val);
-        attrlist_replace(&e->e_attrs, ATTR_NETSCAPEMDSUFFIX, vals);
+        entry_replace_values(e, ATTR_NETSCAPEMDSUFFIX, vals);
     }
 
 #ifdef notdef
@@ -278,13 +278,13 @@ read_root_dse(Slapi_PBlock *pb,
         sprintf(buf, "%u", clsize);
         val.bv_val = buf;
         val.bv_len = strlen(buf);
-        attrlist_replace(&e->e_attrs, "changelogsize", vals);
+        entry_replace_values(e, "changelogsize", vals);
         slapi_ch_free((void **)&val.bv_val);
     }
 #endif /* notdef */
 
     /* vlvsearch is list of dns to VLV Search Specifications */
-    attrlist_delete(&e->e_attrs, "vlvsearch");
+    slapi_entry_attr_delete(e, "vlvsearch");
     cookie = NULL;
     be = slapi_get_first_backend(&cookie);
     while (be) {
@@ -304,7 +304,7 @@ read_root_dse(Slapi_PBlock *pb,
                 for (; *entry; ++entry) {
                     val.bv_val = slapi_entry_get_dn(*entry);
                     val.bv_len = strlen(val.bv_val);
-                    attrlist_merge(&e->e_attrs, "vlvsearch", vals);
+                    slapi_entry_attr_merge(e, "vlvsearch", vals);
                 }
             }
             slapi_free_search_results_internal(resultpb);
@@ -1702,10 +1702,10 @@ read_schema_dse(
     slapi_pblock_get(pb, SLAPI_SCHEMA_FLAGS, (void *)&schema_flags);
     user_defined_only = (schema_flags & DSE_SCHEMA_USER_DEFINED_ONLY) ? 1 : 0;
 
-    attrlist_delete(&pschema_info_e->e_attrs, "objectclasses");
-    attrlist_delete(&pschema_info_e->e_attrs, "attributetypes");
-    attrlist_delete(&pschema_info_e->e_attrs, "matchingRules");
-    attrlist_delete(&pschema_info_e->e_attrs, "ldapSyntaxes");
+    slapi_entry_attr_delete(pschema_info_e, "objectclasses");
+    slapi_entry_attr_delete(pschema_info_e, "attributetypes");
+    slapi_entry_attr_delete(pschema_info_e, "matchingRules");
+    slapi_entry_attr_delete(pschema_info_e, "ldapSyntaxes");
     /*
      * attrlist_delete (&pschema_info_e->e_attrs, "matchingRuleUse");
      */
@@ -1800,12 +1800,13 @@ read_schema_dse(
         strcat(psbObjectClasses->buffer, ")");
         val.bv_val = psbObjectClasses->buffer;
         val.bv_len = strlen(psbObjectClasses->buffer);
-        attrlist_merge(&pschema_info_e->e_attrs, "objectclasses", vals);
+        slapi_entry_attr_merge(pschema_info_e, "objectclasses", vals);
     }
 
     oc_unlock();
 
     /* now return the attrs */
+    entry_attrs_changed(pschema_info_e);
     aew.attrs = &pschema_info_e->e_attrs;
     aew.enquote_sup_oc = enquote_sup_oc;
     aew.psbAttrTypes = psbAttrTypes;
@@ -1844,10 +1845,11 @@ read_schema_dse(
         }
         val.bv_val = psbMatchingRule->buffer;
         val.bv_len = strlen(psbMatchingRule->buffer);
-        attrlist_merge(&pschema_info_e->e_attrs, "matchingRules", vals);
+        slapi_entry_attr_merge(pschema_info_e, "matchingRules", vals);
     }
     if (!schema_ds4x_compat && !user_defined_only) {
         /* return the set of syntaxes we support */
+        entry_attrs_changed(pschema_info_e);
         sew.attrs = &pschema_info_e->e_attrs;
         sew.psbSyntaxDescription = psbSyntaxDescription;
         plugin_syntax_enumerate(schema_syntax_enum_callback, &sew);
@@ -393,6 +393,9 @@ typedef void (*VFPV)(); /* takes undefined arguments */
 #define SLAPD_DEFAULT_SNMP_INDEX_STR "0"
 #define SLAPD_DEFAULT_NUM_LISTENERS 1
 #define SLAPD_DEFAULT_NUM_LISTENERS_STR "1"
+#define SLAPD_DEFAULT_EVENTQ_THREADS 1
+#define SLAPD_DEFAULT_EVENTQ_THREADS_STR "1"
+#define SLAPD_MAX_EVENTQ_THREADS 64
 
 #define SLAPD_DEFAULT_PW_INHISTORY 6
 #define SLAPD_DEFAULT_PW_INHISTORY_STR "6"
@@ -449,6 +452,10 @@ typedef void (*VFPV)(); /* takes undefined arguments */
 #define SLAPD_DEFAULT_TCP_KEEPALIVE_TIME 300
 #define SLAPD_DEFAULT_TCP_KEEPALIVE_TIME_STR "300"
 
+#define SLAPD_DEFAULT_DSE_WRITE_DELAY 0
+#define SLAPD_DEFAULT_DSE_WRITE_DELAY_STR "0"
+#define SLAPD_MAX_DSE_WRITE_DELAY 60000
+
 #define SLAPD_DEFAULT_REFERRAL_CHECK_PERIOD 300
 #define SLAPD_DEFAULT_REFERRAL_CHECK_PERIOD_STR "300"
 
@@ -863,6 +870,7 @@ struct slapi_entry
     void *e_extension;            /* A list of entry object extensions */
     unsigned char e_flags;
     Slapi_Attr *e_aux_attrs;      /* Attr list used for upgrade */
+    struct entry_attrs_index *e_attrs_index; /* e_attrs by type, built by the first lookup */
 };
 
 struct attrs_in_extension
@@ -1024,6 +1032,26 @@ struct pluginconfig
     PRBool plgc_invoke_for_replop;                  /* indicates that plugin should be invoked for internal operations */
 };
 
+/* Latency histograms, see latency.c */
+typedef struct slapi_latency Slapi_Latency;
+
+/* Latencies in microseconds, over a window */
+typedef struct slapi_latency_summary
+{
+    uint64_t count;
+    uint64_t avg;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+} Slapi_Latency_Summary;
+
+/* Each reader of the histograms gets its own windows */
+#define LATENCY_READER_MONITOR 0
+#define LATENCY_READER_SNMP 1
+#define LATENCY_NB_READERS 2
+
 struct slapdplugin
 {
     void *plg_private;                      /* data private to plugin */
@@ -1051,6 +1079,7 @@ struct slapdplugin
     PRUint64 plg_started;                   /* plugin is started/running */
     PRUint64 plg_stopped;                   /* plugin has been fully shutdown */
     Slapi_Counter *plg_op_counter;          /* operation counter, used for shutdown */
+    Slapi_Latency *plg_latency;             /* pre/post operation call times, allocated on first call */
 
     /* NOTE: These LDIF2DB and DB2LDIF fn pointers are internal only for now.
      * I don't believe you can get these functions from a plug-in and
@@ -1520,6 +1549,7 @@ typedef struct backend
     void *vlvSearchList;
     Slapi_Counter *be_usn_counter; /* USN counter; one counter per backend */
     int be_pagedsizelimit;         /* size limit for this backend for simple paged result searches */
+    Slapi_Latency *be_latency;     /* operation times */
 } backend;
 
 enum
@@ -1634,6 +1664,10 @@ typedef struct op
     struct slapi_operation_results o_results;
     int o_pagedresults_sizelimit;
     int o_reverse_search_state;
+    int o_apply_state;           /* parallel apply state, see OP_APPLY_... below */
+    char **o_apply_keys;         /* normalized dns and uniqueid of the entries the update applies to */
+    char **o_apply_deps;         /* those of the entries it depends on, as the parent of an added entry */
+    BerElement *o_apply_result;  /* result held until the previous operations sent theirs */
 } Operation;
 
 /*
@@ -1648,6 +1682,19 @@ typedef struct op
 #define SLAPI_OP_STATUS_WILL_COMPLETE 2 /* no more abandon checks will be done */
 #define SLAPI_OP_STATUS_RESULT_SENT   3   /* result has been sent to the client (or we tried to do so and failed) */
 
+/*
+ * Parallel apply state (o_apply_state) of the operations of a replication
+ * session whose updates are applied concurrently (see connection.c).
+ * The state of an operation only increases.
+ */
+#define OP_APPLY_NONE       0 /* applied serially */
+#define OP_APPLY_READ       1 /* read, the entries it applies to are not known yet */
+#define OP_APPLY_REGISTERED 2 /* the entries it applies to are known */
+#define OP_APPLY_RUNNING    3 /* no previous update of the same entries is pending */
+#define OP_APPLY_BARRIER    4 /* runs once all the previous operations are done */
+#define OP_APPLY_APPLIED    5 /* applied, its result may be held */
+#define OP_APPLY_SENT       6 /* its result is sent */
+
 
 /* simple paged structure */
 typedef struct _paged_results
@@ -1656,6 +1703,8 @@ typedef struct _paged_results
     void *pr_search_result_set;             /* search result set for paging */
     int pr_search_result_count;             /* search result count */
     int pr_search_result_set_size_estimate; /* estimated search result set size */
+    size_t pr_search_result_mem;            /* memory held by the search result set */
+    size_t pr_search_result_spilled;        /* search result set bytes spilled to disk */
     int pr_sort_result_code;                /* sort result put in response */
     struct timespec pr_timelimit_hr;        /* expiry time of this request rel to clock monotonic */
     int pr_flags;
@@ -1694,6 +1743,8 @@ typedef struct conn
     char *c_dn;                      /* current DN bound to this conn  */
     int c_isroot;                    /* c_dn was rootDN at time of bind? */
     int c_isreplication_session;     /* this connection is a replication session */
+    int c_parallel_apply;            /* the replicated updates of the session are applied concurrently */
+    pthread_cond_t c_apply_cv;       /* signaled when an operation applied in parallel changes state */
     char *c_authtype;                /* auth method used to bind c_dn  */
     char *c_external_dn;             /* client DN of this SSL session  */
     char *c_external_authtype;       /* used for c_external_dn   */
@@ -2273,6 +2324,7 @@ typedef struct _slapdEntryPoints
 #define CONFIG_MAXTHREADSPERCONN_ATTRIBUTE "nsslapd-maxthreadsperconn"
 #define CONFIG_MAXDESCRIPTORS_ATTRIBUTE "nsslapd-maxdescriptors"
 #define CONFIG_NUM_LISTENERS_ATTRIBUTE "nsslapd-numlisteners"
+#define CONFIG_EVENTQ_THREADS_ATTRIBUTE "nsslapd-eventq-threads"
 #define CONFIG_RESERVEDESCRIPTORS_ATTRIBUTE "nsslapd-reservedescriptors"
 #define CONFIG_IDLETIMEOUT_ATTRIBUTE "nsslapd-idletimeout"
 #define CONFIG_IOBLOCKTIMEOUT_ATTRIBUTE "nsslapd-ioblocktimeout"
@@ -2417,6 +2469,7 @@ typedef struct _slapdEntryPoints
 
 #define CONFIG_TCP_FIN_TIMEOUT       "nsslapd-tcp-fin-timeout"
 #define CONFIG_TCP_KEEPALIVE_TIME    "nsslapd-tcp-keepalive-time"
+#define CONFIG_DSE_WRITE_DELAY       "nsslapd-dse-write-delay"
 
 /*
  * Define the backlog number for use in listen() call.
@@ -2477,6 +2530,7 @@ typedef struct _slapdFrontendConfig
     slapi_onoff_t lastmod;
     int64_t maxdescriptors;
     int num_listeners;
+    int eventq_threads; /* event queue callback executors */
     slapi_int_t maxthreadsperconn;
     int outbound_ldap_io_timeout;
     slapi_onoff_t nagle;
@@ -2753,6 +2807,7 @@ typedef struct _slapdFrontendConfig
 
     slapi_int_t tcp_fin_timeout;
     slapi_int_t tcp_keepalive_time;
+    slapi_int_t dse_write_delay; /* ms a dse.ldif write may be deferred, 0 means synchronous */
     int32_t referral_check_period;
     slapi_onoff_t return_orig_dn;
     slapi_onoff_t pw_admin_skip_info;
@@ -0,0 +1,62 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#pragma once
+
+/*
+ * Static tracepoints (USDT/SDT) of the ns-slapd provider.
+ *
+ * With --enable-systemtap each probe is compiled as a single nop and a
+ * note in the ELF object that defines it (ns-slapd, libslapd or a plugin
+ * library), that bpftrace, SystemTap or perf turn into a breakpoint when
+ * they attach to it. The arguments are evaluated at every pass, traced
+ * or not, so keep them to values at hand: ids, pointers, return codes,
+ * never a function call. Without --enable-systemtap the probes compile
+ * to nothing.
+ *
+ * The probe names and arguments are a stable interface for the scripts
+ * in profiling/: rename or move a probe only together with them.
+ *
+ *   conn__read__entry(connid)                    reading an operation
+ *   conn__read__return(connid, rc, tag)
+ *   workq__enqueue(op, size)                     connection queued for a worker
+ *   workq__dequeue(op, size)                     taken by a worker thread
+ *   op__dispatch(connid, opid, tag)              operation processing
+ *   op__done(connid, opid, tag)
+ *   search__candidates__entry(scope)             candidate list build
+ *   search__candidates__return(rc, nids)
+ *   search__filter__entry(id)                    filter test of a candidate
+ *   search__filter__return(id, rc)
+ *   search__entry__send__entry(connid, opid)     search entry sent to the client
+ *   search__entry__send__return(connid, opid, rc)
+ *   entrycache__hit(type)                        entry cache lookup, type is
+ *   entrycache__miss(type)                       0 by id, 1 by dn, 2 by uuid
+ *   txn__begin(txn)                              backend write transactions
+ *   txn__commit(txn, rc)
+ *   txn__abort(txn, rc)
+ *   acl__eval__entry(access)                     access control evaluation
+ *   acl__eval__return(access, rc)
+ */
+
+#ifdef SYSTEMTAP
+#include <sys/sdt.h>
+
+#define SLAPD_PROBE0(name) STAP_PROBE(ns-slapd, name)
+#define SLAPD_PROBE1(name, a1) STAP_PROBE1(ns-slapd, name, a1)
+#define SLAPD_PROBE2(name, a1, a2) STAP_PROBE2(ns-slapd, name, a1, a2)
+#define SLAPD_PROBE3(name, a1, a2, a3) STAP_PROBE3(ns-slapd, name, a1, a2, a3)
+#else
+#define SLAPD_PROBE0(name) do { } while (0)
+#define SLAPD_PROBE1(name, a1) do { } while (0)
+#define SLAPD_PROBE2(name, a1, a2) do { } while (0)
+#define SLAPD_PROBE3(name, a1, a2, a3) do { } while (0)
+#endif
+
+#define SLAPD_PROBE_CACHE_BY_ID 0
+#define SLAPD_PROBE_CACHE_BY_DN 1
+#define SLAPD_PROBE_CACHE_BY_UUID 2
@@ -5185,7 +5185,9 @@ Slapi_Operation *slapi_operation_new(int flags);
  */
 
 int slapi_connection_acquire(Slapi_Connection *conn);
+int slapi_connection_release(Slapi_Connection *conn);
 int slapi_connection_remove_operation(Slapi_PBlock *pb, Slapi_Connection *conn, Slapi_Operation *op, int release);
+int slapi_connection_is_writable(Slapi_Connection *conn);
 
 /*
  * LDAPMod manipulation routines
@@ -6658,6 +6660,7 @@ int slapi_config_remove_callback(int operation, int flags, const char *base, int
 /* task flag (pb_task_flags)*/
 #define SLAPI_TASK_RUNNING_AS_TASK          0x0
 #define SLAPI_TASK_RUNNING_FROM_COMMANDLINE 0x1
+#define SLAPI_TASK_BACKUP_INCREMENTAL       0x2 /* only copy what changed since the last backup */
 
 /* task flags (set by the task-control code) */
 #define SLAPI_TASK_DESTROYING 0x01 /* queued event for destruction */
@@ -7824,6 +7827,12 @@ int slapi_back_set_info(Slapi_Backend *be, int cmd, void *info);
  * BACK_INFO_CRYPT_DESTROY - Free allocated during init data (info: back_info_crypt_destroy)
  * BACK_INFO_CRYPT_ENCRYPT_VALUE - Encrypt the given value (info: back_info_crypt_value)
  * BACK_INFO_CRYPT_DECRYPT_VALUE - Decrypt the given value (info: back_info_crypt_value)
+ * BACK_INFO_SNAPSHOT_READ - Walk the records of the backend databases (info: back_info_snapshot)
+ * BACK_INFO_SNAPSHOT_START - Take the backend offline and empty it (info: back_info_snapshot)
+ * BACK_INFO_SNAPSHOT_WRITE - Store records read from another server (info: back_info_snapshot)
+ * BACK_INFO_SNAPSHOT_DONE - Bring the backend back online (info: back_info_snapshot)
+ * BACK_INFO_INDEX_LOOKUP - Find the entries with values in an equality index (info: back_info_index_lookup)
+ * BACK_INFO_SNAPSHOT_FINGERPRINT - Get the fingerprint of the index configuration (info: back_info_snapshot)
  */
 int slapi_back_ctrl_info(Slapi_Backend *be, int cmd, void *info);
 
@@ -7850,7 +7859,13 @@ enum
     BACK_INFO_INDEX_KEY,           /* Get the status of a key in an index */
     BACK_INFO_DB_DIRECTORY,        /* Get the db directory */
     BACK_INFO_DBHOME_DIRECTORY,    /* Get the dbhome directory */
-    BACK_INFO_CLDB_FILENAME        /* Get the backend replication changelog name */
+    BACK_INFO_CLDB_FILENAME,       /* Get the backend replication changelog name */
+    BACK_INFO_SNAPSHOT_READ,       /* Ctrl: read the backend databases records */
+    BACK_INFO_SNAPSHOT_START,      /* Ctrl: start replacing the backend databases */
+    BACK_INFO_SNAPSHOT_WRITE,      /* Ctrl: write records in the backend databases */
+    BACK_INFO_SNAPSHOT_DONE,       /* Ctrl: end replacing the backend databases */
+    BACK_INFO_INDEX_LOOKUP,        /* Ctrl: find the entries with values in an equality index */
+    BACK_INFO_SNAPSHOT_FINGERPRINT /* Get the fingerprint of the index configuration */
 };
 
 struct _back_info_index_key
@@ -7890,6 +7905,51 @@ struct _back_info_config_entry
 };
 typedef struct _back_info_config_entry back_info_config_entry;
 
+/*
+ * A record of a backend database, as read by BACK_INFO_SNAPSHOT_READ and
+ * written by BACK_INFO_SNAPSHOT_WRITE. The database name is relative to
+ * the backend (i.e: "id2entry.db"), so the records can be written in a
+ * backend with another name.
+ */
+struct _back_info_snapshot_record
+{
+    const char *dbname;
+    struct berval key;
+    struct berval data;
+};
+typedef struct _back_info_snapshot_record back_info_snapshot_record;
+
+/* Called for each record, a non-0 value stops the read */
+typedef int (*back_info_snapshot_fn)(void *arg, back_info_snapshot_record *record);
+
+struct _back_info_snapshot
+{
+    back_info_snapshot_fn record_fn;    /* input (read) -- called for each record */
+    void *arg;                          /* input (read) -- passed to record_fn */
+    back_info_snapshot_record *records; /* input (write) -- records to store */
+    size_t nrecords;                    /* input (write) */
+    int abort;                          /* input (done) -- discard the written records */
+    char *fingerprint;                  /* output (fingerprint), input (start) -- index configuration */
+};
+typedef struct _back_info_snapshot back_info_snapshot;
+
+/*
+ * The entries with one of the values of an attribute, found in its
+ * equality index by BACK_INFO_INDEX_LOOKUP in the transaction of the
+ * calling thread. As with a search, tombstones, ldapsubentries and
+ * replication conflict entries are left out. If the attribute has no
+ * equality index, or a value is over the idlistscanlimit, unindexed is
+ * set and no entry is returned.
+ */
+struct _back_info_index_lookup
+{
+    const char *type;       /* input -- the attribute */
+    struct berval **values; /* input -- the values */
+    Slapi_Entry **entries;  /* output -- copies of the entries, to free */
+    int unindexed;          /* output -- the index cannot tell */
+};
+typedef struct _back_info_index_lookup back_info_index_lookup;
+
 #define BACK_CRYPT_OUTBUFF_EXTLEN 16
 
 /**
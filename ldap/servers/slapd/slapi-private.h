@@ -320,6 +320,12 @@ int entry_first_deleted_attribute(const Slapi_Entry *e, Slapi_Attr **a);
 int entry_next_deleted_attribute(const Slapi_Entry *e, Slapi_Attr **a);
 
 /* entry.c */
+/*
+ * entry_attrs_changed must be called when the list of attributes of an
+ * entry is changed without the entry functions, e.g. with attrlist_add()
+ * or slapi_attr_set_type(): it drops the index of the attributes by type.
+ */
+void entry_attrs_changed(Slapi_Entry *e);
 int entry_apply_mods(Slapi_Entry *e, LDAPMod **mods);
 int is_type_protected(const char *type);
 int entry_apply_mods_ignore_error(Slapi_Entry *e, LDAPMod **mods, int ignore_error);
@@ -830,6 +836,25 @@ int slapi_stop_bulk_import(Slapi_PBlock *pb);
 /* allows plugins to close inbound connection */
 void slapi_disconnect_server(Slapi_Connection *conn);
 
+/*
+ * Parallel apply of the updates of a replication session (connection.c).
+ * The replicated adds, modifies and deletes of a connection set to apply
+ * in parallel run concurrently if they apply to different entries.
+ * slapi_operation_apply_wait_turn returns once the previous updates of the
+ * connection registered the entries they apply to, non-zero if the
+ * operation is applied in parallel. The update then registers the entries
+ * it applies to and depends on with slapi_operation_apply_register
+ * (normalized dns or uniqueids, the arrays are consumed), which returns
+ * once the previous updates it conflicts with are applied, with the number
+ * of updates running. An add whose parent is missing creates a glue entry
+ * for it: it registers the parent among the entries it applies to, so the
+ * adds of its siblings are not applied concurrently. A parent deleted by a
+ * previous update of the connection is registered so by the server.
+ */
+void slapi_connection_set_parallel_apply(Slapi_Connection *conn, int parallel_apply);
+int slapi_operation_apply_wait_turn(Slapi_PBlock *pb);
+int slapi_operation_apply_register(Slapi_PBlock *pb, char **keys, char **deps);
+
 /* functions to look up instance names by suffixes (backend_manager.c) */
 int slapi_lookup_instance_name_by_suffixes(char **included,
                                            char **excluded,
@@ -1357,6 +1382,9 @@ void bervalarray_add_berval_fast(struct berval ***vals, const struct berval *add
 #define PRLDAP_SET_PORT(myaddr, myport) \
     ((myaddr)->raw.family == PR_AF_INET6 ? ((myaddr)->ipv6.port = PR_htons(myport)) : ((myaddr)->inet.port = PR_htons(myport)))
 
+/* slapi_counter.c */
+Slapi_Counter *slapi_counter_new_sharded(void);
+
 /* plugin.c */
 int plugin_enabled(const char *plugin_name, void *identity);
 
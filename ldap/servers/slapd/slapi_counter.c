@@ -16,6 +16,7 @@
 #endif
 
 #include "slap.h"
+#include <unistd.h>
 
 #ifndef ATOMIC_64BIT_OPERATIONS
 #include <pthread.h>
@@ -25,6 +26,19 @@
 #include <machine/sys/inline.h>
 #endif
 
+#define COUNTER_CELL_SIZE 64  /* a cache line */
+#define COUNTER_MAX_CELLS 64
+
+/*
+ * A sharded counter cell. Each cell lives on its own cache line
+ * so that threads updating different cells do not contend.
+ */
+typedef struct slapi_counter_cell
+{
+    uint64_t value;
+    char _pad[COUNTER_CELL_SIZE - sizeof(uint64_t)];
+} slapi_counter_cell;
+
 /*
  * Counter Structure
  */
@@ -33,9 +47,27 @@ typedef struct slapi_counter
     uint64_t value;
 #ifndef ATOMIC_64BIT_OPERATIONS
     pthread_mutex_t _lock;
+#else
+    uint32_t ncells;           /* a power of 2, 0 if the counter is not sharded */
+    slapi_counter_cell *cells; /* summed with value on read */
 #endif
 } slapi_counter;
 
+#ifdef ATOMIC_64BIT_OPERATIONS
+/* Sharded counter cell of the calling thread, assigned on its first update */
+static __thread uint32_t counter_thread_cell = UINT32_MAX;
+static uint32_t counter_next_cell = 0;
+
+static uint64_t *
+counter_get_cell(Slapi_Counter *counter)
+{
+    if (counter_thread_cell == UINT32_MAX) {
+        counter_thread_cell = __atomic_fetch_add(&counter_next_cell, 1, __ATOMIC_RELAXED) % COUNTER_MAX_CELLS;
+    }
+    return &(counter->cells[counter_thread_cell & (counter->ncells - 1)].value);
+}
+#endif
+
 /*
  * slapi_counter_new()
  *
@@ -55,6 +87,39 @@ slapi_counter_new()
     return counter;
 }
 
+/*
+ * slapi_counter_new_sharded()
+ *
+ * Allocates and initializes a new Slapi_Counter whose updates
+ * are spread over per thread cells, one per online cpu (rounded
+ * up to a power of 2). The cells are summed when the counter is
+ * read, so it suits statistics that many threads update on the
+ * hot path and that are seldom read.
+ *
+ * For a sharded counter, the value returned by the update
+ * functions is the value of the calling thread's cell: callers
+ * needing the counter value must use slapi_counter_get_value().
+ */
+Slapi_Counter *
+slapi_counter_new_sharded()
+{
+    Slapi_Counter *counter = slapi_counter_new();
+#ifdef ATOMIC_64BIT_OPERATIONS
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t ncells = 1;
+
+    while (ncells < ncpus && ncells < COUNTER_MAX_CELLS) {
+        ncells <<= 1;
+    }
+    if (ncells > 1) {
+        counter->cells = (slapi_counter_cell *)slapi_ch_memalign(ncells * sizeof(slapi_counter_cell), COUNTER_CELL_SIZE);
+        memset(counter->cells, 0, ncells * sizeof(slapi_counter_cell));
+        counter->ncells = ncells;
+    }
+#endif
+    return counter;
+}
+
 /*
  * slapi_counter_init()
  *
@@ -84,6 +149,8 @@ slapi_counter_destroy(Slapi_Counter **counter)
     if ((counter != NULL) && (*counter != NULL)) {
 #ifndef ATOMIC_64BIT_OPERATIONS
         pthread_mutex_destroy(&((*counter)->_lock));
+#else
+        slapi_ch_free((void **)&((*counter)->cells));
 #endif
         slapi_ch_free((void **)counter);
     }
@@ -127,6 +194,9 @@ slapi_counter_add(Slapi_Counter *counter, uint64_t addvalue)
         return newvalue;
     }
 #ifdef ATOMIC_64BIT_OPERATIONS
+    if (counter->cells) {
+        return __atomic_add_fetch_8(counter_get_cell(counter), addvalue, __ATOMIC_RELAXED);
+    }
     newvalue = __atomic_add_fetch_8(&(counter->value), addvalue, __ATOMIC_RELAXED);
 #else
 #ifdef HPUX
@@ -181,6 +251,9 @@ slapi_counter_subtract(Slapi_Counter *counter, uint64_t subvalue)
     }
 
 #ifdef ATOMIC_64BIT_OPERATIONS
+    if (counter->cells) {
+        return __atomic_sub_fetch_8(counter_get_cell(counter), subvalue, __ATOMIC_RELAXED);
+    }
     newvalue = __atomic_sub_fetch_8(&(counter->value), subvalue, __ATOMIC_RELAXED);
 #else
 #ifdef HPUX
@@ -222,7 +295,8 @@ slapi_counter_subtract(Slapi_Counter *counter, uint64_t subvalue)
 /*
  * slapi_counter_set_value()
  *
- * Atomically sets the value of a Slapi_Counter.
+ * Atomically sets the value of a Slapi_Counter. For a sharded
+ * counter, updates done concurrently with the reset may be lost.
  */
 uint64_t
 slapi_counter_set_value(Slapi_Counter *counter, uint64_t newvalue)
@@ -234,6 +308,9 @@ slapi_counter_set_value(Slapi_Counter *counter, uint64_t newvalue)
     }
 
 #ifdef ATOMIC_64BIT_OPERATIONS
+    for (size_t i = 0; i < counter->ncells; i++) {
+        __atomic_store_8(&(counter->cells[i].value), 0, __ATOMIC_RELAXED);
+    }
     __atomic_store_8(&(counter->value), newvalue, __ATOMIC_RELAXED);
 #else /* HPUX */
 #ifdef HPUX
@@ -267,6 +344,9 @@ slapi_counter_get_value(Slapi_Counter *counter)
 
 #ifdef ATOMIC_64BIT_OPERATIONS
     value = __atomic_load_8(&(counter->value), __ATOMIC_RELAXED);
+    for (size_t i = 0; i < counter->ncells; i++) {
+        value += __atomic_load_8(&(counter->cells[i].value), __ATOMIC_RELAXED);
+    }
 #else /* HPUX */
 #ifdef HPUX
     do {
@@ -98,43 +98,50 @@ snmp_collator_init(void)
      * Create the per threads SNMP counters
      */
     for (snmp_vars = g_get_first_thread_snmp_vars(&cookie); snmp_vars; snmp_vars = g_get_next_thread_snmp_vars(&cookie)) {
-        snmp_vars->ops_tbl.dsAnonymousBinds = slapi_counter_new();
-        snmp_vars->ops_tbl.dsUnAuthBinds = slapi_counter_new();
-        snmp_vars->ops_tbl.dsSimpleAuthBinds = slapi_counter_new();
-        snmp_vars->ops_tbl.dsStrongAuthBinds = slapi_counter_new();
-        snmp_vars->ops_tbl.dsBindSecurityErrors = slapi_counter_new();
-        snmp_vars->ops_tbl.dsInOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsReadOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsCompareOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsAddEntryOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsRemoveEntryOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsModifyEntryOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsModifyRDNOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsListOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsSearchOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsOneLevelSearchOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsWholeSubtreeSearchOps = slapi_counter_new();
-        snmp_vars->ops_tbl.dsReferrals = slapi_counter_new();
-        snmp_vars->ops_tbl.dsChainings = slapi_counter_new();
-        snmp_vars->ops_tbl.dsSecurityErrors = slapi_counter_new();
-        snmp_vars->ops_tbl.dsErrors = slapi_counter_new();
-        snmp_vars->ops_tbl.dsConnections = slapi_counter_new();
-        snmp_vars->ops_tbl.dsConnectionSeq = slapi_counter_new();
-        snmp_vars->ops_tbl.dsBytesRecv = slapi_counter_new();
-        snmp_vars->ops_tbl.dsBytesSent = slapi_counter_new();
-        snmp_vars->ops_tbl.dsEntriesReturned = slapi_counter_new();
-        snmp_vars->ops_tbl.dsReferralsReturned = slapi_counter_new();
-        snmp_vars->ops_tbl.dsConnectionsInMaxThreads = slapi_counter_new();
-        snmp_vars->ops_tbl.dsMaxThreadsHits = slapi_counter_new();
-        snmp_vars->entries_tbl.dsSupplierEntries = slapi_counter_new();
-        snmp_vars->entries_tbl.dsCopyEntries = slapi_counter_new();
-        snmp_vars->entries_tbl.dsCacheEntries = slapi_counter_new();
-        snmp_vars->entries_tbl.dsCacheHits = slapi_counter_new();
-        snmp_vars->entries_tbl.dsConsumerHits = slapi_counter_new();
-        snmp_vars->server_tbl.dsOpInitiated = slapi_counter_new();
-        snmp_vars->server_tbl.dsOpCompleted = slapi_counter_new();
-        snmp_vars->server_tbl.dsEntriesSent = slapi_counter_new();
-        snmp_vars->server_tbl.dsBytesSent = slapi_counter_new();
+        /*
+         * Each worker thread updates its own slot. The first slot is shared
+         * by all the other threads (listeners, persistent and sync searches,
+         * plugin and replication threads...), so its counters are sharded.
+         */
+        Slapi_Counter *(*counter_new)(void) = (cookie == 0) ? slapi_counter_new_sharded : slapi_counter_new;
+
+        snmp_vars->ops_tbl.dsAnonymousBinds = counter_new();
+        snmp_vars->ops_tbl.dsUnAuthBinds = counter_new();
+        snmp_vars->ops_tbl.dsSimpleAuthBinds = counter_new();
+        snmp_vars->ops_tbl.dsStrongAuthBinds = counter_new();
+        snmp_vars->ops_tbl.dsBindSecurityErrors = counter_new();
+        snmp_vars->ops_tbl.dsInOps = counter_new();
+        snmp_vars->ops_tbl.dsReadOps = counter_new();
+        snmp_vars->ops_tbl.dsCompareOps = counter_new();
+        snmp_vars->ops_tbl.dsAddEntryOps = counter_new();
+        snmp_vars->ops_tbl.dsRemoveEntryOps = counter_new();
+        snmp_vars->ops_tbl.dsModifyEntryOps = counter_new();
+        snmp_vars->ops_tbl.dsModifyRDNOps = counter_new();
+        snmp_vars->ops_tbl.dsListOps = counter_new();
+        snmp_vars->ops_tbl.dsSearchOps = counter_new();
+        snmp_vars->ops_tbl.dsOneLevelSearchOps = counter_new();
+        snmp_vars->ops_tbl.dsWholeSubtreeSearchOps = counter_new();
+        snmp_vars->ops_tbl.dsReferrals = counter_new();
+        snmp_vars->ops_tbl.dsChainings = counter_new();
+        snmp_vars->ops_tbl.dsSecurityErrors = counter_new();
+        snmp_vars->ops_tbl.dsErrors = counter_new();
+        snmp_vars->ops_tbl.dsConnections = counter_new();
+        snmp_vars->ops_tbl.dsConnectionSeq = counter_new();
+        snmp_vars->ops_tbl.dsBytesRecv = counter_new();
+        snmp_vars->ops_tbl.dsBytesSent = counter_new();
+        snmp_vars->ops_tbl.dsEntriesReturned = counter_new();
+        snmp_vars->ops_tbl.dsReferralsReturned = counter_new();
+        snmp_vars->ops_tbl.dsConnectionsInMaxThreads = counter_new();
+        snmp_vars->ops_tbl.dsMaxThreadsHits = counter_new();
+        snmp_vars->entries_tbl.dsSupplierEntries = counter_new();
+        snmp_vars->entries_tbl.dsCopyEntries = counter_new();
+        snmp_vars->entries_tbl.dsCacheEntries = counter_new();
+        snmp_vars->entries_tbl.dsCacheHits = counter_new();
+        snmp_vars->entries_tbl.dsConsumerHits = counter_new();
+        snmp_vars->server_tbl.dsOpInitiated = counter_new();
+        snmp_vars->server_tbl.dsOpCompleted = counter_new();
+        snmp_vars->server_tbl.dsEntriesSent = counter_new();
+        snmp_vars->server_tbl.dsBytesSent = counter_new();
 
         /* Initialize the global interaction table */
         for (i = 0; i < NUM_SNMP_INT_TBL_ROWS; i++) {
@@ -1054,6 +1061,8 @@ snmp_as_entry(Slapi_Entry *e)
         total += slapi_counter_get_value(snmp_vars->entries_tbl.dsConsumerHits);
     }
     add_counter_to_value(e, "ConsumerHits", total);
+
+    latency_snmp_as_entry(e);
 }
 
 /*
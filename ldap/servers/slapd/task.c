@@ -1603,6 +1603,9 @@ task_backup_add(Slapi_PBlock *pb __attribute__((unused)),
     slapi_pblock_set(mypb, SLAPI_PLUGIN, (be->be_database));
     slapi_pblock_set(mypb, SLAPI_BACKEND_TASK, task);
     int32_t task_flags = SLAPI_TASK_RUNNING_AS_TASK;
+    if (slapi_entry_attr_get_bool(e, "nsIncremental")) {
+        task_flags |= SLAPI_TASK_BACKUP_INCREMENTAL;
+    }
     slapi_pblock_set(mypb, SLAPI_TASK_FLAGS, &task_flags);
 
     /* start the backup as a separate thread */
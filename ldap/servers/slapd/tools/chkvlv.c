@@ -34,14 +34,6 @@ typedef struct {
     int recno_idx;
 } dbi_t;
 
-typedef struct {
-    MDB_val data;
-    MDB_val key;
-    int len;
-    uint32_t recno;
-    /* followed by key value then data value */
-} recno_elmt_t;
-
 typedef struct {
     MDB_cursor *cur;
     MDB_txn *txn;
@@ -129,43 +121,6 @@ dup_val(const MDB_val *val)
 }
 
 
-int
-dup_recno_elmt(const MDB_val *val, recno_elmt_t *elmt)
-{
-    if (val->mv_size < sizeof *elmt) {
-        printf("Unexpected record size %ld (Should be >= %ld)\n",
-               val->mv_size, sizeof *elmt);
-        return -1;
-    }
-    memcpy(elmt, val->mv_data, sizeof *elmt);
-    size_t expected_size = (sizeof *elmt) + elmt->key.mv_size + elmt->data.mv_size;
-    if (val->mv_size != expected_size) {
-        printf("Unexpected record size %ld (Should be %ld)\n",
-               val->mv_size, expected_size);
-        elmt->key.mv_data = elmt->data.mv_data = NULL;
-        return -1;
-    }
-    char *pt = val->mv_data;
-    elmt->key.mv_data = pt+sizeof *elmt;
-    elmt->data.mv_data = pt+(sizeof *elmt)+elmt->key.mv_size;
-    elmt->key.mv_data = dup_val(&elmt->key);
-    elmt->data.mv_data = dup_val(&elmt->data);
-    return 0;
-}
-
-void
-free_recno_elmt(recno_elmt_t *elmt)
-{
-    if (elmt->key.mv_data) {
-        free(elmt->key.mv_data);
-        elmt->key.mv_data = NULL;
-    }
-    if (elmt->data.mv_data) {
-        free(elmt->data.mv_data);
-        elmt->data.mv_data = NULL;
-    }
-}
-
 int
 count_cb(iterator_t *it, void *ctx)
 {
@@ -250,83 +205,79 @@ cmp_val(const MDB_val *val1, const MDB_val *val2)
     return val1->mv_size - val2->mv_size;
 }
 
-typedef struct {
-    dbi_t *vlvdbi;
-    recno_elmt_t *elmt;
-    iterator_t *it;
-    int found;
-} check_recno_ctx_t;
-
-int
-check_recno_ctx(iterator_t *it, void *ctx)
-{
-    check_recno_ctx_t *rctx = ctx;
-    if (cmp_val(&it->key, &rctx->elmt->key) == 0) {
-        rctx->found = 1;
-        if (it->count+1 != rctx->elmt->recno) {
-            printf("Problem (invalid recno value) detected in vlv cache record #%d\n", it->count);
-            printf("Found %d instead of %d\n", rctx->elmt->recno, it->count+1);
-        }
-    }
-    return 0;
-}
-
+/* Same encoding as dbmdb_generate_recno_cache_key_by_data */
 void
-check_recno_record(iterator_t *it, dbi_t *vlvdbi, recno_elmt_t *elmt)
+block_key(const MDB_val *key, const MDB_val *data, MDB_val *bkey)
 {
-    int rc = 0;
-    check_recno_ctx_t ctx = {0};
-    ctx.vlvdbi = vlvdbi;
-    ctx.elmt = elmt;
-    ctx.it = it;
-    if (dup_recno_elmt(&it->data, elmt)) {
-        printf("Problem (invalid data size) detected in vlv cache record #%d\n", it->count);
-        return;
+    unsigned char *ptkey = key->mv_data;
+    unsigned char *pt = malloc(1 + 2 * key->mv_size + 2 + sizeof (uint32_t));
+    uint32_t id = 0;
+
+    if (pt == NULL) {
+        fprintf(stderr, "Cannot alloc %ld bytes.\n", 1 + 2 * key->mv_size + 2 + sizeof (uint32_t));
+        exit(1);
+    }
+    bkey->mv_data = pt;
+    *pt++ = 'B';
+    for (size_t i = 0; i < key->mv_size; i++) {
+        *pt++ = ptkey[i];
+        if (ptkey[i] == 0) {
+            *pt++ = 0xff;
+        }
     }
-    T(iterate(it->txn, vlvdbi->dbi, check_recno_ctx, &ctx));
+    *pt++ = 0;
+    *pt++ = 0;
+    memcpy(&id, data->mv_data, data->mv_size < sizeof id ? data->mv_size : sizeof id);
+    *pt++ = (id >> 24) & 0xff;
+    *pt++ = (id >> 16) & 0xff;
+    *pt++ = (id >> 8) & 0xff;
+    *pt++ = id & 0xff;
+    bkey->mv_size = pt - (unsigned char *)bkey->mv_data;
 }
 
+typedef struct {
+    MDB_cursor *rccur;
+    MDB_val bkey;           /* current block */
+    MDB_val bdata;
+    int rc;                 /* status of the cache cursor */
+    uint32_t remaining;     /* vlv records still expected in current block */
+    int nbblocks;
+} check_blocks_ctx_t;
+
+/* Called for each vlv record: checks it matches the cache blocks */
 int
-walk_cache(iterator_t *it, void *ctx)
+check_block(iterator_t *it, void *ctx)
 {
-    char *pt = it->key.mv_data;
-    recno_elmt_t elmt = {0};
-    MDB_val vkey;
-    MDB_val vdata;
-    switch (*pt) {
-        case 'O':
-            printf("vlv cache is in sync.\n");
-            return 0;
-        case 'D':
-            if (it->key.mv_size < sizeof vkey.mv_size) {
-                printf("Problem (invalid key size) detected in vlv cache record #%d\n", it->count);
-                return 0;
-            }
-            memcpy(&vkey.mv_size, pt + it->key.mv_size - sizeof vkey.mv_size, sizeof vkey.mv_size);
-            vkey.mv_data = pt+1;
-            vdata.mv_data = pt+1+vkey.mv_size;
-            vdata.mv_size = it->key.mv_size - 1-vkey.mv_size - sizeof vkey.mv_size;
-            printf("vkey: "); dump_val(&vkey); putchar('\n');
-            printf("vdata: "); dump_val(&vdata); putchar('\n');
-            check_recno_record(it, ctx, &elmt);
-            if (cmp_val(&vkey, &elmt.key) != 0) {
-                printf("Problem (missmatching key value) detected in vlv cache record #%d\n", it->count);
-                return 0;
-            }
-            if (cmp_val(&vdata, &elmt.data) != 0) {
-                printf("Problem (missmatching data value) detected in vlv cache record #%d\n", it->count);
-                return 0;
-            }
-            return 0;
-        case 'R':
-            if (it->key.mv_size !=11) {
-                printf("Problem (invalid key size) detected in vlv cache record #%d\n", it->count);
-                return 0;
-            }
-            check_recno_record(it, ctx, &elmt);
-            return 0;
+    check_blocks_ctx_t *bctx = ctx;
+    MDB_val bkey = {0};
+
+    if (bctx->remaining == 0) {
+        /* This record should start the next block */
+        block_key(&it->key, &it->data, &bkey);
+        if (bctx->rc != 0 || *(char*)bctx->bkey.mv_data != 'B') {
+            printf("Problem (missing block) detected for vlv record #%d\n", it->count);
+            printf("vkey: "); dump_val(&it->key); putchar('\n');
+            free(bkey.mv_data);
+            return MDB_NOTFOUND;
+        }
+        if (cmp_val(&bkey, &bctx->bkey) != 0) {
+            printf("Problem (missmatching block first record) detected in vlv cache block #%d\n", bctx->nbblocks);
+            printf("vkey: "); dump_val(&it->key); putchar('\n');
+        }
+        free(bkey.mv_data);
+        if (bctx->bdata.mv_size != sizeof bctx->remaining) {
+            printf("Problem (invalid data size) detected in vlv cache block #%d\n", bctx->nbblocks);
+            return MDB_NOTFOUND;
+        }
+        memcpy(&bctx->remaining, bctx->bdata.mv_data, sizeof bctx->remaining);
+        if (bctx->remaining == 0) {
+            printf("Problem (empty block) detected in vlv cache block #%d\n", bctx->nbblocks);
+            return MDB_NOTFOUND;
+        }
+        bctx->nbblocks++;
+        bctx->rc = mdb_cursor_get(bctx->rccur, &bctx->bkey, &bctx->bdata, MDB_NEXT);
     }
-
+    bctx->remaining--;
     return 0;
 }
 
@@ -335,9 +286,32 @@ process_vlv(int idx)
 {
     int rc = 0;
 	MDB_txn *txn = 0;
+    check_blocks_ctx_t bctx = {0};
+    MDB_val data = {0};
+    MDB_val key = {0};
+
     printf("Processing: %s\n", dbis[idx].name);
     T(mdb_txn_begin(env, NULL, MDB_RDONLY, &txn));
-    T(iterate(txn, dbis[dbis[idx].recno_idx].dbi, walk_cache, &dbis[idx]))
+    key.mv_data = "OK-blocks";
+    key.mv_size = strlen(key.mv_data);
+    if (mdb_get(txn, dbis[dbis[idx].recno_idx].dbi, &key, &data)) {
+        printf("vlv cache is not in sync (it will be rebuilt at next vlv search).\n");
+        mdb_txn_abort(txn);
+        return;
+    }
+    printf("vlv cache is in sync.\n");
+    T(mdb_cursor_open(txn, dbis[dbis[idx].recno_idx].dbi, &bctx.rccur));
+    bctx.bkey.mv_data = "B";
+    bctx.bkey.mv_size = 1;
+    bctx.rc = mdb_cursor_get(bctx.rccur, &bctx.bkey, &bctx.bdata, MDB_SET_RANGE);
+    T(iterate(txn, dbis[idx].dbi, check_block, &bctx));
+    if (bctx.remaining != 0) {
+        printf("Problem (block count too large) detected in vlv cache last block #%d\n", bctx.nbblocks - 1);
+    } else if (bctx.rc == 0 && *(char*)bctx.bkey.mv_data == 'B') {
+        printf("Problem (extra block) detected in vlv cache block #%d\n", bctx.nbblocks);
+    }
+    printf("%d blocks checked.\n", bctx.nbblocks);
+    mdb_cursor_close(bctx.rccur);
     T(mdb_txn_commit(txn));
 }
 
@@ -347,7 +321,7 @@ int main(int argc, char **argv)
     int rc = 0;
     if (argc != 2) {
         printf("Usage: %s <dbdir>\n", argv[1]);
-        printf("\tThis tools check the lmdb vlv caches consistency\n")
+        printf("\tThis tools check the lmdb vlv caches consistency\n");
         exit(1);
     }
     char *dbdir = argv[1];
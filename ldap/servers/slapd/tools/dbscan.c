@@ -27,6 +27,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <limits.h>
 #include <getopt.h>
 #include "../back-ldbm/dbimpl.h"
 #include "../slapi-plugin.h"
@@ -59,6 +60,7 @@
 #define IMPORT 0x80
 #define REMOVE 0x100
 #define SHOWSTAT 0x200
+#define INDEXSTATS 0x400
 
 /* stolen from slapi-plugin.h */
 #define SLAPI_OPERATION_BIND 0x00000001UL
@@ -136,6 +138,48 @@ long other_cnt = 0;
 char *dump_filename = NULL;
 int do_it = 0;
 
+/* index statistics (-T): one set of counters per key type */
+#define INDEX_STATS_BUCKETS 32 /* idl length histogram: [2^i, 2^(i+1)[ */
+#define INDEX_STATS_TOP 20
+#define INDEX_STATS_MAX_TOP 100000
+#define INDEX_STATS_IDLISTSCANLIMIT 4000 /* server default nsslapd-idlistscanlimit */
+
+typedef struct
+{
+    char prefix;      /* first character of the keys */
+    const char *name; /* name in the sidecar file */
+    const char *desc;
+    uint64_t keys;
+    uint64_t ids;
+    uint64_t ids2;      /* sum of the squared idl lengths */
+    uint64_t max;
+    uint64_t overlimit; /* keys longer than idlistscanlimit */
+    uint64_t allids;
+    uint64_t histo[INDEX_STATS_BUCKETS];
+} index_type_stats;
+
+static index_type_stats index_stats[] = {
+    { '=', "eq", "Equality" },
+    { '+', "pres", "Presence" },
+    { '~', "approx", "Approximate" },
+    { '*', "sub", "Substring" },
+    { ':', "mr", "Matching rule" },
+    { '\\', "indirect", "Indirect" },
+    { '\0', "other", "Unknown" }, /* must be the last one */
+};
+
+typedef struct
+{
+    uint64_t count;
+    char *key;
+} index_top_key;
+
+static index_top_key *index_top = NULL; /* min-heap on count */
+static uint32_t index_top_max = INDEX_STATS_TOP;
+static uint32_t index_top_used = 0;
+static uint64_t index_idlistscanlimit = INDEX_STATS_IDLISTSCANLIMIT;
+static char *index_stats_filename = NULL;
+
 static Slapi_Backend *be = NULL; /* Pseudo backend used to interact with db */
 
 /* For Long options without shortcuts */
@@ -143,12 +187,18 @@ enum {
     OPT_FIRST = 0x1000,
     OPT_DO_IT,
     OPT_REMOVE,
+    OPT_INDEX_STATS_FILE,
+    OPT_TOP,
+    OPT_IDLISTSCANLIMIT,
 };
 
 static const struct option options[] = {
     /* Options without shortcut */
     { "do-it", no_argument, 0, OPT_DO_IT },
     { "remove", no_argument, 0, OPT_REMOVE },
+    { "index-stats-file", required_argument, 0, OPT_INDEX_STATS_FILE },
+    { "top", required_argument, 0, OPT_TOP },
+    { "idlistscanlimit", required_argument, 0, OPT_IDLISTSCANLIMIT },
     /* Options with shortcut */
     { "import", required_argument, 0, 'I' },
     { "export", required_argument, 0, 'X' },
@@ -161,6 +211,7 @@ static const struct option options[] = {
     { "key", required_argument, 0, 'k' },
     { "list", required_argument, 0, 'L' },
     { "stats", required_argument, 0, 'S' },
+    { "index-stats", no_argument, 0, 'T' },
     { "id-list-max-size", required_argument, 0, 'l' },
     { "id-list-min-size", required_argument, 0, 'G' },
     { "show-id-list-lenghts", no_argument, 0, 'n' },
@@ -900,6 +951,267 @@ display_entryrdn_item(dbi_db_t *db __attribute__((unused)), dbi_cursor_t *cursor
     }
 }
 
+static int
+index_stats_type(dbi_val_t *key)
+{
+    char firstchar = key->size ? ((char *)key->data)[0] : '\0';
+    int i = 0;
+
+    while (index_stats[i].prefix && index_stats[i].prefix != firstchar) {
+        i++;
+    }
+    return i;
+}
+
+static void
+index_top_swap(uint32_t a, uint32_t b)
+{
+    index_top_key tmp = index_top[a];
+    index_top[a] = index_top[b];
+    index_top[b] = tmp;
+}
+
+/* Keep the index_top_max longest keys in a min-heap */
+static void
+index_top_add(dbi_val_t *key, uint64_t count)
+{
+    static unsigned char *buf = NULL;
+    static int buflen = 0;
+    uint32_t i;
+
+    if (index_top_max == 0) {
+        return;
+    }
+    if (index_top == NULL) {
+        index_top = (index_top_key *)calloc(index_top_max, sizeof(index_top_key));
+        if (!index_top) {
+            db_printf("Out of memory: Failed to alloc %d bytes.\n", index_top_max * sizeof(index_top_key));
+            exit(1);
+        }
+    }
+    if (index_top_used == index_top_max && count <= index_top[0].count) {
+        return;
+    }
+    if (buflen < key->size + 256) {
+        buflen = key->size + 256;
+        buf = (unsigned char *)realloc(buf, buflen);
+        if (!buf) {
+            db_printf("Out of memory: Failed to alloc %d bytes.\n", buflen);
+            exit(1);
+        }
+    }
+
+    if (index_top_used < index_top_max) {
+        /* append the key then sift it up */
+        i = index_top_used++;
+        index_top[i].count = count;
+        index_top[i].key = strdup(format(key->data, key->size, buf, buflen));
+        while (i > 0 && index_top[(i - 1) / 2].count > index_top[i].count) {
+            index_top_swap(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+        return;
+    }
+
+    /* replace the shortest key then sift it down */
+    free(index_top[0].key);
+    index_top[0].count = count;
+    index_top[0].key = strdup(format(key->data, key->size, buf, buflen));
+    i = 0;
+    while (1) {
+        uint32_t smallest = i;
+        uint32_t l = 2 * i + 1;
+        uint32_t r = l + 1;
+        if (l < index_top_used && index_top[l].count < index_top[smallest].count) {
+            smallest = l;
+        }
+        if (r < index_top_used && index_top[r].count < index_top[smallest].count) {
+            smallest = r;
+        }
+        if (smallest == i) {
+            break;
+        }
+        index_top_swap(i, smallest);
+        i = smallest;
+    }
+}
+
+static int
+index_top_cmp(const void *a, const void *b)
+{
+    const index_top_key *ka = a;
+    const index_top_key *kb = b;
+
+    if (ka->count != kb->count) {
+        return ka->count < kb->count ? 1 : -1;
+    }
+    return strcmp(ka->key, kb->key);
+}
+
+/*
+ * Stream an index dbi one key at a time: only the number of ids of each
+ * key is read (the id lists are never built) so that huge indexes can
+ * be analyzed with a constant memory footprint.
+ */
+static int
+index_stats_scan(dbi_cursor_t *cursor, dbi_val_t *key, dbi_val_t *data)
+{
+    int ret = 0;
+
+    while (ret == 0) {
+        index_type_stats *st = &index_stats[index_stats_type(key)];
+        dbi_recno_t count = 0;
+        int bucket = 0;
+
+        if (data->size >= 2 * sizeof(uint32_t)) {
+            /* old idl format: the whole id list is in one record */
+            IDL *idl = (IDL *)(data->data);
+            if (idl->max == 0) {
+                st->allids++;
+                ret = dblayer_cursor_op(cursor, DBI_OP_NEXT_KEY, key, data);
+                continue;
+            }
+            count = idl->used;
+        } else if ((ret = dblayer_cursor_get_count(cursor, &count)) != 0) {
+            printf("Can't count the ids of a key: %s\n", dblayer_strerror(ret));
+            return 1;
+        }
+
+        st->keys++;
+        st->ids += count;
+        st->ids2 += (uint64_t)count * count;
+        if (count > st->max) {
+            st->max = count;
+        }
+        if (count > index_idlistscanlimit) {
+            st->overlimit++;
+        }
+        while (bucket < INDEX_STATS_BUCKETS - 1 && ((uint64_t)1 << (bucket + 1)) <= count) {
+            bucket++;
+        }
+        st->histo[bucket]++;
+        index_top_add(key, count);
+
+        ret = dblayer_cursor_op(cursor, DBI_OP_NEXT_KEY, key, data);
+    }
+    if (ret != DBI_RC_NOTFOUND) {
+        printf("Bizarre error: %s\n", dblayer_strerror(ret));
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Print the index statistics and write them in the sidecar file.
+ * The estimated candidates are the number of ids returned by the index
+ * for a filter on one existing value: "avg" when the value is picked
+ * among the keys, "weighted" when it is picked among the entries
+ * (i.e. sum(len^2) / sum(len)), which is what the frequent values cost.
+ */
+static int
+index_stats_report(const char *filename, uint64_t dbsize)
+{
+    FILE *fout = NULL;
+    uint64_t keys = 0, ids = 0, allids = 0, overlimit = 0;
+    size_t i;
+
+    for (i = 0; i < COUNTOF(index_stats); i++) {
+        keys += index_stats[i].keys;
+        ids += index_stats[i].ids;
+        allids += index_stats[i].allids;
+        overlimit += index_stats[i].overlimit;
+    }
+
+    printf("Index statistics of %s\n", filename);
+    printf("  On-disk size: %" PRIu64 " bytes\n", dbsize);
+    printf("  Keys: %" PRIu64 "\n", keys);
+    printf("  Ids: %" PRIu64 "\n", ids);
+    printf("  Keys over idlistscanlimit (%" PRIu64 "): %" PRIu64 "\n", index_idlistscanlimit, overlimit);
+    if (allids > 0) {
+        printf("  Keys that reached ALLIDs threshold: %" PRIu64 "\n", allids);
+    }
+
+    for (i = 0; i < COUNTOF(index_stats); i++) {
+        index_type_stats *st = &index_stats[i];
+        if (st->keys == 0) {
+            continue;
+        }
+        printf("\n  %s index keys: %" PRIu64 " ids: %" PRIu64 "\n", st->desc, st->keys, st->ids);
+        printf("    Estimated candidates: avg %.1f weighted %.1f max %" PRIu64 "\n",
+               (double)st->ids / st->keys, st->ids ? (double)st->ids2 / st->ids : 0.0, st->max);
+        printf("    Keys over idlistscanlimit: %" PRIu64 "\n", st->overlimit);
+        printf("    Id list length distribution:\n");
+        for (int b = 0; b < INDEX_STATS_BUCKETS; b++) {
+            char range[48];
+            if (st->histo[b] == 0) {
+                continue;
+            }
+            if (b == 0) {
+                snprintf(range, sizeof range, "1");
+            } else {
+                snprintf(range, sizeof range, "%" PRIu64 "-%" PRIu64,
+                         (uint64_t)1 << b, ((uint64_t)1 << (b + 1)) - 1);
+            }
+            printf("      %23s: %" PRIu64 "\n", range, st->histo[b]);
+        }
+    }
+
+    if (index_top_used > 0) {
+        qsort(index_top, index_top_used, sizeof(index_top_key), index_top_cmp);
+        printf("\n  Top %" PRIu32 " keys:\n", index_top_used);
+        for (uint32_t t = 0; t < index_top_used; t++) {
+            printf("    %-40s%" PRIu64 "\n", index_top[t].key, index_top[t].count);
+        }
+    }
+
+    if (index_stats_filename == NULL) {
+        return 0;
+    }
+
+    /* "name: value" lines, one line per top key */
+    fout = fopen(index_stats_filename, "w");
+    if (fout == NULL) {
+        fprintf(stderr, "Can't open %s: %s\n", index_stats_filename, strerror(errno));
+        return 1;
+    }
+    fprintf(fout, "# dbscan index statistics\n");
+    fprintf(fout, "dbi: %s\n", filename);
+    fprintf(fout, "time: %ld\n", (long)time(NULL));
+    fprintf(fout, "size: %" PRIu64 "\n", dbsize);
+    fprintf(fout, "keys: %" PRIu64 "\n", keys);
+    fprintf(fout, "ids: %" PRIu64 "\n", ids);
+    fprintf(fout, "allids: %" PRIu64 "\n", allids);
+    fprintf(fout, "idlistscanlimit: %" PRIu64 "\n", index_idlistscanlimit);
+    for (i = 0; i < COUNTOF(index_stats); i++) {
+        index_type_stats *st = &index_stats[i];
+        if (st->keys == 0) {
+            continue;
+        }
+        fprintf(fout, "%s-keys: %" PRIu64 "\n", st->name, st->keys);
+        fprintf(fout, "%s-ids: %" PRIu64 "\n", st->name, st->ids);
+        fprintf(fout, "%s-avg: %.1f\n", st->name, (double)st->ids / st->keys);
+        fprintf(fout, "%s-weighted: %.1f\n", st->name, st->ids ? (double)st->ids2 / st->ids : 0.0);
+        fprintf(fout, "%s-max: %" PRIu64 "\n", st->name, st->max);
+        fprintf(fout, "%s-overlimit: %" PRIu64 "\n", st->name, st->overlimit);
+        fprintf(fout, "%s-histogram:", st->name);
+        for (int b = 0; b < INDEX_STATS_BUCKETS; b++) {
+            if (st->histo[b]) {
+                fprintf(fout, " %" PRIu64 ":%" PRIu64, (uint64_t)1 << b, st->histo[b]);
+            }
+        }
+        fprintf(fout, "\n");
+    }
+    for (uint32_t t = 0; t < index_top_used; t++) {
+        fprintf(fout, "top: %" PRIu64 " %s\n", index_top[t].count, index_top[t].key);
+    }
+    if (fclose(fout) != 0) {
+        fprintf(stderr, "Can't write %s: %s\n", index_stats_filename, strerror(errno));
+        return 1;
+    }
+    printf("\nIndex statistics written in %s\n", index_stats_filename);
+    return 0;
+}
+
 static int
 is_changelog(char *filename)
 {
@@ -987,6 +1299,12 @@ usage(char *argv0, int error)
     printf("    --remove                       remove database instance\n");
     printf("    -r, --show-id-list             display the conents of ID list\n");
     printf("    -S, --stats <dbhome>           show statistics\n");
+    printf("    -T, --index-stats              show the key count, id list length distribution, top keys,\n");
+    printf("                                   estimated candidates per filter type and size of an index\n");
+    printf("    --index-stats-file <file>      also write the index statistics in this (sidecar) file\n");
+    printf("    --top <n>                      number of top keys shown by --index-stats (0 to %d, default %d)\n",
+           INDEX_STATS_MAX_TOP, INDEX_STATS_TOP);
+    printf("    --idlistscanlimit <n>          id list length reported as too long by --index-stats (default %d)\n", INDEX_STATS_IDLISTSCANLIMIT);
     printf("    -X, --export file              export database instance in file\n");
 
     printf("  other options:\n");
@@ -1011,6 +1329,8 @@ usage(char *argv0, int error)
     printf("    %s -r -G 20 -f sn.db4\n", p0);
     printf("    # display summary of objectclass.db4\n");
     printf("    %s -s -f objectclass.db4\n", p0);
+    printf("    # display the key skew of the mail index and save it in mail.stats\n");
+    printf("    %s -T --index-stats-file mail.stats -f /var/lib/dirsrv/slapd-supplier1/db/userroot/mail.db\n", p0);
     printf("\n");
     free(copy);
     exit(error?1:0);
@@ -1335,6 +1655,23 @@ removedb(const char *dbimpl_name, const char *filename)
     return 0;
 }
 
+/* Parse a count option value, between 0 and max. Returns -1 if it is invalid */
+static int
+parse_count(const char *option, const char *arg, uint64_t max, uint64_t *value)
+{
+    char *end = NULL;
+    long long v;
+
+    errno = 0;
+    v = strtoll(arg, &end, 10);
+    if (errno || end == arg || *end || v < 0 || (uint64_t)v > max) {
+        fprintf(stderr, "PARAMETER ERROR! Invalid value '%s' for %s (0 to %" PRIu64 ").\n", arg, option, max);
+        return -1;
+    }
+    *value = (uint64_t)v;
+    return 0;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1386,6 +1723,22 @@ main(int argc, char **argv)
         case OPT_REMOVE:
             display_mode |= REMOVE;
             break;
+        case OPT_INDEX_STATS_FILE:
+            index_stats_filename = optarg;
+            break;
+        case OPT_TOP: {
+            uint64_t top = 0;
+            if (parse_count("--top", optarg, INDEX_STATS_MAX_TOP, &top)) {
+                usage(argv[0], 1);
+            }
+            index_top_max = (uint32_t)top;
+            break;
+        }
+        case OPT_IDLISTSCANLIMIT:
+            if (parse_count("--idlistscanlimit", optarg, LLONG_MAX, &index_idlistscanlimit)) {
+                usage(argv[0], 1);
+            }
+            break;
         case 'A':
             display_mode |= ASCIIDATA;
             break;
@@ -1399,6 +1752,9 @@ main(int argc, char **argv)
             display_mode |= SHOWSTAT;
             filename = optarg;
             break;
+        case 'T':
+            display_mode |= INDEXSTATS;
+            break;
         case 'L':
             display_mode |= LISTDBS;
             filename = optarg;
@@ -1525,6 +1881,12 @@ main(int argc, char **argv)
         }
     }
 
+    if ((display_mode & INDEXSTATS) &&
+        (!(file_type & INDEXTYPE) || (file_type & (VLVINDEXTYPE | ENTRYRDNINDEXTYPE)))) {
+        fprintf(stderr, "PARAMETER ERROR! --index-stats only applies to attribute indexes.\n");
+        exit(1);
+    }
+
     if (dblayer_private_open(dbimpl_name, filename, 0, &be, &env, &db)) {
         printf("Can't initialize db plugin: %s\n", dbimpl_name);
         ret = 1;
@@ -1558,6 +1920,18 @@ main(int argc, char **argv)
         goto done;
     }
 
+    if (display_mode & INDEXSTATS) {
+        uint64_t dbsize = 0;
+        ret = index_stats_scan(&cursor, &key, &data);
+        if (ret == 0) {
+            if (dblayer_get_db_size(be, db, NULL, &dbsize) != 0) {
+                printf("Can't get the size of %s\n", filename);
+            }
+            ret = index_stats_report(filename, dbsize);
+        }
+        goto done;
+    }
+
     if (find_key) {
         /* Position cursor at the matching key */
         dblayer_value_set_buffer(be, &key, find_key, strlen(find_key) + 1);
@@ -657,6 +657,12 @@ printGlobalStatistics(void)
            (float)mctx.totNbOpers / (float)(mctx.sampling * mctx.totNbSamples),
            mctx.totNbOpers);
 
+    /*
+   * Open loop rates and latencies
+   */
+    if (mctx.mod2 & M2_OPEN_LOOP)
+        openLoopPrintStatistics();
+
     /*
    * No activity reports.
    */
@@ -798,6 +804,7 @@ trapVector(
     (void)printGlobalStatistics();
     if (sig == SIGINT) {
         printf("Catch SIGINT - exit...\n");
+        (void)openLoopWriteJson();
         fflush(stdout);
         ldcltExit(mctx.exitStatus); /*JLS 25-08-00*/
     }
@@ -1422,6 +1429,8 @@ dumpModeValues(void)
         printf(" attrib_replace"); /*JLS 21-11-00*/
     if (mctx.mod2 & M2_BINDONLY)   /*JLS 04-05-01*/
         printf(" bindonly");       /*JLS 04-05-01*/
+    if (mctx.mod2 & M2_OPEN_LOOP)
+        printf(" rate");
     if (mctx.mode & DELETE_ENTRIES)
         printf(" delete");
     if (mctx.mode & EXACT_SEARCH)
@@ -1851,6 +1860,14 @@ char *execParams[] = {
     "timestamp",
 #define EP_NOZEROPAD 55 /* do not zero pad numbers created by XXX patterns in values and RDNs */
     "nozeropad",
+#define EP_RATE 56 /* open loop mode: target operations per second */
+    "rate",
+#define EP_ARRIVAL 57 /* open loop mode: poisson or constant arrivals */
+    "arrival",
+#define EP_OPMIX 58 /* open loop mode: weights of the operations */
+    "opmix",
+#define EP_JSONRESULT 59 /* open loop mode: file of the json results */
+    "jsonresult",
     NULL};
 
 /* ****************************************************************************
@@ -1986,6 +2003,37 @@ decodeExecParams(
         case EP_NOZEROPAD:
             mctx.mod2 |= M2_NOZEROPAD;
             break;
+        case EP_RATE:
+            mctx.mod2 |= M2_OPEN_LOOP;
+            if ((subvalue == NULL) || ((mctx.olRate = atof(subvalue)) <= 0)) {
+                fprintf(stderr, "Error: missing or bad arg rate\n");
+                return (-1);
+            }
+            break;
+        case EP_ARRIVAL:
+            if ((subvalue != NULL) && (strcmp(subvalue, "poisson") == 0)) {
+                mctx.olArrival = OL_ARRIVAL_POISSON;
+            } else if ((subvalue != NULL) && (strcmp(subvalue, "constant") == 0)) {
+                mctx.olArrival = OL_ARRIVAL_CONSTANT;
+            } else {
+                fprintf(stderr, "Error: arrival must be poisson or constant\n");
+                return (-1);
+            }
+            break;
+        case EP_OPMIX:
+            if (subvalue == NULL) {
+                fprintf(stderr, "Error: missing arg opmix\n");
+                return (-1);
+            }
+            mctx.olMix = strdup(subvalue);
+            break;
+        case EP_JSONRESULT:
+            if (subvalue == NULL) {
+                fprintf(stderr, "Error: missing jsonresult filename\n");
+                return (-1);
+            }
+            mctx.olJsonFile = strdup(subvalue);
+            break;
         case EP_OBJECT:                                              /*JLS 19-03-01*/
             mctx.mod2 |= M2_OBJECT;                                  /*JLS 19-03-01*/
             if (subvalue == NULL)                                    /*JLS 19-03-01*/
@@ -2311,6 +2359,10 @@ main(
     mctx.timeout = DEF_TIMEOUT;
     mctx.totalReq = -1;
     mctx.waitSec = 0;
+    mctx.olRate = 0;
+    mctx.olArrival = OL_ARRIVAL_POISSON;
+    mctx.olMix = NULL;
+    mctx.olJsonFile = NULL;
     s1ctx.cnxduration = SCALAB01_DEF_CNX_DURATION; /*JLS 12-01-01*/
     s1ctx.maxcnxnb = SCALAB01_DEF_MAX_CNX;         /*JLS 12-01-01*/
     s1ctx.wait = SCALAB01_DEF_WAIT_TIME;           /*JLS 12-01-01*/
@@ -2712,6 +2764,8 @@ main(
         fprintf(stderr, "Error : -e rdn needs -e object.\n");         /*JLS 23-03-01*/
         ldcltExit(EXIT_PARAMS);                                       /*JLS 23-03-01*/
     }                                                                 /*JLS 23-03-01*/
+    if (openLoopInit() < 0)
+        ldcltExit(EXIT_PARAMS);
 
     /*
    * Basic initialization from the user's parameters/options
@@ -2843,6 +2897,13 @@ main(
             printf("Async max pending  = %d\n", mctx.asyncMax);
             printf("Async min pending  = %d\n", mctx.asyncMin);
         }
+        if (mctx.mod2 & M2_OPEN_LOOP) {
+            printf("Open loop rate     = %.2f/sec\n", mctx.olRate);
+            printf("Open loop arrivals = %s\n",
+                   mctx.olArrival == OL_ARRIVAL_CONSTANT ? "constant" : "poisson");
+            if (mctx.olMix != NULL)
+                printf("Operations mix     = %s\n", mctx.olMix);
+        }
         for (size_t i = 0; i < mctx.ignErrNb; i++)
             printf("Ignore error       = %d (%s)\n",
                    mctx.ignErr[i], my_ldap_err2string(mctx.ignErr[i]));
@@ -2868,6 +2929,8 @@ main(
         ldcltExit(EXIT_OTHER); /*JLS 25-08-00*/
     if (printGlobalStatistics() < 0)
         ldcltExit(EXIT_OTHER); /*JLS 25-08-00*/
+    if (openLoopWriteJson() < 0)
+        ldcltExit(EXIT_OTHER);
 
     ldcltExit(mctx.exitStatus); /*JLS 25-08-00*/
 
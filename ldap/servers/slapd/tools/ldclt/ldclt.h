@@ -21,6 +21,7 @@
 #ifdef HAVE_SYS_TIME_H
 #include <sys/time.h>
 #endif
+#include <stdint.h>
 
 /*
  * Misc constant definitions
@@ -106,6 +107,7 @@
 #define M2_DEREF 0x00000200                                     /* -e deref */
 #define M2_ATTR_REPLACE_FILE 0x00000400                         /* -e attreplacefile */
 #define M2_NOZEROPAD 0x00000800                                 /* -e nozeropad */
+#define M2_OPEN_LOOP 0x00001000                                 /* -e rate */
 
 /*
  * Combinatory defines
@@ -330,6 +332,44 @@ typedef struct vers_object
     char *fname;                            /* Object definition */
 } vers_object;
 
+/*
+ * Open loop mode (-e rate)
+ * The operations are started at a target rate whatever the time the
+ * server takes to answer, and their latency is measured from the time
+ * they were scheduled, so that a slow server is not hidden by the
+ * client waiting for it (aka coordinated omission).
+ */
+#define OL_ARRIVAL_POISSON 0  /* Exponential inter-arrival times */
+#define OL_ARRIVAL_CONSTANT 1 /* Fixed inter-arrival times */
+#define OL_ADD 0              /* Operations of the mix (-e opmix) */
+#define OL_DELETE 1
+#define OL_ESEARCH 2
+#define OL_ATTREPLACE 3
+#define OL_RENAME 4
+#define OL_BINDONLY 5
+#define OL_NB_OPERS 6
+#define OL_ALL OL_NB_OPERS /* Histogram of all the operations */
+#define OL_LATE_USEC 1000  /* Started later than this is late */
+
+/*
+ * Latency histogram, in microseconds.
+ * The values below LAT_SUB_COUNT have their own bucket, the others
+ * are grouped by power of 2, each power split in LAT_SUB_COUNT / 2
+ * buckets: the value of a bucket is within 1.6% of the values it
+ * counts, as in a HDR histogram with 2 significant digits.
+ */
+#define LAT_SUB_BITS 7
+#define LAT_SUB_COUNT (1 << LAT_SUB_BITS)
+#define LAT_BUCKETS ((64 - LAT_SUB_BITS + 2) * (LAT_SUB_COUNT / 2))
+typedef struct latency_histo
+{
+    uint64_t counts[LAT_BUCKETS]; /* Nb of values per bucket */
+    uint64_t count;               /* Nb of values */
+    uint64_t sum;                 /* To compute the mean */
+    uint64_t min;                 /* Lowest value */
+    uint64_t max;                 /* Highest value */
+} latency_histo;
+
 /*
  * This structure contain the *process* context, used only by the
  * main thread(s).
@@ -441,6 +481,17 @@ typedef struct main_context
 #define DEFAULT_TIMESTAMP_FMT "%s"
     char *tsfmt; /* if non-null, use this strftime format to print timestamps for status updates */
     int waitSec; /* Wait between two operations */
+    double olRate;                          /* -e rate : ops/sec */
+    int olArrival;                          /* -e arrival */
+    char *olMix;                            /* -e opmix */
+    int olWeights[OL_NB_OPERS];             /* Weights of the mix */
+    int olWeightsTot;                       /* Sum of the weights */
+    char *olJsonFile;                       /* -e jsonresult */
+    int64_t olStart;                        /* First arrival (nsec) */
+    int64_t olNext;                         /* Next arrival (nsec) */
+    ldclt_mutex_t olNext_mutex;             /* Protect olNext */
+    uint64_t olLate;                        /* Nb of late starts */
+    latency_histo olHisto[OL_NB_OPERS + 1]; /* Latencies per oper */
 } main_context;
 
 
@@ -601,6 +652,11 @@ extern int getImage(LDAPMod *attribute);
 extern int loadImages(char *dirpath);
 /* From workarounds.c */
 extern int getFdFromLdapSession(LDAP *ld, int *fd);
+/* From openloop.c */
+extern int doOpenLoopOper(thread_context *tttctx);
+extern int openLoopInit(void);
+extern void openLoopPrintStatistics(void);
+extern int openLoopWriteJson(void);
 /* From opCheck.c */
 extern int opAdd(thread_context *tttctx, int type, char *dn, LDAPMod **attribs, char *newRdn, char *newParent);
 extern void *opCheckMain(void *);
@@ -39,6 +39,7 @@
  *         abandon : abandon asyncronous search requests.
  *         add        : ldap_add() entries.
  *         append      : append entries to the genldif file.
+ *         arrival=poisson|constant : arrivals of the -e rate operations.
  *         ascii        : ascii 7-bits strings.
  *         attreplace=name:mask    : replace attribute of existing entry.
  *         attrlist=name:name:name : specify list of attribs to retrieve
@@ -67,11 +68,13 @@
  *         imagesdir=path        : specify where are the images.
  *         incr                  : incremental values.
  *         inetOrgPerson         : objectclass=inetOrgPerson (-e add only).
+ *         jsonresult=filename   : writes the -e rate results as json.
  *         keydbfile=file        : filename of the key database
  *         keydbpin=password     : password for accessing the key database
  *         noglobalstats         : don't print periodical global statistics
  *         noloop                  : does not loop the incremental numbers.
  *         object=filename       : build object from input file
+ *         opmix=name:weight;... : weights of the operations (-e rate only).
  *         person                  : objectclass=person (-e add only).
  *         random                  : random filters, etc...
  *         randomattrlist=name:name:name : random select attrib in the list
@@ -82,6 +85,7 @@
  *         randombinddnfromfile=file : retrieve bind DN & passwd from file
  *         randombinddnlow=value  : low value for random generator.
  *         randombinddnhigh=value : high value for random generator.
+ *         rate=value             : open loop, value operations per second.
  *         rdn=attrname:value     : alternate for -f.
  *         referral=on|off|rebind : change referral behaviour.
  *         scalab01               : activates scalab01 scenario.
@@ -143,6 +147,7 @@ usage(void)
     (void)printf("        abandon           : abandon async search requests.\n");
     (void)printf("        add               : ldap_add() entries.\n");
     (void)printf("        append            : append entries to the genldif file.\n");
+    (void)printf("        arrival=poisson|constant : arrivals of the -e rate operations.\n");
     (void)printf("        ascii             : ascii 7-bits strings.\n");
     (void)printf("        attreplacefile=attrname:<file name> : replace attribute with given file content.\n");
     (void)printf("        attreplace=name:mask    : replace attribute of existing entry.\n");
@@ -172,11 +177,13 @@ usage(void)
     (void)printf("        imagesdir=path    : specify where are the images.\n");
     (void)printf("        incr              : incremental values.\n");
     (void)printf("        inetOrgPerson     : objectclass=inetOrgPerson (-e add only).\n");
+    (void)printf("        jsonresult=filename : writes the -e rate results as json.\n");
     (void)printf("        keydbfile=file    : filename of the key database\n");
     (void)printf("        keydbpin=password : password for accessing the key database\n");
     (void)printf("        noglobalstats     : don't print periodical global statistics\n");
     (void)printf("        noloop            : does not loop the incremental numbers.\n");
     (void)printf("        object=filename   : build object from input file\n");
+    (void)printf("        opmix=name:weight;... : weights of the operations (-e rate only).\n");
     (void)printf("        person            : objectclass=person (-e add only).\n");
     (void)printf("        random            : random filters, etc...\n");
     (void)printf("        randomattrlist=name:name:name : random select attrib in the list\n");
@@ -187,6 +194,7 @@ usage(void)
     (void)printf("        randombinddnfromfile=file : retrieve bind DN & passwd from file\n");
     (void)printf("        randombinddnlow=value  : low value for random generator.\n");
     (void)printf("        randombinddnhigh=value : high value for random generator.\n");
+    (void)printf("        rate=value             : open loop, value operations per second.\n");
     (void)printf("        rdn=attrname:value     : alternate for -f.\n");
     (void)printf("        referral=on|off|rebind : change referral behaviour.\n");
     (void)printf("        scalab01               : activates scalab01 scenario.\n");
@@ -0,0 +1,564 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+
+/*
+    FILE :        openloop.c
+    DESCRIPTION :
+            This file implements the open loop mode (-e rate): the
+            arrivals of the operations at a target rate, the mix of
+            operations, and the latency histograms and reports.
+*/
+
+
+#include <stdio.h>    /* printf(), etc... */
+#include <string.h>   /* strerror(), etc... */
+#include <stdlib.h>   /* drand48(), etc... */
+#include <inttypes.h> /* PRIu64 */
+#include <errno.h>    /* errno, etc... */
+#include <math.h>     /* log() */
+#include <time.h>     /* clock_gettime(), etc... */
+#include <lber.h>     /* ldap C-API BER declarations */
+#include <ldap.h>     /* ldap C-API declarations */
+#include "port.h"     /* Portability definitions */
+#include "ldclt.h"    /* This tool's include file */
+#include "utils.h"    /* Utilities functions */
+
+#define NSEC_PER_SEC 1000000000LL
+#define NSEC_PER_USEC 1000LL
+#define OL_MAX_SLEEP (NSEC_PER_SEC / 10) /* Check for shutdown every 100ms */
+
+/*
+ * The operations that may be mixed in open loop mode, in the order
+ * of the OL_* indexes. An operation is part of the mix when its -e
+ * option is given.
+ */
+typedef struct ol_oper
+{
+    char *name;                      /* Name in -e opmix */
+    unsigned int mode;               /* Enabled by this mode */
+    unsigned int mod2;               /* or by this mode 2 */
+    int (*doOper)(thread_context *); /* Does one operation */
+} ol_oper;
+
+static ol_oper olOpers[OL_NB_OPERS] = {
+    {"add", ADD_ENTRIES, 0, doAddEntry},
+    {"delete", DELETE_ENTRIES, 0, doDeleteEntry},
+    {"esearch", EXACT_SEARCH, 0, doExactSearch},
+    {"attreplace", ATTR_REPLACE, 0, doAttrReplace},
+    {"rename", RENAME_ENTRIES, 0, doRename},
+    {"bindonly", 0, M2_BINDONLY, doBindOnly},
+};
+
+static double olPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+
+/* ****************************************************************************
+    FUNCTION :    olNow
+    PURPOSE :    Monotonic time.
+    INPUT :        None.
+    OUTPUT :    None.
+    RETURN :    The time in nanoseconds.
+    DESCRIPTION :
+ *****************************************************************************/
+static int64_t
+olNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    latencyBucket
+    PURPOSE :    Find the bucket of a value in the latency histogram.
+    INPUT :        value    = the value
+    OUTPUT :    None.
+    RETURN :    The bucket index.
+    DESCRIPTION :    The values below LAT_SUB_COUNT are their own bucket.
+            The others are shifted right until they are in
+            [LAT_SUB_COUNT / 2, LAT_SUB_COUNT[, and the shift
+            selects the group of buckets.
+ *****************************************************************************/
+static int
+latencyBucket(
+    uint64_t value)
+{
+    int shift;
+
+    if (value < LAT_SUB_COUNT)
+        return ((int)value);
+    shift = (63 - __builtin_clzll(value)) - (LAT_SUB_BITS - 1);
+    return (shift * (LAT_SUB_COUNT / 2) + (int)(value >> shift));
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    latencyBucketValue
+    PURPOSE :    The highest value counted in a bucket.
+    INPUT :        bucket    = the bucket index
+    OUTPUT :    None.
+    RETURN :    The value.
+    DESCRIPTION :
+ *****************************************************************************/
+static uint64_t
+latencyBucketValue(
+    int bucket)
+{
+    int shift;
+    uint64_t sub;
+
+    if (bucket < LAT_SUB_COUNT)
+        return ((uint64_t)bucket);
+    shift = bucket / (LAT_SUB_COUNT / 2) - 1;
+    sub = (uint64_t)(bucket % (LAT_SUB_COUNT / 2) + LAT_SUB_COUNT / 2);
+    return (((sub + 1) << shift) - 1);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    latencyRecord
+    PURPOSE :    Add a value to a latency histogram.
+    INPUT :        histo    = the histogram
+            value    = the latency in microseconds
+    OUTPUT :    None.
+    RETURN :    None.
+    DESCRIPTION :    Lock free, the histograms are shared by all the
+            threads.
+ *****************************************************************************/
+static void
+latencyRecord(
+    latency_histo *histo,
+    uint64_t value)
+{
+    uint64_t cur;
+
+    __atomic_add_fetch(&(histo->counts[latencyBucket(value)]), 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&(histo->sum), value, __ATOMIC_RELAXED);
+    cur = __atomic_load_n(&(histo->max), __ATOMIC_RELAXED);
+    while (value > cur &&
+           !__atomic_compare_exchange_n(&(histo->max), &cur, value, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    cur = __atomic_load_n(&(histo->min), __ATOMIC_RELAXED);
+    while (value < cur &&
+           !__atomic_compare_exchange_n(&(histo->min), &cur, value, 0,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    /* Last, so that a reader never sees more values than counted */
+    __atomic_add_fetch(&(histo->count), 1, __ATOMIC_RELEASE);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    latencyPercentile
+    PURPOSE :    Compute a percentile of a latency histogram.
+    INPUT :        histo    = the histogram
+            percent    = the percentile, e.g. 99.9
+    OUTPUT :    None.
+    RETURN :    The value in microseconds, 0 if the histogram is empty.
+    DESCRIPTION :
+ *****************************************************************************/
+static uint64_t
+latencyPercentile(
+    latency_histo *histo,
+    double percent)
+{
+    uint64_t count = __atomic_load_n(&(histo->count), __ATOMIC_ACQUIRE);
+    uint64_t target;
+    uint64_t seen = 0;
+    uint64_t value;
+
+    if (count == 0)
+        return (0);
+    target = (uint64_t)((percent / 100.0) * (double)count + 0.5);
+    if (target < 1)
+        target = 1;
+    for (int i = 0; i < LAT_BUCKETS; i++) {
+        seen += __atomic_load_n(&(histo->counts[i]), __ATOMIC_RELAXED);
+        if (seen >= target) {
+            value = latencyBucketValue(i);
+            return (value < histo->max ? value : histo->max);
+        }
+    }
+    return (histo->max);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    decodeOpMix
+    PURPOSE :    Decode the -e opmix=name:weight;name:weight argument.
+    INPUT :        None.
+    OUTPUT :    None.
+    RETURN :    -1 if error, 0 else.
+    DESCRIPTION :    Each operation of the mix must be enabled by its own
+            -e option, that also gives its parameters.
+ *****************************************************************************/
+static int
+decodeOpMix(void)
+{
+    char *mix = strdup(mctx.olMix);
+    char *iter = NULL;
+    char *item;
+    int ret = 0;
+
+    for (item = strtok_r(mix, ";", &iter); item != NULL; item = strtok_r(NULL, ";", &iter)) {
+        char *weight = strchr(item, ':');
+        int op;
+
+        if (weight != NULL)
+            *weight++ = '\0';
+        for (op = 0; op < OL_NB_OPERS; op++)
+            if (strcmp(item, olOpers[op].name) == 0)
+                break;
+        if (op == OL_NB_OPERS) {
+            fprintf(stderr, "Error: unknown operation \"%s\" in -e opmix\n", item);
+            ret = -1;
+            break;
+        }
+        if (!((mctx.mode & olOpers[op].mode) || (mctx.mod2 & olOpers[op].mod2))) {
+            fprintf(stderr, "Error: -e opmix operation \"%s\" needs -e %s\n", item, item);
+            ret = -1;
+            break;
+        }
+        mctx.olWeights[op] = weight ? atoi(weight) : 1;
+        if (mctx.olWeights[op] <= 0) {
+            fprintf(stderr, "Error: bad weight \"%s\" for %s in -e opmix\n",
+                    weight, item);
+            ret = -1;
+            break;
+        }
+    }
+    free(mix);
+    return (ret);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    openLoopInit
+    PURPOSE :    Check the open loop parameters and initiate its data.
+    INPUT :        None.
+    OUTPUT :    None.
+    RETURN :    -1 if error, 0 else.
+    DESCRIPTION :
+ *****************************************************************************/
+int
+openLoopInit(void)
+{
+    int ret;
+
+    if (!(mctx.mod2 & M2_OPEN_LOOP)) {
+        if ((mctx.olMix != NULL) || (mctx.olJsonFile != NULL)) {
+            fprintf(stderr, "Error: -e opmix and -e jsonresult need -e rate\n");
+            return (-1);
+        }
+        return (0);
+    }
+    if (mctx.mode & ASYNC) {
+        fprintf(stderr, "Error: -e rate and -a are exclusive\n");
+        return (-1);
+    }
+    if (mctx.waitSec > 0) {
+        fprintf(stderr, "Error: -e rate and -W are exclusive\n");
+        return (-1);
+    }
+    if ((mctx.mode & SCALAB01) ||
+        (mctx.mod2 & (M2_GENLDIF | M2_ABANDON | M2_ATTR_REPLACE_FILE | M2_DEREF))) {
+        fprintf(stderr, "Error: -e rate supports only add, delete, esearch, attreplace, rename and bindonly\n");
+        return (-1);
+    }
+
+    /*
+   * Without -e opmix, the enabled operations have the same weight
+   */
+    if (mctx.olMix != NULL) {
+        if (decodeOpMix() < 0)
+            return (-1);
+    } else {
+        for (int op = 0; op < OL_NB_OPERS; op++)
+            if ((mctx.mode & olOpers[op].mode) || (mctx.mod2 & olOpers[op].mod2))
+                mctx.olWeights[op] = 1;
+    }
+    mctx.olWeightsTot = 0;
+    for (int op = 0; op < OL_NB_OPERS; op++)
+        mctx.olWeightsTot += mctx.olWeights[op];
+    if (mctx.olWeightsTot == 0) {
+        fprintf(stderr, "Error: -e rate needs at least one operation\n");
+        return (-1);
+    }
+
+    for (int i = 0; i <= OL_ALL; i++)
+        mctx.olHisto[i].min = UINT64_MAX;
+    mctx.olStart = 0;
+    mctx.olNext = 0;
+    mctx.olLate = 0;
+    if ((ret = ldclt_mutex_init(&(mctx.olNext_mutex))) != 0) {
+        fprintf(stderr, "ldclt: %s\n", strerror(ret));
+        fprintf(stderr, "Error: cannot initiate olNext_mutex\n");
+        fflush(stderr);
+        return (-1);
+    }
+    return (0);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    nextArrival
+    PURPOSE :    Take the next arrival of the schedule shared by all
+            the threads.
+    INPUT :        tttctx    = thread context
+    OUTPUT :    arrival    = the arrival time (nsec)
+    RETURN :    -1 if error, 0 else.
+    DESCRIPTION :    The schedule starts with the first arrival. Its
+            inter-arrival times are either constant, or
+            exponentially distributed (Poisson arrivals).
+ *****************************************************************************/
+static int
+nextArrival(
+    thread_context *tttctx,
+    int64_t *arrival)
+{
+    double interval; /* Seconds to the next arrival */
+    int ret;
+
+    if ((ret = ldclt_mutex_lock(&(mctx.olNext_mutex))) != 0) {
+        fprintf(stderr, "ldclt[%d]: %s: cannot mutex_lock(olNext_mutex), error=%d (%s)\n",
+                mctx.pid, tttctx->thrdId, ret, strerror(ret));
+        fflush(stderr);
+        return (-1);
+    }
+    if (mctx.olStart == 0) {
+        mctx.olStart = olNow();
+        mctx.olNext = mctx.olStart;
+    }
+    *arrival = mctx.olNext;
+    if (mctx.olArrival == OL_ARRIVAL_CONSTANT)
+        interval = 1.0 / mctx.olRate;
+    else
+        interval = -log(1.0 - drand48()) / mctx.olRate;
+    mctx.olNext += (int64_t)(interval * NSEC_PER_SEC);
+    if ((ret = ldclt_mutex_unlock(&(mctx.olNext_mutex))) != 0) {
+        fprintf(stderr, "ldclt[%d]: %s: cannot mutex_unlock(olNext_mutex), error=%d (%s)\n",
+                mctx.pid, tttctx->thrdId, ret, strerror(ret));
+        fflush(stderr);
+        return (-1);
+    }
+    return (0);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    doOpenLoopOper
+    PURPOSE :    Wait for the next arrival, then do one operation of
+            the mix and record its latency.
+    INPUT :        tttctx    = thread context
+    OUTPUT :    None.
+    RETURN :    -1 if error, 0 else.
+    DESCRIPTION :    The latency is measured from the arrival, not from
+            the start of the operation: when all the threads are
+            busy, the time an arrival waits for a thread is part
+            of its latency.
+ *****************************************************************************/
+int
+doOpenLoopOper(
+    thread_context *tttctx)
+{
+    int64_t arrival; /* Scheduled start (nsec) */
+    int64_t now;
+    int64_t latency; /* usec */
+    int status;
+    int op;
+    int pick;
+    int ret;
+
+    if (nextArrival(tttctx, &arrival) < 0)
+        return (-1);
+
+    /*
+   * Sleep by slices to notice a shutdown at low rates
+   */
+    while ((now = olNow()) < arrival) {
+        int64_t wake = (arrival - now > OL_MAX_SLEEP) ? now + OL_MAX_SLEEP : arrival;
+        struct timespec ts = {wake / NSEC_PER_SEC, wake % NSEC_PER_SEC};
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        if (getThreadStatus(tttctx, &status) < 0)
+            return (-1);
+        if (status == MUST_SHUTDOWN)
+            return (0);
+    }
+    if (now - arrival > OL_LATE_USEC * NSEC_PER_USEC)
+        __atomic_add_fetch(&(mctx.olLate), 1, __ATOMIC_RELAXED);
+
+    /*
+   * Select the operation according to the weights of the mix
+   */
+    pick = rndlim(1, mctx.olWeightsTot);
+    for (op = 0; op < OL_NB_OPERS; op++) {
+        pick -= mctx.olWeights[op];
+        if (pick <= 0)
+            break;
+    }
+
+    ret = olOpers[op].doOper(tttctx);
+
+    latency = (olNow() - arrival) / NSEC_PER_USEC;
+    latencyRecord(&(mctx.olHisto[op]), (uint64_t)latency);
+    latencyRecord(&(mctx.olHisto[OL_ALL]), (uint64_t)latency);
+    return (ret);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    olElapsed
+    PURPOSE :    Time since the first arrival.
+    INPUT :        None.
+    OUTPUT :    None.
+    RETURN :    The time in seconds, 0 if nothing started yet.
+    DESCRIPTION :
+ *****************************************************************************/
+static double
+olElapsed(void)
+{
+    int64_t start = __atomic_load_n(&(mctx.olStart), __ATOMIC_ACQUIRE);
+
+    if (start == 0)
+        return (0.0);
+    return ((double)(olNow() - start) / (double)NSEC_PER_SEC);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    olOperName
+    PURPOSE :    Name of a histogram.
+    INPUT :        op    = the histogram index
+    OUTPUT :    None.
+    RETURN :    The name.
+    DESCRIPTION :
+ *****************************************************************************/
+static char *
+olOperName(
+    int op)
+{
+    return (op == OL_ALL ? "all" : olOpers[op].name);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    openLoopPrintStatistics
+    PURPOSE :    Print the rates and the latencies of the open loop
+            mode.
+    INPUT :        None.
+    OUTPUT :    None.
+    RETURN :    None.
+    DESCRIPTION :
+ *****************************************************************************/
+void
+openLoopPrintStatistics(void)
+{
+    double elapsed = olElapsed();
+    uint64_t total = __atomic_load_n(&(mctx.olHisto[OL_ALL].count), __ATOMIC_ACQUIRE);
+
+    printf("ldclt[%d]: Open loop target rate: %.2f/sec, achieved: %.2f/sec, late starts: %" PRIu64 "\n",
+           mctx.pid, mctx.olRate, elapsed > 0 ? (double)total / elapsed : 0.0,
+           __atomic_load_n(&(mctx.olLate), __ATOMIC_RELAXED));
+    for (int i = 0; i <= OL_ALL; i++) {
+        latency_histo *histo = &(mctx.olHisto[i]);
+
+        if (__atomic_load_n(&(histo->count), __ATOMIC_ACQUIRE) == 0)
+            continue;
+        printf("ldclt[%d]: Latency %-10s count: %8" PRIu64 "  p50: %" PRIu64 "us  p99: %" PRIu64
+               "us  p99.9: %" PRIu64 "us  max: %" PRIu64 "us\n",
+               mctx.pid, olOperName(i), histo->count,
+               latencyPercentile(histo, 50.0), latencyPercentile(histo, 99.0),
+               latencyPercentile(histo, 99.9), histo->max);
+    }
+    fflush(stdout);
+}
+
+
+/* ****************************************************************************
+    FUNCTION :    openLoopWriteJson
+    PURPOSE :    Write the results of the open loop mode to the
+            -e jsonresult file.
+    INPUT :        None.
+    OUTPUT :    None.
+    RETURN :    -1 if error, 0 else.
+    DESCRIPTION :    The latencies are in microseconds.
+ *****************************************************************************/
+int
+openLoopWriteJson(void)
+{
+    FILE *fp;
+    double elapsed = olElapsed();
+    uint64_t errors = mctx.errorsBad;
+    int first = 1;
+
+    if (!(mctx.mod2 & M2_OPEN_LOOP) || (mctx.olJsonFile == NULL))
+        return (0);
+    if ((fp = fopen(mctx.olJsonFile, "w")) == NULL) {
+        fprintf(stderr, "ldclt[%d]: Cannot open(%s), error=%d (%s)\n",
+                mctx.pid, mctx.olJsonFile, errno, strerror(errno));
+        return (-1);
+    }
+    for (int i = 0; i < MAX_ERROR_NB; i++)
+        errors += mctx.errors[i];
+    for (int i = 0; i < ABS(NEGATIVE_MAX_ERROR_NB); i++)
+        errors += mctx.negativeErrors[i];
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"mode\": \"open-loop\",\n");
+    fprintf(fp, "  \"arrival\": \"%s\",\n",
+            mctx.olArrival == OL_ARRIVAL_CONSTANT ? "constant" : "poisson");
+    fprintf(fp, "  \"target_rate\": %.2f,\n", mctx.olRate);
+    fprintf(fp, "  \"achieved_rate\": %.2f,\n",
+            elapsed > 0 ? (double)mctx.olHisto[OL_ALL].count / elapsed : 0.0);
+    fprintf(fp, "  \"duration\": %.3f,\n", elapsed);
+    fprintf(fp, "  \"threads\": %d,\n", mctx.nbThreads);
+    fprintf(fp, "  \"late\": %" PRIu64 ",\n", mctx.olLate);
+    fprintf(fp, "  \"errors\": %" PRIu64 ",\n", errors);
+    fprintf(fp, "  \"operations\": {");
+    for (int i = 0; i <= OL_ALL; i++) {
+        latency_histo *histo = &(mctx.olHisto[i]);
+
+        if ((i != OL_ALL) && (mctx.olWeights[i] == 0))
+            continue;
+        fprintf(fp, "%s\n    \"%s\": {\n", first ? "" : ",", olOperName(i));
+        first = 0;
+        fprintf(fp, "      \"count\": %" PRIu64 ",\n", histo->count);
+        fprintf(fp, "      \"rate\": %.2f,\n", elapsed > 0 ? (double)histo->count / elapsed : 0.0);
+        fprintf(fp, "      \"latency_us\": {\n");
+        fprintf(fp, "        \"min\": %" PRIu64 ",\n", histo->count ? histo->min : 0);
+        fprintf(fp, "        \"mean\": %.1f,\n",
+                histo->count ? (double)histo->sum / (double)histo->count : 0.0);
+        for (size_t p = 0; p < sizeof(olPercentiles) / sizeof(olPercentiles[0]); p++)
+            fprintf(fp, "        \"p%g\": %" PRIu64 ",\n",
+                    olPercentiles[p], latencyPercentile(histo, olPercentiles[p]));
+        fprintf(fp, "        \"max\": %" PRIu64 "\n", histo->max);
+        fprintf(fp, "      }\n");
+        fprintf(fp, "    }");
+    }
+    fprintf(fp, "\n  }\n");
+    fprintf(fp, "}\n");
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "ldclt[%d]: Cannot write(%s), error=%d (%s)\n",
+                mctx.pid, mctx.olJsonFile, errno, strerror(errno));
+        return (-1);
+    }
+    return (0);
+}
+
+
+/* End of file */
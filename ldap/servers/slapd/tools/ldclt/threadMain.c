@@ -1004,6 +1004,20 @@ threadMain(
                 break;                                /*JLS 17-11-00*/
         }                                             /*JLS 17-11-00*/
 
+        /*
+     * Open loop mode: the request waits for its scheduled arrival and
+     * is chosen by the operations mix, not by the chain below.
+     */
+        if (mctx.mod2 & M2_OPEN_LOOP) {
+            if (doOpenLoopOper(tttctx) < 0) {
+                go = 0;
+                continue;
+            }
+            if (getThreadStatus(tttctx, &status) < 0)
+                break;
+            continue;
+        }
+
         /*
      * Do a LDAP request
      */
@@ -3470,8 +3470,12 @@ class DirSrv(SimpleLDAPObject, object):
             self.log.debug("Delete entry children %s", ent.dn)
             self.delete_ext_s(ent.dn, serverctrls=serverctrls, clientctrls=clientctrls, escapehatch='i am sure')
 
-    def backup_online(self, archive=None, db_type=None):
-        """Creates a backup of the database"""
+    def backup_online(self, archive=None, db_type=None, incremental=False):
+        """Creates a backup of the database
+
+        With incremental, only the data that changed since the previous
+        backup is copied (lmdb only, other databases do a full backup)
+        """
 
         if archive is None:
             # Use the instance name and date/time as the default backup name
@@ -3489,6 +3493,8 @@ class DirSrv(SimpleLDAPObject, object):
         task_properties = {'nsArchiveDir': archive}
         if db_type is not None:
             task_properties['nsDatabaseType'] = db_type
+        if incremental:
+            task_properties['nsIncremental'] = 'true'
         task.create(properties=task_properties)
 
         return task
@@ -542,7 +542,8 @@ class Backend(DSLdapObject):
         db_config = DatabaseConfig(self._instance)
         config_attrs = db_config.get()
 
-        mdb_only_attrs = ['nsslapd-mdb-max-size', 'nsslapd-mdb-max-readers', 'nsslapd-mdb-max-dbs']
+        mdb_only_attrs = ['nsslapd-mdb-max-size', 'nsslapd-mdb-max-readers', 'nsslapd-mdb-max-dbs',
+                          'nsslapd-mdb-group-commit-window', 'nsslapd-mdb-backup-max-throughput']
         bdb_only_attrs = ['nsslapd-dbcachesize',
                           'nsslapd-dbncache',
                           'nsslapd-db-logdirectory',
@@ -1147,6 +1148,8 @@ class DatabaseConfig(DSLdapObject):
             'nsslapd-serial-lock',
             'nsslapd-pagedlookthroughlimit',
             'nsslapd-pagedidlistscanlimit',
+            'nsslapd-pagedspillthreshold',
+            'nsslapd-subtreepath-index',
             'nsslapd-rangelookthroughlimit',
             'nsslapd-backend-opt-level',
             'nsslapd-backend-implement',
@@ -1184,6 +1187,8 @@ class DatabaseConfig(DSLdapObject):
                     'nsslapd-mdb-max-size',
                     'nsslapd-mdb-max-readers',
                     'nsslapd-mdb-max-dbs',
+                    'nsslapd-mdb-group-commit-window',
+                    'nsslapd-mdb-backup-max-throughput',
                 ]
         }
         self._create_objectclasses = ['top', 'extensibleObject']
@@ -61,6 +61,8 @@ arg_to_attr = {
         'exclude_from_export': 'nsslapd-exclude-from-export',
         'pagedlookthroughlimit': 'nsslapd-pagedlookthroughlimit',
         'pagedidlistscanlimit': 'nsslapd-pagedidlistscanlimit',
+        'pagedspillthreshold': 'nsslapd-pagedspillthreshold',
+        'subtreepath_index': 'nsslapd-subtreepath-index',
         'rangelookthroughlimit': 'nsslapd-rangelookthroughlimit',
         'backend_opt_level': 'nsslapd-backend-opt-level',
         'deadlock_policy': 'nsslapd-db-deadlock-policy',
@@ -69,6 +71,8 @@ arg_to_attr = {
         'mdb_max_size': 'nsslapd-mdb-max-size',
         'mdb_max_readers': 'nsslapd-mdb-max-readers',
         'mdb_max_dbs': 'nsslapd-mdb-max-dbs',
+        'mdb_group_commit_window': 'nsslapd-mdb-group-commit-window',
+        'mdb_backup_max_throughput': 'nsslapd-mdb-backup-max-throughput',
         # VLV attributes
         'search_base': 'vlvbase',
         'search_scope': 'vlvscope',
@@ -1077,6 +1081,11 @@ def create_parser(subparsers):
                                                                       'the simple paged results control')
     set_db_config_parser.add_argument('--pagedidlistscanlimit', help='Specifies the number of entry IDs that are searched, specifically, '
                                                                      'for a search operation using the simple paged results control.')
+    set_db_config_parser.add_argument('--pagedspillthreshold', help='Specifies the number of candidate entry IDs above which a search '
+                                                                    'using the simple paged results control keeps its candidates in a '
+                                                                    'file mapping instead of memory between pages. 0 disables it.')
+    set_db_config_parser.add_argument('--subtreepath-index', help='Set to "on" to maintain the subtreepath index, used by subtree searches '
+                                                                  'instead of the ancestorid index (requires a server restart)')
     set_db_config_parser.add_argument('--rangelookthroughlimit', help='Specifies the maximum number of entries that the server '
                                                                       'will check when examining candidate entries in response to a '
                                                                       'range search request.')
@@ -1088,6 +1097,10 @@ def create_parser(subparsers):
     set_db_config_parser.add_argument('--mdb-max-size', help='Sets the lmdb database maximum size (in bytes).')
     set_db_config_parser.add_argument('--mdb-max-readers', help='Sets the lmdb database maximum number of readers (Advanced setting)')
     set_db_config_parser.add_argument('--mdb-max-dbs', help='Sets the lmdb database maximum number of sub databases (Advanced setting)')
+    set_db_config_parser.add_argument('--mdb-group-commit-window', help='Sets how long (in milliseconds) an lmdb commit may wait for other '
+                                                                       'commits to share the same sync. 0 disables group commit (Advanced setting)')
+    set_db_config_parser.add_argument('--mdb-backup-max-throughput', help='Sets the maximum rate (in megabytes per second) at which an online '
+                                                                         'backup reads the lmdb database. 0 means unlimited')
 
 
     #######################################################
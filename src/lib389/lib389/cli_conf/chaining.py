@@ -36,6 +36,8 @@ arg_to_attr = {
         'response_delay': 'nsmaxresponsedelay',
         'test_response_delay': 'nsmaxtestresponsedelay',
         'use_starttls': 'nsusestarttls',
+        'multiplex': 'nsmultiplexoperations',
+        'inflight_limit': 'nsmaxoperationsinflight',
         'server_url': 'nsfarmserverurl',
         'bind_mech': 'nsbindmechanism',
         'bind_dn': 'nsmultiplexorbinddn',
@@ -277,6 +279,12 @@ def create_parser(subparsers):
                                        help="Sets the duration of the test issued by the database link to check whether "
                                             "the remote server is responding")
     def_config_set_parser.add_argument('--use-starttls', help="Configured that database links use StartTLS if set to \"on\"")
+    def_config_set_parser.add_argument('--multiplex',
+                                       help="If set to \"on\", a reader thread dispatches the results of each operation "
+                                            "connection, so that many operations can share it (see --op-limit)")
+    def_config_set_parser.add_argument('--inflight-limit',
+                                       help="Sets the maximum number of operations outstanding on the remote server. "
+                                            "\"0\" means no limit.")
 
     create_link_parser = subcommands.add_parser('link-create', add_help=False, conflict_handler='resolve',
                                                 parents=[def_config_set_parser],
@@ -19,7 +19,8 @@ arg_to_attr = {
     'exclude_subtree': 'uniqueness-exclude-subtrees',
     'across_all_subtrees': 'uniqueness-across-all-subtrees',
     'top_entry_oc': 'uniqueness-top-entry-oc',
-    'subtree_entries_oc': 'uniqueness-subtree-entries-oc'
+    'subtree_entries_oc': 'uniqueness-subtree-entries-oc',
+    'use_index': 'uniqueness-use-index'
 }
 
 PLUGIN_DN = "cn=plugins,cn=config"
@@ -139,6 +140,10 @@ def _add_parser_args(parser):
     parser.add_argument('--subtree-entries-oc',
                         help='Verifies if an attribute is unique, if the entry contains the object class '
                              'set in this parameter (uniqueness-subtree-entries-oc)')
+    parser.add_argument('--use-index', choices=['on', 'off'], type=str.lower,
+                        help='If enabled (on), the plug-in checks the values with lookups in the equality index '
+                             'of the attribute instead of internal searches. The plug-in must be of the betxnpreoperation '
+                             'type (uniqueness-use-index)')
 
 
 def create_parser(subparsers):
@@ -18,7 +18,8 @@ arg_to_attr = {
     'exclude_entry_scope': 'nsslapd-pluginExcludeEntryScope',
     'container_scope': 'nsslapd-pluginContainerScope',
     'config_entry': 'nsslapd-pluginConfigArea',
-    'log_file': 'referint-logfile'
+    'log_file': 'referint-logfile',
+    'batch_size': 'referint-batch-size'
 }
 
 
@@ -89,6 +90,10 @@ def _add_parser_args(parser):
     parser.add_argument('--log-file',
                         help='Specifies a path to the Referential integrity logfile.'
                              'For example: /var/log/dirsrv/slapd-YOUR_INSTANCE/referint')
+    parser.add_argument('--batch-size',
+                        help='Finds the references to a DN with a single search over all the membership attributes '
+                             'and updates each referencing entry with a single modify. The delayed updates are '
+                             'committed every batch-size modifies. 0 disables the batching (referint-batch-size)')
 
 
 def create_parser(subparsers):
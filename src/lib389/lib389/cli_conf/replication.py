@@ -40,7 +40,9 @@ arg_to_attr = {
         'replica_id': 'nsds5replicaid',
         'repl_purge_delay': 'nsds5replicapurgedelay',
         'repl_tombstone_purge_interval': 'nsds5replicatombstonepurgeinterval',
+        'repl_tombstone_reap_batch_size': 'nsds5ReplicaTombstoneReapBatchSize',
         'repl_fast_tombstone_purging': 'nsds5ReplicaPreciseTombstonePurging',
+        'repl_parallel_apply': 'nsds5ReplicaParallelApply',
         'repl_bind_group': 'nsds5replicabinddngroup',
         'repl_bind_group_interval': 'nsds5replicabinddngroupcheckinterval',
         'repl_protocol_timeout': 'nsds5replicaprotocoltimeout',
@@ -77,6 +79,9 @@ arg_to_attr = {
         'session_pause_time': 'nsds5replicaSessionPauseTime',
         'flow_control_window': 'nsds5replicaflowcontrolwindow',
         'flow_control_pause': 'nsds5replicaflowcontrolpause',
+        'total_update_streams': 'nsds5replicatotalupdatestreams',
+        'total_update_batch_size': 'nsds5replicatotalupdatebatchsize',
+        'total_update_method': 'nsds5replicatotalupdatemethod',
         # Additional Winsync Agmt attrs
         'win_subtree': 'nsds7windowsreplicasubtree',
         'ds_subtree': 'nsds7directoryreplicasubtree',
@@ -503,11 +508,20 @@ def get_repl_monitor_info(inst, basedn, log, args):
                 replica_id = replica["replica_id"]
                 replica_status = replica["replica_status"]
                 maxcsn = replica["maxcsn"]
+                parallel_apply = replica.get("parallel_apply")
+                tombstone_reap = replica.get("tombstone_reap")
                 if not args.json:
                     log.info(f"Replica Root: {replica_root}")
                     log.info(f"Replica ID: {replica_id}")
                     log.info(f"Replica Status: {replica_status}")
-                    log.info(f"Max CSN: {maxcsn}\n")
+                    log.info(f"Max CSN: {maxcsn}")
+                    if parallel_apply is not None:
+                        log.info(f"Parallel Apply: {parallel_apply['updates']} updates, "
+                                 f"{parallel_apply['average']} average, {parallel_apply['max']} max")
+                    if tombstone_reap is not None:
+                        log.info(f"Tombstone Reap: {tombstone_reap['purged']} purged, "
+                                 f"{tombstone_reap['rate']} per second, {tombstone_reap['backlog']} left")
+                    log.info("")
                 for agreement_status in replica["agmts_status"]:
                     if not args.json:
                         log.info(agreement_status)
@@ -1546,7 +1560,9 @@ def create_parser(subparsers):
     repl_set_parser.add_argument('--repl-del-ref', help="Removes a replication referral (for conusmers only)")
     repl_set_parser.add_argument('--repl-purge-delay', help="Sets the replication purge delay")
     repl_set_parser.add_argument('--repl-tombstone-purge-interval', help="Sets the interval in seconds to check for tombstones that can be purged")
+    repl_set_parser.add_argument('--repl-tombstone-reap-batch-size', help="Sets the maximum number of tombstones purged per backend transaction")
     repl_set_parser.add_argument('--repl-fast-tombstone-purging', help="Enables or disables improving the tombstone purging performance")
+    repl_set_parser.add_argument('--repl-parallel-apply', help="Enables or disables applying independent replicated updates in parallel")
     repl_set_parser.add_argument('--repl-bind-group', help="Sets a group entry DN containing members that are \"bind/supplier\" DNs")
     repl_set_parser.add_argument('--repl-bind-group-interval', help="Sets an interval in seconds to check if the bind group has been updated")
     repl_set_parser.add_argument('--repl-protocol-timeout', help="Sets a timeout in seconds on how long to wait before stopping "
@@ -1720,6 +1736,15 @@ def create_parser(subparsers):
     agmt_add_parser.add_argument('--flow-control-pause',
                                  help="Sets the time in milliseconds to pause after reaching the number of entries and "
                                       "updates set in \"--flow-control-window\"")
+    agmt_add_parser.add_argument('--total-update-streams',
+                                 help="Sets the number of connections a total update sends the entries over, when the "
+                                      "consumer supports it")
+    agmt_add_parser.add_argument('--total-update-batch-size',
+                                 help="Sets the number of entries a total update sends per extended operation, when the "
+                                      "consumer supports it")
+    agmt_add_parser.add_argument('--total-update-method', choices=['entries', 'snapshot'],
+                                 help="Sets how a total update sends the data: the entries, or a snapshot of the database "
+                                      "records when both servers use LMDB and have the same indexes")
     agmt_add_parser.add_argument('--bootstrap-bind-dn',
                                  help="Sets an optional bind DN the agreement can use to bootstrap initialization when "
                                       "bind groups are being used")
@@ -1764,6 +1789,15 @@ def create_parser(subparsers):
     agmt_set_parser.add_argument('--flow-control-pause',
                                  help="Sets the time in milliseconds to pause after reaching the number of entries and "
                                       "updates set in \"--flow-control-window\"")
+    agmt_set_parser.add_argument('--total-update-streams',
+                                 help="Sets the number of connections a total update sends the entries over, when the "
+                                      "consumer supports it")
+    agmt_set_parser.add_argument('--total-update-batch-size',
+                                 help="Sets the number of entries a total update sends per extended operation, when the "
+                                      "consumer supports it")
+    agmt_set_parser.add_argument('--total-update-method', choices=['entries', 'snapshot'],
+                                 help="Sets how a total update sends the data: the entries, or a snapshot of the database "
+                                      "records when both servers use LMDB and have the same indexes")
     agmt_set_parser.add_argument('--bootstrap-bind-dn',
                                  help="Sets an optional bind DN the agreement can use to bootstrap initialization when "
                                       "bind groups are being used")
@@ -7,6 +7,7 @@
 # --- END COPYRIGHT BLOCK ---
 
 import copy
+import shlex
 import psutil
 from lib389._constants import *
 from lib389._mapped_object import DSLdapObject
@@ -418,7 +419,11 @@ class MonitorChaining(DSLdapObject):
             'nsunbindcount',
             'nscomparecount',
             'nsopenopconnectioncount',
-            'nsopenbindconnectioncount'
+            'nsopenbindconnectioncount',
+            'nsoperationsinflight',
+            'nsoperationsinflightpeak',
+            'nsoperationsinflightwaitcount',
+            'nsfarmresponsetimehistogram'
         ]
         self._protected = False
 
@@ -470,6 +475,48 @@ class MonitorSNMP(DSLdapObject):
         return self.get_attrs_vals_utf8(self._snmp_keys)
 
 
+class MonitorLatency(DSLdapObject):
+    """A class for representing "cn=latency,cn=monitor" entry
+
+    Each read returns the latencies, in microseconds, recorded since
+    the previous read of the entry.
+    """
+
+    _summary_keys = ['count', 'avg', 'p50', 'p90', 'p99', 'p999', 'max']
+
+    def __init__(self, instance, dn=None):
+        super(MonitorLatency, self).__init__(instance=instance, dn=dn)
+        self._dn = "cn=latency,cn=monitor"
+
+    @staticmethod
+    def _parse_summary(value):
+        """Parse a 'name="x" count="1" ...' value into a dict"""
+        summary = {}
+        for field in shlex.split(value):
+            key, val = field.split('=', 1)
+            summary[key] = int(val) if key in MonitorLatency._summary_keys else val
+        return summary
+
+    def get_status(self, use_json=False):
+        """Get the latencies per operation type, backend and plugin
+
+        :returns: A dict with the 'operations', 'backends' and 'plugins' keys
+        """
+        # A single read, as each read starts a new window
+        attrs = {k.lower(): v for k, v in self.get_all_attrs_utf8().items()}
+        operations = {}
+        for op in ('bind', 'search', 'compare', 'add', 'delete', 'modify', 'modrdn', 'extended'):
+            operations[op] = {}
+            for time in ('waittime', 'optime'):
+                operations[op][time] = {k: int(attrs[f'{op}{time}{k}'][0])
+                                        for k in self._summary_keys}
+        return {
+            'operations': operations,
+            'backends': [self._parse_summary(v) for v in attrs.get('backendoptime', [])],
+            'plugins': [self._parse_summary(v) for v in attrs.get('plugincalltime', [])],
+        }
+
+
 class MonitorDiskSpace(DSLdapObject):
     """A class for representing "cn=disk space,cn=monitor" entry"""
 
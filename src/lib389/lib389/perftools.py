@@ -425,6 +425,62 @@ class PerformanceTools:
         res["rawresults"] = rawres[1:]   # Discard first measure
         return self.finalizeResult(res)
 
+    def ldclt_latency(self, measure_name, args, rate, nbThreads=10, nbMes=10, arrival="poisson"):
+        # Open loop measure: ldclt starts rate operations per second whatever
+        # the server response time and reports the latency percentiles
+        prog = os.path.join(self._instance.ds_paths.bin_dir, 'ldclt')
+        jsonfile = self.getFilePath(f"{measure_name}.json")
+        cmd = [ prog,
+            '-h',
+            f'{self._instance.host}',
+            '-p',
+            f'{self._instance.port}',
+            '-D',
+            f'{self._instance.binddn}',
+            '-w',
+            f'{self._instance.bindpw}',
+            '-N', str(nbMes),
+            '-n', str(nbThreads) ]
+        for key in args.keys():
+            cmd.append(str(key))
+            val = args[key]
+            if key == "-e":
+                val = f"{val},rate={rate},arrival={arrival},jsonresult={jsonfile}"
+            if (val):
+                cmd.append(str(val))
+        start_time = time.time()
+        tmout = 30+10*nbMes
+        print (f"Running ldclt with a timeout of {tmout} seconds ...\r")
+        result = subprocess.run(args=cmd, capture_output=True, timeout=tmout)
+        print (" Done.")
+        stop_time = time.time()
+        res = { "measure_name" : measure_name,
+                "cmd" : cmd,
+                "stdout" : result.stdout,
+                "stderr" : result.stderr,
+                "returncode" : result.returncode,
+                "start_time" : start_time,
+                "stop_time" : stop_time,
+                "nb_threads" : nbThreads,
+                **self.getEnvInfo() }
+        try:
+            with open(jsonfile) as f:
+                res["latency"] = json.load(f)
+            lat = res["latency"]["operations"]["all"]["latency_us"]
+            pretty_res = { key: res[key] for key in ( 'start_time', 'stop_time', 'measure_name', 'db_lib', 'nbUsers', 'nb_threads' ) }
+            pretty_res["target_rate"] = res["latency"]["target_rate"]
+            pretty_res["achieved_rate"] = res["latency"]["achieved_rate"]
+            for key in ( 'p50', 'p99', 'p99.9', 'max' ):
+                pretty_res[f"{key}_us"] = lat[key]
+        except (OSError, KeyError, ValueError) as e:
+            print(e)
+            res["exception"] = e
+            pretty_res = "#ERROR"
+        res["pretty"] = pretty_res
+        self.log("out", res["pretty"])
+        self.log("log", res)
+        return res
+
     def measure_search_by_uid(self, name, nb_threads = 1):
         nb_users = self._options['nbUsers']
         args  = { "-b" : self._users_parents_dn,
@@ -434,6 +490,15 @@ class PerformanceTools:
                   f"-R{nb_users-1}" : None }
         return self.ldclt(name, args, nbThreads=nb_threads)
 
+    def measure_search_by_uid_latency(self, name, nb_threads = 1):
+        nb_users = self._options['nbUsers']
+        args  = { "-b" : self._users_parents_dn,
+                  "-f" : "uid=XXXXXXXXXX",
+                  "-e" : "esearch,random",
+                  "-r0" : None,
+                  f"-R{nb_users-1}" : None }
+        return self.ldclt_latency(name, args, self._options.get('rate', 1000), nbThreads=nb_threads)
+
     # I wish I could make the base dn vary rather than use the dn in filter
     # but I did not find how to do that (the RDN trick as in modify
     #  generates the same search than measure_search_by_uid test)
@@ -548,6 +613,7 @@ class PerformanceTools:
         # List of test for which args.nb_threads is useful
         return { t.name() :  t for t in [
             PerformanceTools.Tester("search_uid", "Measure number of searches per seconds using filter with random existing uid.", "measure_search_by_uid"),
+            PerformanceTools.Tester("search_uid_latency", "Measure search latency percentiles at a fixed rate (open loop) using filter with random existing uid.", "measure_search_by_uid_latency"),
             PerformanceTools.Tester("search_uid_in_dn", "Measure number of searches per seconds using filter with random existing uid in dn (i.e: (uid:dn:uid_value)).", "measure_search_by_filtering_the_dn"),
             PerformanceTools.Tester("modify_sn", "Measure number of modify per seconds replacing sn by random value on random entries.", "measure_modify"),
             PerformanceTools.TesterImportExport(),
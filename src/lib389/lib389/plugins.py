@@ -175,6 +175,16 @@ class AttributeUniquenessPlugin(Plugin):
 
         self.set('uniqueness-across-all-subtrees', 'off')
 
+    def enable_index_lookup(self):
+        """Set uniqueness-use-index to on"""
+
+        self.set('uniqueness-use-index', 'on')
+
+    def disable_index_lookup(self):
+        """Set uniqueness-use-index to off"""
+
+        self.set('uniqueness-use-index', 'off')
+
 
 class AttributeUniquenessPlugins(DSLdapObjects):
     """A DSLdapObjects entity which represents Attribute Uniqueness plugin instances
@@ -520,6 +530,21 @@ class ReferentialIntegrityPlugin(Plugin):
 
         self.set('referint-update-delay', str(value))
 
+    def get_batch_size(self):
+        """Get referint-batch-size attribute"""
+
+        return self.get_attr_val_int('referint-batch-size')
+
+    def get_batch_size_formatted(self):
+        """Display referint-batch-size attribute"""
+
+        return self.display_attr('referint-batch-size')
+
+    def set_batch_size(self, value):
+        """Set referint-batch-size attribute"""
+
+        self.set('referint-batch-size', str(value))
+
     def get_log_file(self):
         """Get referint log file"""
 
@@ -2739,11 +2739,26 @@ class ReplicationMonitor(object):
                     agmts_status.append(json.loads(agmt.status(use_json=True, binddn=binddn, bindpw=bindpw)))
                 else:
                     agmts_status.append(agmt.status(binddn=binddn, bindpw=bindpw))
-            replicas_status.append({"replica_id": replica_id,
-                                    "replica_root": replica_root,
-                                    "replica_status": "Online",
-                                    "maxcsn": replica_maxcsn,
-                                    "agmts_status": agmts_status})
+            status = {"replica_id": replica_id,
+                      "replica_root": replica_root,
+                      "replica_status": "Online",
+                      "maxcsn": replica_maxcsn,
+                      "agmts_status": agmts_status}
+            # Only reported once updates were applied in parallel
+            updates = replica.get_attr_val_utf8('nsds5replicaParallelApplyUpdates')
+            if updates not in (None, '0'):
+                status["parallel_apply"] = {
+                    "updates": updates,
+                    "average": replica.get_attr_val_utf8('nsds5replicaParallelApplyAverage'),
+                    "max": replica.get_attr_val_utf8('nsds5replicaParallelApplyMax')}
+            # Only reported once tombstones were reaped
+            purged = replica.get_attr_val_utf8('nsds5replicaReapPurged')
+            if purged not in (None, '0'):
+                status["tombstone_reap"] = {
+                    "purged": purged,
+                    "rate": replica.get_attr_val_utf8('nsds5replicaReapRate'),
+                    "backlog": replica.get_attr_val_utf8('nsds5replicaReapBacklog')}
+            replicas_status.append(status)
         return replicas_status
 
     def generate_report(self, get_credentials, use_json=False):
@@ -0,0 +1,63 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#pragma once
+
+#include <config.h>
+#include <slapi-plugin.h>
+#include <inttypes.h>
+#include <stdint.h>
+
+/*
+ * Micro-benchmarks of the server hot primitives, built by "make bench".
+ *
+ * A benchmark is a function running the measured operation n times. The
+ * harness calibrates n so a sample lasts at least the sample time, and
+ * reports the min, median and max time per operation of the samples as
+ * JSON on stdout. The data are synthetic and generated from a fixed seed,
+ * so two runs of the same build measure the same work.
+ */
+
+typedef void (*bench_fn)(void *arg, uint64_t n);
+
+void bench_run(const char *name, bench_fn fn, void *arg);
+
+/* Defeats dead code elimination of results the benchmark ignores */
+extern volatile uint64_t bench_sink;
+
+/* Deterministic generators of synthetic data */
+typedef struct bench_rng
+{
+    uint64_t state;
+} BenchRng;
+
+void bench_rng_init(BenchRng *rng);
+uint64_t bench_rng_next(BenchRng *rng);
+uint64_t bench_rng_below(BenchRng *rng, uint64_t n);
+
+#define BENCH_SUFFIX "dc=example,dc=com"
+
+/* A dn of depth rdns under BENCH_SUFFIX, not normalized: mixed case, spaces */
+char *bench_gen_dn(BenchRng *rng, size_t depth);
+/* An inetOrgPerson user as ldif, id makes it unique */
+char *bench_gen_user_ldif(BenchRng *rng, uint64_t id);
+Slapi_Entry *bench_gen_user(BenchRng *rng, uint64_t id);
+
+/* Registers the syntaxes and attribute types of the generated entries */
+void bench_schema_init(void);
+
+/* The benchmarks, by area */
+void bench_idl(void);
+void bench_dn(void);
+void bench_entry(void);
+void bench_filter(void);
+void bench_syntax(void);
+void bench_cache(void);
+void bench_ber(void);
+void bench_counters(void);
+void bench_schema(void);
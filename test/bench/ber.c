@@ -0,0 +1,74 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <slap.h>
+
+#define BER_ENTRIES 256
+
+typedef struct ber_bench
+{
+    Slapi_PBlock *pb;
+    Slapi_Entry *entries[BER_ENTRIES];
+} BerBench;
+
+/*
+ * Encodes a search result entry with all its attributes, as
+ * send_ldap_search_entry_ext does before it flushes the ber to the
+ * connection. The operation is internal, so the access control of the
+ * attributes is skipped.
+ */
+static void
+ber_search_entry_bench(void *arg, uint64_t n)
+{
+    BerBench *b = (BerBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_Entry *e = b->entries[i % BER_ENTRIES];
+        BerElement *ber = der_alloc();
+        Slapi_Attr *a = NULL;
+
+        ber_printf(ber, "{it{s{", (ber_int_t)i, LDAP_RES_SEARCH_ENTRY, slapi_entry_get_dn_const(e));
+        for (slapi_entry_first_attr(e, &a); a; slapi_entry_next_attr(e, a, &a)) {
+            /* encode_attr frees the ber if it fails */
+            if (encode_attr(b->pb, ber, e, a, 0, NULL) != 0) {
+                ber = NULL;
+                break;
+            }
+        }
+        if (ber) {
+            bench_sink += ber_printf(ber, "}}}");
+            ber_free(ber, 1);
+        }
+    }
+}
+
+void
+bench_ber(void)
+{
+    BenchRng rng;
+    BerBench b;
+    Slapi_Operation *op = operation_new(OP_FLAG_INTERNAL);
+
+    bench_rng_init(&rng);
+    for (size_t i = 0; i < BER_ENTRIES; i++) {
+        b.entries[i] = bench_gen_user(&rng, i);
+    }
+    b.pb = slapi_pblock_new();
+    slapi_pblock_set(b.pb, SLAPI_OPERATION, op);
+
+    bench_run("ber_search_entry", ber_search_entry_bench, &b);
+
+    slapi_pblock_set(b.pb, SLAPI_OPERATION, NULL);
+    operation_free(&op, NULL);
+    slapi_pblock_destroy(b.pb);
+    for (size_t i = 0; i < BER_ENTRIES; i++) {
+        slapi_entry_free(b.entries[i]);
+    }
+}
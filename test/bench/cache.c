@@ -0,0 +1,119 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <back-ldbm.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CACHE_ENTRIES 10000
+#define CACHE_LOOKUPS 4096
+
+typedef struct cache_bench
+{
+    struct cache cache;
+    Slapi_Entry *entries[CACHE_ENTRIES];
+    ID lookups[CACHE_LOOKUPS];
+} CacheBench;
+
+static void
+cache_add_entry(struct cache *cache, Slapi_Entry *e, ID id)
+{
+    struct backentry *bep = backentry_init(e);
+
+    bep->ep_id = id;
+    if (cache_add(cache, bep, NULL) != 0) {
+        fprintf(stderr, "Failed to add the entry %u to the entry cache\n", id);
+        exit(1);
+    }
+    cache_return(cache, (void **)&bep);
+}
+
+static void
+cache_find_id_bench(void *arg, uint64_t n)
+{
+    CacheBench *b = (CacheBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        struct backentry *bep = cache_find_id(&b->cache, b->lookups[i % CACHE_LOOKUPS]);
+
+        bench_sink += (uintptr_t)bep;
+        cache_return(&b->cache, (void **)&bep);
+    }
+}
+
+static void
+cache_find_dn_bench(void *arg, uint64_t n)
+{
+    CacheBench *b = (CacheBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_Entry *e = b->entries[b->lookups[i % CACHE_LOOKUPS] - 1];
+        const Slapi_DN *sdn = slapi_entry_get_sdn_const(e);
+        struct backentry *bep = cache_find_dn(&b->cache, slapi_sdn_get_ndn(sdn),
+                                              slapi_sdn_get_ndn_len(sdn));
+
+        bench_sink += (uintptr_t)bep;
+        cache_return(&b->cache, (void **)&bep);
+    }
+}
+
+/*
+ * Adds to a full cache, each add evicts the least recently used entry.
+ * The cache owns and frees what it evicts, so each add is of a copy.
+ */
+static void
+cache_add_evict_bench(void *arg, uint64_t n)
+{
+    CacheBench *b = (CacheBench *)arg;
+    static uint64_t next = 0;
+
+    for (uint64_t i = 0; i < n; i++, next++) {
+        ID id = (ID)(next % CACHE_ENTRIES) + 1;
+
+        cache_add_entry(&b->cache, slapi_entry_dup(b->entries[id - 1]), id);
+    }
+}
+
+void
+bench_cache(void)
+{
+    BenchRng rng;
+    CacheBench *b = (CacheBench *)slapi_ch_calloc(1, sizeof(CacheBench));
+
+    bench_rng_init(&rng);
+    for (size_t i = 0; i < CACHE_ENTRIES; i++) {
+        b->entries[i] = bench_gen_user(&rng, i + 1);
+    }
+    for (size_t i = 0; i < CACHE_LOOKUPS; i++) {
+        b->lookups[i] = (ID)bench_rng_below(&rng, CACHE_ENTRIES) + 1;
+    }
+
+    /* All the entries fit in the cache */
+    cache_init(&b->cache, (uint64_t)1 << 32, -1, CACHE_TYPE_ENTRY);
+    for (size_t i = 0; i < CACHE_ENTRIES; i++) {
+        cache_add_entry(&b->cache, slapi_entry_dup(b->entries[i]), (ID)i + 1);
+    }
+    bench_run("cache_find_id", cache_find_id_bench, b);
+    bench_run("cache_find_dn", cache_find_dn_bench, b);
+
+    /*
+     * Half of the entries fit: adding the entries in a round robin adds
+     * each after its previous copy was evicted.
+     */
+    cache_clear(&b->cache, CACHE_TYPE_ENTRY);
+    cache_set_max_entries(&b->cache, CACHE_ENTRIES / 2);
+    bench_run("cache_add_evict", cache_add_evict_bench, b);
+
+    cache_destroy_please(&b->cache, CACHE_TYPE_ENTRY);
+    for (size_t i = 0; i < CACHE_ENTRIES; i++) {
+        slapi_entry_free(b->entries[i]);
+    }
+    slapi_ch_free((void **)&b);
+}
@@ -0,0 +1,78 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <slapi-private.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define COUNTERS_MAX_THREADS 64
+
+typedef struct counters_bench
+{
+    Slapi_Counter *counter;
+    int nb_threads;
+    uint64_t n;
+} CountersBench;
+
+static void *
+counters_increment_thread(void *arg)
+{
+    CountersBench *b = (CountersBench *)arg;
+
+    for (uint64_t i = 0; i < b->n; i++) {
+        slapi_counter_increment(b->counter);
+    }
+    return NULL;
+}
+
+/*
+ * Each of the threads increments the counter n times: an operation is one
+ * increment done concurrently by all the threads, so a counter that scales
+ * keeps the same time per operation as the threads are added.
+ */
+static void
+counters_increment_bench(void *arg, uint64_t n)
+{
+    CountersBench *b = (CountersBench *)arg;
+    pthread_t threads[COUNTERS_MAX_THREADS];
+
+    b->n = n;
+    for (int i = 0; i < b->nb_threads; i++) {
+        pthread_create(&threads[i], NULL, counters_increment_thread, b);
+    }
+    for (int i = 0; i < b->nb_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    bench_sink += slapi_counter_get_value(b->counter);
+}
+
+void
+bench_counters(void)
+{
+    CountersBench shared = {slapi_counter_new(), 0, 0};
+    CountersBench sharded = {slapi_counter_new_sharded(), 0, 0};
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    char name[64];
+
+    for (int nb_threads = 1; nb_threads <= COUNTERS_MAX_THREADS; nb_threads *= 2) {
+        shared.nb_threads = sharded.nb_threads = nb_threads;
+        snprintf(name, sizeof(name), "counters_shared_threads%d", nb_threads);
+        bench_run(name, counters_increment_bench, &shared);
+        snprintf(name, sizeof(name), "counters_sharded_threads%d", nb_threads);
+        bench_run(name, counters_increment_bench, &sharded);
+        if (nb_threads >= ncpus) {
+            break;
+        }
+    }
+
+    slapi_counter_destroy(&shared.counter);
+    slapi_counter_destroy(&sharded.counter);
+}
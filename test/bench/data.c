@@ -0,0 +1,127 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <slap.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The syntax plugins of libsyntax-plugin */
+int cis_init(Slapi_PBlock *pb);
+int ces_init(Slapi_PBlock *pb);
+int dn_init(Slapi_PBlock *pb);
+
+static const struct
+{
+    const char *name;
+    const char *oid;
+    const char *syntax;
+    const char *mr_equality;
+} bench_attrs[] = {
+    {"objectClass", "2.5.4.0", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"uid", "0.9.2342.19200300.100.1.1", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"cn", "2.5.4.3", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"sn", "2.5.4.4", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"givenName", "2.5.4.42", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"ou", "2.5.4.11", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"description", "2.5.4.13", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"telephoneNumber", "2.5.4.20", DIRSTRING_SYNTAX_OID, "caseIgnoreMatch"},
+    {"mail", "0.9.2342.19200300.100.1.3", IA5STRING_SYNTAX_OID, "caseIgnoreIA5Match"},
+    {"manager", "0.9.2342.19200300.100.1.10", DN_SYNTAX_OID, "distinguishedNameMatch"},
+};
+
+static const char *bench_words[] = {
+    "alpha", "Bravo", "charlie", "DELTA", "echo", "Foxtrot", "golf", "Hotel",
+    "india", "Juliet", "kilo", "LIMA", "mike", "November", "oscar", "Papa",
+};
+#define BENCH_NWORDS (sizeof(bench_words) / sizeof(bench_words[0]))
+
+void
+bench_schema_init(void)
+{
+    slapi_register_plugin("syntax", 1, "cis_init", cis_init,
+                          "Directory String Syntax", NULL, NULL);
+    slapi_register_plugin("syntax", 1, "ces_init", ces_init,
+                          "IA5String Syntax", NULL, NULL);
+    slapi_register_plugin("syntax", 1, "dn_init", dn_init,
+                          "Distinguished Name Syntax", NULL, NULL);
+
+    for (size_t i = 0; i < sizeof(bench_attrs) / sizeof(bench_attrs[0]); i++) {
+        if (slapi_add_internal_attr_syntax(bench_attrs[i].name, bench_attrs[i].oid,
+                                           bench_attrs[i].syntax, bench_attrs[i].mr_equality,
+                                           0) != LDAP_SUCCESS) {
+            fprintf(stderr, "Failed to add the attribute type %s\n", bench_attrs[i].name);
+            exit(1);
+        }
+    }
+}
+
+char *
+bench_gen_dn(BenchRng *rng, size_t depth)
+{
+    char *dn = slapi_ch_strdup(BENCH_SUFFIX);
+
+    for (size_t i = 0; i < depth; i++) {
+        const char *word = bench_words[bench_rng_below(rng, BENCH_NWORDS)];
+        char *parent = dn;
+
+        /* The first rdn is a multi-valued one, every other rdn has spaces */
+        if (i + 1 == depth) {
+            dn = slapi_ch_smprintf("CN=%s %" PRIu64 "+UID=u%" PRIu64 ",%s", word,
+                                   bench_rng_below(rng, 1000000), bench_rng_below(rng, 1000000), parent);
+        } else if (i % 2) {
+            dn = slapi_ch_smprintf("ou = %s ,%s", word, parent);
+        } else {
+            dn = slapi_ch_smprintf("OU=%s,%s", word, parent);
+        }
+        slapi_ch_free_string(&parent);
+    }
+    return dn;
+}
+
+char *
+bench_gen_user_ldif(BenchRng *rng, uint64_t id)
+{
+    const char *first = bench_words[bench_rng_below(rng, BENCH_NWORDS)];
+    const char *last = bench_words[bench_rng_below(rng, BENCH_NWORDS)];
+
+    return slapi_ch_smprintf("dn: uid=user%" PRIu64 ",ou=People," BENCH_SUFFIX "\n"
+                             "objectClass: top\n"
+                             "objectClass: person\n"
+                             "objectClass: organizationalPerson\n"
+                             "objectClass: inetOrgPerson\n"
+                             "uid: user%" PRIu64 "\n"
+                             "cn: %s %s\n"
+                             "sn: %s\n"
+                             "givenName: %s\n"
+                             "mail: user%" PRIu64 "@example.com\n"
+                             "telephoneNumber: +1 555 %04" PRIu64 "\n"
+                             "manager: uid=user%" PRIu64 ",ou=People," BENCH_SUFFIX "\n"
+                             "description: %s %s %s %s\n",
+                             id, id, first, last, last, first, id,
+                             bench_rng_below(rng, 10000), bench_rng_below(rng, id + 1),
+                             bench_words[bench_rng_below(rng, BENCH_NWORDS)],
+                             bench_words[bench_rng_below(rng, BENCH_NWORDS)],
+                             bench_words[bench_rng_below(rng, BENCH_NWORDS)],
+                             bench_words[bench_rng_below(rng, BENCH_NWORDS)]);
+}
+
+Slapi_Entry *
+bench_gen_user(BenchRng *rng, uint64_t id)
+{
+    char *ldif = bench_gen_user_ldif(rng, id);
+    Slapi_Entry *e = slapi_str2entry(ldif, 0);
+
+    if (e == NULL) {
+        fprintf(stderr, "Failed to parse the generated entry %" PRIu64 "\n", id);
+        exit(1);
+    }
+    slapi_ch_free_string(&ldif);
+    return e;
+}
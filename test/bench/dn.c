@@ -0,0 +1,80 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <stdio.h>
+
+#define DN_COUNT 1024
+
+typedef struct dn_bench
+{
+    char *dns[DN_COUNT];
+} DnBench;
+
+static void
+dn_normalize_bench(void *arg, uint64_t n)
+{
+    DnBench *b = (DnBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        char *src = b->dns[i % DN_COUNT];
+        char *dest = NULL;
+        size_t dest_len = 0;
+        int rc = slapi_dn_normalize_ext(src, 0, &dest, &dest_len);
+
+        bench_sink += dest_len;
+        if (rc > 0) {
+            slapi_ch_free_string(&dest);
+        }
+    }
+}
+
+/* Normalization and case folding, as done for the target dn of an operation */
+static void
+dn_sdn_ndn_bench(void *arg, uint64_t n)
+{
+    DnBench *b = (DnBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_DN *sdn = slapi_sdn_new_dn_byref(b->dns[i % DN_COUNT]);
+
+        bench_sink += slapi_sdn_get_ndn_len(sdn);
+        slapi_sdn_free(&sdn);
+    }
+}
+
+static void
+dn_bench_depth(BenchRng *rng, size_t depth)
+{
+    DnBench b;
+    char name[64];
+
+    for (size_t i = 0; i < DN_COUNT; i++) {
+        b.dns[i] = bench_gen_dn(rng, depth);
+    }
+
+    snprintf(name, sizeof(name), "dn_normalize_depth%zu", depth);
+    bench_run(name, dn_normalize_bench, &b);
+    snprintf(name, sizeof(name), "dn_sdn_ndn_depth%zu", depth);
+    bench_run(name, dn_sdn_ndn_bench, &b);
+
+    for (size_t i = 0; i < DN_COUNT; i++) {
+        slapi_ch_free_string(&b.dns[i]);
+    }
+}
+
+void
+bench_dn(void)
+{
+    BenchRng rng;
+
+    bench_rng_init(&rng);
+    dn_bench_depth(&rng, 3);
+    dn_bench_depth(&rng, 8);
+}
@@ -0,0 +1,94 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <string.h>
+
+#define ENTRY_COUNT 256
+
+typedef struct entry_bench
+{
+    char *ldifs[ENTRY_COUNT];
+    Slapi_Entry *entries[ENTRY_COUNT];
+    char *buf;
+} EntryBench;
+
+/*
+ * str2entry parses the ldif in place, so each run parses a copy: a memcpy
+ * of a few hundred bytes, small next to the parsing.
+ */
+static void
+entry_str2entry_bench(void *arg, uint64_t n)
+{
+    EntryBench *b = (EntryBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_Entry *e = NULL;
+
+        strcpy(b->buf, b->ldifs[i % ENTRY_COUNT]);
+        e = slapi_str2entry(b->buf, 0);
+        bench_sink += (uintptr_t)e;
+        slapi_entry_free(e);
+    }
+}
+
+static void
+entry_entry2str_bench(void *arg, uint64_t n)
+{
+    EntryBench *b = (EntryBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        int len = 0;
+        char *ldif = slapi_entry2str(b->entries[i % ENTRY_COUNT], &len);
+
+        bench_sink += len;
+        slapi_ch_free_string(&ldif);
+    }
+}
+
+static void
+entry_dup_bench(void *arg, uint64_t n)
+{
+    EntryBench *b = (EntryBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_Entry *e = slapi_entry_dup(b->entries[i % ENTRY_COUNT]);
+
+        bench_sink += (uintptr_t)e;
+        slapi_entry_free(e);
+    }
+}
+
+void
+bench_entry(void)
+{
+    BenchRng rng;
+    EntryBench b;
+    size_t maxlen = 0;
+
+    bench_rng_init(&rng);
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        b.ldifs[i] = bench_gen_user_ldif(&rng, i);
+        b.entries[i] = bench_gen_user(&rng, i);
+        if (strlen(b.ldifs[i]) > maxlen) {
+            maxlen = strlen(b.ldifs[i]);
+        }
+    }
+    b.buf = slapi_ch_malloc(maxlen + 1);
+
+    bench_run("entry_str2entry", entry_str2entry_bench, &b);
+    bench_run("entry_entry2str", entry_entry2str_bench, &b);
+    bench_run("entry_dup", entry_dup_bench, &b);
+
+    for (size_t i = 0; i < ENTRY_COUNT; i++) {
+        slapi_ch_free_string(&b.ldifs[i]);
+        slapi_entry_free(b.entries[i]);
+    }
+    slapi_ch_free_string(&b.buf);
+}
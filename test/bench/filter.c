@@ -0,0 +1,94 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FILTER_ENTRIES 256
+
+typedef struct filter_bench
+{
+    Slapi_Entry *entries[FILTER_ENTRIES];
+    Slapi_Filter *filter;
+} FilterBench;
+
+static const struct
+{
+    const char *name;
+    const char *filter;
+} filters[] = {
+    {"filter_test_eq", "(uid=user42)"},
+    {"filter_test_and", "(&(objectClass=inetOrgPerson)(uid=user42))"},
+    {"filter_test_or", "(|(cn=alpha bravo)(sn=delta)(givenName=echo))"},
+    {"filter_test_sub", "(description=*golf*)"},
+    {"filter_test_pres", "(&(objectClass=person)(mail=*)(telephoneNumber=*))"},
+    {"filter_test_dn", "(manager=UID=user7, ou=people, dc=EXAMPLE,dc=com)"},
+    {"filter_test_not", "(&(objectClass=person)(!(sn=kilo)))"},
+};
+
+/* Tests the filter against each entry, as a search does for its candidates */
+static void
+filter_test_bench(void *arg, uint64_t n)
+{
+    FilterBench *b = (FilterBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        bench_sink += slapi_filter_test_simple(b->entries[i % FILTER_ENTRIES], b->filter);
+    }
+}
+
+static void
+filter_parse_bench(void *arg, uint64_t n)
+{
+    const char *str = (const char *)arg;
+    char buf[256];
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_Filter *f = NULL;
+
+        /* str2filter parses in place */
+        snprintf(buf, sizeof(buf), "%s", str);
+        f = slapi_str2filter(buf);
+        bench_sink += (uintptr_t)f;
+        slapi_filter_free(f, 1);
+    }
+}
+
+void
+bench_filter(void)
+{
+    BenchRng rng;
+    FilterBench b;
+
+    bench_rng_init(&rng);
+    for (size_t i = 0; i < FILTER_ENTRIES; i++) {
+        b.entries[i] = bench_gen_user(&rng, i);
+    }
+
+    for (size_t i = 0; i < sizeof(filters) / sizeof(filters[0]); i++) {
+        char *str = slapi_ch_strdup(filters[i].filter);
+
+        b.filter = slapi_str2filter(str);
+        if (b.filter == NULL) {
+            fprintf(stderr, "Failed to parse the filter %s\n", filters[i].filter);
+            exit(1);
+        }
+        /* As ldbm_search does once per search, not per candidate */
+        slapi_filter_normalize(b.filter, PR_TRUE);
+        bench_run(filters[i].name, filter_test_bench, &b);
+        slapi_filter_free(b.filter, 1);
+        slapi_ch_free_string(&str);
+    }
+    bench_run("filter_parse_and", filter_parse_bench, (void *)filters[1].filter);
+
+    for (size_t i = 0; i < FILTER_ENTRIES; i++) {
+        slapi_entry_free(b.entries[i]);
+    }
+}
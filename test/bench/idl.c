@@ -0,0 +1,106 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <back-ldbm.h>
+#include <string.h>
+
+#define IDL_MAX_LISTS 4
+
+typedef struct idl_bench
+{
+    IDList *idls[IDL_MAX_LISTS];
+    size_t nidls;
+    int intersect;
+} IdlBench;
+
+/* A sorted list of nids ids spread over [1, range] */
+static IDList *
+idl_gen(BenchRng *rng, NIDS nids, ID range)
+{
+    IDList *idl = idl_alloc(nids);
+    ID id = 0;
+    ID step = range / nids;
+
+    for (NIDS i = 0; i < nids; i++) {
+        id += 1 + bench_rng_below(rng, 2 * step);
+        idl_append(idl, id);
+    }
+    return idl;
+}
+
+static IDList *
+idl_copy(IDList *idl)
+{
+    IDList *copy = idl_alloc(idl->b_nmax);
+
+    copy->b_nids = idl->b_nids;
+    memcpy(copy->b_ids, idl->b_ids, idl->b_nids * sizeof(ID));
+    return copy;
+}
+
+/*
+ * The set consumes its lists, so each run works on copies: a memcpy of
+ * the lists, small next to the k-way merge.
+ */
+static void
+idl_set_bench(void *arg, uint64_t n)
+{
+    IdlBench *b = (IdlBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        IDListSet *set = idl_set_create();
+        IDList *result = NULL;
+
+        for (size_t j = 0; j < b->nidls; j++) {
+            idl_set_insert_idl(set, idl_copy(b->idls[j]));
+        }
+        /* The lists are never ALLIDS, so the backend is not used */
+        result = b->intersect ? idl_set_intersect(set, NULL) : idl_set_union(set, NULL);
+        bench_sink += IDL_NIDS(result);
+        idl_free(&result);
+        idl_set_destroy(set);
+    }
+}
+
+static void
+idl_bench_free(IdlBench *b)
+{
+    for (size_t j = 0; j < b->nidls; j++) {
+        idl_free(&b->idls[j]);
+    }
+}
+
+void
+bench_idl(void)
+{
+    BenchRng rng;
+    IdlBench b = {0};
+
+    bench_rng_init(&rng);
+
+    /* Four lists of 10000 ids among 100000 entries, as (|(a=x)(b=y)...) */
+    b.nidls = 4;
+    for (size_t j = 0; j < b.nidls; j++) {
+        b.idls[j] = idl_gen(&rng, 10000, 100000);
+    }
+    b.intersect = 0;
+    bench_run("idl_set_union_4x10000", idl_set_bench, &b);
+    b.intersect = 1;
+    bench_run("idl_set_intersect_4x10000", idl_set_bench, &b);
+    idl_bench_free(&b);
+
+    /* A selective term and an unselective one, as (&(uid=x)(objectclass=person)) */
+    b.nidls = 2;
+    b.idls[0] = idl_gen(&rng, 100, 100000);
+    b.idls[1] = idl_gen(&rng, 90000, 100000);
+    b.intersect = 1;
+    bench_run("idl_set_intersect_100x90000", idl_set_bench, &b);
+    idl_bench_free(&b);
+}
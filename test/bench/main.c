@@ -0,0 +1,224 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <getopt.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <nspr.h>
+
+#define BENCH_DEFAULT_SAMPLES 9
+#define BENCH_MAX_SAMPLES 101
+#define BENCH_DEFAULT_SAMPLE_MS 20
+
+typedef struct bench_result
+{
+    char *name;
+    uint64_t iterations;
+    double min;
+    double median;
+    double max;
+} BenchResult;
+
+static struct
+{
+    uint64_t seed;
+    uint32_t samples;
+    uint64_t sample_ns;
+    const char *only;
+    int cpu;
+    BenchResult *results;
+    size_t nresults;
+} bench = {
+    .seed = 1,
+    .samples = BENCH_DEFAULT_SAMPLES,
+    .sample_ns = BENCH_DEFAULT_SAMPLE_MS * 1000000ULL,
+    .cpu = -1,
+};
+
+volatile uint64_t bench_sink;
+
+static uint64_t
+bench_time_ns(bench_fn fn, void *arg, uint64_t n)
+{
+    struct timespec start;
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fn(arg, n);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec;
+}
+
+static int
+bench_cmp_double(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+
+    return (da > db) - (da < db);
+}
+
+void
+bench_run(const char *name, bench_fn fn, void *arg)
+{
+    double per_op[BENCH_MAX_SAMPLES];
+    BenchResult *r = NULL;
+    uint64_t n = 1;
+    uint64_t elapsed = 0;
+
+    if (bench.only && strncmp(name, bench.only, strlen(bench.only)) != 0) {
+        return;
+    }
+
+    /* Warm up the caches, then double n until a run lasts a sample */
+    fn(arg, 1);
+    while ((elapsed = bench_time_ns(fn, arg, n)) < bench.sample_ns) {
+        n *= 2;
+    }
+
+    for (uint32_t i = 0; i < bench.samples; i++) {
+        per_op[i] = (double)bench_time_ns(fn, arg, n) / n;
+    }
+    qsort(per_op, bench.samples, sizeof(double), bench_cmp_double);
+
+    bench.results = (BenchResult *)slapi_ch_realloc((char *)bench.results,
+                                                    (bench.nresults + 1) * sizeof(BenchResult));
+    r = &bench.results[bench.nresults++];
+    r->name = slapi_ch_strdup(name);
+    r->iterations = n;
+    r->min = per_op[0];
+    r->median = per_op[bench.samples / 2];
+    r->max = per_op[bench.samples - 1];
+
+    fprintf(stderr, "%-40s %12.1f ns/op (min %.1f, max %.1f, %" PRIu64 " ops/sample)\n",
+            r->name, r->median, r->min, r->max, r->iterations);
+}
+
+static void
+bench_print_json(void)
+{
+    printf("{\n");
+    printf("  \"version\": \"%s\",\n", PACKAGE_VERSION);
+    printf("  \"seed\": %" PRIu64 ",\n", bench.seed);
+    printf("  \"samples\": %" PRIu32 ",\n", bench.samples);
+    printf("  \"sample_ns\": %" PRIu64 ",\n", bench.sample_ns);
+    printf("  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("  \"cpu\": %d,\n", bench.cpu);
+    printf("  \"results\": [");
+    for (size_t i = 0; i < bench.nresults; i++) {
+        BenchResult *r = &bench.results[i];
+        printf("%s\n    {\"name\": \"%s\", \"iterations\": %" PRIu64 ", "
+               "\"ns_per_op\": {\"min\": %.2f, \"median\": %.2f, \"max\": %.2f}}",
+               i ? "," : "", r->name, r->iterations, r->min, r->median, r->max);
+    }
+    printf("\n  ]\n}\n");
+}
+
+/* Same seed, same data: the rng is a splitmix64 */
+void
+bench_rng_init(BenchRng *rng)
+{
+    rng->state = bench.seed;
+}
+
+uint64_t
+bench_rng_next(BenchRng *rng)
+{
+    uint64_t z = (rng->state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t
+bench_rng_below(BenchRng *rng, uint64_t n)
+{
+    return bench_rng_next(rng) % n;
+}
+
+static void
+bench_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [-o prefix] [-n samples] [-t sample_ms] [-s seed] [-c cpu]\n"
+            "  -o  only run the benchmarks whose name starts with prefix\n"
+            "  -n  samples per benchmark (default %d, max %d)\n"
+            "  -t  minimal duration of a sample in ms (default %d)\n"
+            "  -s  seed of the synthetic data (default 1)\n"
+            "  -c  pin the benchmarks to this cpu\n"
+            "The results are printed as JSON on stdout.\n",
+            prog, BENCH_DEFAULT_SAMPLES, BENCH_MAX_SAMPLES, BENCH_DEFAULT_SAMPLE_MS);
+}
+
+int
+main(int argc, char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:n:t:s:c:h")) != -1) {
+        switch (opt) {
+        case 'o':
+            bench.only = optarg;
+            break;
+        case 'n':
+            bench.samples = (uint32_t)atoi(optarg);
+            break;
+        case 't':
+            bench.sample_ns = strtoull(optarg, NULL, 10) * 1000000ULL;
+            break;
+        case 's':
+            bench.seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'c':
+            bench.cpu = atoi(optarg);
+            break;
+        default:
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (bench.samples == 0 || bench.samples > BENCH_MAX_SAMPLES) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    if (bench.cpu >= 0) {
+        cpu_set_t set;
+
+        CPU_ZERO(&set);
+        CPU_SET(bench.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            perror("sched_setaffinity");
+            return 1;
+        }
+    }
+
+    bench_schema_init();
+
+    bench_idl();
+    bench_dn();
+    bench_entry();
+    bench_filter();
+    bench_syntax();
+    bench_cache();
+    bench_ber();
+    bench_counters();
+    bench_schema();
+
+    bench_print_json();
+
+    PR_Cleanup();
+    return 0;
+}
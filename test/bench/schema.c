@@ -0,0 +1,81 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <slap.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define SCHEMA_MAX_THREADS 16
+
+static const char *schema_names[] = {
+    "cn", "SN", "mail", "uid", "givenName", "ou", "Description", "objectclass",
+};
+#define SCHEMA_NNAMES (sizeof(schema_names) / sizeof(schema_names[0]))
+
+typedef struct schema_bench
+{
+    int nb_threads;
+    uint64_t n;
+} SchemaBench;
+
+static void *
+schema_lookup_thread(void *arg)
+{
+    SchemaBench *b = (SchemaBench *)arg;
+    uint64_t found = 0;
+
+    for (uint64_t i = 0; i < b->n; i++) {
+        struct asyntaxinfo *asi = attr_syntax_get_by_name(schema_names[i % SCHEMA_NNAMES], 0);
+
+        found += asi != NULL;
+        attr_syntax_return(asi);
+    }
+    bench_sink += found;
+    return NULL;
+}
+
+/*
+ * Each of the threads looks an attribute type up n times, as done for
+ * every attribute of a decoded entry: the readers of the schema share no
+ * lock, so the time per operation should stay the same as the threads are
+ * added.
+ */
+static void
+schema_lookup_bench(void *arg, uint64_t n)
+{
+    SchemaBench *b = (SchemaBench *)arg;
+    pthread_t threads[SCHEMA_MAX_THREADS];
+
+    b->n = n;
+    for (int i = 0; i < b->nb_threads; i++) {
+        pthread_create(&threads[i], NULL, schema_lookup_thread, b);
+    }
+    for (int i = 0; i < b->nb_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+void
+bench_schema(void)
+{
+    SchemaBench b = {0};
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    char name[64];
+
+    for (int nb_threads = 1; nb_threads <= SCHEMA_MAX_THREADS; nb_threads *= 2) {
+        b.nb_threads = nb_threads;
+        snprintf(name, sizeof(name), "schema_lookup_threads%d", nb_threads);
+        bench_run(name, schema_lookup_bench, &b);
+        if (nb_threads >= ncpus) {
+            break;
+        }
+    }
+}
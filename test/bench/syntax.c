@@ -0,0 +1,99 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "bench.h"
+
+#include <slap.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SYNTAX_VALUES 256
+#define SYNTAX_VALUE_MAX 256
+
+typedef struct syntax_bench
+{
+    Slapi_Attr *attr;
+    char *values[SYNTAX_VALUES];
+    Slapi_Value **svalues[SYNTAX_VALUES];
+    char buf[SYNTAX_VALUE_MAX];
+} SyntaxBench;
+
+/* Normalizes in place, so each run normalizes a copy */
+static void
+syntax_normalize_bench(void *arg, uint64_t n)
+{
+    SyntaxBench *b = (SyntaxBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        char *norm = NULL;
+
+        strcpy(b->buf, b->values[i % SYNTAX_VALUES]);
+        slapi_attr_value_normalize(NULL, b->attr, NULL, b->buf, 1, &norm);
+        bench_sink += (uintptr_t)norm + b->buf[0];
+        slapi_ch_free_string(&norm);
+    }
+}
+
+/* The equality index keys of a value, as computed on each add and modify */
+static void
+syntax_values2keys_bench(void *arg, uint64_t n)
+{
+    SyntaxBench *b = (SyntaxBench *)arg;
+
+    for (uint64_t i = 0; i < n; i++) {
+        Slapi_Value **keys = NULL;
+
+        slapi_attr_values2keys_sv(b->attr, b->svalues[i % SYNTAX_VALUES], &keys,
+                                  LDAP_FILTER_EQUALITY);
+        bench_sink += (uintptr_t)keys;
+        valuearray_free(&keys);
+    }
+}
+
+static void
+syntax_bench_type(BenchRng *rng, const char *type, const char *format)
+{
+    SyntaxBench b;
+    char name[64];
+
+    b.attr = slapi_attr_new();
+    slapi_attr_init(b.attr, type);
+    for (size_t i = 0; i < SYNTAX_VALUES; i++) {
+        Slapi_Value *v = NULL;
+
+        /* The format has a dn or a few words, mixed case, extra spaces */
+        b.values[i] = slapi_ch_smprintf(format, bench_rng_below(rng, 1000000),
+                                         bench_rng_below(rng, 1000));
+        v = slapi_value_new_string(b.values[i]);
+        b.svalues[i] = NULL;
+        valuearray_add_value(&b.svalues[i], v);
+        slapi_value_free(&v);
+    }
+
+    snprintf(name, sizeof(name), "syntax_normalize_%s", type);
+    bench_run(name, syntax_normalize_bench, &b);
+    snprintf(name, sizeof(name), "syntax_values2keys_%s", type);
+    bench_run(name, syntax_values2keys_bench, &b);
+
+    for (size_t i = 0; i < SYNTAX_VALUES; i++) {
+        slapi_ch_free_string(&b.values[i]);
+        valuearray_free(&b.svalues[i]);
+    }
+    slapi_attr_free(&b.attr);
+}
+
+void
+bench_syntax(void)
+{
+    BenchRng rng;
+
+    bench_rng_init(&rng);
+    syntax_bench_type(&rng, "cn", "  Some   User  %" PRIu64 "  Of  Group %" PRIu64 " ");
+    syntax_bench_type(&rng, "mail", "First.Last%" PRIu64 "@Sub%" PRIu64 ".Example.COM");
+    syntax_bench_type(&rng, "manager", "UID=user%" PRIu64 " , OU=Group %" PRIu64 ", dc=Example,DC=com");
+}
@@ -0,0 +1,89 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "../../test_slapd.h"
+
+#include <slap.h>
+#include <slapi-private.h>
+
+/* more attributes than needed for the entry to index them */
+#define ATTRLIST_NB_TYPES 32
+
+static Slapi_Attr *
+attrlist_entry_find(const Slapi_Entry *e, const char *type)
+{
+    Slapi_Attr *a = NULL;
+
+    if (slapi_entry_attr_find(e, type, &a) != 0) {
+        return NULL;
+    }
+    return a;
+}
+
+void
+test_libslapd_entry_attrs_index(void **state __attribute__((unused)))
+{
+    Slapi_Entry *e = slapi_entry_alloc();
+    char names[ATTRLIST_NB_TYPES][32];
+    char upper[32];
+    Slapi_Attr *a = NULL;
+    Slapi_Value *vals[2] = {0};
+    struct berval bv = {5, "value"};
+    struct berval *bvals[2] = {&bv, NULL};
+
+    slapi_entry_init(e, slapi_ch_strdup("cn=test,dc=example,dc=com"), NULL);
+    for (size_t i = 0; i < ATTRLIST_NB_TYPES; i++) {
+        snprintf(names[i], sizeof(names[i]), "test_attrlist_%zu", i);
+        slapi_entry_add_string(e, names[i], "value");
+    }
+    slapi_entry_add_string(e, "test_attrlist_3;lang-en", "value");
+
+    /* Lookups are case insensitive, and keep options apart */
+    for (size_t i = 0; i < ATTRLIST_NB_TYPES; i++) {
+        a = attrlist_entry_find(e, names[i]);
+        assert_non_null(a);
+        assert_string_equal(a->a_type, names[i]);
+
+        for (size_t j = 0; names[i][j] != '\0'; j++) {
+            upper[j] = toupper(names[i][j]);
+            upper[j + 1] = '\0';
+        }
+        assert_ptr_equal(attrlist_entry_find(e, upper), a);
+    }
+    assert_string_equal(attrlist_entry_find(e, "TEST_ATTRLIST_3;LANG-EN")->a_type, "test_attrlist_3;lang-en");
+    assert_null(attrlist_entry_find(e, "test_attrlist_missing"));
+
+    /* Every change of the attribute list is seen by the next lookup */
+    assert_int_equal(slapi_entry_attr_delete(e, "TEST_ATTRLIST_0"), 0);
+    assert_null(attrlist_entry_find(e, "test_attrlist_0"));
+    assert_int_equal(slapi_entry_attr_delete(e, "test_attrlist_0"), 1);
+
+    slapi_entry_add_string(e, "test_attrlist_new", "value");
+    assert_non_null(attrlist_entry_find(e, "Test_Attrlist_New"));
+
+    vals[0] = slapi_value_new_string("merged");
+    slapi_entry_attr_merge_sv(e, "test_attrlist_merged", vals);
+    assert_non_null(attrlist_entry_find(e, "test_attrlist_merged"));
+    slapi_value_free(&vals[0]);
+
+    vals[0] = slapi_value_new_string("replaced");
+    slapi_entry_attr_replace_sv(e, "test_attrlist_1", vals);
+    assert_true(slapi_entry_attr_hasvalue(e, "TEST_ATTRLIST_1", "replaced"));
+    slapi_value_free(&vals[0]);
+    entry_replace_values(e, "test_attrlist_replaced", bvals);
+    assert_non_null(attrlist_entry_find(e, "test_attrlist_replaced"));
+
+    assert_int_equal(slapi_entry_delete_string(e, "test_attrlist_2", "value"), 0);
+    assert_null(attrlist_entry_find(e, "test_attrlist_2"));
+
+    assert_non_null(attrlist_entry_find(e, "test_attrlist_3"));
+    assert_non_null(attrlist_entry_find(e, "test_attrlist_3;lang-en"));
+    assert_non_null(attrlist_entry_find(e, names[ATTRLIST_NB_TYPES - 1]));
+
+    slapi_entry_free(e);
+}
@@ -0,0 +1,111 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "../../test_slapd.h"
+
+#include <slap.h>
+#include <proto-slap.h>
+
+#define EVENTQ_NB_ONCE 64
+
+/*
+ * The wheel is driven by a fake clock, in ms, and the expired events
+ * run from the test thread: nothing depends on the scheduling.
+ * The wheel starts at 999700 ms, so an event due at 1000 s (1000000 ms)
+ * is in the second level, which is cascaded at 999936 ms.
+ */
+static uint64_t eventq_now = 999700;
+
+static uint64_t
+eventq_clock(void)
+{
+    return eventq_now;
+}
+
+static void
+eventq_count(time_t when __attribute__((unused)), void *arg)
+{
+    uint64_t *calls = arg;
+
+    (*calls)++;
+}
+
+void
+test_libslapd_eventq_timing_wheel(void **state __attribute__((unused)))
+{
+    uint64_t once[EVENTQ_NB_ONCE] = {0};
+    uint64_t second = 0;
+    uint64_t repeat = 0;
+    uint64_t later = 0;
+    uint64_t cancelled = 0;
+    Slapi_Eq_Context once_ctx, second_ctx, repeat_ctx, later_ctx, cancelled_ctx;
+
+    eq_set_clock_rel(eventq_clock);
+    eq_init_rel();
+
+    /* Events already expired, due in the second level, an hour later,
+     * a repeating one, and one cancelled before it ran */
+    for (size_t i = 0; i < EVENTQ_NB_ONCE; i++) {
+        once_ctx = slapi_eq_once_rel(eventq_count, &once[i], 999);
+        assert_non_null(once_ctx);
+    }
+    second_ctx = slapi_eq_once_rel(eventq_count, &second, 1000);
+    later_ctx = slapi_eq_once_rel(eventq_count, &later, 4600);
+    repeat_ctx = slapi_eq_repeat_rel(eventq_count, &repeat, 999, 1050);
+    cancelled_ctx = slapi_eq_once_rel(eventq_count, &cancelled, 999);
+    assert_ptr_equal(slapi_eq_get_arg_rel(later_ctx), &later);
+    assert_int_equal(slapi_eq_cancel_rel(cancelled_ctx), 1);
+    assert_null(slapi_eq_get_arg_rel(cancelled_ctx));
+
+    /* The expired events run once. The repeating one is requeued at
+     * 1000050 ms in the first level, but the second level is cascaded
+     * first, and holds an event due before it */
+    eventq_now = 999800;
+    assert_int_equal(eq_run_expired_rel(), 999936);
+    for (size_t i = 0; i < EVENTQ_NB_ONCE; i++) {
+        assert_int_equal(once[i], 1);
+    }
+    assert_int_equal(repeat, 1);
+    assert_int_equal(second, 0);
+    assert_int_equal(later, 0);
+    assert_int_equal(cancelled, 0);
+
+    /* Once cascaded, the event fires on time */
+    eventq_now = 999936;
+    assert_int_equal(eq_run_expired_rel(), 1000000);
+    assert_int_equal(second, 0);
+    eventq_now = 1000000;
+    assert_int_equal(eq_run_expired_rel(), 1000050);
+    assert_int_equal(second, 1);
+
+    /* The repeating event fires at its interval, and does not catch up
+     * with the schedules it missed */
+    eventq_now = 1000050;
+    eq_run_expired_rel();
+    assert_int_equal(repeat, 2);
+    eventq_now = 1005000;
+    eq_run_expired_rel();
+    assert_int_equal(repeat, 3);
+
+    /* Ids of events that already ran are not found anymore */
+    assert_int_equal(slapi_eq_cancel_rel(once_ctx), 0);
+    assert_null(slapi_eq_get_arg_rel(once_ctx));
+    assert_int_equal(slapi_eq_cancel_rel(second_ctx), 0);
+
+    /* Cancelled events do not fire */
+    assert_int_equal(slapi_eq_cancel_rel(repeat_ctx), 1);
+    assert_int_equal(slapi_eq_cancel_rel(later_ctx), 1);
+    eventq_now = 4600000;
+    assert_int_equal(eq_run_expired_rel(), UINT64_MAX);
+    assert_int_equal(repeat, 3);
+    assert_int_equal(later, 0);
+    assert_int_equal(slapi_eq_cancel_rel(repeat_ctx), 0);
+
+    eq_stop_rel();
+    eq_set_clock_rel(NULL);
+}
@@ -0,0 +1,70 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "../../test_slapd.h"
+
+#include <slap.h>
+#include <proto-slap.h>
+
+static void
+latency_record_usec(Slapi_Latency *latency, uint64_t usec)
+{
+    struct timespec elapsed = {usec / 1000000, (usec % 1000000) * 1000};
+
+    latency_record(latency, &elapsed);
+}
+
+/* A percentile is reported with a ~12% precision, by excess */
+static void
+assert_latency_close(uint64_t value, uint64_t expected)
+{
+    assert_true(value >= expected);
+    assert_true(value <= expected + expected / 8);
+}
+
+void
+test_libslapd_latency_histogram(void **state __attribute__((unused)))
+{
+    Slapi_Latency *latency = latency_new();
+    Slapi_Latency_Summary summary;
+
+    latency_read(latency, LATENCY_READER_MONITOR, &summary);
+    assert_int_equal(summary.count, 0);
+    assert_int_equal(summary.max, 0);
+
+    /* 1..1000 microseconds, and a 2 seconds outlier */
+    for (uint64_t usec = 1; usec <= 1000; usec++) {
+        latency_record_usec(latency, usec);
+    }
+    latency_record_usec(latency, 2000000);
+
+    latency_read(latency, LATENCY_READER_MONITOR, &summary);
+    assert_int_equal(summary.count, 1001);
+    assert_int_equal(summary.avg, (500500 + 2000000) / 1001);
+    assert_latency_close(summary.p50, 501);
+    assert_latency_close(summary.p90, 901);
+    assert_latency_close(summary.p99, 991);
+    assert_latency_close(summary.p999, 1000);
+    assert_latency_close(summary.max, 2000000);
+
+    /* A read starts a new window for its reader only */
+    latency_record_usec(latency, 7);
+    latency_read(latency, LATENCY_READER_MONITOR, &summary);
+    assert_int_equal(summary.count, 1);
+    assert_int_equal(summary.p50, 7);
+    assert_int_equal(summary.max, 7);
+
+    latency_read(latency, LATENCY_READER_SNMP, &summary);
+    assert_int_equal(summary.count, 1002);
+
+    latency_read(latency, LATENCY_READER_MONITOR, &summary);
+    assert_int_equal(summary.count, 0);
+
+    latency_free(&latency);
+    assert_null(latency);
+}
@@ -0,0 +1,179 @@
+/** BEGIN COPYRIGHT BLOCK
+ * Copyright (C) 2026 Red Hat, Inc.
+ * All rights reserved.
+ *
+ * License: GPL (version 3 or any later version).
+ * See LICENSE for details.
+ * END COPYRIGHT BLOCK **/
+
+#include "../../test_slapd.h"
+
+#include <slap.h>
+#include <proto-slap.h>
+#include <pthread.h>
+
+/* more than the lookups needed to rebuild a stale snapshot */
+#define SNAPSHOT_LOOKUPS 256
+
+static struct asyntaxinfo *
+snapshot_add_attr(char *name, char *alias, char *oid)
+{
+    char *names[3] = {0};
+    struct asyntaxinfo *asi = NULL;
+
+    names[0] = name;
+    names[1] = alias;
+
+    assert_int_equal(attr_syntax_create(oid, names, "testing attribute type",
+                                        NULL, NULL, NULL, NULL, NULL,
+                                        DIRSTRING_SYNTAX_OID,
+                                        SLAPI_SYNTAXLENGTH_NONE,
+                                        SLAPI_ATTR_FLAG_STD_ATTR | SLAPI_ATTR_FLAG_OPATTR,
+                                        &asi),
+                     LDAP_SUCCESS);
+    assert_int_equal(attr_syntax_add(asi, 0), LDAP_SUCCESS);
+
+    return asi;
+}
+
+/* Lookup n times, and check every lookup returns the expected asi */
+static void
+snapshot_check_lookup(const char *name, struct asyntaxinfo *expected, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        struct asyntaxinfo *asi = attr_syntax_get_by_name(name, 0);
+        assert_ptr_equal(asi, expected);
+        attr_syntax_return(asi);
+    }
+}
+
+void
+test_libslapd_schema_snapshot_lookup(void **state __attribute__((unused)))
+{
+    struct asyntaxinfo *a = snapshot_add_attr("test_snap", "test_snap_alias", "1.1.0.0.0.1.1");
+    struct asyntaxinfo *held = NULL;
+    struct asyntaxinfo *b = NULL;
+
+    /* By name, alias and oid, before and after the snapshot is published */
+    snapshot_check_lookup("test_snap", a, SNAPSHOT_LOOKUPS);
+    snapshot_check_lookup("TEST_SNAP_ALIAS", a, SNAPSHOT_LOOKUPS);
+    snapshot_check_lookup("1.1.0.0.0.1.1", a, SNAPSHOT_LOOKUPS);
+    held = attr_syntax_get_by_oid("1.1.0.0.0.1.1", 0);
+    assert_ptr_equal(held, a);
+    attr_syntax_return(held);
+
+    /* A deleted attribute is not found anymore, but stays valid while referenced */
+    held = attr_syntax_get_by_name("test_snap", 0);
+    assert_ptr_equal(held, a);
+    attr_syntax_delete(a, 0);
+    snapshot_check_lookup("test_snap", NULL, SNAPSHOT_LOOKUPS);
+    snapshot_check_lookup("test_snap_alias", NULL, 1);
+    assert_string_equal(held->asi_name, "test_snap");
+    attr_syntax_return(held);
+
+    /* A new definition under the same name is found */
+    b = snapshot_add_attr("test_snap", NULL, "1.1.0.0.0.1.2");
+    snapshot_check_lookup("test_snap", b, SNAPSHOT_LOOKUPS);
+    snapshot_check_lookup("test_snap_alias", NULL, 1);
+
+    attr_syntax_delete(b, 0);
+    snapshot_check_lookup("test_snap", NULL, SNAPSHOT_LOOKUPS);
+}
+
+/*
+ * The steps of a reader and of the main thread swapping the definition of
+ * an attribute type, each step waiting for the previous one.
+ */
+struct swap_arg
+{
+    pthread_barrier_t barrier;
+    /* found by the reader before the swap, while stale, after the rebuild */
+    struct asyntaxinfo *by_name[3];
+    struct asyntaxinfo *by_old_oid[3];
+    struct asyntaxinfo *by_new_oid;
+    int held_valid;
+};
+
+static void
+swap_lookup(struct swap_arg *sa, int step)
+{
+    struct asyntaxinfo *asi = attr_syntax_get_by_name("test_swap", 0);
+
+    sa->by_name[step] = asi;
+    attr_syntax_return(asi);
+    asi = attr_syntax_get_by_oid("1.1.0.0.0.1.3", 0);
+    sa->by_old_oid[step] = asi;
+    attr_syntax_return(asi);
+}
+
+static void *
+swap_reader(void *arg)
+{
+    struct swap_arg *sa = (struct swap_arg *)arg;
+    struct asyntaxinfo *held = NULL;
+    struct asyntaxinfo *asi = NULL;
+
+    /* Before the swap, and keep the old definition */
+    swap_lookup(sa, 0);
+    held = attr_syntax_get_by_name("test_swap", 0);
+    pthread_barrier_wait(&sa->barrier);
+
+    /* The old definition is deleted, the snapshot of the reader is stale */
+    pthread_barrier_wait(&sa->barrier);
+    swap_lookup(sa, 1);
+    pthread_barrier_wait(&sa->barrier);
+
+    /* The new definition is added and a new snapshot published */
+    pthread_barrier_wait(&sa->barrier);
+    swap_lookup(sa, 2);
+    asi = attr_syntax_get_by_oid("1.1.0.0.0.1.4", 0);
+    sa->by_new_oid = asi;
+    attr_syntax_return(asi);
+    sa->held_valid = held && strcmp(held->asi_name, "test_swap") == 0 &&
+                     strcmp(held->asi_oid, "1.1.0.0.0.1.3") == 0;
+    attr_syntax_return(held);
+
+    return NULL;
+}
+
+/*
+ * A reader thread keeps its snapshot across lookups: check that once an
+ * attribute type is deleted and redefined by another thread, the reader
+ * never finds the deleted definition, finds the new one once the snapshot
+ * is rebuilt, and that the definition it still references stays valid.
+ */
+void
+test_libslapd_schema_snapshot_swap(void **state __attribute__((unused)))
+{
+    struct swap_arg sa = {0};
+    struct asyntaxinfo *a = snapshot_add_attr("test_swap", NULL, "1.1.0.0.0.1.3");
+    struct asyntaxinfo *b = NULL;
+    pthread_t reader;
+
+    /* Publish a snapshot with the old definition */
+    snapshot_check_lookup("test_swap", a, SNAPSHOT_LOOKUPS);
+
+    pthread_barrier_init(&sa.barrier, NULL, 2);
+    assert_int_equal(pthread_create(&reader, NULL, swap_reader, &sa), 0);
+    pthread_barrier_wait(&sa.barrier);
+    attr_syntax_delete(a, 0);
+    pthread_barrier_wait(&sa.barrier);
+    pthread_barrier_wait(&sa.barrier);
+    b = snapshot_add_attr("test_swap", NULL, "1.1.0.0.0.1.4");
+    snapshot_check_lookup("test_swap", b, SNAPSHOT_LOOKUPS);
+    pthread_barrier_wait(&sa.barrier);
+    pthread_join(reader, NULL);
+    pthread_barrier_destroy(&sa.barrier);
+
+    assert_ptr_equal(sa.by_name[0], a);
+    assert_ptr_equal(sa.by_old_oid[0], a);
+    assert_null(sa.by_name[1]);
+    assert_null(sa.by_old_oid[1]);
+    assert_ptr_equal(sa.by_name[2], b);
+    assert_null(sa.by_old_oid[2]);
+    assert_ptr_equal(sa.by_new_oid, b);
+    assert_true(sa.held_valid);
+
+    attr_syntax_delete(b, 0);
+    snapshot_check_lookup("test_swap", NULL, SNAPSHOT_LOOKUPS);
+}
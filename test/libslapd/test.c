@@ -27,9 +27,14 @@ run_libslapd_tests(void)
         cmocka_unit_test(test_libslapd_pblock_v3c_original_target_dn),
         cmocka_unit_test(test_libslapd_pblock_v3c_target_uniqueid),
         cmocka_unit_test(test_libslapd_schema_filter_validate_simple),
+        cmocka_unit_test(test_libslapd_schema_snapshot_lookup),
+        cmocka_unit_test(test_libslapd_schema_snapshot_swap),
+        cmocka_unit_test(test_libslapd_entry_attrs_index),
         cmocka_unit_test(test_libslapd_operation_v3c_target_spec),
         cmocka_unit_test(test_libslapd_counters_atomic_usage),
         cmocka_unit_test(test_libslapd_counters_atomic_overflow),
+        cmocka_unit_test(test_libslapd_counters_sharded_usage),
+        cmocka_unit_test(test_libslapd_counters_sharded_threads),
         cmocka_unit_test(test_libslapd_filter_optimise),
         cmocka_unit_test(test_libslapd_pal_meminfo),
         cmocka_unit_test(test_libslapd_util_cachesane),
@@ -37,6 +42,8 @@ run_libslapd_tests(void)
         cmocka_unit_test(test_libslapd_haproxy_v2_valid),
         cmocka_unit_test(test_libslapd_haproxy_v2_valid_local),
         cmocka_unit_test(test_libslapd_haproxy_v2_invalid),
+        cmocka_unit_test(test_libslapd_eventq_timing_wheel),
+        cmocka_unit_test(test_libslapd_latency_histogram),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
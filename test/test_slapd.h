@@ -42,6 +42,13 @@ void test_libslapd_pblock_v3c_target_uniqueid(void **state);
 /* libslapd-schema-filter-validate */
 void test_libslapd_schema_filter_validate_simple(void **state);
 
+/* libslapd-schema-snapshot */
+void test_libslapd_schema_snapshot_lookup(void **state);
+void test_libslapd_schema_snapshot_swap(void **state);
+
+/* libslapd-entry-attrlist */
+void test_libslapd_entry_attrs_index(void **state);
+
 /* libslapd-operation-v3_compat */
 void test_libslapd_operation_v3c_target_spec(void **state);
 
@@ -49,6 +56,8 @@ void test_libslapd_operation_v3c_target_spec(void **state);
 
 void test_libslapd_counters_atomic_usage(void **state);
 void test_libslapd_counters_atomic_overflow(void **state);
+void test_libslapd_counters_sharded_usage(void **state);
+void test_libslapd_counters_sharded_threads(void **state);
 
 /* libslapd-pal-meminfo */
 
@@ -61,6 +70,12 @@ void test_libslapd_haproxy_v2_valid(void **state);
 void test_libslapd_haproxy_v2_valid_local(void **state);
 void test_libslapd_haproxy_v2_invalid(void **state);
 
+/* libslapd-eventq */
+void test_libslapd_eventq_timing_wheel(void **state);
+
+/* libslapd-latency */
+void test_libslapd_latency_histogram(void **state);
+
 /* plugins */
 
 void test_plugin_hello(void **state);